@@ -71,6 +71,123 @@
 *               Internet Message Format line limit.
 *
 *           (7) Maximum length of the various arrays inside the SMTPc_MSG structure.
+*
+*           (8) Number of servers (host name & port) for which the capabilities learned from the EHLO reply
+*               are remembered.  Subsequent sessions with a cached server skip the parsing of the EHLO reply,
+*               or directly use HELO if the server is known to reject EHLO.  Set to 0 to disable the cache.
+*
+*           (9) Connection pool used by SMTPc_SendMail() :
+*
+*               (a) SMTPc_CFG_POOL_NBR_SESSIONS is the maximum number of sessions kept open.  Each one uses
+*                   sizeof(SMTPc_SESSION) octets of RAM.  Set to 0 to disable the pool, in which case every
+*                   call to SMTPc_SendMail() opens & closes its own connection.
+*
+*               (b) SMTPc_CFG_POOL_IDLE_TIMEOUT_MS is the maximum time a session may stay idle & still be
+*                   reused.  It SHOULD be smaller than the inactivity timeout of the server (RFC #5321,
+*                   Section 4.5.3.2.7 recommends at least 5 minutes).
+*
+*               (c) SMTPc_CFG_POOL_MAX_MSG_PER_CONN is the number of messages after which a session is
+*                   closed.  Set to 0 for no limit.
+*
+*           (10) Maximum size of the chunks in which the message content is sent with the BDAT command, when
+*                the server supports the CHUNKING extension (RFC #3030).  It SHOULD be a multiple of the send
+*                buffer size of the TCP socket, so that each chunk fills whole segments.  Set to 0 to always
+*                use the DATA command.
+*
+*           (11) Size of the buffer, in each session, into which the body of a message is read when it is
+*                provided by a read function (see 'smtp-c.h  SMTPc_MSG  Note #2').  When the server supports
+*                CHUNKING, each piece read is sent as one or more BDAT chunks; it SHOULD hence not be smaller
+*                than SMTPc_CFG_BDAT_CHUNK_LEN.  Set to 0 to disable body read functions.
+*
+*           (12) Base64 encoding of attachments & credentials :
+*
+*               (a) When SMTPc_CFG_B64_PAIR_TBL_EN is enabled, a table of 4096 pairs of characters (8 KB of
+*                   code memory) lets the scalar encoder look up 12 bits at a time instead of 6.
+*
+*               (b) When SMTPc_CFG_B64_SIMD_EN is enabled, SIMD kernels are compiled for the architectures
+*                   the compiler targets, i.e. SSE2 & AVX2 on x86-64 & NEON on AArch64, & the fastest one
+*                   supported by the CPU is used (see 'smtp-c.c  SMTPc_B64EncSet()').  On other CPUs, only
+*                   the scalar encoder is compiled.
+*
+*           (13) Size of the buffer, in each session, gathering the small pieces of the message content
+*                (headers, body fragments, encoded lines, "end of mail data" indicator) into segments.
+*                It SHOULD be the maximum segment size (MSS) of the TCP connection.  Set to 0 to send each
+*                piece as soon as it is produced.
+*
+*           (14) Asynchronous engine (see 'smtp-c.c  SMTPc_Poll()') :
+*
+*               (a) Configure SMTPc_CFG_ASYNC_EN to enable/disable SMTPc_AsyncSubmit() & SMTPc_Poll().
+*
+*               (b) SMTPc_CFG_ASYNC_TIMEOUT_MS is the maximum time a job may wait for the server without
+*                   any progress.  RFC #5321, Section 4.5.3.2, recommends at least 5 minutes.
+*
+*           (15) Outbound queue (see 'smtp-c.c  SMTPc_QueueInit()') :
+*
+*               (a) Configure SMTPc_CFG_QUEUE_EN to enable/disable SMTPc_QueueInit() & SMTPc_QueueSubmit().
+*                   The queue is drained by worker tasks created through the Kernel Abstraction Layer (KAL);
+*                   its depth, the number of workers & their number of sessions are run-time settings, and
+*                   its memory is allocated from the heap when it is initialized.
+*
+*               (b) The sessions of each worker are pooled as the ones of SMTPc_SendMail() (see Note #9),
+*                   which MUST hence be enabled.
+*
+*               (c) SMTPc_CFG_QUEUE_RING_SIZE is the number of slots of the submission ring, a table of
+*                   job pointers filled by SMTPc_QueueRingSubmit() without pending, so that jobs can be
+*                   submitted from high-priority tasks or deferred interrupt context.  It MUST be a power
+*                   of 2.  Set to 0 to disable the ring.
+*
+*               (d) SMTPc_CFG_QUEUE_RING_POLL_MS is the period at which the ring is polled & drained into
+*                   the job queue when its task is not woken up (see Note #15f).
+*
+*               (e) SMTPc_CFG_QUEUE_RING_ATOMIC_EN selects how the producers claim the slots of the ring :
+*                   with atomic operations, so that interrupts are never disabled, or in a critical section.
+*                   The atomic operations are the GCC/Clang '__atomic' built-ins, unless the port defines
+*                   the following macros, on 32-bit integers, in this file :
+*
+*                       SMTPc_ATOMIC_LD32(p_val)                  Sequentially consistent load.
+*                       SMTPc_ATOMIC_ST32(p_val, val)             Sequentially consistent store.
+*                       SMTPc_ATOMIC_ADD32(p_val, val)            Fetch & add, returning the previous value.
+*                       SMTPc_ATOMIC_CAS32(p_val, p_exp, val)     Compare-and-swap, returning DEF_YES on success
+*                                                                     or the current value in '*p_exp'.
+*
+*                   Disable it on CPUs without atomic read-modify-write instructions, e.g. ARMv6-M.
+*
+*               (f) SMTPc_CFG_QUEUE_RING_WAKE_EN enables the ring task to be woken up, by a semaphore, when a
+*                   job is put in an empty ring, so that no delay is added to the job.  SMTPc_QueueRingSubmit()
+*                   then posts to a kernel object & MUST NOT be called from interrupt context, unless the
+*                   kernel allows it.  When disabled, up to SMTPc_CFG_QUEUE_RING_POLL_MS is added to each job.
+*
+*           (16) Persistent spool (see 'smtp-c.c  SMTPc_SpoolInit()') : configure SMTPc_CFG_SPOOL_EN to
+*                enable/disable SMTPc_SpoolInit(), SMTPc_SpoolSubmit() & SMTPc_SpoolSyncIdGet().  Rendered
+*                messages are appended to a storage (see 'Spool/Posix/smtp-c_spool_posix.h' for files of a
+*                POSIX file system) so that they are sent even after a reset, once the group commit that
+*                covers them is done (see 'smtp-c.c  SMTPc_SpoolSubmit()  Note #3'); they are sent through
+*                the outbound queue, which MUST hence be enabled (see Note #15).
+*
+*           (17) Retry scheduler (see 'smtp-c.c  SMTPc_SchedTask()') :
+*
+*               (a) Configure SMTPc_CFG_SCHED_EN to enable/disable the retries of the jobs of the outbound
+*                   queue that failed on a transient error, & SMTPc_QueueSubmitDly().  The number of retries
+*                   & their backoff are run-time settings (see 'smtp-c.h  SMTPc_QUEUE_CFG').  The outbound
+*                   queue MUST hence be enabled (see Note #15).
+*
+*               (b) SMTPc_CFG_SCHED_TICK_MS is the resolution of the timer wheel holding the jobs waiting
+*                   to be sent.  Delays are rounded up to a whole number of ticks & limited to 2^24 ticks.
+*
+*           (18) Transport (see 'smtp-c.h  SMTPc_TRANSPORT_API') : all the network I/O goes through the
+*                transport set by SMTPc_TransportSet().  Configure SMTPc_CFG_TRANSPORT_NET_EN to include the
+*                uC/TCP-IP transport, used by default.  When it is disabled, another transport, such as the
+*                POSIX sockets transport ('Transport/Posix'), the Linux io_uring transport ('Transport/Uring')
+*                or the in-process mock server ('Transport/Mock'), MUST be set before any connection is
+*                opened.  The transport also provides the millisecond timestamp of the client, & the core
+*                then needs no uC/TCP-IP header (see 'bench/Makefile' for a host build).
+*
+*           (19) Maximum time a session connected by SMTPc_Connect() waits for each reply of the server,
+*                or for the transport to accept the data transmitted.  RFC #5321, Section 4.5.3.2 recommends
+*                timeouts of 5 minutes for most commands & of 10 minutes for the reply to the message
+*                content; shorter timeouts bound the latency of a stalled session, at the risk of
+*                delivering a message twice (see RFC #5321, Section 6.1).  Once a timeout expired, the
+*                connection is no longer used (see 'smtp-c.h  SMTP SESSION DATA TYPES  Note #4').
 *********************************************************************************************************
 */
 
@@ -79,6 +196,7 @@
 
 #define  SMTPc_CFG_MAX_CONN_REQ_TIMEOUT_MS              5000    /* Cfg max inactivity time (ms) on CONNECT.             */
 #define  SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS            5000    /* Cfg max inactivity time (ms) on DISCONNECT.          */
+#define  SMTPc_CFG_MAX_REP_TIMEOUT_MS                 600000    /* Cfg max inactivity time (ms) on REPLY (Note #19).    */
 
                                                                 /* Cfg SMTP auth mechanism (see Note #3).               */
 #define  SMTPc_CFG_AUTH_EN                      DEF_DISABLED
@@ -97,6 +215,61 @@
 #define  SMTPc_CFG_MSG_MAX_BCC                             5    /* Cfg msg max nbr of BCC recipients.                   */
 #define  SMTPc_CFG_MSG_MAX_ATTACH                          5    /* Cfg msg max nbr of msg attach.                       */
 
+#define  SMTPc_CFG_CAP_CACHE_NBR_ENTRIES                   4    /* Cfg nbr of srv capabilities cached (see Note #8).    */
+
+                                                                /* See Note #9.                                         */
+#define  SMTPc_CFG_POOL_NBR_SESSIONS                       2    /* Cfg max nbr of sessions kept open.                   */
+#define  SMTPc_CFG_POOL_IDLE_TIMEOUT_MS                60000    /* Cfg max idle time (ms) of a reused session.          */
+#define  SMTPc_CFG_POOL_MAX_MSG_PER_CONN                 100    /* Cfg max nbr of msgs per conn.                        */
+
+#define  SMTPc_CFG_BDAT_CHUNK_LEN                       4096    /* Cfg max size of BDAT chunks (see Note #10).          */
+#define  SMTPc_CFG_BODY_RD_BUF_LEN                      4096    /* Cfg size of msg body read buf (see Note #11).        */
+
+                                                                /* Cfg base64 encoder (see Note #12).                   */
+#define  SMTPc_CFG_B64_PAIR_TBL_EN               DEF_ENABLED
+                                                                /*   DEF_DISABLED  64-char  tbl                         */
+                                                                /*   DEF_ENABLED   8 KB pair tbl                        */
+#define  SMTPc_CFG_B64_SIMD_EN                   DEF_ENABLED
+                                                                /*   DEF_DISABLED  Scalar encoder only                  */
+                                                                /*   DEF_ENABLED   SIMD kernels, if CPU supported       */
+
+#define  SMTPc_CFG_TX_SEG_LEN                           1460    /* Cfg size of content tx seg buf (see Note #13).       */
+
+                                                                /* Cfg async engine (see Note #14).                     */
+#define  SMTPc_CFG_ASYNC_EN                     DEF_ENABLED
+                                                                /*   DEF_DISABLED  Async engine DISABLED                */
+                                                                /*   DEF_ENABLED   Async engine ENABLED                 */
+#define  SMTPc_CFG_ASYNC_TIMEOUT_MS                   300000    /* Cfg max time (ms) without progress of a job.         */
+
+                                                                /* Cfg outbound queue (see Note #15).                   */
+#define  SMTPc_CFG_QUEUE_EN                     DEF_DISABLED
+                                                                /*   DEF_DISABLED  Outbound queue DISABLED              */
+                                                                /*   DEF_ENABLED   Outbound queue ENABLED               */
+#define  SMTPc_CFG_QUEUE_RING_SIZE                        16    /* Cfg nbr of slots of submission ring.                 */
+#define  SMTPc_CFG_QUEUE_RING_POLL_MS                     10    /* Cfg period (ms) at which the ring is polled.         */
+#define  SMTPc_CFG_QUEUE_RING_ATOMIC_EN         DEF_ENABLED
+                                                                /*   DEF_DISABLED  Slots claimed in critical section    */
+                                                                /*   DEF_ENABLED   Slots claimed with atomic ops        */
+#define  SMTPc_CFG_QUEUE_RING_WAKE_EN           DEF_ENABLED
+                                                                /*   DEF_DISABLED  Ring polled   by its task            */
+                                                                /*   DEF_ENABLED   Ring task woken up on 1st job        */
+
+                                                                /* Cfg persistent spool (see Note #16).                 */
+#define  SMTPc_CFG_SPOOL_EN                     DEF_DISABLED
+                                                                /*   DEF_DISABLED  Persistent spool DISABLED            */
+                                                                /*   DEF_ENABLED   Persistent spool ENABLED             */
+
+                                                                /* Cfg retry scheduler (see Note #17).                  */
+#define  SMTPc_CFG_SCHED_EN                     DEF_DISABLED
+                                                                /*   DEF_DISABLED  Retry scheduler DISABLED             */
+                                                                /*   DEF_ENABLED   Retry scheduler ENABLED              */
+#define  SMTPc_CFG_SCHED_TICK_MS                         100    /* Cfg resolution (ms) of the retry timer wheel.        */
+
+                                                                /* Cfg uC/TCP-IP transport (see Note #18).              */
+#define  SMTPc_CFG_TRANSPORT_NET_EN             DEF_ENABLED
+                                                                /*   DEF_DISABLED  uC/TCP-IP transport DISABLED         */
+                                                                /*   DEF_ENABLED   uC/TCP-IP transport ENABLED          */
+
 /*
 *********************************************************************************************************
 *                                                TRACING
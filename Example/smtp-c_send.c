@@ -97,7 +97,7 @@ CPU_BOOLEAN AppMailSend (void)
     SMTPc_MSG                mail;
     SMTPc_ERR                err;
     CPU_INT16U               port;
-    NET_APP_SOCK_SECURE_CFG *p_secure_cfg;
+    SMTPc_SECURE_CFG        *p_secure_cfg;
 
 
     p_server_addr = SERVER_IPV4;
@@ -0,0 +1,816 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                    uC/SMTPc ASYNC REACTOR : LINUX EPOLL
+*
+* Filename : smtp-c_reactor_epoll.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) The jobs in progress are only accessed by the task running SMTPc_ReactorEpoll_Run().  The
+*                jobs submitted & the stop request are exchanged with the other tasks without lock, with
+*                atomic operations : a submitting task pushes its job, then signals the eventfd; the
+*                reactor task reads the eventfd, then takes all the jobs pushed.  A job pushed after the
+*                jobs were taken signals the eventfd again, so that none is left behind.
+*
+*            (2) Each socket is registered once, edge-triggered, for both reception & transmission : a job
+*                is run until its socket would block (see 'smtp-c.c  SMTPc_AsyncRun()  Note #1'), so that no
+*                readiness edge is lost.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#ifndef  _POSIX_C_SOURCE
+#define  _POSIX_C_SOURCE                              200809L   /* CLOCK_MONOTONIC, getaddrinfo(), read() & write().    */
+#endif
+
+#define  MICRIUM_SOURCE
+#define  SMTPc_REACTOR_EPOLL_MODULE
+
+#include  "smtp-c_reactor_epoll.h"
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+#include  <arpa/inet.h>
+#include  <errno.h>
+#include  <netdb.h>
+#include  <netinet/in.h>
+#include  <stdint.h>
+#include  <string.h>
+#include  <sys/epoll.h>
+#include  <sys/eventfd.h>
+#include  <sys/socket.h>
+#include  <sys/timerfd.h>
+#include  <time.h>
+#include  <unistd.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  SMTPc_REACTOR_EPOLL_EVT_NBR                      64u   /* Max nbr of evts handled per wait.                    */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         SMTPc_ReactorEpoll_AddrGet  (CPU_CHAR             *p_host_name,
+                                                  CPU_CHAR             *p_addr,
+                                                  SMTPc_ERR            *p_err);
+
+static  CPU_BOOLEAN  SMTPc_ReactorEpoll_Start    (SMTPc_REACTOR_EPOLL  *p_reactor);
+
+static  void         SMTPc_ReactorEpoll_JobRun   (SMTPc_REACTOR_EPOLL  *p_reactor,
+                                                  SMTPc_ASYNC          *p_async);
+
+static  void         SMTPc_ReactorEpoll_Expire   (SMTPc_REACTOR_EPOLL  *p_reactor);
+
+static  void         SMTPc_ReactorEpoll_JobAdd   (SMTPc_REACTOR_EPOLL  *p_reactor,
+                                                  SMTPc_ASYNC          *p_async);
+
+static  void         SMTPc_ReactorEpoll_JobRem   (SMTPc_REACTOR_EPOLL  *p_reactor,
+                                                  SMTPc_ASYNC          *p_async);
+
+static  SMTPc_TS_MS  SMTPc_ReactorEpoll_TS_Get_ms(void);
+
+static  void         SMTPc_ReactorEpoll_FdDrain  (int                   fd);
+
+static  void         SMTPc_ReactorEpoll_FdClose  (SMTPc_REACTOR_EPOLL  *p_reactor);
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_ReactorEpoll_Init()
+*
+* Description : (1) Initialize a reactor.
+*
+*                   (a) Create the epoll instance, the wakeup eventfd & the deadline timerfd
+*                   (b) Register the eventfd & the timerfd
+*
+*
+* Argument(s) : p_reactor       Pointer to the reactor (see 'smtp-c_reactor_epoll.h  DATA TYPES  Note #1').
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, reactor ready.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_reactor' passed a NULL pointer.
+*                               SMTPc_ERR_INIT_FAILED               Descriptors could not be created.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The eventfd & the timerfd are identified by the address of their descriptor in the
+*                   reactor; the sockets by their job.
+*********************************************************************************************************
+*/
+
+void  SMTPc_ReactorEpoll_Init (SMTPc_REACTOR_EPOLL  *p_reactor,
+                               SMTPc_ERR            *p_err)
+{
+    struct  epoll_event  evt;
+
+
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_reactor == (SMTPc_REACTOR_EPOLL *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+                                                                /* ------------------- CREATE FDS --------------------- */
+    p_reactor->EpollFd       =  epoll_create1(EPOLL_CLOEXEC);
+    p_reactor->WakeFd        =  eventfd(0u, EFD_NONBLOCK | EFD_CLOEXEC);
+    p_reactor->TimerFd       =  timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    p_reactor->TimerArmed    =  DEF_NO;
+    p_reactor->TimerTS       =  0u;
+    p_reactor->SubmitPtr     = (SMTPc_ASYNC *)0;
+    p_reactor->StopReq       =  DEF_NO;
+    p_reactor->JobHeadPtr    = (SMTPc_ASYNC *)0;
+    p_reactor->JobTailPtr    = (SMTPc_ASYNC *)0;
+    p_reactor->JobNbr        =  0u;
+
+    if ((p_reactor->EpollFd < 0) ||
+        (p_reactor->WakeFd  < 0) ||
+        (p_reactor->TimerFd < 0)) {
+        SMTPc_ReactorEpoll_FdClose(p_reactor);
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* -------------------- REG FDS ----------------------- */
+    memset(&evt, 0, sizeof(evt));
+    evt.events   = EPOLLIN;                                     /* See Note #2.                                         */
+    evt.data.ptr = &p_reactor->WakeFd;
+    if (epoll_ctl(p_reactor->EpollFd, EPOLL_CTL_ADD, p_reactor->WakeFd, &evt) != 0) {
+        SMTPc_ReactorEpoll_FdClose(p_reactor);
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    evt.data.ptr = &p_reactor->TimerFd;
+    if (epoll_ctl(p_reactor->EpollFd, EPOLL_CTL_ADD, p_reactor->TimerFd, &evt) != 0) {
+        SMTPc_ReactorEpoll_FdClose(p_reactor);
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_Submit()
+*
+* Description : Submit a message to be sent by a reactor.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+*               p_async         Pointer to the job (see 'smtp-c.h  SMTPc_ASYNC  Note #3').
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address
+*                               (see Note #3).
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL), DEF_NULL if none.
+*
+*               p_msg           Pointer to the rendered message to send.
+*
+*               cmpl_fnct       Function called by the reactor task when the job is over (see 'smtp-c.h
+*                               SMTPc_ASYNC  Note #2').
+*
+*               p_cmpl_arg      Argument passed to 'cmpl_fnct'.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, job submitted.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Host name could not be resolved.
+*
+*                                                                   ----- RETURNED BY SMTPc_AsyncInit() : -----
+*                               SMTPc_ERR_NULL_ARG                  Argument passed a NULL pointer.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          No secure mode available.
+*                               SMTPc_ERR_NOT_RENDERED              Message not rendered.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               Completion function of a job.
+*
+* Note(s)     : (1) May be called from any task.  The job is started by the reactor task, on its next wakeup.
+*
+*               (2) The eventfd counter only tells that jobs were submitted : it never overflows, since the
+*                   reactor task resets it before taking the submitted jobs (see 'smtp-c_reactor_epoll.c
+*                   Note #1').
+*
+*               (3) The host name is resolved here, by the submitting task, so that a slow name lookup only
+*                   delays this job (see 'smtp-c.h  SMTPc_ASYNC  Note #4') : the reactor task opens the
+*                   connection to the first address found.  A job submitted again from its completion
+*                   function is resolved by the reactor task; an IP address SHOULD then be passed, which is
+*                   resolved without lookup.
+*********************************************************************************************************
+*/
+
+void  SMTPc_ReactorEpoll_Submit (SMTPc_REACTOR_EPOLL      *p_reactor,
+                                 SMTPc_ASYNC              *p_async,
+                                 CPU_CHAR                 *p_host_name,
+                                 CPU_INT16U                port,
+                                 CPU_CHAR                 *p_username,
+                                 CPU_CHAR                 *p_pwd,
+                                 SMTPc_SECURE_CFG         *p_secure_cfg,
+                                 SMTPc_MSG                *p_msg,
+                                 SMTPc_ASYNC_CMPL_FNCT     cmpl_fnct,
+                                 void                     *p_cmpl_arg,
+                                 SMTPc_ERR                *p_err)
+{
+    SMTPc_ASYNC  *p_async_next;
+    uint64_t      wake;
+
+
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_reactor == (SMTPc_REACTOR_EPOLL *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+                                                                /* --------------------- INIT JOB --------------------- */
+    SMTPc_AsyncInit(p_async,
+                    p_host_name,
+                    port,
+                    p_username,
+                    p_pwd,
+                    p_secure_cfg,
+                    p_msg,
+                    cmpl_fnct,
+                    p_cmpl_arg,
+                    p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ------------------- RESOLVE HOST ------------------- */
+    SMTPc_ReactorEpoll_AddrGet(p_host_name, p_async->HostAddr, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {                             /* See Note #3.                                         */
+        return;
+    }
+    p_async->HostNamePtr = p_async->HostAddr;
+                                                                /* --------------------- PUSH JOB --------------------- */
+    p_async_next = __atomic_load_n(&p_reactor->SubmitPtr, __ATOMIC_RELAXED);
+    do {
+        p_async->NextPtr = p_async_next;
+    } while (__atomic_compare_exchange_n(&p_reactor->SubmitPtr,
+                                         &p_async_next,
+                                          p_async,
+                                          DEF_NO,
+                                          __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED) == 0);
+                                                                /* ------------------- WAKE REACTOR ------------------- */
+    wake = 1u;                                                  /* See Note #2.                                         */
+    (void)write(p_reactor->WakeFd, &wake, sizeof(wake));
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_ReactorEpoll_Run()
+*
+* Description : (1) Run the jobs submitted to a reactor, until stopped.
+*
+*                   (a) Wait for sockets to be ready, for jobs to be submitted or for a deadline
+*                   (b) Run the jobs whose socket is ready
+*                   (c) Start the jobs submitted
+*                   (d) Run the jobs whose deadline expired & arm the timer on the next deadline
+*
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, reactor stopped.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_reactor' passed a NULL pointer.
+*                               SMTPc_ERR_RX_FAILED                 Error waiting for the sockets.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The function is typically the body of a task of its own; it MUST NOT be called by
+*                   several tasks at once.  The completion functions are called by this task.
+*
+*               (3) The jobs in progress when the reactor is stopped are kept; they resume when the
+*                   function is called again.
+*
+*               (4) A job whose socket could not be registered is never run on readiness, only on its
+*                   deadline : it then fails with SMTPc_ERR_TIMEOUT.
+*********************************************************************************************************
+*/
+
+void  SMTPc_ReactorEpoll_Run (SMTPc_REACTOR_EPOLL  *p_reactor,
+                              SMTPc_ERR            *p_err)
+{
+    struct  epoll_event   evt_tbl[SMTPc_REACTOR_EPOLL_EVT_NBR];
+    void                 *p_data;
+    CPU_BOOLEAN           stop;
+    int                   evt_nbr;
+    int                   i;
+
+
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_reactor == (SMTPc_REACTOR_EPOLL *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+
+    stop = DEF_NO;
+    while (stop == DEF_NO) {
+                                                                /* ------------------- WAIT FOR EVTS ------------------ */
+        evt_nbr = epoll_wait(p_reactor->EpollFd, evt_tbl, SMTPc_REACTOR_EPOLL_EVT_NBR, -1);
+        if (evt_nbr < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+           *p_err = SMTPc_ERR_RX_FAILED;
+            return;
+        }
+                                                                /* --------------------- RUN JOBS --------------------- */
+        for (i = 0; i < evt_nbr; i++) {
+            p_data = evt_tbl[i].data.ptr;
+            if (p_data == &p_reactor->WakeFd) {
+                SMTPc_ReactorEpoll_FdDrain(p_reactor->WakeFd);
+                stop = SMTPc_ReactorEpoll_Start(p_reactor);
+            } else if (p_data == &p_reactor->TimerFd) {
+                SMTPc_ReactorEpoll_FdDrain(p_reactor->TimerFd);
+                p_reactor->TimerArmed = DEF_NO;
+            } else {
+                SMTPc_ReactorEpoll_JobRun(p_reactor, (SMTPc_ASYNC *)p_data);
+            }
+        }
+                                                                /* ------------------- EXPIRE JOBS -------------------- */
+        SMTPc_ReactorEpoll_Expire(p_reactor);
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_ReactorEpoll_Stop()
+*
+* Description : Stop a reactor.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               Completion function of a job.
+*
+* Note(s)     : (1) May be called from any task.  SMTPc_ReactorEpoll_Run() returns once it handled the
+*                   events already pending (see 'SMTPc_ReactorEpoll_Run()  Note #3').
+*********************************************************************************************************
+*/
+
+void  SMTPc_ReactorEpoll_Stop (SMTPc_REACTOR_EPOLL  *p_reactor)
+{
+    uint64_t  wake;
+
+
+    __atomic_store_n(&p_reactor->StopReq, DEF_YES, __ATOMIC_RELEASE);
+
+    wake = 1u;
+    (void)write(p_reactor->WakeFd, &wake, sizeof(wake));
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_ReactorEpoll_AddrGet()
+*
+* Description : Resolve the host name of a job into an IP address.
+*
+* Argument(s) : p_host_name     Pointer to host name or IP address.
+*
+*               p_addr          Pointer to the buffer that will receive the address, of at least
+*                               SMTPc_TRANSPORT_ADDR_LEN characters.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, address returned.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Host name could not be resolved.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Submit().
+*
+* Note(s)     : (1) An IP address is converted without lookup.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_AddrGet (CPU_CHAR   *p_host_name,
+                                          CPU_CHAR   *p_addr,
+                                          SMTPc_ERR  *p_err)
+{
+    struct  addrinfo   hints;
+    struct  addrinfo  *p_ai;
+    const   void      *p_in;
+    int                rtn;
+
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+                                                                /* See Note #1.                                         */
+    rtn = getaddrinfo((const char *)p_host_name, DEF_NULL, &hints, &p_ai);
+    if (rtn != 0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+
+    if (p_ai->ai_family == AF_INET6) {
+        p_in = &((struct sockaddr_in6 *)p_ai->ai_addr)->sin6_addr;
+    } else {
+        p_in = &((struct sockaddr_in  *)p_ai->ai_addr)->sin_addr;
+    }
+    if (inet_ntop(p_ai->ai_family, p_in, (char *)p_addr, SMTPc_TRANSPORT_ADDR_LEN) == DEF_NULL) {
+        freeaddrinfo(p_ai);
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+    freeaddrinfo(p_ai);
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_Start()
+*
+* Description : Start the jobs submitted to a reactor.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+* Return(s)   : DEF_YES, if the reactor was requested to stop.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Run().
+*
+* Note(s)     : (1) The jobs are taken at once, last submitted first, & reversed so that they are started
+*                   in order of submission.
+*
+*               (2) A job is run once before its socket is registered, so that it opens its connection.
+*                   Registering reports the readiness of the socket at once, if any.
+*
+*               (3) The jobs are appended once run, after their last progress.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_ReactorEpoll_Start (SMTPc_REACTOR_EPOLL  *p_reactor)
+{
+    struct  epoll_event   evt;
+    SMTPc_ASYNC          *p_async;
+    SMTPc_ASYNC          *p_async_next;
+    SMTPc_ASYNC          *p_async_list;
+    CPU_BOOLEAN           stop;
+    CPU_BOOLEAN           done;
+
+                                                                /* --------------------- TAKE JOBS -------------------- */
+    p_async = __atomic_exchange_n(&p_reactor->SubmitPtr, (SMTPc_ASYNC *)0, __ATOMIC_ACQUIRE);
+    stop    = __atomic_exchange_n(&p_reactor->StopReq,   DEF_NO,            __ATOMIC_ACQUIRE);
+
+    p_async_list = (SMTPc_ASYNC *)0;                            /* See Note #1.                                         */
+    while (p_async != (SMTPc_ASYNC *)0) {
+        p_async_next     = p_async->NextPtr;
+        p_async->NextPtr = p_async_list;
+        p_async_list     = p_async;
+        p_async          = p_async_next;
+    }
+                                                                /* -------------------- START JOBS -------------------- */
+    p_async = p_async_list;
+    while (p_async != (SMTPc_ASYNC *)0) {
+        p_async_next     = p_async->NextPtr;
+        p_async->NextPtr = (SMTPc_ASYNC *)0;
+
+        done = SMTPc_AsyncRun(p_async);                         /* See Note #2.                                         */
+        if (done == DEF_YES) {
+            p_async->CmplFnct(p_async, p_async->Err, p_async->CmplArg);
+        } else {
+            memset(&evt, 0, sizeof(evt));
+            evt.events   = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            evt.data.ptr = p_async;
+            (void)epoll_ctl(p_reactor->EpollFd,                 /* See 'SMTPc_ReactorEpoll_Run()  Note #4'.             */
+                            EPOLL_CTL_ADD,
+                            (int)p_async->Sess.SockId,
+                           &evt);
+
+            SMTPc_ReactorEpoll_JobAdd(p_reactor, p_async);      /* See Note #3.                                         */
+        }
+
+        p_async = p_async_next;
+    }
+
+    return (stop);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_JobRun()
+*
+* Description : Run a job in progress, until its socket would block.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+*               p_async         Pointer to the job.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Expire(),
+*               SMTPc_ReactorEpoll_Run().
+*
+* Note(s)     : (1) A job that made progress is moved to the end of the list, which stays in order of last
+*                   progress : the first job has the earliest deadline.
+*
+*               (2) The job is removed before its completion function is called, so that it may be
+*                   submitted again from the completion function.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_JobRun (SMTPc_REACTOR_EPOLL  *p_reactor,
+                                         SMTPc_ASYNC          *p_async)
+{
+    SMTPc_TS_MS  ts;
+    CPU_BOOLEAN  done;
+
+
+    ts   = p_async->TS;
+    done = SMTPc_AsyncRun(p_async);
+    if (done == DEF_YES) {                                      /* See Note #2.                                         */
+        SMTPc_ReactorEpoll_JobRem(p_reactor, p_async);
+        p_async->CmplFnct(p_async, p_async->Err, p_async->CmplArg);
+        return;
+    }
+
+    if (p_async->TS != ts) {                                    /* See Note #1.                                         */
+        SMTPc_ReactorEpoll_JobRem(p_reactor, p_async);
+        SMTPc_ReactorEpoll_JobAdd(p_reactor, p_async);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_Expire()
+*
+* Description : Run the jobs whose deadline expired, & arm the timer on the next deadline.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Run().
+*
+* Note(s)     : (1) An expired job fails with SMTPc_ERR_TIMEOUT, unless its socket became ready in the
+*                   meantime.  Either way, it leaves the head of the list.
+*
+*               (2) The timer is only armed again when the earliest deadline changed.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_Expire (SMTPc_REACTOR_EPOLL  *p_reactor)
+{
+    struct  itimerspec   its;
+    SMTPc_ASYNC         *p_async;
+    SMTPc_TS_MS          elapsed;
+    SMTPc_TS_MS          rem;
+
+
+    elapsed = 0u;
+                                                                /* -------------------- EXPIRE JOBS ------------------- */
+    p_async = p_reactor->JobHeadPtr;
+    while (p_async != (SMTPc_ASYNC *)0) {
+        elapsed = (SMTPc_TS_MS)(SMTPc_ReactorEpoll_TS_Get_ms() - p_async->TS);
+        if (elapsed < SMTPc_CFG_ASYNC_TIMEOUT_MS) {
+            break;
+        }
+        SMTPc_ReactorEpoll_JobRun(p_reactor, p_async);          /* See Note #1.                                         */
+        p_async = p_reactor->JobHeadPtr;
+    }
+                                                                /* -------------------- ARM TIMER --------------------- */
+    memset(&its, 0, sizeof(its));
+    if (p_async == (SMTPc_ASYNC *)0) {
+        if (p_reactor->TimerArmed == DEF_NO) {
+            return;
+        }
+        p_reactor->TimerArmed = DEF_NO;                         /* Disarm timer.                                        */
+    } else {
+        if ((p_reactor->TimerArmed == DEF_YES) &&               /* See Note #2.                                         */
+            (p_reactor->TimerTS    == p_async->TS)) {
+            return;
+        }
+        rem                      = SMTPc_CFG_ASYNC_TIMEOUT_MS - elapsed;
+        its.it_value.tv_sec      = (time_t)(rem / 1000u);
+        its.it_value.tv_nsec     = (long)((rem % 1000u) * 1000000u);
+        p_reactor->TimerArmed    = DEF_YES;
+        p_reactor->TimerTS       = p_async->TS;
+    }
+
+    (void)timerfd_settime(p_reactor->TimerFd, 0, &its, DEF_NULL);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_JobAdd()
+*
+* Description : Append a job to the jobs in progress.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+*               p_async         Pointer to the job.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_JobRun(),
+*               SMTPc_ReactorEpoll_Start().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_JobAdd (SMTPc_REACTOR_EPOLL  *p_reactor,
+                                         SMTPc_ASYNC          *p_async)
+{
+    p_async->NextPtr = (SMTPc_ASYNC *)0;
+    p_async->PrevPtr = p_reactor->JobTailPtr;
+    if (p_reactor->JobTailPtr == (SMTPc_ASYNC *)0) {
+        p_reactor->JobHeadPtr          = p_async;
+    } else {
+        p_reactor->JobTailPtr->NextPtr = p_async;
+    }
+    p_reactor->JobTailPtr = p_async;
+    p_reactor->JobNbr++;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_JobRem()
+*
+* Description : Remove a job from the jobs in progress.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+*               p_async         Pointer to the job.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_JobRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_JobRem (SMTPc_REACTOR_EPOLL  *p_reactor,
+                                         SMTPc_ASYNC          *p_async)
+{
+    if (p_async->PrevPtr == (SMTPc_ASYNC *)0) {
+        p_reactor->JobHeadPtr     = p_async->NextPtr;
+    } else {
+        p_async->PrevPtr->NextPtr = p_async->NextPtr;
+    }
+    if (p_async->NextPtr == (SMTPc_ASYNC *)0) {
+        p_reactor->JobTailPtr     = p_async->PrevPtr;
+    } else {
+        p_async->NextPtr->PrevPtr = p_async->PrevPtr;
+    }
+    p_async->NextPtr = (SMTPc_ASYNC *)0;
+    p_async->PrevPtr = (SMTPc_ASYNC *)0;
+    p_reactor->JobNbr--;
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_ReactorEpoll_TS_Get_ms()
+*
+* Description : Get the time of the monotonic clock.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in milliseconds.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Expire().
+*
+* Note(s)     : (1) The time of the last progress of the jobs is taken by the transport (see 'smtp-c.h
+*                   SMTPc_TRANSPORT_API  Note #1h') : the clock & its conversion MUST be the same as those
+*                   of the POSIX sockets transport (see 'smtp-c_reactor_epoll.h  Note #2').
+*********************************************************************************************************
+*/
+
+static  SMTPc_TS_MS  SMTPc_ReactorEpoll_TS_Get_ms (void)
+{
+    struct  timespec  ts;
+
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);                  /* See Note #1.                                         */
+
+    return ((SMTPc_TS_MS)(((CPU_INT64U)ts.tv_sec * 1000u) + ((CPU_INT64U)ts.tv_nsec / 1000000u)));
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_FdDrain()
+*
+* Description : Reset the counter of an eventfd or timerfd.
+*
+* Argument(s) : fd              Descriptor.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Run().
+*
+* Note(s)     : (1) The descriptors are non-blocking : reading fails if the counter is already null.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_FdDrain (int  fd)
+{
+    uint64_t  cnt;
+
+
+    (void)read(fd, &cnt, sizeof(cnt));                          /* See Note #1.                                         */
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_ReactorEpoll_FdClose()
+*
+* Description : Close the descriptors of a reactor that could not be initialized.
+*
+* Argument(s) : p_reactor       Pointer to the reactor.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_ReactorEpoll_Init().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReactorEpoll_FdClose (SMTPc_REACTOR_EPOLL  *p_reactor)
+{
+    if (p_reactor->EpollFd >= 0) {
+        (void)close(p_reactor->EpollFd);
+        p_reactor->EpollFd = -1;
+    }
+    if (p_reactor->WakeFd >= 0) {
+        (void)close(p_reactor->WakeFd);
+        p_reactor->WakeFd = -1;
+    }
+    if (p_reactor->TimerFd >= 0) {
+        (void)close(p_reactor->TimerFd);
+        p_reactor->TimerFd = -1;
+    }
+}
+#endif
@@ -0,0 +1,134 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                    uC/SMTPc ASYNC REACTOR : LINUX EPOLL
+*
+* Filename : smtp-c_reactor_epoll.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Event loop running the jobs of the asynchronous engine (see 'smtp-c.h  SMTPc_ASYNC') on
+*                Linux, so that a single task drives thousands of connections :
+*
+*                (a) Each job is run by SMTPc_AsyncRun() only when its socket is ready, as reported by an
+*                    edge-triggered epoll instance.
+*
+*                (b) The jobs are kept in order of last progress; a single timerfd is armed on the
+*                    earliest deadline (see 'smtp-c_cfg.h  SMTPc_CFG_ASYNC_TIMEOUT_MS').
+*
+*                (c) Jobs are submitted from any task, through a lock-free list, & handed to the loop
+*                    through an eventfd.  Their host name is resolved by the submitting task, so that no
+*                    name lookup blocks the loop.
+*
+*            (2) The socket identifiers MUST be descriptors, as with the POSIX sockets transport (see
+*                'Transport/Posix/smtp-c_transport_posix.h').
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  SMTPc_REACTOR_EPOLL_MODULE_PRESENT
+#define  SMTPc_REACTOR_EPOLL_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+
+#include  <Source/smtp-c.h>
+
+
+/*
+*********************************************************************************************************
+*                                             DATA TYPES
+*
+* Note(s) : (1) The structure is owned by the application & initialized by SMTPc_ReactorEpoll_Init(); its
+*               members MUST NOT be accessed by the application.
+*
+*           (2) The jobs in progress are linked through their 'NextPtr' & 'PrevPtr' members (see 'smtp-c.h
+*               SMTPc_ASYNC  Note #3'), oldest progress first.
+*
+*           (3) The jobs submitted are pushed on a lock-free stack, through their 'NextPtr' member, & the stop
+*               request is set atomically : both are only taken by the reactor task, after it read the
+*               eventfd (see 'smtp-c_reactor_epoll.c  Note #1').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+typedef  struct  smtpc_reactor_epoll {
+    int               EpollFd;                                  /* Epoll instance.                                      */
+    int               WakeFd;                                   /* Eventfd signaled on submission & stop.               */
+    int               TimerFd;                                  /* Timerfd armed on the earliest deadline.              */
+    CPU_BOOLEAN       TimerArmed;                               /* Timer armed ...                                      */
+    SMTPc_TS_MS       TimerTS;                                  /* ... for the job last progressing at this time.       */
+
+    SMTPc_ASYNC      *SubmitPtr;                                /* Jobs submitted, last first (see Note #3).            */
+    CPU_BOOLEAN       StopReq;                                  /* Stop requested by SMTPc_ReactorEpoll_Stop().         */
+
+    SMTPc_ASYNC      *JobHeadPtr;                               /* Jobs in progress (see Note #2).                      */
+    SMTPc_ASYNC      *JobTailPtr;
+    CPU_INT32U        JobNbr;                                   /* Nbr of jobs in progress.                             */
+} SMTPc_REACTOR_EPOLL;
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+void        SMTPc_ReactorEpoll_Init  (SMTPc_REACTOR_EPOLL      *p_reactor,
+                                      SMTPc_ERR                *p_err);
+
+void        SMTPc_ReactorEpoll_Submit(SMTPc_REACTOR_EPOLL      *p_reactor,
+                                      SMTPc_ASYNC              *p_async,
+                                      CPU_CHAR                 *p_host_name,
+                                      CPU_INT16U                port,
+                                      CPU_CHAR                 *p_username,
+                                      CPU_CHAR                 *p_pwd,
+                                      SMTPc_SECURE_CFG         *p_secure_cfg,
+                                      SMTPc_MSG                *p_msg,
+                                      SMTPc_ASYNC_CMPL_FNCT     cmpl_fnct,
+                                      void                     *p_cmpl_arg,
+                                      SMTPc_ERR                *p_err);
+
+void        SMTPc_ReactorEpoll_Run   (SMTPc_REACTOR_EPOLL      *p_reactor,
+                                      SMTPc_ERR                *p_err);
+
+void        SMTPc_ReactorEpoll_Stop  (SMTPc_REACTOR_EPOLL      *p_reactor);
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of smtp-c reactor epoll module include.          */
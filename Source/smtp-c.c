@@ -25,6 +25,7 @@
 * Note(s)  : (1) This code implements a subset of the SMTP protocol (RFC 2821).  More precisely, the
 *                following commands have been implemented:
 *
+*                  EHLO (RFC 1869, falls back to HELO)
 *                  HELO
 *                  AUTH (if enabled)
 *                  MAIL
@@ -33,6 +34,9 @@
 *                  RSET
 *                  NOOP
 *                  QUIT
+*
+*                The PIPELINING service extension (RFC 2920) is used for the envelope when the server
+*                supports it, and to chain the messages of a batch (see 'SMTPc_SendMsgBatch()').
 *********************************************************************************************************
 */
 
@@ -46,6 +50,14 @@
 #define    SMTPc_MODULE
 #include  "smtp-c.h"
 
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)                      /* Base64 kernels (see 'SMTPc_B64EncSet()').            */
+#if   (defined(__x86_64__)  && (defined(__GNUC__) || defined(__clang__)))
+#include  <immintrin.h>
+#elif (defined(__aarch64__) && defined(__ARM_NEON))
+#include  <arm_neon.h>
+#endif
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -53,6 +65,139 @@
 *********************************************************************************************************
 */
 
+#define  SMTPc_POOL_HOST_NAME_LEN               SMTPc_CAP_CACHE_HOST_NAME_LEN
+
+#define  SMTPc_POOL_FNV_OFFSET_BASIS                    2166136261u
+#define  SMTPc_POOL_FNV_PRIME                             16777619u
+
+#define  SMTPc_EOM_SIZE                         (sizeof(SMTPc_EOM) - 1u)
+
+                                                                /* Last BDAT chunk, see 'SMTPc_BuildEOM()  Note #2'.    */
+#define  SMTPc_BDAT_EOM                         SMTPc_CMD_BDAT " 2 LAST" SMTPc_CRLF SMTPc_CRLF
+#define  SMTPc_BDAT_EOM_SIZE                    (sizeof(SMTPc_BDAT_EOM) - 1u)
+
+#define  SMTPc_BDAT_CMD_BUF_LEN                           20u   /* "BDAT " + 10 digits + CRLF + NUL.                    */
+#define  SMTPc_BDAT_MAX_PEND                               4u   /* Max nbr of BDAT chunks not replied to.               */
+
+#if     (SMTPc_CFG_BDAT_CHUNK_LEN > 0u)                         /* Msg content tx'd with BDAT (see 'SMTPc_TxData()').   */
+#define  SMTPc_BDAT_EN(p_sess)                ((DEF_BIT_IS_SET((p_sess)->Caps.Flags, SMTPc_CAP_CHUNKING) == DEF_YES) && \
+                                                ((p_sess)->DataOnly == DEF_NO))
+#else
+#define  SMTPc_BDAT_EN(p_sess)                  DEF_NO
+#endif
+
+                                                                /* Transparency encoder (see 'SMTPc_TxContent()').      */
+#define  SMTPc_ENC_COPY_TH                               256u   /* Min len of runs tx'd without copy.                   */
+
+#define  SMTPc_ENC_STATE_NONE                   DEF_BIT_NONE
+#define  SMTPc_ENC_STATE_CR                     DEF_BIT_00      /* Last char tx'd was a CR.                             */
+#define  SMTPc_ENC_STATE_BOL                    DEF_BIT_01      /* Next char begins a line.                             */
+
+                                                                /* Word rd from an octet buf (see 'SMTPc_EncScanLF()'). */
+#if     (defined(__GNUC__) || defined(__clang__))
+#define  SMTPc_ENC_WORD_RD(p_word, p_src)       __builtin_memcpy((p_word), (p_src), sizeof(CPU_DATA))
+#else
+#define  SMTPc_ENC_WORD_RD(p_word, p_src)       Mem_Copy((p_word), (p_src), sizeof(CPU_DATA))
+#endif
+
+                                                                /* MIME multipart (see 'SMTPc_TxAttach()').             */
+#define  SMTPc_MIME_BOUNDARY_PREFIX             "=_SMTPc_"
+#define  SMTPc_MIME_TYPE_BODY                   "text/plain"
+#define  SMTPc_MIME_TYPE_ATTACH                 "application/octet-stream"
+#define  SMTPc_MIME_TYPE_MULTIPART              "multipart/mixed; boundary=\""
+
+#define  SMTPc_B64_LINE_LEN                               76u   /* Max len of base64 lines (see RFC #2045).             */
+#define  SMTPc_B64_LINE_NBR_GRP                (SMTPc_B64_LINE_LEN / 4u)
+
+                                                                /* Base64 kernels (see 'SMTPc_B64EncSet()').            */
+#if    ((SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED) && \
+         defined(__x86_64__)                  && \
+        (defined(__GNUC__) || defined(__clang__)))
+#define  SMTPc_B64_X86_EN                       DEF_ENABLED     /* SSE2 & AVX2 kernels.                                 */
+#else
+#define  SMTPc_B64_X86_EN                       DEF_DISABLED
+#endif
+
+#if    ((SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED) && \
+         defined(__aarch64__)                 && \
+         defined(__ARM_NEON))
+#define  SMTPc_B64_NEON_EN                      DEF_ENABLED     /* NEON kernel.                                         */
+#else
+#define  SMTPc_B64_NEON_EN                      DEF_DISABLED
+#endif
+
+                                                                /* Quoted-printable (see 'SMTPc_TxQP()').               */
+#define  SMTPc_QP_LINE_LEN                                76u   /* Max len of QP lines, incl. soft line break.          */
+#define  SMTPc_QP_OUT_MAX_LEN                             16u   /* Max nbr of chars output for one octet.               */
+
+#define  SMTPc_QP_CLASS_SAFE                               0u   /* Octet sent as is.                                    */
+#define  SMTPc_QP_CLASS_ESC                                1u   /* Octet escaped as "=XX".                              */
+#define  SMTPc_QP_CLASS_WS                                 2u   /* White space, escaped at end of line.                 */
+#define  SMTPc_QP_CLASS_CR                                 3u
+#define  SMTPc_QP_CLASS_LF                                 4u
+
+#define  SMTPc_MIME_ENC_SAMPLE_LEN                       512u   /* Nbr of octets sampled by SMTPc_MIMEEncSel().         */
+
+                                                                /* Async job states (see 'SMTPc_AsyncStep()').          */
+#define  SMTPc_ASYNC_STATE_IDLE                            0u   /* Job not submitted, or over.                          */
+#define  SMTPc_ASYNC_STATE_CONN                            1u   /* Conn to srv to open.                                 */
+#define  SMTPc_ASYNC_STATE_GREETING                        2u   /* Waiting for srv greeting.                            */
+#define  SMTPc_ASYNC_STATE_EHLO                            3u   /* Waiting for EHLO reply.                              */
+#define  SMTPc_ASYNC_STATE_HELO                            4u   /* Waiting for HELO reply.                              */
+#define  SMTPc_ASYNC_STATE_AUTH                            5u   /* Waiting for AUTH reply.                              */
+#define  SMTPc_ASYNC_STATE_MAIL                            6u   /* Waiting for MAIL reply.                              */
+#define  SMTPc_ASYNC_STATE_RCPT                            7u   /* Waiting for RCPT reply.                              */
+#define  SMTPc_ASYNC_STATE_DATA                            8u   /* Waiting for DATA reply.                              */
+#define  SMTPc_ASYNC_STATE_CONTENT                         9u   /* Tx'ing msg content.                                  */
+#define  SMTPc_ASYNC_STATE_EOM                            10u   /* Waiting for reply to msg content.                    */
+#define  SMTPc_ASYNC_STATE_QUIT                           11u   /* Waiting for QUIT reply.                              */
+
+                                                                /* Submission ring (see 'SMTPc_QueueRingSubmit()').     */
+#define  SMTPc_QUEUE_RING_MASK                  (SMTPc_CFG_QUEUE_RING_SIZE - 1u)
+#define  SMTPc_QUEUE_RING_LAT_HIST_NBR                    33u   /* 1 bucket per bit of CPU_TS32, plus 1 for 0.          */
+
+                                                                /* Ring atomic ops (see 'smtp-c_cfg.h  Note #15e').     */
+#if    ((SMTPc_CFG_QUEUE_EN             == DEF_ENABLED) && \
+        (SMTPc_CFG_QUEUE_RING_SIZE      >  0u         ) && \
+        (SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED))
+#ifndef  SMTPc_ATOMIC_LD32
+#if     (defined(__GNUC__) || defined(__clang__))
+#define  SMTPc_ATOMIC_LD32(p_val)               __atomic_load_n((p_val), __ATOMIC_SEQ_CST)
+#define  SMTPc_ATOMIC_ST32(p_val, val)          __atomic_store_n((p_val), (val), __ATOMIC_SEQ_CST)
+#define  SMTPc_ATOMIC_ADD32(p_val, val)         __atomic_fetch_add((p_val), (val), __ATOMIC_RELAXED)
+#define  SMTPc_ATOMIC_CAS32(p_val, p_exp, val)  __atomic_compare_exchange_n((p_val), (p_exp), (val), DEF_NO, \
+                                                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+#else
+#error  "SMTPc_ATOMIC_xxx32 not #define'd in 'smtp-c_cfg.h' [MUST be if SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED]"
+#endif
+#endif
+#endif
+
+                                                                /* Spool recs (see 'SMTPc_SpoolSubmit()').              */
+#define  SMTPc_SPOOL_REC_MAGIC                   0x4C4F5053u    /* "SPOL".                                              */
+#define  SMTPc_SPOOL_REC_TYPE_MSG                          1u   /* Msg to send.                                         */
+#define  SMTPc_SPOOL_REC_TYPE_DONE                         2u   /* Msg done, sent or not.                               */
+                                                                /* Nbr of mboxes of a msg envelope.                     */
+#define  SMTPc_SPOOL_MBOX_NBR                   (1u + SMTPc_MSG_RCPT_NBR_MAX)
+                                                                /* Max len of envelope (see 'SMTPc_SpoolEnvBuild()').   */
+#define  SMTPc_SPOOL_ENV_LEN                    ((SMTPc_SPOOL_MBOX_NBR * SMTPc_MBOX_ADDR_LEN) + 3u)
+
+                                                                /* Spooled msg states.                                  */
+#define  SMTPc_SPOOL_STATE_FREE                            0u   /* Entry free.                                          */
+#define  SMTPc_SPOOL_STATE_WR                              1u   /* Rec wr'n, not synced yet.                            */
+#define  SMTPc_SPOOL_STATE_SYNCING                         2u   /* Rec wr'n, being synced by the spool task.            */
+#define  SMTPc_SPOOL_STATE_SYNCED                          3u   /* Rec durable, job to submit.                          */
+#define  SMTPc_SPOOL_STATE_QUEUED                          4u   /* Job submitted to the outbound queue.                 */
+#define  SMTPc_SPOOL_STATE_DONE                            5u   /* Job done, "done" rec to wr.                          */
+
+                                                                /* Retry timer wheel (see 'SMTPc_SchedTick()').         */
+#define  SMTPc_SCHED_LVL_NBR                               4u   /* Nbr of levels of the wheel.                          */
+#define  SMTPc_SCHED_SLOT_BITS                             6u   /* Nbr of tick bits per level, i.e. 64 slots per level. */
+#define  SMTPc_SCHED_SLOT_NBR                   (1u << SMTPc_SCHED_SLOT_BITS)
+#define  SMTPc_SCHED_SLOT_MASK                  (SMTPc_SCHED_SLOT_NBR - 1u)
+                                                                /* Max dly (ticks), 2^24 ticks.                         */
+#define  SMTPc_SCHED_DLY_MAX_TICKS              ((1uL << (SMTPc_SCHED_LVL_NBR * SMTPc_SCHED_SLOT_BITS)) - 1u)
+
 
 /*
 *********************************************************************************************************
@@ -67,6 +212,73 @@
 *********************************************************************************************************
 */
 
+typedef  struct  smtpc_mime_enc_state {                         /* State of the base64 & QP encoders.                   */
+    CPU_INT08U   Carry[3];                                      /* Octets not encoded yet, QP : pending white space.    */
+    CPU_INT08U   CarryLen;
+    CPU_INT32U   LineLen;                                       /* Len of the current line.                             */
+    CPU_INT32U   BufLen;                                        /* Nbr of octets in the tx buf.                         */
+    CPU_BOOLEAN  PendCR;                                        /* QP : last octet was a CR.                            */
+} SMTPc_MIME_ENC_STATE;
+
+typedef  struct  smtpc_keyword {                                /* EHLO keyword to capability flag association.         */
+    const  CPU_CHAR    *Str;
+           CPU_INT16U   Flag;
+} SMTPc_KEYWORD;
+
+typedef  struct  smtpc_cap_cache_entry {                        /* Srv capabilities cache entry.                        */
+    CPU_CHAR     HostName[SMTPc_CAP_CACHE_HOST_NAME_LEN];       /* Host name of the srv, empty if entry is free.        */
+    CPU_INT16U   Port;                                          /* TCP port of the srv.                                 */
+    SMTPc_CAPS   Caps;                                          /* Capabilities learned from the last EHLO reply.       */
+    CPU_INT32U   UseCtr;                                        /* Value of SMTPc_CapCacheUseCtr on last access.        */
+} SMTPc_CAP_CACHE_ENTRY;
+
+typedef  struct  smtpc_pool_entry {                             /* Connection pool entry.                               */
+    SMTPc_SESSION             Sess;                             /* Session.                                             */
+    CPU_BOOLEAN               InUse;                            /* Session leased by a task.                            */
+    CPU_BOOLEAN               IsConn;                           /* Session connected, DEF_NO if entry is free.          */
+    SMTPc_TS_MS               IdleTS;                           /* Time the session was last released.                  */
+    CPU_CHAR                  HostName[SMTPc_POOL_HOST_NAME_LEN];
+    CPU_INT16U                Port;                             /* Parameters the session was connected with.           */
+    SMTPc_SECURE_CFG         *SecureCfgPtr;
+    CPU_INT32U                CredHash;
+} SMTPc_POOL_ENTRY;
+
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)                      /* Base64 kernel (see 'SMTPc_B64EncSet()').             */
+typedef  void  (*SMTPc_B64_ENC_FNCT)(const  CPU_INT08U  *p_src,
+                                             CPU_INT32U   nbr_grp,
+                                             CPU_CHAR    *p_dest);
+#endif
+
+#if ((SMTPc_CFG_QUEUE_EN        == DEF_ENABLED) && \
+     (SMTPc_CFG_QUEUE_RING_SIZE >  0u         ))
+typedef  struct  smtpc_queue_ring_slot {                        /* Ring slot (see 'SMTPc_QueueRingSubmit()  Note #3').  */
+    CPU_INT32U   Seq;                                           /* Pos the slot is ready for.                          */
+    SMTPc_JOB   *JobPtr;                                        /* Job put in the slot.                                 */
+    CPU_TS32     TS;                                            /* Time the job was put in the slot.                    */
+} SMTPc_QUEUE_RING_SLOT;
+#endif
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+typedef  struct  smtpc_spool_rec_hdr {                          /* Spool rec hdr, followed by 'Len' octets of data.     */
+    CPU_INT32U   Magic;                                         /* SMTPc_SPOOL_REC_MAGIC.                               */
+    CPU_INT32U   Id;                                            /* Id of the msg.                                       */
+    CPU_INT32U   Len;                                           /* Len of the data.                                     */
+    CPU_INT16U   Type;                                          /* SMTPc_SPOOL_REC_TYPE_xxx.                            */
+    CPU_INT16U   Rsvd;
+    CPU_INT32U   Chk;                                           /* Hash of the hdr & data, see 'SMTPc_SpoolRecHash()'.  */
+} SMTPc_SPOOL_REC_HDR;
+
+typedef  struct  smtpc_spool_entry {                            /* Spooled msg.                                         */
+    SMTPc_JOB    Job;                                           /* Job submitted to the outbound queue.                 */
+    SMTPc_MSG    Msg;                                           /* Msg loaded from the rec.                             */
+    SMTPc_MBOX   MboxTbl[SMTPc_SPOOL_MBOX_NBR];                 /* Sender & recipients of the msg.                      */
+    CPU_INT32U   Id;                                            /* Id of the msg.                                       */
+    CPU_INT32U   SegId;                                         /* Seg holding the msg rec.                             */
+    CPU_INT08U   State;                                         /* SMTPc_SPOOL_STATE_xxx.                               */
+    CPU_INT08U  *RecPtr;                                        /* Msg rec : hdr, envelope & rendered content.          */
+} SMTPc_SPOOL_ENTRY;
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -74,12 +286,116 @@
 *********************************************************************************************************
 */
 
+static  const  SMTPc_KEYWORD  SMTPc_CapKeywordTbl[] = {
+    { SMTPc_EXT_PIPELINING, SMTPc_CAP_PIPELINING },
+    { SMTPc_EXT_SIZE,       SMTPc_CAP_SIZE       },
+    { SMTPc_EXT_8BITMIME,   SMTPc_CAP_8BITMIME   },
+    { SMTPc_EXT_CHUNKING,   SMTPc_CAP_CHUNKING   },
+    { SMTPc_EXT_STARTTLS,   SMTPc_CAP_STARTTLS   },
+    { SMTPc_EXT_AUTH,       SMTPc_CAP_AUTH       },
+    { SMTPc_EXT_ENHSTATUS,  SMTPc_CAP_ENHSTATUS  }
+};
+
+#if ((SMTPc_CFG_B64_PAIR_TBL_EN != DEF_ENABLED) || \
+     (SMTPc_B64_NEON_EN         == DEF_ENABLED))
+static  const  CPU_CHAR  SMTPc_B64EncTbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+#endif
 
-/*
-*********************************************************************************************************
-*                                          LOCAL DATA TYPES
-*********************************************************************************************************
-*/
+static  const  CPU_CHAR    SMTPc_QPHexTbl[] = "0123456789ABCDEF";
+
+static  const  CPU_INT08U  SMTPc_QPClassTbl[256] = {            /* Class of each octet (see 'SMTPc_TxQP()').            */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 2u, 4u, 1u, 1u, 3u, 1u, 1u,  /* 0x00 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0x10 */
+    2u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,  /* 0x20 */
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u, 0u, 0u,  /* 0x30 */
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,  /* 0x40 */
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,  /* 0x50 */
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,  /* 0x60 */
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u,  /* 0x70 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0x80 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0x90 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0xA0 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0xB0 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0xC0 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0xD0 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,  /* 0xE0 */
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u   /* 0xF0 */
+};
+
+#if (SMTPc_CFG_B64_PAIR_TBL_EN == DEF_ENABLED)                  /* Pairs of base64 chars, indexed by 12-bit val.        */
+static  const  CPU_CHAR  SMTPc_B64EncPairTbl[] =
+    "AAABACADAEAFAGAHAIAJAKALAMANAOAPAQARASATAUAVAWAXAYAZAaAbAcAdAeAfAgAhAiAjAkAlAmAnAoApAqArAsAtAuAvAwAxAyAzA0A1A2A3A4A5A6A7A8A9A+A/"
+    "BABBBCBDBEBFBGBHBIBJBKBLBMBNBOBPBQBRBSBTBUBVBWBXBYBZBaBbBcBdBeBfBgBhBiBjBkBlBmBnBoBpBqBrBsBtBuBvBwBxByBzB0B1B2B3B4B5B6B7B8B9B+B/"
+    "CACBCCCDCECFCGCHCICJCKCLCMCNCOCPCQCRCSCTCUCVCWCXCYCZCaCbCcCdCeCfCgChCiCjCkClCmCnCoCpCqCrCsCtCuCvCwCxCyCzC0C1C2C3C4C5C6C7C8C9C+C/"
+    "DADBDCDDDEDFDGDHDIDJDKDLDMDNDODPDQDRDSDTDUDVDWDXDYDZDaDbDcDdDeDfDgDhDiDjDkDlDmDnDoDpDqDrDsDtDuDvDwDxDyDzD0D1D2D3D4D5D6D7D8D9D+D/"
+    "EAEBECEDEEEFEGEHEIEJEKELEMENEOEPEQERESETEUEVEWEXEYEZEaEbEcEdEeEfEgEhEiEjEkElEmEnEoEpEqErEsEtEuEvEwExEyEzE0E1E2E3E4E5E6E7E8E9E+E/"
+    "FAFBFCFDFEFFFGFHFIFJFKFLFMFNFOFPFQFRFSFTFUFVFWFXFYFZFaFbFcFdFeFfFgFhFiFjFkFlFmFnFoFpFqFrFsFtFuFvFwFxFyFzF0F1F2F3F4F5F6F7F8F9F+F/"
+    "GAGBGCGDGEGFGGGHGIGJGKGLGMGNGOGPGQGRGSGTGUGVGWGXGYGZGaGbGcGdGeGfGgGhGiGjGkGlGmGnGoGpGqGrGsGtGuGvGwGxGyGzG0G1G2G3G4G5G6G7G8G9G+G/"
+    "HAHBHCHDHEHFHGHHHIHJHKHLHMHNHOHPHQHRHSHTHUHVHWHXHYHZHaHbHcHdHeHfHgHhHiHjHkHlHmHnHoHpHqHrHsHtHuHvHwHxHyHzH0H1H2H3H4H5H6H7H8H9H+H/"
+    "IAIBICIDIEIFIGIHIIIJIKILIMINIOIPIQIRISITIUIVIWIXIYIZIaIbIcIdIeIfIgIhIiIjIkIlImInIoIpIqIrIsItIuIvIwIxIyIzI0I1I2I3I4I5I6I7I8I9I+I/"
+    "JAJBJCJDJEJFJGJHJIJJJKJLJMJNJOJPJQJRJSJTJUJVJWJXJYJZJaJbJcJdJeJfJgJhJiJjJkJlJmJnJoJpJqJrJsJtJuJvJwJxJyJzJ0J1J2J3J4J5J6J7J8J9J+J/"
+    "KAKBKCKDKEKFKGKHKIKJKKKLKMKNKOKPKQKRKSKTKUKVKWKXKYKZKaKbKcKdKeKfKgKhKiKjKkKlKmKnKoKpKqKrKsKtKuKvKwKxKyKzK0K1K2K3K4K5K6K7K8K9K+K/"
+    "LALBLCLDLELFLGLHLILJLKLLLMLNLOLPLQLRLSLTLULVLWLXLYLZLaLbLcLdLeLfLgLhLiLjLkLlLmLnLoLpLqLrLsLtLuLvLwLxLyLzL0L1L2L3L4L5L6L7L8L9L+L/"
+    "MAMBMCMDMEMFMGMHMIMJMKMLMMMNMOMPMQMRMSMTMUMVMWMXMYMZMaMbMcMdMeMfMgMhMiMjMkMlMmMnMoMpMqMrMsMtMuMvMwMxMyMzM0M1M2M3M4M5M6M7M8M9M+M/"
+    "NANBNCNDNENFNGNHNINJNKNLNMNNNONPNQNRNSNTNUNVNWNXNYNZNaNbNcNdNeNfNgNhNiNjNkNlNmNnNoNpNqNrNsNtNuNvNwNxNyNzN0N1N2N3N4N5N6N7N8N9N+N/"
+    "OAOBOCODOEOFOGOHOIOJOKOLOMONOOOPOQOROSOTOUOVOWOXOYOZOaObOcOdOeOfOgOhOiOjOkOlOmOnOoOpOqOrOsOtOuOvOwOxOyOzO0O1O2O3O4O5O6O7O8O9O+O/"
+    "PAPBPCPDPEPFPGPHPIPJPKPLPMPNPOPPPQPRPSPTPUPVPWPXPYPZPaPbPcPdPePfPgPhPiPjPkPlPmPnPoPpPqPrPsPtPuPvPwPxPyPzP0P1P2P3P4P5P6P7P8P9P+P/"
+    "QAQBQCQDQEQFQGQHQIQJQKQLQMQNQOQPQQQRQSQTQUQVQWQXQYQZQaQbQcQdQeQfQgQhQiQjQkQlQmQnQoQpQqQrQsQtQuQvQwQxQyQzQ0Q1Q2Q3Q4Q5Q6Q7Q8Q9Q+Q/"
+    "RARBRCRDRERFRGRHRIRJRKRLRMRNRORPRQRRRSRTRURVRWRXRYRZRaRbRcRdReRfRgRhRiRjRkRlRmRnRoRpRqRrRsRtRuRvRwRxRyRzR0R1R2R3R4R5R6R7R8R9R+R/"
+    "SASBSCSDSESFSGSHSISJSKSLSMSNSOSPSQSRSSSTSUSVSWSXSYSZSaSbScSdSeSfSgShSiSjSkSlSmSnSoSpSqSrSsStSuSvSwSxSySzS0S1S2S3S4S5S6S7S8S9S+S/"
+    "TATBTCTDTETFTGTHTITJTKTLTMTNTOTPTQTRTSTTTUTVTWTXTYTZTaTbTcTdTeTfTgThTiTjTkTlTmTnToTpTqTrTsTtTuTvTwTxTyTzT0T1T2T3T4T5T6T7T8T9T+T/"
+    "UAUBUCUDUEUFUGUHUIUJUKULUMUNUOUPUQURUSUTUUUVUWUXUYUZUaUbUcUdUeUfUgUhUiUjUkUlUmUnUoUpUqUrUsUtUuUvUwUxUyUzU0U1U2U3U4U5U6U7U8U9U+U/"
+    "VAVBVCVDVEVFVGVHVIVJVKVLVMVNVOVPVQVRVSVTVUVVVWVXVYVZVaVbVcVdVeVfVgVhViVjVkVlVmVnVoVpVqVrVsVtVuVvVwVxVyVzV0V1V2V3V4V5V6V7V8V9V+V/"
+    "WAWBWCWDWEWFWGWHWIWJWKWLWMWNWOWPWQWRWSWTWUWVWWWXWYWZWaWbWcWdWeWfWgWhWiWjWkWlWmWnWoWpWqWrWsWtWuWvWwWxWyWzW0W1W2W3W4W5W6W7W8W9W+W/"
+    "XAXBXCXDXEXFXGXHXIXJXKXLXMXNXOXPXQXRXSXTXUXVXWXXXYXZXaXbXcXdXeXfXgXhXiXjXkXlXmXnXoXpXqXrXsXtXuXvXwXxXyXzX0X1X2X3X4X5X6X7X8X9X+X/"
+    "YAYBYCYDYEYFYGYHYIYJYKYLYMYNYOYPYQYRYSYTYUYVYWYXYYYZYaYbYcYdYeYfYgYhYiYjYkYlYmYnYoYpYqYrYsYtYuYvYwYxYyYzY0Y1Y2Y3Y4Y5Y6Y7Y8Y9Y+Y/"
+    "ZAZBZCZDZEZFZGZHZIZJZKZLZMZNZOZPZQZRZSZTZUZVZWZXZYZZZaZbZcZdZeZfZgZhZiZjZkZlZmZnZoZpZqZrZsZtZuZvZwZxZyZzZ0Z1Z2Z3Z4Z5Z6Z7Z8Z9Z+Z/"
+    "aAaBaCaDaEaFaGaHaIaJaKaLaMaNaOaPaQaRaSaTaUaVaWaXaYaZaaabacadaeafagahaiajakalamanaoapaqarasatauavawaxayaza0a1a2a3a4a5a6a7a8a9a+a/"
+    "bAbBbCbDbEbFbGbHbIbJbKbLbMbNbObPbQbRbSbTbUbVbWbXbYbZbabbbcbdbebfbgbhbibjbkblbmbnbobpbqbrbsbtbubvbwbxbybzb0b1b2b3b4b5b6b7b8b9b+b/"
+    "cAcBcCcDcEcFcGcHcIcJcKcLcMcNcOcPcQcRcScTcUcVcWcXcYcZcacbcccdcecfcgchcicjckclcmcncocpcqcrcsctcucvcwcxcyczc0c1c2c3c4c5c6c7c8c9c+c/"
+    "dAdBdCdDdEdFdGdHdIdJdKdLdMdNdOdPdQdRdSdTdUdVdWdXdYdZdadbdcdddedfdgdhdidjdkdldmdndodpdqdrdsdtdudvdwdxdydzd0d1d2d3d4d5d6d7d8d9d+d/"
+    "eAeBeCeDeEeFeGeHeIeJeKeLeMeNeOePeQeReSeTeUeVeWeXeYeZeaebecedeeefegeheiejekelemeneoepeqereseteuevewexeyeze0e1e2e3e4e5e6e7e8e9e+e/"
+    "fAfBfCfDfEfFfGfHfIfJfKfLfMfNfOfPfQfRfSfTfUfVfWfXfYfZfafbfcfdfefffgfhfifjfkflfmfnfofpfqfrfsftfufvfwfxfyfzf0f1f2f3f4f5f6f7f8f9f+f/"
+    "gAgBgCgDgEgFgGgHgIgJgKgLgMgNgOgPgQgRgSgTgUgVgWgXgYgZgagbgcgdgegfggghgigjgkglgmgngogpgqgrgsgtgugvgwgxgygzg0g1g2g3g4g5g6g7g8g9g+g/"
+    "hAhBhChDhEhFhGhHhIhJhKhLhMhNhOhPhQhRhShThUhVhWhXhYhZhahbhchdhehfhghhhihjhkhlhmhnhohphqhrhshthuhvhwhxhyhzh0h1h2h3h4h5h6h7h8h9h+h/"
+    "iAiBiCiDiEiFiGiHiIiJiKiLiMiNiOiPiQiRiSiTiUiViWiXiYiZiaibicidieifigihiiijikiliminioipiqirisitiuiviwixiyizi0i1i2i3i4i5i6i7i8i9i+i/"
+    "jAjBjCjDjEjFjGjHjIjJjKjLjMjNjOjPjQjRjSjTjUjVjWjXjYjZjajbjcjdjejfjgjhjijjjkjljmjnjojpjqjrjsjtjujvjwjxjyjzj0j1j2j3j4j5j6j7j8j9j+j/"
+    "kAkBkCkDkEkFkGkHkIkJkKkLkMkNkOkPkQkRkSkTkUkVkWkXkYkZkakbkckdkekfkgkhkikjkkklkmknkokpkqkrksktkukvkwkxkykzk0k1k2k3k4k5k6k7k8k9k+k/"
+    "lAlBlClDlElFlGlHlIlJlKlLlMlNlOlPlQlRlSlTlUlVlWlXlYlZlalblcldlelflglhliljlklllmlnlolplqlrlsltlulvlwlxlylzl0l1l2l3l4l5l6l7l8l9l+l/"
+    "mAmBmCmDmEmFmGmHmImJmKmLmMmNmOmPmQmRmSmTmUmVmWmXmYmZmambmcmdmemfmgmhmimjmkmlmmmnmompmqmrmsmtmumvmwmxmymzm0m1m2m3m4m5m6m7m8m9m+m/"
+    "nAnBnCnDnEnFnGnHnInJnKnLnMnNnOnPnQnRnSnTnUnVnWnXnYnZnanbncndnenfngnhninjnknlnmnnnonpnqnrnsntnunvnwnxnynzn0n1n2n3n4n5n6n7n8n9n+n/"
+    "oAoBoCoDoEoFoGoHoIoJoKoLoMoNoOoPoQoRoSoToUoVoWoXoYoZoaobocodoeofogohoiojokolomonooopoqorosotouovowoxoyozo0o1o2o3o4o5o6o7o8o9o+o/"
+    "pApBpCpDpEpFpGpHpIpJpKpLpMpNpOpPpQpRpSpTpUpVpWpXpYpZpapbpcpdpepfpgphpipjpkplpmpnpopppqprpsptpupvpwpxpypzp0p1p2p3p4p5p6p7p8p9p+p/"
+    "qAqBqCqDqEqFqGqHqIqJqKqLqMqNqOqPqQqRqSqTqUqVqWqXqYqZqaqbqcqdqeqfqgqhqiqjqkqlqmqnqoqpqqqrqsqtquqvqwqxqyqzq0q1q2q3q4q5q6q7q8q9q+q/"
+    "rArBrCrDrErFrGrHrIrJrKrLrMrNrOrPrQrRrSrTrUrVrWrXrYrZrarbrcrdrerfrgrhrirjrkrlrmrnrorprqrrrsrtrurvrwrxryrzr0r1r2r3r4r5r6r7r8r9r+r/"
+    "sAsBsCsDsEsFsGsHsIsJsKsLsMsNsOsPsQsRsSsTsUsVsWsXsYsZsasbscsdsesfsgshsisjskslsmsnsospsqsrssstsusvswsxsyszs0s1s2s3s4s5s6s7s8s9s+s/"
+    "tAtBtCtDtEtFtGtHtItJtKtLtMtNtOtPtQtRtStTtUtVtWtXtYtZtatbtctdtetftgthtitjtktltmtntotptqtrtstttutvtwtxtytzt0t1t2t3t4t5t6t7t8t9t+t/"
+    "uAuBuCuDuEuFuGuHuIuJuKuLuMuNuOuPuQuRuSuTuUuVuWuXuYuZuaubucudueufuguhuiujukulumunuoupuqurusutuuuvuwuxuyuzu0u1u2u3u4u5u6u7u8u9u+u/"
+    "vAvBvCvDvEvFvGvHvIvJvKvLvMvNvOvPvQvRvSvTvUvVvWvXvYvZvavbvcvdvevfvgvhvivjvkvlvmvnvovpvqvrvsvtvuvvvwvxvyvzv0v1v2v3v4v5v6v7v8v9v+v/"
+    "wAwBwCwDwEwFwGwHwIwJwKwLwMwNwOwPwQwRwSwTwUwVwWwXwYwZwawbwcwdwewfwgwhwiwjwkwlwmwnwowpwqwrwswtwuwvwwwxwywzw0w1w2w3w4w5w6w7w8w9w+w/"
+    "xAxBxCxDxExFxGxHxIxJxKxLxMxNxOxPxQxRxSxTxUxVxWxXxYxZxaxbxcxdxexfxgxhxixjxkxlxmxnxoxpxqxrxsxtxuxvxwxxxyxzx0x1x2x3x4x5x6x7x8x9x+x/"
+    "yAyByCyDyEyFyGyHyIyJyKyLyMyNyOyPyQyRySyTyUyVyWyXyYyZyaybycydyeyfygyhyiyjykylymynyoypyqyrysytyuyvywyxyyyzy0y1y2y3y4y5y6y7y8y9y+y/"
+    "zAzBzCzDzEzFzGzHzIzJzKzLzMzNzOzPzQzRzSzTzUzVzWzXzYzZzazbzczdzezfzgzhzizjzkzlzmznzozpzqzrzsztzuzvzwzxzyzzz0z1z2z3z4z5z6z7z8z9z+z/"
+    "0A0B0C0D0E0F0G0H0I0J0K0L0M0N0O0P0Q0R0S0T0U0V0W0X0Y0Z0a0b0c0d0e0f0g0h0i0j0k0l0m0n0o0p0q0r0s0t0u0v0w0x0y0z000102030405060708090+0/"
+    "1A1B1C1D1E1F1G1H1I1J1K1L1M1N1O1P1Q1R1S1T1U1V1W1X1Y1Z1a1b1c1d1e1f1g1h1i1j1k1l1m1n1o1p1q1r1s1t1u1v1w1x1y1z101112131415161718191+1/"
+    "2A2B2C2D2E2F2G2H2I2J2K2L2M2N2O2P2Q2R2S2T2U2V2W2X2Y2Z2a2b2c2d2e2f2g2h2i2j2k2l2m2n2o2p2q2r2s2t2u2v2w2x2y2z202122232425262728292+2/"
+    "3A3B3C3D3E3F3G3H3I3J3K3L3M3N3O3P3Q3R3S3T3U3V3W3X3Y3Z3a3b3c3d3e3f3g3h3i3j3k3l3m3n3o3p3q3r3s3t3u3v3w3x3y3z303132333435363738393+3/"
+    "4A4B4C4D4E4F4G4H4I4J4K4L4M4N4O4P4Q4R4S4T4U4V4W4X4Y4Z4a4b4c4d4e4f4g4h4i4j4k4l4m4n4o4p4q4r4s4t4u4v4w4x4y4z404142434445464748494+4/"
+    "5A5B5C5D5E5F5G5H5I5J5K5L5M5N5O5P5Q5R5S5T5U5V5W5X5Y5Z5a5b5c5d5e5f5g5h5i5j5k5l5m5n5o5p5q5r5s5t5u5v5w5x5y5z505152535455565758595+5/"
+    "6A6B6C6D6E6F6G6H6I6J6K6L6M6N6O6P6Q6R6S6T6U6V6W6X6Y6Z6a6b6c6d6e6f6g6h6i6j6k6l6m6n6o6p6q6r6s6t6u6v6w6x6y6z606162636465666768696+6/"
+    "7A7B7C7D7E7F7G7H7I7J7K7L7M7N7O7P7Q7R7S7T7U7V7W7X7Y7Z7a7b7c7d7e7f7g7h7i7j7k7l7m7n7o7p7q7r7s7t7u7v7w7x7y7z707172737475767778797+7/"
+    "8A8B8C8D8E8F8G8H8I8J8K8L8M8N8O8P8Q8R8S8T8U8V8W8X8Y8Z8a8b8c8d8e8f8g8h8i8j8k8l8m8n8o8p8q8r8s8t8u8v8w8x8y8z808182838485868788898+8/"
+    "9A9B9C9D9E9F9G9H9I9J9K9L9M9N9O9P9Q9R9S9T9U9V9W9X9Y9Z9a9b9c9d9e9f9g9h9i9j9k9l9m9n9o9p9q9r9s9t9u9v9w9x9y9z909192939495969798999+9/"
+    "+A+B+C+D+E+F+G+H+I+J+K+L+M+N+O+P+Q+R+S+T+U+V+W+X+Y+Z+a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p+q+r+s+t+u+v+w+x+y+z+0+1+2+3+4+5+6+7+8+9+++/"
+    "/A/B/C/D/E/F/G/H/I/J/K/L/M/N/O/P/Q/R/S/T/U/V/W/X/Y/Z/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y/z/0/1/2/3/4/5/6/7/8/9/+//";
+#endif
+
+static  const  SMTPc_KEYWORD  SMTPc_AuthMechKeywordTbl[] = {
+    { SMTPc_CMD_AUTH_MECHANISM_PLAIN,    SMTPc_AUTH_MECH_PLAIN    },
+    { SMTPc_CMD_AUTH_MECHANISM_LOGIN,    SMTPc_AUTH_MECH_LOGIN    },
+    { SMTPc_CMD_AUTH_MECHANISM_CRAM_MD5, SMTPc_AUTH_MECH_CRAM_MD5 },
+    { SMTPc_CMD_AUTH_MECHANISM_XOAUTH2,  SMTPc_AUTH_MECH_XOAUTH2  }
+};
 
 
 /*
@@ -88,6 +404,83 @@
 *********************************************************************************************************
 */
 
+static  SMTPc_SESSION          SMTPc_DfltSession;               /* Session used by SMTPc_Connect() & al.                */
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)                 /* Transport of all sessions (see SMTPc_TransportSet()).*/
+static  const  SMTPc_TRANSPORT_API  *SMTPc_TransportAPI_Ptr = &SMTPc_TransportAPI_Net;
+#else
+static  const  SMTPc_TRANSPORT_API  *SMTPc_TransportAPI_Ptr = (const SMTPc_TRANSPORT_API *)0;
+#endif
+
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)                      /* Base64 kernel (see SMTPc_B64EncSet()).               */
+static  SMTPc_B64_ENC_FNCT     SMTPc_B64EncFnct = (SMTPc_B64_ENC_FNCT)0;
+static  CPU_INT08U             SMTPc_B64EncSel  = SMTPc_B64_ENC_AUTO;
+#endif
+
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+static  SMTPc_CAP_CACHE_ENTRY  SMTPc_CapCacheTbl[SMTPc_CFG_CAP_CACHE_NBR_ENTRIES];
+static  CPU_INT32U             SMTPc_CapCacheUseCtr;
+#endif
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  SMTPc_POOL_ENTRY       SMTPc_PoolTbl[SMTPc_CFG_POOL_NBR_SESSIONS];
+#endif
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+static  SMTPc_ASYNC           *SMTPc_AsyncHeadPtr;              /* List of jobs polled by SMTPc_Poll().                 */
+static  SMTPc_ASYNC           *SMTPc_AsyncTailPtr;
+static  CPU_INT16U             SMTPc_AsyncNbr;                  /* Nbr of jobs in list.                                 */
+#endif
+
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+static  KAL_Q_HANDLE           SMTPc_QueueHandle;               /* Q of jobs submitted to the workers.                  */
+static  CPU_INT08U             SMTPc_QueueWorkerSessNbr;        /* Nbr of sessions of each worker.                      */
+static  CPU_BOOLEAN            SMTPc_QueueInitDone;
+static  CPU_BOOLEAN            SMTPc_QueueInitFailed;           /* Init failed after creating kernel objects.           */
+
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+static  SMTPc_QUEUE_RING_SLOT  SMTPc_QueueRingTbl[SMTPc_CFG_QUEUE_RING_SIZE];
+static  CPU_INT32U             SMTPc_QueueRingHead;             /* Nbr of slots ever claimed by the producers.          */
+static  CPU_INT32U             SMTPc_QueueRingTail;             /* Nbr of jobs  ever taken from the ring.               */
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+static  KAL_SEM_HANDLE         SMTPc_QueueRingSemHandle;        /* Sem posted when the ring is no longer empty.         */
+#endif
+
+static  CPU_INT32U             SMTPc_QueueRingSubmitCtr;        /* Ring stats (see 'smtp-c.h  SMTPc_QUEUE_RING_STATS'). */
+static  CPU_INT32U             SMTPc_QueueRingFullCtr;
+static  CPU_INT32U             SMTPc_QueueRingLatSumLo;         /* Sum of enqueue latencies (ts cnts), low  word.       */
+static  CPU_INT32U             SMTPc_QueueRingLatSumHi;         /* Sum of enqueue latencies (ts cnts), high word.       */
+static  CPU_TS32               SMTPc_QueueRingLatMax;
+static  CPU_INT32U             SMTPc_QueueRingLatHistTbl[SMTPc_QUEUE_RING_LAT_HIST_NBR];
+static  CPU_TS32               SMTPc_QueueRingDrainLatMax;      /* Max time spent by a job in the ring (ts cnts).       */
+#endif
+#endif
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  SMTPc_SPOOL_CFG        SMTPc_SpoolCfg;                  /* Copy of the spool cfg.                               */
+static  SMTPc_SPOOL_ENTRY     *SMTPc_SpoolEntryTbl;             /* Spooled msgs.                                        */
+static  CPU_INT32U             SMTPc_SpoolRecLenMax;            /* Size of the rec buf of each entry.                   */
+static  KAL_LOCK_HANDLE        SMTPc_SpoolLockHandle;           /* Lock protecting the entries & the storage.           */
+static  CPU_INT32U             SMTPc_SpoolSegIdFirst;           /* Oldest seg stored.                                   */
+static  CPU_INT32U             SMTPc_SpoolSegIdCur;             /* Seg recs are appended to.                            */
+static  CPU_INT32U             SMTPc_SpoolSegLen;               /* Len of the cur seg.                                  */
+static  CPU_INT32U             SMTPc_SpoolSegIdSync;            /* Oldest seg that MAY hold recs not synced.            */
+static  CPU_INT32U             SMTPc_SpoolIdNext;               /* Id of the next msg spooled.                          */
+static  CPU_INT32U             SMTPc_SpoolIdSynced;             /* Id up to which all msgs are durable.                 */
+static  CPU_BOOLEAN            SMTPc_SpoolInitDone;
+#endif
+
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+                                                                /* Timer wheel of scheduled jobs.                       */
+static  SMTPc_JOB             *SMTPc_SchedWheel[SMTPc_SCHED_LVL_NBR][SMTPc_SCHED_SLOT_NBR];
+static  CPU_INT32U             SMTPc_SchedTickCur;              /* Next tick to process.                                */
+static  KAL_LOCK_HANDLE        SMTPc_SchedLockHandle;           /* Lock protecting the wheel.                           */
+static  CPU_INT08U             SMTPc_SchedRetryNbrMax;          /* Retry cfg (see 'smtp-c.h  SMTPc_QUEUE_CFG').         */
+static  CPU_INT32U             SMTPc_SchedRetryDlyMin_ms;
+static  CPU_INT32U             SMTPc_SchedRetryDlyMax_ms;
+static  CPU_INT32U             SMTPc_SchedRandState;            /* State of the jitter generator.                       */
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -96,81 +489,478 @@
 */
 
                                                                 /* --------------------- RX FNCT'S -------------------- */
-static  CPU_CHAR    *SMTPc_RxReply      (NET_SOCK_ID   sock_id,
-                                         SMTPc_ERR    *perr);
+static  void         SMTPc_SessionInit  (SMTPc_SESSION *p_sess);
+
+static  SMTPc_REPLY *SMTPc_RxReply      (SMTPc_SESSION *p_sess,
+                                         SMTPc_ERR     *perr);
 
-static  void         SMTPc_ParseReply   (CPU_CHAR     *server_reply,
+static  void         SMTPc_RxBufReset   (SMTPc_RX_BUF *p_rx);
+
+static  CPU_INT16U   SMTPc_RxScan       (SMTPc_RX_BUF *p_rx);
+
+static  void         SMTPc_ReplyDecode  (SMTPc_REPLY  *p_reply,
+                                         CPU_CHAR     *p_buf,
+                                         CPU_INT16U    len);
+
+static  void         SMTPc_ParseReply   (SMTPc_REPLY  *p_reply,
                                          CPU_INT32U   *completion_code,
                                          SMTPc_ERR    *perr);
 
+static  void         SMTPc_ParseCaps    (SMTPc_REPLY  *p_reply,
+                                         SMTPc_CAPS   *p_caps);
+
+static  CPU_INT16U   SMTPc_ParseKeyword (CPU_CHAR            *p_tok,
+                                         CPU_SIZE_T           tok_len,
+                                         const SMTPc_KEYWORD *p_tbl,
+                                         CPU_SIZE_T           tbl_size);
+
                                                                 /* --------------------- TX FNCT'S -------------------- */
-static  void         SMTPc_SendBody     (NET_SOCK_ID   sock_id,
-                                         SMTPc_MSG    *msg,
-                                         SMTPc_ERR    *perr);
+static  void         SMTPc_TxMsg        (SMTPc_SESSION *p_sess,
+                                         SMTPc_MSG     *p_msg,
+                                         SMTPc_ERR     *p_err);
+
+static  void         SMTPc_SendBody     (SMTPc_SESSION *p_sess,
+                                         SMTPc_MSG     *msg,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_QueryServer  (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *query,
+                                         CPU_INT32U     len,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxSock       (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *p_data,
+                                         CPU_INT32U     len,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxSockV      (SMTPc_SESSION       *p_sess,
+                                         SMTPc_TRANSPORT_VEC *p_vec,
+                                         CPU_INT08U           vec_nbr,
+                                         SMTPc_ERR           *perr);
+
+static  SMTPc_TS_MS  SMTPc_TS_Get_ms    (void);
+
+static  void         SMTPc_TxGather     (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *p_data,
+                                         CPU_INT32U     len,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxFlush      (SMTPc_SESSION *p_sess,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxEnvelopePipelined(SMTPc_SESSION *p_sess,
+                                               SMTPc_MSG     *p_msg,
+                                               SMTPc_ERR     *perr);
+
+static  CPU_INT32U   SMTPc_BuildEnvelope(SMTPc_SESSION *p_sess,
+                                         CPU_INT32U     buf_wr_ix,
+                                         SMTPc_MSG     *p_msg,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_RxEnvelope   (SMTPc_SESSION *p_sess,
+                                         SMTPc_MSG     *p_msg,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxBody       (SMTPc_SESSION *p_sess,
+                                         SMTPc_MSG     *msg,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxEntity     (SMTPc_SESSION      *p_sess,
+                                         SMTPc_BODY_FRAG    *p_frag,
+                                         CPU_INT16U          nbr_frag,
+                                         SMTPc_BODY_RD_FNCT  rd_fnct,
+                                         void               *p_rd_arg,
+                                         CPU_INT08U          enc,
+                                         SMTPc_ERR          *perr);
+
+static  void         SMTPc_TxAbort      (SMTPc_SESSION *p_sess);
+
+static  CPU_INT08U   SMTPc_MIMEEncSel   (SMTPc_SESSION        *p_sess,
+                                         CPU_INT08U            enc,
+                                         CPU_INT08U            enc_dflt,
+                                         SMTPc_BODY_FRAG     **pp_frag,
+                                         CPU_INT16U           *p_nbr_frag,
+                                         SMTPc_BODY_FRAG      *p_frag_rd,
+                                         SMTPc_BODY_RD_FNCT   *p_rd_fnct,
+                                         void                 *p_rd_arg,
+                                         SMTPc_ERR            *perr);
+
+static  void         SMTPc_TxAttach     (SMTPc_SESSION *p_sess,
+                                         SMTPc_ATTACH  *p_attach,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxB64        (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state,
+                                         CPU_INT08U            *p_data,
+                                         CPU_INT32U             len,
+                                         SMTPc_ERR             *perr);
+
+static  void         SMTPc_TxB64Grp     (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state,
+                                         CPU_INT08U            *p_data,
+                                         CPU_INT32U             nbr_grp,
+                                         SMTPc_ERR             *perr);
+
+static  void         SMTPc_TxB64End     (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state,
+                                         SMTPc_ERR              *perr);
+
+static  CPU_INT32U   SMTPc_B64Enc       (CPU_INT08U       *p_src,
+                                         CPU_INT32U        nbr_grp,
+                                         CPU_CHAR         *p_dest,
+                                         CPU_INT32U       *p_line_len);
+
+static  void         SMTPc_B64EncGrp    (const  CPU_INT08U  *p_src,
+                                                CPU_INT32U   nbr_grp,
+                                                CPU_CHAR    *p_dest);
+
+#if (SMTPc_B64_X86_EN == DEF_ENABLED)
+static  void         SMTPc_B64EncGrp_SSE2(const  CPU_INT08U  *p_src,
+                                                 CPU_INT32U   nbr_grp,
+                                                 CPU_CHAR    *p_dest);
+
+static  void         SMTPc_B64EncGrp_AVX2(const  CPU_INT08U  *p_src,
+                                                 CPU_INT32U   nbr_grp,
+                                                 CPU_CHAR    *p_dest);
+#endif
 
-static  void         SMTPc_QueryServer  (NET_SOCK_ID   sock_id,
-                                         CPU_CHAR     *query,
-                                         CPU_INT32U    len,
-                                         SMTPc_ERR    *perr);
+#if (SMTPc_B64_NEON_EN == DEF_ENABLED)
+static  void         SMTPc_B64EncGrp_NEON(const  CPU_INT08U  *p_src,
+                                                 CPU_INT32U   nbr_grp,
+                                                 CPU_CHAR    *p_dest);
+#endif
+
+static  void         SMTPc_TxQP         (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state,
+                                         CPU_INT08U            *p_data,
+                                         CPU_INT32U             len,
+                                         SMTPc_ERR             *perr);
+
+static  void         SMTPc_TxQPEnd      (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state,
+                                         SMTPc_ERR             *perr);
+
+static  void         SMTPc_QPPut        (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state,
+                                         CPU_INT08U             c,
+                                         CPU_BOOLEAN            esc);
+
+static  void         SMTPc_QPLineEnd    (SMTPc_SESSION         *p_sess,
+                                         SMTPc_MIME_ENC_STATE  *p_state);
+
+static  void         SMTPc_RxBodyReply  (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_TxContent    (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *p_data,
+                                         CPU_INT32U     len,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_EncPut       (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *p_src,
+                                         CPU_INT32U     len,
+                                         CPU_INT32U    *p_buf_len,
+                                         SMTPc_ERR     *perr);
+
+static  CPU_INT32U   SMTPc_EncScanLF    (CPU_CHAR      *p_data,
+                                         CPU_INT32U     ix,
+                                         CPU_INT32U     len);
+
+static  void         SMTPc_TxData       (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *p_data,
+                                         CPU_INT32U     len,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_RxBdat       (SMTPc_SESSION *p_sess,
+                                         CPU_INT16U     nbr_pend_max,
+                                         SMTPc_ERR     *perr);
+
+static  CPU_INT32U   SMTPc_BuildEOM     (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U     buf_wr_ix);
+
+static  CPU_INT16U   SMTPc_TxBatchPipelined(SMTPc_SESSION  *p_sess,
+                                            SMTPc_MSG     **p_msgs,
+                                            CPU_INT16U      nbr_msg,
+                                            SMTPc_ERR      *p_results,
+                                            SMTPc_ERR      *perr);
+
+static  void         SMTPc_MsgChk       (SMTPc_MSG     *p_msg,
+                                         SMTPc_ERR     *perr);
 
                                                                 /* ------------------- UTIL FNCT'S ------------------- */
-static  CPU_INT32U   SMTPc_BuildHdr     (NET_SOCK_ID   sock_id,
-                                         CPU_CHAR     *buf,
-                                         CPU_INT32U    buf_size,
-                                         CPU_INT32U    buf_wr_ix,
-                                         CPU_CHAR     *hdr,
-                                         CPU_CHAR     *val,
-                                         CPU_INT32U   *line_len,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_MBOX  *SMTPc_GetRcpt      (SMTPc_MSG    *p_msg,
+                                         CPU_INT16U    ix);
+
+static  CPU_BOOLEAN  SMTPc_RcptResultSet(SMTPc_MSG    *p_msg,
+                                         CPU_INT16U    ix,
+                                         SMTPc_REPLY  *reply);
+
+static  CPU_INT32U   SMTPc_BuildCmd     (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U     buf_wr_ix,
+                                         CPU_CHAR      *cmd,
+                                         CPU_CHAR      *param,
+                                         CPU_CHAR      *addr,
+                                         SMTPc_ERR     *perr);
+
+static  CPU_INT32U   SMTPc_BuildHELO    (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *cmd,
+                                         SMTPc_ERR     *perr);
+
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+static  CPU_INT32U   SMTPc_BuildAUTH    (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *username,
+                                         CPU_CHAR      *pw,
+                                         SMTPc_ERR     *perr);
+#endif
+
+static  CPU_INT32U   SMTPc_BuildHdr     (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *buf,
+                                         CPU_INT32U     buf_size,
+                                         CPU_INT32U     buf_wr_ix,
+                                         CPU_CHAR      *hdr,
+                                         CPU_CHAR      *val,
+                                         CPU_INT32U    *line_len,
+                                         SMTPc_ERR     *perr);
+
+static  CPU_INT32U   SMTPc_BuildStr     (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U     buf_wr_ix,
+                                         CPU_CHAR      *p_str,
+                                         SMTPc_ERR     *perr);
+
+static  CPU_INT32U   SMTPc_BuildContentType(SMTPc_SESSION          *p_sess,
+                                            CPU_INT32U              buf_wr_ix,
+                                            SMTPc_MIME_ENTITY_HDR  *p_hdr,
+                                            CPU_CHAR               *p_type_dflt,
+                                            SMTPc_ERR              *perr);
+
+static  CPU_INT32U   SMTPc_BuildContentEnc(SMTPc_SESSION  *p_sess,
+                                           CPU_INT32U      buf_wr_ix,
+                                           CPU_INT08U      enc,
+                                           SMTPc_ERR      *perr);
+
+static  void         SMTPc_MIMEBoundarySet(SMTPc_SESSION *p_sess);
+
+                                                                /* --------------- CAPABILITIES CACHE ---------------- */
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+static  CPU_BOOLEAN  SMTPc_CapCacheGet  (CPU_CHAR     *p_host_name,
+                                         CPU_INT16U    port,
+                                         SMTPc_CAPS   *p_caps);
+
+static  void         SMTPc_CapCacheSet  (CPU_CHAR     *p_host_name,
+                                         CPU_INT16U    port,
+                                         SMTPc_CAPS   *p_caps);
+#endif
+
+                                                                /* ----------------- CONNECTION POOL ----------------- */
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  SMTPc_POOL_ENTRY *SMTPc_PoolGet    (SMTPc_POOL_ENTRY         *p_tbl,
+                                            CPU_INT08U                tbl_size,
+                                            CPU_CHAR                 *p_host_name,
+                                            CPU_INT16U                port,
+                                            SMTPc_SECURE_CFG         *p_secure_cfg,
+                                            CPU_INT32U                cred_hash,
+                                            CPU_BOOLEAN              *p_warm);
+
+static  void              SMTPc_PoolRelease(SMTPc_POOL_ENTRY         *p_entry,
+                                            CPU_BOOLEAN               keep);
+
+static  void              SMTPc_PoolKeySet (SMTPc_POOL_ENTRY         *p_entry,
+                                            CPU_CHAR                 *p_host_name,
+                                            CPU_INT16U                port,
+                                            SMTPc_SECURE_CFG         *p_secure_cfg,
+                                            CPU_INT32U                cred_hash);
+
+static  CPU_INT32U        SMTPc_PoolCredHash(CPU_CHAR                *p_username,
+                                             CPU_CHAR                *p_pwd);
+
+static  void              SMTPc_PoolSendMail(SMTPc_POOL_ENTRY        *p_tbl,
+                                             CPU_INT08U               tbl_size,
+                                             CPU_CHAR                *p_host_name,
+                                             CPU_INT16U               port,
+                                             CPU_CHAR                *p_username,
+                                             CPU_CHAR                *p_pwd,
+                                             SMTPc_SECURE_CFG        *p_secure_cfg,
+                                             SMTPc_MSG               *p_msg,
+                                             CPU_INT16U              *p_rep_code,
+                                             SMTPc_ERR               *p_err);
+
+static  void              SMTPc_PoolCloseIdle(SMTPc_POOL_ENTRY       *p_tbl,
+                                              CPU_INT08U              tbl_size);
+#endif
+
+                                                                /* ------------------ OUTBOUND QUEUE ------------------ */
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+static  void              SMTPc_QueueWorkerTask(void                 *p_arg);
+
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+static  void              SMTPc_QueueRingTask  (void                 *p_arg);
+#endif
+#endif
+
+                                                                /* ----------------- PERSISTENT SPOOL ----------------- */
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  void              SMTPc_SpoolRecover   (SMTPc_ERR            *p_err);
+
+static  CPU_INT32U        SMTPc_SpoolEnvBuild  (SMTPc_MSG            *p_msg,
+                                                CPU_CHAR             *p_buf);
+
+static  void              SMTPc_SpoolMsgLoad   (SMTPc_SPOOL_ENTRY    *p_entry,
+                                                SMTPc_ERR            *p_err);
+
+static  CPU_INT32U        SMTPc_SpoolRecHash   (SMTPc_SPOOL_REC_HDR  *p_hdr,
+                                                CPU_INT08U           *p_data);
+
+static  void              SMTPc_SpoolRecWr     (SMTPc_SPOOL_REC_HDR  *p_hdr,
+                                                SMTPc_ERR            *p_err);
+
+static  void              SMTPc_SpoolJobCmpl   (SMTPc_JOB            *p_job,
+                                                SMTPc_ERR             err,
+                                                void                 *p_arg);
+
+static  void              SMTPc_SpoolTask      (void                 *p_arg);
+#endif
+
+                                                                /* ----------------- RETRY SCHEDULER ------------------ */
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+static  void              SMTPc_SchedAdd       (SMTPc_JOB            *p_job,
+                                                CPU_INT32U            dly_ms);
+
+static  void              SMTPc_SchedWheelAdd  (SMTPc_JOB            *p_job);
+
+static  SMTPc_JOB        *SMTPc_SchedTick      (void);
+
+static  CPU_BOOLEAN       SMTPc_SchedRetry     (SMTPc_JOB            *p_job,
+                                                SMTPc_ERR             err);
+
+static  void              SMTPc_SchedTask      (void                 *p_arg);
+#endif
 
                                                                 /* -------------------- CMD FNCT'S ------------------- */
-static  CPU_CHAR    *SMTPc_HELO         (NET_SOCK_ID   sock_id,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_HELO         (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *cmd,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
 
 #if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
-static  CPU_CHAR    *SMTPc_AUTH         (NET_SOCK_ID   sock_id,
-                                         CPU_CHAR     *username,
-                                         CPU_CHAR     *pw,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_AUTH         (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *username,
+                                         CPU_CHAR      *pw,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
 #endif
 
-static  CPU_CHAR    *SMTPc_MAIL         (NET_SOCK_ID   sock_id,
-                                         CPU_CHAR     *from,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_MAIL         (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *from,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
 
-static  CPU_CHAR    *SMTPc_RCPT         (NET_SOCK_ID   sock_id,
-                                         CPU_CHAR     *to,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_RCPT         (SMTPc_SESSION *p_sess,
+                                         CPU_CHAR      *to,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
 
-static  CPU_CHAR    *SMTPc_DATA         (NET_SOCK_ID   sock_id,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_DATA         (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
 
-static  CPU_CHAR    *SMTPc_RSET         (NET_SOCK_ID   sock_id,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_RSET         (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
 
-static  CPU_CHAR    *SMTPc_QUIT         (NET_SOCK_ID   sock_id,
-                                         CPU_INT32U   *completion_code,
-                                         SMTPc_ERR    *perr);
+static  SMTPc_REPLY *SMTPc_QUIT         (SMTPc_SESSION *p_sess,
+                                         CPU_INT32U    *completion_code,
+                                         SMTPc_ERR     *perr);
+
+                                                                /* ------------------- ASYNC ENGINE ------------------- */
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  SMTPc_AsyncStep    (SMTPc_ASYNC   *p_async,
+                                         CPU_BOOLEAN   *p_blocked);
+
+static  void         SMTPc_AsyncConn    (SMTPc_ASYNC   *p_async,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_AsyncTx      (SMTPc_ASYNC   *p_async,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_AsyncReply   (SMTPc_ASYNC   *p_async,
+                                         SMTPc_REPLY   *reply,
+                                         SMTPc_ERR     *perr);
+
+static  void         SMTPc_AsyncCmd     (SMTPc_ASYNC   *p_async,
+                                         CPU_INT08U     state,
+                                         CPU_INT32U     len);
+
+static  void         SMTPc_AsyncEnd     (SMTPc_ASYNC   *p_async);
+#endif
+
+                                                                /* ---------------- uC/TCP-IP TRANSPORT --------------- */
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  SMTPc_SOCK_ID  SMTPc_NetOpen        (CPU_CHAR                 *p_host_name,
+                                             CPU_INT16U                port,
+                                             SMTPc_SECURE_CFG         *p_secure_cfg,
+                                             CPU_INT32U                timeout_ms,
+                                             SMTPc_ERR                *p_err);
+
+static  CPU_INT32U     SMTPc_NetTx          (SMTPc_SOCK_ID             sock_id,
+                                             const  void              *p_data,
+                                             CPU_INT32U                len,
+                                             SMTPc_ERR                *p_err);
+
+static  CPU_INT32U     SMTPc_NetTxV         (SMTPc_SOCK_ID                sock_id,
+                                             const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                             CPU_INT08U                   vec_nbr,
+                                             SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U     SMTPc_NetRx          (SMTPc_SOCK_ID             sock_id,
+                                             void                     *p_buf,
+                                             CPU_INT32U                len,
+                                             SMTPc_ERR                *p_err);
+
+static  void           SMTPc_NetClose       (SMTPc_SOCK_ID             sock_id,
+                                             CPU_INT32U                timeout_ms);
+
+static  void           SMTPc_NetDeadlineSet (SMTPc_SOCK_ID             sock_id,
+                                             CPU_INT32U                timeout_ms,
+                                             SMTPc_ERR                *p_err);
+
+static  void           SMTPc_NetLocalAddrGet(SMTPc_SOCK_ID             sock_id,
+                                             CPU_CHAR                 *p_addr,
+                                             CPU_INT08U               *p_family,
+                                             SMTPc_ERR                *p_err);
+
+static  SMTPc_TS_MS    SMTPc_NetTS_Get_ms   (void);
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                            SMTPc_Connect()
-*
-* Description : (1) Establish a TCP connection to the SMTP server and initiate the SMTP session.
+*                                       uC/TCP-IP TRANSPORT API
 *
-*                   (a) Determine port
-*                   (b) Open the socket
-*                   (c) Receive server's reply & validate
-*                   (d) Initiate SMTP session
-*                   (e) Authenticate client, if applicable
+* Note(s) : (1) Transport used by default (see 'smtp-c_cfg.h  Note #18').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Net = {
+    SMTPc_NetOpen,
+    SMTPc_NetTx,
+    SMTPc_NetTxV,
+    SMTPc_NetRx,
+    SMTPc_NetClose,
+    SMTPc_NetDeadlineSet,
+    SMTPc_NetLocalAddrGet,
+    SMTPc_NetTS_Get_ms
+};
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_Connect()
 *
+* Description : Establish a TCP connection to the SMTP server and initiate the SMTP session, using the
+*               default session.
 *
 * Argument(s) : p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
 *
@@ -188,6 +978,7 @@ static  CPU_CHAR    *SMTPc_QUIT         (NET_SOCK_ID   sock_id,
 *               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
+*                                                                   -- RETURNED BY SMTPc_SessionConnect() : --
 *                               SMTPc_ERR_NONE                      No error, TCP connection established.
 *                               SMTPc_ERR_NULL_ARG                  Argument 'username'/'pw' passed a NULL pointer.
 *                               SMTPc_ERR_SOCK_OPEN_FAILED          Error opening socket.
@@ -195,337 +986,585 @@ static  CPU_CHAR    *SMTPc_QUIT         (NET_SOCK_ID   sock_id,
 *                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
 *                               SMTPc_ERR_REP                       Error with reply.
 *                               SMTPc_ERR_SECURE_NOT_AVAIL          No secure mode available.
-*
-*                                                                   -------- RETURNED BY SMTPc_AUTH : --------
 *                               SMTPc_ERR_ENCODE                    Error encoding credentials.
 *                               SMTPc_ERR_AUTH_FAILED               Error authenticating user.
 *
-*
 * Return(s)   : Socket descriptor/handle identifier, if NO error.
 *
 *               -1,                                  otherwise.
 *
-* Caller(s)   : Application.
+* Caller(s)   : Application,
+*               SMTPc_SendMail().
 *
-* Note(s)     : (2) Network security manager MUST be available & enabled to initialize the server in
-*                   secure mode.
+* Note(s)     : (1) SMTPc_Connect(), SMTPc_SendMsg() & SMTPc_Disconnect() all operate on a single default
+*                   session.  Only one connection can hence be opened with these functions at a time, and
+*                   they MUST NOT be called concurrently from several tasks.  Tasks that need to send mail
+*                   in parallel MUST each use their own session (see 'SMTPc_SessionConnect()').
+*********************************************************************************************************
+*/
+
+SMTPc_SOCK_ID  SMTPc_Connect (CPU_CHAR                *p_host_name,
+                              CPU_INT16U               port,
+                              CPU_CHAR                *p_username,
+                              CPU_CHAR                *p_pwd,
+                              SMTPc_SECURE_CFG        *p_secure_cfg,
+                              SMTPc_ERR               *p_err)
+{
+    SMTPc_SessionConnect(&SMTPc_DfltSession,
+                          p_host_name,
+                          port,
+                          p_username,
+                          p_pwd,
+                          p_secure_cfg,
+                          p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    return (SMTPc_DfltSession.SockId);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_SendMsg()
 *
-*               (3) If anything goes wrong while trying to connect to the server, the socket is
-*                   closed by calling NetSock_Close.  Hence, all data structures are returned to
-*                   their original state in case of a failure to establish the TCP connection.
+* Description : Send a message (an instance of the SMTPc_MSG structure) to the SMTP server, using the
+*               default session.
 *
-*                   If the failure occurs when initiating the session, the application is responsible
-*                   of the appropriate action(s) to be taken.
+* Argument(s) : sock_id         Socket ID, as returned by SMTPc_Connect().
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
 *
-*               (4) If authentication is disabled (SMTPc_CFG_AUTH_EN set to DEF_ENABLED), the 'p_username'
-*                   and 'p_pwd' parameters should be passed a NULL pointer.
+*                               SMTPc_ERR_NOT_CONNECTED             Socket is not the one of the default session.
 *
-*               (5) The server will send a 220 "Service ready" reply when the connection is completed.
-*                   The SMTP protocol allows a server to formally reject a transaction while still
-*                   allowing the initial connection by responding with a 554 "Transaction failed"
-*                   reply.
+*                                                                   -- RETURNED BY SMTPc_SessionSendMsg() : --
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_msg' passed a NULL pointer.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_BODY_RD_FAILED            Message body could not be read.
 *
-*               (6) The Plain-text (PLAIN) authentication mechanism is implemented here.  However, it
-*                   takes some liberties from RFC #4964, section 4 'The AUTH Command', stating the "A
-*                   server implementation MUST implement a configuration in which it does not permit
-*                   any plaintext password mechanisms, unless either the STARTTLS command has been
-*                   negotiated or some other mechanism that protects the session from password snooping
-*                   has been provided".
+* Return(s)   : none.
 *
-*                   Since this client does not support SSL or TLS, or any other protection against
-*                   password snooping, it relies on the server NOT to fully follow RFC #4954 in order
-*                   to be successful.
+* Caller(s)   : Application,
+*               SMTPc_SendMail().
+*
+* Note(s)     : (1) See 'SMTPc_Connect()  Note #1'.
 *********************************************************************************************************
 */
 
-NET_SOCK_ID  SMTPc_Connect (CPU_CHAR                *p_host_name,
-                            CPU_INT16U               port,
-                            CPU_CHAR                *p_username,
-                            CPU_CHAR                *p_pwd,
-                            NET_APP_SOCK_SECURE_CFG *p_secure_cfg,
-                            SMTPc_ERR               *p_err)
+void  SMTPc_SendMsg (SMTPc_SOCK_ID  sock_id,
+                     SMTPc_MSG     *p_msg,
+                     SMTPc_ERR     *p_err)
 {
-    NET_SOCK_ID     sock_id;
-    CPU_INT32U      completion_code;
-    CPU_CHAR       *reply;
-    NET_ERR         err_net;
-    NET_SOCK_ADDR   socket_addr;
-    CPU_INT16U      port_server;
-
-                                                                /* ------------------ VALIDATE PTR -------------------- */
-#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
-#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
-    if ((p_username == (CPU_CHAR *)0) ||
-        (p_pwd      == (CPU_CHAR *)0)) {
-       *p_err = SMTPc_ERR_NULL_ARG;
-        return (NET_SOCK_ID_NONE);
-    }
-#else
-   (void)&p_username;                                           /* Prevent 'variable unused' compiler warnings.         */
-   (void)&p_pwd;
-#endif
-
-#ifndef  NET_SECURE_MODULE_EN                                   /* See Note #2.                                         */
-    if (p_secure_cfg != DEF_NULL) {
-       *p_err = SMTPc_ERR_SECURE_NOT_AVAIL;
-        return NET_SOCK_ID_NONE;
-    }
-#endif
-
-#endif
-                                                                /* ------------------ DETERMINE PORT ------------------ */
-    if (port != 0) {
-        port_server = port;
-    } else {
-        if (p_secure_cfg != DEF_NULL) {                         /* Set the port according to the secure mode cfg.       */
-            port_server = SMTPc_CFG_IPPORT_SECURE;
-        } else {
-            port_server = SMTPc_CFG_IPPORT;
-        }
-    }
-                                                                /* ----------------- OPEN CLIENT STREAM --------------- */
-    NetApp_ClientStreamOpenByHostname(&sock_id,
-                                       p_host_name,
-                                       port_server,
-                                      &socket_addr,
-                                       p_secure_cfg,
-                                       SMTPc_CFG_MAX_CONN_REQ_TIMEOUT_MS,
-                                      &err_net);
-    if ( err_net != NET_APP_ERR_NONE) {
-       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
-        return NET_SOCK_ID_NONE;
-    }
-                                                                /* ---------------- CFG SOCK BLOCK OPT ---------------- */
-    (void)NetSock_CfgBlock(sock_id, NET_SOCK_BLOCK_SEL_BLOCK, &err_net);
-    if (err_net != NET_SOCK_ERR_NONE) {
-        NetApp_SockClose(sock_id,
-                         SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS,
-                         &err_net);
-       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
-        return NET_SOCK_ID_NONE;
+    if ((sock_id == SMTPc_SOCK_ID_NONE) ||
+        (sock_id != SMTPc_DfltSession.SockId)) {
+       *p_err = SMTPc_ERR_NOT_CONNECTED;
+        return;
     }
 
+    SMTPc_SessionSendMsg(&SMTPc_DfltSession, p_msg, p_err);
+}
 
 
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, p_err);                      /* See Note #5.                                         */
-    if (*p_err != SMTPc_ERR_NONE) {
-        NetApp_SockClose(sock_id,
-                         SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS,
-                         &err_net);
-       *p_err = SMTPc_ERR_RX_FAILED;
-        return NET_SOCK_ID_NONE;
-    }
-
-    SMTPc_ParseReply(reply, &completion_code, p_err);
-    switch (*p_err) {
-        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
-            *p_err = SMTPc_ERR_NONE;                            /* ... no err.                                          */
-             break;
-
-        case SMTPc_ERR_REP_INTER:
-        case SMTPc_ERR_REP_NEG:
-        case SMTPc_ERR_REP_TOO_SHORT:
-        default:
-             NetApp_SockClose(sock_id,
-                              SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS,
-                              &err_net);
-            *p_err = SMTPc_ERR_REP;
-             return NET_SOCK_ID_NONE;
-    }
-                                                                /* -------------- INITIATE SMTP SESSION --------------- */
-    reply = SMTPc_HELO(sock_id, &completion_code, p_err);
-    if (*p_err != SMTPc_ERR_NONE) {
-        SMTPc_Disconnect(sock_id, p_err);
-        return NET_SOCK_ID_NONE;;
-    }
+/*
+*********************************************************************************************************
+*                                          SMTPc_Disconnect()
+*
+* Description : Close the connection between client and server, for the default session.
+*
+* Argument(s) : sock_id         Socket ID, as returned by SMTPc_Connect().
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_NOT_CONNECTED             Socket is not the one of the default session.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               SMTPc_SendMail().
+*
+* Note(s)     : (1) See 'SMTPc_Connect()  Note #1'.
+*********************************************************************************************************
+*/
 
-                                                                /* -------------------- AUTH CLIENT ------------------- */
-                                                                /* See Note #6.                                         */
-#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
-     SMTPc_AUTH((NET_SOCK_ID ) sock_id,
-                (CPU_CHAR   *) p_username,
-                (CPU_CHAR   *) p_pwd,
-                (CPU_INT32U *)&completion_code,
-                (SMTPc_ERR  *) p_err);
-    if (*p_err != SMTPc_ERR_NONE) {
-        SMTPc_Disconnect(sock_id, p_err);
-        return NET_SOCK_ID_NONE;;
+void  SMTPc_Disconnect (SMTPc_SOCK_ID  sock_id,
+                        SMTPc_ERR     *p_err)
+{
+    if ((sock_id == SMTPc_SOCK_ID_NONE) ||
+        (sock_id != SMTPc_DfltSession.SockId)) {
+       *p_err = SMTPc_ERR_NOT_CONNECTED;
+        return;
     }
-#endif
 
-    return (sock_id);
+    SMTPc_SessionDisconnect(&SMTPc_DfltSession, p_err);
 }
 
 
 /*
 *********************************************************************************************************
-*                                            SMTPc_SendMsg()
+*                                        SMTPc_SessionConnect()
 *
-* Description : (1) Send a message (an instance of the SMTPc_MSG structure) to the SMTP server.
+* Description : (1) Establish a TCP connection to the SMTP server and initiate the SMTP session.
 *
-*                   (a) Invoke the MAIL command
-*                   (b) Invoke the RCPT command for every recipient
-*                   (c) Invoke the DATA command
-*                   (d) Build and send the actual data
+*                   (a) Determine port
+*                   (b) Open the socket
+*                   (c) Receive server's reply & validate
+*                   (d) Initiate SMTP session & negotiate service extensions
+*                   (e) Authenticate client, if applicable
 *
 *
-* Argument(s) : sock_id         Socket ID.
-*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+* Argument(s) : p_sess          Pointer to the session to connect.
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL):
+*
+*                                       DEF_NULL, if no security enabled.
+*                                       Pointer to a structure that contains the parameters.
+*
 *               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_NULL_ARG                  Argument 'p_msg' passed a NULL pointer.
+*                               SMTPc_ERR_NONE                      No error, TCP connection established.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_sess'/'username'/'pw' passed a NULL pointer.
+*                               SMTPc_ERR_SOCK_OPEN_FAILED          Error opening socket.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Error connecting to server.
 *                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
 *                               SMTPc_ERR_REP                       Error with reply.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          No secure mode available.
+*                               SMTPc_ERR_NOT_INIT                  No transport set (see Note #9).
 *
-*                                                                   ------- RETURNED BY SMTPc_MAIL() : -------
-*                                                                   ------- RETURNED BY SMTPc_RCPT() : -------
-*                                                                   ------- RETURNED BY SMTPc_DATA() : -------
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
+*                                                                   -------- RETURNED BY SMTPc_AUTH : --------
+*                               SMTPc_ERR_ENCODE                    Error encoding credentials.
+*                               SMTPc_ERR_AUTH_FAILED               Error authenticating user.
 *
-*                                                                   ----- RETURNED BY SMTPc_SendBody() : -----
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
 *
 * Return(s)   : none.
 *
-* Caller(s)   : Application.
+* Caller(s)   : Application,
+*               SMTPc_Connect().
 *
-* Note(s)     : (2) The function SMTPc_SetMsg has to be called before being able to send a message.
+* Note(s)     : (2) With the uC/TCP-IP transport, the network security manager MUST be available & enabled
+*                   to initialize the server in secure mode.  Other transports reject a secure configuration
+*                   they do not support (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #3b').
 *
-*               (3) The message has to have at least one receiver, either "To", "CC", or "BCC".
+*               (3) If anything goes wrong while trying to connect to the server, the socket is
+*                   closed by the transport.  Hence, all data structures are returned to
+*                   their original state in case of a failure to establish the TCP connection.
+*
+*                   If the failure occurs when initiating the session, the application is responsible
+*                   of the appropriate action(s) to be taken.
+*
+*               (4) If authentication is disabled (SMTPc_CFG_AUTH_EN set to DEF_ENABLED), the 'p_username'
+*                   and 'p_pwd' parameters should be passed a NULL pointer.
+*
+*               (5) The server will send a 220 "Service ready" reply when the connection is completed.
+*                   The SMTP protocol allows a server to formally reject a transaction while still
+*                   allowing the initial connection by responding with a 554 "Transaction failed"
+*                   reply.
+*
+*               (6) The Plain-text (PLAIN) authentication mechanism is implemented here.  However, it
+*                   takes some liberties from RFC #4964, section 4 'The AUTH Command', stating the "A
+*                   server implementation MUST implement a configuration in which it does not permit
+*                   any plaintext password mechanisms, unless either the STARTTLS command has been
+*                   negotiated or some other mechanism that protects the session from password snooping
+*                   has been provided".
+*
+*                   Since this client does not support SSL or TLS, or any other protection against
+*                   password snooping, it relies on the server NOT to fully follow RFC #4954 in order
+*                   to be successful.
+*
+*               (7) The session is initiated with EHLO so that the service extensions supported by the
+*                   server are known.  As stated in RFC #5321, Section 4.1.4, a client MAY fall back to
+*                   HELO when the server rejects EHLO with a permanent negative reply.
+*
+*                   The capabilities of each server are kept in a cache (see 'smtp-c_cfg.h  Note #8').
+*                   When the server is found in the cache, the EHLO reply is only validated instead of
+*                   being parsed, and a server known to reject EHLO is directly greeted with HELO.
+*
+*               (8) The session structure is entirely (re)initialized.  Its statistics are cleared.
+*
+*               (9) The connection is opened by the transport set by SMTPc_TransportSet() (see 'smtp-c.h
+*                   SMTPc_TRANSPORT_API  Note #2').
+*
+*              (10) The session waits at most SMTPc_CFG_MAX_REP_TIMEOUT_MS for each reply, so that a stalled
+*                   server cannot block it indefinitely (see 'smtp-c.h  SMTP SESSION DATA TYPES  Note #4').
 *********************************************************************************************************
 */
 
-void  SMTPc_SendMsg (NET_SOCK_ID   sock_id,
-                     SMTPc_MSG    *p_msg,
-                     SMTPc_ERR    *p_err)
+void  SMTPc_SessionConnect (SMTPc_SESSION           *p_sess,
+                            CPU_CHAR                *p_host_name,
+                            CPU_INT16U               port,
+                            CPU_CHAR                *p_username,
+                            CPU_CHAR                *p_pwd,
+                            SMTPc_SECURE_CFG        *p_secure_cfg,
+                            SMTPc_ERR               *p_err)
 {
-    CPU_INT08U  i;
-    CPU_INT32U  completion_code;
-
+    SMTPc_SOCK_ID   sock_id;
+    CPU_INT32U      completion_code;
+    SMTPc_REPLY    *reply;
+    CPU_INT16U      port_server;
+    CPU_BOOLEAN     cache_hit;
+    CPU_BOOLEAN     use_helo;
+    SMTPc_ERR       err;
 
-                                                                /* See Note #2.                                         */
-    if (p_msg->From == (SMTPc_MBOX *)0) {
-         SMTPc_TRACE_DBG(("Error SMTPc_SendMsg.  NULL from parameter\n\r"));
-        *p_err = SMTPc_ERR_NULL_ARG;
-         return;
+                                                                /* ------------------ VALIDATE PTR -------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_sess == (SMTPc_SESSION *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
     }
 
-                                                                /* See Note #3.                                         */
-    if ((p_msg->ToArray[0]  == (SMTPc_MBOX *)0) &&
-        (p_msg->CCArray[0]  == (SMTPc_MBOX *)0) &&
-        (p_msg->BCCArray[0] == (SMTPc_MBOX *)0)) {
-         SMTPc_TRACE_DBG(("Error SMTPc_SendMsg.  NULL parameter(s)\n\r"));
-        *p_err = SMTPc_ERR_NULL_ARG;
-         return;
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+    if ((p_username == (CPU_CHAR *)0) ||
+        (p_pwd      == (CPU_CHAR *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
     }
+#else
+   (void)&p_username;                                           /* Prevent 'variable unused' compiler warnings.         */
+   (void)&p_pwd;
+#endif
 
-                                                                /* --------------- INVOKE THE MAIL CMD ---------------- */
-    SMTPc_MAIL(sock_id, p_msg->From->Addr, &completion_code, p_err);
-    if (*p_err != SMTPc_ERR_NONE) {
-         SMTPc_TRACE_DBG(("Error MAIL.  Code: %u\n\r", (unsigned int)completion_code));
-         if ((completion_code != SMTPc_REP_421) &&
-             (completion_code != SMTPc_REP_221)) {
-             SMTPc_RSET(sock_id, &completion_code, p_err);
-         }
-         return;
+#if ((SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED) && \
+     !defined(NET_SECURE_MODULE_EN))                            /* See Note #2.                                         */
+    if (p_secure_cfg != DEF_NULL) {
+       *p_err = SMTPc_ERR_SECURE_NOT_AVAIL;
+        return;
     }
+#endif
 
-                                                                /* --------------- INVOKE THE RCTP CMD ---------------- */
-                                                                /* The RCPT cmd is tx'd for every recipient,            */
-                                                                /* including CCs & BCCs.                                */
-    for (i = 0; i < SMTPc_CFG_MSG_MAX_TO; i++) {
-        if (p_msg->ToArray[i] == (SMTPc_MBOX *)0) {
-            break;
+#endif
+                                                                /* ------------------ DETERMINE PORT ------------------ */
+    if (port != 0) {
+        port_server = port;
+    } else {
+        if (p_secure_cfg != DEF_NULL) {                         /* Set the port according to the secure mode cfg.       */
+            port_server = SMTPc_CFG_IPPORT_SECURE;
+        } else {
+            port_server = SMTPc_CFG_IPPORT;
         }
+    }
+                                                                /* ------------------- INIT SESSION ------------------- */
+    SMTPc_SessionInit(p_sess);                                  /* See Note #8.                                         */
 
-        SMTPc_RCPT(sock_id, p_msg->ToArray[i]->Addr, &completion_code, p_err);
-        if (*p_err != SMTPc_ERR_NONE) {
-             SMTPc_TRACE_DBG(("Error RCPT (TO %u).  Code: %u\n\r", (unsigned int)i, (unsigned int)completion_code));
-             SMTPc_RSET(sock_id, &completion_code, p_err);      /* RSET p_msg if invalid RCPT fails.                      */
-             return;
-        }
+                                                                /* ----------------- OPEN CLIENT STREAM --------------- */
+    if (SMTPc_TransportAPI_Ptr == (const SMTPc_TRANSPORT_API *)0) {
+       *p_err = SMTPc_ERR_NOT_INIT;                             /* See Note #9.                                         */
+        return;
+    }
+    sock_id = SMTPc_TransportAPI_Ptr->Open(p_host_name,
+                                           port_server,
+                                           p_secure_cfg,
+                                           SMTPc_CFG_MAX_CONN_REQ_TIMEOUT_MS,
+                                           p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ---------------- CFG SOCK BLOCK OPT ---------------- */
+    SMTPc_TransportAPI_Ptr->DeadlineSet(sock_id, SMTPc_CFG_MAX_REP_TIMEOUT_MS, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        SMTPc_TransportAPI_Ptr->Close(sock_id, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
     }
+    p_sess->SockId = sock_id;
 
-                                                                /* CCs                                                  */
-    for (i = 0; i < SMTPc_CFG_MSG_MAX_CC; i++) {
-        if (p_msg->CCArray[i] == (SMTPc_MBOX *)0) {
-            break;
-        }
-        SMTPc_RCPT(sock_id, p_msg->CCArray[i]->Addr, &completion_code, p_err);
-        if (*p_err != SMTPc_ERR_NONE) {
-             SMTPc_TRACE_DBG(("Error RCPT (CC %u).  Code: %u\n\r", (unsigned int)i, (unsigned int)completion_code));
-             if ((completion_code != SMTPc_REP_421) &&
-                 (completion_code != SMTPc_REP_221)) {
-                 SMTPc_RSET(sock_id, &completion_code, p_err);  /* RSET p_msg if invalid RCPT fails.                      */
-             }
-             return;
-        }
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, p_err);                       /* See Note #5.                                         */
+    if (*p_err != SMTPc_ERR_NONE) {
+        SMTPc_TransportAPI_Ptr->Close(sock_id, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+        p_sess->SockId = SMTPc_SOCK_ID_NONE;
+       *p_err = SMTPc_ERR_RX_FAILED;
+        return;
     }
 
-                                                                /* BCCs                                                 */
-    for (i = 0; i < SMTPc_CFG_MSG_MAX_BCC; i++) {
-        if (p_msg->BCCArray[i] == (SMTPc_MBOX *)0) {
-            break;
+    SMTPc_ParseReply(reply, &completion_code, p_err);
+    switch (*p_err) {
+        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
+            *p_err = SMTPc_ERR_NONE;                            /* ... no err.                                          */
+             break;
+
+        case SMTPc_ERR_REP_INTER:
+        case SMTPc_ERR_REP_NEG:
+        case SMTPc_ERR_REP_TOO_SHORT:
+        default:
+             SMTPc_TransportAPI_Ptr->Close(sock_id, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+             p_sess->SockId = SMTPc_SOCK_ID_NONE;
+            *p_err = SMTPc_ERR_REP;
+             return;
+    }
+                                                                /* -------------- INITIATE SMTP SESSION --------------- */
+                                                                /* See Note #7.                                         */
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+    cache_hit = SMTPc_CapCacheGet(p_host_name, port_server, &p_sess->Caps);
+#else
+    cache_hit = DEF_NO;
+#endif
+    use_helo  = DEF_NO;
+    if ((cache_hit              == DEF_YES) &&
+        (p_sess->Caps.IsESMTP   == DEF_NO )) {
+        use_helo = DEF_YES;                                     /* Srv known to reject EHLO.                            */
+    } else {
+        completion_code = 0u;
+        reply = SMTPc_HELO(p_sess, SMTPc_CMD_EHLO, &completion_code, p_err);
+        if (*p_err == SMTPc_ERR_NONE) {
+            if (cache_hit == DEF_NO) {
+                SMTPc_ParseCaps(reply, &p_sess->Caps);
+            }
+        } else if ((*p_err                  == SMTPc_ERR_REP) &&
+                   ((completion_code / 100) == SMTPc_REP_NEG_COMPLET_GRP)) {
+            use_helo  = DEF_YES;                                /* EHLO rejected, fall back to HELO.                    */
+            cache_hit = DEF_NO;
+        } else {
+            SMTPc_SessionDisconnect(p_sess, &err);
+            return;
         }
+    }
 
-        SMTPc_RCPT(sock_id, p_msg->BCCArray[i]->Addr, &completion_code, p_err);
+    if (use_helo == DEF_YES) {
+        Mem_Clr(&p_sess->Caps, sizeof(p_sess->Caps));
+        (void)SMTPc_HELO(p_sess, SMTPc_CMD_HELO, &completion_code, p_err);
         if (*p_err != SMTPc_ERR_NONE) {
-             SMTPc_TRACE_DBG(("Error RCPT (BCC %u).  Code: %u\n\r", (unsigned int)i, (unsigned int)completion_code));
-             if ((completion_code != SMTPc_REP_421) &&          /* RSET p_msg if invalid RCPT fails.                      */
-                 (completion_code != SMTPc_REP_221)) {
-                 SMTPc_RSET(sock_id, &completion_code, p_err);
-             }
-             return;
+            SMTPc_SessionDisconnect(p_sess, &err);
+            return;
         }
     }
 
-                                                                /* --------------- INVOKE THE DATA CMD ---------------- */
-    SMTPc_DATA(sock_id, &completion_code, p_err);
-    if (*p_err != SMTPc_ERR_NONE) {
-         SMTPc_TRACE_DBG(("Error DATA.  Code: %u\n\r", (unsigned int)completion_code));
-         if ((completion_code != SMTPc_REP_421) &&
-             (completion_code != SMTPc_REP_221)) {
-             SMTPc_RSET(sock_id, &completion_code, p_err);
-         }
-         return;
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+    if (cache_hit == DEF_NO) {
+        SMTPc_CapCacheSet(p_host_name, port_server, &p_sess->Caps);
     }
+#endif
 
-                                                                /* ----------- BUILD & SEND THE ACTUAL MSG ------------ */
-    SMTPc_SendBody(sock_id, p_msg, p_err);
+                                                                /* -------------------- AUTH CLIENT ------------------- */
+                                                                /* See Note #6.                                         */
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+    (void)SMTPc_AUTH(p_sess,
+                     p_username,
+                     p_pwd,
+                    &completion_code,
+                     p_err);
     if (*p_err != SMTPc_ERR_NONE) {
-         SMTPc_TRACE_DBG(("Error SMTPc_SendBody.  Error: %u\n\r", (unsigned int)*p_err));
+        SMTPc_SessionDisconnect(p_sess, &err);
+        return;
     }
+#endif
 }
 
 
 /*
 *********************************************************************************************************
-*                                          SMTPc_Disconnect()
-*
-* Description : (1) Close the connection between client and server.
+*                                        SMTPc_SessionSendMsg()
 *
-*                   (a) Send QUIT command
-*                   (b) Close socket
+* Description : Send a message (an instance of the SMTPc_MSG structure) over a connected session.
 *
-*
-* Argument(s) : sock_id         Socket ID.
-*               p_err            Pointer to variable that will hold the return error code from this
+* Argument(s) : p_sess          Pointer to the session, connected by SMTPc_SessionConnect().
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
 *                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_sess'/'p_msg' passed a NULL pointer.
+*                               SMTPc_ERR_NOT_CONNECTED             Session is not connected.
+*
+*                                                                   ------- RETURNED BY SMTPc_TxMsg() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_BODY_RD_FAILED            Message body could not be read.
 *
 * Return(s)   : none.
 *
 * Caller(s)   : Application,
-*               SMTPc_Connect().
+*               SMTPc_SendMsg().
 *
-* Note(s)     : (2) The receiver (client) MUST NOT intentionally close the transmission channel until
+* Note(s)     : (1) Each session owns its socket and buffers.  Different sessions can hence be used
+*                   concurrently by different tasks, but a given session MUST NOT be used by more than one
+*                   task at a time.
+*********************************************************************************************************
+*/
+
+void  SMTPc_SessionSendMsg (SMTPc_SESSION  *p_sess,
+                            SMTPc_MSG      *p_msg,
+                            SMTPc_ERR      *p_err)
+{
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_sess == (SMTPc_SESSION *)0) ||
+        (p_msg  == (SMTPc_MSG     *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+
+    if (p_sess->SockId == SMTPc_SOCK_ID_NONE) {
+       *p_err = SMTPc_ERR_NOT_CONNECTED;
+        return;
+    }
+
+    p_sess->RepCodeNeg = 0u;                                    /* See 'smtp-c.h  SMTPc_SESSION  Note #3'.              */
+    SMTPc_TxMsg(p_sess, p_msg, p_err);
+    if (*p_err == SMTPc_ERR_NONE) {
+        p_sess->Stats.MsgTxCtr++;
+    } else {
+        p_sess->Stats.MsgFailCtr++;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_SendMsgBatch()
+*
+* Description : (1) Send several messages over a connected session, one transaction per message.
+*
+*                   (a) Send each message
+*                   (b) Record the result of each message
+*                   (c) Update the session statistics
+*
+*
+* Argument(s) : p_sess          Pointer to the session, connected by SMTPc_SessionConnect().
+*
+*               p_msgs          Array of pointers to the messages to send.
+*
+*               nbr_msg         Number of messages in 'p_msgs'.
+*
+*               p_results       Array of 'nbr_msg' variables that will receive the result of each message :
+*
+*                               SMTPc_ERR_NONE                      Message accepted by the server.
+*                               SMTPc_ERR_NULL_ARG                  Message has no sender or no recipient.
+*                               SMTPc_ERR_REP                       Message rejected by the server.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_BODY_RD_FAILED            Message body could not be read.
+*                               SMTPc_ERR_TX_FAILED                 Message not sent, connection failed.
+*                               SMTPc_ERR_RX_FAILED                 Message not sent, connection failed.
+*                               SMTPc_ERR_NOT_CONNECTED             Message not sent, connection closed.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      Every message was processed, see 'p_results'.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_sess'/'p_msgs'/'p_results' passed
+*                                                                       a NULL pointer.
+*                               SMTPc_ERR_NOT_CONNECTED             Session is not connected, or was closed.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) A message rejected by the server does not abort the batch : the transaction is reset &
+*                   the next message is sent.  The batch is only aborted when the connection failed or was
+*                   closed, in which case the messages not sent yet get the same result as 'p_err'.  The
+*                   session SHOULD then be disconnected.
+*
+*               (3) When the server supports the PIPELINING extension, the "end of mail data" indicator of a
+*                   message is sent in the same group as the envelope of the next message (see
+*                   'SMTPc_TxBatchPipelined()').
+*********************************************************************************************************
+*/
+
+void  SMTPc_SendMsgBatch (SMTPc_SESSION  *p_sess,
+                          SMTPc_MSG     **p_msgs,
+                          CPU_INT16U      nbr_msg,
+                          SMTPc_ERR      *p_results,
+                          SMTPc_ERR      *p_err)
+{
+    CPU_INT16U  i;
+
+
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_sess    == (SMTPc_SESSION *)0) ||
+        (p_msgs    == (SMTPc_MSG    **)0) ||
+        (p_results == (SMTPc_ERR     *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+
+    if (p_sess->SockId == SMTPc_SOCK_ID_NONE) {
+       *p_err = SMTPc_ERR_NOT_CONNECTED;
+        return;
+    }
+                                                                /* ------------------ SEND MESSAGES ------------------- */
+   *p_err = SMTPc_ERR_NONE;
+    i     = 0u;
+    if (DEF_BIT_IS_SET(p_sess->Caps.Flags, SMTPc_CAP_PIPELINING) == DEF_YES) {
+        i = SMTPc_TxBatchPipelined(p_sess, p_msgs, nbr_msg, p_results, p_err);
+
+    } else {
+        while ((i < nbr_msg) && (*p_err == SMTPc_ERR_NONE)) {
+            SMTPc_TxMsg(p_sess, p_msgs[i], &p_results[i]);
+            switch (p_results[i]) {
+                case SMTPc_ERR_TX_FAILED:                       /* See Note #2.                                         */
+                case SMTPc_ERR_RX_FAILED:
+                    *p_err = p_results[i];
+                     break;
+
+                default:
+                     if (p_sess->SockId == SMTPc_SOCK_ID_NONE) {
+                        *p_err = SMTPc_ERR_NOT_CONNECTED;
+                     } else {
+                         i++;
+                     }
+                     break;
+            }
+        }
+    }
+                                                                /* ---------------- RECORD RESULTS -------------------- */
+    for (; i < nbr_msg; i++) {                                  /* See Note #2.                                         */
+        p_results[i] = *p_err;
+    }
+
+    for (i = 0u; i < nbr_msg; i++) {
+        if (p_results[i] == SMTPc_ERR_NONE) {
+            p_sess->Stats.MsgTxCtr++;
+        } else {
+            p_sess->Stats.MsgFailCtr++;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_SessionDisconnect()
+*
+* Description : (1) Close the connection between client and server.
+*
+*                   (a) Send QUIT command
+*                   (b) Close socket
+*
+*
+* Argument(s) : p_sess          Pointer to the session to disconnect.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_sess' passed a NULL pointer.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               SMTPc_SessionConnect(),
+*               SMTPc_Disconnect().
+*
+* Note(s)     : (2) The receiver (client) MUST NOT intentionally close the transmission channel until
 *                   it receives and replies to a QUIT command.
 *
 *               (3) The receiver of the QUIT command MUST send an OK reply, and then close the
@@ -533,23 +1572,128 @@ void  SMTPc_SendMsg (NET_SOCK_ID   sock_id,
 *********************************************************************************************************
 */
 
-void  SMTPc_Disconnect (NET_SOCK_ID   sock_id,
-                        SMTPc_ERR    *p_err)
+void  SMTPc_SessionDisconnect (SMTPc_SESSION  *p_sess,
+                               SMTPc_ERR      *p_err)
 {
     CPU_INT32U  completion_code;
-    NET_ERR     err;
 
 
-    SMTPc_QUIT(sock_id, &completion_code, p_err);
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_sess == (SMTPc_SESSION *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+
+    if (p_sess->SockId == SMTPc_SOCK_ID_NONE) {                 /* Already disconnected.                                */
+       *p_err = SMTPc_ERR_NONE;
+        return;
+    }
+
+    (void)SMTPc_QUIT(p_sess, &completion_code, p_err);
 
-    NetApp_SockClose(sock_id,
-                     SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS,
-                    &err);
+    SMTPc_TransportAPI_Ptr->Close(p_sess->SockId, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+    p_sess->SockId = SMTPc_SOCK_ID_NONE;
 
    *p_err = SMTPc_ERR_NONE;
 }
 
 
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_RenderMsg()
+*
+* Description : (1) Render the content of a message into a buffer, in the form it is sent to the server.
+*
+*                   (a) Validate the message
+*                   (b) Build the headers & encode the body & attachments into the buffer
+*                   (c) Attach the rendered content to the message
+*
+*
+* Argument(s) : p_sess          Pointer to a session, used as work area (see Note #2).
+*               p_msg           SMTPc_MSG structure encapsulating the message to render.
+*               p_buf           Pointer to the buffer receiving the rendered content.
+*               buf_len         Size of the buffer.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, message rendered.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_sess'/'p_msg'/'p_buf' passed a
+*                                                                       NULL pointer, or message has no sender
+*                                                                       or no recipient.
+*                               SMTPc_ERR_BUF_TOO_SMALL             Rendered content larger than the buffer.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_BODY_RD_FAILED            Message body could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The session needs not be connected, but MUST NOT be in use by another task (see
+*                   'SMTPc_SessionSendMsg()  Note #1').  A connected session MUST be between transactions.
+*
+*               (3) The rendered content is the exact content sent with the DATA command : headers, MIME
+*                   parts already encoded & body already dot-stuffed with its line endings normalized (see
+*                   'SMTPc_TxContent()'), without the "end of mail data" indicator.  Its length is the
+*                   total size of the message content.
+*
+*                   A rendered message is therefore always sent with DATA, even if the server supports
+*                   CHUNKING, since BDAT content is never dot-stuffed.
+*
+*               (4) Sending a rendered message only builds its envelope; the content is sent straight from
+*                   the buffer, which MUST be kept unchanged as long as the message is sent.  The same
+*                   message MAY be sent any number of times, e.g. retried or sent to several servers.
+*                   See 'smtp-c.h  SMTPc_MSG  Note #4'.
+*
+*               (5) The rendering goes through the path used to send a message, the data being appended to
+*                   the buffer instead of sent (see 'SMTPc_TxGather()  Note #3').  No data is transmitted,
+*                   so a transmit error can only mean the buffer is full.
+*********************************************************************************************************
+*/
+
+void  SMTPc_RenderMsg (SMTPc_SESSION  *p_sess,
+                       SMTPc_MSG      *p_msg,
+                       CPU_CHAR       *p_buf,
+                       CPU_INT32U      buf_len,
+                       SMTPc_ERR      *p_err)
+{
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_sess == (SMTPc_SESSION *)0) ||
+        (p_buf  == (CPU_CHAR      *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+
+    SMTPc_MsgChk(p_msg, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+    p_msg->RenderBufPtr = (CPU_CHAR *)0;                        /* Content built from the msg struct.                   */
+    p_msg->RenderLen    = 0u;
+                                                                /* ------------------ RENDER CONTENT ------------------ */
+    p_sess->DataOnly    = DEF_YES;                              /* See Note #3.                                         */
+    p_sess->BdatPendCtr = 0u;
+    p_sess->RenderPtr   = p_buf;                                /* See Note #5.                                         */
+    p_sess->RenderRem   = buf_len;
+
+    SMTPc_TxBody(p_sess, p_msg, p_err);
+
+    p_sess->RenderPtr   = (CPU_CHAR *)0;
+    if (*p_err == SMTPc_ERR_TX_FAILED) {
+       *p_err = SMTPc_ERR_BUF_TOO_SMALL;
+    }
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ------------------- ATTACH CONTENT ----------------- */
+    p_msg->RenderBufPtr = p_buf;                                /* See Note #4.                                         */
+    p_msg->RenderLen    = buf_len - p_sess->RenderRem;
+}
+
+
+
 /*
 *********************************************************************************************************
 *                                            SMTPc_SetMbox()
@@ -572,7 +1716,8 @@ void  SMTPc_Disconnect (NET_SOCK_ID   sock_id,
 *
 * Return(s)   : none.
 *
-* Caller(s)   : Application.
+* Caller(s)   : Application,
+*               SMTPc_SpoolMsgLoad().
 *
 * Note(s)     : (2) The name of the mailbox owner is not mandatory.  Passing NULL will result in an
 *                   empty string being copied in the structure.
@@ -633,13 +1778,14 @@ void  SMTPc_SetMbox (SMTPc_MBOX  *p_mbox,
 *
 * Return(s)   : none.
 *
-* Caller(s)   : Application.
+* Caller(s)   : Application,
+*               SMTPc_SpoolMsgLoad().
 *
 * Note(s)     : (1) This function MUST be called after declaring a SMTPc_MSG structure and BEFORE beginning
 *                   to manipulate it.  Failure to do so will likely produce run-time errors.
 *
-*               (2) The SMTPc_MSG structure member 'MIMEMsgHdrStruct' is left uninitialized for now,
-*                   MIME extensions not being supported in this version.
+*               (2) The SMTPc_MSG structure member 'MIMEMsgHdrStruct' is cleared; it only applies to the body
+*                   of a message with attachments (see 'SMTPc_TxBody()  Note #7').
 *********************************************************************************************************
 */
 
@@ -675,8 +1821,17 @@ void  SMTPc_SetMsg (SMTPc_MSG  *p_msg,
     }
 
     p_msg->ReplyTo           = (SMTPc_MBOX *)0;
-    p_msg->ContentBodyMsg    = (CPU_CHAR   *)0;
-    p_msg->ContentBodyMsgLen = 0;
+    p_msg->ContentBodyMsg       = (CPU_CHAR   *)0;
+    p_msg->ContentBodyMsgLen    = 0;
+    p_msg->ContentBodyRdFnct    = (SMTPc_BODY_RD_FNCT)0;
+    p_msg->ContentBodyRdArg     = DEF_NULL;
+    p_msg->ContentBodyFragArray = DEF_NULL;
+    p_msg->ContentBodyFragNbr   = 0u;
+    p_msg->RenderBufPtr         = (CPU_CHAR   *)0;
+    p_msg->RenderLen            = 0u;
+    p_msg->RcptPartialEn        = DEF_NO;
+    Mem_Clr(&p_msg->MIMEMsgHdrStruct, sizeof(p_msg->MIMEMsgHdrStruct));
+    Mem_Clr(&p_msg->RcptResultTbl[0], sizeof(p_msg->RcptResultTbl));
     p_msg->Subject           = DEF_NULL;
                                                                 /* Clr CPU_CHAR arrays                                  */
     Mem_Clr((void     *)p_msg->MsgID,
@@ -689,6 +1844,104 @@ void  SMTPc_SetMsg (SMTPc_MSG  *p_msg,
 }
 
 
+/*
+*********************************************************************************************************
+*                                           SMTPc_SetAttach()
+*
+* Description : (1) Populates a SMTPc_ATTACH structure with the name, content type & data of an attachment.
+*
+*                   (a) Perform error checking.
+*                   (b) Clear the structure.
+*                   (c) Copy arguments in structure.
+*
+*
+* Argument(s) : p_attach        SMTPc_ATTACH structure to be populated.
+*               p_name          Name of the attachment (file name), or NULL.
+*               p_content_type  Content type of the attachment (e.g. "application/pdf"), or NULL for
+*                               "application/octet-stream".
+*               p_data          Pointer to the data of the attachment.
+*               size            Size of the data, in octets.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, structure ready.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_attach' passed a NULL pointer.
+*                               SMTPc_ERR_STR_TOO_LONG              Argument 'p_name'/'p_content_type' too long.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The attachment is encoded in base64.  The other members of the structure, such as the
+*                   description, the read function or the content transfer encoding, MAY be set afterward.
+*********************************************************************************************************
+*/
+
+void  SMTPc_SetAttach (SMTPc_ATTACH  *p_attach,
+                       CPU_CHAR      *p_name,
+                       CPU_CHAR      *p_content_type,
+                       void          *p_data,
+                       CPU_INT32U     size,
+                       SMTPc_ERR     *p_err)
+{
+    if (p_attach == (SMTPc_ATTACH *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+
+    if (((p_name         != (CPU_CHAR *)0) && (Str_Len(p_name)         >= SMTPc_ATTACH_NAME_LEN)) ||
+        ((p_content_type != (CPU_CHAR *)0) && (Str_Len(p_content_type) >= SMTPc_MIME_CONTENT_TYPE_LEN))) {
+       *p_err = SMTPc_ERR_STR_TOO_LONG;
+        return;
+    }
+
+    Mem_Clr(p_attach, sizeof(SMTPc_ATTACH));
+    if (p_name != (CPU_CHAR *)0) {
+        Str_Copy(p_attach->Name, p_name);
+    }
+    if (p_content_type != (CPU_CHAR *)0) {
+        Str_Copy(p_attach->MIMEPartHdrStruct.ContentType, p_content_type);
+    }
+    p_attach->AttachData                        = p_data;
+    p_attach->Size                              = size;
+    p_attach->MIMEPartHdrStruct.ContentEncoding = SMTPc_MIME_ENC_BASE64;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_CapCacheClr()
+*
+* Description : Forget the capabilities learned from every server.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The next session with any server will parse the EHLO reply again.  This should be
+*                   called when the configuration of a known server changed (e.g. a new relay answers
+*                   on the same host name).
+*********************************************************************************************************
+*/
+
+void  SMTPc_CapCacheClr (void)
+{
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    Mem_Clr(SMTPc_CapCacheTbl, sizeof(SMTPc_CapCacheTbl));
+    SMTPc_CapCacheUseCtr = 0u;
+    CPU_CRITICAL_EXIT();
+#endif
+}
+
+
 /*
 *********************************************************************************************************
 *                                            SMTPc_SendMail()
@@ -731,15 +1984,27 @@ void  SMTPc_SetMsg (SMTPc_MSG  *p_msg,
 *                                 SMTPc_ERR_RX_FAILED                 Error receiving server reply.
 *                                 SMTPc_ERR_REP                       Error with reply.
 *                                 SMTPc_ERR_TX_FAILED                 Error querying server.
-*                                 SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                                 SMTPc_ERR_REP                       Error with reply.
-*                                 SMTPc_ERR_TX_FAILED                 Error querying server.
 *                                 SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                                 SMTPc_ERR_BODY_RD_FAILED            Message body could not be read.
 * Return(s)   : none.
 *
 * Caller(s)   : Application.
 *
-* Note(s)     : none.
+* Note(s)     : (1) When the connection pool is enabled (see 'smtp-c_cfg.h  Note #9'), the message is sent
+*                   over an idle session already connected & authenticated to the same server with the
+*                   same secure configuration & credentials, if any.  Otherwise, a pooled session is
+*                   connected & kept open after the transaction for the next messages.
+*
+*                   Tasks calling SMTPc_SendMail() concurrently each lease a different session.  When all the
+*                   sessions of the pool are in use, SMTPc_ERR_POOL_EMPTY is returned.
+*
+*               (2) The server may have closed an idle connection.  When a reused session fails before any
+*                   reply was received, nothing can have been delivered; the message is then sent again
+*                   over a new connection.
+*
+*               (3) A session is only returned to the pool after a successful transaction, which leaves
+*                   it in its initial state (see RFC #5321, Section 4.1.4).  A session on which a
+*                   transaction failed is closed, since its state is unknown.
 *********************************************************************************************************
 */
 
@@ -747,11 +2012,25 @@ void  SMTPc_SendMail (CPU_CHAR                *p_host_name,
                       CPU_INT16U               port,
                       CPU_CHAR                *p_username,
                       CPU_CHAR                *p_pwd,
-                      NET_APP_SOCK_SECURE_CFG *p_secure_cfg,
+                      SMTPc_SECURE_CFG        *p_secure_cfg,
                       SMTPc_MSG               *p_msg,
                       SMTPc_ERR               *p_err)
 {
-    NET_SOCK_ID  sock;
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+    SMTPc_PoolSendMail(SMTPc_PoolTbl,
+                       SMTPc_CFG_POOL_NBR_SESSIONS,
+                       p_host_name,
+                       port,
+                       p_username,
+                       p_pwd,
+                       p_secure_cfg,
+                       p_msg,
+                       DEF_NULL,
+                       p_err);
+
+#else
+    SMTPc_SOCK_ID  sock;
+    SMTPc_ERR      err;
 
                                                                 /* -------------- CONNECT TO SMTP SEVER --------------- */
     sock = SMTPc_Connect(p_host_name,
@@ -766,344 +2045,3852 @@ void  SMTPc_SendMail (CPU_CHAR                *p_host_name,
                                                                 /* ----------------- SEND THE MESSAGE ----------------- */
     SMTPc_SendMsg(sock, p_msg, p_err);
     if (*p_err != SMTPc_ERR_NONE) {
+         SMTPc_Disconnect(sock, &err);
          return;
     }
                                                                 /* ----------- DISCONNECT FROM SMTP SERVER ------------ */
     SMTPc_Disconnect(sock, p_err);
+#endif
 }
 
 
 /*
 *********************************************************************************************************
-*                                           LOCAL FUNCTIONS
+*                                           SMTPc_PoolFlush()
+*
+* Description : Close all the idle sessions of the connection pool.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) Idle sessions are otherwise only closed when they are leased after their idle timeout
+*                   expired (see 'smtp-c_cfg.h  Note #9b').  This function may be called periodically to
+*                   release the connections sooner, or before shutting the network down.
+*
+*               (2) Sessions currently in use by SMTPc_SendMail() are not affected.
 *********************************************************************************************************
 */
 
+void  SMTPc_PoolFlush (void)
+{
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+    SMTPc_PoolCloseIdle(SMTPc_PoolTbl, SMTPc_CFG_POOL_NBR_SESSIONS);
+#endif
+}
+
+
 /*
 *********************************************************************************************************
-*                                            SMTPc_RxReply()
+*                                        SMTPc_ErrIsTransient()
 *
-* Description : Receive and process reply from the SMTP server.
+* Description : Tell whether sending a message failed on a transient error, i.e. whether it may succeed if
+*               the message is sent again later.
 *
-* Argument(s) : sock_id         Socket ID.
-*               perr            Pointer to variable that will hold the return error code from this
-*                               function :
+* Argument(s) : err             Error returned when sending the message.
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving the reply.
+*               rep_code        Code of the last negative reply received, 0 if none (see 'smtp-c.h
+*                               SMTPc_SESSION  Note #3').
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
+* Return(s)   : DEF_YES, if the error is transient (see Note #1).
 *
-*               (CPU_CHAR *)0,                  otherwise.
+*               DEF_NO,  if the message was sent, or if the error is permanent.
 *
-* Caller(s)   : SMTPc_Connect(),
-*               SMTPc_SendMsg(),
-*               SMTPc_HELO(),
-*               SMTPc_MAIL(),
-*               SMTPc_RCPT(),
-*               SMTPc_DATA(),
-*               SMTPc_RSET(),
-*               SMTPc_QUIT().
+* Caller(s)   : Application,
+*               SMTPc_RcptResultSet(),
+*               SMTPc_SchedRetry().
 *
-* Note(s)     : (1) Server reply is at least 3 characters long (3 digits), plus CRLF.  Hence, receiving
-*                   less than that automatically indicates an error.
+* Note(s)     : (1) From RFC #5321, Section 4.2.1, a 4yz reply is a transient negative completion reply &
+*                   a 5yz reply a permanent one.  The loss or the failure of the connection is transient,
+*                   unless a negative reply was received; any other error is permanent.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_RxReply (NET_SOCK_ID   sock_id,
-                                  SMTPc_ERR    *perr)
+CPU_BOOLEAN  SMTPc_ErrIsTransient (SMTPc_ERR   err,
+                                   CPU_INT16U  rep_code)
 {
-    NET_SOCK_RTN_CODE  rx_len;
-    NET_ERR            err;
-
+    CPU_BOOLEAN  transient;
 
-                                                                /* ---------------------- RX REPLY -------------------- */
-    rx_len = NetSock_RxData(sock_id,
-                            SMTPc_Comm_Buf,
-                            SMTPc_COMM_BUF_LEN - 1,
-                            NET_SOCK_FLAG_NONE,
-                           &err);
 
+    if (err == SMTPc_ERR_NONE) {
+        return (DEF_NO);
+    }
                                                                 /* See Note #1.                                         */
-    if ((rx_len == NET_SOCK_BSD_ERR_RX) ||
-        (rx_len <= 4                  )) {
-        *perr = SMTPc_ERR_RX_FAILED;
-         return ((CPU_CHAR *)0);
+    switch (rep_code / 100u) {
+        case SMTPc_REP_NEG_TRANS_COMPLET_GRP:
+             return (DEF_YES);
+
+        case SMTPc_REP_NEG_COMPLET_GRP:
+             return (DEF_NO);
+
+        default:
+             break;
     }
 
-     SMTPc_Comm_Buf[rx_len] = '\0';
+    switch (err) {
+        case SMTPc_ERR_SOCK_OPEN_FAILED:
+        case SMTPc_ERR_SOCK_CONN_FAILED:
+        case SMTPc_ERR_NO_SMTP_SERV:
+        case SMTPc_ERR_RX_FAILED:
+        case SMTPc_ERR_TX_FAILED:
+        case SMTPc_ERR_NOT_CONNECTED:
+        case SMTPc_ERR_POOL_EMPTY:
+        case SMTPc_ERR_TIMEOUT:
+             transient = DEF_YES;
+             break;
 
-    *perr = SMTPc_ERR_NONE;
+        default:
+             transient = DEF_NO;
+             break;
+    }
 
-     return (SMTPc_Comm_Buf);
+    return (transient);
 }
 
 
 /*
 *********************************************************************************************************
-*                                          SMTPc_ParseReply()
+*                                         SMTPc_TransportSet()
 *
-* Description : (1) Process reply received from the SMTP server.
+* Description : Set the transport used by all the sessions to connect to the servers & exchange data.
 *
-*                   (a) Parse reply
-*                   (b) Interpret reply
+* Argument(s) : p_api           Pointer to the transport functions (see 'smtp-c.h  SMTPc_TRANSPORT_API').
 *
-*
-* Argument(s) : server_reply    Complete reply received from the server.
-*               completion_code Numeric value returned by server indicating command status.
-*               perr            Pointer to variable that will hold the return error code from this
+*               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
-*                               SMTPc_ERR_REP_TOO_SHORT             Reply not long enough.
-*                               SMTPc_ERR_REP_POS                   No error, positive reply received.
-*                               SMTPc_ERR_REP_INTER                 No error, intermediate reply received.
-*                               SMTPc_ERR_REP_NEG                   Negative reply received.
+*                               SMTPc_ERR_NONE                      No error, transport set.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_api' passed a NULL pointer.
+*                               SMTPc_ERR_INVALID_CFG               A transport function is missing.
 *
 * Return(s)   : none.
 *
-* Caller(s)   : SMTPc_Connect(),
-*               SMTPc_SendMsg(),
-*               SMTPc_HELO(),
-*               SMTPc_MAIL(),
-*               SMTPc_RCPT(),
-*               SMTPc_DATA(),
-*               SMTPc_RSET(),
-*               SMTPc_QUIT().
+* Caller(s)   : Application.
 *
-* Note(s)     : none.
+* Note(s)     : (1) This function MUST be called before any session is connected, i.e. before the queue
+*                   workers are started & before any job is submitted.  Sessions already connected keep
+*                   using the socket of the previous transport.
+*
+*               (2) If the uC/TCP-IP transport is disabled (see 'smtp-c_cfg.h  Note #18'), this function
+*                   MUST be called, or connecting fails with SMTPc_ERR_NOT_INIT.
 *********************************************************************************************************
 */
 
-static  void  SMTPc_ParseReply (CPU_CHAR    *server_reply,
-                                CPU_INT32U  *completion_code,
-                                SMTPc_ERR   *perr)
+void  SMTPc_TransportSet (const  SMTPc_TRANSPORT_API  *p_api,
+                                 SMTPc_ERR            *p_err)
 {
-    CPU_INT08U  code_first_dig;
-    CPU_INT08U  len;
-
-                                                                /* -------------------- PARSE REPLY  ------------------ */
-    len = Str_Len(server_reply);                                /* Make sure string is at least 3 + 1 char long.        */
-    if (len < 4) {
-        *perr = SMTPc_ERR_REP_TOO_SHORT;
-         return;
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_api == (const SMTPc_TRANSPORT_API *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
     }
-    
-   *completion_code = Str_ParseNbr_Int32U(server_reply, DEF_NULL, 10);   
-    SMTPc_TRACE_DBG(("Code: %u\n\r", (unsigned int)*completion_code));
-    
-    
-                                                                /* ------------------ INTERPRET REPLY ----------------- */
-    code_first_dig = *completion_code / 100;
-    switch (code_first_dig) {
-        case SMTPc_REP_POS_COMPLET_GRP:                         /* Positive reply.                                      */
-            *perr = SMTPc_ERR_REP_POS;
-             break;
 
-        case SMTPc_REP_POS_PRELIM_GRP:                          /* Intermediate reply.                                  */
-        case SMTPc_REP_POS_INTER_GRP:
-            *perr = SMTPc_ERR_REP_INTER;
-             break;
+    if ((p_api->Open         == DEF_NULL) ||
+        (p_api->Tx           == DEF_NULL) ||
+        (p_api->TxV          == DEF_NULL) ||
+        (p_api->Rx           == DEF_NULL) ||
+        (p_api->Close        == DEF_NULL) ||
+        (p_api->DeadlineSet  == DEF_NULL) ||
+        (p_api->LocalAddrGet == DEF_NULL) ||
+        (p_api->TS_Get_ms    == DEF_NULL)) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+#endif
 
-        case SMTPc_REP_NEG_TRANS_COMPLET_GRP:                   /* Negative reply.                                      */
-        case SMTPc_REP_NEG_COMPLET_GRP:
-            *perr = SMTPc_ERR_REP_NEG;
-             break;
+    SMTPc_TransportAPI_Ptr = p_api;                             /* See Note #1.                                         */
 
-        default:                                                /* Should never happen, interpreted as negative.        */
-            *perr = SMTPc_ERR_REP_NEG;
-             break;
-    }
+   *p_err = SMTPc_ERR_NONE;
 }
 
 
 /*
 *********************************************************************************************************
-*                                           SMTPc_QueryServer()
+*                                          SMTPc_B64EncSet()
 *
-* Description : Send a query (or anything else) to the server.
+* Description : Select the kernel of the base64 encoder of attachments & credentials.
 *
-* Argument(s) : sock_id         Socket ID.
-*               query           Query in question.
-*               len             Length of message to transmit
-*               perr            Pointer to variable that will hold the return error code from this
-*                               function :
+* Argument(s) : enc             Kernel (see 'smtp-c.h  BASE 64 ENCODER DEFINES  Note #3') :
 *
-*                               SMTPc_ERR_NONE                      No error.
+*                                   SMTPc_B64_ENC_AUTO      Fastest kernel supported by the CPU.
+*                                   SMTPc_B64_ENC_SCALAR    Portable C kernel.
+*                                   SMTPc_B64_ENC_SSE2      SSE2 kernel, x86-64 only.
+*                                   SMTPc_B64_ENC_AVX2      AVX2 kernel, x86-64 CPUs with AVX2 only.
+*                                   SMTPc_B64_ENC_NEON      NEON kernel, AArch64 only.
 *
-*                                                                   ----- RETURNED BY NetSock_TxData() : -----
-*                                                                   See uC/TCPIP source code.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, kernel selected.
+*                               SMTPc_ERR_INVALID_CFG               Kernel not compiled or not supported by
+*                                                                       the CPU.
 *
 * Return(s)   : none.
 *
-* Caller(s)   : SMTPc_SendBody(),
-*               SMTPc_BuildHdr(),
-*               SMTPc_HELO(),
-*               SMTPc_MAIL(),
-*               SMTPc_RCPT(),
-*               SMTPc_DATA(),
-*               SMTPc_RSET(),
-*               SMTPc_QUIT().
+* Caller(s)   : Application,
+*               SMTPc_B64Enc().
 *
-* Note(s)     : none.
+* Note(s)     : (1) The kernel is selected once : by the application, at initialization, or else on the first
+*                   message encoded, with SMTPc_B64_ENC_AUTO.  It SHOULD NOT be changed while a message is
+*                   encoded; all kernels produce the same output.
+*
+*               (2) The SIMD kernels are only compiled if the compiler targets their architecture, so that the
+*                   scalar kernel is the only one on other CPUs (see 'smtp-c_cfg.h  Note #12b').  On x86-64,
+*                   AVX2 support is detected at run time.
 *********************************************************************************************************
 */
 
-static  void  SMTPc_QueryServer (NET_SOCK_ID   sock_id,
-                                 CPU_CHAR     *query,
-                                 CPU_INT32U    len,
-                                 SMTPc_ERR    *perr)
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)
+void  SMTPc_B64EncSet (CPU_INT08U   enc,
+                       SMTPc_ERR   *p_err)
 {
-    NET_SOCK_RTN_CODE  rtn_code;
-    CPU_INT32U         cur_pos;
-    NET_ERR            err;
+    SMTPc_B64_ENC_FNCT  enc_fnct;
 
-                                                                /* ---------------------- TX QUERY -------------------- */
-    cur_pos = 0;
 
-    do {
-        rtn_code = NetSock_TxData( sock_id,
-                                  &query[cur_pos],
-                                   len,
-                                   0,
-                                  &err);
+    if (enc == SMTPc_B64_ENC_AUTO) {                            /* See Note #2.                                         */
+#if   (SMTPc_B64_X86_EN  == DEF_ENABLED)
+        enc = (__builtin_cpu_supports("avx2") != 0) ? SMTPc_B64_ENC_AVX2 : SMTPc_B64_ENC_SSE2;
+#elif (SMTPc_B64_NEON_EN == DEF_ENABLED)
+        enc = SMTPc_B64_ENC_NEON;
+#else
+        enc = SMTPc_B64_ENC_SCALAR;
+#endif
+    }
 
-        cur_pos  = cur_pos + rtn_code;
-        len      = len - rtn_code;
+    switch (enc) {
+        case SMTPc_B64_ENC_SCALAR:
+             enc_fnct = SMTPc_B64EncGrp;
+             break;
 
-    } while ((len != 0) && (rtn_code != NET_SOCK_BSD_ERR_TX));
+#if (SMTPc_B64_X86_EN == DEF_ENABLED)
+        case SMTPc_B64_ENC_SSE2:
+             enc_fnct = SMTPc_B64EncGrp_SSE2;
+             break;
 
-    if (rtn_code != NET_SOCK_BSD_ERR_TX) {
-       *perr = SMTPc_ERR_NONE;
+        case SMTPc_B64_ENC_AVX2:
+             if (__builtin_cpu_supports("avx2") == 0) {
+                *p_err = SMTPc_ERR_INVALID_CFG;
+                 return;
+             }
+             enc_fnct = SMTPc_B64EncGrp_AVX2;
+             break;
+#endif
+
+#if (SMTPc_B64_NEON_EN == DEF_ENABLED)
+        case SMTPc_B64_ENC_NEON:
+             enc_fnct = SMTPc_B64EncGrp_NEON;
+             break;
+#endif
+
+        default:
+            *p_err = SMTPc_ERR_INVALID_CFG;
+             return;
     }
+
+    SMTPc_B64EncSel  = enc;                                     /* See Note #1.                                         */
+    SMTPc_B64EncFnct = enc_fnct;
+
+   *p_err = SMTPc_ERR_NONE;
 }
 
 
 /*
 *********************************************************************************************************
-*                                           SMTPc_SendBody()
+*                                          SMTPc_B64EncGet()
 *
-* Description : (1) Prepare and send the actual data of the message, i.e. the body part of the message
-*                   content.
+* Description : Get the kernel of the base64 encoder.
 *
-*                   (a) Built headers and transmit
-*                   (b) Transmit body content
-*                   (c) Prepare and transmit attachment(s)
-*                   (d) Transmit "end of mail data" indicator
-*                   (e) Receive the confirmation reply
+* Argument(s) : none.
 *
+* Return(s)   : Kernel selected (see 'SMTPc_B64EncSet()'), never SMTPc_B64_ENC_AUTO.
 *
-* Argument(s) : sock_id         Socket ID.
-*               msg             SMTPc_MSG structure encapsulating the message to send.
-*               perr            Pointer to variable that will hold the return error code from this
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) If no kernel was selected yet, the fastest kernel supported by the CPU is selected.
+*********************************************************************************************************
+*/
+
+CPU_INT08U  SMTPc_B64EncGet (void)
+{
+    SMTPc_ERR  err;
+
+
+    if (SMTPc_B64EncFnct == (SMTPc_B64_ENC_FNCT)0) {            /* See Note #1.                                         */
+        SMTPc_B64EncSet(SMTPc_B64_ENC_AUTO, &err);
+    }
+
+    return (SMTPc_B64EncSel);
+}
+#endif
+
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+/*
+*********************************************************************************************************
+*                                         SMTPc_AsyncSubmit()
+*
+* Description : (1) Submit a message to be sent by the asynchronous engine.
+*
+*                   (a) Validate the message & initialize the job
+*                   (b) Append the job to the list polled by SMTPc_Poll()
+*
+*
+* Argument(s) : p_async         Pointer to the job (see 'smtp-c.h  SMTPc_ASYNC  Note #1').
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL):
+*
+*                                       DEF_NULL, if no security enabled.
+*                                       Pointer to a structure that contains the parameters.
+*
+*               p_msg           Pointer to the rendered message to send (see 'SMTPc_AsyncInit()  Note #2').
+*
+*               cmpl_fnct       Function called when the job is over (see 'smtp-c.h  SMTPc_ASYNC  Note #2').
+*
+*               p_cmpl_arg      Argument passed to 'cmpl_fnct'.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_NONE                      No error, job submitted.
 *
-*                                                                   ----- RETURNED BY SMTPc_BuildHdr() : -----
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                                                                   ----- RETURNED BY SMTPc_AsyncInit() : -----
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_async'/'p_host_name'/'cmpl_fnct'/
+*                                                                       'username'/'pw' passed a NULL pointer.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          No secure mode available.
+*                               SMTPc_ERR_NOT_RENDERED              Message not rendered.
 *
 * Return(s)   : none.
 *
-* Caller(s)   : SMTPc_SendMsg().
+* Caller(s)   : Application,
+*               Completion function of a job.
 *
-* Note(s)     : (2) The current implementation does not insert the names of the mailbox owners (member
-*                   NameDisp of structure SMTPc_MBOX).
+* Note(s)     : (2) The job MUST NOT already be in progress.  SMTPc_AsyncSubmit() & SMTPc_Poll() MUST be
+*                   called from the same task.
 *********************************************************************************************************
 */
 
-static  void  SMTPc_SendBody (NET_SOCK_ID   sock_id,
-                              SMTPc_MSG    *msg,
-                              SMTPc_ERR    *perr)
+void  SMTPc_AsyncSubmit (SMTPc_ASYNC              *p_async,
+                         CPU_CHAR                 *p_host_name,
+                         CPU_INT16U                port,
+                         CPU_CHAR                 *p_username,
+                         CPU_CHAR                 *p_pwd,
+                         SMTPc_SECURE_CFG         *p_secure_cfg,
+                         SMTPc_MSG                *p_msg,
+                         SMTPc_ASYNC_CMPL_FNCT     cmpl_fnct,
+                         void                     *p_cmpl_arg,
+                         SMTPc_ERR                *p_err)
 {
-    CPU_SIZE_T   len;
-    CPU_INT32U   cur_wr_ix;
-    CPU_INT08U   i;
-    CPU_INT32U   line_len;
-    CPU_CHAR    *hdr;
-    CPU_CHAR    *reply;
-    CPU_INT32U   completion_code;
+                                                                /* ---------------------- INIT JOB -------------------- */
+    SMTPc_AsyncInit(p_async,
+                    p_host_name,
+                    port,
+                    p_username,
+                    p_pwd,
+                    p_secure_cfg,
+                    p_msg,
+                    cmpl_fnct,
+                    p_cmpl_arg,
+                    p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* -------------------- APPEND JOB -------------------- */
+    if (SMTPc_AsyncTailPtr == (SMTPc_ASYNC *)0) {
+        SMTPc_AsyncHeadPtr          = p_async;
+    } else {
+        SMTPc_AsyncTailPtr->NextPtr = p_async;
+    }
+    SMTPc_AsyncTailPtr = p_async;
+    SMTPc_AsyncNbr++;
 
+   *p_err = SMTPc_ERR_NONE;
+}
 
-    cur_wr_ix = 0;
-    line_len  = 0;
 
-                                                                /* ------------------- BUILT HEADERS ------------------ */
-                                                                /* Header "From: ".                                     */
-    hdr       = (CPU_CHAR *)SMTPc_HDR_FROM;
-    cur_wr_ix = SMTPc_BuildHdr( sock_id,                        /* Addr                                                 */
-                                SMTPc_Comm_Buf,
-                                SMTPc_COMM_BUF_LEN,
-                                cur_wr_ix,
-                                hdr,
-                                msg->From->Addr,
-                               &line_len,
-                                perr);
-    if (*perr != SMTPc_ERR_NONE) {
+/*
+*********************************************************************************************************
+*                                          SMTPc_AsyncInit()
+*
+* Description : (1) Initialize a job, to be run by SMTPc_AsyncRun().
+*
+*                   (a) Validate the message
+*                   (b) Initialize the job
+*
+*
+* Argument(s) : p_async         Pointer to the job (see 'smtp-c.h  SMTPc_ASYNC  Note #3').
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL):
+*
+*                                       DEF_NULL, if no security enabled.
+*                                       Pointer to a structure that contains the parameters.
+*
+*               p_msg           Pointer to the rendered message to send (see Note #2).
+*
+*               cmpl_fnct       Function called when the job is over (see 'smtp-c.h  SMTPc_ASYNC  Note #2').
+*
+*               p_cmpl_arg      Argument passed to 'cmpl_fnct'.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, job initialized.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_async'/'p_host_name'/'cmpl_fnct'/
+*                                                                       'username'/'pw' passed a NULL pointer.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          No secure mode available.
+*                               SMTPc_ERR_NOT_RENDERED              Message not rendered (see Note #2).
+*
+*                                                                   ------- RETURNED BY SMTPc_MsgChk : -------
+*                               SMTPc_ERR_NULL_ARG                  No message, sender or recipient.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               SMTPc_AsyncSubmit().
+*
+* Note(s)     : (2) The content of the message MUST have been rendered by SMTPc_RenderMsg(), so that it is
+*                   sent without building it.  The render buffer MUST remain valid until the job is over.
+*
+*               (3) The job MUST NOT already be in progress.  Only the job itself is accessed : jobs MAY be
+*                   initialized from any task.
+*
+*               (4) See 'SMTPc_SessionConnect()  Notes #2 & #4'.
+*********************************************************************************************************
+*/
+
+void  SMTPc_AsyncInit (SMTPc_ASYNC              *p_async,
+                       CPU_CHAR                 *p_host_name,
+                       CPU_INT16U                port,
+                       CPU_CHAR                 *p_username,
+                       CPU_CHAR                 *p_pwd,
+                       SMTPc_SECURE_CFG         *p_secure_cfg,
+                       SMTPc_MSG                *p_msg,
+                       SMTPc_ASYNC_CMPL_FNCT     cmpl_fnct,
+                       void                     *p_cmpl_arg,
+                       SMTPc_ERR                *p_err)
+{
+                                                                /* ------------------ VALIDATE PTR -------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_async     == (SMTPc_ASYNC *)0) ||
+        (p_host_name == (CPU_CHAR    *)0) ||
+        (cmpl_fnct   == (SMTPc_ASYNC_CMPL_FNCT)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
         return;
     }
 
-
-    if (msg->Sender != (SMTPc_MBOX *)0) {                       /* Header "Sender: ".                                   */
-        hdr       = (CPU_CHAR *)SMTPc_HDR_SENDER;
-        cur_wr_ix = SMTPc_BuildHdr( sock_id,                    /* Addr                                                 */
-                                    SMTPc_Comm_Buf,
-                                    SMTPc_COMM_BUF_LEN,
-                                    cur_wr_ix,
-                                    hdr,
-                                    msg->Sender->Addr,
-                                   &line_len,
-                                    perr);
-        if (*perr != SMTPc_ERR_NONE) {
-            return;
-        }
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+    if ((p_username == (CPU_CHAR *)0) ||
+        (p_pwd      == (CPU_CHAR *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
     }
+#endif
 
+#if ((SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED) && \
+     !defined(NET_SECURE_MODULE_EN))                            /* See Note #4.                                         */
+    if (p_secure_cfg != DEF_NULL) {
+       *p_err = SMTPc_ERR_SECURE_NOT_AVAIL;
+        return;
+    }
+#endif
 
-
-                                                                /* Header "To: ".                                       */
-    hdr = (CPU_CHAR *)SMTPc_HDR_TO;
-    for (i = 0; (i < SMTPc_CFG_MSG_MAX_TO) && (msg->ToArray[i] != (SMTPc_MBOX *)0); i++) {
-        cur_wr_ix = SMTPc_BuildHdr( sock_id,
-                                    SMTPc_Comm_Buf,
-                                    SMTPc_COMM_BUF_LEN,
-                                    cur_wr_ix,
-                                    hdr,
-                                    msg->ToArray[i]->Addr,
-                                   &line_len,
-                                    perr);
-        if (*perr != SMTPc_ERR_NONE) {
-            return;
+#endif
+#if (SMTPc_CFG_AUTH_EN != DEF_ENABLED)
+   (void)&p_username;                                           /* Prevent 'variable unused' compiler warnings.         */
+   (void)&p_pwd;
+#endif
+                                                                /* ------------------ VALIDATE MSG -------------------- */
+    SMTPc_MsgChk(p_msg, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+    if (p_msg->RenderBufPtr == (CPU_CHAR *)0) {                 /* See Note #2.                                         */
+       *p_err = SMTPc_ERR_NOT_RENDERED;
+        return;
+    }
+                                                                /* --------------------- INIT JOB --------------------- */
+    if (port == 0) {
+        if (p_secure_cfg != DEF_NULL) {
+            port = SMTPc_CFG_IPPORT_SECURE;
+        } else {
+            port = SMTPc_CFG_IPPORT;
         }
-        hdr = (CPU_CHAR *)0;
     }
 
+    SMTPc_SessionInit(&p_async->Sess);
+    p_async->MsgPtr       = p_msg;
+    p_async->HostNamePtr  = p_host_name;
+    p_async->Port         = port;
+    p_async->SecureCfgPtr = p_secure_cfg;
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+    p_async->UsernamePtr  = p_username;
+    p_async->PwdPtr       = p_pwd;
+#endif
+    p_async->CmplFnct     = cmpl_fnct;
+    p_async->CmplArg      = p_cmpl_arg;
+    p_async->State        = SMTPc_ASYNC_STATE_CONN;
+    p_async->Err          = SMTPc_ERR_NONE;
+    p_async->RcptIx       = 0u;
+    p_async->RcptOkCtr    = 0u;
+    p_async->TxPtr        = (CPU_CHAR *)0;
+    p_async->TxLen        = 0u;
+    p_async->TS           = SMTPc_TS_Get_ms();
+    p_async->NextPtr      = (SMTPc_ASYNC *)0;
+    p_async->PrevPtr      = (SMTPc_ASYNC *)0;
 
-                                                                /* Header "Reply-to: ".                                 */
-    hdr = (CPU_CHAR *)SMTPc_HDR_REPLYTO;
-    if (msg->ReplyTo != (SMTPc_MBOX *)0) {
-        cur_wr_ix = SMTPc_BuildHdr( sock_id,
-                                    SMTPc_Comm_Buf,
-                                    SMTPc_COMM_BUF_LEN,
-                                    cur_wr_ix,
-                                    hdr,
-                                    msg->ReplyTo->Addr,
-                                   &line_len,
-                                    perr);
-        if (*perr != SMTPc_ERR_NONE) {
-            return;
-        }
-        hdr = (CPU_CHAR *)0;
-    }
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_Poll()
+*
+* Description : Make the submitted jobs progress, without waiting for the servers.
+*
+* Argument(s) : work_max        Maximum number of steps performed (see Note #2).
+*
+* Return(s)   : Number of jobs still in progress.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) Each job runs the whole SMTP session on its own non-blocking socket : connection,
+*                   greeting, EHLO/HELO, AUTH, MAIL, RCPT, DATA, message content & QUIT.  A step performs
+*                   at most one transmission or one reception; a job waiting for its server is skipped
+*                   until data is available.
+*
+*               (2) The jobs are polled in turn, each at most once per call, so that 'work_max' bounds the
+*                   time spent in the function and no job starves the others.
+*
+*               (3) A job is removed from the list before its completion function is called, so that it
+*                   may be submitted again from the completion function.
+*
+*               (4) The connection is opened without waiting for the server to accept it, if the transport
+*                   supports it (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #1a').  Otherwise, the transport
+*                   blocks until the server accepts it or SMTPc_CFG_MAX_CONN_REQ_TIMEOUT_MS expires.
+*
+*               (5) SMTPc_Poll() is typically called periodically, or whenever the network signals
+*                   activity on one of the sockets, from the same task as SMTPc_AsyncSubmit().
+*********************************************************************************************************
+*/
+
+CPU_INT16U  SMTPc_Poll (CPU_INT16U  work_max)
+{
+    SMTPc_ASYNC  *p_async;
+    CPU_INT16U    nbr_step;
+    CPU_BOOLEAN   done;
+    CPU_BOOLEAN   blocked;
+
+
+    nbr_step = DEF_MIN(work_max, SMTPc_AsyncNbr);               /* See Note #2.                                         */
+
+    while (nbr_step > 0u) {
+        nbr_step--;
+                                                                /* --------------------- POP JOB ---------------------- */
+        p_async            = SMTPc_AsyncHeadPtr;
+        SMTPc_AsyncHeadPtr = p_async->NextPtr;
+        if (SMTPc_AsyncHeadPtr == (SMTPc_ASYNC *)0) {
+            SMTPc_AsyncTailPtr  = (SMTPc_ASYNC *)0;
+        }
+        p_async->NextPtr   = (SMTPc_ASYNC *)0;
+        SMTPc_AsyncNbr--;
+
+        done = SMTPc_AsyncStep(p_async, &blocked);
+        if (done == DEF_YES) {                                  /* See Note #3.                                         */
+            p_async->CmplFnct(p_async, p_async->Err, p_async->CmplArg);
+            continue;
+        }
+                                                                /* ------------------- RE-APPEND JOB ------------------ */
+        if (SMTPc_AsyncTailPtr == (SMTPc_ASYNC *)0) {
+            SMTPc_AsyncHeadPtr          = p_async;
+        } else {
+            SMTPc_AsyncTailPtr->NextPtr = p_async;
+        }
+        SMTPc_AsyncTailPtr = p_async;
+        SMTPc_AsyncNbr++;
+    }
+
+    return (SMTPc_AsyncNbr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_AsyncRun()
+*
+* Description : Make a job initialized by SMTPc_AsyncInit() progress, as long as it does not wait for its
+*               server.
+*
+* Argument(s) : p_async         Pointer to the job.
+*
+* Return(s)   : DEF_YES, if the job is over (see Note #2).
+*
+*               DEF_NO,  if the job waits for its server (see Note #1).
+*
+* Caller(s)   : Application,
+*               SMTPc_ReactorEpoll_Run().
+*
+* Note(s)     : (1) The job runs until its connection would block, so that it may be run again once its
+*                   connection is ready : i.e. until nothing is left to receive, or the connection does not
+*                   accept more data.  The connection of the job is 'p_async->Sess.SockId' once the job was
+*                   run the first time.
+*
+*                   The job is aborted once it made no progress for SMTPc_CFG_ASYNC_TIMEOUT_MS, on the next
+*                   call : it SHOULD be run again SMTPc_CFG_ASYNC_TIMEOUT_MS after its last progress
+*                   ('p_async->TS'), even if its connection is not ready.
+*
+*               (2) The completion function of the job is NOT called : the caller calls it once the job is
+*                   over, with 'p_async->Err' (see 'smtp-c.h  SMTPc_ASYNC  Note #3').
+*
+*               (3) A job MUST NOT be run by several tasks at once.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  SMTPc_AsyncRun (SMTPc_ASYNC  *p_async)
+{
+    CPU_BOOLEAN  done;
+    CPU_BOOLEAN  blocked;
+
+
+    do {                                                        /* See Note #1.                                         */
+        done = SMTPc_AsyncStep(p_async, &blocked);
+    } while ((done    == DEF_NO) &&
+             (blocked == DEF_NO));
+
+    return (done);
+}
+#endif
+
+
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+/*
+*********************************************************************************************************
+*                                          SMTPc_QueueInit()
+*
+* Description : (1) Initialize the outbound queue.
+*
+*                   (a) Validate the configuration
+*                   (b) Create the job queue
+*                   (c) Allocate the sessions of the workers
+*                   (d) Create the worker tasks
+*                   (e) Init the submission ring & create the task draining it, if enabled
+*                   (f) Create the retry scheduler task, if enabled
+*
+*
+* Argument(s) : p_cfg           Pointer to the run-time configuration of the queue (see 'smtp-c.h
+*                               SMTPc_QUEUE_CFG').
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, queue ready.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_cfg' passed a NULL pointer.
+*                               SMTPc_ERR_INVALID_CFG               Invalid configuration.
+*                               SMTPc_ERR_INIT_FAILED               Queue already initialized, or sessions/queue/
+*                                                                       tasks could not be created, now or by a
+*                                                                       previous call (see Note #5).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The function MUST be called once, after the network stack was initialized & before
+*                   SMTPc_QueueSubmit().  The memory is allocated from the heap & never freed.
+*
+*               (3) Each worker sends one message at a time.  Its sessions are a pool of its own, so that
+*                   connections to several servers can be kept open by each worker without being shared
+*                   between tasks (see 'smtp-c_cfg.h  Note #15b').
+*
+*               (4) The jitter generator is seeded with the timestamp, if available, so that devices
+*                   started together do not draw the same delays.
+*
+*               (5) The kernel does not offer to delete a task pending on the job queue, so a failure after
+*                   the job queue was created cannot be undone : the tasks already created keep running on
+*                   it.  The failure is therefore sticky : every later call fails, rather than creating a
+*                   second queue & a second set of workers.  The queue is NOT usable & SMTPc_QueueSubmit()
+*                   keeps returning SMTPc_ERR_NOT_INIT.
+*
+*                   The sessions of the workers are allocated once the job queue was created, so that any
+*                   failure after their allocation is sticky too : heap memory cannot be freed, & is never
+*                   allocated twice.
+*********************************************************************************************************
+*/
+
+void  SMTPc_QueueInit (const  SMTPc_QUEUE_CFG  *p_cfg,
+                              SMTPc_ERR        *p_err)
+{
+    SMTPc_POOL_ENTRY  *p_tbl;
+    KAL_TASK_HANDLE    task_handle;
+    CPU_SIZE_T         tbl_size;
+    CPU_INT08U         i;
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+    CPU_INT32U         slot_ix;
+#endif
+    KAL_ERR            err_kal;
+    LIB_MEM_ERR        err_lib;
+
+                                                                /* ------------------ VALIDATE CFG -------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_cfg == (const SMTPc_QUEUE_CFG *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+    if ((p_cfg->JobQSize      == 0u) ||
+        (p_cfg->WorkerNbr     == 0u) ||
+        (p_cfg->WorkerSessNbr == 0u)) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+    if (p_cfg->RetryDlyMin_ms > p_cfg->RetryDlyMax_ms) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+#endif
+    if ((SMTPc_QueueInitDone   == DEF_YES) ||                   /* See Note #2.                                         */
+        (SMTPc_QueueInitFailed == DEF_YES)) {                   /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* ------------------- CREATE JOB Q ------------------- */
+    SMTPc_QueueHandle = KAL_QCreate("SMTPc Job Q",
+                                     p_cfg->JobQSize,
+                                     DEF_NULL,
+                                    &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* ------------------ ALLOC SESSIONS ------------------ */
+    tbl_size = (CPU_SIZE_T)p_cfg->WorkerNbr * p_cfg->WorkerSessNbr;
+    p_tbl    = (SMTPc_POOL_ENTRY *)Mem_SegAlloc("SMTPc Worker Sessions",
+                                                 DEF_NULL,
+                                                 tbl_size * sizeof(SMTPc_POOL_ENTRY),
+                                                &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+    Mem_Clr(p_tbl, tbl_size * sizeof(SMTPc_POOL_ENTRY));        /* All entries free.                                    */
+    SMTPc_QueueWorkerSessNbr = p_cfg->WorkerSessNbr;
+                                                                /* ---------------- CREATE WORKER TASKS --------------- */
+    for (i = 0u; i < p_cfg->WorkerNbr; i++) {
+        task_handle = KAL_TaskAlloc("SMTPc Worker",
+                                     DEF_NULL,
+                                     p_cfg->WorkerStkSizeBytes,
+                                     DEF_NULL,
+                                    &err_kal);
+        if (err_kal != KAL_ERR_NONE) {
+            SMTPc_QueueInitFailed = DEF_YES;                    /* See Note #5.                                         */
+           *p_err = SMTPc_ERR_INIT_FAILED;
+            return;
+        }
+
+        KAL_TaskCreate(task_handle,
+                       SMTPc_QueueWorkerTask,
+                      &p_tbl[i * p_cfg->WorkerSessNbr],         /* See Note #3.                                         */
+                       p_cfg->WorkerPrio,
+                       DEF_NULL,
+                      &err_kal);
+        if (err_kal != KAL_ERR_NONE) {
+            SMTPc_QueueInitFailed = DEF_YES;                    /* See Note #5.                                         */
+           *p_err = SMTPc_ERR_INIT_FAILED;
+            return;
+        }
+    }
+
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+                                                                /* --------------------- INIT RING -------------------- */
+    for (slot_ix = 0u; slot_ix < SMTPc_CFG_QUEUE_RING_SIZE; slot_ix++) {
+        SMTPc_QueueRingTbl[slot_ix].Seq = slot_ix;              /* Each slot ready for its pos on the first lap.        */
+    }
+
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+    SMTPc_QueueRingSemHandle = KAL_SemCreate("SMTPc Ring Sem",
+                                              DEF_NULL,
+                                             &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+#endif
+                                                                /* ----------------- CREATE RING TASK ----------------- */
+    task_handle = KAL_TaskAlloc("SMTPc Ring",
+                                 DEF_NULL,
+                                 p_cfg->RingStkSizeBytes,
+                                 DEF_NULL,
+                                &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    KAL_TaskCreate(task_handle,
+                   SMTPc_QueueRingTask,
+                   DEF_NULL,
+                   p_cfg->RingPrio,
+                   DEF_NULL,
+                  &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+#endif
+
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+                                                                /* ---------------- CREATE SCHED TASK ----------------- */
+    SMTPc_SchedRetryNbrMax    = p_cfg->RetryNbrMax;
+    SMTPc_SchedRetryDlyMin_ms = p_cfg->RetryDlyMin_ms;
+    SMTPc_SchedRetryDlyMax_ms = p_cfg->RetryDlyMax_ms;
+#if (CPU_CFG_TS_32_EN == DEF_ENABLED)
+    SMTPc_SchedRandState      = (CPU_INT32U)CPU_TS_Get32();     /* See Note #4.                                         */
+#endif
+    if (SMTPc_SchedRandState == 0u) {                           /* Generator state MUST NOT be 0.                       */
+        SMTPc_SchedRandState = 0x2545F491u;
+    }
+
+    SMTPc_SchedLockHandle = KAL_LockCreate("SMTPc Sched Lock",
+                                            DEF_NULL,
+                                           &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    task_handle = KAL_TaskAlloc("SMTPc Sched",
+                                 DEF_NULL,
+                                 p_cfg->SchedStkSizeBytes,
+                                 DEF_NULL,
+                                &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    KAL_TaskCreate(task_handle,
+                   SMTPc_SchedTask,
+                   DEF_NULL,
+                   p_cfg->SchedPrio,
+                   DEF_NULL,
+                  &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        SMTPc_QueueInitFailed = DEF_YES;                        /* See Note #5.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+#endif
+
+    SMTPc_QueueInitDone = DEF_YES;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_QueueSubmit()
+*
+* Description : Submit a message to be sent by the workers of the outbound queue.
+*
+* Argument(s) : p_job           Pointer to the job (see 'smtp-c.h  SMTPc_JOB  Note #2').
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL):
+*
+*                                       DEF_NULL, if no security enabled.
+*                                       Pointer to a structure that contains the parameters.
+*
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*
+*               cmpl_fnct       Function called by the worker when the job is done, if any.
+*
+*               p_cmpl_arg      Argument passed to 'cmpl_fnct'.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, job queued.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_job'/'p_host_name' passed a NULL pointer.
+*                               SMTPc_ERR_NOT_INIT                  Queue not initialized.
+*                               SMTPc_ERR_QUEUE_FULL                Job queue full.
+*
+*                                                                   ------- RETURNED BY SMTPc_MsgChk : -------
+*                               SMTPc_ERR_NULL_ARG                  No message, sender or recipient.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               Completion function of a job,
+*               SMTPc_SpoolTask().
+*
+* Note(s)     : (1) The function returns as soon as the job is queued.  The message, the strings & the
+*                   secure configuration MUST remain valid until the job is done.
+*
+*               (2) The job MUST NOT already be pending or active.  It may be submitted again once done.
+*
+*               (3) The completion function is called from the worker task, after the status of the job
+*                   was set to SMTPc_JOB_STATUS_DONE.
+*********************************************************************************************************
+*/
+
+void  SMTPc_QueueSubmit (SMTPc_JOB                *p_job,
+                         CPU_CHAR                 *p_host_name,
+                         CPU_INT16U                port,
+                         CPU_CHAR                 *p_username,
+                         CPU_CHAR                 *p_pwd,
+                         SMTPc_SECURE_CFG         *p_secure_cfg,
+                         SMTPc_MSG                *p_msg,
+                         SMTPc_JOB_CMPL_FNCT       cmpl_fnct,
+                         void                     *p_cmpl_arg,
+                         SMTPc_ERR                *p_err)
+{
+    KAL_ERR  err_kal;
+
+                                                                /* ------------------ VALIDATE ARGS ------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_job       == (SMTPc_JOB *)0) ||
+        (p_host_name == (CPU_CHAR  *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+    if (SMTPc_QueueInitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_NOT_INIT;
+        return;
+    }
+
+    SMTPc_MsgChk(p_msg, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* --------------------- INIT JOB --------------------- */
+    p_job->HostNamePtr  = p_host_name;
+    p_job->Port         = port;
+    p_job->UsernamePtr  = p_username;
+    p_job->PwdPtr       = p_pwd;
+    p_job->SecureCfgPtr = p_secure_cfg;
+    p_job->MsgPtr       = p_msg;
+    p_job->CmplFnct     = cmpl_fnct;
+    p_job->CmplArg      = p_cmpl_arg;
+    p_job->Status       = SMTPc_JOB_STATUS_PEND;
+    p_job->Err          = SMTPc_ERR_NONE;
+    p_job->RepCode      = 0u;
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+    p_job->RetryCtr     = 0u;
+#endif
+
+                                                                /* --------------------- QUEUE JOB -------------------- */
+    KAL_QPost(SMTPc_QueueHandle, p_job, KAL_OPT_POST_NONE, &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+        p_job->Status = SMTPc_JOB_STATUS_IDLE;
+       *p_err = SMTPc_ERR_QUEUE_FULL;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_QueueStatusGet()
+*
+* Description : Get the status of a job submitted to the outbound queue.
+*
+* Argument(s) : p_job           Pointer to the job.
+*
+*               p_err_job       Pointer to variable that will receive the result of the job, once done (see
+*                               'smtp-c.h  SMTPc_JOB  Note #3').
+*
+* Return(s)   : Status of the job :
+*
+*                   SMTPc_JOB_STATUS_IDLE           Job never submitted, or could not be queued.
+*                   SMTPc_JOB_STATUS_PEND           Job waiting for a worker.
+*                   SMTPc_JOB_STATUS_ACTIVE         Message being sent.
+*                   SMTPc_JOB_STATUS_DONE           Job over, result returned in 'p_err_job'.
+*                   SMTPc_JOB_STATUS_SCHED          Job waiting for its send time or for a retry.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The status is read from any task, while it is updated by a worker.  It is hence read
+*                   together with the result in a critical section.
+*********************************************************************************************************
+*/
+
+CPU_INT08U  SMTPc_QueueStatusGet (SMTPc_JOB  *p_job,
+                                  SMTPc_ERR  *p_err_job)
+{
+    CPU_INT08U  status;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    status     = p_job->Status;
+   *p_err_job  = p_job->Err;
+    CPU_CRITICAL_EXIT();
+
+    return (status);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_QueueSubmitDly()
+*
+* Description : Submit a message to be sent by the workers of the outbound queue, after a delay.
+*
+* Argument(s) : p_job           Pointer to the job (see 'smtp-c.h  SMTPc_JOB  Note #2').
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL):
+*
+*                                       DEF_NULL, if no security enabled.
+*                                       Pointer to a structure that contains the parameters.
+*
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*
+*               cmpl_fnct       Function called by the worker when the job is done, if any.
+*
+*               p_cmpl_arg      Argument passed to 'cmpl_fnct'.
+*
+*               dly_ms          Delay before the job is queued, in milliseconds (see Note #1).
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, job scheduled.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_job'/'p_host_name' passed a NULL pointer.
+*                               SMTPc_ERR_NOT_INIT                  Queue not initialized.
+*
+*                                                                   ----- RETURNED BY SMTPc_QueueSubmit() : -----
+*                               SMTPc_ERR_QUEUE_FULL                Job queue full.
+*
+*                                                                   ------- RETURNED BY SMTPc_MsgChk : -------
+*                               SMTPc_ERR_NULL_ARG                  No message, sender or recipient.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               Completion function of a job.
+*
+* Note(s)     : (1) The delay is rounded up to a whole number of SMTPc_CFG_SCHED_TICK_MS & limited to 2^24
+*                   ticks.  A job with no delay is queued at once by SMTPc_QueueSubmit().
+*
+*               (2) The job is queued by the scheduler task once the delay expired; it is kept in the
+*                   timer wheel until the job queue accepts it.  SMTPc_QueueSubmit() Notes #1 to #3 also
+*                   apply.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+void  SMTPc_QueueSubmitDly (SMTPc_JOB                *p_job,
+                            CPU_CHAR                 *p_host_name,
+                            CPU_INT16U                port,
+                            CPU_CHAR                 *p_username,
+                            CPU_CHAR                 *p_pwd,
+                            SMTPc_SECURE_CFG         *p_secure_cfg,
+                            SMTPc_MSG                *p_msg,
+                            SMTPc_JOB_CMPL_FNCT       cmpl_fnct,
+                            void                     *p_cmpl_arg,
+                            CPU_INT32U                dly_ms,
+                            SMTPc_ERR                *p_err)
+{
+    if (dly_ms == 0u) {                                         /* See Note #1.                                         */
+        SMTPc_QueueSubmit(p_job,
+                          p_host_name,
+                          port,
+                          p_username,
+                          p_pwd,
+                          p_secure_cfg,
+                          p_msg,
+                          cmpl_fnct,
+                          p_cmpl_arg,
+                          p_err);
+        return;
+    }
+                                                                /* ------------------ VALIDATE ARGS ------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_job       == (SMTPc_JOB *)0) ||
+        (p_host_name == (CPU_CHAR  *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+    if (SMTPc_QueueInitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_NOT_INIT;
+        return;
+    }
+
+    SMTPc_MsgChk(p_msg, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* --------------------- INIT JOB --------------------- */
+    p_job->HostNamePtr  = p_host_name;
+    p_job->Port         = port;
+    p_job->UsernamePtr  = p_username;
+    p_job->PwdPtr       = p_pwd;
+    p_job->SecureCfgPtr = p_secure_cfg;
+    p_job->MsgPtr       = p_msg;
+    p_job->CmplFnct     = cmpl_fnct;
+    p_job->CmplArg      = p_cmpl_arg;
+    p_job->Err          = SMTPc_ERR_NONE;
+    p_job->RepCode      = 0u;
+    p_job->RetryCtr     = 0u;
+
+                                                                /* -------------------- SCHED JOB --------------------- */
+    SMTPc_SchedAdd(p_job, dly_ms);                              /* See Note #2.                                         */
+
+   *p_err = SMTPc_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_QueueRingSubmit()
+*
+* Description : Submit a message to the outbound queue through the submission ring.
+*
+* Argument(s) : p_job           Pointer to the job (see 'smtp-c.h  SMTPc_JOB  Note #2').
+*
+*               p_host_name     Pointer to host name of the SMTP server to contact. Can be also an IP address.
+*
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*
+*               p_username      Pointer to user name, if authentication enabled.
+*
+*               p_pwd           Pointer to password,  if authentication enabled.
+*
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL):
+*
+*                                       DEF_NULL, if no security enabled.
+*                                       Pointer to a structure that contains the parameters.
+*
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*
+*               cmpl_fnct       Function called by the worker when the job is done, if any.
+*
+*               p_cmpl_arg      Argument passed to 'cmpl_fnct'.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, job put in the ring.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_job'/'p_host_name'/'p_msg' passed
+*                                                                       a NULL pointer.
+*                               SMTPc_ERR_NOT_INIT                  Queue not initialized.
+*                               SMTPc_ERR_QUEUE_FULL                Submission ring full.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               Completion function of a job.
+*
+* Note(s)     : (1) The function never pends & MAY be called from any task.  It MAY also be called from
+*                   deferred interrupt context when the wake-up of the ring task is disabled, since it then
+*                   never calls the kernel (see Note #5).
+*
+*               (2) The message is not checked here; it is checked by the worker & an invalid message is
+*                   reported as the result of the job.  SMTPc_QueueSubmit() Notes #1 & #2 also apply.
+*
+*               (3) The ring has a single consumer, the ring task, & many producers.  Each slot holds the
+*                   sequence number of the position it is ready for, as in D. Vyukov's bounded queue :
+*
+*                   (a) A producer claims position 'pos' by a compare-and-swap of the head from 'pos' to
+*                       'pos + 1', if the sequence of its slot is 'pos'; a lower sequence means the slot
+*                       still holds the job of the previous lap, i.e. the ring is full.  The job is then
+*                       published by setting the sequence to 'pos + 1'.
+*
+*                   (b) The consumer takes the job of position 'pos' once its sequence is 'pos + 1', then
+*                       frees the slot by setting it to 'pos + SMTPc_CFG_QUEUE_RING_SIZE'.
+*
+*                   No producer ever waits for another one, nor disables interrupts.  The atomic operations
+*                   are provided by the port (see 'smtp-c_cfg.h  Note #15e'); when they are not, the slot is
+*                   claimed & the job published in a critical section of a few instructions instead.
+*
+*               (4) The enqueue latency, from the entry in the function until the job is in the ring, is
+*                   accounted in the histogram of SMTPc_QueueRingStatsGet() once the job was published, with
+*                   atomic operations; each bucket 'i' counts the latencies of 'i' significant bits.  Without
+*                   atomic operations, the statistics are updated in a second critical section.
+*
+*               (5) When SMTPc_CFG_QUEUE_RING_WAKE_EN is enabled, the producer that puts a job in an empty
+*                   ring, i.e. at the position of the tail, posts the semaphore the ring task pends on, so
+*                   that the job is moved to the job queue at once.  Otherwise, the ring task polls the ring
+*                   every SMTPc_CFG_QUEUE_RING_POLL_MS, which bounds the delay added to the job; the largest
+*                   delay is reported by SMTPc_QueueRingStatsGet().
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+void  SMTPc_QueueRingSubmit (SMTPc_JOB                *p_job,
+                             CPU_CHAR                 *p_host_name,
+                             CPU_INT16U                port,
+                             CPU_CHAR                 *p_username,
+                             CPU_CHAR                 *p_pwd,
+                             SMTPc_SECURE_CFG         *p_secure_cfg,
+                             SMTPc_MSG                *p_msg,
+                             SMTPc_JOB_CMPL_FNCT       cmpl_fnct,
+                             void                     *p_cmpl_arg,
+                             SMTPc_ERR                *p_err)
+{
+    SMTPc_QUEUE_RING_SLOT  *p_slot;
+    CPU_TS32                ts_start;
+    CPU_TS32                lat;
+    CPU_INT32U              pos;
+    CPU_INT32U              lat_sum;
+    CPU_INT08U              hist_ix;
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+    CPU_BOOLEAN             was_empty;
+    KAL_ERR                 err_kal;
+#endif
+#if (SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED)
+    CPU_INT32U              seq;
+    CPU_INT32S              diff;
+    CPU_TS32                lat_max;
+#else
+    CPU_SR_ALLOC();
+#endif
+
+
+    ts_start = CPU_TS_Get32();                                  /* See Note #4.                                         */
+
+                                                                /* ------------------ VALIDATE ARGS ------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if ((p_job       == (SMTPc_JOB *)0) ||
+        (p_host_name == (CPU_CHAR  *)0) ||
+        (p_msg       == (SMTPc_MSG *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+    if (SMTPc_QueueInitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_NOT_INIT;
+        return;
+    }
+                                                                /* --------------------- INIT JOB --------------------- */
+    p_job->HostNamePtr  = p_host_name;
+    p_job->Port         = port;
+    p_job->UsernamePtr  = p_username;
+    p_job->PwdPtr       = p_pwd;
+    p_job->SecureCfgPtr = p_secure_cfg;
+    p_job->MsgPtr       = p_msg;
+    p_job->CmplFnct     = cmpl_fnct;
+    p_job->CmplArg      = p_cmpl_arg;
+    p_job->Status       = SMTPc_JOB_STATUS_PEND;
+    p_job->Err          = SMTPc_ERR_NONE;
+    p_job->RepCode      = 0u;
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+    p_job->RetryCtr     = 0u;
+#endif
+
+                                                                /* ---------------------- PUT JOB --------------------- */
+#if (SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED)
+    pos = SMTPc_ATOMIC_LD32(&SMTPc_QueueRingHead);              /* See Note #3a.                                        */
+    while (DEF_ON) {
+        p_slot =  &SMTPc_QueueRingTbl[pos & SMTPc_QUEUE_RING_MASK];
+        seq    =   SMTPc_ATOMIC_LD32(&p_slot->Seq);
+        diff   = (CPU_INT32S)(seq - pos);
+        if (diff == 0) {                                        /* Slot ready for 'pos' : claim it ...                  */
+            if (SMTPc_ATOMIC_CAS32(&SMTPc_QueueRingHead, &pos, pos + 1u)) {
+                break;
+            }                                                   /* ... else, 'pos' was reloaded by the CAS.             */
+        } else if (diff < 0) {                                  /* Slot holding the job of the previous lap.            */
+           (void)SMTPc_ATOMIC_ADD32(&SMTPc_QueueRingFullCtr, 1u);
+            p_job->Status = SMTPc_JOB_STATUS_IDLE;
+           *p_err = SMTPc_ERR_QUEUE_FULL;
+            return;
+        } else {                                                /* Slot claimed by another producer.                    */
+            pos = SMTPc_ATOMIC_LD32(&SMTPc_QueueRingHead);
+        }
+    }
+    p_slot->JobPtr = p_job;
+    p_slot->TS     = CPU_TS_Get32();
+    SMTPc_ATOMIC_ST32(&p_slot->Seq, pos + 1u);                  /* Publish the job.                                     */
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+    was_empty = (SMTPc_ATOMIC_LD32(&SMTPc_QueueRingTail) == pos) ? DEF_YES : DEF_NO;
+#endif
+#else
+    CPU_CRITICAL_ENTER();                                       /* See Note #3.                                         */
+    pos    =  SMTPc_QueueRingHead;
+    p_slot = &SMTPc_QueueRingTbl[pos & SMTPc_QUEUE_RING_MASK];
+    if (p_slot->Seq != pos) {
+        SMTPc_QueueRingFullCtr++;
+        CPU_CRITICAL_EXIT();
+        p_job->Status = SMTPc_JOB_STATUS_IDLE;
+       *p_err = SMTPc_ERR_QUEUE_FULL;
+        return;
+    }
+    SMTPc_QueueRingHead = pos + 1u;
+    p_slot->JobPtr      = p_job;
+    p_slot->TS          = CPU_TS_Get32();
+    p_slot->Seq         = pos + 1u;
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+    was_empty = (SMTPc_QueueRingTail == pos) ? DEF_YES : DEF_NO;
+#endif
+    CPU_CRITICAL_EXIT();
+#endif
+                                                                /* ------------------- UPDATE STATS ------------------- */
+    lat     = CPU_TS_Get32() - ts_start;                        /* See Note #4.                                         */
+    hist_ix = (CPU_INT08U)(32u - CPU_CntLeadZeros32(lat));
+#if (SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED)
+   (void)SMTPc_ATOMIC_ADD32(&SMTPc_QueueRingLatHistTbl[hist_ix], 1u);
+    lat_sum = SMTPc_ATOMIC_ADD32(&SMTPc_QueueRingLatSumLo, lat);
+    if ((CPU_INT32U)(lat_sum + lat) < lat_sum) {                /* Carry into the high word.                            */
+       (void)SMTPc_ATOMIC_ADD32(&SMTPc_QueueRingLatSumHi, 1u);
+    }
+    lat_max = SMTPc_ATOMIC_LD32(&SMTPc_QueueRingLatMax);
+    while (lat > lat_max) {
+        if (SMTPc_ATOMIC_CAS32(&SMTPc_QueueRingLatMax, &lat_max, lat)) {
+            break;
+        }                                                       /* Else, 'lat_max' was reloaded by the CAS.             */
+    }
+   (void)SMTPc_ATOMIC_ADD32(&SMTPc_QueueRingSubmitCtr, 1u);
+#else
+    CPU_CRITICAL_ENTER();
+    SMTPc_QueueRingLatHistTbl[hist_ix]++;
+    lat_sum                 = SMTPc_QueueRingLatSumLo;
+    SMTPc_QueueRingLatSumLo = lat_sum + lat;
+    if (SMTPc_QueueRingLatSumLo < lat_sum) {                    /* Carry into the high word.                            */
+        SMTPc_QueueRingLatSumHi++;
+    }
+    if (lat > SMTPc_QueueRingLatMax) {
+        SMTPc_QueueRingLatMax = lat;
+    }
+    SMTPc_QueueRingSubmitCtr++;
+    CPU_CRITICAL_EXIT();
+#endif
+                                                                /* ------------------- WAKE CONSUMER ------------------ */
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+    if (was_empty == DEF_YES) {                                 /* See Note #5.                                         */
+        KAL_SemPost(SMTPc_QueueRingSemHandle, KAL_OPT_POST_NONE, &err_kal);
+       (void)&err_kal;                                          /* On failure, the job is moved on the next poll.       */
+    }
+#endif
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_QueueRingStatsGet()
+*
+* Description : Get the statistics of the submission ring.
+*
+* Argument(s) : p_stats         Pointer to the structure that will receive the statistics (see 'smtp-c.h
+*                               SMTPc_QUEUE_RING_STATS').
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The counters & the latency histogram are copied in a critical section & the percentile is
+*                   computed from the copy.  When the ring uses atomic operations, the producers update the
+*                   statistics outside of any critical section (see 'SMTPc_QueueRingSubmit()  Note #4'), so
+*                   a submission in progress may be partly accounted in the copy.
+*
+*               (2) The 99th percentile is the upper bound of the histogram bucket holding the job of rank
+*                   ceil(0.99 * SubmitCtr), limited to the maximum latency.
+*********************************************************************************************************
+*/
+
+void  SMTPc_QueueRingStatsGet (SMTPc_QUEUE_RING_STATS  *p_stats)
+{
+    CPU_INT32U  hist_tbl[SMTPc_QUEUE_RING_LAT_HIST_NBR];
+    CPU_INT64U  lat_sum;
+    CPU_TS32    lat_max;
+    CPU_TS32    drain_lat_max;
+    CPU_TS32    lat_p99;
+    CPU_INT32U  submit_ctr;
+    CPU_INT32U  rank;
+    CPU_INT32U  cnt;
+    CPU_INT08U  i;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    submit_ctr       = SMTPc_QueueRingSubmitCtr;
+    p_stats->FullCtr = SMTPc_QueueRingFullCtr;
+    lat_sum          = ((CPU_INT64U)SMTPc_QueueRingLatSumHi << 32u) | SMTPc_QueueRingLatSumLo;
+    lat_max          = SMTPc_QueueRingLatMax;
+    drain_lat_max    = SMTPc_QueueRingDrainLatMax;
+    Mem_Copy(hist_tbl, SMTPc_QueueRingLatHistTbl, sizeof(hist_tbl));
+    CPU_CRITICAL_EXIT();
+
+    p_stats->SubmitCtr      = submit_ctr;
+    p_stats->DrainLatMax_us = (CPU_INT32U)CPU_TS32_to_uSec(drain_lat_max);
+    if (submit_ctr == 0u) {
+        p_stats->LatAvg_us = 0u;
+        p_stats->LatP99_us = 0u;
+        p_stats->LatMax_us = 0u;
+        return;
+    }
+                                                                /* --------------- FIND 99TH PERCENTILE --------------- */
+    rank = (CPU_INT32U)(((CPU_INT64U)submit_ctr * 99u + 99u) / 100u);
+    cnt  = 0u;
+    i    = 0u;
+    while (i < (SMTPc_QUEUE_RING_LAT_HIST_NBR - 1u)) {
+        cnt += hist_tbl[i];
+        if (cnt >= rank) {
+            break;
+        }
+        i++;
+    }
+
+    if (i == 0u) {                                              /* See Note #2.                                         */
+        lat_p99 = 0u;
+    } else {
+        lat_p99 = DEF_INT_32U_MAX_VAL >> (32u - i);
+    }
+    lat_p99 = DEF_MIN(lat_p99, lat_max);
+
+    p_stats->LatAvg_us = (CPU_INT32U)CPU_TS32_to_uSec((CPU_TS32)(lat_sum / submit_ctr));
+    p_stats->LatP99_us = (CPU_INT32U)CPU_TS32_to_uSec(lat_p99);
+    p_stats->LatMax_us = (CPU_INT32U)CPU_TS32_to_uSec(lat_max);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_QueueRingStatsClr()
+*
+* Description : Clear the statistics of the submission ring.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  SMTPc_QueueRingStatsClr (void)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    SMTPc_QueueRingSubmitCtr   = 0u;
+    SMTPc_QueueRingFullCtr     = 0u;
+    SMTPc_QueueRingLatSumLo    = 0u;
+    SMTPc_QueueRingLatSumHi    = 0u;
+    SMTPc_QueueRingLatMax      = 0u;
+    SMTPc_QueueRingDrainLatMax = 0u;
+    Mem_Clr(SMTPc_QueueRingLatHistTbl, sizeof(SMTPc_QueueRingLatHistTbl));
+    CPU_CRITICAL_EXIT();
+}
+#endif
+#endif
+
+
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+/*
+*********************************************************************************************************
+*                                          SMTPc_SpoolInit()
+*
+* Description : (1) Initialize the persistent spool.
+*
+*                   (a) Validate the configuration
+*                   (b) Allocate the spooled messages
+*                   (c) Recover the messages left in the storage
+*                   (d) Create the spool task
+*
+*
+* Argument(s) : p_cfg           Pointer to the run-time configuration of the spool (see 'smtp-c.h
+*                               SMTPc_SPOOL_CFG').
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, spool ready.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_cfg' passed a NULL pointer, or no
+*                                                                       storage or server set.
+*                               SMTPc_ERR_INVALID_CFG               Invalid configuration.
+*                               SMTPc_ERR_NOT_INIT                  Outbound queue not initialized.
+*                               SMTPc_ERR_INIT_FAILED               Spool already initialized, memory/lock/task
+*                                                                       could not be allocated, or more
+*                                                                       messages stored than 'MsgNbrMax'.
+*                               SMTPc_ERR_SPOOL_IO                  Storage could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The function MUST be called once, after SMTPc_QueueInit() & after the storage is
+*                   available.  The memory is allocated from the heap & never freed.
+*
+*               (3) The messages recovered are submitted to the outbound queue by the spool task, as any
+*                   message spooled; the completion function is called for each of them.
+*********************************************************************************************************
+*/
+
+void  SMTPc_SpoolInit (const  SMTPc_SPOOL_CFG  *p_cfg,
+                              SMTPc_ERR        *p_err)
+{
+    SMTPc_SPOOL_ENTRY  *p_tbl;
+    KAL_TASK_HANDLE     task_handle;
+    CPU_SIZE_T          rec_len;
+    CPU_INT16U          i;
+    KAL_ERR             err_kal;
+    LIB_MEM_ERR         err_lib;
+
+                                                                /* ------------------ VALIDATE CFG -------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_cfg == (const SMTPc_SPOOL_CFG *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+    if ((p_cfg->StorageAPI_Ptr == (const SMTPc_SPOOL_API *)0) ||
+        (p_cfg->HostNamePtr    == (CPU_CHAR              *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+#endif
+    if ((p_cfg->MsgNbrMax     == 0u) ||
+        (p_cfg->MsgLenMax     == 0u) ||
+        (p_cfg->SegLenMax     == 0u) ||
+        (p_cfg->SyncPeriod_ms == 0u)) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+    if (SMTPc_SpoolInitDone == DEF_YES) {                       /* See Note #2.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+    if (SMTPc_QueueInitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_NOT_INIT;
+        return;
+    }
+    SMTPc_SpoolCfg = *p_cfg;
+                                                                /* -------------------- ALLOC MSGS -------------------- */
+    rec_len = sizeof(SMTPc_SPOOL_REC_HDR) + SMTPc_SPOOL_ENV_LEN + p_cfg->MsgLenMax;
+    p_tbl   = (SMTPc_SPOOL_ENTRY *)Mem_SegAlloc("SMTPc Spool Msgs",
+                                                 DEF_NULL,
+                                                 p_cfg->MsgNbrMax * sizeof(SMTPc_SPOOL_ENTRY),
+                                                &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* All entries free.                                    */
+    Mem_Clr(p_tbl, p_cfg->MsgNbrMax * sizeof(SMTPc_SPOOL_ENTRY));
+
+    for (i = 0u; i < p_cfg->MsgNbrMax; i++) {
+        p_tbl[i].RecPtr = (CPU_INT08U *)Mem_SegAlloc("SMTPc Spool Rec Buf",
+                                                      DEF_NULL,
+                                                      rec_len,
+                                                     &err_lib);
+        if (err_lib != LIB_MEM_ERR_NONE) {
+           *p_err = SMTPc_ERR_INIT_FAILED;
+            return;
+        }
+    }
+    SMTPc_SpoolEntryTbl  = p_tbl;
+    SMTPc_SpoolRecLenMax = (CPU_INT32U)rec_len;
+
+    SMTPc_SpoolLockHandle = KAL_LockCreate("SMTPc Spool Lock",
+                                            DEF_NULL,
+                                           &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* ------------------- RECOVER MSGS ------------------- */
+    SMTPc_SpoolRecover(p_err);                                  /* See Note #3.                                         */
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ----------------- CREATE SPOOL TASK ---------------- */
+    task_handle = KAL_TaskAlloc("SMTPc Spool",
+                                 DEF_NULL,
+                                 p_cfg->TaskStkSizeBytes,
+                                 DEF_NULL,
+                                &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    KAL_TaskCreate(task_handle,
+                   SMTPc_SpoolTask,
+                   DEF_NULL,
+                   p_cfg->TaskPrio,
+                   DEF_NULL,
+                  &err_kal);
+    if (err_kal != KAL_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    SMTPc_SpoolInitDone = DEF_YES;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_SpoolSubmit()
+*
+* Description : (1) Store a rendered message in the persistent spool, to be sent through the outbound queue.
+*
+*                   (a) Validate the message
+*                   (b) Build the record of the message : envelope & rendered content
+*                   (c) Append the record to the current segment
+*
+*
+* Argument(s) : p_msg           SMTPc_MSG structure encapsulating the message to send, rendered by
+*                               SMTPc_RenderMsg().
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, message spooled.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_msg' passed a NULL pointer.
+*                               SMTPc_ERR_NOT_INIT                  Spool not initialized.
+*                               SMTPc_ERR_NOT_RENDERED              Message not rendered.
+*                               SMTPc_ERR_BUF_TOO_SMALL             Rendered message longer than 'MsgLenMax'.
+*                               SMTPc_ERR_QUEUE_FULL                Spool full.
+*                               SMTPc_ERR_SPOOL_IO                  Record could not be written.
+*
+* Return(s)   : Id of the message, passed to the completion function (see 'smtp-c.h  SMTPc_SPOOL_CFG
+*               Note #3'), if NO error(s).
+*
+*               0,                                                                   otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The message is copied : the structure & its rendered content may be reused as soon as
+*                   the function returns.
+*
+*               (3) The record is written but not synced : the spool task syncs the storage once for all
+*                   the records written during its period (group commit) & only then submits the messages
+*                   to the outbound queue.  A message is hence never sent before it is durable, but MAY be
+*                   lost on a reset until the commit that covers it, within about 'SyncPeriod_ms' of its
+*                   submission.  The message is durable once SMTPc_SpoolSyncIdGet() returns its id or a
+*                   higher one; the sync function, if any, is called when this happens (see 'smtp-c.h
+*                   SMTPc_SPOOL_CFG  Note #4').
+*
+*               (4) Ids start at 1 & increase with each message, including the ones already stored.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  SMTPc_SpoolSubmit (SMTPc_MSG  *p_msg,
+                               SMTPc_ERR  *p_err)
+{
+    SMTPc_SPOOL_ENTRY    *p_entry;
+    SMTPc_SPOOL_REC_HDR  *p_hdr;
+    CPU_INT08U           *p_data;
+    CPU_INT32U            len;
+    CPU_INT32U            msg_id;
+    CPU_INT16U            i;
+    KAL_ERR               err_kal;
+
+                                                                /* ------------------ VALIDATE MSG -------------------- */
+#if (SMTPc_CFG_ARG_CHK_EXT_EN == DEF_ENABLED)
+    if (p_msg == (SMTPc_MSG *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return (0u);
+    }
+#endif
+    if (SMTPc_SpoolInitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_NOT_INIT;
+        return (0u);
+    }
+    if (p_msg->RenderBufPtr == (CPU_CHAR *)0) {
+       *p_err = SMTPc_ERR_NOT_RENDERED;
+        return (0u);
+    }
+    if (p_msg->RenderLen > SMTPc_SpoolCfg.MsgLenMax) {
+       *p_err = SMTPc_ERR_BUF_TOO_SMALL;
+        return (0u);
+    }
+
+    KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+   (void)&err_kal;                                              /* No timeout.                                          */
+
+    p_entry = (SMTPc_SPOOL_ENTRY *)0;
+    for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {
+        if (SMTPc_SpoolEntryTbl[i].State == SMTPc_SPOOL_STATE_FREE) {
+            p_entry = &SMTPc_SpoolEntryTbl[i];
+            break;
+        }
+    }
+    if (p_entry == (SMTPc_SPOOL_ENTRY *)0) {
+        KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+       *p_err = SMTPc_ERR_QUEUE_FULL;
+        return (0u);
+    }
+                                                                /* ------------------- BUILD RECORD ------------------- */
+    p_hdr  = (SMTPc_SPOOL_REC_HDR *)p_entry->RecPtr;
+    p_data =  p_entry->RecPtr + sizeof(SMTPc_SPOOL_REC_HDR);
+    len    =  SMTPc_SpoolEnvBuild(p_msg, (CPU_CHAR *)p_data);
+    Mem_Copy(p_data + len, p_msg->RenderBufPtr, p_msg->RenderLen);
+    len   +=  p_msg->RenderLen;
+
+    msg_id        = SMTPc_SpoolIdNext;                          /* See Note #4.                                         */
+    p_hdr->Magic  = SMTPc_SPOOL_REC_MAGIC;
+    p_hdr->Id     = msg_id;
+    p_hdr->Len    = len;
+    p_hdr->Type   = SMTPc_SPOOL_REC_TYPE_MSG;
+    p_hdr->Rsvd   = 0u;
+    p_hdr->Chk    = SMTPc_SpoolRecHash(p_hdr, p_data);
+
+    SMTPc_SpoolMsgLoad(p_entry, p_err);                         /* Msg sent from the rec, as after a reset.             */
+    if (*p_err != SMTPc_ERR_NONE) {
+        KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+        return (0u);
+    }
+                                                                /* ------------------- WRITE RECORD ------------------- */
+    p_entry->SegId = SMTPc_SpoolSegIdCur;
+    SMTPc_SpoolRecWr(p_hdr, p_err);                             /* See Note #3.                                         */
+    if (*p_err != SMTPc_ERR_NONE) {
+        KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+        return (0u);
+    }
+    p_entry->Id    = msg_id;
+    p_entry->State = SMTPc_SPOOL_STATE_WR;
+    SMTPc_SpoolIdNext++;
+
+    KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (msg_id);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_SpoolSyncIdGet()
+*
+* Description : Get the id up to which all the messages spooled are durable.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Highest id such that the messages with this id or a lower one are durable (see
+*               'SMTPc_SpoolSubmit()  Note #3'), if any,
+*
+*               0,                                                                   otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) Ids increase with each message spooled : a message whose id is not higher than the id
+*                   returned survives a reset.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+CPU_INT32U  SMTPc_SpoolSyncIdGet (void)
+{
+    CPU_INT32U  msg_id;
+    KAL_ERR     err_kal;
+
+
+    if (SMTPc_SpoolInitDone != DEF_YES) {
+        return (0u);
+    }
+
+    KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+    msg_id = SMTPc_SpoolIdSynced;
+    KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+
+    return (msg_id);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_SessionInit()
+*
+* Description : Reset a session to its disconnected state & clear its statistics.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect(),
+*               SMTPc_AsyncSubmit().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SessionInit (SMTPc_SESSION  *p_sess)
+{
+    p_sess->SockId = SMTPc_SOCK_ID_NONE;
+    Mem_Clr(&p_sess->Caps,  sizeof(p_sess->Caps));
+    Mem_Clr(&p_sess->Stats, sizeof(p_sess->Stats));
+    SMTPc_RxBufReset(&p_sess->RxBuf);
+    p_sess->BdatPendCtr = 0u;
+#if (SMTPc_CFG_TX_SEG_LEN > 0u)
+    p_sess->TxSegLen    = 0u;
+#endif
+    p_sess->DataOnly    = DEF_NO;
+    p_sess->RenderPtr   = (CPU_CHAR *)0;
+    p_sess->RepCodeNeg  = 0u;
+    p_sess->NoBlock     = DEF_NO;
+    p_sess->ConnLost    = DEF_NO;
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_RxReply()
+*
+* Description : (1) Receive the next reply from the SMTP server.
+*
+*                   (a) Release the previous reply
+*                   (b) Receive data until a complete reply is available
+*                   (c) Decode the reply
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving the reply, or timeout
+*                                                                       (see Note #7).
+*                               SMTPc_ERR_WOULD_BLOCK               Reply not complete yet (see Note #6).
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect(),
+*               SMTPc_TxMsg(),
+*               SMTPc_TxEnvelopePipelined(),
+*               SMTPc_HELO(),
+*               SMTPc_MAIL(),
+*               SMTPc_RCPT(),
+*               SMTPc_DATA(),
+*               SMTPc_RSET(),
+*               SMTPc_QUIT(),
+*               SMTPc_AsyncStep().
+*
+* Note(s)     : (2) The reply is NOT copied : the returned structure describes the reply within the
+*                   receive buffer.  It remains valid until the next call, and its text is NOT NULL
+*                   terminated.
+*
+*               (3) A reply may span several segments and several lines, and several replies may be
+*                   received at once when pipelining.  The data following the reply is kept in the
+*                   receive buffer for the next call.
+*
+*               (4) Data is appended at the end of the receive buffer.  The unconsumed data is moved back
+*                   to the beginning of the buffer only when its end is reached, so that a reply is always
+*                   contiguous.  A reply that does not fit in the buffer is a reception error.
+*
+*               (5) The data gathered for transmission is sent first, since the reply MAY depend on it (see
+*                   'SMTPc_TxGather()  Note #2').
+*
+*               (6) On a non-blocking socket (see 'SMTPc_AsyncConn()'), the reception stops when no more
+*                   data is available.  The partial reply is kept in the receive buffer & scanning resumes
+*                   from where it stopped on the next call.
+*
+*               (7) On a blocking socket, no data within SMTPc_CFG_MAX_REP_TIMEOUT_MS is a timeout.  A
+*                   reception error, a timeout or a 421 reply marks the connection as lost : no reply is
+*                   awaited on it anymore (see 'smtp-c.h  SMTP SESSION DATA TYPES  Note #4').
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_RxReply (SMTPc_SESSION *p_sess,
+                                     SMTPc_ERR     *perr)
+{
+    SMTPc_RX_BUF       *p_rx;
+    CPU_INT32U          rx_len;
+    CPU_INT16U          reply_len;
+    CPU_INT16U          len;
+
+
+    p_rx = &p_sess->RxBuf;
+    if (p_sess->ConnLost == DEF_YES) {                          /* See Note #7.                                         */
+       *perr = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+                                                                /* ------------------ FLUSH TX DATA ------------------- */
+    SMTPc_TxFlush(p_sess, perr);                                /* See Note #5.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+                                                                /* -------------- RELEASE PREVIOUS REPLY -------------- */
+    p_rx->RdIx      += p_rx->Reply.Len;
+    p_rx->Reply.Len  = 0u;
+    if (p_rx->RdIx == p_rx->WrIx) {                             /* Buf empty, rewind.                                   */
+        SMTPc_RxBufReset(p_rx);
+    }
+
+                                                                /* --------------------- RX REPLY --------------------- */
+    reply_len = SMTPc_RxScan(p_rx);                             /* See Note #3.                                         */
+    while (reply_len == 0u) {
+        if (p_rx->WrIx >= SMTPc_RX_BUF_LEN) {                   /* See Note #4.                                         */
+            if (p_rx->RdIx == 0u) {
+                 SMTPc_RxBufReset(p_rx);
+                *perr = SMTPc_ERR_RX_FAILED;
+                 return ((SMTPc_REPLY *)0);
+            }
+            len = p_rx->WrIx - p_rx->RdIx;
+            Mem_Move(&p_rx->Data[0], &p_rx->Data[p_rx->RdIx], len);
+            p_rx->LineIx -= p_rx->RdIx;
+            p_rx->ScanIx -= p_rx->RdIx;
+            p_rx->WrIx    = len;
+            p_rx->RdIx    = 0u;
+        }
+
+        rx_len = SMTPc_TransportAPI_Ptr->Rx(p_sess->SockId,
+                                           &p_rx->Data[p_rx->WrIx],
+                                            SMTPc_RX_BUF_LEN - p_rx->WrIx,
+                                            perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            if ((*perr           != SMTPc_ERR_WOULD_BLOCK) ||   /* See Note #6.                                         */
+                (p_sess->NoBlock == DEF_NO)) {                  /* See Note #7.                                         */
+                p_sess->ConnLost = DEF_YES;
+               *perr             = SMTPc_ERR_RX_FAILED;
+            }
+            return ((SMTPc_REPLY *)0);
+        }
+
+        p_rx->WrIx               += (CPU_INT16U)rx_len;
+        p_sess->Stats.OctetRxCtr += (CPU_INT32U)rx_len;
+        reply_len                 = SMTPc_RxScan(p_rx);
+    }
+
+                                                                /* ------------------- DECODE REPLY ------------------- */
+    SMTPc_ReplyDecode(&p_rx->Reply, &p_rx->Data[p_rx->RdIx], reply_len);
+    p_sess->Stats.ReplyRxCtr++;
+    if (p_rx->Reply.Code >= (SMTPc_REP_NEG_TRANS_COMPLET_GRP * 100u)) {
+        p_sess->RepCodeNeg = p_rx->Reply.Code;                  /* See 'smtp-c.h  SMTPc_SESSION  Note #3'.              */
+    }
+    if (p_rx->Reply.Code == SMTPc_REP_421) {                    /* See Note #7.                                         */
+        p_sess->ConnLost = DEF_YES;
+    }
+
+   *perr = SMTPc_ERR_NONE;
+
+    return (&p_rx->Reply);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_RxBufReset()
+*
+* Description : Discard all the data held by a receive buffer.
+*
+* Argument(s) : p_rx            Pointer to the receive buffer.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionInit(),
+*               SMTPc_RxReply().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_RxBufReset (SMTPc_RX_BUF  *p_rx)
+{
+    p_rx->RdIx      = 0u;
+    p_rx->WrIx      = 0u;
+    p_rx->LineIx    = 0u;
+    p_rx->ScanIx    = 0u;
+    p_rx->Reply.Len = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_RxScan()
+*
+* Description : Search the received data for the end of the first reply.
+*
+* Argument(s) : p_rx            Pointer to the receive buffer.
+*
+* Return(s)   : Length of the first reply, including the last CRLF, if the reply is complete.
+*
+*               0,                                                 otherwise.
+*
+* Caller(s)   : SMTPc_RxReply().
+*
+* Note(s)     : (1) From RFC #5321, Section 4.2.1, "the format for multiline replies requires that every
+*                   line, except the last, begin with the reply code, followed immediately by a hyphen,
+*                   "-" (also known as minus), followed by text.  The last line will begin with the reply
+*                   code, followed immediately by <SP>, optionally some text, and <CRLF>".
+*
+*               (2) Server reply is at least 3 characters long (3 digits), plus CRLF.
+*
+*               (3) The scan resumes where the previous call stopped, so that each received octet is
+*                   examined only once regardless of the number of segments the reply is split into.
+*********************************************************************************************************
+*/
+
+static  CPU_INT16U  SMTPc_RxScan (SMTPc_RX_BUF  *p_rx)
+{
+    CPU_CHAR    *p_data;
+    CPU_INT16U   scan_ix;
+    CPU_INT16U   line_ix;
+    CPU_INT16U   wr_ix;
+
+
+    p_data  = p_rx->Data;
+    scan_ix = p_rx->ScanIx;                                     /* See Note #3.                                         */
+    line_ix = p_rx->LineIx;
+    wr_ix   = p_rx->WrIx;
+
+    while (scan_ix < wr_ix) {
+        if (p_data[scan_ix] != '\n') {
+            scan_ix++;
+            continue;
+        }
+        scan_ix++;                                              /* End of a line.                                       */
+        if (((CPU_INT16U)(scan_ix - line_ix) >= (3u + SMTPc_CRLF_SIZE)) &&
+            ( p_data[line_ix + 3u] != '-')) {                   /* See Notes #1 & #2.                                   */
+            p_rx->ScanIx = scan_ix;
+            p_rx->LineIx = scan_ix;
+            return (scan_ix - p_rx->RdIx);
+        }
+        line_ix = scan_ix;
+    }
+
+    p_rx->ScanIx = scan_ix;
+    p_rx->LineIx = line_ix;
+
+    return (0u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_ReplyDecode()
+*
+* Description : (1) Decode a complete reply.
+*
+*                   (a) Convert the reply code
+*                   (b) Convert the enhanced status code, if any
+*                   (c) Locate the text of the first line
+*
+*
+* Argument(s) : p_reply         Pointer to the reply structure to fill.
+*               p_buf           Pointer to the beginning of the reply.
+*               len             Length of the reply, including the last CRLF.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_RxReply().
+*
+* Note(s)     : (2) The reply code is always made of three digits (see RFC #5321, Section 4.2).  It is
+*                   converted directly rather than through a generic string conversion.  A code that is
+*                   not made of three digits is returned as 0.
+*
+*               (3) From RFC #3463, Section 2, the enhanced status code has the form "class.subject.detail"
+*                   where class is a single digit and subject & detail are up to three digits each.  From
+*                   RFC #2034, Section 4, it is placed at the beginning of the text, followed by a space.
+*                   It is only considered valid if its class matches the first digit of the reply code.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ReplyDecode (SMTPc_REPLY  *p_reply,
+                                 CPU_CHAR     *p_buf,
+                                 CPU_INT16U    len)
+{
+    CPU_CHAR    *p_txt;
+    CPU_CHAR    *p_end;
+    CPU_INT16U   nbr[3];
+    CPU_INT08U   nbr_ix;
+    CPU_INT08U   dig_cnt;
+
+
+    p_reply->BufPtr        = p_buf;
+    p_reply->Len           = len;
+    p_reply->Code          = 0u;
+    p_reply->StatusClass   = 0u;
+    p_reply->StatusSubject = 0u;
+    p_reply->StatusDetail  = 0u;
+
+                                                                /* ---------------- CONVERT REPLY CODE ---------------- */
+    if ((ASCII_IS_DIG(p_buf[0]) == DEF_YES) &&                  /* See Note #2.                                         */
+        (ASCII_IS_DIG(p_buf[1]) == DEF_YES) &&
+        (ASCII_IS_DIG(p_buf[2]) == DEF_YES)) {
+        p_reply->Code = ((CPU_INT16U)(p_buf[0] - '0') * 100u)
+                      + ((CPU_INT16U)(p_buf[1] - '0') *  10u)
+                      +  (CPU_INT16U)(p_buf[2] - '0');
+    }
+
+    p_end = p_buf + 3u;                                         /* Find end of first line.                              */
+    while ((*p_end != '\r') &&
+           (*p_end != '\n')) {
+        p_end++;
+    }
+    p_txt = p_buf + 3u;
+    if (p_txt < p_end) {                                        /* Skip separator.                                      */
+        p_txt++;
+    }
+
+                                                                /* ---------------- CONVERT ENH STATUS ---------------- */
+    nbr[0]  = 0u;                                               /* See Note #3.                                         */
+    nbr[1]  = 0u;
+    nbr[2]  = 0u;
+    nbr_ix  = 0u;
+    dig_cnt = 0u;
+    while ((p_txt < p_end) && (nbr_ix < 3u)) {
+        if ((ASCII_IS_DIG(*p_txt) == DEF_YES) &&
+            (dig_cnt              <  3u)) {
+            nbr[nbr_ix] = (nbr[nbr_ix] * 10u) + (CPU_INT16U)(*p_txt - '0');
+            dig_cnt++;
+        } else if ((*p_txt  == '.') &&
+                   (dig_cnt != 0u ) &&
+                   (nbr_ix  <  2u )) {
+            nbr_ix++;
+            dig_cnt = 0u;
+        } else if ((*p_txt  == ' ') &&
+                   (dig_cnt != 0u ) &&
+                   (nbr_ix  == 2u )) {
+            nbr_ix++;                                           /* Complete status code.                                */
+        } else {
+            break;
+        }
+        p_txt++;
+    }
+
+    if ((nbr_ix == 3u) &&
+        (nbr[0] == (p_reply->Code / 100u))) {
+        p_reply->StatusClass   = (CPU_INT08U)nbr[0];
+        p_reply->StatusSubject = nbr[1];
+        p_reply->StatusDetail  = nbr[2];
+    } else {                                                    /* No valid status code, text starts after separator.   */
+        p_txt = p_buf + 3u;
+        if (p_txt < p_end) {
+            p_txt++;
+        }
+    }
+
+                                                                /* -------------------- LOCATE TEXT ------------------- */
+    p_reply->TextPtr = p_txt;
+    p_reply->TextLen = (CPU_INT16U)(p_end - p_txt);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_ParseReply()
+*
+* Description : Interpret the reply code received from the SMTP server.
+*
+* Argument(s) : p_reply         Pointer to the reply received from the server.
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_REP_TOO_SHORT             Reply too short or malformed.
+*                               SMTPc_ERR_REP_POS                   No error, positive reply received.
+*                               SMTPc_ERR_REP_INTER                 No error, intermediate reply received.
+*                               SMTPc_ERR_REP_NEG                   Negative reply received.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect(),
+*               SMTPc_TxMsg(),
+*               SMTPc_TxEnvelopePipelined(),
+*               SMTPc_HELO(),
+*               SMTPc_MAIL(),
+*               SMTPc_RCPT(),
+*               SMTPc_DATA(),
+*               SMTPc_RSET(),
+*               SMTPc_QUIT(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (1) The reply code was already converted by SMTPc_RxReply().
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ParseReply (SMTPc_REPLY  *p_reply,
+                                CPU_INT32U   *completion_code,
+                                SMTPc_ERR    *perr)
+{
+    CPU_INT08U  code_first_dig;
+
+
+    if (p_reply->Code == 0u) {                                  /* See Note #1.                                         */
+        *perr = SMTPc_ERR_REP_TOO_SHORT;
+         return;
+    }
+
+   *completion_code = p_reply->Code;
+    SMTPc_TRACE_DBG(("Code: %u\n\r", (unsigned int)*completion_code));
+
+                                                                /* ------------------ INTERPRET REPLY ----------------- */
+    code_first_dig = (CPU_INT08U)(p_reply->Code / 100u);
+    switch (code_first_dig) {
+        case SMTPc_REP_POS_COMPLET_GRP:                         /* Positive reply.                                      */
+            *perr = SMTPc_ERR_REP_POS;
+             break;
+
+        case SMTPc_REP_POS_PRELIM_GRP:                          /* Intermediate reply.                                  */
+        case SMTPc_REP_POS_INTER_GRP:
+            *perr = SMTPc_ERR_REP_INTER;
+             break;
+
+        case SMTPc_REP_NEG_TRANS_COMPLET_GRP:                   /* Negative reply.                                      */
+        case SMTPc_REP_NEG_COMPLET_GRP:
+            *perr = SMTPc_ERR_REP_NEG;
+             break;
+
+        default:                                                /* Should never happen, interpreted as negative.        */
+            *perr = SMTPc_ERR_REP_NEG;
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_ParseCaps()
+*
+* Description : (1) Extract the service extensions supported by the server from its reply to EHLO.
+*
+*                   (a) Skip the first line (server's domain & greeting)
+*                   (b) Match each following line's keyword against the known extensions
+*                   (c) Parse the parameters of the SIZE & AUTH extensions
+*
+*
+* Argument(s) : p_reply         Pointer to the complete (multi-line) reply received from the server.
+*               p_caps          Pointer to variable that will receive the capabilities.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (2) From RFC #1869, Section 4.3, each line of the reply after the first one holds an
+*                   "ehlo-keyword" optionally followed by space-separated "ehlo-param".  Keywords are case
+*                   insensitive.
+*
+*               (3) Some servers still advertise the mechanisms with the obsolete "AUTH=" syntax; the '='
+*                   is accepted as a parameter separator.
+*
+*               (4) Unknown keywords are ignored.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_ParseCaps (SMTPc_REPLY  *p_reply,
+                               SMTPc_CAPS   *p_caps)
+{
+    CPU_CHAR    *p_line;
+    CPU_CHAR    *p_line_end;
+    CPU_CHAR    *p_end;
+    CPU_CHAR    *p_tok;
+    CPU_SIZE_T   tok_len;
+    CPU_INT16U   flag;
+    CPU_BOOLEAN  first_line;
+
+
+    Mem_Clr(p_caps, sizeof(SMTPc_CAPS));
+    p_caps->IsESMTP = DEF_YES;
+
+    p_line     = p_reply->BufPtr;
+    p_end      = p_reply->BufPtr + p_reply->Len;
+    first_line = DEF_YES;
+    while (p_line < p_end) {
+        p_line_end = p_line;
+        while ((p_line_end  <  p_end) &&
+               (*p_line_end != '\r')  &&
+               (*p_line_end != '\n')) {
+            p_line_end++;
+        }
+
+        if ((first_line         == DEF_NO) &&                   /* See Note #1a.                                        */
+            ((p_line_end - p_line) > 4)) {
+            p_tok = p_line + 4;                                 /* Skip reply code & separator.                         */
+            while ((p_tok < p_line_end) &&
+                   (*p_tok != ' ')      &&
+                   (*p_tok != '=')) {
+                p_tok++;
+            }
+            tok_len = (CPU_SIZE_T)(p_tok - (p_line + 4));
+            flag    = SMTPc_ParseKeyword(p_line + 4,
+                                         tok_len,
+                                         SMTPc_CapKeywordTbl,
+                                         sizeof(SMTPc_CapKeywordTbl) / sizeof(SMTPc_KEYWORD));
+            DEF_BIT_SET(p_caps->Flags, flag);
+                                                                /* See Note #1c.                                        */
+            if ((flag  == SMTPc_CAP_SIZE) &&
+                (p_tok <  p_line_end)) {
+                p_caps->SizeMax = Str_ParseNbr_Int32U(p_tok + 1, DEF_NULL, 10);
+
+            } else if (flag == SMTPc_CAP_AUTH) {                /* See Note #3.                                         */
+                while (p_tok < p_line_end) {
+                    p_tok++;                                    /* Skip separator.                                      */
+                    tok_len = 0u;
+                    while (((p_tok + tok_len) < p_line_end) &&
+                           (p_tok[tok_len]    != ' ')) {
+                        tok_len++;
+                    }
+                    p_caps->AuthMechs |= (SMTPc_AUTH_MECH_FLAGS)SMTPc_ParseKeyword(p_tok,
+                                                                                   tok_len,
+                                                                                   SMTPc_AuthMechKeywordTbl,
+                                                                                   sizeof(SMTPc_AuthMechKeywordTbl) / sizeof(SMTPc_KEYWORD));
+                    p_tok += tok_len;
+                }
+            }
+        }
+
+        first_line = DEF_NO;
+        p_line     = p_line_end;
+        while ((p_line <  p_end) &&
+               ((*p_line == '\r') || (*p_line == '\n'))) {
+            p_line++;
+        }
+    }
+
+    SMTPc_TRACE_DBG(("Caps: 0x%04X, Size: %u, Auth: 0x%02X\n\r",
+                     (unsigned int)p_caps->Flags,
+                     (unsigned int)p_caps->SizeMax,
+                     (unsigned int)p_caps->AuthMechs));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_ParseKeyword()
+*
+* Description : Look up a token in a keyword table.
+*
+* Argument(s) : p_tok           Pointer to the token (not NULL terminated).
+*               tok_len         Length of the token.
+*               p_tbl           Table of keywords.
+*               tbl_size        Number of entries in the table.
+*
+* Return(s)   : Flag associated with the keyword, if found.
+*
+*               DEF_BIT_NONE,                     otherwise.
+*
+* Caller(s)   : SMTPc_ParseCaps().
+*
+* Note(s)     : (1) Comparison is case insensitive.
+*********************************************************************************************************
+*/
+
+static  CPU_INT16U  SMTPc_ParseKeyword (CPU_CHAR             *p_tok,
+                                        CPU_SIZE_T            tok_len,
+                                        const SMTPc_KEYWORD  *p_tbl,
+                                        CPU_SIZE_T            tbl_size)
+{
+    CPU_SIZE_T  i;
+    CPU_INT16S  cmp;
+
+
+    for (i = 0u; i < tbl_size; i++) {
+        if (Str_Len(p_tbl[i].Str) == tok_len) {
+            cmp = Str_CmpIgnoreCase_N(p_tok, p_tbl[i].Str, tok_len);
+            if (cmp == 0) {
+                return (p_tbl[i].Flag);
+            }
+        }
+    }
+
+    return (DEF_BIT_NONE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_CapCacheGet()
+*
+* Description : Retrieve the capabilities of a server from the cache.
+*
+* Argument(s) : p_host_name     Host name of the server, as passed to SMTPc_SessionConnect().
+*               port            TCP port of the server.
+*               p_caps          Pointer to variable that will receive the capabilities, if found.
+*
+* Return(s)   : DEF_YES, if the server was found in the cache.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+static  CPU_BOOLEAN  SMTPc_CapCacheGet (CPU_CHAR    *p_host_name,
+                                        CPU_INT16U   port,
+                                        SMTPc_CAPS  *p_caps)
+{
+    SMTPc_CAP_CACHE_ENTRY  *p_entry;
+    CPU_INT16S              cmp;
+    CPU_INT08U              i;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See 'SMTPc_CapCacheSet()  Note #3'.                  */
+    for (i = 0u; i < SMTPc_CFG_CAP_CACHE_NBR_ENTRIES; i++) {
+        p_entry = &SMTPc_CapCacheTbl[i];
+        if ((p_entry->HostName[0] != '\0') &&
+            (p_entry->Port        == port)) {
+            cmp = Str_CmpIgnoreCase_N(p_entry->HostName, p_host_name, SMTPc_CAP_CACHE_HOST_NAME_LEN);
+            if (cmp == 0) {
+                SMTPc_CapCacheUseCtr++;
+                p_entry->UseCtr = SMTPc_CapCacheUseCtr;
+               *p_caps          = p_entry->Caps;
+                CPU_CRITICAL_EXIT();
+                return (DEF_YES);
+            }
+        }
+    }
+    CPU_CRITICAL_EXIT();
+
+    return (DEF_NO);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_CapCacheSet()
+*
+* Description : Add or update the capabilities of a server in the cache.
+*
+* Argument(s) : p_host_name     Host name of the server, as passed to SMTPc_SessionConnect().
+*               port            TCP port of the server.
+*               p_caps          Pointer to the capabilities to store.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect().
+*
+* Note(s)     : (1) When the cache is full, the least recently used entry is replaced.
+*
+*               (2) Host names too long for SMTPc_CAP_CACHE_HOST_NAME_LEN are not cached.
+*
+*               (3) The cache is shared by all the sessions.  Since its accesses are short & bounded by
+*                   SMTPc_CFG_CAP_CACHE_NBR_ENTRIES, they are protected by a critical section.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > 0u)
+static  void  SMTPc_CapCacheSet (CPU_CHAR    *p_host_name,
+                                 CPU_INT16U   port,
+                                 SMTPc_CAPS  *p_caps)
+{
+    SMTPc_CAP_CACHE_ENTRY  *p_entry;
+    SMTPc_CAP_CACHE_ENTRY  *p_entry_lru;
+    CPU_SIZE_T              len;
+    CPU_INT16S              cmp;
+    CPU_INT08U              i;
+    CPU_SR_ALLOC();
+
+
+    len = Str_Len_N(p_host_name, SMTPc_CAP_CACHE_HOST_NAME_LEN);
+    if (len >= SMTPc_CAP_CACHE_HOST_NAME_LEN) {                 /* See Note #2.                                         */
+        return;
+    }
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #3.                                         */
+    p_entry_lru = &SMTPc_CapCacheTbl[0];
+    for (i = 0u; i < SMTPc_CFG_CAP_CACHE_NBR_ENTRIES; i++) {
+        p_entry = &SMTPc_CapCacheTbl[i];
+        if (p_entry->HostName[0] == '\0') {                     /* Free entry.                                          */
+            p_entry_lru = p_entry;
+            break;
+        }
+        if (p_entry->Port == port) {                            /* Same srv, update entry.                              */
+            cmp = Str_CmpIgnoreCase_N(p_entry->HostName, p_host_name, SMTPc_CAP_CACHE_HOST_NAME_LEN);
+            if (cmp == 0) {
+                p_entry_lru = p_entry;
+                break;
+            }
+        }
+        if (p_entry->UseCtr < p_entry_lru->UseCtr) {            /* See Note #1.                                         */
+            p_entry_lru = p_entry;
+        }
+    }
+
+    SMTPc_CapCacheUseCtr++;
+    Str_Copy(p_entry_lru->HostName, p_host_name);
+    p_entry_lru->Port   = port;
+    p_entry_lru->Caps   = *p_caps;
+    p_entry_lru->UseCtr = SMTPc_CapCacheUseCtr;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_PoolGet()
+*
+* Description : (1) Lease a session from the connection pool.
+*
+*                   (a) Search for an idle session connected with the same parameters
+*                   (b) Otherwise, select a free session
+*                   (c) Otherwise, select the least recently used idle session
+*
+*
+* Argument(s) : p_tbl           Pointer to the table of pooled sessions.
+*               tbl_size        Number of entries of the table.
+*               p_host_name     Host name of the server.
+*               port            TCP port of the server, as passed to SMTPc_SendMail().
+*               p_secure_cfg    Pointer to the secure configuration.
+*               cred_hash       Hash of the credentials (see 'SMTPc_PoolCredHash()').
+*               p_warm          Pointer to variable that will receive :
+*
+*                                   DEF_YES, if the session is connected with the requested parameters
+*                                            & can be used as is.
+*                                   DEF_NO,  if the session MUST be (re)connected.
+*
+* Return(s)   : Pointer to the leased pool entry, if any session available.
+*
+*               (SMTPc_POOL_ENTRY *)0,                otherwise.
+*
+* Caller(s)   : SMTPc_PoolSendMail().
+*
+* Note(s)     : (2) A matching session idle for more than SMTPc_CFG_POOL_IDLE_TIMEOUT_MS is returned as not
+*                   warm : the server may already have closed the connection.
+*
+*               (3) The pool of SMTPc_SendMail() is shared by all the tasks.  Its accesses are short & bounded
+*                   by the size of the table, they are hence protected by a critical section.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  SMTPc_POOL_ENTRY  *SMTPc_PoolGet (SMTPc_POOL_ENTRY         *p_tbl,
+                                          CPU_INT08U                tbl_size,
+                                          CPU_CHAR                 *p_host_name,
+                                          CPU_INT16U                port,
+                                          SMTPc_SECURE_CFG         *p_secure_cfg,
+                                          CPU_INT32U                cred_hash,
+                                          CPU_BOOLEAN              *p_warm)
+{
+    SMTPc_POOL_ENTRY  *p_entry;
+    SMTPc_POOL_ENTRY  *p_entry_free;
+    SMTPc_POOL_ENTRY  *p_entry_lru;
+    SMTPc_TS_MS        ts_cur;
+    CPU_INT16S         cmp;
+    CPU_INT08U         i;
+    CPU_SR_ALLOC();
+
+
+   *p_warm       =  DEF_NO;
+    p_entry_free = (SMTPc_POOL_ENTRY *)0;
+    p_entry_lru  = (SMTPc_POOL_ENTRY *)0;
+    ts_cur       =  SMTPc_TS_Get_ms();
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #3.                                         */
+    for (i = 0u; i < tbl_size; i++) {
+        p_entry = &p_tbl[i];
+        if (p_entry->InUse == DEF_YES) {
+            continue;
+        }
+
+        if (p_entry->IsConn == DEF_NO) {                        /* See Note #1b.                                        */
+            if (p_entry_free == (SMTPc_POOL_ENTRY *)0) {
+                p_entry_free = p_entry;
+            }
+            continue;
+        }
+                                                                /* See Note #1a.                                        */
+        if ((p_entry->Port         == port)         &&
+            (p_entry->SecureCfgPtr == p_secure_cfg) &&
+            (p_entry->CredHash     == cred_hash)) {
+            cmp = Str_CmpIgnoreCase_N(p_entry->HostName, p_host_name, SMTPc_POOL_HOST_NAME_LEN);
+            if (cmp == 0) {
+                p_entry->InUse = DEF_YES;
+                CPU_CRITICAL_EXIT();
+                                                                /* See Note #2.                                         */
+                if ((SMTPc_TS_MS)(ts_cur - p_entry->IdleTS) < SMTPc_CFG_POOL_IDLE_TIMEOUT_MS) {
+                   *p_warm = DEF_YES;
+                }
+                return (p_entry);
+            }
+        }
+                                                                /* See Note #1c.                                        */
+        if ((p_entry_lru                == (SMTPc_POOL_ENTRY *)0) ||
+            ((ts_cur - p_entry->IdleTS) >  (ts_cur - p_entry_lru->IdleTS))) {
+            p_entry_lru = p_entry;
+        }
+    }
+
+    p_entry = p_entry_free;
+    if (p_entry == (SMTPc_POOL_ENTRY *)0) {
+        p_entry = p_entry_lru;
+    }
+    if (p_entry != (SMTPc_POOL_ENTRY *)0) {
+        p_entry->InUse = DEF_YES;
+    }
+    CPU_CRITICAL_EXIT();
+
+    return (p_entry);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_PoolRelease()
+*
+* Description : Return a leased session to the connection pool.
+*
+* Argument(s) : p_entry         Pointer to the leased pool entry.
+*               keep            DEF_YES, if the session can be reused.
+*                               DEF_NO,  if the session MUST be closed.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_PoolSendMail(),
+*               SMTPc_PoolCloseIdle().
+*
+* Note(s)     : (1) A session having sent SMTPc_CFG_POOL_MAX_MSG_PER_CONN messages is closed, so that the load
+*                   can be redistributed among the servers behind the host name, and a server limiting the
+*                   number of transactions per connection is not hit.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  void  SMTPc_PoolRelease (SMTPc_POOL_ENTRY  *p_entry,
+                                 CPU_BOOLEAN        keep)
+{
+    SMTPc_SESSION  *p_sess;
+    SMTPc_ERR       err;
+    CPU_SR_ALLOC();
+
+
+    p_sess = &p_entry->Sess;
+#if (SMTPc_CFG_POOL_MAX_MSG_PER_CONN > 0u)
+    if ((p_sess->Stats.MsgTxCtr + p_sess->Stats.MsgFailCtr) >= SMTPc_CFG_POOL_MAX_MSG_PER_CONN) {
+        keep = DEF_NO;                                          /* See Note #1.                                         */
+    }
+#endif
+    if (p_entry->HostName[0] == '\0') {                         /* Host name too long to be pooled.                     */
+        keep = DEF_NO;
+    }
+
+    if ((keep            == DEF_NO ) &&
+        (p_entry->IsConn == DEF_YES)) {
+        SMTPc_SessionDisconnect(p_sess, &err);
+        p_entry->IsConn = DEF_NO;
+    }
+
+    CPU_CRITICAL_ENTER();
+    p_entry->IdleTS = SMTPc_TS_Get_ms();
+    p_entry->InUse  = DEF_NO;
+    CPU_CRITICAL_EXIT();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_PoolKeySet()
+*
+* Description : Record the parameters a pooled session was connected with, and mark it as connected.
+*
+* Argument(s) : p_entry         Pointer to the leased pool entry.
+*               p_host_name     Host name of the server.
+*               port            TCP port of the server, as passed to SMTPc_SendMail().
+*               p_secure_cfg    Pointer to the secure configuration.
+*               cred_hash       Hash of the credentials.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_PoolSendMail().
+*
+* Note(s)     : (1) Sessions to host names too long for SMTPc_POOL_HOST_NAME_LEN are not kept open after
+*                   the transaction (see 'SMTPc_PoolRelease()').
+*
+*               (2) The secure configuration is identified by its address.  It MUST hence NOT be modified
+*                   while idle sessions connected with it are pooled.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  void  SMTPc_PoolKeySet (SMTPc_POOL_ENTRY         *p_entry,
+                                CPU_CHAR                 *p_host_name,
+                                CPU_INT16U                port,
+                                SMTPc_SECURE_CFG         *p_secure_cfg,
+                                CPU_INT32U                cred_hash)
+{
+    CPU_SIZE_T  len;
+
+
+    len = Str_Len_N(p_host_name, SMTPc_POOL_HOST_NAME_LEN);
+    if (len < SMTPc_POOL_HOST_NAME_LEN) {
+        Str_Copy(p_entry->HostName, p_host_name);
+    } else {
+        p_entry->HostName[0] = '\0';                            /* See Note #1.                                         */
+    }
+    p_entry->Port         = port;
+    p_entry->SecureCfgPtr = p_secure_cfg;                       /* See Note #2.                                         */
+    p_entry->CredHash     = cred_hash;
+    p_entry->IsConn       = DEF_YES;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_PoolCredHash()
+*
+* Description : Compute the hash identifying a set of credentials.
+*
+* Argument(s) : p_username      Pointer to user name, if any.
+*               p_pwd           Pointer to password,  if any.
+*
+* Return(s)   : 32-bit FNV-1a hash of the user name & password.
+*
+* Caller(s)   : SMTPc_PoolSendMail().
+*
+* Note(s)     : (1) The pool only keeps a hash of the credentials, so that no copy of the password is kept
+*                   in memory.  Sessions opened with different credentials whose hashes collide could be
+*                   confused, which is considered acceptable given the probability (2^-32).
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  CPU_INT32U  SMTPc_PoolCredHash (CPU_CHAR  *p_username,
+                                        CPU_CHAR  *p_pwd)
+{
+    CPU_CHAR    *p_str;
+    CPU_INT32U   hash;
+    CPU_INT08U   i;
+
+
+    hash  = SMTPc_POOL_FNV_OFFSET_BASIS;
+    p_str = p_username;
+    for (i = 0u; i < 2u; i++) {
+        if (p_str != (CPU_CHAR *)0) {
+            while (*p_str != '\0') {
+                hash ^= (CPU_INT32U)(CPU_INT08U)*p_str;
+                hash *=  SMTPc_POOL_FNV_PRIME;
+                p_str++;
+            }
+        }
+        hash ^= (CPU_INT32U)':';                                /* Separate user name from pwd.                         */
+        hash *=  SMTPc_POOL_FNV_PRIME;
+        p_str = p_pwd;
+    }
+
+    return (hash);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_PoolSendMail()
+*
+* Description : Send an email over a session leased from a connection pool.
+*
+* Argument(s) : p_tbl           Pointer to the table of pooled sessions.
+*               tbl_size        Number of entries of the table.
+*               p_host_name     Pointer to host name of the SMTP server to contact.
+*               port            TCP port to use, or '0' if SMTPc_DFLT_PORT.
+*               p_username      Pointer to user name, if authentication enabled.
+*               p_pwd           Pointer to password,  if authentication enabled.
+*               p_secure_cfg    Pointer to the secure configuration, if any.
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               p_rep_code      Pointer to variable that will receive the last negative reply code, 0 if none
+*                               (see 'smtp-c.h  SMTPc_SESSION  Note #3'), or DEF_NULL.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_POOL_EMPTY                All the sessions of the table in use.
+*
+*                                                                   - RETURNED BY SMTPc_SessionConnect() & -
+*                                                                   ------ SMTPc_SessionSendMsg() : ------
+*                                                                   See 'SMTPc_SendMail()'.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SendMail(),
+*               SMTPc_QueueWorkerTask().
+*
+* Note(s)     : (1) See 'SMTPc_SendMail()  Notes #1 to #3'.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  void  SMTPc_PoolSendMail (SMTPc_POOL_ENTRY         *p_tbl,
+                                  CPU_INT08U                tbl_size,
+                                  CPU_CHAR                 *p_host_name,
+                                  CPU_INT16U                port,
+                                  CPU_CHAR                 *p_username,
+                                  CPU_CHAR                 *p_pwd,
+                                  SMTPc_SECURE_CFG         *p_secure_cfg,
+                                  SMTPc_MSG                *p_msg,
+                                  CPU_INT16U               *p_rep_code,
+                                  SMTPc_ERR                *p_err)
+{
+    SMTPc_POOL_ENTRY  *p_entry;
+    SMTPc_SESSION     *p_sess;
+    CPU_INT32U         cred_hash;
+    CPU_INT32U         reply_ctr;
+    CPU_BOOLEAN        warm;
+    SMTPc_ERR          err;
+
+                                                                /* ----------------- LEASE A SESSION ------------------ */
+    cred_hash = SMTPc_PoolCredHash(p_username, p_pwd);
+    p_entry   = SMTPc_PoolGet(p_tbl, tbl_size, p_host_name, port, p_secure_cfg, cred_hash, &warm);
+    if (p_entry == (SMTPc_POOL_ENTRY *)0) {
+        if (p_rep_code != DEF_NULL) {
+           *p_rep_code = 0u;
+        }
+       *p_err = SMTPc_ERR_POOL_EMPTY;
+        return;
+    }
+    p_sess = &p_entry->Sess;
+
+    if (warm == DEF_YES) {                                      /* ------------- SEND OVER WARM SESSION -------------- */
+        reply_ctr = p_sess->Stats.ReplyRxCtr;
+        SMTPc_SessionSendMsg(p_sess, p_msg, p_err);
+        if (((*p_err == SMTPc_ERR_TX_FAILED)  ||                /* See 'SMTPc_SendMail()  Note #2'.                     */
+             (*p_err == SMTPc_ERR_RX_FAILED)) &&
+            (p_sess->Stats.ReplyRxCtr == reply_ctr)) {
+            warm = DEF_NO;
+        }
+    }
+
+    if (warm == DEF_NO) {                                       /* --------------- CONNECT TO SMTP SRV --------------- */
+        if (p_entry->IsConn == DEF_YES) {                       /* Close stale or evicted conn.                         */
+            SMTPc_SessionDisconnect(p_sess, &err);
+            p_entry->IsConn = DEF_NO;
+        }
+        SMTPc_SessionConnect(p_sess,
+                             p_host_name,
+                             port,
+                             p_username,
+                             p_pwd,
+                             p_secure_cfg,
+                             p_err);
+        if (*p_err != SMTPc_ERR_NONE) {
+            if (p_rep_code != DEF_NULL) {
+               *p_rep_code = p_sess->RepCodeNeg;
+            }
+            SMTPc_PoolRelease(p_entry, DEF_NO);
+            return;
+        }
+        SMTPc_PoolKeySet(p_entry, p_host_name, port, p_secure_cfg, cred_hash);
+                                                                /* ----------------- SEND THE MESSAGE ----------------- */
+        SMTPc_SessionSendMsg(p_sess, p_msg, p_err);
+    }
+                                                                /* ----------- RETURN THE SESSION TO POOL ------------- */
+    if (p_rep_code != DEF_NULL) {
+       *p_rep_code = p_sess->RepCodeNeg;
+    }
+    SMTPc_PoolRelease(p_entry, (*p_err == SMTPc_ERR_NONE) ? DEF_YES : DEF_NO);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_PoolCloseIdle()
+*
+* Description : Close all the idle sessions of a connection pool.
+*
+* Argument(s) : p_tbl           Pointer to the table of pooled sessions.
+*               tbl_size        Number of entries of the table.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_PoolFlush(),
+*               SMTPc_QueueWorkerTask().
+*
+* Note(s)     : (1) Sessions currently leased are not affected.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_POOL_NBR_SESSIONS > 0u)
+static  void  SMTPc_PoolCloseIdle (SMTPc_POOL_ENTRY  *p_tbl,
+                                   CPU_INT08U         tbl_size)
+{
+    SMTPc_POOL_ENTRY  *p_entry;
+    CPU_BOOLEAN        close;
+    CPU_INT08U         i;
+    CPU_SR_ALLOC();
+
+
+    for (i = 0u; i < tbl_size; i++) {
+        p_entry = &p_tbl[i];
+        close   = DEF_NO;
+        CPU_CRITICAL_ENTER();
+        if ((p_entry->InUse  == DEF_NO ) &&
+            (p_entry->IsConn == DEF_YES)) {
+            p_entry->InUse = DEF_YES;                           /* Reserve session while closing it.                    */
+            close          = DEF_YES;
+        }
+        CPU_CRITICAL_EXIT();
+
+        if (close == DEF_YES) {
+            SMTPc_PoolRelease(p_entry, DEF_NO);
+        }
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_QueryServer()
+*
+* Description : Send a query (or anything else) to the server.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               query           Query in question.
+*               len             Length of message to transmit
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the query.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_BuildCmd(),
+*               SMTPc_TxEnvelopePipelined(),
+*               SMTPc_HELO(),
+*               SMTPc_MAIL(),
+*               SMTPc_RCPT(),
+*               SMTPc_DATA(),
+*               SMTPc_RSET(),
+*               SMTPc_QUIT().
+*
+* Note(s)     : (1) The data gathered by SMTPc_TxGather(), if any, is sent first.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_QueryServer (SMTPc_SESSION *p_sess,
+                                 CPU_CHAR      *query,
+                                 CPU_INT32U     len,
+                                 SMTPc_ERR     *perr)
+{
+    SMTPc_TxFlush(p_sess, perr);                                /* See Note #1.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+
+    SMTPc_TxSock(p_sess, query, len, perr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_TxSock()
+*
+* Description : Send data on the socket of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_data          Pointer to the data.
+*               len             Length of the data.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_QueryServer(),
+*               SMTPc_TxGather(),
+*               SMTPc_TxFlush().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxSock (SMTPc_SESSION  *p_sess,
+                            CPU_CHAR       *p_data,
+                            CPU_INT32U      len,
+                            SMTPc_ERR      *perr)
+{
+    SMTPc_TRANSPORT_VEC  vec;
+
+
+    vec.DataPtr = p_data;
+    vec.Len     = len;
+    SMTPc_TxSockV(p_sess, &vec, 1u, perr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxSockV()
+*
+* Description : Send several buffers on the socket of the session, in order.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_vec           Pointer to the buffers.
+*               vec_nbr         Number of buffers.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxSock(),
+*               SMTPc_TxGather().
+*
+* Note(s)     : (1) The buffers are passed to the transport in a single call (see 'smtp-c.h
+*                   SMTPc_TRANSPORT_API  Note #1c'), until they are all transmitted.  The buffers already
+*                   transmitted are then skipped, so the table of buffers is modified.
+*
+*               (2) Nothing is transmitted on a connection lost; a transmission error or timeout marks the
+*                   connection as lost (see 'smtp-c.h  SMTP SESSION DATA TYPES  Note #4').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxSockV (SMTPc_SESSION        *p_sess,
+                             SMTPc_TRANSPORT_VEC  *p_vec,
+                             CPU_INT08U            vec_nbr,
+                             SMTPc_ERR            *perr)
+{
+    CPU_INT32U  tx_len;
+
+
+    if (p_sess->ConnLost == DEF_YES) {                          /* See Note #2.                                         */
+       *perr = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+                                                                /* ---------------------- TX DATA --------------------- */
+   *perr = SMTPc_ERR_NONE;
+    while (vec_nbr > 0u) {
+        if (p_vec->Len == 0u) {                                 /* Skip bufs tx'd.                                      */
+            p_vec++;
+            vec_nbr--;
+            continue;
+        }
+                                                                /* See Note #1.                                         */
+        tx_len = SMTPc_TransportAPI_Ptr->TxV(p_sess->SockId, p_vec, vec_nbr, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            p_sess->ConnLost = DEF_YES;                         /* See Note #2.                                         */
+           *perr             = SMTPc_ERR_TX_FAILED;
+            return;
+        }
+        p_sess->Stats.OctetTxCtr += tx_len;
+
+        while ((vec_nbr > 0u) &&
+               (tx_len  >= p_vec->Len)) {
+            tx_len -= p_vec->Len;
+            p_vec++;
+            vec_nbr--;
+        }
+        if (vec_nbr > 0u) {                                     /* Buf partially tx'd.                                  */
+            p_vec->DataPtr  = (const CPU_INT08U *)p_vec->DataPtr + tx_len;
+            p_vec->Len     -= tx_len;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_TS_Get_ms()
+*
+* Description : Get the current time, from the clock of the transport.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Current time, in milliseconds (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #1h').
+*
+*               0,                                   if no transport is set.
+*
+* Caller(s)   : SMTPc_AsyncInit(),
+*               SMTPc_AsyncStep(),
+*               SMTPc_AsyncConn(),
+*               SMTPc_AsyncTx(),
+*               SMTPc_PoolGet(),
+*               SMTPc_PoolRelease(),
+*               SMTPc_MIMEBoundarySet().
+*
+* Note(s)     : (1) The module reads the time only through the transport, so that it runs without the
+*                   timestamps of a TCP/IP stack.
+*********************************************************************************************************
+*/
+
+static  SMTPc_TS_MS  SMTPc_TS_Get_ms (void)
+{
+    if (SMTPc_TransportAPI_Ptr == (const SMTPc_TRANSPORT_API *)0) {
+        return (0u);
+    }
+
+    return (SMTPc_TransportAPI_Ptr->TS_Get_ms());               /* See Note #1.                                         */
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxGather()
+*
+* Description : Send data to the server, gathering small pieces into segments.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_data          Pointer to the data.
+*               len             Length of the data.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*                               SMTPc_ERR_BUF_TOO_SMALL             Render buffer full (see Note #3).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxData(),
+*               SMTPc_SendBody(),
+*               SMTPc_TxBatchPipelined().
+*
+* Note(s)     : (1) The message content is produced in pieces : the headers, each body fragment, the
+*                   encoded lines & the "end of mail data" indicator.  Sending each one as it comes would
+*                   produce many small TCP segments.  Instead :
+*
+*                   (a) A piece that does not fill the segment buffer is copied into it.
+*
+*                   (b) Otherwise, the data of the segment buffer & as many whole segments as possible from
+*                       the piece are sent together, in a single call to the transport (see
+*                       'SMTPc_TxSockV()').  The piece is thus never copied as a whole.  The end of the
+*                       piece is kept in the segment buffer.
+*
+*               (2) The gathered data is sent by SMTPc_TxFlush(), which is called before any reply is
+*                   awaited (see 'SMTPc_RxReply()') & before any command is sent (see
+*                   'SMTPc_QueryServer()').
+*
+*               (3) While a message is rendered (see 'SMTPc_RenderMsg()'), the data is appended to the
+*                   render buffer instead of sent.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxGather (SMTPc_SESSION  *p_sess,
+                              CPU_CHAR       *p_data,
+                              CPU_INT32U      len,
+                              SMTPc_ERR      *perr)
+{
+#if (SMTPc_CFG_TX_SEG_LEN > 0u)
+    SMTPc_TRANSPORT_VEC  vec[2];
+    CPU_INT32U           len_cpy;
+#endif
+
+
+   *perr = SMTPc_ERR_NONE;
+                                                                /* ------------------- RENDER PIECE ------------------- */
+    if (p_sess->RenderPtr != (CPU_CHAR *)0) {                   /* See Note #3.                                         */
+        if (len > p_sess->RenderRem) {
+           *perr = SMTPc_ERR_BUF_TOO_SMALL;
+            return;
+        }
+        Mem_Copy(p_sess->RenderPtr, p_data, len);
+        p_sess->RenderPtr += len;
+        p_sess->RenderRem -= len;
+        return;
+    }
+
+#if (SMTPc_CFG_TX_SEG_LEN > 0u)
+                                                                /* ------------------ GATHER PIECE -------------------- */
+    if ((p_sess->TxSegLen + len) < SMTPc_CFG_TX_SEG_LEN) {      /* See Note #1a.                                        */
+        Mem_Copy(&p_sess->TxSegBuf[p_sess->TxSegLen], p_data, len);
+        p_sess->TxSegLen += len;
+        return;
+    }
+                                                                /* ----------- TX BUF & WHOLE SEGMENTS ---------------- */
+    len_cpy          = (p_sess->TxSegLen + len) % SMTPc_CFG_TX_SEG_LEN;
+    vec[0].DataPtr   =  p_sess->TxSegBuf;                       /* See Note #1b.                                        */
+    vec[0].Len       =  p_sess->TxSegLen;
+    vec[1].DataPtr   =  p_data;
+    vec[1].Len       =  len - len_cpy;
+    p_sess->TxSegLen =  0u;
+    SMTPc_TxSockV(p_sess, &vec[0], 2u, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* -------------------- KEEP END ---------------------- */
+    Mem_Copy(&p_sess->TxSegBuf[0], &p_data[len - len_cpy], len_cpy);
+    p_sess->TxSegLen = len_cpy;
+#else
+    SMTPc_TxSock(p_sess, p_data, len, perr);
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_TxFlush()
+*
+* Description : Send the data gathered by SMTPc_TxGather(), if any.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_QueryServer(),
+*               SMTPc_RxReply().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxFlush (SMTPc_SESSION  *p_sess,
+                             SMTPc_ERR      *perr)
+{
+#if (SMTPc_CFG_TX_SEG_LEN > 0u)
+    CPU_INT32U  len;
+
+
+    len = p_sess->TxSegLen;
+    if (len > 0u) {
+        p_sess->TxSegLen = 0u;
+        SMTPc_TxSock(p_sess, p_sess->TxSegBuf, len, perr);
+        return;
+    }
+#else
+    (void)p_sess;
+#endif
+   *perr = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                              SMTPc_TxMsg()
+*
+* Description : (1) Send a message (an instance of the SMTPc_MSG structure) to the SMTP server.
+*
+*                   (a) Invoke the MAIL command
+*                   (b) Invoke the RCPT command for every recipient
+*                   (c) Invoke the DATA command
+*                   (d) Build and send the actual data
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_msg' passed a NULL pointer.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+*                                                                   ------- RETURNED BY SMTPc_MAIL() : -------
+*                                                                   ------- RETURNED BY SMTPc_RCPT() : -------
+*                                                                   ------- RETURNED BY SMTPc_DATA() : -------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+*                                                                   ----- RETURNED BY SMTPc_SendBody() : -----
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_BODY_RD_FAILED            Body could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SendMsgBatch(),
+*               SMTPc_SessionSendMsg().
+*
+* Note(s)     : (2) The function SMTPc_SetMsg has to be called before being able to send a message.
+*
+*               (3) The message has to have at least one receiver, either "To", "CC", or "BCC".
+*
+*               (4) When the server supports the PIPELINING extension, the MAIL, RCPT & DATA commands are
+*                   sent as a single group (see 'SMTPc_TxEnvelopePipelined()').
+*
+*               (5) The DATA command is not used when the message content is sent with BDAT (see
+*                   'SMTPc_TxData()  Note #2').  A rendered message is always sent with DATA (see
+*                   'SMTPc_RenderMsg()  Note #3').
+*
+*               (6) When partial delivery is enabled, a recipient rejected by the server is skipped & the
+*                   message is sent to the recipients accepted (see 'smtp-c.h  SMTPc_MSG  Note #5').  The
+*                   transaction is still aborted if no recipient was accepted, if the connection failed, or
+*                   if the server is shutting down (421).
+*
+*               (7) RSET is only sent to abort a transaction the server rejected.  After a transmission or
+*                   reception error, the connection can no longer be trusted (see 'smtp-c.h  SMTP SESSION
+*                   DATA TYPES  Note #4') : RSET would fail, or wait for a reply timeout on a stalled one.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxMsg (SMTPc_SESSION  *p_sess,
+                           SMTPc_MSG      *p_msg,
+                           SMTPc_ERR      *p_err)
+{
+    CPU_INT16U    i;
+    CPU_INT16U    rcpt_ok_nbr;
+    SMTPc_MBOX   *p_rcpt;
+    SMTPc_REPLY  *reply;
+    CPU_INT32U    completion_code;
+    SMTPc_ERR     err_rset;
+
+
+    SMTPc_MsgChk(p_msg, p_err);                                 /* See Notes #2 & #3.                                   */
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* See Note #5.                                         */
+    p_sess->DataOnly = (p_msg->RenderBufPtr != (CPU_CHAR *)0) ? DEF_YES : DEF_NO;
+                                                                /* See Note #4.                                         */
+    if (DEF_BIT_IS_SET(p_sess->Caps.Flags, SMTPc_CAP_PIPELINING) == DEF_YES) {
+        SMTPc_TxEnvelopePipelined(p_sess, p_msg, p_err);
+        if (*p_err != SMTPc_ERR_NONE) {
+            return;
+        }
+
+        SMTPc_SendBody(p_sess, p_msg, p_err);
+        if (*p_err != SMTPc_ERR_NONE) {
+             SMTPc_TRACE_DBG(("Error SMTPc_SendBody.  Error: %u\n\r", (unsigned int)*p_err));
+        }
+        return;
+    }
+
+                                                                /* --------------- INVOKE THE MAIL CMD ---------------- */
+    completion_code = 0u;
+    SMTPc_MAIL(p_sess, p_msg->From->Addr, &completion_code, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+         SMTPc_TRACE_DBG(("Error MAIL.  Code: %u\n\r", (unsigned int)completion_code));
+         if ((*p_err          != SMTPc_ERR_TX_FAILED) &&        /* See Note #7.                                         */
+             (*p_err          != SMTPc_ERR_RX_FAILED) &&
+             (completion_code != SMTPc_REP_421)       &&
+             (completion_code != SMTPc_REP_221)) {
+             SMTPc_RSET(p_sess, &completion_code, &err_rset);
+         }
+         return;
+    }
+
+                                                                /* --------------- INVOKE THE RCTP CMD ---------------- */
+                                                                /* The RCPT cmd is tx'd for every recipient,            */
+                                                                /* including CCs & BCCs.                                */
+    rcpt_ok_nbr = 0u;
+    p_rcpt      = SMTPc_GetRcpt(p_msg, 0u);
+    for (i = 0u; p_rcpt != (SMTPc_MBOX *)0; i++) {
+        completion_code = 0u;
+        reply = SMTPc_RCPT(p_sess, p_rcpt->Addr, &completion_code, p_err);
+        (void)SMTPc_RcptResultSet(p_msg, i, reply);
+        if (*p_err == SMTPc_ERR_NONE) {
+            rcpt_ok_nbr++;
+
+        } else {
+             SMTPc_TRACE_DBG(("Error RCPT (%u).  Code: %u\n\r", (unsigned int)i, (unsigned int)completion_code));
+             if ((p_msg->RcptPartialEn != DEF_YES)       ||     /* See Note #6.                                         */
+                 (*p_err                != SMTPc_ERR_REP) ||
+                 (completion_code       == SMTPc_REP_421)) {
+                                                                /* RSET p_msg if invalid RCPT fails (see Note #7).      */
+                 if ((*p_err          != SMTPc_ERR_TX_FAILED) &&
+                     (*p_err          != SMTPc_ERR_RX_FAILED) &&
+                     (completion_code != SMTPc_REP_421)       &&
+                     (completion_code != SMTPc_REP_221)) {
+                     SMTPc_RSET(p_sess, &completion_code, &err_rset);
+                 }
+                 return;
+             }
+        }
+        p_rcpt = SMTPc_GetRcpt(p_msg, i + 1u);
+    }
+
+    if (rcpt_ok_nbr == 0u) {                                    /* No rcpt accepted (see Note #6).                      */
+        SMTPc_TRACE_DBG(("Error RCPT, no recipient accepted.\n\r"));
+        SMTPc_RSET(p_sess, &completion_code, &err_rset);
+       *p_err = SMTPc_ERR_REP;
+        return;
+    }
+
+                                                                /* --------------- INVOKE THE DATA CMD ---------------- */
+    if (SMTPc_BDAT_EN(p_sess) == DEF_NO) {                      /* See Note #5.                                         */
+        completion_code = 0u;
+        SMTPc_DATA(p_sess, &completion_code, p_err);
+        if (*p_err != SMTPc_ERR_NONE) {
+             SMTPc_TRACE_DBG(("Error DATA.  Code: %u\n\r", (unsigned int)completion_code));
+             if ((*p_err          != SMTPc_ERR_TX_FAILED) &&    /* See Note #7.                                         */
+                 (*p_err          != SMTPc_ERR_RX_FAILED) &&
+                 (completion_code != SMTPc_REP_421)       &&
+                 (completion_code != SMTPc_REP_221)) {
+                 SMTPc_RSET(p_sess, &completion_code, &err_rset);
+             }
+             return;
+        }
+    }
+
+                                                                /* ----------- BUILD & SEND THE ACTUAL MSG ------------ */
+    SMTPc_SendBody(p_sess, p_msg, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+         SMTPc_TRACE_DBG(("Error SMTPc_SendBody.  Error: %u\n\r", (unsigned int)*p_err));
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TxEnvelopePipelined()
+*
+* Description : (1) Send the envelope of a message using command pipelining.
+*
+*                   (a) Build & send the MAIL, RCPT & DATA commands as a single group
+*                   (b) Receive & validate the replies
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, server waiting for data.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+*                                                                   ---- RETURNED BY SMTPc_RxEnvelope() : ----
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxMsg().
+*
+* Note(s)     : (2) From RFC #2920, Section 3.1, "the actual transfer of message content is explicitly
+*                   allowed to be the first "command" in a group", and the DATA command MAY be the last
+*                   command of a group.  The envelope therefore costs a single round-trip.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxEnvelopePipelined (SMTPc_SESSION *p_sess,
+                                         SMTPc_MSG     *p_msg,
+                                         SMTPc_ERR     *perr)
+{
+    CPU_INT32U  wr_ix;
+
+
+                                                                /* ---------------- TX COMMANDS GROUP ----------------- */
+    wr_ix = SMTPc_BuildEnvelope(p_sess, 0u, p_msg, perr);
+    if (*perr == SMTPc_ERR_NONE) {
+        SMTPc_QueryServer(p_sess, p_sess->TxBuf, wr_ix, perr);
+    }
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+                                                                /* ----------------- RX & VALIDATE REPLIES ------------ */
+    SMTPc_RxEnvelope(p_sess, p_msg, perr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_BuildEnvelope()
+*
+* Description : Append the MAIL, RCPT & DATA commands of a message to the transmit buffer of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf_wr_ix       Index of current "write" position.
+*               p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_TxEnvelopePipelined(),
+*               SMTPc_TxBatchPipelined().
+*
+* Note(s)     : (1) The commands are NOT sent, except when the buffer is full (see 'SMTPc_BuildCmd()
+*                   Note #2').
+*
+*               (2) The DATA command is omitted when the message content is sent with BDAT.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildEnvelope (SMTPc_SESSION  *p_sess,
+                                         CPU_INT32U      buf_wr_ix,
+                                         SMTPc_MSG      *p_msg,
+                                         SMTPc_ERR      *perr)
+{
+    SMTPc_MBOX  *p_rcpt;
+    CPU_INT16U   i;
+
+
+    buf_wr_ix = SMTPc_BuildCmd(p_sess, buf_wr_ix, SMTPc_CMD_MAIL, " FROM:<", p_msg->From->Addr, perr);
+
+    p_rcpt = SMTPc_GetRcpt(p_msg, 0u);
+    for (i = 0u; (p_rcpt != (SMTPc_MBOX *)0) && (*perr == SMTPc_ERR_NONE); i++) {
+        buf_wr_ix = SMTPc_BuildCmd(p_sess, buf_wr_ix, SMTPc_CMD_RCPT, " TO:<", p_rcpt->Addr, perr);
+        p_rcpt    = SMTPc_GetRcpt(p_msg, i + 1u);
+    }
+
+    if ((*perr                 == SMTPc_ERR_NONE) &&            /* See Note #2.                                         */
+        (SMTPc_BDAT_EN(p_sess) == DEF_NO)) {
+        buf_wr_ix = SMTPc_BuildCmd(p_sess, buf_wr_ix, SMTPc_CMD_DATA, DEF_NULL, DEF_NULL, perr);
+    }
+
+    return (buf_wr_ix);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_RxEnvelope()
+*
+* Description : (1) Receive the replies to the pipelined envelope of a message.
+*
+*                   (a) Receive & validate the replies, in order
+*                   (b) Reset the transaction, if any command failed
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_msg           SMTPc_MSG structure encapsulating the message being sent.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, server waiting for data.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEnvelopePipelined(),
+*               SMTPc_TxBatchPipelined().
+*
+* Note(s)     : (2) "Client SMTP implementations that employ pipelining MUST check ALL statuses associated
+*                   with each command in a group".  Every reply is received even after a failure, so the
+*                   replies of the next commands are not mistaken for the reply of the RSET command.
+*
+*                   The same validation as SMTPc_MAIL(), SMTPc_RCPT() & SMTPc_DATA() is applied to each
+*                   reply.  Any failure aborts the whole message, as when pipelining is not used (see also
+*                   Note #5).
+*
+*               (3) The server accepts DATA as soon as one recipient is accepted.  If DATA was accepted
+*                   while a previous command failed, the transaction cannot be reset since the server
+*                   expects mail data, and sending the end of mail data indicator would deliver an empty
+*                   message.  The connection is closed instead, which aborts the transaction.
+*
+*               (4) When the message content is sent with BDAT, the envelope has no DATA command (see
+*                   'SMTPc_TxData()  Note #2').
+*
+*               (5) When partial delivery is enabled, a rejected recipient does not fail the envelope, unless
+*                   no recipient was accepted or the server is shutting down (see 'SMTPc_TxMsg()  Note #6').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_RxEnvelope (SMTPc_SESSION  *p_sess,
+                                SMTPc_MSG      *p_msg,
+                                SMTPc_ERR      *perr)
+{
+    CPU_INT16U    i;
+    SMTPc_MBOX   *p_rcpt;
+    SMTPc_REPLY  *reply;
+    CPU_INT32U    completion_code;
+    CPU_INT32U    fail_code;
+    CPU_INT32U    rej_code;
+    CPU_INT16U    rcpt_ok_nbr;
+    CPU_BOOLEAN   accepted;
+
+
+    fail_code   = 0u;                                           /* See Note #2.                                         */
+    rej_code    = 0u;
+    rcpt_ok_nbr = 0u;
+                                                                /* MAIL reply.                                          */
+    reply = SMTPc_RxReply(p_sess, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_RX_FAILED;
+        return;
+    }
+    completion_code = 0u;
+    SMTPc_ParseReply(reply, &completion_code, perr);
+    if (*perr != SMTPc_ERR_REP_POS) {
+         SMTPc_TRACE_DBG(("Error MAIL.  Code: %u\n\r", (unsigned int)completion_code));
+         fail_code = completion_code;
+    }
+                                                                /* RCPT replies.                                        */
+    p_rcpt = SMTPc_GetRcpt(p_msg, 0u);
+    for (i = 0u; p_rcpt != (SMTPc_MBOX *)0; i++) {
+        reply = SMTPc_RxReply(p_sess, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+           *perr = SMTPc_ERR_RX_FAILED;
+            return;
+        }
+        completion_code = 0u;
+        SMTPc_ParseReply(reply, &completion_code, perr);
+        accepted = SMTPc_RcptResultSet(p_msg, i, reply);
+        if (accepted == DEF_YES) {
+            rcpt_ok_nbr++;
+
+        } else if (fail_code == 0u) {
+             SMTPc_TRACE_DBG(("Error RCPT (%u).  Code: %u\n\r", (unsigned int)i, (unsigned int)completion_code));
+             if ((p_msg->RcptPartialEn != DEF_YES) ||           /* See Note #5.                                         */
+                 (completion_code       == SMTPc_REP_421)) {
+                 fail_code = completion_code;
+             } else if (rej_code == 0u) {
+                 rej_code  = completion_code;
+             }
+        }
+        p_rcpt = SMTPc_GetRcpt(p_msg, i + 1u);
+    }
+    if ((fail_code   == 0u) &&
+        (rcpt_ok_nbr == 0u)) {
+        fail_code = rej_code;
+    }
+    if (SMTPc_BDAT_EN(p_sess) == DEF_YES) {                     /* See Note #4.                                         */
+        if (fail_code == 0u) {
+           *perr = SMTPc_ERR_NONE;                              /* Srv waiting for BDAT chunks.                         */
+            return;
+        }
+        completion_code = fail_code;
+
+    } else {
+                                                                /* DATA reply.                                          */
+        reply = SMTPc_RxReply(p_sess, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+           *perr = SMTPc_ERR_RX_FAILED;
+            return;
+        }
+        completion_code = 0u;
+        SMTPc_ParseReply(reply, &completion_code, perr);
+        if (completion_code == SMTPc_REP_354) {
+            if (fail_code == 0u) {
+               *perr = SMTPc_ERR_NONE;                          /* Srv waiting for mail data.                           */
+                return;
+            }
+                                                                /* See Note #3.                                         */
+            SMTPc_TRACE_DBG(("Error envelope.  Code: %u, closing conn\n\r", (unsigned int)fail_code));
+            SMTPc_TransportAPI_Ptr->Close(p_sess->SockId, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+            p_sess->SockId = SMTPc_SOCK_ID_NONE;
+           *perr = SMTPc_ERR_REP;
+            return;
+        }
+
+        if (fail_code == 0u) {
+             SMTPc_TRACE_DBG(("Error DATA.  Code: %u\n\r", (unsigned int)completion_code));
+             fail_code = completion_code;
+        }
+    }
+                                                                /* ------------------ RESET TRANSACTION --------------- */
+    if ((fail_code       != SMTPc_REP_421) &&
+        (fail_code       != SMTPc_REP_221) &&
+        (completion_code != SMTPc_REP_421)) {
+        SMTPc_RSET(p_sess, &completion_code, perr);
+    }
+
+   *perr = SMTPc_ERR_REP;
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_TxBody()
+*
+* Description : (1) Prepare and send the actual data of the message, i.e. the body part of the message
+*                   content.
+*
+*                   (a) Built headers and transmit
+*                   (b) Transmit body content
+*                   (c) Prepare and transmit attachment(s)
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               msg             SMTPc_MSG structure encapsulating the message to send.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+*                                                                   ----- RETURNED BY SMTPc_BuildHdr() : -----
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+*                                                                   ----- RETURNED BY SMTPc_TxContent() : ----
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+*                                                                   ----- RETURNED BY SMTPc_TxEntity() : -----
+*                               SMTPc_ERR_BODY_RD_FAILED            Body/attachment could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SendBody(),
+*               SMTPc_TxBatchPipelined().
+*
+* Note(s)     : (2) The "end of mail data" indicator is NOT sent (see 'SMTPc_BuildEOM()').
+*
+*               (3) The current implementation does not insert the names of the mailbox owners (member
+*                   NameDisp of structure SMTPc_MBOX).
+*
+*               (4) Every BDAT chunk is replied to before returning, so only the reply to the "end of mail
+*                   data" indicator is outstanding.
+*
+*               (5) The headers are built by this module & need no transparency encoding.  The body begins
+*                   a line (see 'SMTPc_TxContent()  Note #5').
+*
+*               (6) The body is read by pieces when the message provides a read function (see 'smtp-c.h
+*                   SMTPc_MSG  Note #2').
+*
+*               (7) A message with attachments is sent as a multipart/mixed entity (see RFC #2046, Section
+*                   5.1.3).  The body is its first part, followed by a part per attachment.
+*
+*               (8) The body is sent as is unless the message selects a content transfer encoding (see
+*                   'smtp-c.h  SMTPc_MIME_ENTITY_HDR  Note #4'), in which case MIME headers describe it.
+*
+*               (9) A body made of fragments (see 'smtp-c.h  SMTPc_MSG  Note #3') is sent fragment by
+*                   fragment; the fragments are gathered into segments as they are sent (see
+*                   'SMTPc_TxGather()').
+*
+*              (10) The content of a rendered message is sent as is (see 'SMTPc_RenderMsg()  Note #4').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxBody (SMTPc_SESSION  *p_sess,
+                            SMTPc_MSG      *msg,
+                            SMTPc_ERR      *perr)
+{
+    CPU_INT32U   cur_wr_ix;
+    CPU_INT08U   i;
+    CPU_INT08U   nbr_attach;
+    CPU_INT08U   enc;
+    CPU_INT32U   line_len;
+    CPU_CHAR    *hdr;
+    SMTPc_BODY_FRAG      body_frag;
+    SMTPc_BODY_FRAG     *p_body_frag;
+    CPU_INT16U           body_nbr_frag;
+    SMTPc_BODY_RD_FNCT   body_rd_fnct;
+
+
+    if (msg->RenderBufPtr != (CPU_CHAR *)0) {                   /* See Note #10.                                        */
+        SMTPc_TxData(p_sess, msg->RenderBufPtr, msg->RenderLen, perr);
+        return;
+    }
+
+    cur_wr_ix = 0;
+    line_len  = 0;
+
+                                                                /* ------------------- BUILT HEADERS ------------------ */
+                                                                /* Header "From: ".                                     */
+    hdr       = (CPU_CHAR *)SMTPc_HDR_FROM;
+    cur_wr_ix = SMTPc_BuildHdr( p_sess,                         /* Addr                                                 */
+                                p_sess->TxBuf,
+                                SMTPc_COMM_BUF_LEN,
+                                cur_wr_ix,
+                                hdr,
+                                msg->From->Addr,
+                               &line_len,
+                                perr);
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+
+
+    if (msg->Sender != (SMTPc_MBOX *)0) {                       /* Header "Sender: ".                                   */
+        hdr       = (CPU_CHAR *)SMTPc_HDR_SENDER;
+        cur_wr_ix = SMTPc_BuildHdr( p_sess,                     /* Addr                                                 */
+                                    p_sess->TxBuf,
+                                    SMTPc_COMM_BUF_LEN,
+                                    cur_wr_ix,
+                                    hdr,
+                                    msg->Sender->Addr,
+                                   &line_len,
+                                    perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+    }
+
+
+
+                                                                /* Header "To: ".                                       */
+    hdr = (CPU_CHAR *)SMTPc_HDR_TO;
+    for (i = 0; (i < SMTPc_CFG_MSG_MAX_TO) && (msg->ToArray[i] != (SMTPc_MBOX *)0); i++) {
+        cur_wr_ix = SMTPc_BuildHdr( p_sess,
+                                    p_sess->TxBuf,
+                                    SMTPc_COMM_BUF_LEN,
+                                    cur_wr_ix,
+                                    hdr,
+                                    msg->ToArray[i]->Addr,
+                                   &line_len,
+                                    perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        hdr = (CPU_CHAR *)0;
+    }
+
+
+                                                                /* Header "Reply-to: ".                                 */
+    hdr = (CPU_CHAR *)SMTPc_HDR_REPLYTO;
+    if (msg->ReplyTo != (SMTPc_MBOX *)0) {
+        cur_wr_ix = SMTPc_BuildHdr( p_sess,
+                                    p_sess->TxBuf,
+                                    SMTPc_COMM_BUF_LEN,
+                                    cur_wr_ix,
+                                    hdr,
+                                    msg->ReplyTo->Addr,
+                                   &line_len,
+                                    perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        hdr = (CPU_CHAR *)0;
+    }
 
 
                                                                 /* Header "CC: ".                                       */
     hdr = (CPU_CHAR *)SMTPc_HDR_CC;
     for (i = 0; (i < SMTPc_CFG_MSG_MAX_CC) && (msg->CCArray[i] != (SMTPc_MBOX *)0); i++) {
-        cur_wr_ix = SMTPc_BuildHdr( sock_id,
-                                    SMTPc_Comm_Buf,
+        cur_wr_ix = SMTPc_BuildHdr( p_sess,
+                                    p_sess->TxBuf,
                                     SMTPc_COMM_BUF_LEN,
                                     cur_wr_ix,
                                     hdr,
@@ -1113,929 +5900,5642 @@ static  void  SMTPc_SendBody (NET_SOCK_ID   sock_id,
         if (*perr != SMTPc_ERR_NONE) {
             return;
         }
-        hdr = (CPU_CHAR *)0;
+        hdr = (CPU_CHAR *)0;
+    }
+
+
+    if (msg->Subject != (CPU_CHAR *)0) {                        /* Header "Subject: ".                                  */
+        cur_wr_ix = SMTPc_BuildHdr((SMTPc_SESSION *)p_sess,
+                                   (CPU_CHAR   *) p_sess->TxBuf,
+                                   (CPU_INT32U  ) SMTPc_COMM_BUF_LEN,
+                                   (CPU_INT32U  ) cur_wr_ix,
+                                   (CPU_CHAR   *) SMTPc_HDR_SUBJECT,
+                                   (CPU_CHAR   *) msg->Subject,
+                                   (CPU_INT32U *)&line_len,
+                                   (SMTPc_ERR  *) perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+    }
+
+    nbr_attach = 0u;
+    while ((nbr_attach < SMTPc_CFG_MSG_MAX_ATTACH) &&
+           (msg->AttachArray[nbr_attach] != (SMTPc_ATTACH *)0)) {
+        nbr_attach++;
+    }
+                                                                /* ------------- SEL BODY TRANSFER ENC ---------------- */
+    if (msg->ContentBodyFragNbr > 0u) {                         /* See Note #9.                                         */
+        p_body_frag       =  msg->ContentBodyFragArray;
+        body_nbr_frag     =  msg->ContentBodyFragNbr;
+    } else {
+        body_frag.DataPtr =  msg->ContentBodyMsg;
+        body_frag.Len     =  msg->ContentBodyMsgLen;
+        p_body_frag       = &body_frag;
+        body_nbr_frag     =  1u;
+    }
+    body_rd_fnct = msg->ContentBodyRdFnct;
+    enc          = SMTPc_MIMEEncSel(p_sess,                     /* See Note #8.                                         */
+                                    msg->MIMEMsgHdrStruct.ContentEncoding,
+                                    SMTPc_MIME_ENC_7BIT,
+                                   &p_body_frag,
+                                   &body_nbr_frag,
+                                   &body_frag,
+                                   &body_rd_fnct,
+                                    msg->ContentBodyRdArg,
+                                    perr);
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ------------------ MIME HEADERS -------------------- */
+    if ((nbr_attach >  0u) ||
+        (enc        != SMTPc_MIME_ENC_7BIT)) {
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, SMTPc_HDR_MIME_VERSION SMTPc_CRLF, perr);
+    }
+    if (nbr_attach > 0u) {                                      /* See Note #7.                                         */
+        SMTPc_MIMEBoundarySet(p_sess);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, SMTPc_HDR_CONTENT_TYPE SMTPc_MIME_TYPE_MULTIPART, perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, p_sess->Boundary, perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, "\"" SMTPc_CRLF, perr);
+                                                                /* ----------- INSERT HEADER/BODY DELIMITER ----------- */
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, SMTPc_CRLF "--", perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, p_sess->Boundary, perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, SMTPc_CRLF, perr);
+    }
+    if ((nbr_attach >  0u) ||                                   /* Body hdrs.                                           */
+        (enc        != SMTPc_MIME_ENC_7BIT)) {
+        cur_wr_ix = SMTPc_BuildContentType(p_sess,
+                                           cur_wr_ix,
+                                          &msg->MIMEMsgHdrStruct,
+                                           SMTPc_MIME_TYPE_BODY,
+                                           perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, SMTPc_CRLF, perr);
+        if (enc != SMTPc_MIME_ENC_7BIT) {
+            cur_wr_ix = SMTPc_BuildContentEnc(p_sess, cur_wr_ix, enc, perr);
+        }
+    }
+                                                                /* ----------- INSERT HEADER/BODY DELIMITER ----------- */
+    cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, SMTPc_CRLF, perr);
+                                                                /* ---------------- TX CONTENT HEADERS ---------------- */
+    if (*perr == SMTPc_ERR_NONE) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, cur_wr_ix, perr);
+    }
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+
+
+                                                                /* ------------------ TX BODY CONTENT ----------------- */
+    SMTPc_TxEntity(p_sess,                                      /* See Notes #5 & #6.                                   */
+                   p_body_frag,
+                   body_nbr_frag,
+                   body_rd_fnct,
+                   msg->ContentBodyRdArg,
+                   enc,
+                   perr);
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+
+                                                                /* ------------ PREPARE & TX ATTACHMENT(S) ------------ */
+    if (nbr_attach > 0u) {
+        for (i = 0u; i < nbr_attach; i++) {
+            SMTPc_TxAttach(p_sess, msg->AttachArray[i], perr);
+            if (*perr != SMTPc_ERR_NONE) {
+                return;
+            }
+        }
+                                                                /* Close delimiter.                                     */
+        cur_wr_ix = SMTPc_BuildStr(p_sess, 0u,        SMTPc_CRLF "--",       perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, p_sess->Boundary,      perr);
+        cur_wr_ix = SMTPc_BuildStr(p_sess, cur_wr_ix, "--" SMTPc_CRLF,       perr);
+        if (*perr == SMTPc_ERR_NONE) {
+            SMTPc_TxData(p_sess, p_sess->TxBuf, cur_wr_ix, perr);
+        }
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+    }
+
+                                                                /* ------------- RX BDAT CHUNKS REPLIES --------------- */
+    SMTPc_RxBdat(p_sess, 0u, perr);                             /* See Note #4.                                         */
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxEntity()
+*
+* Description : (1) Send the body of a MIME entity, i.e. the message body or the data of an attachment.
+*
+*                   (a) Encode & send the data held in fragments, or read beforehand
+*                   (b) Get the rest of the data by pieces from the read function, if any
+*                   (c) Abort the transaction, if the data could not be read
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_frag          Pointer to the fragments of the data, or to the data read beforehand (see
+*                               Note #5).
+*               nbr_frag        Number of fragments.
+*               rd_fnct         Function reading the (rest of the) data, or NULL.
+*               p_rd_arg        Argument passed to 'rd_fnct'.
+*               enc             Content transfer encoding :
+*
+*                                   SMTPc_MIME_ENC_BASE64       Data encoded in base64.
+*                                   SMTPc_MIME_ENC_QP           Data encoded in quoted-printable.
+*                                   SMTPc_MIME_ENC_7BIT         Data sent as is (see Note #3).
+*
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_BODY_RD_FAILED            Data could not be read.
+*
+*                                                                   ----- RETURNED BY SMTPc_TxContent() : ----
+*                                                                   ------- RETURNED BY SMTPc_TxB64() : ------
+*                                                                   ------- RETURNED BY SMTPc_TxQP() : -------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxBody(),
+*               SMTPc_TxAttach().
+*
+* Note(s)     : (2) Each fragment or piece is sent before the next one is read, so the memory needed does not
+*                   depend on the size of the data.  The encoders keep their state across fragments &
+*                   pieces.
+*
+*               (3) Data sent as is goes through the transparency encoder (see 'SMTPc_TxContent()').  Base64
+*                   & quoted-printable encoded data never need it.
+*
+*               (4) See 'SMTPc_TxAbort()'.
+*
+*               (5) SMTPc_MIMEEncSel() MAY read the first piece to select the encoding.  It is then sent
+*                   before any other piece is read.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxEntity (SMTPc_SESSION       *p_sess,
+                              SMTPc_BODY_FRAG     *p_frag,
+                              CPU_INT16U           nbr_frag,
+                              SMTPc_BODY_RD_FNCT   rd_fnct,
+                              void                *p_rd_arg,
+                              CPU_INT08U           enc,
+                              SMTPc_ERR           *perr)
+{
+    SMTPc_MIME_ENC_STATE  state;
+    CPU_CHAR             *p_data;
+    CPU_INT32U            len;
+    CPU_BOOLEAN           ok;
+
+
+    p_sess->EncState = SMTPc_ENC_STATE_BOL;
+    Mem_Clr(&state, sizeof(state));
+    ok     = DEF_OK;
+    p_data = DEF_NULL;
+    len    = 0u;
+                                                                /* See Note #2.                                         */
+    while (DEF_YES) {
+        if (nbr_frag > 0u) {                                    /* ------------------ NEXT FRAGMENT ------------------- */
+            p_data = p_frag->DataPtr;
+            len    = p_frag->Len;
+            p_frag++;
+            nbr_frag--;
+        }
+                                                                /* ----------------- ENCODE & TX DATA ----------------- */
+        switch (enc) {
+            case SMTPc_MIME_ENC_BASE64:
+                 SMTPc_TxB64(p_sess, &state, (CPU_INT08U *)p_data, len, perr);
+                 break;
+
+            case SMTPc_MIME_ENC_QP:
+                 SMTPc_TxQP(p_sess, &state, (CPU_INT08U *)p_data, len, perr);
+                 break;
+
+            default:
+                 SMTPc_TxContent(p_sess, p_data, len, perr);    /* See Note #3.                                         */
+                 break;
+        }
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        if (nbr_frag > 0u) {
+            continue;
+        }
+                                                                /* -------------------- GET DATA ---------------------- */
+#if (SMTPc_CFG_BODY_RD_BUF_LEN > 0u)
+        if (rd_fnct == (SMTPc_BODY_RD_FNCT)0) {
+            break;
+        }
+        len = 0u;
+        ok  = rd_fnct(p_rd_arg, p_sess->BodyRdBuf, SMTPc_CFG_BODY_RD_BUF_LEN, &len);
+        if ((ok  != DEF_OK) ||
+            (len == 0u)) {
+            break;
+        }
+        p_data = p_sess->BodyRdBuf;
+        len    = DEF_MIN(len, SMTPc_CFG_BODY_RD_BUF_LEN);
+#else
+        break;
+#endif
+    }
+
+    if (ok != DEF_OK) {                                         /* ----------------- ABORT TRANSACTION ---------------- */
+        SMTPc_TxAbort(p_sess);                                  /* See Note #4.                                         */
+       *perr = SMTPc_ERR_BODY_RD_FAILED;
+        return;
+    }
+
+    switch (enc) {
+        case SMTPc_MIME_ENC_BASE64:
+             SMTPc_TxB64End(p_sess, &state, perr);
+             break;
+
+        case SMTPc_MIME_ENC_QP:
+             SMTPc_TxQPEnd(p_sess, &state, perr);
+             break;
+
+        default:
+            *perr = SMTPc_ERR_NONE;
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxAbort()
+*
+* Description : Abort the transaction after the content of the message could not be read.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEntity(),
+*               SMTPc_MIMEEncSel().
+*
+* Note(s)     : (1) Once part of the content was sent with DATA, the server expects the end of the mail data
+*                   & the transaction cannot be reset.  The connection is closed, which aborts the
+*                   transaction.  When the content is sent with BDAT, the transaction is reset instead.
+*
+*               (2) No transaction is in progress while a message is rendered (see 'SMTPc_RenderMsg()').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxAbort (SMTPc_SESSION  *p_sess)
+{
+    CPU_INT32U  completion_code;
+    SMTPc_ERR   err;
+
+
+    if (p_sess->RenderPtr != (CPU_CHAR *)0) {                   /* See Note #2.                                         */
+        return;
+    }
+
+    SMTPc_TRACE_DBG(("Error reading msg content, aborting\n\r"));
+    if (SMTPc_BDAT_EN(p_sess) == DEF_YES) {                     /* See Note #1.                                         */
+        SMTPc_RxBdat(p_sess, 0u, &err);
+        SMTPc_RSET(p_sess, &completion_code, &err);
+    } else {
+        SMTPc_TransportAPI_Ptr->Close(p_sess->SockId, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+        p_sess->SockId = SMTPc_SOCK_ID_NONE;
+#if (SMTPc_CFG_TX_SEG_LEN > 0u)
+        p_sess->TxSegLen = 0u;                                  /* Gathered data discarded.                             */
+#endif
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_MIMEEncSel()
+*
+* Description : Select the content transfer encoding of a MIME entity.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               enc             Encoding requested by the entity header (see 'smtp-c.h
+*                               SMTPc_MIME_ENTITY_HDR  Note #4').
+*               enc_dflt        Encoding used for SMTPc_MIME_ENC_DFLT.
+*               pp_frag         Pointer to the pointer to the fragments of the data of the entity; set to
+*                               'p_frag_rd', if data was read beforehand (see Note #2).
+*               p_nbr_frag      Pointer to the number of fragments.
+*               p_frag_rd       Pointer to the fragment describing the data read beforehand.
+*               p_rd_fnct       Pointer to the read function of the entity; cleared if all the data was
+*                               read beforehand.
+*               p_rd_arg        Argument passed to the read function.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_BODY_RD_FAILED            Data could not be read.
+*
+* Return(s)   : Encoding to apply :
+*
+*                   SMTPc_MIME_ENC_BASE64
+*                   SMTPc_MIME_ENC_QP
+*                   SMTPc_MIME_ENC_7BIT
+*
+* Caller(s)   : SMTPc_TxBody(),
+*               SMTPc_TxAttach().
+*
+* Note(s)     : (1) SMTPc_MIME_ENC_AUTO selects quoted-printable if it is expected to be no longer than
+*                   base64 :  each octet that quoted-printable escapes takes 3 characters instead of 1,
+*                   whereas base64 takes 4 characters for every 3 octets.  The octets escaped are counted
+*                   over the first SMTPc_MIME_ENC_SAMPLE_LEN octets of the data.
+*
+*               (2) The headers of the entity, which name the encoding, are sent before its data.  When the
+*                   data is read by pieces, the first piece is read here so it can be sampled.  The number
+*                   of fragments is cleared otherwise, so that SMTPc_TxEntity() begins by reading.
+*********************************************************************************************************
+*/
+
+static  CPU_INT08U  SMTPc_MIMEEncSel (SMTPc_SESSION        *p_sess,
+                                      CPU_INT08U            enc,
+                                      CPU_INT08U            enc_dflt,
+                                      SMTPc_BODY_FRAG     **pp_frag,
+                                      CPU_INT16U           *p_nbr_frag,
+                                      SMTPc_BODY_FRAG      *p_frag_rd,
+                                      SMTPc_BODY_RD_FNCT   *p_rd_fnct,
+                                      void                 *p_rd_arg,
+                                      SMTPc_ERR            *perr)
+{
+    SMTPc_BODY_FRAG  *p_frag;
+    CPU_INT08U       *p_sample;
+    CPU_INT32U        sample_len;
+    CPU_INT32U        nbr_esc;
+    CPU_INT32U        i;
+    CPU_INT16U        j;
+#if (SMTPc_CFG_BODY_RD_BUF_LEN > 0u)
+    CPU_BOOLEAN       ok;
+#endif
+
+
+   *perr = SMTPc_ERR_NONE;
+    if (enc == SMTPc_MIME_ENC_DFLT) {
+        enc = enc_dflt;
+    }
+                                                                /* ----------------- RD FIRST PIECE ------------------- */
+#if (SMTPc_CFG_BODY_RD_BUF_LEN > 0u)
+    if (*p_rd_fnct != (SMTPc_BODY_RD_FNCT)0) {                  /* See Note #2.                                         */
+       *p_nbr_frag = 0u;
+        if (enc == SMTPc_MIME_ENC_AUTO) {
+            p_frag_rd->Len = 0u;
+            ok = (*p_rd_fnct)(p_rd_arg, p_sess->BodyRdBuf, SMTPc_CFG_BODY_RD_BUF_LEN, &p_frag_rd->Len);
+            if (ok != DEF_OK) {
+                SMTPc_TxAbort(p_sess);
+               *perr = SMTPc_ERR_BODY_RD_FAILED;
+                return (enc_dflt);
+            }
+            p_frag_rd->DataPtr = p_sess->BodyRdBuf;
+            p_frag_rd->Len     = DEF_MIN(p_frag_rd->Len, SMTPc_CFG_BODY_RD_BUF_LEN);
+           *pp_frag            = p_frag_rd;
+           *p_nbr_frag         = 1u;
+            if (p_frag_rd->Len == 0u) {                         /* End of data already reached.                         */
+               *p_rd_fnct = (SMTPc_BODY_RD_FNCT)0;
+            }
+        }
+    }
+#else
+    (void)p_frag_rd;
+    (void)p_rd_fnct;
+    (void)p_rd_arg;
+#endif
+                                                                /* ------------------ SAMPLE DATA --------------------- */
+    if (enc == SMTPc_MIME_ENC_AUTO) {                           /* See Note #1.                                         */
+        sample_len = 0u;
+        nbr_esc    = 0u;
+        p_frag     = *pp_frag;
+        for (j = 0u; (j < *p_nbr_frag) && (sample_len < SMTPc_MIME_ENC_SAMPLE_LEN); j++) {
+            p_sample = (CPU_INT08U *)p_frag[j].DataPtr;
+            for (i = 0u; (i < p_frag[j].Len) && (sample_len < SMTPc_MIME_ENC_SAMPLE_LEN); i++) {
+                if (SMTPc_QPClassTbl[p_sample[i]] == SMTPc_QP_CLASS_ESC) {
+                    nbr_esc++;
+                }
+                sample_len++;
+            }
+        }
+        enc = ((nbr_esc * 6u) <= sample_len) ? SMTPc_MIME_ENC_QP
+                                             : SMTPc_MIME_ENC_BASE64;
+    }
+
+    return (enc);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxAttach()
+*
+* Description : (1) Send an attachment as a part of a multipart message.
+*
+*                   (a) Select the content transfer encoding
+*                   (b) Build & send the boundary & the headers of the part
+*                   (c) Send the data of the attachment
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_attach        Pointer to the attachment.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                                                                   ----- RETURNED BY SMTPc_TxEntity() : -----
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*                               SMTPc_ERR_BODY_RD_FAILED            Data could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxBody().
+*
+* Note(s)     : (2) See RFC #2045 for the Content-Type & Content-Transfer-Encoding header fields, & RFC #2183
+*                   for the Content-Disposition header field.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxAttach (SMTPc_SESSION  *p_sess,
+                              SMTPc_ATTACH   *p_attach,
+                              SMTPc_ERR      *perr)
+{
+    SMTPc_MIME_ENTITY_HDR  *p_hdr;
+    SMTPc_BODY_FRAG         frag;
+    SMTPc_BODY_FRAG        *p_frag;
+    CPU_INT16U              nbr_frag;
+    SMTPc_BODY_RD_FNCT      rd_fnct;
+    CPU_INT08U              enc;
+    CPU_INT32U              wr_ix;
+    CPU_BOOLEAN             named;
+
+
+    p_hdr   = &p_attach->MIMEPartHdrStruct;
+    named   = (p_attach->Name[0] != '\0') ? DEF_YES : DEF_NO;
+                                                                /* ------------------ SEL ENCODING -------------------- */
+    frag.DataPtr = (CPU_CHAR *)p_attach->AttachData;
+    frag.Len     =  p_attach->Size;
+    p_frag       = &frag;
+    nbr_frag     =  1u;
+    rd_fnct      =  p_attach->RdFnct;
+    enc          =  SMTPc_MIMEEncSel(p_sess,
+                                     p_hdr->ContentEncoding,
+                                     SMTPc_MIME_ENC_BASE64,
+                                    &p_frag,
+                                    &nbr_frag,
+                                    &frag,
+                                    &rd_fnct,
+                                     p_attach->RdArg,
+                                     perr);
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ------------------- BOUNDARY ----------------------- */
+    wr_ix = SMTPc_BuildStr(p_sess, 0u,    SMTPc_CRLF "--",     perr);
+    wr_ix = SMTPc_BuildStr(p_sess, wr_ix, p_sess->Boundary,    perr);
+    wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_CRLF,          perr);
+                                                                /* ------------------ PART HEADERS -------------------- */
+    wr_ix = SMTPc_BuildContentType(p_sess, wr_ix, p_hdr, SMTPc_MIME_TYPE_ATTACH, perr);
+    if (named == DEF_YES) {
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, "; name=\"",     perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, p_attach->Name,  perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, "\"",            perr);
+    }
+    wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_CRLF,          perr);
+    wr_ix = SMTPc_BuildContentEnc(p_sess, wr_ix, enc,          perr);
+
+    wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_HDR_CONTENT_DISP "attachment", perr);
+    if (named == DEF_YES) {
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, "; filename=\"", perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, p_attach->Name,  perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, "\"",            perr);
+    }
+    wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_CRLF,          perr);
+
+    if (p_attach->Desc[0] != '\0') {
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_HDR_CONTENT_DESC, perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, p_attach->Desc,  perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_CRLF,      perr);
+    }
+    if (p_hdr->ID[0] != '\0') {
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_HDR_CONTENT_ID "<", perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, p_hdr->ID,       perr);
+        wr_ix = SMTPc_BuildStr(p_sess, wr_ix, ">" SMTPc_CRLF,  perr);
+    }
+    wr_ix = SMTPc_BuildStr(p_sess, wr_ix, SMTPc_CRLF,          perr);
+
+    if (*perr == SMTPc_ERR_NONE) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, wr_ix, perr);
+    }
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ------------------- PART DATA ---------------------- */
+    SMTPc_TxEntity(p_sess,
+                   p_frag,
+                   nbr_frag,
+                   rd_fnct,
+                   p_attach->RdArg,
+                   enc,
+                   perr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_TxB64()
+*
+* Description : Encode data in base64 & send it, by pieces.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder, cleared before the first piece.
+*               p_data          Pointer to the piece of data.
+*               len             Length of the piece.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEntity().
+*
+* Note(s)     : (1) The encoded data is gathered in the transmit buffer of the session & sent whenever the
+*                   buffer is full.  The memory needed does not depend on the size of the data.
+*
+*               (2) From RFC #2045, Section 6.8, "the encoded output stream must be represented in lines of
+*                   no more than 76 characters each".  Lines are separated by CRLF; the last line is not
+*                   terminated, the multipart delimiter beginning with a CRLF.
+*
+*               (3) Up to 2 octets that do not form a whole group of 3 are kept in the state until the next
+*                   piece.  SMTPc_TxB64End() MUST be called after the last piece.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxB64 (SMTPc_SESSION         *p_sess,
+                           SMTPc_MIME_ENC_STATE  *p_state,
+                           CPU_INT08U            *p_data,
+                           CPU_INT32U             len,
+                           SMTPc_ERR             *perr)
+{
+    CPU_INT32U  nbr_grp;
+    CPU_INT32U  nbr_grp_buf;
+
+
+   *perr = SMTPc_ERR_NONE;
+                                                                /* ------------ COMPLETE PREVIOUS GROUP --------------- */
+    if (p_state->CarryLen > 0u) {                               /* See Note #3.                                         */
+        while ((p_state->CarryLen < 3u) && (len > 0u)) {
+            p_state->Carry[p_state->CarryLen] = *p_data;
+            p_state->CarryLen++;
+            p_data++;
+            len--;
+        }
+        if (p_state->CarryLen < 3u) {
+            return;
+        }
+        p_state->CarryLen = 0u;
+        SMTPc_TxB64Grp(p_sess, p_state, p_state->Carry, 1u, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+    }
+                                                                /* ---------------- ENCODE GROUPS --------------------- */
+    nbr_grp = len / 3u;
+    while (nbr_grp > 0u) {
+        nbr_grp_buf = DEF_MIN(nbr_grp, SMTPc_B64_LINE_NBR_GRP);
+        SMTPc_TxB64Grp(p_sess, p_state, p_data, nbr_grp_buf, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        p_data  += nbr_grp_buf * 3u;
+        len     -= nbr_grp_buf * 3u;
+        nbr_grp -= nbr_grp_buf;
+    }
+                                                                /* ------------------ KEEP REMAINDER ------------------ */
+    while (len > 0u) {
+        p_state->Carry[p_state->CarryLen] = *p_data;
+        p_state->CarryLen++;
+        p_data++;
+        len--;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxB64Grp()
+*
+* Description : Encode groups of 3 octets in base64 into the transmit buffer of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder.
+*               p_data          Pointer to the groups.
+*               nbr_grp         Number of groups, at most SMTPc_B64_LINE_NBR_GRP.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxB64(),
+*               SMTPc_TxB64End().
+*
+* Note(s)     : (1) The groups MAY span two lines.  The transmit buffer is sent beforehand if it cannot hold
+*                   the encoded groups & a line separator.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxB64Grp (SMTPc_SESSION         *p_sess,
+                              SMTPc_MIME_ENC_STATE  *p_state,
+                              CPU_INT08U            *p_data,
+                              CPU_INT32U             nbr_grp,
+                              SMTPc_ERR             *perr)
+{
+   *perr = SMTPc_ERR_NONE;
+                                                                /* See Note #1.                                         */
+    if ((SMTPc_COMM_BUF_LEN - p_state->BufLen) < ((nbr_grp * 4u) + SMTPc_CRLF_SIZE)) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, p_state->BufLen, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        p_state->BufLen = 0u;
+    }
+
+    p_state->BufLen += SMTPc_B64Enc(p_data,
+                                    nbr_grp,
+                                   &p_sess->TxBuf[p_state->BufLen],
+                                   &p_state->LineLen);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_TxB64End()
+*
+* Description : Encode the last octets of base64 encoded data & send the encoded data not sent yet.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEntity().
+*
+* Note(s)     : (1) A last group of 1 or 2 octets is padded with '=' (see RFC #2045, Section 6.8).
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxB64End (SMTPc_SESSION         *p_sess,
+                              SMTPc_MIME_ENC_STATE  *p_state,
+                              SMTPc_ERR             *perr)
+{
+    CPU_INT32U  len;
+
+
+   *perr = SMTPc_ERR_NONE;
+    if (p_state->CarryLen > 0u) {                               /* See Note #1.                                         */
+        len = p_state->CarryLen;
+        Mem_Clr(&p_state->Carry[len], 3u - len);
+        SMTPc_TxB64Grp(p_sess, p_state, p_state->Carry, 1u, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        p_sess->TxBuf[p_state->BufLen - 1u] = '=';
+        if (len == 1u) {
+            p_sess->TxBuf[p_state->BufLen - 2u] = '=';
+        }
+        p_state->CarryLen = 0u;
+    }
+
+    if (p_state->BufLen > 0u) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, p_state->BufLen, perr);
+        p_state->BufLen = 0u;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_B64Enc()
+*
+* Description : Encode groups of 3 octets in base64.
+*
+* Argument(s) : p_src           Pointer to the groups.
+*               nbr_grp         Number of groups.
+*               p_dest          Pointer to the buffer receiving the encoded data, large enough for
+*                               (nbr_grp * 4) characters & the line separators.
+*               p_line_len      Pointer to the length of the current line :
+*
+*                                   Pointer     Lines wrapped at SMTPc_B64_LINE_LEN characters.
+*                                   DEF_NULL    No wrapping.
+*
+* Return(s)   : Number of characters written, NOT NULL terminated.
+*
+* Caller(s)   : SMTPc_TxB64Grp(),
+*               SMTPc_AUTH().
+*
+* Note(s)     : (1) Line separators are inserted outside of the encoding loop, which only has to handle
+*                   whole lines.  A separator is inserted before a line, never after the last one (see
+*                   'SMTPc_TxB64()  Note #2').
+*
+*               (2) Each line is encoded by the kernel selected by SMTPc_B64EncSet(), which is selected on
+*                   the first call if the application did not select one.
+*
+*               (3) Padding, if any, is left to the caller.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_B64Enc (CPU_INT08U  *p_src,
+                                  CPU_INT32U   nbr_grp,
+                                  CPU_CHAR    *p_dest,
+                                  CPU_INT32U  *p_line_len)
+{
+    CPU_CHAR            *p_out;
+    CPU_INT32U           nbr_grp_line;
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)
+    SMTPc_B64_ENC_FNCT   enc_fnct;
+    SMTPc_ERR            err;
+
+
+    if (SMTPc_B64EncFnct == (SMTPc_B64_ENC_FNCT)0) {            /* See Note #2.                                         */
+        SMTPc_B64EncSet(SMTPc_B64_ENC_AUTO, &err);
+    }
+    enc_fnct = SMTPc_B64EncFnct;
+#endif
+
+    p_out = p_dest;
+    while (nbr_grp > 0u) {
+        if (p_line_len != DEF_NULL) {                           /* See Note #1.                                         */
+            if (*p_line_len >= SMTPc_B64_LINE_LEN) {
+               *p_out++     = '\r';
+               *p_out++     = '\n';
+               *p_line_len  = 0u;
+            }
+            nbr_grp_line = DEF_MIN(nbr_grp, (SMTPc_B64_LINE_LEN - *p_line_len) / 4u);
+           *p_line_len  += nbr_grp_line * 4u;
+        } else {
+            nbr_grp_line = nbr_grp;
+        }
+        nbr_grp -= nbr_grp_line;
+
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)
+        enc_fnct(p_src, nbr_grp_line, p_out);
+#else
+        SMTPc_B64EncGrp(p_src, nbr_grp_line, p_out);
+#endif
+        p_out += nbr_grp_line * 4u;
+        p_src += nbr_grp_line * 3u;
+    }
+
+    return ((CPU_INT32U)(p_out - p_dest));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_B64EncGrp()
+*
+* Description : Encode groups of 3 octets in base64, without line separators (scalar kernel).
+*
+* Argument(s) : p_src           Pointer to the groups.
+*               nbr_grp         Number of groups.
+*               p_dest          Pointer to the buffer receiving the (nbr_grp * 4) characters.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_B64Enc(),
+*               SMTPc_B64EncGrp_SSE2(),
+*               SMTPc_B64EncGrp_AVX2(),
+*               SMTPc_B64EncGrp_NEON().
+*
+* Note(s)     : (1) With SMTPc_CFG_B64_PAIR_TBL_EN, each group is split into two 12-bit values that each
+*                   index a pair of characters, which halves the number of lookups.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_B64EncGrp (const  CPU_INT08U  *p_src,
+                                      CPU_INT32U   nbr_grp,
+                                      CPU_CHAR    *p_dest)
+{
+#if (SMTPc_CFG_B64_PAIR_TBL_EN == DEF_ENABLED)
+    const  CPU_CHAR  *p_hi;
+    const  CPU_CHAR  *p_lo;
+#else
+    CPU_INT32U        val;
+#endif
+
+
+    while (nbr_grp > 0u) {
+#if (SMTPc_CFG_B64_PAIR_TBL_EN == DEF_ENABLED)                  /* See Note #1.                                         */
+        p_hi       = &SMTPc_B64EncPairTbl[(((CPU_INT32U)p_src[0] << 4) | ((CPU_INT32U)p_src[1] >> 4)) * 2u];
+        p_lo       = &SMTPc_B64EncPairTbl[(((CPU_INT32U)p_src[1] & 0x0Fu) << 8 | (CPU_INT32U)p_src[2]) * 2u];
+        p_dest[0]  = p_hi[0];
+        p_dest[1]  = p_hi[1];
+        p_dest[2]  = p_lo[0];
+        p_dest[3]  = p_lo[1];
+#else
+        val        = ((CPU_INT32U)p_src[0] << 16)
+                   | ((CPU_INT32U)p_src[1] <<  8)
+                   |  (CPU_INT32U)p_src[2];
+        p_dest[0]  = SMTPc_B64EncTbl[(val >> 18) & 0x3Fu];
+        p_dest[1]  = SMTPc_B64EncTbl[(val >> 12) & 0x3Fu];
+        p_dest[2]  = SMTPc_B64EncTbl[(val >>  6) & 0x3Fu];
+        p_dest[3]  = SMTPc_B64EncTbl[ val        & 0x3Fu];
+#endif
+        p_dest    += 4u;
+        p_src     += 3u;
+        nbr_grp--;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_B64EncGrp_SSE2()
+*
+* Description : Encode groups of 3 octets in base64, without line separators (SSE2 kernel).
+*
+* Argument(s) : p_src           Pointer to the groups.
+*               nbr_grp         Number of groups.
+*               p_dest          Pointer to the buffer receiving the (nbr_grp * 4) characters.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_B64Enc(), through SMTPc_B64EncFnct.
+*
+* Note(s)     : (1) Four groups are encoded at a time from a 16-octet load, i.e. as long as at least 6 groups
+*                   are left so that the load never reads past the source.  The other groups are encoded by
+*                   SMTPc_B64EncGrp().
+*
+*               (2) SSE2 has no byte shuffle : each group is moved to its 32-bit lane by byte shifts of the
+*                   whole register, then its octets are reversed so that the lane reads 'b0 b1 b2 x' from
+*                   the most significant octet.  The four 6-bit values are then shifted in place, the first
+*                   one in the least significant octet.
+*
+*               (3) The values are translated to characters without table : 'A' is added to each one, then
+*                   the distance to the next range of the alphabet for the values above 25, 51, 61 & 62.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_B64_X86_EN == DEF_ENABLED)
+static  void  SMTPc_B64EncGrp_SSE2 (const  CPU_INT08U  *p_src,
+                                           CPU_INT32U   nbr_grp,
+                                           CPU_CHAR    *p_dest)
+{
+    __m128i  in;
+    __m128i  val;
+    __m128i  out;
+
+
+    while (nbr_grp >= 6u) {                                     /* See Note #1.                                         */
+        in  = _mm_loadu_si128((const __m128i *)p_src);
+                                                                /* See Note #2.                                         */
+        in  = _mm_or_si128(_mm_or_si128(_mm_and_si128(                in,     _mm_set_epi32(0, 0, 0, -1)),
+                                        _mm_and_si128(_mm_slli_si128(in, 1), _mm_set_epi32(0, 0, -1, 0))),
+                           _mm_or_si128(_mm_and_si128(_mm_slli_si128(in, 2), _mm_set_epi32(0, -1, 0, 0)),
+                                        _mm_and_si128(_mm_slli_si128(in, 3), _mm_set_epi32(-1, 0, 0, 0))));
+        in  = _mm_or_si128(_mm_slli_epi16(in, 8), _mm_srli_epi16(in, 8));
+        in  = _mm_shufflehi_epi16(_mm_shufflelo_epi16(in, 0xB1), 0xB1);
+
+        val = _mm_or_si128(_mm_or_si128(              _mm_srli_epi32(in, 26),
+                                        _mm_and_si128(_mm_srli_epi32(in, 12), _mm_set1_epi32(0x00003F00))),
+                           _mm_or_si128(_mm_and_si128(_mm_slli_epi32(in,  2), _mm_set1_epi32(0x003F0000)),
+                                        _mm_and_si128(_mm_slli_epi32(in, 16), _mm_set1_epi32(0x3F000000))));
+                                                                /* See Note #3.                                         */
+        out = _mm_add_epi8(val, _mm_set1_epi8('A'));
+        out = _mm_add_epi8(out, _mm_and_si128(_mm_cmpgt_epi8(val, _mm_set1_epi8(25)), _mm_set1_epi8('a' - 'A' - 26)));
+        out = _mm_add_epi8(out, _mm_and_si128(_mm_cmpgt_epi8(val, _mm_set1_epi8(51)), _mm_set1_epi8('0' - 'a' - 26)));
+        out = _mm_add_epi8(out, _mm_and_si128(_mm_cmpgt_epi8(val, _mm_set1_epi8(61)), _mm_set1_epi8('+' - '0' - 10)));
+        out = _mm_add_epi8(out, _mm_and_si128(_mm_cmpeq_epi8(val, _mm_set1_epi8(63)), _mm_set1_epi8('/' - '+' -  1)));
+        _mm_storeu_si128((__m128i *)p_dest, out);
+
+        p_src   += 12u;
+        p_dest  += 16u;
+        nbr_grp -=  4u;
+    }
+
+    SMTPc_B64EncGrp(p_src, nbr_grp, p_dest);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_B64EncGrp_AVX2()
+*
+* Description : Encode groups of 3 octets in base64, without line separators (AVX2 kernel).
+*
+* Argument(s) : p_src           Pointer to the groups.
+*               nbr_grp         Number of groups.
+*               p_dest          Pointer to the buffer receiving the (nbr_grp * 4) characters.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_B64Enc(), through SMTPc_B64EncFnct.
+*
+* Note(s)     : (1) The kernel is compiled for AVX2 whatever the target of the compiler, & only selected
+*                   by SMTPc_B64EncSet() if the CPU supports AVX2.
+*
+*               (2) Eight groups are encoded at a time, from two 16-octet loads 12 octets apart, i.e. as long
+*                   as at least 10 groups are left so that the loads never read past the source.  The other
+*                   groups are encoded by SMTPc_B64EncGrp().
+*
+*               (3) As in W. Mula & D. Lemire's encoder ("Faster Base64 Encoding and Decoding Using AVX2
+*                   Instructions", 2018) : each group is shuffled to 'b1 b0 b2 b1' in its 32-bit lane, so
+*                   that the four 6-bit values are moved to their octet by 16-bit multiplications, then
+*                   translated to characters by a lookup of the offset of their range of the alphabet.
+*********************************************************************************************************
+*/
+
+__attribute__((target("avx2")))                                 /* See Note #1.                                         */
+static  void  SMTPc_B64EncGrp_AVX2 (const  CPU_INT08U  *p_src,
+                                           CPU_INT32U   nbr_grp,
+                                           CPU_CHAR    *p_dest)
+{
+    __m256i  in;
+    __m256i  val;
+    __m256i  out;
+    __m256i  shuf;
+    __m256i  ofs_tbl;
+
+
+    shuf    = _mm256_setr_epi8( 1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7, 10,  9, 11, 10,
+                                1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7, 10,  9, 11, 10);
+    ofs_tbl = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                               '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A',       0,        0,
+                               'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                               '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A',       0,        0);
+
+    while (nbr_grp >= 10u) {                                    /* See Note #2.                                         */
+        in  = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) p_src)),
+                                                             _mm_loadu_si128((const __m128i *)(p_src + 12u)),
+                                      1);
+                                                                /* See Note #3.                                         */
+        in  = _mm256_shuffle_epi8(in, shuf);
+        val = _mm256_or_si256(_mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                                                 _mm256_set1_epi32(0x04000040)),
+                              _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                                                 _mm256_set1_epi32(0x01000010)));
+
+        out = _mm256_subs_epu8(val, _mm256_set1_epi8(51));      /* Range ix : 13 if < 26, 0 if < 52, 1-12 above.        */
+        out = _mm256_or_si256(out, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), val),
+                                                    _mm256_set1_epi8(13)));
+        out = _mm256_add_epi8(val, _mm256_shuffle_epi8(ofs_tbl, out));
+        _mm256_storeu_si256((__m256i *)p_dest, out);
+
+        p_src   += 24u;
+        p_dest  += 32u;
+        nbr_grp -=  8u;
+    }
+
+    SMTPc_B64EncGrp(p_src, nbr_grp, p_dest);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_B64EncGrp_NEON()
+*
+* Description : Encode groups of 3 octets in base64, without line separators (NEON kernel).
+*
+* Argument(s) : p_src           Pointer to the groups.
+*               nbr_grp         Number of groups.
+*               p_dest          Pointer to the buffer receiving the (nbr_grp * 4) characters.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_B64Enc(), through SMTPc_B64EncFnct.
+*
+* Note(s)     : (1) Sixteen groups are encoded at a time : the load de-interleaves the first, second & third
+*                   octets of the groups, the four 6-bit values are computed for the 16 groups at once &
+*                   translated by a lookup in the table of 64 characters, & the store interleaves them.
+*                   The other groups are encoded by SMTPc_B64EncGrp().
+*********************************************************************************************************
+*/
+
+#if (SMTPc_B64_NEON_EN == DEF_ENABLED)
+static  void  SMTPc_B64EncGrp_NEON (const  CPU_INT08U  *p_src,
+                                           CPU_INT32U   nbr_grp,
+                                           CPU_CHAR    *p_dest)
+{
+    uint8x16x4_t  tbl;
+    uint8x16x3_t  in;
+    uint8x16x4_t  out;
+    uint8x16_t    mask;
+
+
+    tbl.val[0] = vld1q_u8((const uint8_t *)&SMTPc_B64EncTbl[ 0]);
+    tbl.val[1] = vld1q_u8((const uint8_t *)&SMTPc_B64EncTbl[16]);
+    tbl.val[2] = vld1q_u8((const uint8_t *)&SMTPc_B64EncTbl[32]);
+    tbl.val[3] = vld1q_u8((const uint8_t *)&SMTPc_B64EncTbl[48]);
+    mask       = vdupq_n_u8(0x3Fu);
+
+    while (nbr_grp >= 16u) {                                    /* See Note #1.                                         */
+        in         = vld3q_u8((const uint8_t *)p_src);
+
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(in.val[0], 4), mask), vshrq_n_u8(in.val[1], 4));
+        out.val[2] = vorrq_u8(vandq_u8(vshlq_n_u8(in.val[1], 2), mask), vshrq_n_u8(in.val[2], 6));
+        out.val[3] = vandq_u8(in.val[2], mask);
+
+        out.val[0] = vqtbl4q_u8(tbl, out.val[0]);
+        out.val[1] = vqtbl4q_u8(tbl, out.val[1]);
+        out.val[2] = vqtbl4q_u8(tbl, out.val[2]);
+        out.val[3] = vqtbl4q_u8(tbl, out.val[3]);
+        vst4q_u8((uint8_t *)p_dest, out);
+
+        p_src   += 48u;
+        p_dest  += 64u;
+        nbr_grp -= 16u;
+    }
+
+    SMTPc_B64EncGrp(p_src, nbr_grp, p_dest);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_TxQP()
+*
+* Description : Encode data in quoted-printable & send it, by pieces.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder, cleared before the first piece.
+*               p_data          Pointer to the piece of data.
+*               len             Length of the piece.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEntity().
+*
+* Note(s)     : (1) See RFC #2045, Section 6.7.  The encoded data is gathered in the transmit buffer of the
+*                   session, as with SMTPc_TxB64().
+*
+*                   (a) Runs of octets that need no escaping are looked up in SMTPc_QPClassTbl[] & copied
+*                       at once, up to the end of the line.
+*
+*                   (b) Encoded lines are at most 76 characters long, including the "=" of a soft line
+*                       break.
+*
+*                   (c) CRLF, bare CR & bare LF are all sent as a line break, as for text.
+*
+*                   (d) A "." beginning a line is escaped, so that the encoded data never needs
+*                       transparency (see 'SMTPc_TxContent()  Note #2').
+*
+*               (2) White space MUST be escaped at the end of a line.  Whether it is cannot be known before
+*                   the next octet, which MAY be in the next piece : white space is hence kept in the state
+*                   until then, like a CR that MAY be followed by a LF.  SMTPc_TxQPEnd() MUST be called
+*                   after the last piece.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxQP (SMTPc_SESSION         *p_sess,
+                          SMTPc_MIME_ENC_STATE  *p_state,
+                          CPU_INT08U            *p_data,
+                          CPU_INT32U             len,
+                          SMTPc_ERR             *perr)
+{
+    CPU_INT08U   c;
+    CPU_INT08U   cls;
+    CPU_INT32U   run_len;
+    CPU_INT32U   run_len_max;
+
+
+   *perr = SMTPc_ERR_NONE;
+    while (len > 0u) {
+        if ((SMTPc_COMM_BUF_LEN - p_state->BufLen) < SMTPc_QP_OUT_MAX_LEN) {
+            SMTPc_TxData(p_sess, p_sess->TxBuf, p_state->BufLen, perr);
+            if (*perr != SMTPc_ERR_NONE) {
+                return;
+            }
+            p_state->BufLen = 0u;
+        }
+
+        c   = *p_data;
+        cls =  SMTPc_QPClassTbl[c];
+                                                                /* ------------------ LINE BREAKS --------------------- */
+        if (p_state->PendCR == DEF_YES) {                       /* See Note #2.                                         */
+            p_state->PendCR = DEF_NO;
+            if (cls == SMTPc_QP_CLASS_LF) {                     /* CRLF.                                                */
+                SMTPc_QPLineEnd(p_sess, p_state);
+                p_data++;
+                len--;
+                continue;
+            }
+            SMTPc_QPLineEnd(p_sess, p_state);                   /* Bare CR (see Note #1c).                              */
+        }
+
+        switch (cls) {
+            case SMTPc_QP_CLASS_CR:
+                 p_state->PendCR = DEF_YES;
+                 p_data++;
+                 len--;
+                 continue;
+
+            case SMTPc_QP_CLASS_LF:                             /* Bare LF (see Note #1c).                              */
+                 SMTPc_QPLineEnd(p_sess, p_state);
+                 p_data++;
+                 len--;
+                 continue;
+
+            default:
+                 break;
+        }
+                                                                /* ---------------- PENDING WHITE SPACE --------------- */
+        if (p_state->CarryLen > 0u) {                           /* Not at end of line, sent as is.                      */
+            p_state->CarryLen = 0u;
+            SMTPc_QPPut(p_sess, p_state, p_state->Carry[0], DEF_NO);
+        }
+
+        switch (cls) {
+            case SMTPc_QP_CLASS_WS:                             /* See Note #2.                                         */
+                 p_state->Carry[0] = c;
+                 p_state->CarryLen = 1u;
+                 p_data++;
+                 len--;
+                 break;
+
+            case SMTPc_QP_CLASS_ESC:
+                 SMTPc_QPPut(p_sess, p_state, c, DEF_YES);
+                 p_data++;
+                 len--;
+                 break;
+
+            case SMTPc_QP_CLASS_SAFE:
+            default:
+                 if ((p_state->LineLen >= SMTPc_QP_LINE_LEN - 1u) ||
+                     (p_state->LineLen == 0u)) {                /* Line full or line start (see Note #1d).              */
+                     SMTPc_QPPut(p_sess, p_state, c, DEF_NO);
+                     p_data++;
+                     len--;
+                     break;
+                 }
+                                                                /* See Note #1a.                                        */
+                 run_len_max = DEF_MIN(len, (SMTPc_QP_LINE_LEN - 1u) - p_state->LineLen);
+                 run_len_max = DEF_MIN(run_len_max, SMTPc_COMM_BUF_LEN - p_state->BufLen);
+                 run_len     = 1u;
+                 while ((run_len < run_len_max) &&
+                        (SMTPc_QPClassTbl[p_data[run_len]] == SMTPc_QP_CLASS_SAFE)) {
+                     run_len++;
+                 }
+                 Mem_Copy(&p_sess->TxBuf[p_state->BufLen], p_data, run_len);
+                 p_state->BufLen  += run_len;
+                 p_state->LineLen += run_len;
+                 p_data           += run_len;
+                 len              -= run_len;
+                 break;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_TxQPEnd()
+*
+* Description : Encode the octets kept by the quoted-printable encoder & send the encoded data not sent yet.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEntity().
+*
+* Note(s)     : (1) The end of the data ends the last line : pending white space is escaped.  The last line
+*                   is not terminated, the multipart delimiter beginning with a CRLF.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxQPEnd (SMTPc_SESSION         *p_sess,
+                             SMTPc_MIME_ENC_STATE  *p_state,
+                             SMTPc_ERR             *perr)
+{
+   *perr = SMTPc_ERR_NONE;
+    if ((SMTPc_COMM_BUF_LEN - p_state->BufLen) < SMTPc_QP_OUT_MAX_LEN) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, p_state->BufLen, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+        p_state->BufLen = 0u;
+    }
+
+    if (p_state->PendCR == DEF_YES) {
+        p_state->PendCR = DEF_NO;
+        SMTPc_QPLineEnd(p_sess, p_state);
+    } else if (p_state->CarryLen > 0u) {                        /* See Note #1.                                         */
+        p_state->CarryLen = 0u;
+        SMTPc_QPPut(p_sess, p_state, p_state->Carry[0], DEF_YES);
+    }
+
+    if (p_state->BufLen > 0u) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, p_state->BufLen, perr);
+        p_state->BufLen = 0u;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_QPPut()
+*
+* Description : Append an octet to the quoted-printable encoded data, inserting a soft line break first if
+*               the line is full.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder.
+*               c               Octet to append.
+*               esc             DEF_YES, to escape the octet as "=XX".
+*                               DEF_NO,  to append it as is.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxQP(),
+*               SMTPc_TxQPEnd(),
+*               SMTPc_QPLineEnd().
+*
+* Note(s)     : (1) The transmit buffer MUST have room for SMTPc_QP_OUT_MAX_LEN characters.
+*
+*               (2) A "." beginning a line is always escaped (see 'SMTPc_TxQP()  Note #1d').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_QPPut (SMTPc_SESSION         *p_sess,
+                           SMTPc_MIME_ENC_STATE  *p_state,
+                           CPU_INT08U             c,
+                           CPU_BOOLEAN            esc)
+{
+    CPU_CHAR    *p_out;
+    CPU_INT32U   len;
+
+
+    len   = (esc == DEF_YES) ? 3u : 1u;
+    p_out = &p_sess->TxBuf[p_state->BufLen];
+    if ((p_state->LineLen + len) > (SMTPc_QP_LINE_LEN - 1u)) {  /* Soft line break.                                     */
+       *p_out++          = '=';
+       *p_out++          = '\r';
+       *p_out++          = '\n';
+        p_state->LineLen = 0u;
+    }
+    if ((p_state->LineLen == 0u) &&                             /* See Note #2.                                         */
+        (c                == '.')) {
+        esc = DEF_YES;
+        len = 3u;
+    }
+
+    if (esc == DEF_YES) {
+       *p_out++ = '=';
+       *p_out++ = SMTPc_QPHexTbl[c >> 4];
+       *p_out++ = SMTPc_QPHexTbl[c & 0x0Fu];
+    } else {
+       *p_out++ = (CPU_CHAR)c;
+    }
+
+    p_state->LineLen += len;
+    p_state->BufLen   = (CPU_INT32U)(p_out - p_sess->TxBuf);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_QPLineEnd()
+*
+* Description : Append a line break to the quoted-printable encoded data.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_state         Pointer to the state of the encoder.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxQP(),
+*               SMTPc_TxQPEnd().
+*
+* Note(s)     : (1) White space before a line break MUST be escaped (see RFC #2045, Section 6.7, rule #3).
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_QPLineEnd (SMTPc_SESSION         *p_sess,
+                               SMTPc_MIME_ENC_STATE  *p_state)
+{
+    if (p_state->CarryLen > 0u) {                               /* See Note #1.                                         */
+        p_state->CarryLen = 0u;
+        SMTPc_QPPut(p_sess, p_state, p_state->Carry[0], DEF_YES);
+    }
+
+    p_sess->TxBuf[p_state->BufLen]      = '\r';
+    p_sess->TxBuf[p_state->BufLen + 1u] = '\n';
+    p_state->BufLen += SMTPc_CRLF_SIZE;
+    p_state->LineLen = 0u;
+}
+
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_SendBody()
+*
+* Description : (1) Send the actual data of the message & validate its acceptance by the server.
+*
+*                   (a) Transmit the message content
+*                   (b) Transmit "end of mail data" indicator
+*                   (c) Receive the confirmation reply
+*                   (d) Reset the transaction, if the message was rejected
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               msg             SMTPc_MSG structure encapsulating the message to send.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_BODY_RD_FAILED            Body could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxMsg().
+*
+* Note(s)     : (2) A BDAT chunk rejected by the server fails the transaction, which MUST be reset (see
+*                   RFC #3030, Section 2).
+*
+*               (3) The indicator is gathered with the end of the content, so that a small message is sent
+*                   in a single segment (see 'SMTPc_TxGather()  Note #1').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SendBody (SMTPc_SESSION  *p_sess,
+                              SMTPc_MSG      *msg,
+                              SMTPc_ERR      *perr)
+{
+    CPU_INT32U  completion_code;
+    CPU_INT32U  len;
+
+
+    SMTPc_TxBody(p_sess, msg, perr);
+    if (*perr == SMTPc_ERR_REP) {                               /* See Note #2.                                         */
+        SMTPc_RSET(p_sess, &completion_code, perr);
+       *perr = SMTPc_ERR_REP;
+    }
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ----------- TX END OF MAIL DATA INDICATOR ---------- */
+    len = SMTPc_BuildEOM(p_sess, 0u);
+    SMTPc_TxGather(p_sess, p_sess->TxBuf, len, perr);           /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+                                                                /* --------------- RX CONFIRMATION REPLY -------------- */
+    completion_code = 0u;
+    SMTPc_RxBodyReply(p_sess, &completion_code, perr);
+    if (*perr == SMTPc_ERR_REP) {
+        if ((completion_code != SMTPc_REP_421) &&
+            (completion_code != SMTPc_REP_221)) {
+            SMTPc_RSET(p_sess, &completion_code, perr);
+        }
+       *perr = SMTPc_ERR_REP;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_RxBodyReply()
+*
+* Description : Receive & validate the reply to the "end of mail data" indicator.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, message accepted.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Message rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SendBody(),
+*               SMTPc_TxBatchPipelined().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_RxBodyReply (SMTPc_SESSION  *p_sess,
+                                 CPU_INT32U     *completion_code,
+                                 SMTPc_ERR      *perr)
+{
+    SMTPc_REPLY  *reply;
+
+
+    reply = SMTPc_RxReply(p_sess, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_RX_FAILED;
+        return;
+    }
+
+    SMTPc_ParseReply(reply, completion_code, perr);
+    if ((*perr            == SMTPc_ERR_REP_POS) &&
+        (*completion_code == SMTPc_REP_250)) {
+        *perr = SMTPc_ERR_NONE;
+    } else {
+        *perr = SMTPc_ERR_REP;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_TxContent()
+*
+* Description : (1) Send message content data, applying the transparency procedure when required.
+*
+*                   (a) Send the data as is,                                  if the content is sent with BDAT
+*                   (b) Dot-stuff the data & normalize its line endings,      otherwise
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_data          Pointer to the data to send.
+*               len             Length of the data.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxEntity().
+*
+* Note(s)     : (2) From RFC #5321, Section 4.5.2, "before sending a line of mail text, the SMTP client
+*                   checks the first character of the line.  If it is a period, one additional period is
+*                   inserted at the beginning of the line".  Otherwise, a line holding a single period
+*                   would end the message early & the leading period of other lines would be removed.
+*
+*               (3) RFC #5321, Section 2.3.8, forbids bare LF characters in the message content.  Each LF
+*                   not preceded by a CR is sent as CRLF.
+*
+*               (4) The data is scanned a word at a time for LF characters (see 'SMTPc_EncScanLF()').  Runs
+*                   of data needing no change are sent straight from the application buffer when they are
+*                   at least SMTPc_ENC_COPY_TH octets long.  Shorter runs & inserted characters are gathered
+*                   in the transmit buffer of the session, whose content is lost.  A content needing no
+*                   change is thus sent without being copied.
+*
+*               (5) The state of the encoder is kept in the session, so the content MAY be sent in several
+*                   pieces.  It MUST be reset at the beginning of the content.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxContent (SMTPc_SESSION  *p_sess,
+                               CPU_CHAR       *p_data,
+                               CPU_INT32U      len,
+                               SMTPc_ERR      *perr)
+{
+    CPU_INT32U   ix;
+    CPU_INT32U   ix_seg;
+    CPU_INT32U   buf_len;
+    CPU_BOOLEAN  cr;
+
+
+    if (SMTPc_BDAT_EN(p_sess) == DEF_YES) {
+        SMTPc_TxData(p_sess, p_data, len, perr);
+        return;
+    }
+
+   *perr = SMTPc_ERR_NONE;
+    if (len == 0u) {
+        return;
+    }
+
+    buf_len = 0u;
+    ix_seg  = 0u;
+    ix      = 0u;
+    if ((DEF_BIT_IS_SET(p_sess->EncState, SMTPc_ENC_STATE_BOL) == DEF_YES) &&
+        (p_data[0] == '.')) {                                   /* See Note #2.                                         */
+        SMTPc_EncPut(p_sess, (CPU_CHAR *)".", 1u, &buf_len, perr);
+    }
+
+    while (*perr == SMTPc_ERR_NONE) {
+        ix = SMTPc_EncScanLF(p_data, ix, len);                  /* See Note #4.                                         */
+        if (ix >= len) {
+            break;
+        }
+                                                                /* ------------------- BARE LF ------------------------ */
+        if (ix > 0u) {
+            cr = (p_data[ix - 1u] == '\r') ? DEF_YES : DEF_NO;
+        } else {
+            cr = DEF_BIT_IS_SET(p_sess->EncState, SMTPc_ENC_STATE_CR);
+        }
+        if (cr == DEF_NO) {                                     /* See Note #3.                                         */
+            SMTPc_EncPut(p_sess, &p_data[ix_seg], ix - ix_seg, &buf_len, perr);
+            if (*perr == SMTPc_ERR_NONE) {
+                SMTPc_EncPut(p_sess, (CPU_CHAR *)"\r", 1u, &buf_len, perr);
+            }
+            ix_seg = ix;                                        /* LF sent with the next run.                           */
+        }
+        ix++;
+                                                                /* ----------------- LEADING PERIOD ------------------- */
+        if ((*perr     == SMTPc_ERR_NONE) &&
+            (ix        <  len)            &&
+            (p_data[ix] == '.')) {                              /* See Note #2.                                         */
+            SMTPc_EncPut(p_sess, &p_data[ix_seg], ix - ix_seg, &buf_len, perr);
+            if (*perr == SMTPc_ERR_NONE) {
+                SMTPc_EncPut(p_sess, (CPU_CHAR *)".", 1u, &buf_len, perr);
+            }
+            ix_seg = ix;                                        /* Period sent with the next run.                       */
+        }
+    }
+                                                                /* ------------------ TX LAST RUN --------------------- */
+    if (*perr == SMTPc_ERR_NONE) {
+        SMTPc_EncPut(p_sess, &p_data[ix_seg], len - ix_seg, &buf_len, perr);
+    }
+    if ((*perr   == SMTPc_ERR_NONE) &&
+        (buf_len >  0u)) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, buf_len, perr);
+    }
+                                                                /* ------------------ SAVE STATE ---------------------- */
+    p_sess->EncState = SMTPc_ENC_STATE_NONE;                    /* See Note #5.                                         */
+    if (p_data[len - 1u] == '\r') {
+        DEF_BIT_SET(p_sess->EncState, SMTPc_ENC_STATE_CR);
+    } else if (p_data[len - 1u] == '\n') {
+        DEF_BIT_SET(p_sess->EncState, SMTPc_ENC_STATE_BOL);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_EncPut()
+*
+* Description : Send or gather a run of encoded message content.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_src           Pointer to the run.
+*               len             Length of the run.
+*               p_buf_len       Pointer to the number of octets gathered in the transmit buffer.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxContent().
+*
+* Note(s)     : (1) The gathered octets are sent first, to preserve the order of the content.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_EncPut (SMTPc_SESSION  *p_sess,
+                            CPU_CHAR       *p_src,
+                            CPU_INT32U      len,
+                            CPU_INT32U     *p_buf_len,
+                            SMTPc_ERR      *perr)
+{
+   *perr = SMTPc_ERR_NONE;
+                                                                /* ---------------- FLUSH TX BUF ---------------------- */
+    if ((*p_buf_len >  0u) &&                                   /* See Note #1.                                         */
+        ((len >= SMTPc_ENC_COPY_TH) || ((*p_buf_len + len) > SMTPc_COMM_BUF_LEN))) {
+        SMTPc_TxData(p_sess, p_sess->TxBuf, *p_buf_len, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return;
+        }
+       *p_buf_len = 0u;
+    }
+                                                                /* ------------------ TX RUN -------------------------- */
+    if (len >= SMTPc_ENC_COPY_TH) {
+        SMTPc_TxData(p_sess, p_src, len, perr);
+        return;
+    }
+
+    Mem_Copy(&p_sess->TxBuf[*p_buf_len], p_src, len);
+   *p_buf_len += len;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_EncScanLF()
+*
+* Description : Find the next LF character in a buffer.
+*
+* Argument(s) : p_data          Pointer to the buffer.
+*               ix              Index of the first character to examine.
+*               len             Length of the buffer.
+*
+* Return(s)   : Index of the next LF character, if any.
+*
+*               'len',                            otherwise.
+*
+* Caller(s)   : SMTPc_TxContent().
+*
+* Note(s)     : (1) Aligned words are examined CPU_DATA octets at a time.  XOR'ing a word with a word of LF
+*                   characters zeroes the octets holding a LF, which are detected with the classic "has zero
+*                   byte" expression :
+*
+*                       (w - 0x01..01) & ~w & 0x80..80
+*
+*                   which is non-zero if & only if one of the octets of 'w' is zero.  The exact position is
+*                   then found octet by octet.
+*
+*               (2) The buffer is an array of characters : each word is copied to a local CPU_DATA rather
+*                   than read through a CPU_DATA pointer, which would break the aliasing rules of C.  GNU
+*                   compilers copy it with a single load.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_EncScanLF (CPU_CHAR    *p_data,
+                                     CPU_INT32U   ix,
+                                     CPU_INT32U   len)
+{
+    CPU_DATA   word;
+    CPU_DATA   ones;
+    CPU_DATA   highs;
+    CPU_DATA   lfs;
+
+
+    ones  = (CPU_DATA)(~(CPU_DATA)0u) / 0xFFu;                  /* 0x01..01                                             */
+    highs =  ones * 0x80u;                                      /* 0x80..80                                             */
+    lfs   =  ones * (CPU_DATA)'\n';                             /* 0x0A..0A                                             */
+                                                                /* ------------------ ALIGN -------------------------- */
+    while ((ix < len) &&
+           (((CPU_ADDR)&p_data[ix] % sizeof(CPU_DATA)) != 0u)) {
+        if (p_data[ix] == '\n') {
+            return (ix);
+        }
+        ix++;
+    }
+                                                                /* --------------- SCAN WORD AT A TIME ---------------- */
+    while ((len - ix) >= sizeof(CPU_DATA)) {                    /* See Note #1.                                         */
+        SMTPc_ENC_WORD_RD(&word, &p_data[ix]);                  /* See Note #2.                                         */
+        word ^= lfs;
+        if (((word - ones) & ~word & highs) != 0u) {
+            break;
+        }
+        ix += sizeof(CPU_DATA);
+    }
+                                                                /* ----------------- SCAN TAIL ------------------------ */
+    while (ix < len) {
+        if (p_data[ix] == '\n') {
+            return (ix);
+        }
+        ix++;
+    }
+
+    return (len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_TxData()
+*
+* Description : (1) Send part of the message content.
+*
+*                   (a) Send the data as is,                    if the DATA command is used
+*                   (b) Send the data as one or more BDAT chunks, otherwise
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_data          Pointer to the data to send.
+*               len             Length of the data.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+*                                                                   ------ RETURNED BY SMTPc_RxBdat() : ------
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxBody(),
+*               SMTPc_TxAttach(),
+*               SMTPc_TxB64Grp(),
+*               SMTPc_TxB64End(),
+*               SMTPc_TxContent(),
+*               SMTPc_EncPut(),
+*               SMTPc_BuildHdr(),
+*               SMTPc_BuildStr().
+*
+* Note(s)     : (2) When the server supports the CHUNKING extension (RFC #3030), the message content is
+*                   sent with BDAT commands.  Each chunk is preceded by its length, so the data never has
+*                   to be scanned for the "end of mail data" indicator & may be sent as is.
+*
+*               (3) Chunks are at most SMTPc_CFG_BDAT_CHUNK_LEN octets long.  When the server also supports
+*                   PIPELINING, up to SMTPc_BDAT_MAX_PEND chunks are sent before waiting for their replies.
+*                   Otherwise, each chunk is replied to before the next one is sent.
+*
+*               (4) Once a chunk is rejected, the server rejects every subsequent chunk of the transaction.
+*                   The outstanding replies are received & no other chunk is sent.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TxData (SMTPc_SESSION  *p_sess,
+                            CPU_CHAR       *p_data,
+                            CPU_INT32U      len,
+                            SMTPc_ERR      *perr)
+{
+#if (SMTPc_CFG_BDAT_CHUNK_LEN > 0u)
+    CPU_CHAR    cmd[SMTPc_BDAT_CMD_BUF_LEN];
+    CPU_INT32U  cmd_len;
+    CPU_INT32U  chunk_len;
+    CPU_INT16U  nbr_pend_max;
+    SMTPc_ERR   err;
+
+
+    if (SMTPc_BDAT_EN(p_sess) == DEF_YES) {                     /* See Note #2.                                         */
+        if (DEF_BIT_IS_SET(p_sess->Caps.Flags, SMTPc_CAP_PIPELINING) == DEF_YES) {
+            nbr_pend_max = SMTPc_BDAT_MAX_PEND - 1u;            /* See Note #3.                                         */
+        } else {
+            nbr_pend_max = 0u;
+        }
+
+        while (len > 0u) {
+            chunk_len = DEF_MIN(len, SMTPc_CFG_BDAT_CHUNK_LEN);
+                                                                /* ------------------ TX BDAT CHUNK ------------------- */
+            Str_Copy(cmd, SMTPc_CMD_BDAT " ");
+            Str_FmtNbr_Int32U(chunk_len,
+                              DEF_INT_32U_NBR_DIG_MAX,
+                              DEF_NBR_BASE_DEC,
+                              (CPU_CHAR)'\0',
+                              DEF_NO,
+                              DEF_YES,
+                             &cmd[sizeof(SMTPc_CMD_BDAT)]);
+            Str_Cat(cmd, SMTPc_CRLF);
+            cmd_len = Str_Len(cmd);
+
+            SMTPc_TxGather(p_sess, cmd, cmd_len, perr);
+            if (*perr == SMTPc_ERR_NONE) {
+                SMTPc_TxGather(p_sess, p_data, chunk_len, perr);
+            }
+            if (*perr != SMTPc_ERR_NONE) {
+               *perr = SMTPc_ERR_TX_FAILED;
+                return;
+            }
+            p_sess->BdatPendCtr++;
+            p_data += chunk_len;
+            len    -= chunk_len;
+                                                                /* ----------------- RX BDAT REPLIES ------------------ */
+            SMTPc_RxBdat(p_sess, nbr_pend_max, perr);
+            if (*perr == SMTPc_ERR_REP) {                       /* See Note #4.                                         */
+                SMTPc_RxBdat(p_sess, 0u, &err);
+                if (err == SMTPc_ERR_RX_FAILED) {
+                   *perr = SMTPc_ERR_RX_FAILED;
+                }
+            }
+            if (*perr != SMTPc_ERR_NONE) {
+                return;
+            }
+        }
+
+       *perr = SMTPc_ERR_NONE;
+        return;
+    }
+#endif
+                                                                /* ---------------------- TX DATA --------------------- */
+    SMTPc_TxGather(p_sess, p_data, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_TX_FAILED;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_RxBdat()
+*
+* Description : Receive & validate the replies to the outstanding BDAT chunks.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               nbr_pend_max    Number of chunks that may remain outstanding.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Chunk(s) rejected.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxData(),
+*               SMTPc_TxBody().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_RxBdat (SMTPc_SESSION  *p_sess,
+                            CPU_INT16U      nbr_pend_max,
+                            SMTPc_ERR      *perr)
+{
+    SMTPc_REPLY  *reply;
+    CPU_INT32U    completion_code;
+    CPU_BOOLEAN   rej;
+
+
+    rej = DEF_NO;
+    while (p_sess->BdatPendCtr > nbr_pend_max) {
+        reply = SMTPc_RxReply(p_sess, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+           *perr = SMTPc_ERR_RX_FAILED;
+            return;
+        }
+        p_sess->BdatPendCtr--;
+
+        completion_code = 0u;
+        SMTPc_ParseReply(reply, &completion_code, perr);
+        if (completion_code != SMTPc_REP_250) {
+             SMTPc_TRACE_DBG(("Error BDAT.  Code: %u\n\r", (unsigned int)completion_code));
+             rej = DEF_YES;
+        }
+    }
+
+    if (rej == DEF_YES) {
+       *perr = SMTPc_ERR_REP;
+    } else {
+       *perr = SMTPc_ERR_NONE;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_BuildEOM()
+*
+* Description : Append the "end of mail data" indicator to the transmit buffer of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf_wr_ix       Index of current "write" position.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_SendBody(),
+*               SMTPc_TxBatchPipelined().
+*
+* Note(s)     : (1) The indicator is NOT sent.
+*
+*               (2) When the message content is sent with BDAT, the last chunk (empty but for a final CRLF)
+*                   carries the LAST parameter.  The message content thus ends exactly as with the DATA
+*                   command, whose "end of mail data" indicator begins with a CRLF.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildEOM (SMTPc_SESSION  *p_sess,
+                                    CPU_INT32U      buf_wr_ix)
+{
+    if (SMTPc_BDAT_EN(p_sess) == DEF_YES) {                     /* See Note #2.                                         */
+        Mem_Copy(&p_sess->TxBuf[buf_wr_ix], SMTPc_BDAT_EOM, SMTPc_BDAT_EOM_SIZE);
+        return (buf_wr_ix + SMTPc_BDAT_EOM_SIZE);
+    }
+
+    Mem_Copy(&p_sess->TxBuf[buf_wr_ix], SMTPc_EOM, SMTPc_EOM_SIZE);
+    return (buf_wr_ix + SMTPc_EOM_SIZE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_TxBatchPipelined()
+*
+* Description : (1) Send several messages using command pipelining.
+*
+*                   (a) Send the "end of mail data" indicator of the previous message, if any, & the envelope
+*                       of the current message as a single group
+*                   (b) Receive the reply to the previous message's data
+*                   (c) Receive the replies to the current message's envelope
+*                   (d) Send the current message content
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               p_msgs          Array of pointers to the messages to send.
+*               nbr_msg         Number of messages in 'p_msgs'.
+*               p_results       Array of 'nbr_msg' variables that will receive the result of each message.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_NOT_CONNECTED             Connection closed.
+*
+* Return(s)   : Index of the first message without a result, if aborted.
+*
+*               'nbr_msg',                                    otherwise.
+*
+* Caller(s)   : SMTPc_SendMsgBatch().
+*
+* Note(s)     : (2) From RFC #2920, Section 3.1, "the actual transfer of message content is explicitly
+*                   allowed to be the first "command" in a group".  The end of a message & the envelope of
+*                   the next one therefore share a single round-trip.
+*
+*               (3) The transaction is over once the "end of mail data" indicator was replied to, whatever
+*                   the reply (see RFC #5321, Section 4.1.1.4).  No RSET command is needed, which would
+*                   otherwise be interleaved with the pipelined commands.
+*
+*               (4) Once a message content was partially sent, the server expects the end of the mail data.
+*                   The connection is closed, which aborts the transaction.
+*
+*               (5) A rejected BDAT chunk ends the data transfer, every outstanding chunk being replied to.
+*                   The transaction is reset & the batch goes on.
+*
+*               (6) A body that could not be read was already aborted (see 'SMTPc_TxEntity()  Note #4').
+*                   The batch goes on unless the connection was closed.
+*
+*               (7) Each message selects DATA or BDAT (see 'SMTPc_TxMsg()  Note #5') once the "end of mail
+*                   data" indicator of the previous message was built.
+*********************************************************************************************************
+*/
+
+static  CPU_INT16U  SMTPc_TxBatchPipelined (SMTPc_SESSION  *p_sess,
+                                            SMTPc_MSG     **p_msgs,
+                                            CPU_INT16U      nbr_msg,
+                                            SMTPc_ERR      *p_results,
+                                            SMTPc_ERR      *perr)
+{
+    SMTPc_MSG    *p_msg;
+    CPU_INT32U    wr_ix;
+    CPU_INT32U    completion_code;
+    CPU_INT16U    i;
+    CPU_INT16U    ix_pend;
+    CPU_BOOLEAN   pend;
+
+
+    pend    = DEF_NO;
+    ix_pend = 0u;
+   *perr    = SMTPc_ERR_NONE;
+    for (i = 0u; i <= nbr_msg; i++) {                           /* Last iteration only completes the last msg.          */
+                                                                /* ------------------ TX GROUP ------------------------ */
+        wr_ix = 0u;
+        if (pend == DEF_YES) {                                  /* See Note #2.                                         */
+            wr_ix = SMTPc_BuildEOM(p_sess, 0u);
+        }
+
+        p_msg = (SMTPc_MSG *)0;
+        if (i < nbr_msg) {
+            SMTPc_MsgChk(p_msgs[i], &p_results[i]);
+            if (p_results[i] == SMTPc_ERR_NONE) {
+                p_msg = p_msgs[i];                              /* See Note #7.                                         */
+                p_sess->DataOnly = (p_msg->RenderBufPtr != (CPU_CHAR *)0) ? DEF_YES : DEF_NO;
+                wr_ix = SMTPc_BuildEnvelope(p_sess, wr_ix, p_msg, perr);
+            }
+        }
+
+        if ((*perr == SMTPc_ERR_NONE) &&
+            (wr_ix >  0u)) {
+            SMTPc_TxGather(p_sess, p_sess->TxBuf, wr_ix, perr);
+        }
+        if (*perr != SMTPc_ERR_NONE) {
+           *perr = SMTPc_ERR_TX_FAILED;
+            break;
+        }
+                                                                /* ------------- RX PREVIOUS MSG RESULT --------------- */
+        if (pend == DEF_YES) {                                  /* See Note #3.                                         */
+            pend = DEF_NO;
+            SMTPc_RxBodyReply(p_sess, &completion_code, &p_results[ix_pend]);
+            if (p_results[ix_pend] == SMTPc_ERR_RX_FAILED) {
+               *perr = SMTPc_ERR_RX_FAILED;
+                break;
+            }
+        }
+
+        if (p_msg == (SMTPc_MSG *)0) {
+            continue;
+        }
+                                                                /* ---------------- RX ENVELOPE REPLIES --------------- */
+        SMTPc_RxEnvelope(p_sess, p_msg, &p_results[i]);
+        if (p_results[i] == SMTPc_ERR_RX_FAILED) {
+           *perr = SMTPc_ERR_RX_FAILED;
+            break;
+        }
+        if (p_sess->SockId == SMTPc_SOCK_ID_NONE) {
+           *perr = SMTPc_ERR_NOT_CONNECTED;
+            i++;                                                /* Msg result already set.                              */
+            break;
+        }
+        if (p_results[i] != SMTPc_ERR_NONE) {
+            continue;
+        }
+                                                                /* ----------------- TX MSG CONTENT ------------------- */
+        SMTPc_TxBody(p_sess, p_msg, &p_results[i]);
+        if (p_results[i] == SMTPc_ERR_REP) {                    /* See Note #5.                                         */
+            SMTPc_RSET(p_sess, &completion_code, perr);
+           *perr = SMTPc_ERR_NONE;
+            continue;
+        }
+        if (p_results[i] == SMTPc_ERR_BODY_RD_FAILED) {         /* See Note #6.                                         */
+            if (p_sess->SockId == SMTPc_SOCK_ID_NONE) {
+               *perr = SMTPc_ERR_NOT_CONNECTED;
+                i++;
+                break;
+            }
+            continue;
+        }
+        if (p_results[i] != SMTPc_ERR_NONE) {                   /* See Note #4.                                         */
+            SMTPc_TransportAPI_Ptr->Close(p_sess->SockId, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+            p_sess->SockId = SMTPc_SOCK_ID_NONE;
+           *perr           = p_results[i];
+            break;
+        }
+        pend    = DEF_YES;
+        ix_pend = i;
+    }
+
+    if (pend == DEF_YES) {                                      /* Previous msg result unknown.                         */
+        p_results[ix_pend] = *perr;
+    }
+
+    return ((i < nbr_msg) ? i : nbr_msg);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_MsgChk()
+*
+* Description : Validate that a message can be sent & clear the results of its recipients.
+*
+* Argument(s) : p_msg           SMTPc_MSG structure encapsulating the message to send.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_NULL_ARG                  No message, sender or recipient.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxMsg(),
+*               SMTPc_TxBatchPipelined(),
+*               SMTPc_AsyncSubmit().
+*
+* Note(s)     : (1) The function SMTPc_SetMsg has to be called before being able to send a message.
+*
+*               (2) The message has to have at least one receiver, either "To", "CC", or "BCC".
+*
+*               (3) Until a reply is received, a recipient has no reply code & may be retried (see 'smtp-c.h
+*                   SMTPc_RCPT_RESULT  Note #1').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_MsgChk (SMTPc_MSG  *p_msg,
+                            SMTPc_ERR  *perr)
+{
+    CPU_INT16U  i;
+
+
+    if (p_msg == (SMTPc_MSG *)0) {
+       *perr = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+                                                                /* See Note #1.                                         */
+    if (p_msg->From == (SMTPc_MBOX *)0) {
+         SMTPc_TRACE_DBG(("Error SMTPc_SendMsg.  NULL from parameter\n\r"));
+        *perr = SMTPc_ERR_NULL_ARG;
+         return;
+    }
+                                                                /* See Note #2.                                         */
+    if ((p_msg->ToArray[0]  == (SMTPc_MBOX *)0) &&
+        (p_msg->CCArray[0]  == (SMTPc_MBOX *)0) &&
+        (p_msg->BCCArray[0] == (SMTPc_MBOX *)0)) {
+         SMTPc_TRACE_DBG(("Error SMTPc_SendMsg.  NULL parameter(s)\n\r"));
+        *perr = SMTPc_ERR_NULL_ARG;
+         return;
+    }
+                                                                /* See Note #3.                                         */
+    Mem_Clr(&p_msg->RcptResultTbl[0], sizeof(p_msg->RcptResultTbl));
+    for (i = 0u; SMTPc_GetRcpt(p_msg, i) != (SMTPc_MBOX *)0; i++) {
+        p_msg->RcptResultTbl[i].Retryable = DEF_YES;
+    }
+
+   *perr = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_GetRcpt()
+*
+* Description : Get a recipient of a message, regardless of whether it is a "To", "CC" or "BCC" recipient.
+*
+* Argument(s) : p_msg           SMTPc_MSG structure encapsulating the message.
+*               ix              Index of the recipient, "To" recipients first, then "CC" & "BCC".
+*
+* Return(s)   : Pointer to the recipient's mailbox, if any.
+*
+*               (SMTPc_MBOX *)0,                    otherwise.
+*
+* Caller(s)   : SMTPc_TxMsg(),
+*               SMTPc_MsgChk(),
+*               SMTPc_BuildEnvelope(),
+*               SMTPc_RxEnvelope(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (1) Each array of recipients ends at the first NULL entry.
+*********************************************************************************************************
+*/
+
+static  SMTPc_MBOX  *SMTPc_GetRcpt (SMTPc_MSG   *p_msg,
+                                    CPU_INT16U   ix)
+{
+    CPU_INT16U  i;
+
+
+    for (i = 0u; (i < SMTPc_CFG_MSG_MAX_TO) && (p_msg->ToArray[i] != (SMTPc_MBOX *)0); i++) {
+        if (ix == 0u) {
+            return (p_msg->ToArray[i]);
+        }
+        ix--;
+    }
+
+    for (i = 0u; (i < SMTPc_CFG_MSG_MAX_CC) && (p_msg->CCArray[i] != (SMTPc_MBOX *)0); i++) {
+        if (ix == 0u) {
+            return (p_msg->CCArray[i]);
+        }
+        ix--;
+    }
+
+    for (i = 0u; (i < SMTPc_CFG_MSG_MAX_BCC) && (p_msg->BCCArray[i] != (SMTPc_MBOX *)0); i++) {
+        if (ix == 0u) {
+            return (p_msg->BCCArray[i]);
+        }
+        ix--;
+    }
+
+    return ((SMTPc_MBOX *)0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_RcptResultSet()
+*
+* Description : Set the result of a recipient of a message from the reply to its RCPT command.
+*
+* Argument(s) : p_msg           SMTPc_MSG structure encapsulating the message being sent.
+*               ix              Index of the recipient (see 'SMTPc_GetRcpt()').
+*               reply           Reply received from the server, NULL if the reply is malformed.
+*
+* Return(s)   : DEF_YES, if the recipient was accepted.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_TxMsg(),
+*               SMTPc_RxEnvelope(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (1) As by SMTPc_RCPT(), replies 250 & 251 are the only positive replies (see 'SMTPc_RCPT()
+*                   Note #4').
+*
+*               (2) A rejected recipient may be retried if the rejection is transient (see 'smtp-c.h
+*                   SMTPc_RCPT_RESULT  Note #3').
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_RcptResultSet (SMTPc_MSG    *p_msg,
+                                          CPU_INT16U    ix,
+                                          SMTPc_REPLY  *reply)
+{
+    SMTPc_RCPT_RESULT  *p_result;
+    CPU_BOOLEAN         accepted;
+
+
+    if ((reply       == (SMTPc_REPLY *)0) ||                    /* Malformed reply, result left unknown.                */
+        (reply->Code == 0u)) {
+        return (DEF_NO);
+    }
+
+    p_result                = &p_msg->RcptResultTbl[ix];
+    p_result->RepCode       =  reply->Code;
+    p_result->StatusClass   =  reply->StatusClass;
+    p_result->StatusSubject =  reply->StatusSubject;
+    p_result->StatusDetail  =  reply->StatusDetail;
+                                                                /* See Note #1.                                         */
+    if ((reply->Code == SMTPc_REP_250) ||
+        (reply->Code == SMTPc_REP_251)) {
+        accepted            = DEF_YES;
+        p_result->Retryable = DEF_NO;
+    } else {                                                    /* See Note #2.                                         */
+        accepted            = DEF_NO;
+        p_result->Retryable = SMTPc_ErrIsTransient(SMTPc_ERR_REP, reply->Code);
+    }
+
+    return (accepted);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_BuildCmd()
+*
+* Description : (1) Append a command to the transmit buffer of the session.
+*
+*                   (a) Send buffered commands, if necessary
+*                   (b) Build command
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf_wr_ix       Index of current "write" position.
+*               cmd             Command name.
+*               param           Parameter keyword preceding the address (e.g. " FROM:<"), if any.
+*               addr            Address argument of the command, if any.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_BuildEnvelope(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (2) The buffered commands are transmitted when the next command does not fit in the
+*                   remaining buffer space.  The group of commands may hence be sent in several segments,
+*                   without waiting for any reply.
+*
+*               (3) The address is enclosed between '<' (part of 'param') and '>'.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildCmd (SMTPc_SESSION *p_sess,
+                                    CPU_INT32U     buf_wr_ix,
+                                    CPU_CHAR      *cmd,
+                                    CPU_CHAR      *param,
+                                    CPU_CHAR      *addr,
+                                    SMTPc_ERR     *perr)
+{
+    CPU_SIZE_T  cmd_len;
+    CPU_SIZE_T  param_len;
+    CPU_SIZE_T  addr_len;
+    CPU_SIZE_T  total_len;
+
+
+                                                                /* ------------- CALCULATE NECESSARY SPACE ------------ */
+    cmd_len   = Str_Len(cmd);
+    param_len = 0u;
+    addr_len  = 0u;
+    if (param != (CPU_CHAR *)0) {
+        param_len = Str_Len(param);
+    }
+    if (addr != (CPU_CHAR *)0) {
+        addr_len  = Str_Len(addr) + 1u;                         /* See Note #3.                                         */
+    }
+    total_len = cmd_len + param_len + addr_len + SMTPc_CRLF_SIZE;
+
+                                                                /* -------------- SEND DATA, IF NECESSARY ------------- */
+    if ((SMTPc_COMM_BUF_LEN - buf_wr_ix) < total_len) {         /* See Note #2.                                         */
+        SMTPc_QueryServer(p_sess, p_sess->TxBuf, buf_wr_ix, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+           *perr = SMTPc_ERR_TX_FAILED;
+            return (buf_wr_ix);
+        }
+        buf_wr_ix = 0u;
+    }
+
+                                                                /* ------------------ BUILDING COMMAND ---------------- */
+    Mem_Copy(&p_sess->TxBuf[buf_wr_ix], cmd, cmd_len);
+    buf_wr_ix += cmd_len;
+    if (param != (CPU_CHAR *)0) {
+        Mem_Copy(&p_sess->TxBuf[buf_wr_ix], param, param_len);
+        buf_wr_ix += param_len;
+    }
+    if (addr != (CPU_CHAR *)0) {
+        Mem_Copy(&p_sess->TxBuf[buf_wr_ix], addr, addr_len - 1u);
+        buf_wr_ix += addr_len - 1u;
+        p_sess->TxBuf[buf_wr_ix] = '>';
+        buf_wr_ix++;
+    }
+    Mem_Copy(&p_sess->TxBuf[buf_wr_ix], SMTPc_CRLF, SMTPc_CRLF_SIZE);
+    buf_wr_ix += SMTPc_CRLF_SIZE;
+
+   *perr = SMTPc_ERR_NONE;
+    return (buf_wr_ix);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_BuildHELO()
+*
+* Description : Build the HELO or EHLO command into the transmit buffer of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               cmd             Command to build :
+*
+*                                   SMTPc_CMD_EHLO
+*                                   SMTPc_CMD_HELO
+*
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Local address could not be formatted.
+*
+* Return(s)   : Length of the command, if NO error.
+*
+*               0,                           otherwise.
+*
+* Caller(s)   : SMTPc_HELO(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (1) The client is identified by the address literal of the local IP address of the
+*                   connection (see 'SMTPc_HELO()  Note #5').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildHELO (SMTPc_SESSION *p_sess,
+                                     CPU_CHAR      *cmd,
+                                     SMTPc_ERR     *perr)
+{
+    CPU_CHAR    client_addr_ascii[SMTPc_TRANSPORT_ADDR_LEN];
+    CPU_INT08U  client_addr_family;
+
+                                                                /* Get the IP address used in the conn.                 */
+    SMTPc_TransportAPI_Ptr->LocalAddrGet(p_sess->SockId,
+                                         client_addr_ascii,
+                                        &client_addr_family,
+                                         perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr = SMTPc_ERR_TX_FAILED;
+        return (0u);
+    }
+                                                                /* Format the message depending of the address family.  */
+    Str_Copy(p_sess->TxBuf, cmd);
+    Str_Cat(p_sess->TxBuf, " [");
+    if (client_addr_family == SMTPc_TRANSPORT_FAMILY_IPv6) {
+        Str_Cat(p_sess->TxBuf, SMTPc_TAG_IPv6);
+        Str_Cat(p_sess->TxBuf, " ");
+    }
+    Str_Cat(p_sess->TxBuf, client_addr_ascii);
+    Str_Cat(p_sess->TxBuf, "]\r\n");
+
+   *perr = SMTPc_ERR_NONE;
+    return (Str_Len(p_sess->TxBuf));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_BuildAUTH()
+*
+* Description : (1) Build the AUTH command into the transmit buffer of the session.
+*
+*                   (a) Encode username & password
+*                   (b) Build command
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               username        Mailbox username name for authentication.
+*               pw              Mailbox password      for authentication.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_ENCODE                    Error encoding credentials.
+*
+* Return(s)   : Length of the command, if NO error.
+*
+*               0,                           otherwise.
+*
+* Caller(s)   : SMTPc_AUTH(),
+*               SMTPc_AsyncReply().
+*
+* Note(s)     : (1) See 'SMTPc_AUTH()  Note #2'.
+*
+*               (2) The credentials are encoded with the encoder also used for attachments (see
+*                   'SMTPc_B64Enc()').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+static  CPU_INT32U  SMTPc_BuildAUTH (SMTPc_SESSION *p_sess,
+                                     CPU_CHAR      *username,
+                                     CPU_CHAR      *pw,
+                                     SMTPc_ERR     *perr)
+{
+    CPU_CHAR     unencoded_buf[SMTPc_ENCODER_BASE54_IN_MAX_LEN];
+    CPU_CHAR     encoded_buf[SMTPc_ENCODER_BASE64_OUT_MAX_LEN];
+    CPU_INT08U   last_grp[3];
+    CPU_INT16U   unencoded_len;
+    CPU_INT16U   nbr_grp;
+    CPU_INT16U   rem_len;
+    CPU_INT32U   encoded_len;
+    CPU_INT16U   wr_ix;
+
+                                                                /* -------------- ENCODE USERNAME & PW ---------------- */
+                                                                /* See Note #1.                                         */
+    wr_ix = 0;
+    unencoded_buf[wr_ix] = SMTPc_ENCODER_BASE64_DELIMITER_CHAR;
+    wr_ix++;
+
+    Str_Copy(&unencoded_buf[wr_ix], username);
+    wr_ix += Str_Len(username);
+
+    unencoded_buf[wr_ix] = SMTPc_ENCODER_BASE64_DELIMITER_CHAR;
+    wr_ix++;
+
+    Str_Copy(&unencoded_buf[wr_ix], pw);
+    unencoded_len = wr_ix + Str_Len(pw);
+
+                                                                /* Base 64 encoding (see Note #2).                      */
+    nbr_grp = unencoded_len / 3u;
+    rem_len = unencoded_len - (nbr_grp * 3u);
+    if ((((CPU_INT32U)nbr_grp + 1u) * 4u) >= SMTPc_ENCODER_BASE64_OUT_MAX_LEN) {
+       *perr = SMTPc_ERR_ENCODE;
+        return (0u);
+    }
+
+    encoded_len = SMTPc_B64Enc((CPU_INT08U *)unencoded_buf, nbr_grp, encoded_buf, DEF_NULL);
+    if (rem_len > 0u) {                                         /* Pad last grp.                                        */
+        Mem_Clr(last_grp, sizeof(last_grp));
+        Mem_Copy(last_grp, &unencoded_buf[nbr_grp * 3u], rem_len);
+        encoded_len += SMTPc_B64Enc(last_grp, 1u, &encoded_buf[encoded_len], DEF_NULL);
+        encoded_buf[encoded_len - 1u] = '=';
+        if (rem_len == 1u) {
+            encoded_buf[encoded_len - 2u] = '=';
+        }
+    }
+    encoded_buf[encoded_len] = '\0';
+
+                                                                /* ------------------- BUILD CMD ---------------------- */
+    Str_Copy(p_sess->TxBuf, SMTPc_CMD_AUTH);
+    Str_Cat(p_sess->TxBuf, " ");
+    Str_Cat(p_sess->TxBuf, SMTPc_CMD_AUTH_MECHANISM_PLAIN);
+    Str_Cat(p_sess->TxBuf, " ");
+    Str_Cat(p_sess->TxBuf, encoded_buf);
+    Str_Cat(p_sess->TxBuf, "\r\n");
+
+   *perr = SMTPc_ERR_NONE;
+    return (Str_Len(p_sess->TxBuf));
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_BuildHdr()
+*
+* Description : (1) Prepare (and send if necessary) the message content's headers.
+*
+*                   (a) Calculate needed space
+*                   (b) Send data, if necessary
+*                   (c) Build header
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf             Buffer used to store the headers prior to their expedition.
+*               buf_size        Size of buffer.
+*               buf_wr_ix       Index of current "write" position.
+*               hdr             Header name.
+*               val             Value associated with header.
+*               line_len        Current line total length.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_SendBody().
+*
+* Note(s)     : (2) If the parameter "hdr" is (CPU_CHAR *)0, et means that it's already been passed in a
+*                   previous call.  Hence, a "," will be inserted in the buffer prior to the value.
+*
+*               (3) If the SMTP line limit is exceeded, perr is set to SMTPc_ERR_LINE_TOO_LONG and the
+*                   function returns without having added the header.
+*
+*               (4) This implementation transmit the headers buffer if the next header is too large to
+*                   be inserted in the remaining buffer space.
+*
+*                   Note that NO EXACT calculations are performed here;  a conservative approach is
+*                   brought forward, without actually optimizing the process (i.e. a buffer could be
+*                   sent even though a few more characters could have been inserted).
+*
+*               (5) CRLF is inserted even though more entries are still to come for a particular header
+*                   (line folding is performed even if unnecessary).
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildHdr (SMTPc_SESSION *p_sess,
+                                    CPU_CHAR      *buf,
+                                    CPU_INT32U     buf_size,
+                                    CPU_INT32U     buf_wr_ix,
+                                    CPU_CHAR      *hdr,
+                                    CPU_CHAR      *val,
+                                    CPU_INT32U    *line_len,
+                                    SMTPc_ERR     *perr)
+{
+    CPU_INT32U  hdr_len;
+    CPU_INT32U  val_len;
+    CPU_INT32U  total_len;
+
+                                                                /* ------------- CALCULATE NECESSARY SPACE ------------ */
+    if (hdr == (CPU_CHAR *)0) {
+        hdr_len = 0;
+    } else {
+        hdr_len = Str_Len(hdr);
+    }
+
+    if (val == (CPU_CHAR *)0) {
+        val_len = 0;
+    } else {
+        val_len = Str_Len(val);
+    }
+
+    total_len = hdr_len + val_len + 2;
+
+    if ((*line_len + total_len) > SMTPc_LINE_LEN_LIM) {         /* See Note #3.                                         */
+       *perr = SMTPc_ERR_LINE_TOO_LONG;
+        return (buf_wr_ix);
+    }
+
+
+
+                                                                /* -------------- SEND DATA, IF NECESSARY ------------- */
+                                                                /* See Note #4.                                         */
+    if ((buf_size - buf_wr_ix) < total_len) {
+        SMTPc_TxData(p_sess, buf, buf_wr_ix, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return buf_wr_ix;
+        }
+        buf_wr_ix = 0;
+    }
+
+
+                                                                /* ------------------ BUILDING HEADER ----------------- */
+    if (hdr != (CPU_CHAR *)0) {
+        Mem_Copy(buf + buf_wr_ix, hdr, hdr_len);
+        buf_wr_ix += hdr_len;
+       *line_len += hdr_len;
+    } else {                                                    /* Not first item, adding ','.                          */
+        Mem_Copy(buf + buf_wr_ix, " ,", 2);
+        buf_wr_ix += 2;
+       *line_len += 2;
+    }
+    if (val != (CPU_CHAR *)0) {
+        Mem_Copy(buf + buf_wr_ix, val, val_len);
+        buf_wr_ix += val_len;
+       *line_len += val_len;
+    }
+
+    Mem_Copy(buf + buf_wr_ix, SMTPc_CRLF, 2);                   /* See Note #5.                                         */
+    buf_wr_ix += 2;
+   *line_len  = 0;
+
+
+    buf[buf_wr_ix] = '\0';
+    SMTPc_TRACE_DBG(("String: %s\n", buf));
+
+   *perr = SMTPc_ERR_NONE;
+    return (buf_wr_ix);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_BuildStr()
+*
+* Description : Append a string to the transmit buffer of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf_wr_ix       Index of current "write" position.
+*               p_str           String to append.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ------ RETURNED BY SMTPc_TxData() : ------
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_TxBody(),
+*               SMTPc_TxAttach(),
+*               SMTPc_BuildContentType().
+*
+* Note(s)     : (1) Nothing is done if 'perr' already holds an error, so that successive calls MAY be
+*                   checked once.
+*
+*               (2) The buffer is sent when the string does not fit, as with SMTPc_BuildHdr().  The string
+*                   MUST NOT be longer than the buffer.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildStr (SMTPc_SESSION  *p_sess,
+                                    CPU_INT32U      buf_wr_ix,
+                                    CPU_CHAR       *p_str,
+                                    SMTPc_ERR      *perr)
+{
+    CPU_INT32U  len;
+
+
+    if (*perr != SMTPc_ERR_NONE) {                              /* See Note #1.                                         */
+        return (buf_wr_ix);
+    }
+
+    len = Str_Len(p_str);
+    if ((SMTPc_COMM_BUF_LEN - buf_wr_ix) < len) {               /* See Note #2.                                         */
+        SMTPc_TxData(p_sess, p_sess->TxBuf, buf_wr_ix, perr);
+        if (*perr != SMTPc_ERR_NONE) {
+            return (buf_wr_ix);
+        }
+        buf_wr_ix = 0u;
+    }
+
+    Mem_Copy(&p_sess->TxBuf[buf_wr_ix], p_str, len);
+
+    return (buf_wr_ix + len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_BuildContentType()
+*
+* Description : Append the Content-Type header field of a MIME entity to the transmit buffer of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf_wr_ix       Index of current "write" position.
+*               p_hdr           Pointer to the MIME header of the entity.
+*               p_type_dflt     Content type used if the entity has none.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ----- RETURNED BY SMTPc_BuildStr() : -----
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_TxBody(),
+*               SMTPc_TxAttach().
+*
+* Note(s)     : (1) The header field is NOT terminated, so that other parameters MAY be appended.
+*
+*               (2) Nothing is done if 'perr' already holds an error (see 'SMTPc_BuildStr()  Note #1').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildContentType (SMTPc_SESSION          *p_sess,
+                                            CPU_INT32U              buf_wr_ix,
+                                            SMTPc_MIME_ENTITY_HDR  *p_hdr,
+                                            CPU_CHAR               *p_type_dflt,
+                                            SMTPc_ERR              *perr)
+{
+    SMTPc_KEY_VAL  *p_param;
+    CPU_INT16U      i;
+
+
+    buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, SMTPc_HDR_CONTENT_TYPE, perr);
+    if (p_hdr->ContentType[0] != '\0') {
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, p_hdr->ContentType, perr);
+    } else {
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, p_type_dflt,        perr);
+    }
+                                                                /* Params, as '; key="val"'.                            */
+    for (i = 0u; i < SMTPc_MIME_MAX_KEYVAL; i++) {
+        p_param = p_hdr->ParamArray[i];
+        if ((p_param         == (SMTPc_KEY_VAL *)0) ||
+            (p_param->Key[0] == '\0')) {
+            continue;
+        }
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, "; ",         perr);
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, p_param->Key, perr);
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, "=\"",        perr);
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, p_param->Val, perr);
+        buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, "\"",         perr);
+    }
+
+    return (buf_wr_ix);
+}
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_BuildContentEnc()
+*
+* Description : Append the Content-Transfer-Encoding header field of a MIME entity to the transmit buffer
+*               of the session.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               buf_wr_ix       Index of current "write" position.
+*               enc             Content transfer encoding, as returned by SMTPc_MIMEEncSel().
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*
+*                                                                   ----- RETURNED BY SMTPc_BuildStr() : -----
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       BDAT chunk rejected.
+*
+* Return(s)   : "Write" position in buffer.
+*
+* Caller(s)   : SMTPc_TxBody(),
+*               SMTPc_TxAttach().
+*
+* Note(s)     : (1) Nothing is done if 'perr' already holds an error (see 'SMTPc_BuildStr()  Note #1').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_BuildContentEnc (SMTPc_SESSION  *p_sess,
+                                           CPU_INT32U      buf_wr_ix,
+                                           CPU_INT08U      enc,
+                                           SMTPc_ERR      *perr)
+{
+    CPU_CHAR  *p_enc;
+
+
+    switch (enc) {
+        case SMTPc_MIME_ENC_BASE64:
+             p_enc = (CPU_CHAR *)"base64";
+             break;
+
+        case SMTPc_MIME_ENC_QP:
+             p_enc = (CPU_CHAR *)"quoted-printable";
+             break;
+
+        default:
+             p_enc = (CPU_CHAR *)"7bit";
+             break;
+    }
+
+    buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, SMTPc_HDR_CONTENT_ENC, perr);
+    buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, p_enc,                 perr);
+    buf_wr_ix = SMTPc_BuildStr(p_sess, buf_wr_ix, SMTPc_CRLF,            perr);
+
+    return (buf_wr_ix);
+}
+
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_MIMEBoundarySet()
+*
+* Description : Build the multipart boundary of the message being sent.
+*
+* Argument(s) : p_sess          Pointer to the session.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TxBody().
+*
+* Note(s)     : (1) The boundary MUST NOT appear in the encapsulated parts (see RFC #2046, Section 5.1.1).
+*                   It begins with "=_", which cannot occur in base64 encoded data, followed by a value
+*                   varying from one message to the next to avoid clashes with forwarded messages.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_MIMEBoundarySet (SMTPc_SESSION  *p_sess)
+{
+    CPU_INT32U  nbr;
+
+
+    nbr = (CPU_INT32U)SMTPc_TS_Get_ms()
+        ^ ((p_sess->Stats.MsgTxCtr + p_sess->Stats.MsgFailCtr) << 20);
+
+    Str_Copy(p_sess->Boundary, SMTPc_MIME_BOUNDARY_PREFIX);     /* See Note #1.                                         */
+    Str_FmtNbr_Int32U(nbr,
+                      8u,
+                      DEF_NBR_BASE_HEX,
+                      '0',
+                      DEF_NO,
+                      DEF_YES,
+                     &p_sess->Boundary[sizeof(SMTPc_MIME_BOUNDARY_PREFIX) - 1u]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_HELO()
+*
+* Description : (1) Build the HELO or EHLO command, send it to the server and validate reply.
+*
+*                   (a) Send command to the server
+*                   (b) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*
+*               cmd             Command to send :
+*
+*                                   SMTPc_CMD_EHLO
+*                                   SMTPc_CMD_HELO
+*
+*               completion_code Numeric value returned by server indicating command status.
+*
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect().
+*
+* Note(s)     : (2) From RFC #2821, "the HELO command is used to identify the SMTP client to the SMTP
+*                   server".  EHLO is used the same way and additionally requests the list of service
+*                   extensions supported by the server (see RFC #1869).
+*
+*               (3) The server will send a 250 "Requested mail action okay, completed" reply upon
+*                   success.  A positive reply is the only reply that will lead to a  "SMTPc_ERR_NONE"
+*                   error return code.
+*
+*               (4) This implementation will accept reply 250, as well as any other positive reply.
+*
+*               (5) From RFC #2821, section 4.1.3 Address Literals:
+*
+*                      For IPv4 addresses, this form uses four small decimal integers separated
+*                      by dots and enclosed by brackets such as [123.255.37.2], which
+*                      indicates an (IPv4) Internet Address in sequence-of-octets form.  For
+*                      IPv6 and other forms of addressing that might eventually be
+*                      standardized, the form consists of a standardized "tag" that
+*                      identifies the address syntax, a colon, and the address itself, in a
+*                      format specified as part of the IPv6 standards.
+*
+*               (6) The command is built by SMTPc_BuildHELO().
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_HELO (SMTPc_SESSION *p_sess,
+                               CPU_CHAR      *cmd,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY     *reply;
+    CPU_SIZE_T       len;
+
+
+    len = SMTPc_BuildHELO(p_sess, cmd, perr);                   /* See Notes #5 & #6.                                   */
+    if (*perr != SMTPc_ERR_NONE) {
+        return ((SMTPc_REPLY *)0);
+    }
+                                                                /* Send HELO/EHLO Query.                                */
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* --------- RX SERVER'S REPLY & VALIDATE ------------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
+    switch (*perr) {
+        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
+            *perr = SMTPc_ERR_NONE;                             /* ... no err.                                          */
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SMTPc_AUTH()
+*
+* Description : (1) Build the AUTH command, send it to the server and validate reply.
+*
+*                   (a) Encode username & password
+*                   (b) Send command to the server
+*                   (c) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess           Pointer to the session.
+*               username         Mailbox username name for authentication.
+*               pw               Mailbox password      for authentication.
+*               completion_code  Numeric value returned by server indicating command status.
+*               perr             Pointer to variable that will hold the return error code from this
+*                                function :
+*
+*                                SMTPc_ERR_NONE                     No error.
+*                                SMTPc_ERR_TX_FAILED                Error querying server.
+*                                SMTPc_ERR_RX_FAILED                Error receiving server reply.
+*                                SMTPc_ERR_REP                      Error with reply.
+*                                SMTPc_ERR_ENCODE                   Error encoding credentials.
+*                                SMTPc_ERR_AUTH_FAILED              Error authenticating user.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect().
+*
+* Note(s)     : (2) The user's credentials are transmitted to the server using a base 64 encoding and
+*                   formated according to RFC #4616.  From Section 2 'PLAIN SALS Mechanism' "The client
+*                   presents the authorization identity (identity to act as), followed by a NUL (U+0000)
+*                   character, followed by the authentication identity (identity whose password will be
+*                   used), followed by a NUL (U+0000) character, followed by the clear-text password.
+*                   As with other SASL mechanisms, the client does not provide an authorization identity
+*                   when it wishes the server to derive an identity from the credentials and use that
+*                   as the authorization identity."
+*
+*               (3) The server will send a 235 "Authentication successful" reply upon success.  A positive
+*                   reply is the only reply that will lead to a  "SMTPc_ERR_NONE" error return code.
+*
+*               (4) This implementation will accept reply 235, as well as any other positive reply.
+*
+*               (5) The command is built by SMTPc_BuildAUTH().
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+static  SMTPc_REPLY  *SMTPc_AUTH (SMTPc_SESSION *p_sess,
+                               CPU_CHAR      *username,
+                               CPU_CHAR      *pw,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY *reply;
+    CPU_SIZE_T   len;
+
+
+    len = SMTPc_BuildAUTH(p_sess, username, pw, perr);          /* See Note #5.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+        return ((SMTPc_REPLY *)0);
+    }
+
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+
+    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
+    switch (*perr) {
+        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
+            *perr = SMTPc_ERR_NONE;                             /* ... no err.                                          */
+             break;
+
+        case SMTPc_ERR_REP_NEG:
+             if (*completion_code == SMTPc_REP_535) {
+                *perr = SMTPc_ERR_AUTH_FAILED;
+             } else {
+                *perr = SMTPc_ERR_REP;
+             }
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_MAIL()
+*
+* Description : (1) Build the MAIL command, send it to the server and validate reply.
+*
+*                   (a) Send command to the server
+*                   (b) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               from            Argument of the "MAIL" command (sender mailbox).
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_TxMsg().
+*
+* Note(s)     : (2) From RFC #2821, "the MAIL command is used to initiate a mail transaction in which
+*                   the mail data is delivered to an SMTP server [...]".
+*
+*               (3) The server will send a 250 "Requested mail action okay, completed" reply upon
+*                   success.  A positive reply is the only reply that will lead to a  "SMTPc_ERR_NONE"
+*                   error return code.
+*
+*               (4) This implementation will accept reply 250, as well as any other positive reply.
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_MAIL (SMTPc_SESSION *p_sess,
+                               CPU_CHAR      *from,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY *reply;
+    CPU_SIZE_T   len;
+
+                                                                /* ----------------- TX CMD TO SERVER ----------------- */
+    Str_Copy(p_sess->TxBuf, SMTPc_CMD_MAIL);
+    Str_Cat(p_sess->TxBuf, " FROM:<");
+    Str_Cat(p_sess->TxBuf, from);
+    Str_Cat(p_sess->TxBuf, ">\r\n");
+
+    len = Str_Len(p_sess->TxBuf);
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+
+    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
+    switch (*perr) {
+        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
+            *perr = SMTPc_ERR_NONE;                             /* ... no err.                                          */
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_RCPT()
+*
+* Description : (1) Build the RCPT command, send it to the server and validate reply.
+*
+*                   (a) Send command to the server
+*                   (b) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               to              Argument of the "RCPT" command (receiver mailbox).
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_TxMsg().
+*
+* Note(s)     : (2) From RFC #2821, "the RCPT command is used to identify an individual recipient of the
+*                   mail data; multiple recipients are specified by multiple use of this command".
+*
+*               (3) The server will send a 250 "Requested mail action okay, completed"  or a 251 "User
+*                   not local; will forwarded to <forward-path>" reply upon success.
+*
+*               (4) This implementation will accept replies 250 and 251 as positive replies.  Reply 551
+*                   "User not local; please try <forward-path>" will result in an error.
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_RCPT (SMTPc_SESSION *p_sess,
+                               CPU_CHAR      *to,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY *reply;
+    CPU_SIZE_T   len;
+
+                                                                /* ----------------- TX CMD TO SERVER ----------------- */
+    Str_Copy(p_sess->TxBuf, SMTPc_CMD_RCPT);
+    Str_Cat(p_sess->TxBuf, " TO:<");
+    Str_Cat(p_sess->TxBuf, to);
+    Str_Cat(p_sess->TxBuf, ">\r\n");
+
+    len = Str_Len(p_sess->TxBuf);
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
+    switch (*perr) {
+        case SMTPc_ERR_REP_POS:
+             if ((*completion_code == SMTPc_REP_250) ||
+                 (*completion_code == SMTPc_REP_251)) {
+                *perr = SMTPc_ERR_NONE;
+             } else {
+                *perr = SMTPc_ERR_REP;
+             }
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_DATA()
+*
+* Description : (1) Build the DATA command, send it to the server and validate reply.
+*
+*                   (a) Send command to the server
+*                   (b) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_TxMsg().
+*
+* Note(s)     : (2) The DATA command is used to indicate to the SMTP server that all the following lines
+*                   up to but not including the end of mail data indicator are to be considered as the
+*                   message text.
+*
+*               (3) The receiver normally sends a 354 "Start mail input" reply and then treats the lines
+*                   following the command as mail data from the sender.
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_DATA (SMTPc_SESSION *p_sess,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY *reply;
+    CPU_SIZE_T   len;
+
+                                                                /* ----------------- TX CMD TO SERVER ----------------- */
+    Str_Copy(p_sess->TxBuf, SMTPc_CMD_DATA);
+    Str_Cat(p_sess->TxBuf, "\r\n");
+
+
+    len = Str_Len(p_sess->TxBuf);
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+    SMTPc_ParseReply(reply, completion_code, perr);
+    switch (*perr) {
+        case SMTPc_ERR_REP_INTER:
+             if (*completion_code == SMTPc_REP_354) {
+                *perr = SMTPc_ERR_NONE;
+             } else {
+                *perr = SMTPc_ERR_REP;
+             }
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_RSET()
+*
+* Description : (1) Build the RSET command, send it to the server and validate reply.
+*
+*                   (a) Send command to the server
+*                   (b) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_TxMsg(),
+*               SMTPc_TxEnvelopePipelined().
+*
+* Note(s)     : (2) From RFC #2821, "the RSET command specifies that the current mail transaction will
+*                   be aborted.  Any stored sender, recipients, and mail data MUST be discarded, and all
+*                   buffers and state tables cleared".
+*
+*               (3) The server MUST send a 250 "Requested mail action okay, completed" reply to a RSET
+*                   command with no arguments.
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_RSET (SMTPc_SESSION *p_sess,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY *reply;
+    CPU_SIZE_T   len;
+
+                                                                /* ----------------- TX CMD TO SERVER ----------------- */
+    Str_Copy(p_sess->TxBuf, SMTPc_CMD_RSET);
+    Str_Cat(p_sess->TxBuf, "\r\n");
+
+    len = Str_Len(p_sess->TxBuf);
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+    SMTPc_ParseReply(reply, completion_code, perr);
+    switch (*perr) {
+        case SMTPc_ERR_REP_POS:
+             if (*completion_code == SMTPc_REP_250) {
+                *perr = SMTPc_ERR_NONE;
+             } else {
+                *perr = SMTPc_ERR_REP;
+             }
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             SMTPc_QUIT()
+*
+* Description : (1) Build the QUIT command, send it to the server and validate reply.
+*
+*                   (a) Send command to the server
+*                   (b) Receive server's reply and validate
+*
+*
+* Argument(s) : p_sess          Pointer to the session.
+*               completion_code Numeric value returned by server indicating command status.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                               SMTPc_ERR_REP                       Error with reply.
+*
+* Return(s)   : Pointer to the reply received from the server, if NO reception error.
+*
+*               (SMTPc_REPLY *)0,                                otherwise.
+*
+* Caller(s)   : SMTPc_Disconnect().
+*
+* Note(s)     : (2) From RFC #2821, "the QUIT command specifies that the receiver MUST send an OK reply,
+*                   and then close the transmission channel.  The receiver MUST NOT intentionally close
+*                   the transmission channel until it receives and replies to a QUIT command (even if
+*                   there was an error).  the sender MUST NOT intentionally close the transmission
+*                   channel until it sends a QUIT command and SHOULD wait until it receives the reply
+*                   (even if there was an error response to a previous command)".
+*
+*               (3) The server MUST send a 221 "Service closing transmission channel" reply to a QUIT
+*                   command.
+*********************************************************************************************************
+*/
+
+static  SMTPc_REPLY  *SMTPc_QUIT (SMTPc_SESSION *p_sess,
+                               CPU_INT32U    *completion_code,
+                               SMTPc_ERR     *perr)
+{
+    SMTPc_REPLY *reply;
+    CPU_SIZE_T   len;
+
+                                                                /* ----------------- TX CMD TO SERVER ----------------- */
+    Str_Copy(p_sess->TxBuf, SMTPc_CMD_QUIT);
+    Str_Cat(p_sess->TxBuf, "\r\n");
+    len = Str_Len(p_sess->TxBuf);
+
+    SMTPc_QueryServer(p_sess, p_sess->TxBuf, len, perr);
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_TX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
+    reply = SMTPc_RxReply(p_sess, perr);                        /* See Note #3.                                         */
+    if (*perr != SMTPc_ERR_NONE) {
+       *perr  = SMTPc_ERR_RX_FAILED;
+        return ((SMTPc_REPLY *)0);
+    }
+
+    SMTPc_ParseReply(reply, completion_code, perr);
+    switch (*perr) {
+        case SMTPc_ERR_REP_POS:
+             if (*completion_code == SMTPc_REP_221) {
+                *perr = SMTPc_ERR_NONE;
+             } else {
+                *perr = SMTPc_ERR_REP;
+             }
+             break;
+
+        case SMTPc_ERR_REP_TOO_SHORT:
+            *perr = SMTPc_ERR_REP;
+             reply = (SMTPc_REPLY *)0;
+             break;
+
+        default:
+            *perr = SMTPc_ERR_REP;
+             break;
+    }
+
+    return (reply);
+}
+
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+/*
+*********************************************************************************************************
+*                                          SMTPc_AsyncStep()
+*
+* Description : (1) Make a job progress by one step.
+*
+*                   (a) Open the connection, if not done yet
+*                   (b) Transmit pending data, if any
+*                   (c) Otherwise, receive the next reply & act upon it
+*                   (d) Close the connection, if the job is over
+*
+*
+* Argument(s) : p_async         Pointer to the job.
+*
+*               p_blocked       Pointer to variable that will receive DEF_YES if the step waited for the
+*                               server, DEF_NO if it made progress.
+*
+* Return(s)   : DEF_YES, if the job is over.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_AsyncRun(),
+*               SMTPc_Poll().
+*
+* Note(s)     : (2) A job that makes no progress for SMTPc_CFG_ASYNC_TIMEOUT_MS is aborted.
+*
+*               (3) Once the server replied to the message content, the result of the job is known; a
+*                   failure of the QUIT exchange does not change it.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_AsyncStep (SMTPc_ASYNC  *p_async,
+                                      CPU_BOOLEAN  *p_blocked)
+{
+    SMTPc_SESSION  *p_sess;
+    SMTPc_REPLY    *reply;
+    SMTPc_ERR       err;
+
+
+    p_sess     = &p_async->Sess;
+   *p_blocked  =  DEF_NO;
+                                                                /* ---------------------- CONNECT --------------------- */
+    if (p_async->State == SMTPc_ASYNC_STATE_CONN) {
+        SMTPc_AsyncConn(p_async, &err);
+        if (err != SMTPc_ERR_NONE) {
+            p_async->Err = err;
+            SMTPc_AsyncEnd(p_async);
+            return (DEF_YES);
+        }
+        return (DEF_NO);
+    }
+                                                                /* ------------------ TX PENDING DATA ----------------- */
+    if ((p_async->State == SMTPc_ASYNC_STATE_CONTENT) &&
+        (p_async->TxLen == 0u)) {                               /* Content tx'd, end it.                                */
+        p_async->TxPtr  = (CPU_CHAR *)SMTPc_EOM;
+        p_async->TxLen  = SMTPc_EOM_SIZE;
+        p_async->State  = SMTPc_ASYNC_STATE_EOM;
+    }
+
+    if (p_async->TxLen > 0u) {
+        SMTPc_AsyncTx(p_async, &err);
+    } else {
+                                                                /* --------------------- RX REPLY --------------------- */
+        reply = SMTPc_RxReply(p_sess, &err);
+        if (err == SMTPc_ERR_NONE) {
+            p_async->TS = SMTPc_TS_Get_ms();
+            SMTPc_AsyncReply(p_async, reply, &err);
+        }
+    }
+
+    if (err == SMTPc_ERR_WOULD_BLOCK) {                         /* See Note #2.                                         */
+        if ((SMTPc_TS_MS)(SMTPc_TS_Get_ms() - p_async->TS) < SMTPc_CFG_ASYNC_TIMEOUT_MS) {
+           *p_blocked = DEF_YES;
+            return (DEF_NO);
+        }
+        err = SMTPc_ERR_TIMEOUT;
+    }
+                                                                /* --------------------- END JOB ---------------------- */
+    if (err != SMTPc_ERR_NONE) {
+        if (p_async->State != SMTPc_ASYNC_STATE_QUIT) {         /* See Note #3.                                         */
+            p_async->Err = err;
+        }
+        p_async->State = SMTPc_ASYNC_STATE_IDLE;
+    }
+
+    if (p_async->State != SMTPc_ASYNC_STATE_IDLE) {
+        return (DEF_NO);
+    }
+
+    SMTPc_AsyncEnd(p_async);
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_AsyncConn()
+*
+* Description : Open the connection of a job to its server.
+*
+* Argument(s) : p_async         Pointer to the job.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Error connecting to server.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          No secure mode available.
+*                               SMTPc_ERR_NOT_INIT                  No transport set.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_AsyncStep().
+*
+* Note(s)     : (1) See 'SMTPc_Poll()  Note #4'.
+*
+*               (2) The socket is then configured as non-blocking, so that the replies are only read
+*                   once available (see 'SMTPc_RxReply()  Note #6'), & the session marked as such.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_AsyncConn (SMTPc_ASYNC  *p_async,
+                               SMTPc_ERR    *perr)
+{
+    SMTPc_SOCK_ID  sock_id;
+
+                                                                /* ----------------- OPEN CLIENT STREAM --------------- */
+    if (SMTPc_TransportAPI_Ptr == (const SMTPc_TRANSPORT_API *)0) {
+       *perr = SMTPc_ERR_NOT_INIT;
+        return;
+    }
+                                                                /* See Note #1.                                         */
+    sock_id = SMTPc_TransportAPI_Ptr->Open(p_async->HostNamePtr,
+                                           p_async->Port,
+                                           p_async->SecureCfgPtr,
+                                           SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK,
+                                           perr);
+    if (*perr != SMTPc_ERR_NONE) {
+        return;
+    }
+                                                                /* ---------------- CFG SOCK BLOCK OPT ---------------- */
+    SMTPc_TransportAPI_Ptr->DeadlineSet(sock_id, SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, perr);
+    if (*perr != SMTPc_ERR_NONE) {                              /* See Note #2.                                         */
+        SMTPc_TransportAPI_Ptr->Close(sock_id, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+       *perr = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+
+    p_async->Sess.SockId  = sock_id;
+    p_async->Sess.NoBlock = DEF_YES;
+    p_async->State        = SMTPc_ASYNC_STATE_GREETING;
+    p_async->TS           = SMTPc_TS_Get_ms();
+
+   *perr = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_AsyncTx()
+*
+* Description : Transmit the pending data of a job, as much as the socket accepts.
+*
+* Argument(s) : p_async         Pointer to the job.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data (partially) tx'd.
+*                               SMTPc_ERR_WOULD_BLOCK               Socket transmit queue full.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_AsyncStep().
+*
+* Note(s)     : (1) The transport may transmit part of the data only; the rest is transmitted on the next
+*                   steps.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_AsyncTx (SMTPc_ASYNC  *p_async,
+                             SMTPc_ERR    *perr)
+{
+    CPU_INT32U  tx_len;
+
+
+    tx_len = SMTPc_TransportAPI_Ptr->Tx(p_async->Sess.SockId,
+                                        p_async->TxPtr,
+                                        p_async->TxLen,
+                                        perr);
+    if (*perr == SMTPc_ERR_NONE) {                              /* See Note #1.                                         */
+        p_async->TxPtr                 += tx_len;
+        p_async->TxLen                 -= tx_len;
+        p_async->Sess.Stats.OctetTxCtr += tx_len;
+        p_async->TS                     = SMTPc_TS_Get_ms();
+    } else if (*perr != SMTPc_ERR_WOULD_BLOCK) {                /* Transitory err, retry on next step.                  */
+       *perr = SMTPc_ERR_TX_FAILED;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_AsyncReply()
+*
+* Description : Act upon a reply received by a job, & build the next command.
+*
+* Argument(s) : p_async         Pointer to the job.
+*               reply           Reply received from the server.
+*               perr            Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_REP                       Error with greeting or HELO reply.
+*                               SMTPc_ERR_TX_FAILED                 Local address could not be formatted.
+*
+*                                                                   ------ RETURNED BY SMTPc_BuildAUTH : ------
+*                               SMTPc_ERR_ENCODE                    Error encoding credentials.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_AsyncStep().
+*
+* Note(s)     : (1) The replies are validated as by the synchronous functions (see 'SMTPc_SessionConnect()
+*                   Note #7' & 'SMTPc_TxMsg()').  The capabilities cache is not used.
+*
+*               (2) A negative reply ends the job : its result is set & the QUIT command is sent (see
+*                   'SMTPc_QUIT()  Note #2').
+*
+*               (3) Each recipient, "To", "CC" & "BCC", is sent in its own RCPT command.
+*
+*               (4) A rejected recipient is skipped when partial delivery is enabled (see 'SMTPc_TxMsg()
+*                   Note #6').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_AsyncReply (SMTPc_ASYNC  *p_async,
+                                SMTPc_REPLY  *reply,
+                                SMTPc_ERR    *perr)
+{
+    SMTPc_SESSION  *p_sess;
+    SMTPc_MSG      *p_msg;
+    SMTPc_MBOX     *p_rcpt;
+    CPU_INT32U      completion_code;
+    CPU_INT32U      len;
+    CPU_BOOLEAN     tx_mail;
+    CPU_BOOLEAN     tx_rcpt;
+    SMTPc_ERR       err_rep;
+
+
+    p_sess          = &p_async->Sess;
+    completion_code =  0u;
+    tx_mail         =  DEF_NO;
+    tx_rcpt         =  DEF_NO;
+    SMTPc_ParseReply(reply, &completion_code, &err_rep);
+
+    switch (p_async->State) {
+        case SMTPc_ASYNC_STATE_GREETING:
+             if (err_rep != SMTPc_ERR_REP_POS) {
+                *perr = SMTPc_ERR_REP;
+                 return;
+             }
+             len = SMTPc_BuildHELO(p_sess, SMTPc_CMD_EHLO, perr);
+             if (*perr != SMTPc_ERR_NONE) {
+                 return;
+             }
+             SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_EHLO, len);
+             return;
+
+
+        case SMTPc_ASYNC_STATE_EHLO:
+        case SMTPc_ASYNC_STATE_HELO:
+             if (err_rep == SMTPc_ERR_REP_POS) {
+                 if (p_async->State == SMTPc_ASYNC_STATE_EHLO) {
+                     SMTPc_ParseCaps(reply, &p_sess->Caps);
+                 }
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+                 len = SMTPc_BuildAUTH(p_sess, p_async->UsernamePtr, p_async->PwdPtr, perr);
+                 if (*perr != SMTPc_ERR_NONE) {
+                     return;
+                 }
+                 SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_AUTH, len);
+                 return;
+#else
+                 tx_mail = DEF_YES;
+                 break;
+#endif
+             }
+             if ((p_async->State        == SMTPc_ASYNC_STATE_EHLO) &&
+                 ((completion_code / 100) == SMTPc_REP_NEG_COMPLET_GRP)) {
+                 Mem_Clr(&p_sess->Caps, sizeof(p_sess->Caps));  /* EHLO rejected, fall back to HELO.                    */
+                 len = SMTPc_BuildHELO(p_sess, SMTPc_CMD_HELO, perr);
+                 if (*perr != SMTPc_ERR_NONE) {
+                     return;
+                 }
+                 SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_HELO, len);
+                 return;
+             }
+             p_async->Err = SMTPc_ERR_REP;                      /* See Note #2.                                         */
+             break;
+
+
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+        case SMTPc_ASYNC_STATE_AUTH:
+             if (err_rep == SMTPc_ERR_REP_POS) {
+                 tx_mail = DEF_YES;
+             } else if (completion_code == SMTPc_REP_535) {
+                 p_async->Err = SMTPc_ERR_AUTH_FAILED;
+             } else {
+                 p_async->Err = SMTPc_ERR_REP;
+             }
+             break;
+#endif
+
+
+        case SMTPc_ASYNC_STATE_MAIL:
+             if (err_rep != SMTPc_ERR_REP_POS) {
+                 p_async->Err = SMTPc_ERR_REP;
+                 break;
+             }
+             tx_rcpt = DEF_YES;
+             break;
+
+
+        case SMTPc_ASYNC_STATE_RCPT:
+             p_msg = p_async->MsgPtr;
+             if (SMTPc_RcptResultSet(p_msg, p_async->RcptIx, reply) == DEF_YES) {
+                 p_async->RcptOkCtr++;
+             } else if ((p_msg->RcptPartialEn != DEF_YES) ||    /* See Note #4.                                         */
+                        (completion_code      == SMTPc_REP_421)) {
+                 p_async->Err = SMTPc_ERR_REP;
+                 break;
+             }
+             p_async->RcptIx++;
+             tx_rcpt = DEF_YES;
+             break;
+
+
+        case SMTPc_ASYNC_STATE_DATA:
+             if (err_rep != SMTPc_ERR_REP_INTER) {
+                 p_async->Err = SMTPc_ERR_REP;
+                 break;
+             }
+             p_async->TxPtr = p_async->MsgPtr->RenderBufPtr;
+             p_async->TxLen = p_async->MsgPtr->RenderLen;
+             p_async->State = SMTPc_ASYNC_STATE_CONTENT;
+            *perr = SMTPc_ERR_NONE;
+             return;
+
+
+        case SMTPc_ASYNC_STATE_EOM:
+             if (err_rep != SMTPc_ERR_REP_POS) {
+                 p_async->Err = SMTPc_ERR_REP;
+             } else {
+                 p_async->Err = SMTPc_ERR_NONE;
+             }
+             break;
+
+
+        case SMTPc_ASYNC_STATE_QUIT:
+        default:
+             p_async->State = SMTPc_ASYNC_STATE_IDLE;
+            *perr = SMTPc_ERR_NONE;
+             return;
+    }
+
+                                                                /* ------------------- TX MAIL CMD -------------------- */
+    if (tx_mail == DEF_YES) {                                   /* Session initiated.                                   */
+        len = SMTPc_BuildCmd(p_sess, 0u, SMTPc_CMD_MAIL, " FROM:<", p_async->MsgPtr->From->Addr, perr);
+        SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_MAIL, len);
+        return;
+    }
+                                                                /* ---------------- TX RCPT OR DATA CMD --------------- */
+    if (tx_rcpt == DEF_YES) {
+        p_rcpt = SMTPc_GetRcpt(p_async->MsgPtr, p_async->RcptIx);
+        if (p_rcpt != (SMTPc_MBOX *)0) {                        /* See Note #3.                                         */
+            len = SMTPc_BuildCmd(p_sess, 0u, SMTPc_CMD_RCPT, " TO:<", p_rcpt->Addr, perr);
+            SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_RCPT, len);
+            return;
+        }
+        if (p_async->RcptOkCtr > 0u) {
+            len = SMTPc_BuildCmd(p_sess, 0u, SMTPc_CMD_DATA, DEF_NULL, DEF_NULL, perr);
+            SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_DATA, len);
+            return;
+        }
+        p_async->Err = SMTPc_ERR_REP;                           /* No rcpt accepted (see Note #4).                      */
     }
+                                                                /* ------------------- TX QUIT CMD -------------------- */
+    len = SMTPc_BuildCmd(p_sess, 0u, SMTPc_CMD_QUIT, DEF_NULL, DEF_NULL, perr);
+    SMTPc_AsyncCmd(p_async, SMTPc_ASYNC_STATE_QUIT, len);       /* See Note #2.                                         */
+}
 
 
-    if (msg->Subject != (CPU_CHAR *)0) {                        /* Header "Subject: ".                                  */
-        cur_wr_ix = SMTPc_BuildHdr((NET_SOCK_ID ) sock_id,
-                                   (CPU_CHAR   *) SMTPc_Comm_Buf,
-                                   (CPU_INT32U  ) SMTPc_COMM_BUF_LEN,
-                                   (CPU_INT32U  ) cur_wr_ix,
-                                   (CPU_CHAR   *) SMTPc_HDR_SUBJECT,
-                                   (CPU_CHAR   *) msg->Subject,
-                                   (CPU_INT32U *)&line_len,
-                                   (SMTPc_ERR  *) perr);
-        if (*perr != SMTPc_ERR_NONE) {
-            return;
+/*
+*********************************************************************************************************
+*                                           SMTPc_AsyncCmd()
+*
+* Description : Queue the command built in the transmit buffer of a job's session.
+*
+* Argument(s) : p_async         Pointer to the job.
+*               state           State of the job once the command is queued.
+*               len             Length of the command.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_AsyncReply().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_AsyncCmd (SMTPc_ASYNC  *p_async,
+                              CPU_INT08U    state,
+                              CPU_INT32U    len)
+{
+    p_async->TxPtr = p_async->Sess.TxBuf;
+    p_async->TxLen = len;
+    p_async->State = state;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           SMTPc_AsyncEnd()
+*
+* Description : Close the connection of a job that is over & account for its result.
+*
+* Argument(s) : p_async         Pointer to the job.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_AsyncStep().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_AsyncEnd (SMTPc_ASYNC  *p_async)
+{
+    SMTPc_SESSION  *p_sess;
+
+
+    p_sess = &p_async->Sess;
+    if (p_sess->SockId != SMTPc_SOCK_ID_NONE) {
+        SMTPc_TransportAPI_Ptr->Close(p_sess->SockId, SMTPc_CFG_MAX_CONN_CLOSE_TIMEOUT_MS);
+        p_sess->SockId = SMTPc_SOCK_ID_NONE;
+    }
+
+    if (p_async->Err == SMTPc_ERR_NONE) {
+        p_sess->Stats.MsgTxCtr++;
+    } else {
+        p_sess->Stats.MsgFailCtr++;
+    }
+
+    p_async->State = SMTPc_ASYNC_STATE_IDLE;
+    p_async->TxLen = 0u;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_QueueWorkerTask()
+*
+* Description : Send the messages submitted to the outbound queue.
+*
+* Argument(s) : p_arg           Pointer to the table of sessions of the worker.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Kernel (created by SMTPc_QueueInit()).
+*
+* Note(s)     : (1) The idle sessions of the worker are closed when no job was submitted for
+*                   SMTPc_CFG_POOL_IDLE_TIMEOUT_MS, since they could not be reused anyway (see
+*                   'SMTPc_PoolGet()  Note #2').
+*
+*               (2) The completion function & its argument are read before the job is marked as done;
+*                   the application may reuse the job as soon as it is.
+*
+*               (3) A job that failed on a transient error is scheduled to be sent again & is not done yet
+*                   (see 'SMTPc_SchedRetry()').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+static  void  SMTPc_QueueWorkerTask (void  *p_arg)
+{
+    SMTPc_POOL_ENTRY     *p_tbl;
+    SMTPc_JOB            *p_job;
+    SMTPc_JOB_CMPL_FNCT   cmpl_fnct;
+    void                 *p_cmpl_arg;
+    SMTPc_ERR             err;
+    KAL_ERR               err_kal;
+    CPU_SR_ALLOC();
+
+
+    p_tbl = (SMTPc_POOL_ENTRY *)p_arg;
+
+    while (DEF_ON) {
+                                                                /* ------------------- WAIT FOR JOB ------------------- */
+        p_job = (SMTPc_JOB *)KAL_QPend(SMTPc_QueueHandle,
+                                       KAL_OPT_PEND_NONE,
+                                       SMTPc_CFG_POOL_IDLE_TIMEOUT_MS,
+                                      &err_kal);
+        if (err_kal == KAL_ERR_TIMEOUT) {                       /* See Note #1.                                         */
+            SMTPc_PoolCloseIdle(p_tbl, SMTPc_QueueWorkerSessNbr);
+            continue;
+        }
+        if (err_kal != KAL_ERR_NONE) {
+            continue;
+        }
+                                                                /* --------------------- SEND MSG --------------------- */
+        CPU_CRITICAL_ENTER();
+        p_job->Status = SMTPc_JOB_STATUS_ACTIVE;
+        CPU_CRITICAL_EXIT();
+
+        SMTPc_PoolSendMail(p_tbl,
+                           SMTPc_QueueWorkerSessNbr,
+                           p_job->HostNamePtr,
+                           p_job->Port,
+                           p_job->UsernamePtr,
+                           p_job->PwdPtr,
+                           p_job->SecureCfgPtr,
+                           p_job->MsgPtr,
+                          &p_job->RepCode,
+                          &err);
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+        if (SMTPc_SchedRetry(p_job, err) == DEF_YES) {          /* See Note #3.                                         */
+            continue;
+        }
+#endif
+                                                                /* -------------------- REPORT RESULT ----------------- */
+        cmpl_fnct  = p_job->CmplFnct;                           /* See Note #2.                                         */
+        p_cmpl_arg = p_job->CmplArg;
+
+        CPU_CRITICAL_ENTER();
+        p_job->Err    = err;
+        p_job->Status = SMTPc_JOB_STATUS_DONE;
+        CPU_CRITICAL_EXIT();
+
+        if (cmpl_fnct != (SMTPc_JOB_CMPL_FNCT)0) {
+            cmpl_fnct(p_job, err, p_cmpl_arg);
         }
     }
-                                                                /* ----------- INSERT HEADER/BODY DELIMITER ----------- */
-    Mem_Copy(&SMTPc_Comm_Buf[cur_wr_ix], SMTPc_CRLF, SMTPc_CRLF_SIZE);
-    cur_wr_ix += SMTPc_CRLF_SIZE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_QueueRingTask()
+*
+* Description : Move the jobs of the submission ring to the job queue.
+*
+* Argument(s) : p_arg           Argument passed to the task (unused).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Kernel (created by SMTPc_QueueInit()).
+*
+* Note(s)     : (1) The task is the single consumer of the ring : it alone takes the jobs & frees their slot
+*                   for the next lap of the producers, after the job was posted (see 'SMTPc_QueueRingSubmit()
+*                   Note #3b').  The tail is only read by the producers, to find out that the ring was empty.
+*
+*               (2) When the job queue is full, the remaining jobs are left in the ring & posted on the
+*                   next period; new jobs are then rejected by SMTPc_QueueRingSubmit() once the ring is
+*                   full too.
+*
+*               (3) When SMTPc_CFG_QUEUE_RING_WAKE_EN is enabled, the task pends on the semaphore posted by
+*                   the producers that find the ring empty (see 'SMTPc_QueueRingSubmit()  Note #5'), with
+*                   the poll period as timeout, so that the jobs left in the ring by Note #2 are retried.
+*                   Otherwise, it polls the ring every SMTPc_CFG_QUEUE_RING_POLL_MS.
+*
+*               (4) The time each job spent in the ring is measured once the job was posted; its maximum is
+*                   reported by SMTPc_QueueRingStatsGet().
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_QUEUE_EN        == DEF_ENABLED) && \
+    (SMTPc_CFG_QUEUE_RING_SIZE >  0u)
+static  void  SMTPc_QueueRingTask (void  *p_arg)
+{
+    SMTPc_QUEUE_RING_SLOT  *p_slot;
+    CPU_INT32U              tail;
+    CPU_INT32U              seq;
+    CPU_TS32                lat;
+    KAL_ERR                 err_kal;
+#if (SMTPc_CFG_QUEUE_RING_ATOMIC_EN != DEF_ENABLED)
+    CPU_SR_ALLOC();
+#endif
+
+
+   (void)&p_arg;                                                /* Prevent 'variable unused' compiler warning.          */
+
+    tail = 0u;
+    while (DEF_ON) {
+#if (SMTPc_CFG_QUEUE_RING_WAKE_EN == DEF_ENABLED)
+        KAL_SemPend(SMTPc_QueueRingSemHandle,                   /* See Note #3.                                         */
+                    KAL_OPT_PEND_NONE,
+                    SMTPc_CFG_QUEUE_RING_POLL_MS,
+                   &err_kal);
+#else
+        KAL_Dly(SMTPc_CFG_QUEUE_RING_POLL_MS);
+#endif
+
+        while (DEF_ON) {
+            p_slot = &SMTPc_QueueRingTbl[tail & SMTPc_QUEUE_RING_MASK];
+#if (SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED)
+            seq    =  SMTPc_ATOMIC_LD32(&p_slot->Seq);
+#else
+            CPU_CRITICAL_ENTER();
+            seq    =  p_slot->Seq;
+            CPU_CRITICAL_EXIT();
+#endif
+            if (seq != (tail + 1u)) {                           /* Ring empty, or job not published yet.                */
+                break;
+            }
+
+            KAL_QPost(SMTPc_QueueHandle, p_slot->JobPtr, KAL_OPT_POST_NONE, &err_kal);
+            if (err_kal != KAL_ERR_NONE) {                      /* See Note #2.                                         */
+                break;
+            }
+
+            lat = CPU_TS_Get32() - p_slot->TS;                  /* See Note #4.                                         */
+            if (lat > SMTPc_QueueRingDrainLatMax) {
+                SMTPc_QueueRingDrainLatMax = lat;
+            }
+                                                                /* Free the slot (see Note #1).                         */
+#if (SMTPc_CFG_QUEUE_RING_ATOMIC_EN == DEF_ENABLED)
+            SMTPc_ATOMIC_ST32(&p_slot->Seq, tail + SMTPc_CFG_QUEUE_RING_SIZE);
+            tail++;
+            SMTPc_ATOMIC_ST32(&SMTPc_QueueRingTail, tail);
+#else
+            CPU_CRITICAL_ENTER();
+            p_slot->Seq         = tail + SMTPc_CFG_QUEUE_RING_SIZE;
+            tail++;
+            SMTPc_QueueRingTail = tail;
+            CPU_CRITICAL_EXIT();
+#endif
+        }
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_SpoolRecover()
+*
+* Description : (1) Recover the messages left in the storage of the spool.
+*
+*                   (a) Read the records of each segment, from the oldest
+*                   (b) Load the messages spooled, & free the ones already done
+*                   (c) Start a new segment for the records to come
+*
+*
+* Argument(s) : p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_INIT_FAILED               More messages stored than 'MsgNbrMax'.
+*                               SMTPc_ERR_SPOOL_IO                  Storage could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolInit().
+*
+* Note(s)     : (2) A record cut by a reset, or damaged, ends its segment : the records of a segment are
+*                   only read up to the first one whose header or hash is not valid.  Since records are
+*                   never appended to a segment read here (see Note #1c), no record can follow it.
+*
+*               (3) A message stored but not synced before a reset MAY have reached the storage.  It is
+*                   then sent, as if it had been synced.
+*********************************************************************************************************
+*/
 
-                                                                /* ---------------- TX CONTENT HEADERS ---------------- */
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, cur_wr_ix, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr = SMTPc_ERR_TX_FAILED;
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  void  SMTPc_SpoolRecover (SMTPc_ERR  *p_err)
+{
+    const  SMTPc_SPOOL_API      *p_api;
+           SMTPc_SPOOL_ENTRY    *p_entry;
+           SMTPc_SPOOL_REC_HDR   hdr;
+           CPU_INT08U           *p_data;
+           CPU_INT32U            seg_first;
+           CPU_INT32U            seg_last;
+           CPU_INT32U            seg_id;
+           CPU_INT32U            offset;
+           CPU_INT32U            len_rd;
+           CPU_BOOLEAN           found;
+           CPU_BOOLEAN           valid;
+           CPU_INT16U            i;
+
+
+    p_api             = SMTPc_SpoolCfg.StorageAPI_Ptr;
+    SMTPc_SpoolIdNext = 1u;
+
+    p_api->SegRangeGet(SMTPc_SpoolCfg.StorageArg, &seg_first, &seg_last, &found, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
         return;
     }
-
-
-                                                                /* ------------------ TX BODY CONTENT ----------------- */
-    SMTPc_QueryServer(sock_id, msg->ContentBodyMsg, msg->ContentBodyMsgLen, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr = SMTPc_ERR_TX_FAILED;
+    if (found == DEF_NO) {                                      /* Empty storage.                                       */
+        SMTPc_SpoolSegIdFirst = 0u;
+        SMTPc_SpoolSegIdCur   = 0u;
+        SMTPc_SpoolSegIdSync  = 0u;
+        SMTPc_SpoolSegLen     = 0u;
+        SMTPc_SpoolIdSynced   = 0u;
         return;
     }
 
+    for (seg_id = seg_first; seg_id <= seg_last; seg_id++) {
+        offset = 0u;
+        valid  = DEF_YES;
+        while (valid == DEF_YES) {
+                                                                /* --------------------- RD HDR ----------------------- */
+            len_rd = p_api->SegRd(SMTPc_SpoolCfg.StorageArg,
+                                  seg_id,
+                                  offset,
+                                 &hdr,
+                                  sizeof(hdr),
+                                  p_err);
+            if (*p_err != SMTPc_ERR_NONE) {
+                return;
+            }
+            if ((len_rd    <  sizeof(hdr)) ||                   /* End of seg, or invalid rec (see Note #2).            */
+                (hdr.Magic != SMTPc_SPOOL_REC_MAGIC) ||
+                (hdr.Len   > (SMTPc_SpoolRecLenMax - sizeof(hdr)))) {
+                break;
+            }
+
+            switch (hdr.Type) {
+                case SMTPc_SPOOL_REC_TYPE_DONE:                 /* ------------------- FREE DONE MSG ------------------ */
+                     if ((hdr.Len != 0u) ||
+                         (SMTPc_SpoolRecHash(&hdr, (CPU_INT08U *)0) != hdr.Chk)) {
+                         valid = DEF_NO;
+                         break;
+                     }
+                     for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {
+                         p_entry = &SMTPc_SpoolEntryTbl[i];
+                         if ((p_entry->State != SMTPc_SPOOL_STATE_FREE) &&
+                             (p_entry->Id    == hdr.Id)) {
+                              p_entry->State  = SMTPc_SPOOL_STATE_FREE;
+                              break;
+                         }
+                     }
+                     break;
+
+
+                case SMTPc_SPOOL_REC_TYPE_MSG:                  /* --------------------- LOAD MSG --------------------- */
+                     p_entry = (SMTPc_SPOOL_ENTRY *)0;
+                     for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {
+                         if (SMTPc_SpoolEntryTbl[i].State == SMTPc_SPOOL_STATE_FREE) {
+                             p_entry = &SMTPc_SpoolEntryTbl[i];
+                             break;
+                         }
+                     }
+                     if (p_entry == (SMTPc_SPOOL_ENTRY *)0) {
+                        *p_err = SMTPc_ERR_INIT_FAILED;
+                         return;
+                     }
+
+                     Mem_Copy(p_entry->RecPtr, &hdr, sizeof(hdr));
+                     p_data = p_entry->RecPtr + sizeof(hdr);
+                     len_rd = p_api->SegRd(SMTPc_SpoolCfg.StorageArg,
+                                           seg_id,
+                                           offset + sizeof(hdr),
+                                           p_data,
+                                           hdr.Len,
+                                           p_err);
+                     if (*p_err != SMTPc_ERR_NONE) {
+                         return;
+                     }
+                     if ((len_rd != hdr.Len) ||
+                         (SMTPc_SpoolRecHash(&hdr, p_data) != hdr.Chk)) {
+                         valid = DEF_NO;
+                         break;
+                     }
+
+                     SMTPc_SpoolMsgLoad(p_entry, p_err);
+                     if (*p_err != SMTPc_ERR_NONE) {            /* Rec valid but msg not : skip it.                     */
+                        *p_err = SMTPc_ERR_NONE;
+                         break;
+                     }
+                     p_entry->Id    = hdr.Id;
+                     p_entry->SegId = seg_id;
+                     p_entry->State = SMTPc_SPOOL_STATE_SYNCED; /* See Note #3.                                         */
+                     break;
+
+
+                default:
+                     valid = DEF_NO;
+                     break;
+            }
+            if (valid == DEF_NO) {
+                break;
+            }
+
+            offset += sizeof(hdr) + hdr.Len;
+            if (hdr.Id >= SMTPc_SpoolIdNext) {
+                SMTPc_SpoolIdNext = hdr.Id + 1u;
+            }
+        }
+    }
+                                                                /* ------------------- START NEW SEG ------------------ */
+    SMTPc_SpoolSegIdFirst = seg_first;
+    SMTPc_SpoolSegIdCur   = seg_last + 1u;                      /* See Note #2.                                         */
+    SMTPc_SpoolSegIdSync  = SMTPc_SpoolSegIdCur;
+    SMTPc_SpoolSegLen     = 0u;
+    SMTPc_SpoolIdSynced   = SMTPc_SpoolIdNext - 1u;             /* See Note #3.                                         */
+}
+#endif
 
 
-                                                                /* ------------ PREPARE & TX ATTACHMENT(S) ------------ */
-                                                                /* #### Not currently implemented.                      */
+/*
+*********************************************************************************************************
+*                                        SMTPc_SpoolEnvBuild()
+*
+* Description : Build the envelope of a message to spool.
+*
+* Argument(s) : p_msg           Pointer to the message.
+*
+*               p_buf           Pointer to the buffer receiving the envelope, of SMTPc_SPOOL_ENV_LEN octets.
+*
+* Return(s)   : Length of the envelope.
+*
+* Caller(s)   : SMTPc_SpoolSubmit().
+*
+* Note(s)     : (1) The envelope is the address of the sender, followed by the lists of 'To', 'CC' & 'BCC'
+*                   addresses.  Each address is NULL terminated, & each list ends with an empty string :
+*
+*                       sender\0to_1\0...to_n\0\0cc_1\0...\0\0bcc_1\0...\0\0
+*
+*                   The headers are part of the rendered content; the names of the mailboxes are thus not
+*                   needed.
+*********************************************************************************************************
+*/
 
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  CPU_INT32U  SMTPc_SpoolEnvBuild (SMTPc_MSG  *p_msg,
+                                         CPU_CHAR   *p_buf)
+{
+    SMTPc_MBOX  **p_list;
+    CPU_CHAR     *p_str;
+    CPU_SIZE_T    len;
+    CPU_INT08U    list_ix;
+    CPU_INT08U    list_max;
+    CPU_INT08U    i;
+
+
+    p_str = p_buf;
+    len   = Str_Len(p_msg->From->Addr) + 1u;
+    Mem_Copy(p_str, p_msg->From->Addr, len);
+    p_str += len;
+
+    for (list_ix = 0u; list_ix < 3u; list_ix++) {
+        switch (list_ix) {
+            case 0u:
+                 p_list   = p_msg->ToArray;
+                 list_max = SMTPc_CFG_MSG_MAX_TO;
+                 break;
+
+            case 1u:
+                 p_list   = p_msg->CCArray;
+                 list_max = SMTPc_CFG_MSG_MAX_CC;
+                 break;
+
+            default:
+                 p_list   = p_msg->BCCArray;
+                 list_max = SMTPc_CFG_MSG_MAX_BCC;
+                 break;
+        }
 
+        for (i = 0u; i < list_max; i++) {
+            if (p_list[i] == (SMTPc_MBOX *)0) {
+                break;
+            }
+            len = Str_Len(p_list[i]->Addr) + 1u;
+            Mem_Copy(p_str, p_list[i]->Addr, len);
+            p_str += len;
+        }
+       *p_str = '\0';                                           /* End of list.                                         */
+        p_str++;
+    }
 
-                                                                /* ----------- TX END OF MAIL DATA INDICATOR ---------- */
-    Mem_Copy(SMTPc_Comm_Buf, SMTPc_EOM, sizeof(SMTPc_EOM));
-    len = Str_Len(SMTPc_Comm_Buf);
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr = SMTPc_ERR_TX_FAILED;
+    return ((CPU_INT32U)(p_str - p_buf));
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_SpoolMsgLoad()
+*
+* Description : Load the message of a spooled message from its record.
+*
+* Argument(s) : p_entry         Pointer to the spooled message, whose record is in its record buffer.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SPOOL_IO                  Invalid envelope.
+*
+*                                                                   ------ RETURNED BY SMTPc_SetMbox : ------
+*                               SMTPc_ERR_STR_TOO_LONG              Address too long.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolRecover(),
+*               SMTPc_SpoolSubmit().
+*
+* Note(s)     : (1) The message is sent from the record : the mailboxes are set from the envelope (see
+*                   'SMTPc_SpoolEnvBuild()  Note #1') & the content follows it.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  void  SMTPc_SpoolMsgLoad (SMTPc_SPOOL_ENTRY  *p_entry,
+                                  SMTPc_ERR          *p_err)
+{
+    SMTPc_SPOOL_REC_HDR   *p_hdr;
+    SMTPc_MSG             *p_msg;
+    SMTPc_MBOX            *p_mbox;
+    SMTPc_MBOX           **p_list;
+    CPU_CHAR              *p_str;
+    CPU_CHAR              *p_end;
+    CPU_SIZE_T             len;
+    CPU_INT08U             list_ix;
+    CPU_INT08U             list_max;
+    CPU_INT08U             i;
+
+
+    p_hdr  = (SMTPc_SPOOL_REC_HDR *)p_entry->RecPtr;
+    p_str  = (CPU_CHAR *)(p_entry->RecPtr + sizeof(SMTPc_SPOOL_REC_HDR));
+    p_end  =  p_str + p_hdr->Len;
+    p_msg  = &p_entry->Msg;
+    p_mbox = &p_entry->MboxTbl[0];
+
+    SMTPc_SetMsg(p_msg, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
         return;
     }
-
-                                                                /* --------------- RX CONFIRMATION REPLY -------------- */
-    reply = SMTPc_RxReply(sock_id, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr = SMTPc_ERR_RX_FAILED;
+                                                                /* ---------------------- SENDER ---------------------- */
+    len = Str_Len_N(p_str, (CPU_SIZE_T)(p_end - p_str));
+    if (len >= (CPU_SIZE_T)(p_end - p_str)) {                   /* Addr not NULL terminated.                            */
+       *p_err = SMTPc_ERR_SPOOL_IO;
         return;
     }
-
-    SMTPc_ParseReply(reply, &completion_code, perr);
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:
-             if (completion_code == SMTPc_REP_250) {
-                *perr = SMTPc_ERR_NONE;
-             }
-             break;
-
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
+    SMTPc_SetMbox(p_mbox, (CPU_CHAR *)0, p_str, p_err);
+    if (*p_err != SMTPc_ERR_NONE) {
+        return;
     }
+    p_msg->From = p_mbox;
+    p_mbox++;
+    p_str += len + 1u;
+                                                                /* -------------------- RECIPIENTS -------------------- */
+    for (list_ix = 0u; list_ix < 3u; list_ix++) {
+        switch (list_ix) {
+            case 0u:
+                 p_list   = p_msg->ToArray;
+                 list_max = SMTPc_CFG_MSG_MAX_TO;
+                 break;
+
+            case 1u:
+                 p_list   = p_msg->CCArray;
+                 list_max = SMTPc_CFG_MSG_MAX_CC;
+                 break;
+
+            default:
+                 p_list   = p_msg->BCCArray;
+                 list_max = SMTPc_CFG_MSG_MAX_BCC;
+                 break;
+        }
 
-    if (*perr != SMTPc_ERR_NONE) {
-        if ((completion_code != SMTPc_REP_421) &&
-            (completion_code != SMTPc_REP_221)) {
-            SMTPc_RSET(sock_id, &completion_code, perr);
+        i = 0u;
+        while (DEF_ON) {
+            if (p_str >= p_end) {
+               *p_err = SMTPc_ERR_SPOOL_IO;
+                return;
+            }
+            len = Str_Len_N(p_str, (CPU_SIZE_T)(p_end - p_str));
+            if (len >= (CPU_SIZE_T)(p_end - p_str)) {
+               *p_err = SMTPc_ERR_SPOOL_IO;
+                return;
+            }
+            if (len == 0u) {                                    /* End of list.                                         */
+                p_str++;
+                break;
+            }
+            if (i >= list_max) {
+               *p_err = SMTPc_ERR_SPOOL_IO;
+                return;
+            }
+
+            SMTPc_SetMbox(p_mbox, (CPU_CHAR *)0, p_str, p_err);
+            if (*p_err != SMTPc_ERR_NONE) {
+                return;
+            }
+            p_list[i] = p_mbox;
+            p_mbox++;
+            i++;
+            p_str += len + 1u;
         }
-       *perr = SMTPc_ERR_REP;
     }
+                                                                /* ----------------- RENDERED CONTENT ----------------- */
+    p_msg->RenderBufPtr = p_str;
+    p_msg->RenderLen    = (CPU_INT32U)(p_end - p_str);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                           SMTPc_BuildHdr()
+*                                        SMTPc_SpoolRecHash()
 *
-* Description : (1) Prepare (and send if necessary) the message content's headers.
+* Description : Compute the hash protecting a spool record.
 *
-*                   (a) Calculate needed space
-*                   (b) Send data, if necessary
-*                   (c) Build header
+* Argument(s) : p_hdr           Pointer to the header of the record.
 *
+*               p_data          Pointer to the data of the record, if any.
 *
-* Argument(s) : sock_id         Socket ID.
-*               buf             Buffer used to store the headers prior to their expedition.
-*               buf_size        Size of buffer.
-*               buf_wr_ix       Index of current "write" position.
-*               hdr             Header name.
-*               val             Value associated with header.
-*               line_len        Current line total length.
-*               perr            Pointer to variable that will hold the return error code from this
+* Return(s)   : 32-bit FNV-1a hash of the header, except its 'Chk' member, & of the data.
+*
+* Caller(s)   : SMTPc_SpoolRecover(),
+*               SMTPc_SpoolSubmit(),
+*               SMTPc_SpoolTask().
+*
+* Note(s)     : (1) The hash detects a record partially written before a reset, rather than deliberate
+*                   changes.  'Chk' is the last member of the header.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  CPU_INT32U  SMTPc_SpoolRecHash (SMTPc_SPOOL_REC_HDR  *p_hdr,
+                                        CPU_INT08U           *p_data)
+{
+    CPU_INT08U  *p_octet;
+    CPU_INT32U   len;
+    CPU_INT32U   hash;
+    CPU_INT32U   j;
+    CPU_INT08U   i;
+
+
+    hash    = SMTPc_POOL_FNV_OFFSET_BASIS;
+    p_octet = (CPU_INT08U *)p_hdr;
+    len     = sizeof(SMTPc_SPOOL_REC_HDR) - sizeof(p_hdr->Chk); /* See Note #1.                                         */
+    for (i = 0u; i < 2u; i++) {
+        for (j = 0u; j < len; j++) {
+            hash ^= (CPU_INT32U)p_octet[j];
+            hash *=  SMTPc_POOL_FNV_PRIME;
+        }
+        p_octet = p_data;
+        len     = p_hdr->Len;
+    }
+
+    return (hash);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_SpoolRecWr()
+*
+* Description : Append a record to the current segment of the spool.
+*
+* Argument(s) : p_hdr           Pointer to the record : header followed by its data.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
 *                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_LINE_TOO_LONG             Line limit exceeded.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
+*                               SMTPc_ERR_SPOOL_IO                  Record could not be written.
 *
-* Return(s)   : "Write" position in buffer.
+* Return(s)   : none.
 *
-* Caller(s)   : SMTPc_SendBody().
+* Caller(s)   : SMTPc_SpoolSubmit(),
+*               SMTPc_SpoolTask().
 *
-* Note(s)     : (2) If the parameter "hdr" is (CPU_CHAR *)0, et means that it's already been passed in a
-*                   previous call.  Hence, a "," will be inserted in the buffer prior to the value.
+* Note(s)     : (1) The spool lock MUST be held by the caller.
 *
-*               (3) If the SMTP line limit is exceeded, perr is set to SMTPc_ERR_LINE_TOO_LONG and the
-*                   function returns without having added the header.
+*               (2) A record that could not be written MAY have been partially written.  A new segment is
+*                   started, so that the records to come are not hidden behind it (see 'SMTPc_SpoolRecover()
+*                   Note #2').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  void  SMTPc_SpoolRecWr (SMTPc_SPOOL_REC_HDR  *p_hdr,
+                                SMTPc_ERR            *p_err)
+{
+    CPU_INT32U  len;
+
+
+    len = sizeof(SMTPc_SPOOL_REC_HDR) + p_hdr->Len;
+    SMTPc_SpoolCfg.StorageAPI_Ptr->SegWr(SMTPc_SpoolCfg.StorageArg,
+                                         SMTPc_SpoolSegIdCur,
+                                         p_hdr,
+                                         len,
+                                         p_err);
+    if (*p_err != SMTPc_ERR_NONE) {                             /* See Note #2.                                         */
+        SMTPc_SpoolSegIdCur++;
+        SMTPc_SpoolSegLen = 0u;
+       *p_err             = SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+
+    SMTPc_SpoolSegLen += len;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_SpoolJobCmpl()
 *
-*               (4) This implementation transmit the headers buffer if the next header is too large to
-*                   be inserted in the remaining buffer space.
+* Description : Mark a spooled message as done.
 *
-*                   Note that NO EXACT calculations are performed here;  a conservative approach is
-*                   brought forward, without actually optimizing the process (i.e. a buffer could be
-*                   sent even though a few more characters could have been inserted).
+* Argument(s) : p_job           Pointer to the job of the message.
 *
-*               (5) CRLF is inserted even though more entries are still to come for a particular header
-*                   (line folding is performed even if unnecessary).
+*               err             Result of the job.
+*
+*               p_arg           Pointer to the spooled message.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_QueueWorkerTask().
+*
+* Note(s)     : (1) The "done" record is written by the spool task.  The id is read before, since the entry
+*                   MAY be reused as soon as it is.
 *********************************************************************************************************
 */
 
-static  CPU_INT32U  SMTPc_BuildHdr (NET_SOCK_ID   sock_id,
-                                    CPU_CHAR     *buf,
-                                    CPU_INT32U    buf_size,
-                                    CPU_INT32U    buf_wr_ix,
-                                    CPU_CHAR     *hdr,
-                                    CPU_CHAR     *val,
-                                    CPU_INT32U   *line_len,
-                                    SMTPc_ERR    *perr)
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  void  SMTPc_SpoolJobCmpl (SMTPc_JOB  *p_job,
+                                  SMTPc_ERR   err,
+                                  void       *p_arg)
 {
-    CPU_INT32U  hdr_len;
-    CPU_INT32U  val_len;
-    CPU_INT32U  total_len;
+    SMTPc_SPOOL_ENTRY  *p_entry;
+    CPU_INT32U          msg_id;
+    KAL_ERR             err_kal;
 
-                                                                /* ------------- CALCULATE NECESSARY SPACE ------------ */
-    if (hdr == (CPU_CHAR *)0) {
-        hdr_len = 0;
-    } else {
-        hdr_len = Str_Len(hdr);
-    }
 
-    if (val == (CPU_CHAR *)0) {
-        val_len = 0;
-    } else {
-        val_len = Str_Len(val);
-    }
+   (void)&p_job;                                                /* Prevent 'variable unused' compiler warning.          */
 
-    total_len = hdr_len + val_len + 2;
+    p_entry = (SMTPc_SPOOL_ENTRY *)p_arg;
+    msg_id  =  p_entry->Id;                                     /* See Note #1.                                         */
 
-    if ((*line_len + total_len) > SMTPc_LINE_LEN_LIM) {         /* See Note #3.                                         */
-       *perr = SMTPc_ERR_LINE_TOO_LONG;
-        return (buf_wr_ix);
+    KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+    p_entry->State = SMTPc_SPOOL_STATE_DONE;
+    KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+
+    if (SMTPc_SpoolCfg.CmplFnct != (SMTPc_SPOOL_CMPL_FNCT)0) {
+        SMTPc_SpoolCfg.CmplFnct(msg_id, err, SMTPc_SpoolCfg.CmplArg);
     }
+}
+#endif
 
 
+/*
+*********************************************************************************************************
+*                                          SMTPc_SpoolTask()
+*
+* Description : (1) Commit & deliver the spooled messages, every 'SyncPeriod_ms' :
+*
+*                   (a) Write the "done" records of the messages done
+*                   (b) Start a new segment once the current one reached 'SegLenMax'
+*                   (c) Sync the records written since the last period (group commit)
+*                   (d) Delete the oldest segments, once all their messages are done
+*                   (e) Submit the messages synced to the outbound queue
+*
+*
+* Argument(s) : p_arg           Argument passed to the task (unused).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Kernel (created by SMTPc_SpoolInit()).
+*
+* Note(s)     : (2) The storage is synced without the spool lock, so that SMTPc_SpoolSubmit() & the
+*                   completion of the jobs are not delayed by the sync.  The messages whose record was
+*                   written before the sync are marked SYNCING under the lock, & only these are marked
+*                   SYNCED once the sync is done; the records written meanwhile are synced on the next
+*                   period.  No other task changes the state of a SYNCING message.
+*
+*               (3) A single sync covers all the records written to a segment.  The segments are synced from
+*                   the oldest one that MAY hold records not synced, e.g. records written to a previous
+*                   segment if a write failed (see 'SMTPc_SpoolRecWr()  Note #2') or the segment just
+*                   sealed, up to the current one.  Segments already deleted are skipped.
+*
+*               (4) The "done" records are synced with the next records; a message whose "done" record is
+*                   lost on a reset is sent again.  Messages are hence sent at least once.
+*
+*               (5) Segments are only deleted from the oldest, so that a "done" record is always deleted
+*                   after the record of its message, which is in the same segment or an older one.
+*
+*               (6) The messages are submitted without the spool lock too.  A message is marked QUEUED
+*                   before it is submitted, since its job MAY be done before SMTPc_QueueSubmit() returns.  A
+*                   message the queue could not accept is marked SYNCED again, & submitted on the next
+*                   period.
+*********************************************************************************************************
+*/
 
-                                                                /* -------------- SEND DATA, IF NECESSARY ------------- */
-                                                                /* See Note #4.                                         */
-    if ((buf_size - buf_wr_ix) < total_len) {
-        SMTPc_QueryServer(sock_id, buf, buf_wr_ix, perr);
-        if (*perr != SMTPc_ERR_NONE) {
-           *perr = SMTPc_ERR_TX_FAILED;
-            return buf_wr_ix;
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+static  void  SMTPc_SpoolTask (void  *p_arg)
+{
+    const  SMTPc_SPOOL_API      *p_api;
+           SMTPc_SPOOL_ENTRY    *p_entry;
+           SMTPc_SPOOL_REC_HDR   hdr;
+           CPU_INT32U            seg_id;
+           CPU_INT32U            seg_id_last;
+           CPU_INT32U            seg_id_sync;
+           CPU_INT32U            msg_id_sync;
+           CPU_BOOLEAN           sync_pend;
+           CPU_BOOLEAN           synced;
+           CPU_BOOLEAN           seg_used;
+           CPU_INT16U            i;
+           SMTPc_ERR             err;
+           KAL_ERR               err_kal;
+
+
+   (void)&p_arg;                                                /* Prevent 'variable unused' compiler warning.          */
+
+    p_api = SMTPc_SpoolCfg.StorageAPI_Ptr;
+
+    while (DEF_ON) {
+        KAL_Dly(SMTPc_SpoolCfg.SyncPeriod_ms);
+
+        KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+                                                                /* ------------------- DONE RECORDS ------------------- */
+        for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {       /* See Note #4.                                         */
+            p_entry = &SMTPc_SpoolEntryTbl[i];
+            if (p_entry->State == SMTPc_SPOOL_STATE_DONE) {
+                hdr.Magic = SMTPc_SPOOL_REC_MAGIC;
+                hdr.Id    = p_entry->Id;
+                hdr.Len   = 0u;
+                hdr.Type  = SMTPc_SPOOL_REC_TYPE_DONE;
+                hdr.Rsvd  = 0u;
+                hdr.Chk   = SMTPc_SpoolRecHash(&hdr, (CPU_INT08U *)0);
+                SMTPc_SpoolRecWr(&hdr, &err);
+                if (err == SMTPc_ERR_NONE) {
+                    p_entry->State = SMTPc_SPOOL_STATE_FREE;
+                }
+            }
+        }
+                                                                /* ------------------ SNAPSHOT RECS ------------------- */
+        sync_pend = DEF_NO;
+        for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {       /* See Note #2.                                         */
+            p_entry = &SMTPc_SpoolEntryTbl[i];
+            if (p_entry->State == SMTPc_SPOOL_STATE_WR) {
+                p_entry->State  = SMTPc_SPOOL_STATE_SYNCING;
+                sync_pend       = DEF_YES;
+            }
+        }
+        msg_id_sync = SMTPc_SpoolIdNext - 1u;                   /* All msgs spooled so far are covered by the sync.     */
+        seg_id      = DEF_MAX(SMTPc_SpoolSegIdSync, SMTPc_SpoolSegIdFirst);
+        seg_id_last = SMTPc_SpoolSegIdCur;
+                                                                /* --------------------- SEAL SEG --------------------- */
+        if (SMTPc_SpoolSegLen >= SMTPc_SpoolCfg.SegLenMax) {
+            SMTPc_SpoolSegIdCur++;
+            SMTPc_SpoolSegLen = 0u;
+        }
+        seg_id_sync = SMTPc_SpoolSegIdCur;
+        if (seg_id < seg_id_sync) {                             /* Previous segs not synced yet (see Note #3).          */
+            sync_pend = DEF_YES;
+        }
+
+        KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+                                                                /* ------------------- GROUP COMMIT ------------------- */
+        synced = DEF_NO;
+        if (sync_pend == DEF_YES) {                             /* See Note #3.                                         */
+            err = SMTPc_ERR_NONE;
+            while ((seg_id <= seg_id_last) &&
+                   (err    == SMTPc_ERR_NONE)) {
+                p_api->SegSync(SMTPc_SpoolCfg.StorageArg, seg_id, &err);
+                seg_id++;
+            }
+            synced = (err == SMTPc_ERR_NONE) ? DEF_YES : DEF_NO;
+        }
+
+        KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+        if (sync_pend == DEF_YES) {
+            for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {
+                p_entry = &SMTPc_SpoolEntryTbl[i];
+                if (p_entry->State == SMTPc_SPOOL_STATE_SYNCING) {
+                    p_entry->State  = (synced == DEF_YES) ? SMTPc_SPOOL_STATE_SYNCED
+                                                          : SMTPc_SPOOL_STATE_WR;
+                }
+            }
+            if (synced == DEF_YES) {
+                SMTPc_SpoolSegIdSync = seg_id_sync;
+                if (msg_id_sync > SMTPc_SpoolIdSynced) {
+                    SMTPc_SpoolIdSynced = msg_id_sync;
+                } else {
+                    synced = DEF_NO;                            /* No new msg made durable.                             */
+                }
+            }
+        }
+                                                                /* -------------------- COMPACT SEGS ------------------ */
+        while (SMTPc_SpoolSegIdFirst < SMTPc_SpoolSegIdCur) {   /* See Note #5.                                         */
+            seg_used = DEF_NO;
+            for (i = 0u; i < SMTPc_SpoolCfg.MsgNbrMax; i++) {
+                p_entry = &SMTPc_SpoolEntryTbl[i];
+                if ((p_entry->State != SMTPc_SPOOL_STATE_FREE) &&
+                    (p_entry->SegId == SMTPc_SpoolSegIdFirst)) {
+                    seg_used = DEF_YES;
+                    break;
+                }
+            }
+            if (seg_used == DEF_YES) {
+                break;
+            }
+
+            p_api->SegDel(SMTPc_SpoolCfg.StorageArg, SMTPc_SpoolSegIdFirst, &err);
+            if (err != SMTPc_ERR_NONE) {
+                break;
+            }
+            SMTPc_SpoolSegIdFirst++;
+        }
+
+        KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+
+        if ((synced                  == DEF_YES) &&             /* See 'smtp-c.h  SMTPc_SPOOL_CFG  Note #4'.            */
+            (SMTPc_SpoolCfg.SyncFnct != (SMTPc_SPOOL_SYNC_FNCT)0)) {
+            SMTPc_SpoolCfg.SyncFnct(msg_id_sync, SMTPc_SpoolCfg.SyncArg);
+        }
+                                                                /* -------------------- SUBMIT MSGS ------------------- */
+        i = 0u;
+        while (i < SMTPc_SpoolCfg.MsgNbrMax) {                  /* See Note #6.                                         */
+            KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+            while ((i                             <  SMTPc_SpoolCfg.MsgNbrMax) &&
+                   (SMTPc_SpoolEntryTbl[i].State != SMTPc_SPOOL_STATE_SYNCED)) {
+                i++;
+            }
+            if (i < SMTPc_SpoolCfg.MsgNbrMax) {
+                SMTPc_SpoolEntryTbl[i].State = SMTPc_SPOOL_STATE_QUEUED;
+            }
+            KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+            if (i >= SMTPc_SpoolCfg.MsgNbrMax) {
+                break;
+            }
+
+            p_entry = &SMTPc_SpoolEntryTbl[i];
+            SMTPc_QueueSubmit(&p_entry->Job,
+                               SMTPc_SpoolCfg.HostNamePtr,
+                               SMTPc_SpoolCfg.Port,
+                               SMTPc_SpoolCfg.UsernamePtr,
+                               SMTPc_SpoolCfg.PwdPtr,
+                               SMTPc_SpoolCfg.SecureCfgPtr,
+                              &p_entry->Msg,
+                               SMTPc_SpoolJobCmpl,
+                               p_entry,
+                              &err);
+            if (err != SMTPc_ERR_NONE) {
+                KAL_LockAcquire(SMTPc_SpoolLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+                p_entry->State = SMTPc_SPOOL_STATE_SYNCED;
+                KAL_LockRelease(SMTPc_SpoolLockHandle, &err_kal);
+                break;
+            }
+            i++;
         }
-        buf_wr_ix = 0;
     }
+}
+#endif
 
 
-                                                                /* ------------------ BUILDING HEADER ----------------- */
-    if (hdr != (CPU_CHAR *)0) {
-        Mem_Copy(buf + buf_wr_ix, hdr, hdr_len);
-        buf_wr_ix += hdr_len;
-       *line_len += hdr_len;
-    } else {                                                    /* Not first item, adding ','.                          */
-        Mem_Copy(buf + buf_wr_ix, " ,", 2);
-        buf_wr_ix += 2;
-       *line_len += 2;
+/*
+*********************************************************************************************************
+*                                          SMTPc_SchedAdd()
+*
+* Description : Schedule a job to be queued after a delay.
+*
+* Argument(s) : p_job           Pointer to the job.
+*
+*               dly_ms          Delay before the job is queued, in milliseconds.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_QueueSubmitDly(),
+*               SMTPc_SchedRetry(),
+*               SMTPc_SchedTask().
+*
+* Note(s)     : (1) The delay is rounded up to a whole number of ticks.  Since the current tick is already
+*                   partly elapsed, the job is due on the tick that follows the delay, so that it is never
+*                   queued early.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+static  void  SMTPc_SchedAdd (SMTPc_JOB   *p_job,
+                              CPU_INT32U   dly_ms)
+{
+    CPU_INT32U  dly_ticks;
+    KAL_ERR     err_kal;
+    CPU_SR_ALLOC();
+
+                                                                /* See Note #1.                                         */
+    dly_ticks = dly_ms / SMTPc_CFG_SCHED_TICK_MS;
+    if ((dly_ms % SMTPc_CFG_SCHED_TICK_MS) != 0u) {
+        dly_ticks++;
     }
-    if (val != (CPU_CHAR *)0) {
-        Mem_Copy(buf + buf_wr_ix, val, val_len);
-        buf_wr_ix += val_len;
-       *line_len += val_len;
+    if (dly_ticks == 0u) {
+        dly_ticks = 1u;
+    }
+    if (dly_ticks > SMTPc_SCHED_DLY_MAX_TICKS) {
+        dly_ticks = SMTPc_SCHED_DLY_MAX_TICKS;
     }
 
-    Mem_Copy(buf + buf_wr_ix, SMTPc_CRLF, 2);                   /* See Note #5.                                         */
-    buf_wr_ix += 2;
-   *line_len  = 0;
+    CPU_CRITICAL_ENTER();
+    p_job->Status = SMTPc_JOB_STATUS_SCHED;
+    CPU_CRITICAL_EXIT();
+
+    KAL_LockAcquire(SMTPc_SchedLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+    p_job->SchedTick = SMTPc_SchedTickCur + dly_ticks;
+    SMTPc_SchedWheelAdd(p_job);
+    KAL_LockRelease(SMTPc_SchedLockHandle, &err_kal);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        SMTPc_SchedWheelAdd()
+*
+* Description : Insert a job in the slot of the timer wheel matching the tick it is due on.
+*
+* Argument(s) : p_job           Pointer to the job, its 'SchedTick' set.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SchedAdd(),
+*               SMTPc_SchedTick().
+*
+* Note(s)     : (1) The wheel lock MUST be held by the caller.
+*
+*               (2) Level n holds the jobs due within 64^(n + 1) ticks, in the slot indexed by bits
+*                   [6n, 6n + 5] of their due tick.  Inserting a job is hence O(1), whatever the number of
+*                   jobs scheduled.
+*
+*               (3) A job already due, re-inserted while the wheel is cascaded, is put in the slot of the
+*                   tick being processed.
+*********************************************************************************************************
+*/
 
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+static  void  SMTPc_SchedWheelAdd (SMTPc_JOB  *p_job)
+{
+    CPU_INT32U  tick;
+    CPU_INT32U  dly_ticks;
+    CPU_INT08U  lvl;
+    CPU_INT08U  slot;
 
-    buf[buf_wr_ix] = '\0';
-    SMTPc_TRACE_DBG(("String: %s\n", buf));
 
-   *perr = SMTPc_ERR_NONE;
-    return (buf_wr_ix);
+    tick      = p_job->SchedTick;
+    dly_ticks = tick - SMTPc_SchedTickCur;
+    if (dly_ticks > SMTPc_SCHED_DLY_MAX_TICKS) {                /* See Note #3.                                         */
+        tick      = SMTPc_SchedTickCur;
+        dly_ticks = 0u;
+    }
+                                                                /* See Note #2.                                         */
+    lvl = 0u;
+    while ((lvl < (SMTPc_SCHED_LVL_NBR - 1u)) &&
+           (dly_ticks >= (1uL << ((lvl + 1u) * SMTPc_SCHED_SLOT_BITS)))) {
+        lvl++;
+    }
+    slot = (CPU_INT08U)((tick >> (lvl * SMTPc_SCHED_SLOT_BITS)) & SMTPc_SCHED_SLOT_MASK);
+
+    p_job->SchedNextPtr         = SMTPc_SchedWheel[lvl][slot];
+    SMTPc_SchedWheel[lvl][slot] = p_job;
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                             SMTPc_HELO()
-*
-* Description : (1) Build the HELO command, send it to the server and validate reply.
+*                                          SMTPc_SchedTick()
 *
-*                   (a) Send command to the server
-*                   (b) Receive server's reply and validate
+* Description : (1) Process the current tick of the timer wheel.
 *
+*                   (a) Cascade the jobs of the upper levels whose slot was reached
+*                   (b) Take the jobs due on the tick
+*                   (c) Advance to the next tick
 *
-* Argument(s) : sock_id         Socket ID.
 *
-*               completion_code Numeric value returned by server indicating command status.
+* Argument(s) : none.
 *
-*               perr            Pointer to variable that will hold the return error code from this
-*                               function :
+* Return(s)   : List of the jobs due, linked by 'SchedNextPtr', or (SMTPc_JOB *)0 if none.
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
+* Caller(s)   : SMTPc_SchedTask().
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
+* Note(s)     : (2) The wheel lock MUST be held by the caller.
 *
-*               (CPU_CHAR *)0,                  otherwise.
+*               (3) Every 64^n ticks, the slot of level n reached by the tick is emptied & its jobs are
+*                   inserted again, closer to the bottom level.  Each job is hence moved at most once per
+*                   level : scheduling & firing a job costs O(1), amortized.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+static  SMTPc_JOB  *SMTPc_SchedTick (void)
+{
+    SMTPc_JOB   *p_job;
+    SMTPc_JOB   *p_job_next;
+    CPU_INT08U   lvl;
+    CPU_INT08U   slot;
+
+
+    slot = (CPU_INT08U)(SMTPc_SchedTickCur & SMTPc_SCHED_SLOT_MASK);
+                                                                /* --------------- CASCADE UPPER LEVELS --------------- */
+    if (slot == 0u) {                                           /* See Note #3.                                         */
+        for (lvl = 1u; lvl < SMTPc_SCHED_LVL_NBR; lvl++) {
+            slot  = (CPU_INT08U)((SMTPc_SchedTickCur >> (lvl * SMTPc_SCHED_SLOT_BITS)) & SMTPc_SCHED_SLOT_MASK);
+            p_job =  SMTPc_SchedWheel[lvl][slot];
+            SMTPc_SchedWheel[lvl][slot] = (SMTPc_JOB *)0;
+            while (p_job != (SMTPc_JOB *)0) {
+                p_job_next = p_job->SchedNextPtr;
+                SMTPc_SchedWheelAdd(p_job);
+                p_job      = p_job_next;
+            }
+            if (slot != 0u) {                                   /* Upper levels reached on later ticks only.            */
+                break;
+            }
+        }
+        slot = 0u;
+    }
+                                                                /* ------------------- TAKE JOBS DUE ------------------ */
+    p_job                      = SMTPc_SchedWheel[0u][slot];
+    SMTPc_SchedWheel[0u][slot] = (SMTPc_JOB *)0;
+
+    SMTPc_SchedTickCur++;
+
+    return (p_job);
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          SMTPc_SchedRetry()
 *
-* Caller(s)   : SMTPc_Connect().
+* Description : Schedule a failed job to be sent again, if it failed on a transient error.
 *
-* Note(s)     : (2) From RFC #2821, "the HELO command is used to identify the SMTP client to the SMTP
-*                   server".
+* Argument(s) : p_job           Pointer to the job, its 'RepCode' set.
 *
-*               (3) The server will send a 250 "Requested mail action okay, completed" reply upon
-*                   success.  A positive reply is the only reply that will lead to a  "SMTPc_ERR_NONE"
-*                   error return code.
+*               err             Error returned when sending the message.
 *
-*               (4) This implementation will accept reply 250, as well as any other positive reply.
+* Return(s)   : DEF_YES, if the job was scheduled again.
 *
-*               (5) From RFC #2821, section 4.1.3 Address Literals:
+*               DEF_NO,  if the job is done.
 *
-*                      For IPv4 addresses, this form uses four small decimal integers separated
-*                      by dots and enclosed by brackets such as [123.255.37.2], which
-*                      indicates an (IPv4) Internet Address in sequence-of-octets form.  For
-*                      IPv6 and other forms of addressing that might eventually be
-*                      standardized, the form consists of a standardized "tag" that
-*                      identifies the address syntax, a colon, and the address itself, in a
-*                      format specified as part of the IPv6 standards.
+* Caller(s)   : SMTPc_QueueWorkerTask().
 *
+* Note(s)     : (1) See 'smtp-c.h  SMTPc_JOB  Note #5' for the delay.  The jitter is drawn from a xorshift
+*                   generator, good enough to spread retries & cheap enough for any target.
 *
+*               (2) The error is kept in the job until it is sent again, so that the application can tell
+*                   why a scheduled job is waiting.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_HELO (NET_SOCK_ID   sock_id,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+static  CPU_BOOLEAN  SMTPc_SchedRetry (SMTPc_JOB  *p_job,
+                                      SMTPc_ERR   err)
 {
-    CPU_CHAR        *reply;
-    CPU_SIZE_T       len;
-    CPU_INT08U       client_addr[NET_CONN_ADDR_LEN_MAX];
-    NET_SOCK_FAMILY  client_addr_family;
-    NET_ERR          err_net;
-    CPU_CHAR         client_addr_ascii[NET_ASCII_LEN_MAX_ADDR_IP];
-    NET_IPv4_ADDR    ipv4_client_addr;
+    CPU_INT32U  dly_ms;
+    CPU_INT32U  rand;
+    CPU_INT08U  i;
+    CPU_SR_ALLOC();
 
-                                                                /* Get the IP address used in the conn.                 */
-    NetSock_GetLocalIPAddr(sock_id,
-                           client_addr,
-                          &client_addr_family,
-                          &err_net);
-    if (err_net != NET_SOCK_ERR_NONE) {
-       *perr = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
-                                                                /* Format the message depending of the address family.  */
 
-    switch (client_addr_family) {
-#ifdef  NET_IPv4_MODULE_EN
-        case NET_SOCK_FAMILY_IP_V4:
+    if (SMTPc_ErrIsTransient(err, p_job->RepCode) != DEF_YES) {
+        return (DEF_NO);
+    }
+    if (p_job->RetryCtr >= SMTPc_SchedRetryNbrMax) {
+        return (DEF_NO);
+    }
+                                                                /* ------------------- BACKOFF DLY -------------------- */
+    dly_ms = SMTPc_SchedRetryDlyMin_ms;                         /* See Note #1.                                         */
+    for (i = 0u; i < p_job->RetryCtr; i++) {
+        if (dly_ms > (SMTPc_SchedRetryDlyMax_ms / 2u)) {
+            dly_ms = SMTPc_SchedRetryDlyMax_ms;
+            break;
+        }
+        dly_ms *= 2u;
+    }
+                                                                /* ---------------------- JITTER ---------------------- */
+    CPU_CRITICAL_ENTER();
+    rand                  = SMTPc_SchedRandState;
+    rand                 ^= rand << 13u;
+    rand                 ^= rand >> 17u;
+    rand                 ^= rand <<  5u;
+    SMTPc_SchedRandState  = rand;
+    p_job->Err            = err;                                /* See Note #2.                                         */
+    CPU_CRITICAL_EXIT();
+
+    dly_ms -= rand % ((dly_ms / 2u) + 1u);
+
+    p_job->RetryCtr++;
+    SMTPc_SchedAdd(p_job, dly_ms);
+
+    return (DEF_YES);
+}
+#endif
 
-             ipv4_client_addr = NET_UTIL_NET_TO_HOST_32(*(CPU_INT32U *)client_addr);
-             NetASCII_IPv4_to_Str(ipv4_client_addr, client_addr_ascii, DEF_NO, &err_net);
 
-             if (err_net != NET_ASCII_ERR_NONE) {
-                *perr = SMTPc_ERR_TX_FAILED;
-                 return ((CPU_CHAR *)0);
-             }
+/*
+*********************************************************************************************************
+*                                          SMTPc_SchedTask()
+*
+* Description : Queue the scheduled jobs once due, every SMTPc_CFG_SCHED_TICK_MS.
+*
+* Argument(s) : p_arg           Argument passed to the task (unused).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Kernel (created by SMTPc_QueueInit()).
+*
+* Note(s)     : (1) The jobs due are taken from the wheel with the lock held, then queued once it is
+*                   released, so that the lock is never held while posting to the job queue.
+*
+*               (2) A job the job queue could not accept is scheduled again on the next tick.
+*
+*               (3) The ticks are counted by the task, so that time spent processing them delays the next
+*                   ones : delays are minimums.
+*********************************************************************************************************
+*/
 
-              Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_HELO);
-              Str_Cat(SMTPc_Comm_Buf," [");
-              Str_Cat(SMTPc_Comm_Buf,client_addr_ascii);
-              Str_Cat(SMTPc_Comm_Buf,"]\r\n");
-              break;
-#endif
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+static  void  SMTPc_SchedTask (void  *p_arg)
+{
+    SMTPc_JOB  *p_job;
+    SMTPc_JOB  *p_job_next;
+    KAL_ERR     err_kal;
+    CPU_SR_ALLOC();
 
-#ifdef  NET_IPv6_MODULE_EN
-        case NET_SOCK_FAMILY_IP_V6:
 
-             NetASCII_IPv6_to_Str((NET_IPv6_ADDR *) client_addr,
-                                                    client_addr_ascii,
-                                                    DEF_NO,
-                                                    DEF_NO,
-                                                   &err_net);
-             if (err_net != NET_ASCII_ERR_NONE) {
-                *perr = SMTPc_ERR_TX_FAILED;
-                 return ((CPU_CHAR *)0);
-             }
+   (void)&p_arg;                                                /* Prevent 'variable unused' compiler warning.          */
 
-             Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_HELO);
-             Str_Cat(SMTPc_Comm_Buf, " [");
-             Str_Cat(SMTPc_Comm_Buf, SMTPc_TAG_IPv6);
-             Str_Cat(SMTPc_Comm_Buf, " ");
-             Str_Cat(SMTPc_Comm_Buf, client_addr_ascii);
-             Str_Cat(SMTPc_Comm_Buf, "]\r\n");
-             break;
-#endif
-         default:
-            *perr = SMTPc_ERR_TX_FAILED;
-             return ((CPU_CHAR *)0);
-    }
+    while (DEF_ON) {
+        KAL_Dly(SMTPc_CFG_SCHED_TICK_MS);                       /* See Note #3.                                         */
 
-    len = Str_Len(SMTPc_Comm_Buf);
-                                                                /* Send HELO Query.                                     */
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
+        KAL_LockAcquire(SMTPc_SchedLockHandle, KAL_OPT_PEND_NONE, KAL_TIMEOUT_INFINITE, &err_kal);
+        p_job = SMTPc_SchedTick();                              /* See Note #1.                                         */
+        KAL_LockRelease(SMTPc_SchedLockHandle, &err_kal);
 
-                                                                /* --------- RX SERVER'S REPLY & VALIDATE ------------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
+        while (p_job != (SMTPc_JOB *)0) {
+            p_job_next = p_job->SchedNextPtr;
 
-    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
-            *perr = SMTPc_ERR_NONE;                             /* ... no err.                                          */
-             break;
+            CPU_CRITICAL_ENTER();
+            p_job->Status = SMTPc_JOB_STATUS_PEND;
+            CPU_CRITICAL_EXIT();
 
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
-             break;
+            KAL_QPost(SMTPc_QueueHandle, p_job, KAL_OPT_POST_NONE, &err_kal);
+            if (err_kal != KAL_ERR_NONE) {                      /* See Note #2.                                         */
+                SMTPc_SchedAdd(p_job, 1u);
+            }
 
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
+            p_job = p_job_next;
+        }
     }
-
-    return (reply);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                            SMTPc_AUTH()
+*                                            SMTPc_NetOpen()
 *
-* Description : (1) Build the AUTH command, send it to the server and validate reply.
+* Description : Open a TCP connection to a server, using uC/TCP-IP (see 'smtp-c.h  SMTPc_TRANSPORT_API').
 *
-*                   (a) Encode username & password
-*                   (b) Send command to the server
-*                   (c) Receive server's reply and validate
+* Argument(s) : p_host_name     Pointer to host name or IP address of the server.
 *
+*               port            TCP port of the server.
 *
-* Argument(s) : sock_id          Socket ID.
-*               username         Mailbox username name for authentication.
-*               pw               Mailbox password      for authentication.
-*               completion_code  Numeric value returned by server indicating command status.
-*               perr             Pointer to variable that will hold the return error code from this
-*                                function :
+*               p_secure_cfg    Pointer to the secure configuration (TLS/SSL), DEF_NULL if none.
 *
-*                                SMTPc_ERR_NONE                     No error.
-*                                SMTPc_ERR_TX_FAILED                Error querying server.
-*                                SMTPc_ERR_RX_FAILED                Error receiving server reply.
-*                                SMTPc_ERR_REP                      Error with reply.
-*                                SMTPc_ERR_ENCODE                   Error encoding credentials.
-*                                SMTPc_ERR_AUTH_FAILED              Error authenticating user.
+*               timeout_ms      Time to wait for the server to accept the connection, in milliseconds.
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
 *
-*               (CPU_CHAR *)0,                  otherwise.
+*                               SMTPc_ERR_NONE                      No error, connection established.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Error connecting to server.
 *
-* Caller(s)   : SMTPc_Connect().
+* Return(s)   : Socket descriptor/handle identifier, if NO error.
 *
-* Note(s)     : (2) The user's credentials are transmitted to the server using a base 64 encoding and
-*                   formated according to RFC #4616.  From Section 2 'PLAIN SALS Mechanism' "The client
-*                   presents the authorization identity (identity to act as), followed by a NUL (U+0000)
-*                   character, followed by the authentication identity (identity whose password will be
-*                   used), followed by a NUL (U+0000) character, followed by the clear-text password.
-*                   As with other SASL mechanisms, the client does not provide an authorization identity
-*                   when it wishes the server to derive an identity from the credentials and use that
-*                   as the authorization identity."
+*               SMTPc_SOCK_ID_NONE,                    otherwise.
 *
-*               (3) The server will send a 235 "Authentication successful" reply upon success.  A positive
-*                   reply is the only reply that will lead to a  "SMTPc_ERR_NONE" error return code.
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Net.
 *
-*               (4) This implementation will accept reply 235, as well as any other positive reply.
+* Note(s)     : (1) uC/TCP-IP cannot return a connection being established : without timeout, the connection
+*                   request waits at most SMTPc_CFG_MAX_CONN_REQ_TIMEOUT_MS.
 *********************************************************************************************************
 */
 
-#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
-static  CPU_CHAR  *SMTPc_AUTH (NET_SOCK_ID   sock_id,
-                               CPU_CHAR     *username,
-                               CPU_CHAR     *pw,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  SMTPc_SOCK_ID  SMTPc_NetOpen (CPU_CHAR                 *p_host_name,
+                                      CPU_INT16U                port,
+                                      SMTPc_SECURE_CFG         *p_secure_cfg,
+                                      CPU_INT32U                timeout_ms,
+                                      SMTPc_ERR                *p_err)
 {
-    CPU_CHAR     unencoded_buf[SMTPc_ENCODER_BASE54_IN_MAX_LEN];
-    CPU_CHAR     encoded_buf[SMTPc_ENCODER_BASE64_OUT_MAX_LEN];
-    CPU_INT16U   unencoded_len;
-    CPU_CHAR    *reply;
-    CPU_INT16U   wr_ix;
-    CPU_SIZE_T   len;
-    NET_ERR      net_err;
-
-                                                                /* -------------- ENCODE USERNAME & PW ---------------- */
-                                                                /* See Note #2.                                         */
-    wr_ix = 0;
-    unencoded_buf[wr_ix] = SMTPc_ENCODER_BASE64_DELIMITER_CHAR;
-    wr_ix++;
-
-    Str_Copy(&unencoded_buf[wr_ix], username);
-    wr_ix += Str_Len(username);
-
-    unencoded_buf[wr_ix] = SMTPc_ENCODER_BASE64_DELIMITER_CHAR;
-    wr_ix++;
+    NET_SOCK_ID    sock_id;
+    NET_SOCK_ADDR  sock_addr;
+    NET_ERR        err_net;
 
-    Str_Copy(&unencoded_buf[wr_ix], pw);
-    unencoded_len = wr_ix + Str_Len(pw);
-
-                                                                /* Base 64 encoding.                                    */
-    NetBase64_Encode (unencoded_buf, unencoded_len, encoded_buf, SMTPc_ENCODER_BASE64_OUT_MAX_LEN, &net_err);
-    if (net_err != NET_ERR_NONE) {
-       *perr = SMTPc_ERR_ENCODE;
-        return ((CPU_CHAR *)0);
-    }
-
-                                                                /* ------------------ TX CMD TO SERVER ---------------- */
-    Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_AUTH);
-    Str_Cat(SMTPc_Comm_Buf, " ");
-    Str_Cat(SMTPc_Comm_Buf, SMTPc_CMD_AUTH_MECHANISM_PLAIN);
-    Str_Cat(SMTPc_Comm_Buf, " ");
-    Str_Cat(SMTPc_Comm_Buf, encoded_buf);
-    Str_Cat(SMTPc_Comm_Buf, "\r\n");
-    len = Str_Len(SMTPc_Comm_Buf);
 
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
+    sock_id = NET_SOCK_ID_NONE;
+                                                                /* See Note #1.                                         */
+    if (timeout_ms == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+        timeout_ms = SMTPc_CFG_MAX_CONN_REQ_TIMEOUT_MS;
     }
 
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
+    NetApp_ClientStreamOpenByHostname(&sock_id,
+                                       p_host_name,
+                                       port,
+                                      &sock_addr,
+                                       p_secure_cfg,
+                                       timeout_ms,
+                                      &err_net);
+    if (err_net != NET_APP_ERR_NONE) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
     }
 
+   *p_err = SMTPc_ERR_NONE;
 
-    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
-            *perr = SMTPc_ERR_NONE;                             /* ... no err.                                          */
-             break;
-
-        case SMTPc_ERR_REP_NEG:
-             if (*completion_code == SMTPc_REP_535) {
-                *perr = SMTPc_ERR_AUTH_FAILED;
-             } else {
-                *perr = SMTPc_ERR_REP;
-             }
-             break;
-
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
-             break;
-
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
-    }
-
-    return (reply);
+    return ((SMTPc_SOCK_ID)sock_id);
 }
 #endif
 
+
 /*
 *********************************************************************************************************
-*                                             SMTPc_MAIL()
+*                                             SMTPc_NetTx()
 *
-* Description : (1) Build the MAIL command, send it to the server and validate reply.
+* Description : Send data on a socket, using uC/TCP-IP.
 *
-*                   (a) Send command to the server
-*                   (b) Receive server's reply and validate
+* Argument(s) : sock_id         Socket to send on.
 *
+*               p_data          Pointer to the data to send.
 *
-* Argument(s) : sock_id         Socket ID.
-*               from            Argument of the "MAIL" command (sender mailbox).
-*               completion_code Numeric value returned by server indicating command status.
-*               perr            Pointer to variable that will hold the return error code from this
-*                               function :
+*               len             Length of the data.
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
+*                               SMTPc_ERR_NONE                      No error, data (partially) sent.
+*                               SMTPc_ERR_WOULD_BLOCK               Nothing could be sent (see Note #2).
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
 *
-*               (CPU_CHAR *)0,                  otherwise.
+* Return(s)   : Number of octets sent, if NO error.
 *
-* Caller(s)   : SMTPc_SendMsg().
+*               0,                     otherwise.
 *
-* Note(s)     : (2) From RFC #2821, "the MAIL command is used to initiate a mail transaction in which
-*                   the mail data is delivered to an SMTP server [...]".
+* Caller(s)   : SMTPc_NetTxV(),
+*               SMTPc_AsyncTx(), through SMTPc_TransportAPI_Net.
 *
-*               (3) The server will send a 250 "Requested mail action okay, completed" reply upon
-*                   success.  A positive reply is the only reply that will lead to a  "SMTPc_ERR_NONE"
-*                   error return code.
+* Note(s)     : (1) NetSock_TxData() sends at most DEF_INT_16U_MAX_VAL octets per call; the caller sends the
+*                   rest on the next call.
 *
-*               (4) This implementation will accept reply 250, as well as any other positive reply.
+*               (2) NET_ERR_TX is a transitory error : the transmit queue of the socket is full, or the
+*                   non-blocking socket could not send yet.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_MAIL (NET_SOCK_ID   sock_id,
-                               CPU_CHAR     *from,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  CPU_INT32U  SMTPc_NetTx (SMTPc_SOCK_ID  sock_id,
+                                 const  void   *p_data,
+                                 CPU_INT32U     len,
+                                 SMTPc_ERR     *p_err)
 {
-    CPU_CHAR    *reply;
-    CPU_SIZE_T   len;
-
-                                                                /* ----------------- TX CMD TO SERVER ----------------- */
-    Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_MAIL);
-    Str_Cat(SMTPc_Comm_Buf, " FROM:<");
-    Str_Cat(SMTPc_Comm_Buf, from);
-    Str_Cat(SMTPc_Comm_Buf, ">\r\n");
-
-    len = Str_Len(SMTPc_Comm_Buf);
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
-
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
+    NET_SOCK_RTN_CODE  rtn_code;
+    NET_ERR            err_net;
+
+
+    len      = DEF_MIN(len, DEF_INT_16U_MAX_VAL);               /* See Note #1.                                         */
+    rtn_code = NetSock_TxData((NET_SOCK_ID)sock_id,
+                              (void *)p_data,
+                              (CPU_INT16U)len,
+                              NET_SOCK_FLAG_NONE,
+                             &err_net);
+    if (rtn_code > 0) {
+       *p_err = SMTPc_ERR_NONE;
+        return ((CPU_INT32U)rtn_code);
     }
 
-
-    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:                                 /* If any pos rep...                                    */
-            *perr = SMTPc_ERR_NONE;                             /* ... no err.                                          */
-             break;
-
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
-             break;
-
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
+    if (err_net == NET_ERR_TX) {                                /* See Note #2.                                         */
+       *p_err = SMTPc_ERR_WOULD_BLOCK;
+    } else {
+       *p_err = SMTPc_ERR_TX_FAILED;
     }
 
-    return (reply);
+    return (0u);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                             SMTPc_RCPT()
+*                                            SMTPc_NetTxV()
 *
-* Description : (1) Build the RCPT command, send it to the server and validate reply.
+* Description : Send several buffers on a socket, in order, using uC/TCP-IP.
+*
+* Argument(s) : sock_id         Socket to send on.
 *
-*                   (a) Send command to the server
-*                   (b) Receive server's reply and validate
+*               p_vec           Pointer to the table of buffers.
 *
+*               vec_nbr         Number of buffers.
 *
-* Argument(s) : sock_id         Socket ID.
-*               to              Argument of the "RCPT" command (receiver mailbox).
-*               completion_code Numeric value returned by server indicating command status.
-*               perr            Pointer to variable that will hold the return error code from this
+*               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
-*
-* Return(s)   : Complete reply from the server, if NO reception error.
+*                               SMTPc_ERR_NONE                      No error, data (partially) sent.
 *
-*               (CPU_CHAR *)0,                  otherwise.
+*                                                                   ------- RETURNED BY SMTPc_NetTx() : -------
+*                               SMTPc_ERR_WOULD_BLOCK               Nothing could be sent.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
 *
-* Caller(s)   : SMTPc_SendMsg().
+* Return(s)   : Number of octets sent, if NO error.
 *
-* Note(s)     : (2) From RFC #2821, "the RCPT command is used to identify an individual recipient of the
-*                   mail data; multiple recipients are specified by multiple use of this command".
+*               0,                     otherwise.
 *
-*               (3) The server will send a 250 "Requested mail action okay, completed"  or a 251 "User
-*                   not local; will forwarded to <forward-path>" reply upon success.
+* Caller(s)   : SMTPc_TxSockV(), through SMTPc_TransportAPI_Net.
 *
-*               (4) This implementation will accept replies 250 and 251 as positive replies.  Reply 551
-*                   "User not local; please try <forward-path>" will result in an error.
+* Note(s)     : (1) uC/TCP-IP has no gather send : the buffers are sent one after the other, until one is
+*                   only partially sent.  An error after some data was sent is reported on the next call.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_RCPT (NET_SOCK_ID   sock_id,
-                               CPU_CHAR     *to,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  CPU_INT32U  SMTPc_NetTxV (SMTPc_SOCK_ID                sock_id,
+                                  const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                  CPU_INT08U                   vec_nbr,
+                                  SMTPc_ERR                   *p_err)
 {
-    CPU_CHAR    *reply;
-    CPU_SIZE_T   len;
-
-                                                                /* ----------------- TX CMD TO SERVER ----------------- */
-    Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_RCPT);
-    Str_Cat(SMTPc_Comm_Buf, " TO:<");
-    Str_Cat(SMTPc_Comm_Buf, to);
-    Str_Cat(SMTPc_Comm_Buf, ">\r\n");
+    CPU_INT32U  tx_len;
+    CPU_INT32U  tx_len_tot;
+    CPU_INT08U  i;
 
-    len = Str_Len(SMTPc_Comm_Buf);
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
 
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
+    tx_len_tot = 0u;
 
-    SMTPc_ParseReply(reply, completion_code, perr);             /* See Note #4.                                         */
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:
-             if ((*completion_code == SMTPc_REP_250) ||
-                 (*completion_code == SMTPc_REP_251)) {
-                *perr = SMTPc_ERR_NONE;
-             } else {
-                *perr = SMTPc_ERR_REP;
-             }
-             break;
+    for (i = 0u; i < vec_nbr; i++) {                            /* See Note #1.                                         */
+        if (p_vec[i].Len == 0u) {
+            continue;
+        }
 
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
-             break;
+        tx_len = SMTPc_NetTx(sock_id, p_vec[i].DataPtr, p_vec[i].Len, p_err);
+        if (*p_err != SMTPc_ERR_NONE) {
+            if (tx_len_tot > 0u) {
+               *p_err = SMTPc_ERR_NONE;
+            }
+            break;
+        }
 
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
+        tx_len_tot += tx_len;
+        if (tx_len < p_vec[i].Len) {
+            break;
+        }
     }
 
-    return (reply);
+    return (tx_len_tot);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                             SMTPc_DATA()
+*                                             SMTPc_NetRx()
 *
-* Description : (1) Build the DATA command, send it to the server and validate reply.
+* Description : Receive data from a socket, using uC/TCP-IP.
 *
-*                   (a) Send command to the server
-*                   (b) Receive server's reply and validate
+* Argument(s) : sock_id         Socket to receive from.
 *
+*               p_buf           Pointer to the buffer that will receive the data.
 *
-* Argument(s) : sock_id         Socket ID.
-*               completion_code Numeric value returned by server indicating command status.
-*               perr            Pointer to variable that will hold the return error code from this
-*                               function :
+*               len             Size of the buffer.
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
+*                               SMTPc_ERR_NONE                      No error, data received.
+*                               SMTPc_ERR_WOULD_BLOCK               No data available yet (see Note #1).
+*                               SMTPc_ERR_RX_FAILED                 Error receiving, or connection closed.
 *
-*               (CPU_CHAR *)0,                  otherwise.
+* Return(s)   : Number of octets received, if NO error.
 *
-* Caller(s)   : SMTPc_SendMsg().
+*               0,                         otherwise.
 *
-* Note(s)     : (2) The DATA command is used to indicate to the SMTP server that all the following lines
-*                   up to but not including the end of mail data indicator are to be considered as the
-*                   message text.
+* Caller(s)   : SMTPc_RxReply(), through SMTPc_TransportAPI_Net.
 *
-*               (3) The receiver normally sends a 354 "Start mail input" reply and then treats the lines
-*                   following the command as mail data from the sender.
+* Note(s)     : (1) NET_SOCK_ERR_RX_Q_EMPTY is returned when a non-blocking socket has nothing to receive,
+*                   or when the receive timeout of a blocking socket expired.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_DATA (NET_SOCK_ID   sock_id,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  CPU_INT32U  SMTPc_NetRx (SMTPc_SOCK_ID  sock_id,
+                                 void          *p_buf,
+                                 CPU_INT32U     len,
+                                 SMTPc_ERR     *p_err)
 {
-    CPU_CHAR    *reply;
-    CPU_SIZE_T   len;
-
-                                                                /* ----------------- TX CMD TO SERVER ----------------- */
-    Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_DATA);
-    Str_Cat(SMTPc_Comm_Buf, "\r\n");
+    NET_SOCK_RTN_CODE  rx_len;
+    NET_ERR            err_net;
 
 
-    len = Str_Len(SMTPc_Comm_Buf);
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
+    len    = DEF_MIN(len, DEF_INT_16U_MAX_VAL);
+    rx_len = NetSock_RxData((NET_SOCK_ID)sock_id,
+                            p_buf,
+                            (CPU_INT16U)len,
+                            NET_SOCK_FLAG_NONE,
+                           &err_net);
+    if (rx_len <= 0) {
+        if (err_net == NET_SOCK_ERR_RX_Q_EMPTY) {               /* See Note #1.                                         */
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+        } else {
+           *p_err = SMTPc_ERR_RX_FAILED;
+        }
+        return (0u);
     }
 
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
+   *p_err = SMTPc_ERR_NONE;
 
-    SMTPc_ParseReply(reply, completion_code, perr);
-    switch (*perr) {
-        case SMTPc_ERR_REP_INTER:
-             if (*completion_code == SMTPc_REP_354) {
-                *perr = SMTPc_ERR_NONE;
-             } else {
-                *perr = SMTPc_ERR_REP;
-             }
-             break;
+    return ((CPU_INT32U)rx_len);
+}
+#endif
 
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
-             break;
 
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
-    }
+/*
+*********************************************************************************************************
+*                                            SMTPc_NetClose()
+*
+* Description : Close a socket, using uC/TCP-IP.
+*
+* Argument(s) : sock_id         Socket to close.
+*
+*               timeout_ms      Time to wait for the connection to be closed, in milliseconds.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various, through SMTPc_TransportAPI_Net.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
 
-    return (reply);
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  void  SMTPc_NetClose (SMTPc_SOCK_ID  sock_id,
+                              CPU_INT32U     timeout_ms)
+{
+    NET_ERR  err_net;
+
+
+    NetApp_SockClose((NET_SOCK_ID)sock_id, timeout_ms, &err_net);
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                             SMTPc_RSET()
+*                                         SMTPc_NetDeadlineSet()
 *
-* Description : (1) Build the RSET command, send it to the server and validate reply.
+* Description : Configure the blocking mode & the timeouts of a socket, using uC/TCP-IP.
 *
-*                   (a) Send command to the server
-*                   (b) Receive server's reply and validate
+* Argument(s) : sock_id         Socket to configure.
 *
+*               timeout_ms      SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, SMTPc_TRANSPORT_TIMEOUT_INFINITE, or time
+*                               to wait on each receive & transmit, in milliseconds.
 *
-* Argument(s) : sock_id         Socket ID.
-*               completion_code Numeric value returned by server indicating command status.
-*               perr            Pointer to variable that will hold the return error code from this
+*               p_err           Pointer to variable that will hold the return error code from this
 *                               function :
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
+*                               SMTPc_ERR_NONE                      No error, socket configured.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Error configuring the socket.
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
-*
-*               (CPU_CHAR *)0,                  otherwise.
-*
-* Caller(s)   : SMTPc_SendMsg().
+* Return(s)   : none.
 *
-* Note(s)     : (2) From RFC #2821, "the RSET command specifies that the current mail transaction will
-*                   be aborted.  Any stored sender, recipients, and mail data MUST be discarded, and all
-*                   buffers and state tables cleared".
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Net.
 *
-*               (3) The server MUST send a 250 "Requested mail action okay, completed" reply to a RSET
-*                   command with no arguments.
+* Note(s)     : (1) With SMTPc_TRANSPORT_TIMEOUT_INFINITE, the timeouts of the socket are left to their
+*                   default values.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_RSET (NET_SOCK_ID   sock_id,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  void  SMTPc_NetDeadlineSet (SMTPc_SOCK_ID  sock_id,
+                                    CPU_INT32U     timeout_ms,
+                                    SMTPc_ERR     *p_err)
 {
-    CPU_CHAR    *reply;
-    CPU_SIZE_T   len;
-
-                                                                /* ----------------- TX CMD TO SERVER ----------------- */
-    Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_RSET);
-    Str_Cat(SMTPc_Comm_Buf, "\r\n");
+    NET_ERR  err_net;
 
-    len = Str_Len(SMTPc_Comm_Buf);
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
 
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
+    if (timeout_ms == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+       (void)NetSock_CfgBlock((NET_SOCK_ID)sock_id, NET_SOCK_BLOCK_SEL_NO_BLOCK, &err_net);
+    } else {
+       (void)NetSock_CfgBlock((NET_SOCK_ID)sock_id, NET_SOCK_BLOCK_SEL_BLOCK, &err_net);
+        if ((err_net    == NET_SOCK_ERR_NONE) &&
+            (timeout_ms != SMTPc_TRANSPORT_TIMEOUT_INFINITE)) { /* See Note #1.                                         */
+           (void)NetSock_CfgTimeoutRxQ_Set((NET_SOCK_ID)sock_id, timeout_ms, &err_net);
+            if (err_net == NET_SOCK_ERR_NONE) {
+               (void)NetSock_CfgTimeoutTxQ_Set((NET_SOCK_ID)sock_id, timeout_ms, &err_net);
+            }
+        }
     }
 
-    SMTPc_ParseReply(reply, completion_code, perr);
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:
-             if (*completion_code == SMTPc_REP_250) {
-                *perr = SMTPc_ERR_NONE;
-             } else {
-                *perr = SMTPc_ERR_REP;
-             }
-             break;
-
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
-             break;
-
-        default:
-            *perr = SMTPc_ERR_REP;
-             break;
+    if (err_net != NET_SOCK_ERR_NONE) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
     }
 
-    return (reply);
+   *p_err = SMTPc_ERR_NONE;
 }
+#endif
 
 
 /*
 *********************************************************************************************************
-*                                             SMTPc_QUIT()
+*                                        SMTPc_NetLocalAddrGet()
 *
-* Description : (1) Build the QUIT command, send it to the server and validate reply.
+* Description : Get the local IP address of a connected socket, as a string, using uC/TCP-IP.
 *
-*                   (a) Send command to the server
-*                   (b) Receive server's reply and validate
+* Argument(s) : sock_id         Socket to get the address of.
 *
+*               p_addr          Pointer to the buffer that will receive the address, of at least
+*                               SMTPc_TRANSPORT_ADDR_LEN characters.
 *
-* Argument(s) : sock_id         Socket ID.
-*               completion_code Numeric value returned by server indicating command status.
-*               perr            Pointer to variable that will hold the return error code from this
-*                               function :
+*               p_family        Pointer to the variable that will receive the address family :
 *
-*                               SMTPc_ERR_NONE                      No error.
-*                               SMTPc_ERR_TX_FAILED                 Error querying server.
-*                               SMTPc_ERR_RX_FAILED                 Error receiving server reply.
-*                               SMTPc_ERR_REP                       Error with reply.
+*                                   SMTPc_TRANSPORT_FAMILY_IPv4
+*                                   SMTPc_TRANSPORT_FAMILY_IPv6
 *
-* Return(s)   : Complete reply from the server, if NO reception error.
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
 *
-*               (CPU_CHAR *)0,                  otherwise.
+*                               SMTPc_ERR_NONE                      No error, address returned.
+*                               SMTPc_ERR_TX_FAILED                 Error getting or formatting the address.
 *
-* Caller(s)   : SMTPc_Disconnect().
+* Return(s)   : none.
 *
-* Note(s)     : (2) From RFC #2821, "the QUIT command specifies that the receiver MUST send an OK reply,
-*                   and then close the transmission channel.  The receiver MUST NOT intentionally close
-*                   the transmission channel until it receives and replies to a QUIT command (even if
-*                   there was an error).  the sender MUST NOT intentionally close the transmission
-*                   channel until it sends a QUIT command and SHOULD wait until it receives the reply
-*                   (even if there was an error response to a previous command)".
+* Caller(s)   : SMTPc_BuildHELO(), through SMTPc_TransportAPI_Net.
 *
-*               (3) The server MUST send a 221 "Service closing transmission channel" reply to a QUIT
-*                   command.
+* Note(s)     : none.
 *********************************************************************************************************
 */
 
-static  CPU_CHAR  *SMTPc_QUIT (NET_SOCK_ID   sock_id,
-                               CPU_INT32U   *completion_code,
-                               SMTPc_ERR    *perr)
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  void  SMTPc_NetLocalAddrGet (SMTPc_SOCK_ID  sock_id,
+                                     CPU_CHAR      *p_addr,
+                                     CPU_INT08U    *p_family,
+                                     SMTPc_ERR     *p_err)
 {
-    CPU_CHAR    *reply;
-    CPU_SIZE_T   len;
-
-                                                                /* ----------------- TX CMD TO SERVER ----------------- */
-    Str_Copy(SMTPc_Comm_Buf, SMTPc_CMD_QUIT);
-    Str_Cat(SMTPc_Comm_Buf, "\r\n");
-    len = Str_Len(SMTPc_Comm_Buf);
+    CPU_INT08U       addr[NET_CONN_ADDR_LEN_MAX];
+    NET_SOCK_FAMILY  addr_family;
+    NET_ERR          err_net;
+#ifdef  NET_IPv4_MODULE_EN
+    NET_IPv4_ADDR    ipv4_addr;
+#endif
 
-    SMTPc_QueryServer(sock_id, SMTPc_Comm_Buf, len, perr);
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_TX_FAILED;
-        return ((CPU_CHAR *)0);
-    }
 
-                                                                /* ---------- RX SERVER'S RESPONSE & VALIDATE --------- */
-    reply = SMTPc_RxReply(sock_id, perr);                       /* See Note #3.                                         */
-    if (*perr != SMTPc_ERR_NONE) {
-       *perr  = SMTPc_ERR_RX_FAILED;
-        return ((CPU_CHAR *)0);
+    NetSock_GetLocalIPAddr((NET_SOCK_ID)sock_id,
+                           addr,
+                          &addr_family,
+                          &err_net);
+    if (err_net != NET_SOCK_ERR_NONE) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
     }
 
-    SMTPc_ParseReply(reply, completion_code, perr);
-    switch (*perr) {
-        case SMTPc_ERR_REP_POS:
-             if (*completion_code == SMTPc_REP_221) {
-                *perr = SMTPc_ERR_NONE;
-             } else {
-                *perr = SMTPc_ERR_REP;
-             }
+    switch (addr_family) {
+#ifdef  NET_IPv4_MODULE_EN
+        case NET_SOCK_FAMILY_IP_V4:
+             ipv4_addr = NET_UTIL_NET_TO_HOST_32(*(CPU_INT32U *)addr);
+             NetASCII_IPv4_to_Str(ipv4_addr, p_addr, DEF_NO, &err_net);
+            *p_family  = SMTPc_TRANSPORT_FAMILY_IPv4;
              break;
+#endif
 
-        case SMTPc_ERR_REP_TOO_SHORT:
-            *perr = SMTPc_ERR_REP;
-             reply = (CPU_CHAR *)0;
+#ifdef  NET_IPv6_MODULE_EN
+        case NET_SOCK_FAMILY_IP_V6:
+             NetASCII_IPv6_to_Str((NET_IPv6_ADDR *)addr,
+                                                   p_addr,
+                                                   DEF_NO,
+                                                   DEF_NO,
+                                                  &err_net);
+            *p_family  = SMTPc_TRANSPORT_FAMILY_IPv6;
              break;
+#endif
 
         default:
-            *perr = SMTPc_ERR_REP;
-             break;
+            *p_err = SMTPc_ERR_TX_FAILED;
+             return;
     }
 
-    return (reply);
+    if (err_net != NET_ASCII_ERR_NONE) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         SMTPc_NetTS_Get_ms()
+*
+* Description : Get the current time, using uC/TCP-IP.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Current time, in milliseconds.
+*
+* Caller(s)   : SMTPc_TS_Get_ms(), through SMTPc_TransportAPI_Net.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+static  SMTPc_TS_MS  SMTPc_NetTS_Get_ms (void)
+{
+    return ((SMTPc_TS_MS)NetUtil_TS_Get_ms());
 }
+#endif
@@ -25,6 +25,7 @@
 * Note(s)  : (1) This code implements a subset of the SMTP protocol (RFC 2821).  More precisely, the
 *                following commands have been implemented:
 *
+*                  EHLO (RFC 1869, falls back to HELO)
 *                  HELO
 *                  AUTH (if enabled)
 *                  MAIL
@@ -101,7 +102,8 @@
 *
 *               (a) \<Your Product Application>\smtp-c_cfg.h
 *
-*               (b) (1) \<Network Protocol Suite>\Source\net_*.*
+*               (b) (1) \<Network Protocol Suite>\Source\net_*.*, if the uC/TCP-IP transport is enabled (see
+*                       'smtp-c_cfg.h  Note #18').
 *
 *                   (2) If network security manager is to be used:
 *
@@ -162,16 +164,24 @@
 
 #include  <lib_def.h>                                           /* Standard        Defines        (see Note #3a)        */
 #include  <lib_str.h>                                           /* Standard String Library        (see Note #3a)        */
+#include  <lib_mem.h>                                           /* Standard Memory Library        (see Note #3a)        */
+#include  <lib_ascii.h>                                         /* Standard ASCII Library         (see Note #3a)        */
 
 
-#include  <Source/net.h>                                        /* Network Protocol Suite         (see Note #1b)        */
 #include  <smtp-c_cfg.h>
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+#include  <Source/net.h>                                        /* Network Protocol Suite         (see Note #1b)        */
 #include  <Source/net_app.h>
 #include  <Source/net_sock.h>
 #include  <Source/net_conn.h>
 #include  <Source/net_ascii.h>
 #include  <Source/net_util.h>
-#include  <Modules/Common/net_base64.h>
+#endif
+
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+#include  <KAL/kal.h>                                           /* Kernel Abstraction Layer                             */
+#endif
 
 
 #if 1                                                           /* See Note #3b.                                        */
@@ -212,6 +222,17 @@ typedef enum smtpc_err {
     SMTPc_ERR_REP_TOO_SHORT                        = 51015u,
   
     SMTPc_ERR_INVALID_ADDR                         = 51016u,
+    SMTPc_ERR_NOT_CONNECTED                        = 51017u,
+    SMTPc_ERR_POOL_EMPTY                           = 51018u,
+    SMTPc_ERR_BODY_RD_FAILED                       = 51019u,
+    SMTPc_ERR_WOULD_BLOCK                          = 51020u,
+    SMTPc_ERR_TIMEOUT                              = 51021u,
+    SMTPc_ERR_NOT_RENDERED                         = 51022u,
+    SMTPc_ERR_QUEUE_FULL                           = 51023u,
+    SMTPc_ERR_NOT_INIT                             = 51024u,
+    SMTPc_ERR_INIT_FAILED                          = 51025u,
+    SMTPc_ERR_INVALID_CFG                          = 51026u,
+    SMTPc_ERR_SPOOL_IO                             = 51027u,
 
 } SMTPc_ERR;
 
@@ -230,6 +251,9 @@ typedef enum smtpc_err {
 *               This buffer is also used to build outgoing messages and MUST NOT be smaller than 1000
 *               (see Note #1).
 *
+*               SMTPc_RX_BUF_LEN is the length of the buffer holding the replies received from the server.
+*               It MUST be large enough for the longest multi-line reply expected (e.g. EHLO reply).
+*
 *           (3) Maximum length of key-value strings in structure SMTPc_KEY_VAL.
 *
 *           (4) As mentioned in RFC #2821, Section 'The SMTP Specifications, Additional
@@ -238,7 +262,7 @@ typedef enum smtpc_err {
 *               total length of a domain name or number is 255 characters.".  Adding 2 for
 *               '@' (see SMTPc_MBOX structure) and '\0'.
 *
-*           (5) Maximum length of content-type.
+*           (5) Maximum length of content-type, including '\0'.
 *
 *           (6) From RFC #2822, Section 'Syntax, Fields definitions, Identification fields', "The message
 *               identifier (msg-id) [field] is similar in syntax to an angle-addr construct".
@@ -246,12 +270,18 @@ typedef enum smtpc_err {
 *           (7) Size of ParamArray in structure SMTPc_MIME_ENTITY_HDR.
 *
 *           (8) Maximum length of attachment's name and description.
+*
+*           (9) Maximum length of the host name used as the key of a server capability cache entry,
+*               including '\0'.  Host names that do not fit are never cached.
+*
+*          (10) Length of the MIME multipart boundary built for each message, including '\0'.
 *********************************************************************************************************
 */
 
 #define  SMTPc_LINE_LEN_LIM                             1000    /* See Note #1.                                         */
 
 #define  SMTPc_COMM_BUF_LEN                             1024    /* See Note #2.                                         */
+#define  SMTPc_RX_BUF_LEN                               1024
 
                                                                 /* See Note #3.                                         */
 #define  SMTPc_KEY_VAL_KEY_LEN                            30
@@ -263,7 +293,7 @@ typedef enum smtpc_err {
 #define  SMTPc_MBOX_ADDR_LEN                   (SMTPc_MBOX_DOMAIN_NAME_LEN + SMTPc_MBOX_LOCAL_PART_LEN + 2)
 
                                                                 /* See Note #5.                                         */
-#define  SMTPc_MIME_CONTENT_TYPE_LEN                      20
+#define  SMTPc_MIME_CONTENT_TYPE_LEN                      64
 
                                                                 /* See Note #6.                                         */
 #define  SMTPc_MIME_ID_LEN                      SMTPc_MBOX_ADDR_LEN
@@ -277,7 +307,14 @@ typedef enum smtpc_err {
 
                                                                 /* See Note #6.                                         */
 #define  SMTPc_MSG_MSGID_LEN                    SMTPc_MBOX_ADDR_LEN
+                                                                /* Nbr of rcpts of a msg, "To", "CC" & "BCC".          */
+#define  SMTPc_MSG_RCPT_NBR_MAX                 (SMTPc_CFG_MSG_MAX_TO + SMTPc_CFG_MSG_MAX_CC + SMTPc_CFG_MSG_MAX_BCC)
+
+                                                                /* See Note #9.                                         */
+#define  SMTPc_CAP_CACHE_HOST_NAME_LEN                    64
 
+                                                                /* See Note #10.                                        */
+#define  SMTPc_MIME_BOUNDARY_LEN                          20
 
 
 /*
@@ -310,10 +347,13 @@ typedef enum smtpc_err {
 
                                                                 /* -------- PERMANENT NEGATIVE COMPLETION REPLY ------- */
 #define  SMTPc_REP_NEG_COMPLET_GRP                         5
+#define  SMTPc_REP_500                                   500    /* Syntax error, command unrecognized.                  */
+#define  SMTPc_REP_502                                   502    /* Command not implemented.                             */
 #define  SMTPc_REP_503                                   503    /* Bad sequence of commands.                            */
 #define  SMTPc_REP_504                                   504    /* Command parameter not implemented.                   */
 #define  SMTPc_REP_535                                   535    /* Authentication failure.                              */
 #define  SMTPc_REP_550                                   550    /* Requested action not taken: mailbox unavailable.     */
+#define  SMTPc_REP_552                                   552    /* Requested mail action aborted: storage exceeded.     */
 #define  SMTPc_REP_554                                   554    /* Transaction failed.                                  */
 
 
@@ -323,16 +363,30 @@ typedef enum smtpc_err {
 *********************************************************************************************************
 */
 
+#define  SMTPc_CMD_EHLO                         "EHLO"
 #define  SMTPc_CMD_HELO                         "HELO"
 #define  SMTPc_CMD_MAIL                         "MAIL"
 #define  SMTPc_CMD_RCPT                         "RCPT"
 #define  SMTPc_CMD_DATA                         "DATA"
+#define  SMTPc_CMD_BDAT                         "BDAT"
 #define  SMTPc_CMD_RSET                         "RSET"
 #define  SMTPc_CMD_NOOP                         "NOOP"
 #define  SMTPc_CMD_QUIT                         "QUIT"
 
 #define  SMTPc_CMD_AUTH                         "AUTH"
 #define  SMTPc_CMD_AUTH_MECHANISM_PLAIN         "PLAIN"
+#define  SMTPc_CMD_AUTH_MECHANISM_LOGIN         "LOGIN"
+#define  SMTPc_CMD_AUTH_MECHANISM_CRAM_MD5      "CRAM-MD5"
+#define  SMTPc_CMD_AUTH_MECHANISM_XOAUTH2       "XOAUTH2"
+
+                                                                /* ------------- ESMTP SERVICE EXTENSIONS ------------- */
+#define  SMTPc_EXT_PIPELINING                   "PIPELINING"
+#define  SMTPc_EXT_SIZE                         "SIZE"
+#define  SMTPc_EXT_8BITMIME                     "8BITMIME"
+#define  SMTPc_EXT_CHUNKING                     "CHUNKING"
+#define  SMTPc_EXT_STARTTLS                     "STARTTLS"
+#define  SMTPc_EXT_AUTH                         "AUTH"
+#define  SMTPc_EXT_ENHSTATUS                    "ENHANCEDSTATUSCODES"
 
 
 #define  SMTPc_CRLF                             "\x0D\x0A"
@@ -345,6 +399,12 @@ typedef enum smtpc_err {
 #define  SMTPc_HDR_REPLYTO                      "Reply-to: "
 #define  SMTPc_HDR_CC                           "Cc: "
 #define  SMTPc_HDR_SUBJECT                      "Subject: "
+#define  SMTPc_HDR_MIME_VERSION                 "MIME-Version: 1.0"
+#define  SMTPc_HDR_CONTENT_TYPE                 "Content-Type: "
+#define  SMTPc_HDR_CONTENT_ENC                  "Content-Transfer-Encoding: "
+#define  SMTPc_HDR_CONTENT_DISP                 "Content-Disposition: "
+#define  SMTPc_HDR_CONTENT_DESC                 "Content-Description: "
+#define  SMTPc_HDR_CONTENT_ID                   "Content-ID: "
 
 #define  SMTPc_TAG_IPv6                         "IPv6:"
 
@@ -361,6 +421,8 @@ typedef enum smtpc_err {
 *               input buffer by a factor of (4 x 3).  However, when padding is necessary, up to 3
 *               additional characters could by appended.  Finally, one more character is used to NULL
 *               terminate the buffer.
+*
+*           (3) Kernels of the encoder of attachments & credentials (see 'smtp-c.c  SMTPc_B64EncSet()').
 *********************************************************************************************************
 */
 
@@ -371,6 +433,73 @@ typedef enum smtpc_err {
                                                                 /* See Note #2.                                         */
 #define  SMTPc_ENCODER_BASE64_OUT_MAX_LEN        ((((SMTPc_CFG_MBOX_NAME_DISP_LEN + SMTPc_CFG_MSG_SUBJECT_LEN + 2) * 4) / 3) + 4)
 
+                                                                /* See Note #3.                                         */
+#define  SMTPc_B64_ENC_AUTO                                0u   /* Fastest kernel supported by the CPU.                 */
+#define  SMTPc_B64_ENC_SCALAR                              1u   /* Portable C.                                          */
+#define  SMTPc_B64_ENC_SSE2                                2u   /* x86-64.                                              */
+#define  SMTPc_B64_ENC_AVX2                                3u   /* x86-64 with AVX2.                                    */
+#define  SMTPc_B64_ENC_NEON                                4u   /* AArch64.                                             */
+
+
+/*
+*********************************************************************************************************
+*                                   SERVER CAPABILITIES DEFINES
+*
+* Note(s) : (1) Service extensions advertised by the server in its reply to the EHLO command (see RFC #1869,
+*               Section 'The EHLO command').  Only the extensions the client knows how to use are kept.
+*
+*           (2) SASL mechanisms advertised by the AUTH extension keyword (see RFC #4954, Section 3).
+*********************************************************************************************************
+*/
+
+                                                                /* See Note #1.                                         */
+#define  SMTPc_CAP_NONE                         DEF_BIT_NONE
+#define  SMTPc_CAP_PIPELINING                   DEF_BIT_00      /* RFC #2920 Command pipelining.                        */
+#define  SMTPc_CAP_SIZE                         DEF_BIT_01      /* RFC #1870 Message size declaration.                  */
+#define  SMTPc_CAP_8BITMIME                     DEF_BIT_02      /* RFC #6152 8-bit MIME transport.                      */
+#define  SMTPc_CAP_CHUNKING                     DEF_BIT_03      /* RFC #3030 BDAT command.                              */
+#define  SMTPc_CAP_STARTTLS                     DEF_BIT_04      /* RFC #3207 Secure SMTP over TLS.                      */
+#define  SMTPc_CAP_AUTH                         DEF_BIT_05      /* RFC #4954 Authentication.                            */
+#define  SMTPc_CAP_ENHSTATUS                    DEF_BIT_06      /* RFC #2034 Enhanced error codes.                      */
+
+                                                                /* See Note #2.                                         */
+#define  SMTPc_AUTH_MECH_NONE                   DEF_BIT_NONE
+#define  SMTPc_AUTH_MECH_PLAIN                  DEF_BIT_00
+#define  SMTPc_AUTH_MECH_LOGIN                  DEF_BIT_01
+#define  SMTPc_AUTH_MECH_CRAM_MD5               DEF_BIT_02
+#define  SMTPc_AUTH_MECH_XOAUTH2                DEF_BIT_03
+
+
+/*
+*********************************************************************************************************
+*                                          TRANSPORT DEFINES
+*
+* Note(s) : (1) Timeout of the operations of a connection, set by the 'DeadlineSet' function of the transport
+*               (see 'SMTPc_TRANSPORT_API  Note #1f').
+*
+*           (2) Address family of the local address of a connection.
+*
+*           (3) Size of the buffer holding the local address of a connection, as a string : large enough for
+*               an IPv6 address, including the terminating NULL character.
+*
+*           (4) Identifier never returned for an open connection (see 'SMTPc_TRANSPORT_API  Note #3a').
+*********************************************************************************************************
+*/
+
+                                                                /* See Note #1.                                         */
+#define  SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK                 0u    /* Operations never block.                              */
+#define  SMTPc_TRANSPORT_TIMEOUT_INFINITE       DEF_INT_32U_MAX_VAL
+
+                                                                /* See Note #2.                                         */
+#define  SMTPc_TRANSPORT_FAMILY_IPv4                      4u
+#define  SMTPc_TRANSPORT_FAMILY_IPv6                      6u
+
+                                                                /* See Note #3.                                         */
+#define  SMTPc_TRANSPORT_ADDR_LEN                        46u
+
+                                                                /* See Note #4.                                         */
+#define  SMTPc_SOCK_ID_NONE                               -1
+
 
 /*
 *********************************************************************************************************
@@ -439,28 +568,94 @@ typedef struct SMTPc_mbox
 * Note(s): (1) See RFC #2045 for details.
 *
 *          (2) Structure subject to change.  For instance, other data structures could be used to represent
-*              "Encoding", etc.  The encoding could also be left to do by the application
+*              "Encoding", etc.
+*
+*          (3) An empty 'ContentType' stands for "application/octet-stream" for an attachment, & for
+*              "text/plain" for the message body.  'ParamArray' entries, if any, are appended to it.
+*
+*          (4) Content transfer encoding applied by this module (see RFC #2045, Section 6).  A structure
+*              cleared to 0 selects base64 for an attachment, & sends the message body as is.
+*
+*              (a) Quoted-printable suits text that is mostly US-ASCII : it leaves such characters readable
+*                  & only grows the other octets.  Line breaks are sent as CRLF, whatever their form in the
+*                  data.
+*
+*              (b) SMTPc_MIME_ENC_AUTO picks quoted-printable or base64, whichever is expected to be
+*                  shorter, from a sample of the beginning of the data.
+*
+*          (5) 'ID' is sent as the Content-ID header field, when not empty.
 *********************************************************************************************************
 */
 
+#define  SMTPc_MIME_ENC_DFLT                               0u   /* Dflt for the entity (see Note #4).                   */
+#define  SMTPc_MIME_ENC_BASE64                             1u   /* Base64           (see RFC #2045, Section 6.8).       */
+#define  SMTPc_MIME_ENC_7BIT                               2u   /* None, data is known to be 7bit/CRLF lines.           */
+#define  SMTPc_MIME_ENC_QP                                 3u   /* Quoted-printable (see RFC #2045, Section 6.7).       */
+#define  SMTPc_MIME_ENC_AUTO                               4u   /* QP or base64     (see Note #4b).                     */
+
 typedef struct SMTPc_mime_entity_hdr
 {
-    CPU_CHAR       *ContentType[SMTPc_MIME_CONTENT_TYPE_LEN];   /* Description of contained body data (IANA assigned).  */
+    CPU_CHAR        ContentType[SMTPc_MIME_CONTENT_TYPE_LEN];   /* Description of contained body data (see Note #3).    */
     SMTPc_KEY_VAL  *ParamArray[SMTPc_MIME_MAX_KEYVAL];          /* Additional param for specified content-type.         */
-    void           *ContentEncoding;                            /* Content transfer encoding.                           */
-    void          (*EncodingFnctPtr)(CPU_CHAR *,                /* Ptr to fnct performing the encoding of the           */
-                                     NET_ERR  *);               /* attachment.                                          */
-    CPU_CHAR        ID[SMTPc_MIME_ID_LEN];                      /* Unique attachment id.                                */
+    CPU_INT08U      ContentEncoding;                            /* Content transfer encoding (see Note #4).             */
+    CPU_CHAR        ID[SMTPc_MIME_ID_LEN];                      /* Unique entity id (see Note #5).                      */
 } SMTPc_MIME_ENTITY_HDR;
 
 
+/*
+*********************************************************************************************************
+*                                     SMTP MESSAGE BODY READ FUNCTION
+*
+* Note(s): (1) Function called to read the body of a message or the data of an attachment, when it is not
+*              held in a single buffer (see 'smtp-c.c  SMTPc_TxEntity()') :
+*
+*              (a) 'p_arg' is the 'ContentBodyRdArg' member of the message, or the 'RdArg' member of the
+*                  attachment.
+*
+*              (b) At most 'buf_len' octets are copied to 'p_buf' & their number is returned in 'p_len_rd'.
+*                  0 octets signals the end of the body.
+*
+*              (c) DEF_FAIL is returned if the body cannot be read, which aborts the message.
+*********************************************************************************************************
+*/
+
+typedef  CPU_BOOLEAN  (*SMTPc_BODY_RD_FNCT)(void        *p_arg,
+                                            CPU_CHAR    *p_buf,
+                                            CPU_INT32U   buf_len,
+                                            CPU_INT32U  *p_len_rd);
+
+
+/*
+*********************************************************************************************************
+*                                      SMTP MESSAGE BODY FRAGMENT
+*
+* Note(s): (1) A message body MAY be made of several fragments held in distinct buffers, for instance a
+*              constant template, a section built for the message & a footer.  The body is the
+*              concatenation of the fragments, which are sent without being gathered in a single buffer
+*              first (see 'smtp-c.c  SMTPc_TxGather()').
+*********************************************************************************************************
+*/
+
+typedef struct SMTPc_body_frag
+{
+    CPU_CHAR    *DataPtr;                                       /* Ptr to the data of the fragment.                     */
+    CPU_INT32U   Len;                                           /* Len  of the data of the fragment.                    */
+} SMTPc_BODY_FRAG;
+
+
 /*
 *********************************************************************************************************
 *                        SMTP MESSAGE ATTACHMENT AND ATTACHMENT LIST DATA TYPES
 *
-* Note(s): (1) Attachments are not going to be supported in the first version of the uCSMTPc module.
-*              Hence, the format of this structure will surely change to accommodate for possible
-*              file system access.
+* Note(s): (1) Each attachment is sent as a part of a multipart/mixed message (see RFC #2046, Section
+*              5.1.3), the message body being the first part.
+*
+*          (2) The data of the attachment is either held in the buffer 'AttachData', or read by pieces using
+*              the function 'RdFnct' (see 'SMTPc_BODY_RD_FNCT  Note #1'), for instance from a file system.
+*              In both cases, the data is encoded by pieces & no encoded copy is ever held in memory.
+*              SMTPc_CFG_BODY_RD_BUF_LEN MUST be > 0 to use a read function.
+*
+*          (3) SMTPc_SetAttach() SHOULD be used to initialize the structure.
 *********************************************************************************************************
 */
 
@@ -471,10 +666,39 @@ typedef struct SMTPc_attach
     CPU_CHAR                Desc[SMTPc_ATTACH_DESC_LEN];        /* Optional attachment description.                     */
     void                   *AttachData;                         /* Ptr to beginning of body (data of the entity).       */
     CPU_INT32U              Size ;                              /* Size of data in octets.                              */
-
+    SMTPc_BODY_RD_FNCT      RdFnct;                             /* Data read fnct, used instead of AttachData ...       */
+    void                   *RdArg;                              /* ... if non-NULL (see Note #2).                       */
 } SMTPc_ATTACH;
 
 
+/*
+*********************************************************************************************************
+*                                   SMTP RECIPIENT RESULT DATA TYPE
+*
+* Note(s): (1) Result of the RCPT command of a recipient, as replied by the server.  'RepCode' is 0 when
+*              no reply was received for the recipient, for instance when the transaction was aborted
+*              before, in which case the message was not sent to the recipient.
+*
+*          (2) Enhanced mail system status code, "class.subject.detail" (see RFC #3463).  'StatusClass'
+*              is 0 when the reply does not hold a status code.
+*
+*          (3) 'Retryable' is DEF_YES when the recipient was not accepted but may be accepted if the message
+*              is sent again later : the server replied with a transient negative reply (4yz) or did not
+*              reply at all.  A permanent negative reply (5yz) is not retryable (see RFC #5321, Section
+*              4.2.1).
+*********************************************************************************************************
+*/
+
+typedef struct SMTPc_rcpt_result
+{
+    CPU_INT16U     RepCode;                                     /* Reply code to RCPT cmd (see Note #1).                */
+    CPU_INT08U     StatusClass;                                 /* Enhanced status code (see Note #2).                  */
+    CPU_INT16U     StatusSubject;
+    CPU_INT16U     StatusDetail;
+    CPU_BOOLEAN    Retryable;                                   /* Rcpt may be retried (see Note #3).                   */
+} SMTPc_RCPT_RESULT;
+
+
 /*
 *********************************************************************************************************
 *                                          SMTP MSG Structure
@@ -484,6 +708,28 @@ typedef struct SMTPc_attach
 *              and to send it to the SMTP server.  More specifically, it encapsulates the various
 *              addresses of the sender and recipients, MIME information, the message itself, and
 *              finally the eventual attachments.
+*
+*          (2) The body is either held in the buffer 'ContentBodyMsg', or read by pieces using the function
+*              'ContentBodyRdFnct' (see 'SMTPc_BODY_RD_FNCT  Note #1').  The latter keeps the memory needed
+*              constant, whatever the size of the body.  SMTPc_CFG_BODY_RD_BUF_LEN MUST be > 0.
+*
+*          (3) The body MAY instead be made of the 'ContentBodyFragNbr' fragments of 'ContentBodyFragArray'
+*              (see 'SMTPc_BODY_FRAG  Note #1'), which are used instead of 'ContentBodyMsg' when
+*              'ContentBodyFragNbr' is not 0.  A read function, if any, takes precedence.
+*
+*          (4) 'RenderBufPtr' & 'RenderLen' are set by SMTPc_RenderMsg() (see 'smtp-c.c  SMTPc_RenderMsg()')
+*              & MUST NOT be modified by the application.  Once rendered, the message content is sent from
+*              the rendered buffer & the members describing it (headers, body & attachments) are not used
+*              anymore; the message MUST be rendered again after they are modified.  The envelope ('From'
+*              & the recipients) is still taken from the structure.
+*
+*          (5) When 'RcptPartialEn' is DEF_YES, a recipient rejected by the server does not abort the message :
+*              the message is sent to the recipients accepted & the transmission succeeds as long as one
+*              recipient was accepted.  Otherwise, any rejected recipient aborts the whole message.  In both
+*              cases, the result of each recipient is set in 'RcptResultTbl' (see 'SMTPc_RCPT_RESULT'),
+*              indexed in the order the recipients are sent : "To" recipients first, then "CC" & "BCC".
+*              The results are cleared every time the message is sent & MUST NOT be modified by the
+*              application.
 *********************************************************************************************************
 */
 
@@ -502,16 +748,525 @@ typedef struct SMTPc_msg
     SMTPc_ATTACH           *AttachArray[SMTPc_CFG_MSG_MAX_ATTACH];
     CPU_CHAR               *ContentBodyMsg;                     /* Data of the mail obj content's body.                 */
     CPU_INT32U              ContentBodyMsgLen;                  /* Size (in octets) of buf pointed by ContentBodyMsg.   */
+    SMTPc_BODY_RD_FNCT      ContentBodyRdFnct;                  /* Body read fnct, used instead of ContentBodyMsg ...   */
+    void                   *ContentBodyRdArg;                   /* ... if non-NULL (see Note #2).                       */
+    SMTPc_BODY_FRAG        *ContentBodyFragArray;               /* Body fragments, used instead of ContentBodyMsg ...   */
+    CPU_INT16U              ContentBodyFragNbr;                 /* ... if non-zero (see Note #3).                       */
+    CPU_CHAR               *RenderBufPtr;                       /* Rendered msg content, NULL if not rendered ...       */
+    CPU_INT32U              RenderLen;                          /* ... & its len (see Note #4).                         */
+    CPU_BOOLEAN             RcptPartialEn;                      /* Send to the rcpts accepted only (see Note #5).       */
+                                                                /* Result of each rcpt (see Note #5).                   */
+    SMTPc_RCPT_RESULT       RcptResultTbl[SMTPc_MSG_RCPT_NBR_MAX];
 } SMTPc_MSG;
 
 
+/*
+*********************************************************************************************************
+*                                         SMTP REPLY DATA TYPES
+*
+* Note(s): (1) A reply is described in place, within the receive buffer (SMTPc_RX_BUF).  The text is NOT
+*              NULL terminated and the description is only valid until the next reply is received.
+*
+*          (2) Enhanced mail system status code, "class.subject.detail" (see RFC #3463).  'StatusClass'
+*              is 0 when the reply does not hold a status code.
+*
+*          (3) Data received from the server is appended at 'WrIx'.  The data between 'RdIx' & 'WrIx' is
+*              not consumed yet; it begins with the reply being returned ('Reply'), possibly followed by
+*              (part of) the next replies.
+*********************************************************************************************************
+*/
+
+typedef struct SMTPc_reply
+{
+    CPU_CHAR      *BufPtr;                                      /* Ptr to beginning of reply (see Note #1).             */
+    CPU_INT16U     Len;                                         /* Len of reply, incl. last CRLF.                       */
+    CPU_INT16U     Code;                                        /* Reply code, 0 if malformed.                          */
+    CPU_INT08U     StatusClass;                                 /* Enhanced status code (see Note #2).                  */
+    CPU_INT16U     StatusSubject;
+    CPU_INT16U     StatusDetail;
+    CPU_CHAR      *TextPtr;                                     /* Ptr to text of first line.                           */
+    CPU_INT16U     TextLen;                                     /* Len of text of first line.                           */
+} SMTPc_REPLY;
+
+
+typedef struct SMTPc_rx_buf
+{
+    CPU_CHAR       Data[SMTPc_RX_BUF_LEN];                      /* Data rx'd from the srv.                              */
+    CPU_INT16U     RdIx;                                        /* Ix of first unconsumed octet (see Note #3).          */
+    CPU_INT16U     WrIx;                                        /* Ix of next octet to rx.                              */
+    CPU_INT16U     LineIx;                                      /* Ix of beginning of line being scanned.               */
+    CPU_INT16U     ScanIx;                                      /* Ix of next octet to scan for end of line.            */
+    SMTPc_REPLY    Reply;                                       /* Reply currently returned.                            */
+} SMTPc_RX_BUF;
+
+
+/*
+*********************************************************************************************************
+*                                    SMTP SERVER CAPABILITIES DATA TYPE
+*
+* Note(s): (1) Result of the EHLO negotiation with a server.  'IsESMTP' is DEF_NO when the server rejected
+*              EHLO and the session was initiated with HELO, in which case no extension is available.
+*
+*          (2) 'SizeMax' is the value of the SIZE extension parameter, 0 if the server did not declare a
+*              fixed maximum message size.
+*********************************************************************************************************
+*/
+
+typedef  CPU_INT16U  SMTPc_CAP_FLAGS;
+typedef  CPU_INT08U  SMTPc_AUTH_MECH_FLAGS;
+
+typedef struct SMTPc_caps
+{
+    CPU_BOOLEAN             IsESMTP;                            /* Srv accepted EHLO (see Note #1).                     */
+    SMTPc_CAP_FLAGS         Flags;                              /* Srv extensions (SMTPc_CAP_xxx).                      */
+    CPU_INT32U              SizeMax;                            /* Max msg size accepted by srv (see Note #2).          */
+    SMTPc_AUTH_MECH_FLAGS   AuthMechs;                          /* SASL mechanisms (SMTPc_AUTH_MECH_xxx).               */
+} SMTPc_CAPS;
+
+
+/*
+*********************************************************************************************************
+*                                        SMTP TRANSPORT DATA TYPES
+*
+* Note(s): (1) All the network I/O of the module goes through the functions of a SMTPc_TRANSPORT_API
+*              structure, so that the module can run on any TCP/IP stack.  The transport in use is set by
+*              SMTPc_TransportSet(); the uC/TCP-IP transport is used by default (see 'smtp-c_cfg.h
+*              Note #18').  A connection is identified by a SMTPc_SOCK_ID, SMTPc_SOCK_ID_NONE being never
+*              returned for an open connection (see Note #3) :
+*
+*              (a) Open() connects to a server, waiting at most 'timeout_ms', & returns the connection.
+*                  It returns SMTPc_ERR_SOCK_CONN_FAILED, or SMTPc_ERR_SECURE_NOT_AVAIL if the secure
+*                  configuration is not supported.  With SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, it MAY return a
+*                  non-blocking connection still being established : its failure is then returned by the
+*                  next Tx(), TxV() or Rx().
+*
+*              (b) Tx() transmits up to 'len' octets & returns the number of octets transmitted.
+*
+*              (c) TxV() transmits the 'vec_nbr' buffers of 'p_vec', in order, as by a single Tx().
+*
+*              (d) Rx() receives up to 'len' octets & returns the number of octets received, never 0
+*                  without error.  The loss of the connection is a reception error.
+*
+*              (e) Close() closes a connection, waiting at most 'timeout_ms' for the data transmitted to
+*                  be acknowledged.
+*
+*              (f) DeadlineSet() sets how long Tx(), TxV() & Rx() wait at most : never
+*                  (SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK), without limit (SMTPc_TRANSPORT_TIMEOUT_INFINITE),
+*                  or 'timeout_ms'.  A connection is opened without limit.
+*
+*              (g) LocalAddrGet() returns the local IP address of a connection, as a NULL terminated
+*                  string, & its family (SMTPc_TRANSPORT_FAMILY_xxx).
+*
+*              (h) TS_Get_ms() returns the current time in milliseconds, from a clock that is never set
+*                  back & wraps around at 2^32 ms.  It times the reply deadlines, the idle sessions & the
+*                  asynchronous jobs.
+*
+*              Tx(), TxV() & Rx() return SMTPc_ERR_WOULD_BLOCK when they would wait while the connection
+*              does not block; SMTPc_ERR_TX_FAILED or SMTPc_ERR_RX_FAILED on any other error, including
+*              a timeout.
+*
+*          (2) The transport MUST be set before any connection is opened & MUST NOT be changed while a
+*              connection is open.
+*
+*          (3) The module does not depend on the types of a TCP/IP stack :
+*
+*              (a) SMTPc_SOCK_ID holds the connection identifier of any transport : a uC/TCP-IP socket ID,
+*                  a file descriptor or an index in a table of connections.
+*
+*              (b) SMTPc_SECURE_CFG is the secure configuration passed to Open().  It is the uC/TCP-IP
+*                  secure configuration if the uC/TCP-IP transport is enabled; otherwise its structure is
+*                  only known by the transports supporting it, the others rejecting any secure
+*                  configuration with SMTPc_ERR_SECURE_NOT_AVAIL.
+*
+*              (c) SMTPc_TS_MS holds the timestamps returned by TS_Get_ms().
+*********************************************************************************************************
+*/
+
+typedef  CPU_INT32S  SMTPc_SOCK_ID;                             /* See Note #3a.                                        */
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)                 /* See Note #3b.                                        */
+typedef  NET_APP_SOCK_SECURE_CFG  SMTPc_SECURE_CFG;
+#else
+typedef  struct  smtpc_secure_cfg  SMTPc_SECURE_CFG;
+#endif
+
+typedef  CPU_INT32U  SMTPc_TS_MS;                               /* See Note #3c.                                        */
+
+
+typedef  struct  smtpc_transport_vec {
+    const  void  *DataPtr;                                      /* Ptr to data to tx ...                                */
+    CPU_INT32U    Len;                                          /* ... & its len.                                       */
+} SMTPc_TRANSPORT_VEC;
+
+
+typedef  struct  smtpc_transport_api {                          /* See Note #1.                                         */
+    SMTPc_SOCK_ID  (*Open)        (CPU_CHAR                   *p_host_name,
+                                   CPU_INT16U                  port,
+                                   SMTPc_SECURE_CFG           *p_secure_cfg,
+                                   CPU_INT32U                  timeout_ms,
+                                   SMTPc_ERR                  *p_err);
+
+    CPU_INT32U     (*Tx)          (SMTPc_SOCK_ID               sock_id,
+                                   const  void                *p_data,
+                                   CPU_INT32U                  len,
+                                   SMTPc_ERR                  *p_err);
+
+    CPU_INT32U     (*TxV)         (SMTPc_SOCK_ID               sock_id,
+                                   const  SMTPc_TRANSPORT_VEC *p_vec,
+                                   CPU_INT08U                  vec_nbr,
+                                   SMTPc_ERR                  *p_err);
+
+    CPU_INT32U     (*Rx)          (SMTPc_SOCK_ID               sock_id,
+                                   void                       *p_buf,
+                                   CPU_INT32U                  len,
+                                   SMTPc_ERR                  *p_err);
+
+    void           (*Close)       (SMTPc_SOCK_ID               sock_id,
+                                   CPU_INT32U                  timeout_ms);
+
+    void           (*DeadlineSet) (SMTPc_SOCK_ID               sock_id,
+                                   CPU_INT32U                  timeout_ms,
+                                   SMTPc_ERR                  *p_err);
+
+    void           (*LocalAddrGet)(SMTPc_SOCK_ID               sock_id,
+                                   CPU_CHAR                   *p_addr,
+                                   CPU_INT08U                 *p_family,
+                                   SMTPc_ERR                  *p_err);
+
+    SMTPc_TS_MS    (*TS_Get_ms)   (void);
+} SMTPc_TRANSPORT_API;
+
+
+/*
+*********************************************************************************************************
+*                                          SMTP SESSION DATA TYPES
+*
+* Note(s): (1) A session holds the whole state of a connection with a SMTP server.  Each task sending mail
+*              concurrently MUST use its own session (see 'smtp-c.c  SMTPc_SessionSendMsg()  Note #1').
+*
+*          (2) The session structure is initialized by SMTPc_SessionConnect(); its members MUST NOT be
+*              modified by the application.  'Caps', 'Stats' & 'RepCodeNeg' may be read while the session is
+*              not in use.
+*
+*          (3) 'RepCodeNeg' is the code of the last negative reply received during the last connection or
+*              message, 0 if none.  It tells a transient failure (4yz) from a permanent one (5yz) when
+*              SMTPc_ERR_REP is returned (see 'smtp-c.c  SMTPc_ErrIsTransient()').
+*
+*          (4) A session connected by SMTPc_SessionConnect() waits at most SMTPc_CFG_MAX_REP_TIMEOUT_MS on
+*              its connection (see 'smtp-c_cfg.h  Note #19').  Once the connection failed or timed out, or
+*              the server replied 421, 'ConnLost' is set : no more command is transmitted & no more reply
+*              awaited, so that RSET & QUIT fail at once instead of waiting again on a connection that can
+*              no longer be trusted (see RFC #5321, Section 3.8).  'NoBlock' is set on the connections of
+*              the asynchronous engine, that never wait.
+*********************************************************************************************************
+*/
+
+typedef struct SMTPc_session_stats
+{
+    CPU_INT32U     MsgTxCtr;                                    /* Nbr of msgs successfully tx'd.                       */
+    CPU_INT32U     MsgFailCtr;                                  /* Nbr of msgs that could not be tx'd.                  */
+    CPU_INT32U     ReplyRxCtr;                                  /* Nbr of replies rx'd from the srv.                    */
+    CPU_INT32U     OctetTxCtr;                                  /* Nbr of octets tx'd to   the srv.                     */
+    CPU_INT32U     OctetRxCtr;                                  /* Nbr of octets rx'd from the srv.                     */
+} SMTPc_SESSION_STATS;
+
+
+typedef struct SMTPc_session
+{
+    SMTPc_SOCK_ID          SockId;                              /* Sock ID, SMTPc_SOCK_ID_NONE if not connected.        */
+    SMTPc_CAPS             Caps;                                /* Srv capabilities negotiated by EHLO.                 */
+    SMTPc_SESSION_STATS    Stats;                               /* Session stats.                                       */
+    CPU_CHAR               TxBuf[SMTPc_COMM_BUF_LEN];           /* Buf used to build cmds & msg hdrs.                   */
+    SMTPc_RX_BUF           RxBuf;                               /* Replies rx'd from the srv.                           */
+    CPU_INT16U             BdatPendCtr;                         /* Nbr of BDAT chunks not replied to yet.               */
+    CPU_INT08U             EncState;                            /* State of the msg content transparency encoder.       */
+    CPU_CHAR               Boundary[SMTPc_MIME_BOUNDARY_LEN];   /* MIME multipart boundary of the current msg.          */
+#if (SMTPc_CFG_BODY_RD_BUF_LEN > 0u)
+                                                                /* Buf the msg body is read into.                       */
+    CPU_CHAR               BodyRdBuf[SMTPc_CFG_BODY_RD_BUF_LEN];
+#endif
+#if (SMTPc_CFG_TX_SEG_LEN > 0u)
+    CPU_CHAR               TxSegBuf[SMTPc_CFG_TX_SEG_LEN];      /* Buf gathering msg content into segments.             */
+    CPU_INT32U             TxSegLen;                            /* Nbr of octets gathered in TxSegBuf.                  */
+#endif
+    CPU_BOOLEAN            DataOnly;                            /* Cur msg content tx'd with DATA, never with BDAT.     */
+    CPU_CHAR              *RenderPtr;                           /* Wr pos in buf msg content is rendered into, if any.  */
+    CPU_INT32U             RenderRem;                           /* Nbr of octets remaining in render buf.               */
+    CPU_INT16U             RepCodeNeg;                          /* Last neg reply code, 0 if none (see Note #3).        */
+    CPU_BOOLEAN            NoBlock;                             /* Conn does not block (see Note #4).                   */
+    CPU_BOOLEAN            ConnLost;                            /* Conn failed, timed out or closed (see Note #4).      */
+} SMTPc_SESSION;
+
+
+/*
+*********************************************************************************************************
+*                                    SMTP ASYNCHRONOUS JOB DATA TYPES
+*
+* Note(s): (1) A job sends one message over its own connection, driven by SMTPc_Poll() (see 'smtp-c.c
+*              SMTPc_Poll()').  The structure is initialized by SMTPc_AsyncSubmit(); its members MUST NOT
+*              be modified by the application until the completion function was called (see also Note #3).
+*
+*          (2) The completion function is called by SMTPc_Poll() once the job is over, with the result of
+*              the job :
+*
+*                  SMTPc_ERR_NONE                      Message accepted by the server.
+*                  SMTPc_ERR_REP                       Message rejected by the server.
+*                  SMTPc_ERR_AUTH_FAILED               Authentication failed.
+*                  SMTPc_ERR_SOCK_CONN_FAILED          Error connecting to server.
+*                  SMTPc_ERR_TX_FAILED                 Error querying server.
+*                  SMTPc_ERR_RX_FAILED                 Error receiving server reply.
+*                  SMTPc_ERR_TIMEOUT                   Server did not reply in time.
+*
+*              The job MAY be submitted again from the completion function.
+*
+*          (3) A job initialized by SMTPc_AsyncInit() is not polled by SMTPc_Poll() but run by
+*              SMTPc_AsyncRun(), typically whenever its connection is ready (see
+*              'Reactor/Epoll/smtp-c_reactor_epoll.h').  Its 'NextPtr' & 'PrevPtr' members are then left
+*              to the caller, to link its jobs, & its completion function is called by the caller.
+*
+*          (4) Opening the connection of a job resolves its host name, which may block on a name lookup.
+*              A caller running many jobs in a single task MAY resolve it beforehand, in the task
+*              submitting the job, into 'HostAddr' & point 'HostNamePtr' to it (see
+*              'Reactor/Epoll/smtp-c_reactor_epoll.c  SMTPc_ReactorEpoll_Submit()').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+typedef  struct  SMTPc_async  SMTPc_ASYNC;
+
+typedef  void  (*SMTPc_ASYNC_CMPL_FNCT)(SMTPc_ASYNC  *p_async,
+                                        SMTPc_ERR     err,
+                                        void         *p_arg);
+
+struct  SMTPc_async {
+    SMTPc_SESSION             Sess;                             /* Session driven by the engine.                        */
+    SMTPc_MSG                *MsgPtr;                           /* Msg to send.                                         */
+    CPU_CHAR                 *HostNamePtr;                      /* Srv host name or IP addr.                            */
+                                                                /* Srv IP addr, if resolved by caller (see Note #4).    */
+    CPU_CHAR                  HostAddr[SMTPc_TRANSPORT_ADDR_LEN];
+    CPU_INT16U                Port;                             /* Srv port.                                            */
+    SMTPc_SECURE_CFG         *SecureCfgPtr;                     /* Secure cfg, if any.                                  */
+#if (SMTPc_CFG_AUTH_EN == DEF_ENABLED)
+    CPU_CHAR                 *UsernamePtr;                      /* Credentials, if any.                                 */
+    CPU_CHAR                 *PwdPtr;
+#endif
+    SMTPc_ASYNC_CMPL_FNCT     CmplFnct;                         /* Completion fnct (see Note #2) ...                    */
+    void                     *CmplArg;                          /* ... & its arg.                                       */
+    CPU_INT08U                State;                            /* State of the job (SMTPc_ASYNC_STATE_xxx).            */
+    SMTPc_ERR                 Err;                              /* Result of the job.                                   */
+    CPU_INT16U                RcptIx;                           /* Ix of the recipient being sent.                      */
+    CPU_INT16U                RcptOkCtr;                        /* Nbr of recipients accepted.                          */
+    CPU_CHAR                 *TxPtr;                            /* Data remaining to tx ...                             */
+    CPU_INT32U                TxLen;                            /* ... & its len.                                       */
+    SMTPc_TS_MS               TS;                               /* Time of the last progress.                           */
+    SMTPc_ASYNC              *NextPtr;                          /* Next job polled (see Note #3).                       */
+    SMTPc_ASYNC              *PrevPtr;                          /* Prev job, if linked by the caller (see Note #3).     */
+};
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                     SMTP OUTBOUND QUEUE DATA TYPES
+*
+* Note(s): (1) The run-time configuration of the outbound queue is passed to SMTPc_QueueInit().
+*
+*          (2) A job is a message submitted to the queue by SMTPc_QueueSubmit().  The structure is owned by
+*              the application but MUST NOT be modified until the job is done (see Note #3).
+*
+*          (3) The status of a job is returned by SMTPc_QueueStatusGet().  Once the job is done, its result
+*              is also passed to the completion function, if any :
+*
+*                  SMTPc_ERR_NONE                      Message sent.
+*                  Any error returned by SMTPc_SendMail().
+*
+*              When the retry scheduler is enabled, a job that failed on a transient error is sent again
+*              after a backoff delay, up to 'RetryNbrMax' times, before it is done (see Note #5).
+*
+*          (4) The statistics of the submission ring are returned by SMTPc_QueueRingStatsGet().  Latencies
+*              are measured from the entry in SMTPc_QueueRingSubmit() until the job is in the ring; the
+*              99th percentile is the upper bound of the power-of-2 range of timestamp counts it falls in.
+*              'DrainLatMax_us' is the longest time a job waited in the ring before it was moved to the
+*              job queue, i.e. the delay added by the ring task (see 'smtp-c_cfg.h  Note #15f').
+*
+*          (5) The delay before the n-th retry is 'RetryDlyMin_ms' doubled (n - 1) times, limited to
+*              'RetryDlyMax_ms', of which a random part of up to one half is taken off so that jobs that
+*              failed together are not retried together.  'RepCode' holds the negative reply code the job
+*              last failed on, if any (see 'SMTPc_SESSION  Note #3').
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+typedef  struct  smtpc_queue_cfg {
+    CPU_INT16U                JobQSize;                         /* Max nbr of jobs waiting for a worker.                */
+    CPU_INT08U                WorkerNbr;                        /* Nbr of worker tasks.                                 */
+    CPU_INT08U                WorkerSessNbr;                    /* Nbr of sessions kept open by each worker.            */
+    CPU_INT08U                WorkerPrio;                       /* Prio of the worker tasks.                            */
+    CPU_SIZE_T                WorkerStkSizeBytes;               /* Stk size of each worker task.                        */
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+    CPU_INT08U                RingPrio;                         /* Prio of the task draining the submission ring.       */
+    CPU_SIZE_T                RingStkSizeBytes;                 /* Stk size of the task draining the submission ring.   */
+#endif
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+    CPU_INT08U                RetryNbrMax;                      /* Max nbr of retries of a job (see Note #5).           */
+    CPU_INT32U                RetryDlyMin_ms;                   /* Dly before the first retry.                          */
+    CPU_INT32U                RetryDlyMax_ms;                   /* Max dly before a retry.                              */
+    CPU_INT08U                SchedPrio;                        /* Prio     of the scheduler task.                      */
+    CPU_SIZE_T                SchedStkSizeBytes;                /* Stk size of the scheduler task.                      */
+#endif
+} SMTPc_QUEUE_CFG;
+
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+typedef  struct  smtpc_queue_ring_stats {                       /* See Note #4.                                         */
+    CPU_INT32U                SubmitCtr;                        /* Nbr of jobs put in the ring.                         */
+    CPU_INT32U                FullCtr;                          /* Nbr of jobs rejected, ring full.                     */
+    CPU_INT32U                LatAvg_us;                        /* Avg             enqueue latency (us).                */
+    CPU_INT32U                LatP99_us;                        /* 99th percentile enqueue latency (us).                */
+    CPU_INT32U                LatMax_us;                        /* Max             enqueue latency (us).                */
+    CPU_INT32U                DrainLatMax_us;                   /* Max time spent by a job in the ring (us).            */
+} SMTPc_QUEUE_RING_STATS;
+#endif
+
+                                                                /* ------------------- JOB STATUS --------------------- */
+#define  SMTPc_JOB_STATUS_IDLE                             0u   /* Job never submitted.                                 */
+#define  SMTPc_JOB_STATUS_PEND                             1u   /* Job waiting for a worker.                            */
+#define  SMTPc_JOB_STATUS_ACTIVE                           2u   /* Msg being sent.                                      */
+#define  SMTPc_JOB_STATUS_DONE                             3u   /* Job over (see Note #3).                              */
+#define  SMTPc_JOB_STATUS_SCHED                            4u   /* Job waiting for its send time or retry.              */
+
+typedef  struct  smtpc_job  SMTPc_JOB;
+
+typedef  void  (*SMTPc_JOB_CMPL_FNCT)(SMTPc_JOB  *p_job,
+                                      SMTPc_ERR   err,
+                                      void       *p_arg);
+
+struct  smtpc_job {
+    CPU_CHAR                 *HostNamePtr;                      /* Srv host name or IP addr.                            */
+    CPU_INT16U                Port;                             /* Srv port, or '0' if dflt port.                       */
+    CPU_CHAR                 *UsernamePtr;                      /* Credentials, if any.                                 */
+    CPU_CHAR                 *PwdPtr;
+    SMTPc_SECURE_CFG         *SecureCfgPtr;                     /* Secure cfg, if any.                                  */
+    SMTPc_MSG                *MsgPtr;                           /* Msg to send.                                         */
+    SMTPc_JOB_CMPL_FNCT       CmplFnct;                         /* Completion fnct, if any (see Note #3) ...            */
+    void                     *CmplArg;                          /* ... & its arg.                                       */
+    CPU_INT08U                Status;                           /* Status of the job (SMTPc_JOB_STATUS_xxx).            */
+    SMTPc_ERR                 Err;                              /* Result of the job.                                   */
+    CPU_INT16U                RepCode;                          /* Last neg reply code, 0 if none (see Note #5).        */
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+    CPU_INT08U                RetryCtr;                         /* Nbr of retries so far.                               */
+    CPU_INT32U                SchedTick;                        /* Tick at which the job is due.                        */
+    SMTPc_JOB                *SchedNextPtr;                     /* Next job of the same timer wheel slot.               */
+#endif
+};
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                    SMTP PERSISTENT SPOOL DATA TYPES
+*
+* Note(s): (1) The storage holding the spool is accessed through the functions of a SMTPc_SPOOL_API
+*              structure, so that any file system or raw flash area can be used.  The spool is made of
+*              segments identified by increasing numbers, to which records are only appended.  Each
+*              function is passed the argument of the storage ('SMTPc_SPOOL_CFG  StorageArg', e.g. the
+*              path of a directory) & returns SMTPc_ERR_NONE or SMTPc_ERR_SPOOL_IO :
+*
+*              (a) SegRangeGet() returns the lowest & highest numbers of the segments stored, or DEF_NO in
+*                  'p_found' if there is none.  Segments are always deleted from the lowest, so the
+*                  segments stored are consecutive.
+*
+*              (b) SegRd() reads up to 'len' octets at 'offset' in a segment & returns the number of octets
+*                  read, which is lower than 'len' at the end of the segment.
+*
+*              (c) SegWr() appends 'len' octets to a segment, creating the segment if needed.
+*
+*              (d) SegSync() makes the data appended to a segment, & its creation, durable.  It is called
+*                  without the lock of the spool, so that messages can be spooled during a sync : it MAY run
+*                  while SegWr() appends to the same segment, & MUST then make durable at least the data
+*                  appended before it was called.  The other functions are never called concurrently.
+*
+*              (e) SegDel() deletes a segment.
+*
+*          (2) The spooled messages are all sent to the same server, through the outbound queue.
+*
+*          (3) The completion function is called by the worker of the outbound queue when a spooled
+*              message is done, with the id returned by SMTPc_SpoolSubmit() & the result of the job (see
+*              'SMTPc_JOB  Note #3').  Messages recovered from the storage keep their id.
+*
+*          (4) The sync function is called by the spool task after each group commit that made messages
+*              durable, with the highest id up to which all the messages spooled are durable (see
+*              'smtp-c.c  SMTPc_SpoolSubmit()  Note #3').  It MUST NOT call the functions of the spool.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+typedef  struct  smtpc_spool_api {                              /* See Note #1.                                         */
+    void        (*SegRangeGet)(void             *p_arg,
+                               CPU_INT32U       *p_seg_first,
+                               CPU_INT32U       *p_seg_last,
+                               CPU_BOOLEAN      *p_found,
+                               SMTPc_ERR        *p_err);
+
+    CPU_INT32U  (*SegRd)      (void             *p_arg,
+                               CPU_INT32U        seg_id,
+                               CPU_INT32U        offset,
+                               void             *p_buf,
+                               CPU_INT32U        len,
+                               SMTPc_ERR        *p_err);
+
+    void        (*SegWr)      (void             *p_arg,
+                               CPU_INT32U        seg_id,
+                               const  void      *p_data,
+                               CPU_INT32U        len,
+                               SMTPc_ERR        *p_err);
+
+    void        (*SegSync)    (void             *p_arg,
+                               CPU_INT32U        seg_id,
+                               SMTPc_ERR        *p_err);
+
+    void        (*SegDel)     (void             *p_arg,
+                               CPU_INT32U        seg_id,
+                               SMTPc_ERR        *p_err);
+} SMTPc_SPOOL_API;
+
+typedef  void  (*SMTPc_SPOOL_CMPL_FNCT)(CPU_INT32U   msg_id,
+                                        SMTPc_ERR    err,
+                                        void        *p_arg);
+
+typedef  void  (*SMTPc_SPOOL_SYNC_FNCT)(CPU_INT32U   msg_id,
+                                        void        *p_arg);
+
+typedef  struct  smtpc_spool_cfg {
+    const  SMTPc_SPOOL_API   *StorageAPI_Ptr;                   /* Storage fncts (see Note #1) ...                      */
+    void                     *StorageArg;                       /* ... & their arg.                                     */
+    CPU_CHAR                 *HostNamePtr;                      /* Srv host name or IP addr (see Note #2).              */
+    CPU_INT16U                Port;                             /* Srv port, or '0' if dflt port.                       */
+    CPU_CHAR                 *UsernamePtr;                      /* Credentials, if any.                                 */
+    CPU_CHAR                 *PwdPtr;
+    SMTPc_SECURE_CFG         *SecureCfgPtr;                     /* Secure cfg, if any.                                  */
+    CPU_INT16U                MsgNbrMax;                        /* Max nbr of msgs in the spool.                        */
+    CPU_INT32U                MsgLenMax;                        /* Max len of a rendered msg.                           */
+    CPU_INT32U                SegLenMax;                        /* Len from which a new seg is started.                 */
+    CPU_INT32U                SyncPeriod_ms;                    /* Period of the group commits.                         */
+    CPU_INT08U                TaskPrio;                         /* Prio     of the spool task.                          */
+    CPU_SIZE_T                TaskStkSizeBytes;                 /* Stk size of the spool task.                          */
+    SMTPc_SPOOL_CMPL_FNCT     CmplFnct;                         /* Completion fnct, if any (see Note #3) ...            */
+    void                     *CmplArg;                          /* ... & its arg.                                       */
+    SMTPc_SPOOL_SYNC_FNCT     SyncFnct;                         /* Sync fnct, if any (see Note #4) ...                  */
+    void                     *SyncArg;                          /* ... & its arg.                                       */
+} SMTPc_SPOOL_CFG;
+#endif
+
+
 /*
 *********************************************************************************************************
 *                                          GLOBAL VARIABLES
 *********************************************************************************************************
 */
 
-SMTPc_EXT  CPU_CHAR  SMTPc_Comm_Buf[SMTPc_COMM_BUF_LEN];
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+extern  const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Net;     /* uC/TCP-IP transport (see 'SMTPc_TRANSPORT_API').     */
+#endif
 
 
 /*
@@ -520,39 +1275,182 @@ SMTPc_EXT  CPU_CHAR  SMTPc_Comm_Buf[SMTPc_COMM_BUF_LEN];
 *********************************************************************************************************
 */
 
-void         SMTPc_SendMail    (CPU_CHAR                *p_host_name,
-                                CPU_INT16U               port,
-                                CPU_CHAR                *p_username,
-                                CPU_CHAR                *p_pwd,
-                                NET_APP_SOCK_SECURE_CFG *p_secure_cfg,
-                                SMTPc_MSG               *p_msg,
-                                SMTPc_ERR               *p_err);
+void           SMTPc_SendMail    (CPU_CHAR                *p_host_name,
+                                  CPU_INT16U               port,
+                                  CPU_CHAR                *p_username,
+                                  CPU_CHAR                *p_pwd,
+                                  SMTPc_SECURE_CFG        *p_secure_cfg,
+                                  SMTPc_MSG               *p_msg,
+                                  SMTPc_ERR               *p_err);
 
                                                                 /* ---------------- SMTP SESSION FNCTS ---------------- */
-NET_SOCK_ID  SMTPc_Connect     (CPU_CHAR                *p_host_name,
-                                CPU_INT16U               port,
-                                CPU_CHAR                *p_username,
-                                CPU_CHAR                *p_pwd,
-                                NET_APP_SOCK_SECURE_CFG *p_secure_cfg,
-                                SMTPc_ERR               *p_err);
+SMTPc_SOCK_ID  SMTPc_Connect     (CPU_CHAR                *p_host_name,
+                                  CPU_INT16U               port,
+                                  CPU_CHAR                *p_username,
+                                  CPU_CHAR                *p_pwd,
+                                  SMTPc_SECURE_CFG        *p_secure_cfg,
+                                  SMTPc_ERR               *p_err);
+
+
+void           SMTPc_SendMsg     (SMTPc_SOCK_ID            sock_id,
+                                  SMTPc_MSG               *msg,
+                                  SMTPc_ERR               *perr);
+
+void           SMTPc_Disconnect  (SMTPc_SOCK_ID            sock_id,
+                                  SMTPc_ERR               *perr);
+
+                                                                /* -------------- MULTI-SESSION FNCTS ----------------- */
+void           SMTPc_SessionConnect   (SMTPc_SESSION           *p_sess,
+                                       CPU_CHAR                *p_host_name,
+                                       CPU_INT16U               port,
+                                       CPU_CHAR                *p_username,
+                                       CPU_CHAR                *p_pwd,
+                                       SMTPc_SECURE_CFG        *p_secure_cfg,
+                                       SMTPc_ERR               *p_err);
+
+void           SMTPc_SessionSendMsg   (SMTPc_SESSION           *p_sess,
+                                       SMTPc_MSG               *p_msg,
+                                       SMTPc_ERR               *p_err);
+
+void           SMTPc_SendMsgBatch     (SMTPc_SESSION           *p_sess,
+                                       SMTPc_MSG              **p_msgs,
+                                       CPU_INT16U               nbr_msg,
+                                       SMTPc_ERR               *p_results,
+                                       SMTPc_ERR               *p_err);
+
+void           SMTPc_SessionDisconnect(SMTPc_SESSION           *p_sess,
+                                       SMTPc_ERR               *p_err);
+
+void           SMTPc_RenderMsg        (SMTPc_SESSION           *p_sess,
+                                       SMTPc_MSG               *p_msg,
+                                       CPU_CHAR                *p_buf,
+                                       CPU_INT32U               buf_len,
+                                       SMTPc_ERR               *p_err);
+
+                                                                /* ----------------- ASYNC ENGINE FNCTS --------------- */
+#if (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+void           SMTPc_AsyncSubmit      (SMTPc_ASYNC             *p_async,
+                                       CPU_CHAR                *p_host_name,
+                                       CPU_INT16U               port,
+                                       CPU_CHAR                *p_username,
+                                       CPU_CHAR                *p_pwd,
+                                       SMTPc_SECURE_CFG        *p_secure_cfg,
+                                       SMTPc_MSG               *p_msg,
+                                       SMTPc_ASYNC_CMPL_FNCT    cmpl_fnct,
+                                       void                    *p_cmpl_arg,
+                                       SMTPc_ERR               *p_err);
+
+CPU_INT16U     SMTPc_Poll             (CPU_INT16U               work_max);
+
+void           SMTPc_AsyncInit        (SMTPc_ASYNC             *p_async,
+                                       CPU_CHAR                *p_host_name,
+                                       CPU_INT16U               port,
+                                       CPU_CHAR                *p_username,
+                                       CPU_CHAR                *p_pwd,
+                                       SMTPc_SECURE_CFG        *p_secure_cfg,
+                                       SMTPc_MSG               *p_msg,
+                                       SMTPc_ASYNC_CMPL_FNCT    cmpl_fnct,
+                                       void                    *p_cmpl_arg,
+                                       SMTPc_ERR               *p_err);
+
+CPU_BOOLEAN    SMTPc_AsyncRun         (SMTPc_ASYNC             *p_async);
+#endif
 
+                                                                /* ---------------- OUTBOUND QUEUE FNCTS -------------- */
+#if (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+void           SMTPc_QueueInit        (const  SMTPc_QUEUE_CFG  *p_cfg,
+                                       SMTPc_ERR               *p_err);
+
+void           SMTPc_QueueSubmit      (SMTPc_JOB               *p_job,
+                                       CPU_CHAR                *p_host_name,
+                                       CPU_INT16U               port,
+                                       CPU_CHAR                *p_username,
+                                       CPU_CHAR                *p_pwd,
+                                       SMTPc_SECURE_CFG        *p_secure_cfg,
+                                       SMTPc_MSG               *p_msg,
+                                       SMTPc_JOB_CMPL_FNCT      cmpl_fnct,
+                                       void                    *p_cmpl_arg,
+                                       SMTPc_ERR               *p_err);
+
+CPU_INT08U     SMTPc_QueueStatusGet   (SMTPc_JOB               *p_job,
+                                       SMTPc_ERR               *p_err_job);
+
+#if (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+void           SMTPc_QueueSubmitDly   (SMTPc_JOB               *p_job,
+                                       CPU_CHAR                *p_host_name,
+                                       CPU_INT16U               port,
+                                       CPU_CHAR                *p_username,
+                                       CPU_CHAR                *p_pwd,
+                                       SMTPc_SECURE_CFG        *p_secure_cfg,
+                                       SMTPc_MSG               *p_msg,
+                                       SMTPc_JOB_CMPL_FNCT      cmpl_fnct,
+                                       void                    *p_cmpl_arg,
+                                       CPU_INT32U               dly_ms,
+                                       SMTPc_ERR               *p_err);
+#endif
 
-void         SMTPc_SendMsg     (NET_SOCK_ID              sock_id,
-                                SMTPc_MSG               *msg,
-                                SMTPc_ERR               *perr);
+#if (SMTPc_CFG_QUEUE_RING_SIZE > 0u)
+void           SMTPc_QueueRingSubmit  (SMTPc_JOB               *p_job,
+                                       CPU_CHAR                *p_host_name,
+                                       CPU_INT16U               port,
+                                       CPU_CHAR                *p_username,
+                                       CPU_CHAR                *p_pwd,
+                                       SMTPc_SECURE_CFG        *p_secure_cfg,
+                                       SMTPc_MSG               *p_msg,
+                                       SMTPc_JOB_CMPL_FNCT      cmpl_fnct,
+                                       void                    *p_cmpl_arg,
+                                       SMTPc_ERR               *p_err);
+
+void           SMTPc_QueueRingStatsGet(SMTPc_QUEUE_RING_STATS  *p_stats);
+
+void           SMTPc_QueueRingStatsClr(void);
+#endif
+#endif
 
-void         SMTPc_Disconnect  (NET_SOCK_ID              sock_id,
-                                SMTPc_ERR               *perr);
+                                                                /* ---------------- PERSISTENT SPOOL FNCTS ------------ */
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+void           SMTPc_SpoolInit        (const  SMTPc_SPOOL_CFG  *p_cfg,
+                                       SMTPc_ERR               *p_err);
+
+CPU_INT32U     SMTPc_SpoolSubmit      (SMTPc_MSG               *p_msg,
+                                       SMTPc_ERR               *p_err);
+
+CPU_INT32U     SMTPc_SpoolSyncIdGet   (void);
+#endif
 
 
                                                                 /* -------------------- UTIL FNCTS -------------------- */
-void         SMTPc_SetMbox     (SMTPc_MBOX              *mbox,
-                                CPU_CHAR                *name,
-                                CPU_CHAR                *addr,
-                                SMTPc_ERR               *perr);
+void           SMTPc_SetMbox     (SMTPc_MBOX              *mbox,
+                                  CPU_CHAR                *name,
+                                  CPU_CHAR                *addr,
+                                  SMTPc_ERR               *perr);
+
+void           SMTPc_SetMsg      (SMTPc_MSG               *msg,
+                                  SMTPc_ERR               *perr);
+
+void           SMTPc_SetAttach   (SMTPc_ATTACH            *p_attach,
+                                  CPU_CHAR                *p_name,
+                                  CPU_CHAR                *p_content_type,
+                                  void                    *p_data,
+                                  CPU_INT32U               size,
+                                  SMTPc_ERR               *p_err);
+
+void           SMTPc_CapCacheClr (void);
 
-void         SMTPc_SetMsg      (SMTPc_MSG               *msg,
-                                SMTPc_ERR               *perr);
+void           SMTPc_PoolFlush   (void);
+
+void           SMTPc_TransportSet(const  SMTPc_TRANSPORT_API  *p_api,
+                                  SMTPc_ERR                   *p_err);
+
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)
+void           SMTPc_B64EncSet   (CPU_INT08U               enc,
+                                  SMTPc_ERR               *p_err);
+
+CPU_INT08U     SMTPc_B64EncGet   (void);
+#endif
+
+CPU_BOOLEAN    SMTPc_ErrIsTransient(SMTPc_ERR               err,
+                                    CPU_INT16U              rep_code);
 
 
 /*
@@ -625,6 +1523,14 @@ void         SMTPc_SetMsg      (SMTPc_MSG               *msg,
 #endif
 
 
+#ifndef  SMTPc_CFG_MAX_REP_TIMEOUT_MS
+#error  "SMTPc_CFG_MAX_REP_TIMEOUT_MS not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_MAX_REP_TIMEOUT_MS == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) || \
+        (SMTPc_CFG_MAX_REP_TIMEOUT_MS >= SMTPc_TRANSPORT_TIMEOUT_INFINITE))
+#error  "SMTPc_CFG_MAX_REP_TIMEOUT_MS illegally #define'd in 'smtp-c_cfg.h' [MUST be > 0 && < DEF_INT_32U_MAX_VAL]"
+#endif
+
+
 #ifndef  SMTPc_CFG_AUTH_EN
 #error  "SMTPc_CFG_AUTH_EN not #define'd in 'smtp-c_cfg.h [MUST be DEF_DISABLED || DEF_ENABLED]"
 #elif  ((SMTPc_CFG_AUTH_EN != DEF_DISABLED) && \
@@ -690,6 +1596,167 @@ void         SMTPc_SetMsg      (SMTPc_MSG               *msg,
 #endif
 
 
+#ifndef  SMTPc_CFG_CAP_CACHE_NBR_ENTRIES
+#error  "SMTPc_CFG_CAP_CACHE_NBR_ENTRIES not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_CAP_CACHE_NBR_ENTRIES <                   0) || \
+        (SMTPc_CFG_CAP_CACHE_NBR_ENTRIES > DEF_INT_08U_MAX_VAL))
+#error  "SMTPc_CFG_CAP_CACHE_NBR_ENTRIES illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 0 && <= 255]"
+#endif
+
+
+#ifndef  SMTPc_CFG_POOL_NBR_SESSIONS
+#error  "SMTPc_CFG_POOL_NBR_SESSIONS not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_POOL_NBR_SESSIONS <                   0) || \
+        (SMTPc_CFG_POOL_NBR_SESSIONS > DEF_INT_08U_MAX_VAL))
+#error  "SMTPc_CFG_POOL_NBR_SESSIONS illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 0 && <= 255]"
+#elif   (SMTPc_CFG_POOL_NBR_SESSIONS > 0)
+
+#ifndef  SMTPc_CFG_POOL_IDLE_TIMEOUT_MS
+#error  "SMTPc_CFG_POOL_IDLE_TIMEOUT_MS not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#endif
+
+#ifndef  SMTPc_CFG_POOL_MAX_MSG_PER_CONN
+#error  "SMTPc_CFG_POOL_MAX_MSG_PER_CONN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#endif
+
+#endif
+
+
+#ifndef  SMTPc_CFG_BDAT_CHUNK_LEN
+#error  "SMTPc_CFG_BDAT_CHUNK_LEN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif   (SMTPc_CFG_BDAT_CHUNK_LEN < 0)
+#error  "SMTPc_CFG_BDAT_CHUNK_LEN illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 0]"
+#endif
+
+
+#ifndef  SMTPc_CFG_BODY_RD_BUF_LEN
+#error  "SMTPc_CFG_BODY_RD_BUF_LEN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif   (SMTPc_CFG_BODY_RD_BUF_LEN < 0)
+#error  "SMTPc_CFG_BODY_RD_BUF_LEN illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 0]"
+#endif
+
+
+#ifndef  SMTPc_CFG_B64_PAIR_TBL_EN
+#error  "SMTPc_CFG_B64_PAIR_TBL_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_B64_PAIR_TBL_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_B64_PAIR_TBL_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_B64_PAIR_TBL_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#endif
+
+#ifndef  SMTPc_CFG_B64_SIMD_EN
+#error  "SMTPc_CFG_B64_SIMD_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_B64_SIMD_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_B64_SIMD_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_B64_SIMD_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#endif
+
+
+#ifndef  SMTPc_CFG_TX_SEG_LEN
+#error  "SMTPc_CFG_TX_SEG_LEN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif   (SMTPc_CFG_TX_SEG_LEN < 0)
+#error  "SMTPc_CFG_TX_SEG_LEN illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 0]"
+#endif
+
+
+#ifndef  SMTPc_CFG_ASYNC_EN
+#error  "SMTPc_CFG_ASYNC_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_ASYNC_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_ASYNC_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_ASYNC_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#elif   (SMTPc_CFG_ASYNC_EN == DEF_ENABLED)
+
+#ifndef  SMTPc_CFG_ASYNC_TIMEOUT_MS
+#error  "SMTPc_CFG_ASYNC_TIMEOUT_MS not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#endif
+
+#endif
+
+
+#ifndef  SMTPc_CFG_QUEUE_EN
+#error  "SMTPc_CFG_QUEUE_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_QUEUE_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_QUEUE_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_QUEUE_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#elif  ((SMTPc_CFG_QUEUE_EN          == DEF_ENABLED) && \
+        (SMTPc_CFG_POOL_NBR_SESSIONS == 0          ))
+#error  "SMTPc_CFG_QUEUE_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED if SMTPc_CFG_POOL_NBR_SESSIONS == 0]"
+#elif   (SMTPc_CFG_QUEUE_EN == DEF_ENABLED)
+
+#ifndef  SMTPc_CFG_QUEUE_RING_SIZE
+#error  "SMTPc_CFG_QUEUE_RING_SIZE not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_QUEUE_RING_SIZE < 0) || \
+       ((SMTPc_CFG_QUEUE_RING_SIZE & (SMTPc_CFG_QUEUE_RING_SIZE - 1)) != 0))
+#error  "SMTPc_CFG_QUEUE_RING_SIZE illegally #define'd in 'smtp-c_cfg.h' [MUST be 0 or a power of 2]"
+#elif   (SMTPc_CFG_QUEUE_RING_SIZE > 0)
+
+#ifndef  SMTPc_CFG_QUEUE_RING_POLL_MS
+#error  "SMTPc_CFG_QUEUE_RING_POLL_MS not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif   (SMTPc_CFG_QUEUE_RING_POLL_MS < 1)
+#error  "SMTPc_CFG_QUEUE_RING_POLL_MS illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 1]"
+#endif
+
+#ifndef  SMTPc_CFG_QUEUE_RING_ATOMIC_EN
+#error  "SMTPc_CFG_QUEUE_RING_ATOMIC_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_QUEUE_RING_ATOMIC_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_QUEUE_RING_ATOMIC_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_QUEUE_RING_ATOMIC_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#endif
+
+#ifndef  SMTPc_CFG_QUEUE_RING_WAKE_EN
+#error  "SMTPc_CFG_QUEUE_RING_WAKE_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_QUEUE_RING_WAKE_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_QUEUE_RING_WAKE_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_QUEUE_RING_WAKE_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#endif
+
+#if    ((CPU_CFG_TS_32_EN  != DEF_ENABLED) || \
+        (CPU_CFG_TS_TMR_EN != DEF_ENABLED))
+#error  "CPU_CFG_TS_32_EN/CPU_CFG_TS_TMR_EN illegally #define'd in 'cpu_cfg.h' [MUST be DEF_ENABLED if SMTPc_CFG_QUEUE_RING_SIZE > 0]"
+#endif
+
+#endif
+
+#endif
+
+
+#ifndef  SMTPc_CFG_SPOOL_EN
+#error  "SMTPc_CFG_SPOOL_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_SPOOL_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_SPOOL_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_SPOOL_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#elif  ((SMTPc_CFG_SPOOL_EN == DEF_ENABLED) && \
+        (SMTPc_CFG_QUEUE_EN != DEF_ENABLED))
+#error  "SMTPc_CFG_SPOOL_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED if SMTPc_CFG_QUEUE_EN is DEF_DISABLED]"
+#endif
+
+
+#ifndef  SMTPc_CFG_TRANSPORT_NET_EN
+#error  "SMTPc_CFG_TRANSPORT_NET_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_TRANSPORT_NET_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_TRANSPORT_NET_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_TRANSPORT_NET_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#endif
+
+
+#ifndef  SMTPc_CFG_SCHED_EN
+#error  "SMTPc_CFG_SCHED_EN not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif  ((SMTPc_CFG_SCHED_EN != DEF_DISABLED) && \
+        (SMTPc_CFG_SCHED_EN != DEF_ENABLED ))
+#error  "SMTPc_CFG_SCHED_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED || DEF_ENABLED]"
+#elif  ((SMTPc_CFG_SCHED_EN == DEF_ENABLED) && \
+        (SMTPc_CFG_QUEUE_EN != DEF_ENABLED))
+#error  "SMTPc_CFG_SCHED_EN illegally #define'd in 'smtp-c_cfg.h' [MUST be DEF_DISABLED if SMTPc_CFG_QUEUE_EN is DEF_DISABLED]"
+#elif   (SMTPc_CFG_SCHED_EN == DEF_ENABLED)
+
+#ifndef  SMTPc_CFG_SCHED_TICK_MS
+#error  "SMTPc_CFG_SCHED_TICK_MS not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
+#elif   (SMTPc_CFG_SCHED_TICK_MS < 1)
+#error  "SMTPc_CFG_SCHED_TICK_MS illegally #define'd in 'smtp-c_cfg.h' [MUST be >= 1]"
+#endif
+
+#endif
+
+
 #ifndef  SMTPc_CFG_MSG_MAX_ATTACH
 #error  "SMTPc_CFG_MSG_MAX_ATTACH not #define'd in 'smtp-c_cfg.h' see template file in package named 'smtp-c_cfg.h'"
 #elif  ((SMTPc_CFG_MSG_MAX_ATTACH <                   0) || \
@@ -0,0 +1,610 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  uC/SMTPc SPOOL STORAGE : POSIX FILES
+*
+* Filename : smtp-c_spool_posix.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) The storage functions are called by the spool with its lock held, except SegSync() (see
+*                'smtp-c.h  SMTPc_SPOOL_API  Note #1d') : the descriptor of the segment being appended to is
+*                only used by the functions called with the lock held, which makes it safe to cache.
+*                SMTPc_SpoolPosix_SegSync() opens its own descriptor & shares no state with the others.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#ifndef  _POSIX_C_SOURCE
+#define  _POSIX_C_SOURCE                              200809L   /* pread(), fsync() & O_DIRECTORY.                      */
+#endif
+
+#define  MICRIUM_SOURCE
+#define  SMTPc_SPOOL_POSIX_MODULE
+
+#include  "smtp-c_spool_posix.h"
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+#include  <dirent.h>
+#include  <errno.h>
+#include  <fcntl.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <unistd.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  SMTPc_SPOOL_POSIX_PATH_LEN_MAX                  256u   /* Max len of the path of a seg file.                   */
+#define  SMTPc_SPOOL_POSIX_SEG_NAME_LEN                   12u   /* "xxxxxxxx.seg".                                      */
+#define  SMTPc_SPOOL_POSIX_SEG_EXT                    ".seg"
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  int          SMTPc_SpoolPosixFd      = -1;              /* Seg file appended to, -1 if none (see Note #1).      */
+static  CPU_INT32U   SMTPc_SpoolPosixFdSegId;                   /* ... & its seg.                                       */
+static  CPU_BOOLEAN  SMTPc_SpoolPosixDirSyncDone;               /* Dir synced by SegSync() ...                          */
+static  CPU_INT32U   SMTPc_SpoolPosixDirSyncSegId;              /* ... after the creation of this seg.                  */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void        SMTPc_SpoolPosix_SegRangeGet(void         *p_arg,
+                                                 CPU_INT32U   *p_seg_first,
+                                                 CPU_INT32U   *p_seg_last,
+                                                 CPU_BOOLEAN  *p_found,
+                                                 SMTPc_ERR    *p_err);
+
+static  CPU_INT32U  SMTPc_SpoolPosix_SegRd      (void         *p_arg,
+                                                 CPU_INT32U    seg_id,
+                                                 CPU_INT32U    offset,
+                                                 void         *p_buf,
+                                                 CPU_INT32U    len,
+                                                 SMTPc_ERR    *p_err);
+
+static  void        SMTPc_SpoolPosix_SegWr      (void         *p_arg,
+                                                 CPU_INT32U    seg_id,
+                                                 const  void  *p_data,
+                                                 CPU_INT32U    len,
+                                                 SMTPc_ERR    *p_err);
+
+static  void        SMTPc_SpoolPosix_SegSync    (void         *p_arg,
+                                                 CPU_INT32U    seg_id,
+                                                 SMTPc_ERR    *p_err);
+
+static  void        SMTPc_SpoolPosix_SegDel     (void         *p_arg,
+                                                 CPU_INT32U    seg_id,
+                                                 SMTPc_ERR    *p_err);
+
+static  CPU_BOOLEAN SMTPc_SpoolPosix_PathGet    (void         *p_arg,
+                                                 CPU_INT32U    seg_id,
+                                                 CPU_CHAR     *p_path);
+
+static  CPU_BOOLEAN SMTPc_SpoolPosix_DirSync    (void         *p_arg);
+
+static  void        SMTPc_SpoolPosix_FdClose    (void);
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+const  SMTPc_SPOOL_API  SMTPc_SpoolAPI_Posix = {
+    SMTPc_SpoolPosix_SegRangeGet,
+    SMTPc_SpoolPosix_SegRd,
+    SMTPc_SpoolPosix_SegWr,
+    SMTPc_SpoolPosix_SegSync,
+    SMTPc_SpoolPosix_SegDel
+};
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_SpoolPosix_SegRangeGet()
+*
+* Description : Get the lowest & highest numbers of the segment files of the spool directory.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+*               p_seg_first     Pointer to variable that will receive the lowest  segment number.
+*
+*               p_seg_last      Pointer to variable that will receive the highest segment number.
+*
+*               p_found         Pointer to variable that will receive DEF_YES if any segment file was found.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SPOOL_IO                  Directory could not be read.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolRecover(), through SMTPc_SpoolAPI_Posix.
+*
+* Note(s)     : (1) Files whose name is not a segment name are ignored.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SpoolPosix_SegRangeGet (void         *p_arg,
+                                            CPU_INT32U   *p_seg_first,
+                                            CPU_INT32U   *p_seg_last,
+                                            CPU_BOOLEAN  *p_found,
+                                            SMTPc_ERR    *p_err)
+{
+    DIR            *p_dir;
+    struct dirent  *p_dirent;
+    char           *p_end;
+    unsigned long   seg_id;
+
+
+   *p_found = DEF_NO;
+
+    p_dir = opendir((const char *)p_arg);
+    if (p_dir == (DIR *)0) {
+       *p_err = SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+
+    p_dirent = readdir(p_dir);
+    while (p_dirent != (struct dirent *)0) {
+        if ((strlen(p_dirent->d_name) == SMTPc_SPOOL_POSIX_SEG_NAME_LEN) &&
+            (strcmp(&p_dirent->d_name[8], SMTPc_SPOOL_POSIX_SEG_EXT) == 0)) {
+            seg_id = strtoul(p_dirent->d_name, &p_end, 16);
+            if (p_end == &p_dirent->d_name[8]) {                /* See Note #1.                                         */
+                if ((*p_found     == DEF_NO) ||
+                    (seg_id       < *p_seg_first)) {
+                    *p_seg_first  = (CPU_INT32U)seg_id;
+                }
+                if ((*p_found     == DEF_NO) ||
+                    (seg_id       > *p_seg_last)) {
+                    *p_seg_last   = (CPU_INT32U)seg_id;
+                }
+                *p_found = DEF_YES;
+            }
+        }
+        p_dirent = readdir(p_dir);
+    }
+
+    (void)closedir(p_dir);
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_SpoolPosix_SegRd()
+*
+* Description : Read data from a segment file.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+*               seg_id          Number of the segment.
+*
+*               offset          Offset of the data in the segment.
+*
+*               p_buf           Pointer to the buffer receiving the data.
+*
+*               len             Length of the data to read.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SPOOL_IO                  File could not be read.
+*
+* Return(s)   : Number of octets read, lower than 'len' at the end of the segment.
+*
+* Caller(s)   : SMTPc_SpoolRecover(), through SMTPc_SpoolAPI_Posix.
+*
+* Note(s)     : (1) A segment file that does not exist is read as an empty segment.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_SpoolPosix_SegRd (void        *p_arg,
+                                            CPU_INT32U   seg_id,
+                                            CPU_INT32U   offset,
+                                            void        *p_buf,
+                                            CPU_INT32U   len,
+                                            SMTPc_ERR   *p_err)
+{
+    CPU_CHAR    path[SMTPc_SPOOL_POSIX_PATH_LEN_MAX];
+    CPU_INT32U  len_rd;
+    ssize_t     rtn;
+    int         fd;
+
+
+    if (SMTPc_SpoolPosix_PathGet(p_arg, seg_id, path) != DEF_OK) {
+       *p_err = SMTPc_ERR_SPOOL_IO;
+        return (0u);
+    }
+
+    fd = open((const char *)path, O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) {                                  /* See Note #1.                                         */
+           *p_err = SMTPc_ERR_NONE;
+        } else {
+           *p_err = SMTPc_ERR_SPOOL_IO;
+        }
+        return (0u);
+    }
+
+    len_rd = 0u;
+    while (len_rd < len) {
+        rtn = pread(fd,
+                    (CPU_INT08U *)p_buf + len_rd,
+                    len - len_rd,
+                    (off_t)offset + len_rd);
+        if (rtn < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            (void)close(fd);
+           *p_err = SMTPc_ERR_SPOOL_IO;
+            return (len_rd);
+        }
+        if (rtn == 0) {                                         /* End of seg.                                          */
+            break;
+        }
+        len_rd += (CPU_INT32U)rtn;
+    }
+
+    (void)close(fd);
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (len_rd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_SpoolPosix_SegWr()
+*
+* Description : Append data to a segment file, creating it if needed.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+*               seg_id          Number of the segment.
+*
+*               p_data          Pointer to the data.
+*
+*               len             Length of the data.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SPOOL_IO                  File could not be created or written.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolRecWr(), through SMTPc_SpoolAPI_Posix.
+*
+* Note(s)     : (1) The file is kept open until data is appended to another segment (see 'smtp-c_spool_posix.c
+*                   Note #1').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SpoolPosix_SegWr (void          *p_arg,
+                                      CPU_INT32U     seg_id,
+                                      const  void   *p_data,
+                                      CPU_INT32U     len,
+                                      SMTPc_ERR     *p_err)
+{
+    CPU_CHAR    path[SMTPc_SPOOL_POSIX_PATH_LEN_MAX];
+    CPU_INT32U  len_wr;
+    ssize_t     rtn;
+
+
+                                                                /* ------------------ OPEN SEG FILE ------------------- */
+    if ((SMTPc_SpoolPosixFd      <  0) ||                       /* See Note #1.                                         */
+        (SMTPc_SpoolPosixFdSegId != seg_id)) {
+        SMTPc_SpoolPosix_FdClose();
+
+        if (SMTPc_SpoolPosix_PathGet(p_arg, seg_id, path) != DEF_OK) {
+           *p_err = SMTPc_ERR_SPOOL_IO;
+            return;
+        }
+
+        SMTPc_SpoolPosixFd = open((const char *)path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (SMTPc_SpoolPosixFd < 0) {
+           *p_err = SMTPc_ERR_SPOOL_IO;
+            return;
+        }
+        SMTPc_SpoolPosixFdSegId = seg_id;
+    }
+                                                                /* --------------------- WR DATA ---------------------- */
+    len_wr = 0u;
+    while (len_wr < len) {
+        rtn = write(SMTPc_SpoolPosixFd,
+                    (const CPU_INT08U *)p_data + len_wr,
+                    len - len_wr);
+        if (rtn < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SMTPc_SpoolPosix_FdClose();
+           *p_err = SMTPc_ERR_SPOOL_IO;
+            return;
+        }
+        len_wr += (CPU_INT32U)rtn;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_SpoolPosix_SegSync()
+*
+* Description : Make the data appended to a segment file durable.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+*               seg_id          Number of the segment.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SPOOL_IO                  File or directory could not be synced.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolTask(), through SMTPc_SpoolAPI_Posix.
+*
+* Note(s)     : (1) The function MAY run while data is appended to the segment (see 'smtp-c_spool_posix.c
+*                   Note #1') : the file is opened on its own descriptor, since fsync() flushes all the data
+*                   written to a file, through any descriptor.  A segment file that does not exist holds no
+*                   data to sync.
+*
+*               (2) The directory is synced once after the file of a newer segment than the last one synced
+*                   exists, so that the files themselves survive a reset.  A single sync of the directory
+*                   covers all the files created before it.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SpoolPosix_SegSync (void        *p_arg,
+                                        CPU_INT32U   seg_id,
+                                        SMTPc_ERR   *p_err)
+{
+    CPU_CHAR  path[SMTPc_SPOOL_POSIX_PATH_LEN_MAX];
+    int       fd;
+    int       rtn;
+
+
+    if (SMTPc_SpoolPosix_PathGet(p_arg, seg_id, path) != DEF_OK) {
+       *p_err = SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+    fd = open((const char *)path, O_RDONLY);                    /* See Note #1.                                         */
+    if (fd < 0) {
+       *p_err = (errno == ENOENT) ? SMTPc_ERR_NONE : SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+    rtn = fsync(fd);
+    (void)close(fd);
+    if (rtn != 0) {
+       *p_err = SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+
+    if ((SMTPc_SpoolPosixDirSyncDone  != DEF_YES) ||            /* See Note #2.                                         */
+        (SMTPc_SpoolPosixDirSyncSegId <  seg_id)) {
+        if (SMTPc_SpoolPosix_DirSync(p_arg) != DEF_OK) {
+           *p_err = SMTPc_ERR_SPOOL_IO;
+            return;
+        }
+        SMTPc_SpoolPosixDirSyncDone  = DEF_YES;
+        SMTPc_SpoolPosixDirSyncSegId = seg_id;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       SMTPc_SpoolPosix_SegDel()
+*
+* Description : Delete a segment file.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+*               seg_id          Number of the segment.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error.
+*                               SMTPc_ERR_SPOOL_IO                  File could not be deleted.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolTask(), through SMTPc_SpoolAPI_Posix.
+*
+* Note(s)     : (1) The directory is synced so that the deletion is durable before any newer segment is
+*                   deleted (see 'smtp-c.c  SMTPc_SpoolTask()  Note #5').  A segment file that does not exist
+*                   is already deleted.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SpoolPosix_SegDel (void        *p_arg,
+                                       CPU_INT32U   seg_id,
+                                       SMTPc_ERR   *p_err)
+{
+    CPU_CHAR  path[SMTPc_SPOOL_POSIX_PATH_LEN_MAX];
+
+
+    if (SMTPc_SpoolPosixFdSegId == seg_id) {
+        SMTPc_SpoolPosix_FdClose();
+    }
+
+    if (SMTPc_SpoolPosix_PathGet(p_arg, seg_id, path) != DEF_OK) {
+       *p_err = SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+    if (unlink((const char *)path) != 0) {
+        if (errno != ENOENT) {                                  /* See Note #1.                                         */
+           *p_err = SMTPc_ERR_SPOOL_IO;
+            return;
+        }
+    }
+
+    if (SMTPc_SpoolPosix_DirSync(p_arg) != DEF_OK) {
+       *p_err = SMTPc_ERR_SPOOL_IO;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_SpoolPosix_PathGet()
+*
+* Description : Build the path of a segment file.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+*               seg_id          Number of the segment.
+*
+*               p_path          Pointer to the buffer receiving the path, of SMTPc_SPOOL_POSIX_PATH_LEN_MAX
+*                               octets.
+*
+* Return(s)   : DEF_OK,   if path built.
+*
+*               DEF_FAIL, if path too long.
+*
+* Caller(s)   : SMTPc_SpoolPosix_SegDel(),
+*               SMTPc_SpoolPosix_SegRd(),
+*               SMTPc_SpoolPosix_SegSync(),
+*               SMTPc_SpoolPosix_SegWr().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_SpoolPosix_PathGet (void        *p_arg,
+                                               CPU_INT32U   seg_id,
+                                               CPU_CHAR    *p_path)
+{
+    int  len;
+
+
+    len = snprintf((char *)p_path,
+                   SMTPc_SPOOL_POSIX_PATH_LEN_MAX,
+                   "%s/%08lx" SMTPc_SPOOL_POSIX_SEG_EXT,
+                   (const char *)p_arg,
+                   (unsigned long)seg_id);
+    if ((len <  0) ||
+        (len >= (int)SMTPc_SPOOL_POSIX_PATH_LEN_MAX)) {
+        return (DEF_FAIL);
+    }
+
+    return (DEF_OK);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_SpoolPosix_DirSync()
+*
+* Description : Make the creation & deletion of the segment files durable.
+*
+* Argument(s) : p_arg           Path of the spool directory.
+*
+* Return(s)   : DEF_OK,   if directory synced.
+*
+*               DEF_FAIL, otherwise.
+*
+* Caller(s)   : SMTPc_SpoolPosix_SegDel(),
+*               SMTPc_SpoolPosix_SegSync().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_SpoolPosix_DirSync (void  *p_arg)
+{
+    int  fd;
+    int  rtn;
+
+
+    fd = open((const char *)p_arg, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return (DEF_FAIL);
+    }
+    rtn = fsync(fd);
+    (void)close(fd);
+
+    return ((rtn == 0) ? DEF_OK : DEF_FAIL);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_SpoolPosix_FdClose()
+*
+* Description : Close the segment file being appended to, if any.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SpoolPosix_SegDel(),
+*               SMTPc_SpoolPosix_SegWr().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_SpoolPosix_FdClose (void)
+{
+    if (SMTPc_SpoolPosixFd >= 0) {
+        (void)close(SMTPc_SpoolPosixFd);
+        SMTPc_SpoolPosixFd = -1;
+    }
+}
+#endif
@@ -0,0 +1,74 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  uC/SMTPc SPOOL STORAGE : POSIX FILES
+*
+* Filename : smtp-c_spool_posix.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Storage of the persistent spool (see 'smtp-c.h  SMTPc_SPOOL_API') on a POSIX file system.
+*                Each segment is a file of the directory passed as storage argument ('SMTPc_SPOOL_CFG
+*                StorageArg'), named after the number of the segment : "0000002a.seg".  The directory
+*                MUST exist & SHOULD hold no other file.
+*
+*            (2) Appended data is made durable with fsync(); the directory is synced as well when a
+*                segment was created or deleted.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  SMTPc_SPOOL_POSIX_MODULE_PRESENT
+#define  SMTPc_SPOOL_POSIX_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+
+#include  <Source/smtp-c.h>
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_SPOOL_EN == DEF_ENABLED)
+extern  const  SMTPc_SPOOL_API  SMTPc_SpoolAPI_Posix;           /* Storage fncts (see Note #1).                         */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of smtp-c spool posix module include.            */
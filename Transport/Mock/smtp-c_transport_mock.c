@@ -0,0 +1,1905 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                 uC/SMTPc TRANSPORT : IN-PROCESS MOCK SERVER
+*
+* Filename : smtp-c_transport_mock.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) The server runs in the task of the client : the commands are executed as they are
+*                transmitted, & their replies queued in the reply buffer of the connection, until received.
+*
+*            (2) Each connection is used by a single task at a time, like a socket.  The free connections,
+*                the configuration & the statistics are shared, & accessed in critical sections.
+*
+*            (3) A blocking reception waits for the delay of the replies (see 'smtp-c_transport_mock.h
+*                DATA TYPES  Note #1b') by polling the timestamp of the server (see
+*                'SMTPc_TransportMock_TS_Get_ms()'), so that no kernel is needed.  A reception that times out
+*                returns SMTPc_ERR_WOULD_BLOCK, like a non-blocking one that could not proceed.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  MICRIUM_SOURCE
+#define  SMTPc_TRANSPORT_MOCK_MODULE
+
+#include  "smtp-c_transport_mock.h"
+
+#include  <lib_mem.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  SMTPc_TRANSPORT_MOCK_LINE_LEN                  1024u   /* Max len of a cmd line, longer lines are truncated.   */
+#define  SMTPc_TRANSPORT_MOCK_REP_BUF_LEN               4096u   /* Size of the reply buf of each conn.                  */
+                                                                /* See 'smtp-c_transport_mock.h  DATA TYPES  Note #3'.  */
+#define  SMTPc_TRANSPORT_MOCK_LAT_SUB_BIT_NBR              5u   /* 32 linear sub-buckets per power of 2 ...             */
+#define  SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR                 32u
+#define  SMTPc_TRANSPORT_MOCK_LAT_HIST_NBR               896u   /* ... for 32-bit latencies : 32 * (32 - 5 + 1).        */
+#define  SMTPc_TRANSPORT_MOCK_EXT_NBR_MAX                  6u   /* Max nbr of ext lines in the reply to EHLO.           */
+#define  SMTPc_TRANSPORT_MOCK_SIZE_LEN                    16u   /* "SIZE " + 10 digits + NUL.                           */
+#define  SMTPc_TRANSPORT_MOCK_EOM_LEN                     (sizeof(SMTPc_EOM) - 1u)
+
+#define  SMTPc_TRANSPORT_MOCK_ADDR                      "127.0.0.1"
+#define  SMTPc_TRANSPORT_MOCK_DOMAIN                    "mock"
+
+                                                                /* ------------------ STATES OF CONNS ----------------- */
+#define  SMTPc_TRANSPORT_MOCK_STATE_CMD                    0u   /* Rx'ing cmd lines.                                    */
+#define  SMTPc_TRANSPORT_MOCK_STATE_DATA                   1u   /* Rx'ing msg content, up to "<CRLF>.<CRLF>".           */
+#define  SMTPc_TRANSPORT_MOCK_STATE_BDAT                   2u   /* Rx'ing BDAT chunk.                                   */
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  smtpc_transport_mock_conn  SMTPc_TRANSPORT_MOCK_CONN;
+
+struct  smtpc_transport_mock_conn {
+    CPU_BOOLEAN                 Used;                           /* Conn open by the client.                             */
+    CPU_BOOLEAN                 Closed;                         /* Conn closed by the server.                           */
+    CPU_INT08U                  State;                          /* SMTPc_TRANSPORT_MOCK_STATE_xxx.                      */
+    CPU_INT32U                  TimeoutMs;                      /* Deadline of the rx (see Note #3).                    */
+
+    CPU_CHAR                    LineBuf[SMTPc_TRANSPORT_MOCK_LINE_LEN];
+    CPU_INT32U                  LineLen;                        /* Len of the cmd line being rx'd.                      */
+    CPU_INT08U                  EomIx;                          /* Nbr of octets of "<CRLF>.<CRLF>" matched.            */
+    CPU_INT32U                  BdatLen;                        /* Octets of the BDAT chunk left to rx ...              */
+    CPU_BOOLEAN                 BdatLast;                       /* ... whether it is the last one ...                   */
+    CPU_INT16U                  BdatRepCode;                    /* ... & the failure to reply at its end, 0 if none.    */
+
+    CPU_BOOLEAN                 InTrans;                        /* Mail transaction started by MAIL ...                 */
+    CPU_TS64                    TransTS;                        /* ... at this time ...                                 */
+    CPU_INT32U                  RcptNbr;                        /* ... with this nbr of rcpts ...                       */
+    CPU_INT32U                  MsgLen;                         /* ... & of content octets.                             */
+
+    CPU_INT08U                  RepBuf[SMTPc_TRANSPORT_MOCK_REP_BUF_LEN];
+    CPU_INT32U                  RepRdIx;                        /* Replies queued, from this ix ...                     */
+    CPU_INT32U                  RepWrIx;                        /* ... to this one ...                                  */
+    SMTPc_TS_MS                 RepTS;                          /* ... available from this time ...                     */
+    CPU_INT32U                  RepDlyMs;                       /* ... on, plus this dly ...                            */
+    CPU_INT16U                  RepSegLen;                      /* ... & rx'd by segs of this len, 0 if unsplit.        */
+    CPU_BOOLEAN                 LatPend;                        /* Final reply of a msg queued, ending at ...           */
+    CPU_INT32U                  LatIx;                          /* ... this ix.                                         */
+
+    SMTPc_TRANSPORT_MOCK_CONN  *NextPtr;                        /* Next free conn.                                      */
+};
+
+
+typedef  struct  smtpc_transport_mock_cmd {
+    const  CPU_CHAR            *StrPtr;                         /* Cmd verb ...                                         */
+    CPU_INT08U                  Cmd;                            /* ... & its SMTPc_TRANSPORT_MOCK_CMD_xxx.              */
+} SMTPc_TRANSPORT_MOCK_CMD;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  SMTPc_TRANSPORT_MOCK_CMD  SMTPc_TransportMock_CmdTbl[] = {
+    { SMTPc_CMD_EHLO, SMTPc_TRANSPORT_MOCK_CMD_EHLO },
+    { SMTPc_CMD_HELO, SMTPc_TRANSPORT_MOCK_CMD_HELO },
+    { SMTPc_CMD_AUTH, SMTPc_TRANSPORT_MOCK_CMD_AUTH },
+    { SMTPc_CMD_MAIL, SMTPc_TRANSPORT_MOCK_CMD_MAIL },
+    { SMTPc_CMD_RCPT, SMTPc_TRANSPORT_MOCK_CMD_RCPT },
+    { SMTPc_CMD_DATA, SMTPc_TRANSPORT_MOCK_CMD_DATA },
+    { SMTPc_CMD_BDAT, SMTPc_TRANSPORT_MOCK_CMD_BDAT },
+    { SMTPc_CMD_RSET, SMTPc_TRANSPORT_MOCK_CMD_RSET },
+    { SMTPc_CMD_NOOP, SMTPc_TRANSPORT_MOCK_CMD_NOOP },
+    { SMTPc_CMD_QUIT, SMTPc_TRANSPORT_MOCK_CMD_QUIT }
+};
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN                 SMTPc_TransportMock_InitDone = DEF_NO;
+static  SMTPc_TRANSPORT_MOCK_CONN  *SMTPc_TransportMock_ConnTbl;
+static  CPU_INT32U                  SMTPc_TransportMock_ConnNbrMax;
+static  SMTPc_TRANSPORT_MOCK_CONN  *SMTPc_TransportMock_ConnFreePtr;
+
+static  SMTPc_TRANSPORT_MOCK_CFG    SMTPc_TransportMock_Cfg;
+static  SMTPc_TRANSPORT_MOCK_FAULT  SMTPc_TransportMock_FaultTbl[SMTPc_TRANSPORT_MOCK_FAULT_NBR_MAX];
+static  CPU_INT32U                  SMTPc_TransportMock_FaultCmdCtrTbl[SMTPc_TRANSPORT_MOCK_FAULT_NBR_MAX];
+
+static  CPU_INT32U                  SMTPc_TransportMock_ConnCtr;
+static  CPU_INT32U                  SMTPc_TransportMock_MsgCtr;
+static  CPU_INT32U                  SMTPc_TransportMock_RcptCtr;
+static  CPU_INT64U                  SMTPc_TransportMock_OctetCtr;
+static  CPU_INT32U                  SMTPc_TransportMock_FaultCtr;
+                                                                /* Latencies, in us.                                    */
+static  CPU_INT64U                  SMTPc_TransportMock_LatSum;
+static  CPU_INT32U                  SMTPc_TransportMock_LatMax;
+static  CPU_INT32U                  SMTPc_TransportMock_LatHistTbl[SMTPc_TRANSPORT_MOCK_LAT_HIST_NBR];
+static  CPU_TS64                    SMTPc_TransportMock_StatsTS;
+                                                                /* See 'smtp-c_transport_mock.h  DATA TYPES  Note #4'.  */
+static  CPU_BOOLEAN                 SMTPc_TransportMock_RecovPend;
+static  SMTPc_TS_MS                 SMTPc_TransportMock_RecovTS;
+static  CPU_INT32U                  SMTPc_TransportMock_RecovCtr;
+static  CPU_INT64U                  SMTPc_TransportMock_RecovSum;
+static  CPU_INT32U                  SMTPc_TransportMock_RecovMax;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID               SMTPc_TransportMock_Open        (CPU_CHAR                         *p_host_name,
+                                                                     CPU_INT16U                        port,
+                                                                     SMTPc_SECURE_CFG                 *p_secure_cfg,
+                                                                     CPU_INT32U                        timeout_ms,
+                                                                     SMTPc_ERR                        *p_err);
+
+static  CPU_INT32U                  SMTPc_TransportMock_Tx          (SMTPc_SOCK_ID                     sock_id,
+                                                                     const  void                      *p_data,
+                                                                     CPU_INT32U                        len,
+                                                                     SMTPc_ERR                        *p_err);
+
+static  CPU_INT32U                  SMTPc_TransportMock_TxV         (SMTPc_SOCK_ID                     sock_id,
+                                                                     const  SMTPc_TRANSPORT_VEC       *p_vec,
+                                                                     CPU_INT08U                        vec_nbr,
+                                                                     SMTPc_ERR                        *p_err);
+
+static  CPU_INT32U                  SMTPc_TransportMock_Rx          (SMTPc_SOCK_ID                     sock_id,
+                                                                     void                             *p_buf,
+                                                                     CPU_INT32U                        len,
+                                                                     SMTPc_ERR                        *p_err);
+
+static  void                        SMTPc_TransportMock_Close       (SMTPc_SOCK_ID                     sock_id,
+                                                                     CPU_INT32U                        timeout_ms);
+
+static  void                        SMTPc_TransportMock_DeadlineSet (SMTPc_SOCK_ID                     sock_id,
+                                                                     CPU_INT32U                        timeout_ms,
+                                                                     SMTPc_ERR                        *p_err);
+
+static  void                        SMTPc_TransportMock_LocalAddrGet(SMTPc_SOCK_ID                     sock_id,
+                                                                     CPU_CHAR                         *p_addr,
+                                                                     CPU_INT08U                       *p_family,
+                                                                     SMTPc_ERR                        *p_err);
+
+static  SMTPc_TS_MS                 SMTPc_TransportMock_TS_Get_ms   (void);
+
+static  void                        SMTPc_TransportMock_Dly         (CPU_INT32U                        dly_ms);
+
+static  SMTPc_TRANSPORT_MOCK_CONN  *SMTPc_TransportMock_ConnGet     (SMTPc_SOCK_ID                     sock_id);
+
+static  void                        SMTPc_TransportMock_SrvRx       (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     const  CPU_INT08U                *p_data,
+                                                                     CPU_INT32U                        len,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  void                        SMTPc_TransportMock_SrvCmd      (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  void                        SMTPc_TransportMock_SrvEHLO     (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  void                        SMTPc_TransportMock_SrvEOM      (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  void                        SMTPc_TransportMock_SrvDlySet   (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  CPU_BOOLEAN                 SMTPc_TransportMock_SrvFaultChk (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     CPU_INT08U                        cmd,
+                                                                     CPU_INT16U                       *p_rep_code);
+
+static  void                        SMTPc_TransportMock_SrvFail     (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     CPU_INT16U                        rep_code,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  void                        SMTPc_TransportMock_RepAdd      (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                                                     CPU_INT16U                        rep_code,
+                                                                     CPU_CHAR                          sep,
+                                                                     const  CPU_CHAR                  *p_enh,
+                                                                     const  CPU_CHAR                  *p_text,
+                                                                     const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg);
+
+static  void                        SMTPc_TransportMock_LatRec      (SMTPc_TRANSPORT_MOCK_CONN        *p_conn);
+
+static  CPU_INT32U                  SMTPc_TransportMock_LatPctGet   (const  CPU_INT32U               *p_hist_tbl,
+                                                                     CPU_INT32U                        msg_ctr,
+                                                                     CPU_INT32U                        per_mille,
+                                                                     CPU_INT32U                        lat_max);
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Mock = {
+    SMTPc_TransportMock_Open,
+    SMTPc_TransportMock_Tx,
+    SMTPc_TransportMock_TxV,
+    SMTPc_TransportMock_Rx,
+    SMTPc_TransportMock_Close,
+    SMTPc_TransportMock_DeadlineSet,
+    SMTPc_TransportMock_LocalAddrGet,
+    SMTPc_TransportMock_TS_Get_ms
+};
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportMock_Init()
+*
+* Description : Initialize the transport & allocate its connections.
+*
+* Argument(s) : conn_nbr_max    Maximum number of connections open at once.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, transport ready.
+*                               SMTPc_ERR_INVALID_CFG               Invalid number of connections.
+*                               SMTPc_ERR_INIT_FAILED               Transport already initialized, or
+*                                                                       allocation failed.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The function MUST be called once, before the transport is set (see
+*                   'smtp-c_transport_mock.h  Note #1').  The memory is never freed.
+*
+*               (2) The server starts with the default configuration : no extension, no delay & no
+*                   fault.
+*********************************************************************************************************
+*/
+
+void  SMTPc_TransportMock_Init (CPU_INT32U   conn_nbr_max,
+                                SMTPc_ERR   *p_err)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_tbl;
+    CPU_INT32U                  i;
+    LIB_MEM_ERR                 err_lib;
+
+
+    if ((conn_nbr_max == 0u) ||                                 /* Conn ix MUST fit in a sock ID.                       */
+        ((CPU_INT32U)(SMTPc_SOCK_ID)(conn_nbr_max - 1u) != (conn_nbr_max - 1u))) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+    if (SMTPc_TransportMock_InitDone == DEF_YES) {              /* See Note #1.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    p_tbl = (SMTPc_TRANSPORT_MOCK_CONN *)Mem_SegAlloc("SMTPc Mock Conns",
+                                                       DEF_NULL,
+                                                       conn_nbr_max * sizeof(SMTPc_TRANSPORT_MOCK_CONN),
+                                                      &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    for (i = 0u; i < conn_nbr_max; i++) {
+        p_tbl[i].Used    = DEF_NO;
+        p_tbl[i].NextPtr = (i + 1u < conn_nbr_max) ? &p_tbl[i + 1u] : (SMTPc_TRANSPORT_MOCK_CONN *)0;
+    }
+                                                                /* See Note #2.                                         */
+    Mem_Clr(&SMTPc_TransportMock_Cfg, sizeof(SMTPc_TransportMock_Cfg));
+    SMTPc_TransportMock_Cfg.FaultTbl = SMTPc_TransportMock_FaultTbl;
+    SMTPc_TransportMock_Cfg.FaultNbr = 0u;
+    SMTPc_TransportMock_StatsClr();
+
+    SMTPc_TransportMock_ConnTbl     = p_tbl;
+    SMTPc_TransportMock_ConnNbrMax  = conn_nbr_max;
+    SMTPc_TransportMock_ConnFreePtr = p_tbl;
+    SMTPc_TransportMock_InitDone    = DEF_YES;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportMock_CfgSet()
+*
+* Description : Configure the server.
+*
+* Argument(s) : p_cfg           Pointer to the configuration (see 'smtp-c_transport_mock.h  DATA TYPES
+*                               Note #1').
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, configuration applied.
+*                               SMTPc_ERR_NULL_ARG                  Argument 'p_cfg' passed a NULL pointer, or
+*                                                                       faults without table.
+*                               SMTPc_ERR_INVALID_CFG               Too many faults, or invalid command to
+*                                                                       fault.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The configuration & its faults are copied : they apply to the connections already
+*                   open, from their next command on.  The occurrences of the commands to fault are
+*                   counted from 0 again.
+*********************************************************************************************************
+*/
+
+void  SMTPc_TransportMock_CfgSet (const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg,
+                                  SMTPc_ERR                       *p_err)
+{
+    CPU_INT08U  i;
+    CPU_SR_ALLOC();
+
+
+    if (p_cfg == (const SMTPc_TRANSPORT_MOCK_CFG *)0) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+    if (p_cfg->FaultNbr > SMTPc_TRANSPORT_MOCK_FAULT_NBR_MAX) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+    if ((p_cfg->FaultNbr >  0u) &&
+        (p_cfg->FaultTbl == (const SMTPc_TRANSPORT_MOCK_FAULT *)0)) {
+       *p_err = SMTPc_ERR_NULL_ARG;
+        return;
+    }
+    for (i = 0u; i < p_cfg->FaultNbr; i++) {
+        if (p_cfg->FaultTbl[i].Cmd > SMTPc_TRANSPORT_MOCK_CMD_ANY) {
+           *p_err = SMTPc_ERR_INVALID_CFG;
+            return;
+        }
+    }
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    SMTPc_TransportMock_Cfg          = *p_cfg;
+    SMTPc_TransportMock_Cfg.FaultTbl =  SMTPc_TransportMock_FaultTbl;
+    for (i = 0u; i < p_cfg->FaultNbr; i++) {
+        SMTPc_TransportMock_FaultTbl[i]       = p_cfg->FaultTbl[i];
+        SMTPc_TransportMock_FaultCmdCtrTbl[i] = 0u;
+    }
+    CPU_CRITICAL_EXIT();
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportMock_StatsGet()
+*
+* Description : Get the statistics of the server.
+*
+* Argument(s) : p_stats         Pointer to the structure that will receive the statistics (see
+*                               'smtp-c_transport_mock.h  DATA TYPES  Notes #3 & #4').
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The counters & the latency histogram are copied in a critical section, so that the
+*                   statistics are consistent; the percentiles are computed from the copy.
+*********************************************************************************************************
+*/
+
+void  SMTPc_TransportMock_StatsGet (SMTPc_TRANSPORT_MOCK_STATS  *p_stats)
+{
+    CPU_INT32U  hist_tbl[SMTPc_TRANSPORT_MOCK_LAT_HIST_NBR];
+    CPU_INT64U  lat_sum;
+    CPU_INT32U  lat_max;
+    CPU_INT32U  msg_ctr;
+    CPU_INT32U  recov_ctr;
+    CPU_INT64U  recov_sum;
+    CPU_TS64    stats_ts;
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    p_stats->ConnCtr  = SMTPc_TransportMock_ConnCtr;
+    p_stats->RcptCtr  = SMTPc_TransportMock_RcptCtr;
+    p_stats->OctetCtr = SMTPc_TransportMock_OctetCtr;
+    p_stats->FaultCtr    = SMTPc_TransportMock_FaultCtr;
+    p_stats->RecovMax_ms = SMTPc_TransportMock_RecovMax;
+    recov_ctr            = SMTPc_TransportMock_RecovCtr;
+    recov_sum            = SMTPc_TransportMock_RecovSum;
+    msg_ctr              = SMTPc_TransportMock_MsgCtr;
+    lat_sum              = SMTPc_TransportMock_LatSum;
+    lat_max              = SMTPc_TransportMock_LatMax;
+    stats_ts             = SMTPc_TransportMock_StatsTS;
+    Mem_Copy(hist_tbl, SMTPc_TransportMock_LatHistTbl, sizeof(hist_tbl));
+    CPU_CRITICAL_EXIT();
+
+    p_stats->Elapsed_us  = CPU_TS64_to_uSec(CPU_TS_Get64() - stats_ts);
+    p_stats->RecovCtr    = recov_ctr;
+    p_stats->RecovAvg_ms = (recov_ctr > 0u) ? (CPU_INT32U)(recov_sum / recov_ctr) : 0u;
+
+    p_stats->MsgCtr = msg_ctr;
+    if (msg_ctr == 0u) {
+        p_stats->LatAvg_us  = 0u;
+        p_stats->LatP50_us  = 0u;
+        p_stats->LatP99_us  = 0u;
+        p_stats->LatP999_us = 0u;
+        p_stats->LatMax_us  = 0u;
+        return;
+    }
+
+    p_stats->LatAvg_us  = (CPU_INT32U)(lat_sum / msg_ctr);
+    p_stats->LatP50_us  =  SMTPc_TransportMock_LatPctGet(hist_tbl, msg_ctr, 500u, lat_max);
+    p_stats->LatP99_us  =  SMTPc_TransportMock_LatPctGet(hist_tbl, msg_ctr, 990u, lat_max);
+    p_stats->LatP999_us =  SMTPc_TransportMock_LatPctGet(hist_tbl, msg_ctr, 999u, lat_max);
+    p_stats->LatMax_us  =  lat_max;
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportMock_StatsClr()
+*
+* Description : Clear the statistics of the server.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application,
+*               SMTPc_TransportMock_Init().
+*
+* Note(s)     : (1) The messages whose final reply is not received yet are still accounted, once it is.
+*********************************************************************************************************
+*/
+
+void  SMTPc_TransportMock_StatsClr (void)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_CRITICAL_ENTER();
+    SMTPc_TransportMock_ConnCtr   = 0u;
+    SMTPc_TransportMock_MsgCtr    = 0u;
+    SMTPc_TransportMock_RcptCtr   = 0u;
+    SMTPc_TransportMock_OctetCtr  = 0u;
+    SMTPc_TransportMock_FaultCtr  = 0u;
+    SMTPc_TransportMock_LatSum    = 0u;
+    SMTPc_TransportMock_LatMax    = 0u;
+    Mem_Clr(SMTPc_TransportMock_LatHistTbl, sizeof(SMTPc_TransportMock_LatHistTbl));
+    SMTPc_TransportMock_RecovPend = DEF_NO;
+    SMTPc_TransportMock_RecovCtr  = 0u;
+    SMTPc_TransportMock_RecovSum  = 0u;
+    SMTPc_TransportMock_RecovMax  = 0u;
+    SMTPc_TransportMock_StatsTS   = CPU_TS_Get64();
+    CPU_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportMock_Open()
+*
+* Description : Open a connection to the server & queue its greeting.
+*
+* Argument(s) : p_host_name     Pointer to host name of the server (unused, see 'smtp-c_transport_mock.h
+*                               Note #1').
+*
+*               port            TCP port of the server (unused).
+*
+*               p_secure_cfg    Pointer to the secure configuration, MUST be DEF_NULL.
+*
+*               timeout_ms      Time to wait for the connection (unused, see Note #1).
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, connection established.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          Secure configuration passed.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          No free connection, or fault
+*                                                                       injected.
+*
+* Return(s)   : Index of the connection, if NO error.
+*
+*               SMTPc_SOCK_ID_NONE,        otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Mock.
+*
+* Note(s)     : (1) The connection is established at once, even without blocking.
+*
+*               (2) A fault injected on SMTPc_TRANSPORT_MOCK_CMD_CONN may delay or split the greeting,
+*                   replace it, or refuse the connection.
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID  SMTPc_TransportMock_Open (CPU_CHAR                 *p_host_name,
+                                                 CPU_INT16U                port,
+                                                 SMTPc_SECURE_CFG         *p_secure_cfg,
+                                                 CPU_INT32U                timeout_ms,
+                                                 SMTPc_ERR                *p_err)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_conn;
+    SMTPc_TRANSPORT_MOCK_CFG    cfg;
+    CPU_BOOLEAN                 fail;
+    CPU_INT16U                  rep_code;
+    CPU_SR_ALLOC();
+
+
+   (void)&p_host_name;
+   (void)&port;
+   (void)&timeout_ms;                                           /* See Note #1.                                         */
+
+    if (p_secure_cfg != DEF_NULL) {
+       *p_err = SMTPc_ERR_SECURE_NOT_AVAIL;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+    if (SMTPc_TransportMock_InitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+                                                                /* --------------------- GET CONN --------------------- */
+    CPU_CRITICAL_ENTER();
+    p_conn = SMTPc_TransportMock_ConnFreePtr;
+    if (p_conn != (SMTPc_TRANSPORT_MOCK_CONN *)0) {
+        SMTPc_TransportMock_ConnFreePtr = p_conn->NextPtr;
+    }
+    cfg = SMTPc_TransportMock_Cfg;
+    CPU_CRITICAL_EXIT();
+
+    if (p_conn == (SMTPc_TRANSPORT_MOCK_CONN *)0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    p_conn->Used        = DEF_YES;
+    p_conn->Closed      = DEF_NO;
+    p_conn->State       = SMTPc_TRANSPORT_MOCK_STATE_CMD;
+    p_conn->TimeoutMs   = SMTPc_TRANSPORT_TIMEOUT_INFINITE;
+    p_conn->LineLen     = 0u;
+    p_conn->EomIx       = 0u;
+    p_conn->InTrans     = DEF_NO;
+    p_conn->RcptNbr     = 0u;
+    p_conn->RepRdIx     = 0u;
+    p_conn->RepWrIx     = 0u;
+    p_conn->RepTS       = SMTPc_TransportMock_TS_Get_ms();
+    p_conn->RepDlyMs    = cfg.RepDlyMs;
+    p_conn->RepSegLen   = 0u;
+    p_conn->LatPend     = DEF_NO;
+                                                                /* ------------------- QUEUE GREETING ----------------- */
+    fail = SMTPc_TransportMock_SrvFaultChk(p_conn, SMTPc_TRANSPORT_MOCK_CMD_CONN, &rep_code);
+    if (fail == DEF_YES) {                                      /* See Note #2.                                         */
+        SMTPc_TransportMock_SrvFail(p_conn, rep_code, &cfg);
+    } else {
+        SMTPc_TransportMock_RepAdd(p_conn,
+                                   SMTPc_REP_220,
+                                  ' ',
+                                   DEF_NULL,
+                                   SMTPc_TRANSPORT_MOCK_DOMAIN " ESMTP ready",
+                                  &cfg);
+    }
+
+    if ((p_conn->Closed  == DEF_YES) &&
+        (p_conn->RepWrIx == 0u)) {
+        SMTPc_TransportMock_Close((SMTPc_SOCK_ID)(p_conn - SMTPc_TransportMock_ConnTbl), 0u);
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    CPU_CRITICAL_ENTER();
+    SMTPc_TransportMock_ConnCtr++;
+    CPU_CRITICAL_EXIT();
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return ((SMTPc_SOCK_ID)(p_conn - SMTPc_TransportMock_ConnTbl));
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportMock_Tx()
+*
+* Description : Transmit data to the server.
+*
+* Argument(s) : sock_id         Connection to transmit on.
+*
+*               p_data          Pointer to the data to transmit.
+*
+*               len             Length of the data.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data transmitted.
+*                               SMTPc_ERR_TX_FAILED                 Connection closed or invalid.
+*
+* Return(s)   : Number of octets transmitted, if NO error.
+*
+*               0,                            otherwise.
+*
+* Caller(s)   : SMTPc_AsyncTx(), through SMTPc_TransportAPI_Mock.
+*
+* Note(s)     : (1) The data is always transmitted in full : the server executes the commands it completes
+*                   (see 'smtp-c_transport_mock.c  Note #1').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportMock_Tx (SMTPc_SOCK_ID  sock_id,
+                                            const  void   *p_data,
+                                            CPU_INT32U     len,
+                                            SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_VEC  vec;
+
+
+    vec.DataPtr = p_data;
+    vec.Len     = len;
+
+    return (SMTPc_TransportMock_TxV(sock_id, &vec, 1u, p_err));
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportMock_TxV()
+*
+* Description : Transmit several buffers to the server, in order.
+*
+* Argument(s) : sock_id         Connection to transmit on.
+*
+*               p_vec           Pointer to the table of buffers.
+*
+*               vec_nbr         Number of buffers.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data transmitted.
+*                               SMTPc_ERR_TX_FAILED                 Connection closed or invalid.
+*
+* Return(s)   : Number of octets transmitted, if NO error.
+*
+*               0,                            otherwise.
+*
+* Caller(s)   : SMTPc_TxSockV(),
+*               SMTPc_TransportMock_Tx().
+*
+* Note(s)     : (1) The configuration is read once per transmission (see 'smtp-c_transport_mock.c
+*                   Note #2').
+*
+*               (2) The data following a command that closed the connection is discarded.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportMock_TxV (SMTPc_SOCK_ID                sock_id,
+                                             const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                             CPU_INT08U                   vec_nbr,
+                                             SMTPc_ERR                   *p_err)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_conn;
+    SMTPc_TRANSPORT_MOCK_CFG    cfg;
+    CPU_INT32U                  len;
+    CPU_INT08U                  i;
+    CPU_SR_ALLOC();
+
+
+    p_conn = SMTPc_TransportMock_ConnGet(sock_id);
+    if ((p_conn         == (SMTPc_TRANSPORT_MOCK_CONN *)0) ||
+        (p_conn->Closed == DEF_YES)) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return (0u);
+    }
+
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    cfg = SMTPc_TransportMock_Cfg;
+    CPU_CRITICAL_EXIT();
+
+    len = 0u;
+    for (i = 0u; i < vec_nbr; i++) {
+        if (p_conn->Closed == DEF_NO) {                         /* See Note #2.                                         */
+            SMTPc_TransportMock_SrvRx(p_conn, (const CPU_INT08U *)p_vec[i].DataPtr, p_vec[i].Len, &cfg);
+        }
+        len += p_vec[i].Len;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportMock_Rx()
+*
+* Description : Receive the replies of the server.
+*
+* Argument(s) : sock_id         Connection to receive from.
+*
+*               p_buf           Pointer to the buffer that will receive the data.
+*
+*               len             Size of the buffer.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data received.
+*                               SMTPc_ERR_WOULD_BLOCK               No reply available yet.
+*                               SMTPc_ERR_RX_FAILED                 Connection closed or invalid.
+*
+* Return(s)   : Number of octets received, if NO error.
+*
+*               0,                         otherwise.
+*
+* Caller(s)   : SMTPc_RxReply(), through SMTPc_TransportAPI_Mock.
+*
+* Note(s)     : (1) The replies queued are available once the delay of the last one elapsed.  A blocking
+*                   reception waits for them, at most for the deadline of the connection (see
+*                   'smtp-c_transport_mock.c  Note #3').
+*
+*               (2) No reply can be queued while the client waits, since the server runs in its task : a
+*                   blocking reception without reply queued times out, or fails if it has no deadline.
+*
+*               (3) The latency of a message is accounted when its final reply is received in full.
+*
+*               (4) The replies may be received by segments (see 'smtp-c_transport_mock.h  DATA TYPES
+*                   Note #2b'), until all the replies queued are.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportMock_Rx (SMTPc_SOCK_ID  sock_id,
+                                            void          *p_buf,
+                                            CPU_INT32U     len,
+                                            SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_conn;
+    SMTPc_TS_MS                 ts_start;
+    SMTPc_TS_MS                 elapsed;
+    CPU_INT32U                  dly;
+    CPU_INT32U                  wait;
+
+
+    p_conn = SMTPc_TransportMock_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_MOCK_CONN *)0) {
+       *p_err = SMTPc_ERR_RX_FAILED;
+        return (0u);
+    }
+                                                                /* ------------------ WAIT FOR REPLY ------------------ */
+    if (p_conn->RepRdIx == p_conn->RepWrIx) {                   /* See Note #2.                                         */
+        if (p_conn->Closed == DEF_YES) {
+           *p_err = SMTPc_ERR_RX_FAILED;
+        } else if (p_conn->TimeoutMs == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+        } else if (p_conn->TimeoutMs == SMTPc_TRANSPORT_TIMEOUT_INFINITE) {
+           *p_err = SMTPc_ERR_RX_FAILED;
+        } else {
+            SMTPc_TransportMock_Dly(p_conn->TimeoutMs);
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+        }
+        return (0u);
+    }
+
+    ts_start = SMTPc_TransportMock_TS_Get_ms();
+    for (;;) {                                                  /* See Note #1.                                         */
+        elapsed = (SMTPc_TS_MS)(SMTPc_TransportMock_TS_Get_ms() - p_conn->RepTS);
+        if (elapsed >= p_conn->RepDlyMs) {
+            break;
+        }
+        if (p_conn->TimeoutMs == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+            return (0u);
+        }
+
+        dly = p_conn->RepDlyMs - elapsed;
+        if (p_conn->TimeoutMs != SMTPc_TRANSPORT_TIMEOUT_INFINITE) {
+            wait = (SMTPc_TS_MS)(SMTPc_TransportMock_TS_Get_ms() - ts_start);
+            if (wait >= p_conn->TimeoutMs) {
+               *p_err = SMTPc_ERR_WOULD_BLOCK;
+                return (0u);
+            }
+            dly = DEF_MIN(dly, p_conn->TimeoutMs - wait);
+        }
+        SMTPc_TransportMock_Dly(dly);
+    }
+                                                                /* ------------------- COPY REPLIES ------------------- */
+    len = DEF_MIN(len, p_conn->RepWrIx - p_conn->RepRdIx);
+    if (p_conn->RepSegLen > 0u) {                               /* See Note #4.                                         */
+        len = DEF_MIN(len, p_conn->RepSegLen);
+    }
+    Mem_Copy(p_buf, &p_conn->RepBuf[p_conn->RepRdIx], len);
+    p_conn->RepRdIx += len;
+
+    if ((p_conn->LatPend == DEF_YES) &&                         /* See Note #3.                                         */
+        (p_conn->RepRdIx >= p_conn->LatIx)) {
+        SMTPc_TransportMock_LatRec(p_conn);
+    }
+    if (p_conn->RepRdIx == p_conn->RepWrIx) {
+        p_conn->RepRdIx   = 0u;
+        p_conn->RepWrIx   = 0u;
+        p_conn->RepSegLen = 0u;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportMock_Close()
+*
+* Description : Close a connection.
+*
+* Argument(s) : sock_id         Connection to close.
+*
+*               timeout_ms      Time to wait for the connection to be closed (unused).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various, through SMTPc_TransportAPI_Mock.
+*
+* Note(s)     : (1) The latency of a message whose final reply was not received is not accounted.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_Close (SMTPc_SOCK_ID  sock_id,
+                                         CPU_INT32U     timeout_ms)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_conn;
+    CPU_SR_ALLOC();
+
+
+   (void)&timeout_ms;
+
+    p_conn = SMTPc_TransportMock_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_MOCK_CONN *)0) {
+        return;
+    }
+
+    p_conn->Used    = DEF_NO;                                   /* See Note #1.                                         */
+    p_conn->LatPend = DEF_NO;
+
+    CPU_CRITICAL_ENTER();
+    p_conn->NextPtr                 = SMTPc_TransportMock_ConnFreePtr;
+    SMTPc_TransportMock_ConnFreePtr = p_conn;
+    CPU_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                  SMTPc_TransportMock_DeadlineSet()
+*
+* Description : Set how long the receptions of a connection wait at most.
+*
+* Argument(s) : sock_id         Connection to configure.
+*
+*               timeout_ms      SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, SMTPc_TRANSPORT_TIMEOUT_INFINITE, or time
+*                               to wait on each reception, in milliseconds.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, connection configured.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Invalid connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Mock.
+*
+* Note(s)     : (1) Transmissions never wait (see 'SMTPc_TransportMock_Tx()  Note #1').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_DeadlineSet (SMTPc_SOCK_ID  sock_id,
+                                               CPU_INT32U     timeout_ms,
+                                               SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_conn;
+
+
+    p_conn = SMTPc_TransportMock_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_MOCK_CONN *)0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+
+    p_conn->TimeoutMs = timeout_ms;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                 SMTPc_TransportMock_LocalAddrGet()
+*
+* Description : Get the local IP address of a connection, as a string.
+*
+* Argument(s) : sock_id         Connection to get the address of.
+*
+*               p_addr          Pointer to the buffer that will receive the address, of at least
+*                               SMTPc_TRANSPORT_ADDR_LEN characters.
+*
+*               p_family        Pointer to the variable that will receive the address family.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, address returned.
+*                               SMTPc_ERR_TX_FAILED                 Invalid connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_BuildHELO(), through SMTPc_TransportAPI_Mock.
+*
+* Note(s)     : (1) Every connection is local to the host.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_LocalAddrGet (SMTPc_SOCK_ID  sock_id,
+                                                CPU_CHAR      *p_addr,
+                                                CPU_INT08U    *p_family,
+                                                SMTPc_ERR     *p_err)
+{
+    if (SMTPc_TransportMock_ConnGet(sock_id) == (SMTPc_TRANSPORT_MOCK_CONN *)0) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+    (void)Str_Copy(p_addr, SMTPc_TRANSPORT_MOCK_ADDR);          /* See Note #1.                                         */
+   *p_family = SMTPc_TRANSPORT_FAMILY_IPv4;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportMock_TS_Get_ms()
+*
+* Description : Get the timestamp of the server, in milliseconds.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Timestamp, in milliseconds.
+*
+* Caller(s)   : SMTPc_TS_Get_ms(), through SMTPc_TransportAPI_Mock,
+*               SMTPc_TransportMock_Open(),
+*               SMTPc_TransportMock_Rx(),
+*               SMTPc_TransportMock_SrvEOM(),
+*               SMTPc_TransportMock_SrvDlySet(),
+*               SMTPc_TransportMock_SrvFaultChk(),
+*               SMTPc_TransportMock_Dly().
+*
+* Note(s)     : (1) The timestamp is derived from the 64-bit CPU timestamp, which does not wrap during the
+*                   run of a test, & is truncated to SMTPc_TS_MS : it wraps like a uC/TCP-IP timestamp, &
+*                   the differences of timestamps are computed modulo its size.
+*********************************************************************************************************
+*/
+
+static  SMTPc_TS_MS  SMTPc_TransportMock_TS_Get_ms (void)
+{
+    CPU_INT64U  ts_us;
+
+
+    ts_us = CPU_TS64_to_uSec(CPU_TS_Get64());                   /* See Note #1.                                         */
+
+    return ((SMTPc_TS_MS)(ts_us / 1000u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportMock_Dly()
+*
+* Description : Delay the task of the client.
+*
+* Argument(s) : dly_ms          Delay, in milliseconds.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_Rx().
+*
+* Note(s)     : (1) The delay polls the timestamp of the server (see 'smtp-c_transport_mock.c  Note #3') :
+*                   the mock serves tests & benchmarks, & must run on a host without a kernel port.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_Dly (CPU_INT32U  dly_ms)
+{
+    SMTPc_TS_MS  ts_start;
+
+
+    ts_start = SMTPc_TransportMock_TS_Get_ms();
+    while ((SMTPc_TS_MS)(SMTPc_TransportMock_TS_Get_ms() - ts_start) < dly_ms) {
+        ;                                                       /* See Note #1.                                         */
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportMock_ConnGet()
+*
+* Description : Get the open connection of a socket identifier.
+*
+* Argument(s) : sock_id         Socket identifier.
+*
+* Return(s)   : Pointer to the connection, if open.
+*
+*               Pointer to NULL,           otherwise.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  SMTPc_TRANSPORT_MOCK_CONN  *SMTPc_TransportMock_ConnGet (SMTPc_SOCK_ID  sock_id)
+{
+    SMTPc_TRANSPORT_MOCK_CONN  *p_conn;
+
+
+    if ((SMTPc_TransportMock_InitDone != DEF_YES) ||
+        (sock_id                      <  0)       ||
+        ((CPU_INT32U)sock_id          >= SMTPc_TransportMock_ConnNbrMax)) {
+        return ((SMTPc_TRANSPORT_MOCK_CONN *)0);
+    }
+
+    p_conn = &SMTPc_TransportMock_ConnTbl[sock_id];
+    if (p_conn->Used != DEF_YES) {
+        return ((SMTPc_TRANSPORT_MOCK_CONN *)0);
+    }
+
+    return (p_conn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportMock_SrvRx()
+*
+* Description : Process the data received by the server : command lines, message content & BDAT chunks.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               p_data          Pointer to the data received.
+*
+*               len             Length of the data.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_TxV().
+*
+* Note(s)     : (1) The content of DATA ends with "<CRLF>.<CRLF>", the CRLF preceding DATA counting as the
+*                   first one.  On a mismatch, a CR may start the sequence again.
+*
+*               (2) The octets of the end sequence, but its first CRLF, are not counted in the content.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_SrvRx (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                         const  CPU_INT08U                *p_data,
+                                         CPU_INT32U                        len,
+                                         const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    CPU_INT32U  ix;
+    CPU_INT32U  n;
+    CPU_INT08U  c;
+
+
+    ix = 0u;
+    while ((ix             <  len) &&
+           (p_conn->Closed == DEF_NO)) {
+        switch (p_conn->State) {
+            case SMTPc_TRANSPORT_MOCK_STATE_CMD:
+                 c = p_data[ix];
+                 ix++;
+                 if (p_conn->LineLen < (SMTPc_TRANSPORT_MOCK_LINE_LEN - 1u)) {
+                     p_conn->LineBuf[p_conn->LineLen] = (CPU_CHAR)c;
+                     p_conn->LineLen++;
+                 }
+                 if (c == ASCII_CHAR_LINE_FEED) {
+                     p_conn->LineBuf[p_conn->LineLen] = '\0';
+                     SMTPc_TransportMock_SrvCmd(p_conn, p_cfg);
+                     p_conn->LineLen = 0u;
+                 }
+                 break;
+
+
+            case SMTPc_TRANSPORT_MOCK_STATE_DATA:               /* See Note #1.                                         */
+                 c = p_data[ix];
+                 ix++;
+                 p_conn->MsgLen++;
+                 if (c == (CPU_INT08U)SMTPc_EOM[p_conn->EomIx]) {
+                     p_conn->EomIx++;
+                     if (p_conn->EomIx == SMTPc_TRANSPORT_MOCK_EOM_LEN) {
+                         p_conn->MsgLen -= SMTPc_TRANSPORT_MOCK_EOM_LEN - SMTPc_CRLF_SIZE;
+                         p_conn->State   = SMTPc_TRANSPORT_MOCK_STATE_CMD;
+                         SMTPc_TransportMock_SrvEOM(p_conn, p_cfg);
+                     }
+                 } else {
+                     p_conn->EomIx = (c == ASCII_CHAR_CARRIAGE_RETURN) ? 1u : 0u;
+                 }
+                 break;
+
+
+            case SMTPc_TRANSPORT_MOCK_STATE_BDAT:
+                 n                = DEF_MIN(len - ix, p_conn->BdatLen);
+                 ix              += n;
+                 p_conn->BdatLen -= n;
+                 p_conn->MsgLen  += n;
+                 if (p_conn->BdatLen > 0u) {
+                     break;
+                 }
+
+                 p_conn->State = SMTPc_TRANSPORT_MOCK_STATE_CMD;
+                 if (p_conn->BdatRepCode != 0u) {               /* Chunk refused when its cmd was rx'd.                 */
+                     if (p_conn->BdatLast == DEF_YES) {
+                         p_conn->InTrans = DEF_NO;
+                         p_conn->RcptNbr = 0u;
+                     }
+                     SMTPc_TransportMock_RepAdd(p_conn, p_conn->BdatRepCode, ' ', DEF_NULL, "Chunk refused", p_cfg);
+                     if (p_conn->BdatRepCode == SMTPc_REP_421) {
+                         p_conn->Closed = DEF_YES;
+                     }
+                 } else if (p_conn->BdatLast == DEF_YES) {
+                     SMTPc_TransportMock_SrvEOM(p_conn, p_cfg);
+                 } else {
+                     SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', "2.0.0", "Chunk received", p_cfg);
+                 }
+                 break;
+
+
+            default:
+                 p_conn->Closed = DEF_YES;
+                 break;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportMock_SrvCmd()
+*
+* Description : Execute the command line received by the server.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_SrvRx().
+*
+* Note(s)     : (1) The delay of the replies counts from the last command received (see
+*                   'SMTPc_TransportMock_SrvDlySet()').
+*
+*               (2) The chunk of a BDAT command is received even if the command fails : its reply is queued
+*                   once the chunk is received.
+*
+*               (3) The parameters of MAIL & RCPT are not checked.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_SrvCmd (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                          const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    const  CPU_CHAR  *p_line;
+    CPU_CHAR         *p_end;
+    CPU_INT08U        cmd;
+    CPU_INT08U        i;
+    CPU_BOOLEAN       fail;
+    CPU_INT16U        rep_code;
+
+
+    SMTPc_TransportMock_SrvDlySet(p_conn, p_cfg);               /* See Note #1.                                         */
+                                                                /* -------------------- PARSE CMD --------------------- */
+    p_line = p_conn->LineBuf;
+    cmd    = SMTPc_TRANSPORT_MOCK_CMD_NONE;
+    for (i = 0u; i < (sizeof(SMTPc_TransportMock_CmdTbl) / sizeof(SMTPc_TransportMock_CmdTbl[0])); i++) {
+        if ((Str_CmpIgnoreCase_N(p_line, SMTPc_TransportMock_CmdTbl[i].StrPtr, 4u) == 0) &&
+            ((p_line[4] == ' ')                        ||
+             (p_line[4] == ASCII_CHAR_CARRIAGE_RETURN) ||
+             (p_line[4] == ASCII_CHAR_LINE_FEED))) {
+            cmd = SMTPc_TransportMock_CmdTbl[i].Cmd;
+            break;
+        }
+    }
+
+    if (cmd == SMTPc_TRANSPORT_MOCK_CMD_BDAT) {                 /* See Note #2.                                         */
+        p_conn->BdatLen     = Str_ParseNbr_Int32U(&p_line[5], &p_end, DEF_NBR_BASE_DEC);
+        p_conn->BdatLast    = (Str_CmpIgnoreCase_N(p_end, " LAST", 5u) == 0) ? DEF_YES : DEF_NO;
+        p_conn->BdatRepCode = 0u;
+        p_conn->State       = SMTPc_TRANSPORT_MOCK_STATE_BDAT;
+        if (p_conn->BdatLast == DEF_YES) {
+            cmd = SMTPc_TRANSPORT_MOCK_CMD_EOM;
+        }
+        if (p_conn->RcptNbr == 0u) {
+            p_conn->BdatRepCode = SMTPc_REP_503;
+        }
+    }
+                                                                /* ------------------- INJECT FAULT ------------------- */
+    fail = SMTPc_TransportMock_SrvFaultChk(p_conn, cmd, &rep_code);
+    if (fail == DEF_YES) {
+        if ((p_conn->State == SMTPc_TRANSPORT_MOCK_STATE_BDAT) &&
+            (rep_code      != 0u)) {
+            p_conn->BdatRepCode = rep_code;
+        } else {
+            SMTPc_TransportMock_SrvFail(p_conn, rep_code, p_cfg);
+        }
+        return;
+    }
+                                                                /* -------------------- EXEC CMD ---------------------- */
+    switch (cmd) {
+        case SMTPc_TRANSPORT_MOCK_CMD_EHLO:
+             SMTPc_TransportMock_SrvEHLO(p_conn, p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_HELO:
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', DEF_NULL, SMTPc_TRANSPORT_MOCK_DOMAIN, p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_AUTH:
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_235, ' ', "2.7.0", "Authentication successful", p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_MAIL:                     /* See Note #3.                                         */
+             if (p_conn->InTrans == DEF_YES) {
+                 SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_503, ' ', "5.5.1", "Nested MAIL command", p_cfg);
+                 break;
+             }
+             p_conn->InTrans = DEF_YES;
+             p_conn->TransTS = CPU_TS_Get64();
+             p_conn->RcptNbr = 0u;
+             p_conn->MsgLen  = 0u;
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', "2.1.0", "Ok", p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_RCPT:
+             if (p_conn->InTrans == DEF_NO) {
+                 SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_503, ' ', "5.5.1", "Need MAIL command", p_cfg);
+                 break;
+             }
+             p_conn->RcptNbr++;
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', "2.1.5", "Ok", p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_DATA:
+             if (p_conn->RcptNbr == 0u) {
+                 SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_503, ' ', "5.5.1", "Need RCPT command", p_cfg);
+                 break;
+             }
+             p_conn->State  = SMTPc_TRANSPORT_MOCK_STATE_DATA;
+             p_conn->EomIx  = SMTPc_CRLF_SIZE;                  /* See 'SMTPc_TransportMock_SrvRx()  Note #1'.          */
+             p_conn->MsgLen = 0u;
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_354, ' ', DEF_NULL, "End data with <CR><LF>.<CR><LF>", p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_BDAT:                     /* Reply queued at end of chunk.                        */
+        case SMTPc_TRANSPORT_MOCK_CMD_EOM:
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_RSET:
+             p_conn->InTrans = DEF_NO;
+             p_conn->RcptNbr = 0u;
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', "2.0.0", "Ok", p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_NOOP:
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', "2.0.0", "Ok", p_cfg);
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_QUIT:
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_221, ' ', "2.0.0", "Bye", p_cfg);
+             p_conn->Closed = DEF_YES;
+             break;
+
+
+        case SMTPc_TRANSPORT_MOCK_CMD_NONE:
+        default:
+             SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_500, ' ', "5.5.2", "Command unrecognized", p_cfg);
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportMock_SrvEHLO()
+*
+* Description : Reply to EHLO with the extensions of the configuration.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_SrvCmd().
+*
+* Note(s)     : (1) A null maximum size is advertised without value : the size is not limited.
+*
+*               (2) EHLO resets the transaction, like RSET.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_SrvEHLO (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                           const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    const  CPU_CHAR  *ext_tbl[SMTPc_TRANSPORT_MOCK_EXT_NBR_MAX];
+    CPU_CHAR          size_str[SMTPc_TRANSPORT_MOCK_SIZE_LEN];
+    CPU_INT08U        ext_nbr;
+    CPU_INT08U        i;
+
+
+    ext_nbr = 0u;
+    if (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_PIPELINING) == DEF_YES) {
+        ext_tbl[ext_nbr++] = SMTPc_EXT_PIPELINING;
+    }
+    if (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_SIZE) == DEF_YES) {
+        (void)Str_Copy(size_str, SMTPc_EXT_SIZE);
+        if (p_cfg->SizeMax > 0u) {                              /* See Note #1.                                         */
+            (void)Str_Cat(size_str, " ");
+            (void)Str_FmtNbr_Int32U(p_cfg->SizeMax,
+                                    DEF_INT_32U_NBR_DIG_MAX,
+                                    DEF_NBR_BASE_DEC,
+                                    '\0',
+                                    DEF_NO,
+                                    DEF_YES,
+                                   &size_str[sizeof(SMTPc_EXT_SIZE)]);
+        }
+        ext_tbl[ext_nbr++] = size_str;
+    }
+    if (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_8BITMIME) == DEF_YES) {
+        ext_tbl[ext_nbr++] = SMTPc_EXT_8BITMIME;
+    }
+    if (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_CHUNKING) == DEF_YES) {
+        ext_tbl[ext_nbr++] = SMTPc_EXT_CHUNKING;
+    }
+    if (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_ENHSTATUS) == DEF_YES) {
+        ext_tbl[ext_nbr++] = SMTPc_EXT_ENHSTATUS;
+    }
+    if (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_AUTH) == DEF_YES) {
+        ext_tbl[ext_nbr++] = SMTPc_EXT_AUTH " " SMTPc_CMD_AUTH_MECHANISM_PLAIN;
+    }
+
+    p_conn->InTrans = DEF_NO;                                   /* See Note #2.                                         */
+    p_conn->RcptNbr = 0u;
+
+    SMTPc_TransportMock_RepAdd(p_conn,
+                               SMTPc_REP_250,
+                              (ext_nbr > 0u) ? '-' : ' ',
+                               DEF_NULL,
+                               SMTPc_TRANSPORT_MOCK_DOMAIN,
+                               p_cfg);
+    for (i = 0u; i < ext_nbr; i++) {
+        SMTPc_TransportMock_RepAdd(p_conn,
+                                   SMTPc_REP_250,
+                                  (i + 1u < ext_nbr) ? '-' : ' ',
+                                   DEF_NULL,
+                                   ext_tbl[i],
+                                   p_cfg);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportMock_SrvEOM()
+*
+* Description : Accept or refuse the message whose content was received, & end its transaction.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_SrvRx().
+*
+* Note(s)     : (1) A fault injected on SMTPc_TRANSPORT_MOCK_CMD_EOM after DATA is applied here, once the
+*                   content is received; after BDAT, it is applied when the last command is received.
+*
+*               (2) A message is accounted when accepted; its latency once the client received the reply
+*                   (see 'SMTPc_TransportMock_Rx()  Note #3').  The latency of the previous message of the
+*                   connection, if its reply is still not received, is accounted now.
+*
+*               (3) A message accepted ends the recovery from the faults injected before (see
+*                   'smtp-c_transport_mock.h  DATA TYPES  Note #4').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_SrvEOM (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                          const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    CPU_BOOLEAN  fail;
+    CPU_INT16U   rep_code;
+    SMTPc_TS_MS  recov_ms;
+    CPU_SR_ALLOC();
+
+
+    p_conn->InTrans = DEF_NO;
+    if (p_conn->EomIx == SMTPc_TRANSPORT_MOCK_EOM_LEN) {        /* See Note #1.                                         */
+        p_conn->EomIx = 0u;
+        SMTPc_TransportMock_SrvDlySet(p_conn, p_cfg);
+        fail = SMTPc_TransportMock_SrvFaultChk(p_conn, SMTPc_TRANSPORT_MOCK_CMD_EOM, &rep_code);
+        if (fail == DEF_YES) {
+            SMTPc_TransportMock_SrvFail(p_conn, rep_code, p_cfg);
+            p_conn->RcptNbr = 0u;
+            return;
+        }
+    }
+
+    if ((DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_SIZE) == DEF_YES) &&
+        (p_cfg->SizeMax                                  >  0u)     &&
+        (p_conn->MsgLen                                  >  p_cfg->SizeMax)) {
+        SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_552, ' ', "5.3.4", "Message size exceeds limit", p_cfg);
+        p_conn->RcptNbr = 0u;
+        return;
+    }
+                                                                /* See Note #2.                                         */
+    if (p_conn->LatPend == DEF_YES) {
+        SMTPc_TransportMock_LatRec(p_conn);
+    }
+    SMTPc_TransportMock_RepAdd(p_conn, SMTPc_REP_250, ' ', "2.0.0", "Ok: queued", p_cfg);
+    if (p_conn->Closed == DEF_YES) {
+        return;
+    }
+    p_conn->LatPend = DEF_YES;
+    p_conn->LatIx   = p_conn->RepWrIx;
+
+    CPU_CRITICAL_ENTER();
+    SMTPc_TransportMock_MsgCtr++;
+    SMTPc_TransportMock_RcptCtr  += p_conn->RcptNbr;
+    SMTPc_TransportMock_OctetCtr += p_conn->MsgLen;
+    if (SMTPc_TransportMock_RecovPend == DEF_YES) {             /* See Note #3.                                         */
+        recov_ms                      = (SMTPc_TS_MS)(SMTPc_TransportMock_TS_Get_ms() - SMTPc_TransportMock_RecovTS);
+        SMTPc_TransportMock_RecovPend = DEF_NO;
+        SMTPc_TransportMock_RecovCtr++;
+        SMTPc_TransportMock_RecovSum += recov_ms;
+        SMTPc_TransportMock_RecovMax  = DEF_MAX(SMTPc_TransportMock_RecovMax, recov_ms);
+    }
+    CPU_CRITICAL_EXIT();
+
+    p_conn->RcptNbr = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportMock_SrvDlySet()
+*
+* Description : Set the delay of the replies to a command received.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_SrvCmd(),
+*               SMTPc_TransportMock_SrvEOM().
+*
+* Note(s)     : (1) The replies queued are all available at once (see 'SMTPc_TransportMock_Rx()  Note #1') :
+*                   the delay counts from now, but the replies still queued are not made available earlier
+*                   than they were, e.g. when a fault delayed one of them (see 'smtp-c_transport_mock.h
+*                   DATA TYPES  Note #2a').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_SrvDlySet (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                             const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    SMTPc_TS_MS  ts;
+    SMTPc_TS_MS  elapsed;
+    CPU_INT32U   dly_left;
+
+
+    ts       = SMTPc_TransportMock_TS_Get_ms();
+    dly_left = 0u;
+    if (p_conn->RepRdIx != p_conn->RepWrIx) {                   /* See Note #1.                                         */
+        elapsed = (SMTPc_TS_MS)(ts - p_conn->RepTS);
+        if (elapsed < p_conn->RepDlyMs) {
+            dly_left = p_conn->RepDlyMs - elapsed;
+        }
+    }
+
+    p_conn->RepTS    = ts;
+    p_conn->RepDlyMs = DEF_MAX(p_cfg->RepDlyMs, dly_left);
+}
+
+
+/*
+*********************************************************************************************************
+*                                  SMTPc_TransportMock_SrvFaultChk()
+*
+* Description : Inject the faults of the configuration on a command.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               cmd             Command received (SMTPc_TRANSPORT_MOCK_CMD_xxx).
+*
+*               p_rep_code      Pointer to variable that will receive the reply code replacing the
+*                               command, or 0 to drop the connection.
+*
+* Return(s)   : DEF_YES, if the command MUST NOT be executed (see 'smtp-c_transport_mock.h  DATA TYPES
+*                        Notes #2c & #2d').
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_TransportMock_Open(),
+*               SMTPc_TransportMock_SrvCmd(),
+*               SMTPc_TransportMock_SrvEOM().
+*
+* Note(s)     : (1) The occurrences of the commands are counted over all the connections.  A command
+*                   faulted by several entries of the configuration counts as a single fault.
+*
+*               (2) The delays & segment lengths of the faults apply to the connection at once : they
+*                   affect the replies queued, including the one to the command (see
+*                   'smtp-c_transport_mock.h  DATA TYPES  Notes #2a & #2b').
+*
+*               (3) The first fault injected after a message was accepted starts the recovery (see
+*                   'smtp-c_transport_mock.h  DATA TYPES  Note #4').
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_TransportMock_SrvFaultChk (SMTPc_TRANSPORT_MOCK_CONN  *p_conn,
+                                                      CPU_INT08U                  cmd,
+                                                      CPU_INT16U                 *p_rep_code)
+{
+    SMTPc_TRANSPORT_MOCK_FAULT  *p_fault;
+    CPU_BOOLEAN                  fault;
+    CPU_BOOLEAN                  skip;
+    CPU_INT08U                   i;
+    CPU_SR_ALLOC();
+
+
+   *p_rep_code = 0u;
+    if (cmd == SMTPc_TRANSPORT_MOCK_CMD_NONE) {
+        return (DEF_NO);
+    }
+
+    fault = DEF_NO;
+    skip  = DEF_NO;
+    CPU_CRITICAL_ENTER();                                       /* See Note #1.                                         */
+    for (i = 0u; i < SMTPc_TransportMock_Cfg.FaultNbr; i++) {
+        p_fault = &SMTPc_TransportMock_FaultTbl[i];
+        if (((p_fault->Cmd != cmd) &&
+             (p_fault->Cmd != SMTPc_TRANSPORT_MOCK_CMD_ANY)) ||
+            (p_fault->Period == 0u)) {
+            continue;
+        }
+
+        SMTPc_TransportMock_FaultCmdCtrTbl[i]++;
+        if (SMTPc_TransportMock_FaultCmdCtrTbl[i] < p_fault->Period) {
+            continue;
+        }
+        SMTPc_TransportMock_FaultCmdCtrTbl[i] = 0u;
+        fault                                 = DEF_YES;
+                                                                /* See Note #2.                                         */
+        if (p_fault->DlyMs > DEF_INT_32U_MAX_VAL - p_conn->RepDlyMs) {
+            p_conn->RepDlyMs  = DEF_INT_32U_MAX_VAL;
+        } else {
+            p_conn->RepDlyMs += p_fault->DlyMs;
+        }
+        if ((p_fault->SegLen > 0u) &&
+            ((p_conn->RepSegLen == 0u) ||
+             (p_conn->RepSegLen >  p_fault->SegLen))) {
+            p_conn->RepSegLen = p_fault->SegLen;
+        }
+        if ((skip == DEF_NO) &&
+            ((p_fault->RepCode != 0u) ||
+             (p_fault->Drop    == DEF_YES))) {
+            skip       = DEF_YES;
+           *p_rep_code = (p_fault->Drop == DEF_YES) ? 0u : p_fault->RepCode;
+        }
+    }
+
+    if (fault == DEF_YES) {
+        SMTPc_TransportMock_FaultCtr++;
+        if (SMTPc_TransportMock_RecovPend == DEF_NO) {          /* See Note #3.                                         */
+            SMTPc_TransportMock_RecovPend = DEF_YES;
+            SMTPc_TransportMock_RecovTS   = SMTPc_TransportMock_TS_Get_ms();
+        }
+    }
+    CPU_CRITICAL_EXIT();
+
+    return (skip);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportMock_SrvFail()
+*
+* Description : Answer a command with an injected fault.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               rep_code        Reply code of the fault, or 0 to drop the connection.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_Open(),
+*               SMTPc_TransportMock_SrvCmd(),
+*               SMTPc_TransportMock_SrvEOM().
+*
+* Note(s)     : (1) The replies already queued can still be received once the connection is closed; the
+*                   receptions fail afterwards, like on a connection closed by a real server.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_SrvFail (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                           CPU_INT16U                        rep_code,
+                                           const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    if (rep_code != 0u) {
+        SMTPc_TransportMock_RepAdd(p_conn, rep_code, ' ', DEF_NULL, "Mock failure", p_cfg);
+    }
+    if ((rep_code == 0u) ||                                     /* See Note #1.                                         */
+        (rep_code == SMTPc_REP_421)) {
+        p_conn->Closed = DEF_YES;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportMock_RepAdd()
+*
+* Description : Queue a reply line.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               rep_code        Reply code.
+*
+*               sep             Separator following the code : '-' if more lines follow, ' ' otherwise.
+*
+*               p_enh           Pointer to the enhanced status code, or DEF_NULL (see Note #1).
+*
+*               p_text          Pointer to the text of the reply.
+*
+*               p_cfg           Pointer to the configuration of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) The enhanced status code is only sent if advertised (see RFC #2034, section 3).
+*
+*               (2) Replies that are not received are not kept without limit : the reply buffer is
+*                   compacted, & the connection dropped if it is still full.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_RepAdd (SMTPc_TRANSPORT_MOCK_CONN        *p_conn,
+                                          CPU_INT16U                        rep_code,
+                                          CPU_CHAR                          sep,
+                                          const  CPU_CHAR                  *p_enh,
+                                          const  CPU_CHAR                  *p_text,
+                                          const  SMTPc_TRANSPORT_MOCK_CFG  *p_cfg)
+{
+    CPU_SIZE_T   enh_len;
+    CPU_SIZE_T   text_len;
+    CPU_SIZE_T   rep_len;
+    CPU_INT08U  *p_rep;
+
+
+    enh_len = 0u;                                               /* See Note #1.                                         */
+    if ((p_enh                                              != DEF_NULL) &&
+        (DEF_BIT_IS_SET(p_cfg->CapFlags, SMTPc_CAP_ENHSTATUS) == DEF_YES)) {
+        enh_len = Str_Len(p_enh) + 1u;
+    }
+    text_len = Str_Len(p_text);
+    rep_len  = 4u + enh_len + text_len + SMTPc_CRLF_SIZE;       /* "250-" + "2.0.0 " + text + CRLF.                     */
+
+    if (p_conn->RepWrIx + rep_len > SMTPc_TRANSPORT_MOCK_REP_BUF_LEN) {
+        if (p_conn->RepRdIx > 0u) {                             /* See Note #2.                                         */
+            Mem_Move(&p_conn->RepBuf[0],
+                     &p_conn->RepBuf[p_conn->RepRdIx],
+                      p_conn->RepWrIx - p_conn->RepRdIx);
+            p_conn->RepWrIx -= p_conn->RepRdIx;
+            p_conn->LatIx   -= DEF_MIN(p_conn->LatIx, p_conn->RepRdIx);
+            p_conn->RepRdIx  = 0u;
+        }
+        if (p_conn->RepWrIx + rep_len > SMTPc_TRANSPORT_MOCK_REP_BUF_LEN) {
+            p_conn->Closed = DEF_YES;
+            return;
+        }
+    }
+
+    p_rep    = &p_conn->RepBuf[p_conn->RepWrIx];
+    p_rep[0] = (CPU_INT08U)('0' + ((rep_code / 100u) % 10u));
+    p_rep[1] = (CPU_INT08U)('0' + ((rep_code /  10u) % 10u));
+    p_rep[2] = (CPU_INT08U)('0' +  (rep_code         % 10u));
+    p_rep[3] = (CPU_INT08U)sep;
+    p_rep   += 4u;
+    if (enh_len > 0u) {
+        Mem_Copy(p_rep, p_enh, enh_len - 1u);
+        p_rep[enh_len - 1u] = (CPU_INT08U)' ';
+        p_rep += enh_len;
+    }
+    Mem_Copy(p_rep, p_text, text_len);
+    p_rep   += text_len;
+    p_rep[0] = (CPU_INT08U)ASCII_CHAR_CARRIAGE_RETURN;
+    p_rep[1] = (CPU_INT08U)ASCII_CHAR_LINE_FEED;
+
+    p_conn->RepWrIx += (CPU_INT32U)rep_len;
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportMock_LatRec()
+*
+* Description : Account the latency of the last message accepted on a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportMock_Rx(),
+*               SMTPc_TransportMock_SrvEOM().
+*
+* Note(s)     : (1) The latency is taken from the 64-bit CPU timestamp, which does not wrap, & limited to
+*                   DEF_INT_32U_MAX_VAL microseconds (see 'smtp-c_transport_mock.h  DATA TYPES  Note #3').
+*
+*               (2) The latencies below 2 * SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR have a bucket each.  Above,
+*                   the latencies of 'n' significant bits are split in SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR
+*                   buckets, by their SMTPc_TRANSPORT_MOCK_LAT_SUB_BIT_NBR bits after the most significant
+*                   one.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportMock_LatRec (SMTPc_TRANSPORT_MOCK_CONN  *p_conn)
+{
+    CPU_INT64U  lat_us;
+    CPU_INT32U  lat;
+    CPU_INT32U  hist_ix;
+    CPU_INT08U  shift;
+    CPU_SR_ALLOC();
+
+
+    p_conn->LatPend = DEF_NO;
+    lat_us          = CPU_TS64_to_uSec(CPU_TS_Get64() - p_conn->TransTS);
+    lat             = (CPU_INT32U)DEF_MIN(lat_us, DEF_INT_32U_MAX_VAL);
+                                                                /* See Note #2.                                         */
+    if (lat < (2u * SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR)) {
+        hist_ix = lat;
+    } else {
+        shift   = (CPU_INT08U)((31u - CPU_CntLeadZeros32(lat)) - SMTPc_TRANSPORT_MOCK_LAT_SUB_BIT_NBR);
+        hist_ix = (SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR * shift) + (lat >> shift);
+    }
+
+    CPU_CRITICAL_ENTER();
+    SMTPc_TransportMock_LatHistTbl[hist_ix]++;
+    SMTPc_TransportMock_LatSum += lat;
+    if (lat > SMTPc_TransportMock_LatMax) {
+        SMTPc_TransportMock_LatMax = lat;
+    }
+    CPU_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportMock_LatPctGet()
+*
+* Description : Get a percentile of the latencies from their histogram.
+*
+* Argument(s) : p_hist_tbl      Pointer to the histogram.
+*
+*               msg_ctr         Number of latencies, MUST be non-null.
+*
+*               per_mille       Percentile, in thousandths.
+*
+*               lat_max         Maximum latency.
+*
+* Return(s)   : Percentile of the latencies, in microseconds.
+*
+* Caller(s)   : SMTPc_TransportMock_StatsGet().
+*
+* Note(s)     : (1) The percentile is the upper bound of the histogram bucket holding the message of rank
+*                   ceil(per_mille * msg_ctr / 1000), limited to the maximum latency (see
+*                   'SMTPc_TransportMock_LatRec()  Note #2').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportMock_LatPctGet (const  CPU_INT32U  *p_hist_tbl,
+                                                   CPU_INT32U          msg_ctr,
+                                                   CPU_INT32U          per_mille,
+                                                   CPU_INT32U          lat_max)
+{
+    CPU_INT64U  lat;
+    CPU_INT32U  rank;
+    CPU_INT32U  cnt;
+    CPU_INT32U  i;
+    CPU_INT08U  shift;
+
+
+    rank = (CPU_INT32U)(((CPU_INT64U)msg_ctr * per_mille + 999u) / 1000u);
+    cnt  = 0u;
+    i    = 0u;
+    while (i < (SMTPc_TRANSPORT_MOCK_LAT_HIST_NBR - 1u)) {
+        cnt += p_hist_tbl[i];
+        if (cnt >= rank) {
+            break;
+        }
+        i++;
+    }
+                                                                /* See Note #1.                                         */
+    if (i < (2u * SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR)) {
+        lat = i;
+    } else {
+        shift = (CPU_INT08U)((i / SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR) - 1u);
+        lat   = ((CPU_INT64U)(i - (SMTPc_TRANSPORT_MOCK_LAT_SUB_NBR * shift) + 1u) << shift) - 1u;
+    }
+
+    return ((CPU_INT32U)DEF_MIN(lat, lat_max));
+}
@@ -0,0 +1,232 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                 uC/SMTPc TRANSPORT : IN-PROCESS MOCK SERVER
+*
+* Filename : smtp-c_transport_mock.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Transport (see 'smtp-c.h  SMTPc_TRANSPORT_API') connecting the sessions to an SMTP server
+*                emulated in memory, so that the cost of the client can be measured without network :
+*
+*                    SMTPc_TransportMock_Init(16u, &err);
+*                    SMTPc_TransportMock_CfgSet(&cfg, &err);
+*                    SMTPc_TransportSet(&SMTPc_TransportAPI_Mock, &err);
+*
+*                The host name & port passed to the client are ignored : every connection reaches the
+*                mock server.
+*
+*            (2) The server implements EHLO/HELO, AUTH (accepted at once), MAIL, RCPT, DATA, BDAT, RSET,
+*                NOOP & QUIT.  It advertises the extensions of its configuration (see 'DATA TYPES
+*                Note #1'); the message content is counted & discarded.  Faults such as slow greetings,
+*                replies split in single octets, 421 replies or dropped connections are injected from a
+*                script (see 'DATA TYPES  Note #2').
+*
+*            (3) The statistics (see 'DATA TYPES  Notes #3 & #4') are those of the server : the messages it
+*                accepted, the time from the MAIL command of each to the reading of its final reply by
+*                the client, & the time the client took to deliver a message again after a fault.
+*
+*            (4) The socket identifiers are indexes of connections, not descriptors : the transport cannot
+*                be used by the epoll reactor (see 'Reactor/Epoll/smtp-c_reactor_epoll.h  Note #2'), but the
+*                jobs of the asynchronous engine may be run by SMTPc_Poll() alone.
+*
+*            (5) TLS is not supported : connecting with a secure configuration fails.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  SMTPc_TRANSPORT_MOCK_MODULE_PRESENT
+#define  SMTPc_TRANSPORT_MOCK_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+
+#include  <Source/smtp-c.h>
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*
+* Note(s) : (1) Commands of the server a fault may be injected on (see 'DATA TYPES  Note #2').
+*               SMTPc_TRANSPORT_MOCK_CMD_CONN is the opening of the connection & its greeting;
+*               SMTPc_TRANSPORT_MOCK_CMD_EOM the end of the message content, by "." or BDAT LAST;
+*               SMTPc_TRANSPORT_MOCK_CMD_ANY any of them.
+*
+*           (2) Maximum number of faults of the configuration.
+*********************************************************************************************************
+*/
+
+                                                                /* See Note #1.                                         */
+#define  SMTPc_TRANSPORT_MOCK_CMD_NONE                     0u
+#define  SMTPc_TRANSPORT_MOCK_CMD_CONN                     1u
+#define  SMTPc_TRANSPORT_MOCK_CMD_EHLO                     2u
+#define  SMTPc_TRANSPORT_MOCK_CMD_HELO                     3u
+#define  SMTPc_TRANSPORT_MOCK_CMD_AUTH                     4u
+#define  SMTPc_TRANSPORT_MOCK_CMD_MAIL                     5u
+#define  SMTPc_TRANSPORT_MOCK_CMD_RCPT                     6u
+#define  SMTPc_TRANSPORT_MOCK_CMD_DATA                     7u
+#define  SMTPc_TRANSPORT_MOCK_CMD_BDAT                     8u
+#define  SMTPc_TRANSPORT_MOCK_CMD_EOM                      9u
+#define  SMTPc_TRANSPORT_MOCK_CMD_RSET                    10u
+#define  SMTPc_TRANSPORT_MOCK_CMD_NOOP                    11u
+#define  SMTPc_TRANSPORT_MOCK_CMD_QUIT                    12u
+#define  SMTPc_TRANSPORT_MOCK_CMD_ANY                     13u
+
+#define  SMTPc_TRANSPORT_MOCK_FAULT_NBR_MAX                8u   /* See Note #2.                                         */
+
+
+/*
+*********************************************************************************************************
+*                                             DATA TYPES
+*
+* Note(s) : (1) Configuration of the server, applied from the next reply on :
+*
+*               (a) 'CapFlags' are the extensions advertised in the reply to EHLO (SMTPc_CAP_PIPELINING,
+*                   SMTPc_CAP_SIZE, SMTPc_CAP_8BITMIME, SMTPc_CAP_CHUNKING, SMTPc_CAP_AUTH &
+*                   SMTPc_CAP_ENHSTATUS; STARTTLS is never advertised).  With SMTPc_CAP_SIZE, 'SizeMax' is
+*                   the limit advertised & enforced on the message content, 0 for none.
+*
+*               (b) Each reply is available to the client 'RepDlyMs' milliseconds after the command it
+*                   answers was received.
+*
+*               (c) 'FaultTbl' is the script of the faults injected, of 'FaultNbr' entries (see Note #2).
+*                   The table is copied.
+*
+*           (2) A fault applies to every 'Period'-th occurrence of command 'Cmd' (SMTPc_TRANSPORT_MOCK_CMD_xxx),
+*               counted over all the connections.  When several faults apply to a command, their delays
+*               add up, & the first reply code or drop applies :
+*
+*               (a) The reply is delayed by 'DlyMs' more milliseconds; DEF_INT_32U_MAX_VAL never replies.
+*
+*               (b) The replies queued are received at most 'SegLen' octets at a time, until all are
+*                   received; 0 does not split them.
+*
+*               (c) With 'RepCode' other than 0, the command is answered with that reply code instead of
+*                   being executed.  A 421 reply closes the connection.
+*
+*               (d) With 'Drop', the connection is dropped instead of answering the command.  The replies
+*                   already queued are still received.
+*
+*           (3) The latencies are measured with the 64-bit CPU timestamp, in microseconds, & counted in a
+*               histogram of 32 linear buckets per power of 2 : a percentile is the upper bound of the
+*               bucket holding it, limited to the maximum latency, at most 1/32 (about 3%) above the exact
+*               value.  Latencies over DEF_INT_32U_MAX_VAL microseconds (about 71 minutes) are counted as
+*               such.  'Elapsed_us' is the time since the statistics were cleared, from which rates such as
+*               octets per second are derived.
+*
+*           (4) The recovery time is the time from the first fault injected after a message was accepted
+*               until the next message is accepted, on any connection.
+*********************************************************************************************************
+*/
+
+typedef  struct  smtpc_transport_mock_fault {                   /* See Note #2.                                         */
+    CPU_INT08U                          Cmd;                    /* Cmd faulted ...                                      */
+    CPU_INT32U                          Period;                 /* ... once every 'Period' occurrences.                 */
+    CPU_INT32U                          DlyMs;                  /* Additional dly of the reply (see Note #2a).          */
+    CPU_INT16U                          SegLen;                 /* Max len rx'd at once (see Note #2b).                 */
+    CPU_INT16U                          RepCode;                /* Reply code replacing the cmd (see Note #2c).         */
+    CPU_BOOLEAN                         Drop;                   /* Conn dropped (see Note #2d).                         */
+} SMTPc_TRANSPORT_MOCK_FAULT;
+
+
+typedef  struct  smtpc_transport_mock_cfg {                     /* See Note #1.                                         */
+    SMTPc_CAP_FLAGS                     CapFlags;               /* Extensions advertised (see Note #1a).                */
+    CPU_INT32U                          SizeMax;                /* Max msg size advertised.                             */
+    CPU_INT32U                          RepDlyMs;               /* Dly of each reply (see Note #1b).                    */
+    const  SMTPc_TRANSPORT_MOCK_FAULT  *FaultTbl;               /* Faults injected (see Note #1c).                      */
+    CPU_INT08U                          FaultNbr;
+} SMTPc_TRANSPORT_MOCK_CFG;
+
+
+typedef  struct  smtpc_transport_mock_stats {                   /* See Notes #3 & #4.                                   */
+    CPU_INT32U       ConnCtr;                                   /* Nbr of conns opened.                                 */
+    CPU_INT32U       MsgCtr;                                    /* Nbr of msgs accepted ...                             */
+    CPU_INT32U       RcptCtr;                                   /* ... their nbr of rcpts ...                           */
+    CPU_INT64U       OctetCtr;                                  /* ... & of content octets.                             */
+    CPU_INT32U       FaultCtr;                                  /* Nbr of faults injected.                              */
+    CPU_INT32U       LatAvg_us;                                 /* Avg                latency of the msgs (us).         */
+    CPU_INT32U       LatP50_us;                                 /* Median             latency of the msgs (us).         */
+    CPU_INT32U       LatP99_us;                                 /* 99th   percentile  latency of the msgs (us).         */
+    CPU_INT32U       LatP999_us;                                /* 99.9th percentile  latency of the msgs (us).         */
+    CPU_INT32U       LatMax_us;                                 /* Max                latency of the msgs (us).         */
+    CPU_INT32U       RecovCtr;                                  /* Nbr of recoveries from faults ...                    */
+    CPU_INT32U       RecovAvg_ms;                               /* ... their avg time (ms) ...                          */
+    CPU_INT32U       RecovMax_ms;                               /* ... & max time (ms).                                 */
+    CPU_INT64U       Elapsed_us;                                /* Time since the stats were cleared (us).              */
+} SMTPc_TRANSPORT_MOCK_STATS;
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+extern  const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Mock;    /* Transport fncts (see Note #1).                       */
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  SMTPc_TransportMock_Init    (CPU_INT32U                         conn_nbr_max,
+                                   SMTPc_ERR                         *p_err);
+
+void  SMTPc_TransportMock_CfgSet  (const  SMTPc_TRANSPORT_MOCK_CFG   *p_cfg,
+                                   SMTPc_ERR                         *p_err);
+
+void  SMTPc_TransportMock_StatsGet(SMTPc_TRANSPORT_MOCK_STATS        *p_stats);
+
+void  SMTPc_TransportMock_StatsClr(void);
+
+
+/*
+*********************************************************************************************************
+*                                        CONFIGURATION ERRORS
+*********************************************************************************************************
+*/
+
+#if    ((CPU_CFG_TS_64_EN  != DEF_ENABLED) || \
+        (CPU_CFG_TS_TMR_EN != DEF_ENABLED))
+#error  "CPU_CFG_TS_64_EN/CPU_CFG_TS_TMR_EN illegally #define'd in 'cpu_cfg.h' [MUST be DEF_ENABLED for the mock transport]"
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of smtp-c transport mock module include.         */
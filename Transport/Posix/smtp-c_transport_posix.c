@@ -0,0 +1,739 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                   uC/SMTPc TRANSPORT : POSIX SOCKETS
+*
+* Filename : smtp-c_transport_posix.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) A socket is blocking unless SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK was set as its deadline.  A
+*                blocking send or receive that times out returns SMTPc_ERR_WOULD_BLOCK, like a
+*                non-blocking one that could not proceed.
+*
+*            (2) The transport functions hold no state : they may be called concurrently, on different
+*                sockets.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#ifndef  _POSIX_C_SOURCE
+#define  _POSIX_C_SOURCE                              200809L   /* getaddrinfo(), poll() & MSG_NOSIGNAL.                */
+#endif
+
+#define  MICRIUM_SOURCE
+#define  SMTPc_TRANSPORT_POSIX_MODULE
+
+#include  "smtp-c_transport_posix.h"
+
+#include  <arpa/inet.h>
+#include  <errno.h>
+#include  <fcntl.h>
+#include  <limits.h>
+#include  <netdb.h>
+#include  <netinet/in.h>
+#include  <netinet/tcp.h>
+#include  <poll.h>
+#include  <stdio.h>
+#include  <string.h>
+#include  <sys/socket.h>
+#include  <sys/time.h>
+#include  <sys/uio.h>
+#include  <time.h>
+#include  <unistd.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  SMTPc_TRANSPORT_POSIX_PORT_LEN                    6u   /* "65535".                                             */
+#define  SMTPc_TRANSPORT_POSIX_VEC_NBR_MAX                 8u   /* Max nbr of bufs per sendmsg().                       */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID  SMTPc_TransportPosix_Open        (CPU_CHAR                    *p_host_name,
+                                                         CPU_INT16U                   port,
+                                                         SMTPc_SECURE_CFG            *p_secure_cfg,
+                                                         CPU_INT32U                   timeout_ms,
+                                                         SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U     SMTPc_TransportPosix_Tx          (SMTPc_SOCK_ID                sock_id,
+                                                         const  void                 *p_data,
+                                                         CPU_INT32U                   len,
+                                                         SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U     SMTPc_TransportPosix_TxV         (SMTPc_SOCK_ID                sock_id,
+                                                         const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                                         CPU_INT08U                   vec_nbr,
+                                                         SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U     SMTPc_TransportPosix_Rx          (SMTPc_SOCK_ID                sock_id,
+                                                         void                        *p_buf,
+                                                         CPU_INT32U                   len,
+                                                         SMTPc_ERR                   *p_err);
+
+static  void           SMTPc_TransportPosix_Close       (SMTPc_SOCK_ID                sock_id,
+                                                         CPU_INT32U                   timeout_ms);
+
+static  void           SMTPc_TransportPosix_DeadlineSet (SMTPc_SOCK_ID                sock_id,
+                                                         CPU_INT32U                   timeout_ms,
+                                                         SMTPc_ERR                   *p_err);
+
+static  void           SMTPc_TransportPosix_LocalAddrGet(SMTPc_SOCK_ID                sock_id,
+                                                         CPU_CHAR                    *p_addr,
+                                                         CPU_INT08U                  *p_family,
+                                                         SMTPc_ERR                   *p_err);
+
+static  SMTPc_TS_MS    SMTPc_TransportPosix_TS_Get_ms   (void);
+
+static  int            SMTPc_TransportPosix_Conn        (const  struct  addrinfo     *p_ai,
+                                                         CPU_INT32U                   timeout_ms);
+
+static  SMTPc_ERR      SMTPc_TransportPosix_ErrGet      (SMTPc_ERR                    err_fail);
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Posix = {
+    SMTPc_TransportPosix_Open,
+    SMTPc_TransportPosix_Tx,
+    SMTPc_TransportPosix_TxV,
+    SMTPc_TransportPosix_Rx,
+    SMTPc_TransportPosix_Close,
+    SMTPc_TransportPosix_DeadlineSet,
+    SMTPc_TransportPosix_LocalAddrGet,
+    SMTPc_TransportPosix_TS_Get_ms
+};
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportPosix_Open()
+*
+* Description : Open a TCP connection to a server.
+*
+* Argument(s) : p_host_name     Pointer to host name or IP address of the server.
+*
+*               port            TCP port of the server.
+*
+*               p_secure_cfg    Pointer to the secure configuration, MUST be DEF_NULL (see
+*                               'smtp-c_transport_posix.h  Note #3').
+*
+*               timeout_ms      Time to wait for the server to accept the connection, in milliseconds, or
+*                               SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK (see Note #3).
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, connection established.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          Secure configuration passed.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Error resolving or connecting to server.
+*
+* Return(s)   : Descriptor of the socket, if NO error.
+*
+*               SMTPc_SOCK_ID_NONE,         otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : (1) Each address the host name resolves to is tried in turn, each with the full timeout.
+*
+*               (2) Commands are already gathered into segments by the client : Nagle's algorithm would
+*                   only delay them.
+*
+*               (3) With SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, the socket is returned non-blocking as soon as
+*                   the connection is initiated (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #1a').  Only the
+*                   addresses the connection fails to be initiated to are skipped.
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID  SMTPc_TransportPosix_Open (CPU_CHAR                 *p_host_name,
+                                                  CPU_INT16U                port,
+                                                  SMTPc_SECURE_CFG         *p_secure_cfg,
+                                                  CPU_INT32U                timeout_ms,
+                                                  SMTPc_ERR                *p_err)
+{
+    struct  addrinfo   hints;
+    struct  addrinfo  *p_ai_list;
+    struct  addrinfo  *p_ai;
+    char               port_str[SMTPc_TRANSPORT_POSIX_PORT_LEN];
+    int                fd;
+    int                opt;
+
+
+    if (p_secure_cfg != DEF_NULL) {
+       *p_err = SMTPc_ERR_SECURE_NOT_AVAIL;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+                                                                /* ------------------ RESOLVE HOST -------------------- */
+    (void)snprintf(port_str, sizeof(port_str), "%u", (unsigned)port);
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = AI_NUMERICSERV;
+
+    if (getaddrinfo((const char *)p_host_name, port_str, &hints, &p_ai_list) != 0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+                                                                /* ------------------- CONN TO HOST ------------------- */
+    fd = -1;
+    for (p_ai = p_ai_list; p_ai != DEF_NULL; p_ai = p_ai->ai_next) {
+        fd = SMTPc_TransportPosix_Conn(p_ai, timeout_ms);       /* See Note #1.                                         */
+        if (fd >= 0) {
+            break;
+        }
+    }
+    freeaddrinfo(p_ai_list);
+
+    if (fd < 0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+                                                                /* See 'smtp-c_transport_posix.h  Note #2'.             */
+    if (((int)(SMTPc_SOCK_ID)fd    != fd) ||
+        ((SMTPc_SOCK_ID)fd == SMTPc_SOCK_ID_NONE)) {
+        (void)close(fd);
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    opt = 1;                                                    /* See Note #2.                                         */
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return ((SMTPc_SOCK_ID)fd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportPosix_Tx()
+*
+* Description : Send data on a socket.
+*
+* Argument(s) : sock_id         Socket to send on.
+*
+*               p_data          Pointer to the data to send.
+*
+*               len             Length of the data.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data (partially) sent.
+*                               SMTPc_ERR_WOULD_BLOCK               Nothing could be sent (see Note #1).
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : Number of octets sent, if NO error.
+*
+*               0,                     otherwise.
+*
+* Caller(s)   : SMTPc_AsyncTx(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : (1) See 'smtp-c_transport_posix.c  Note #1'.
+*
+*               (2) A connection reset by the server MUST NOT raise SIGPIPE.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportPosix_Tx (SMTPc_SOCK_ID  sock_id,
+                                             const  void   *p_data,
+                                             CPU_INT32U     len,
+                                             SMTPc_ERR     *p_err)
+{
+    ssize_t  rtn;
+
+
+    do {
+        rtn = send((int)sock_id, p_data, len, MSG_NOSIGNAL);    /* See Note #2.                                         */
+    } while ((rtn < 0) && (errno == EINTR));
+
+    if (rtn < 0) {
+       *p_err = SMTPc_TransportPosix_ErrGet(SMTPc_ERR_TX_FAILED);
+        return (0u);
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return ((CPU_INT32U)rtn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportPosix_TxV()
+*
+* Description : Send several buffers on a socket, in order, in a single system call.
+*
+* Argument(s) : sock_id         Socket to send on.
+*
+*               p_vec           Pointer to the table of buffers.
+*
+*               vec_nbr         Number of buffers.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data (partially) sent.
+*                               SMTPc_ERR_WOULD_BLOCK               Nothing could be sent.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : Number of octets sent, if NO error.
+*
+*               0,                     otherwise.
+*
+* Caller(s)   : SMTPc_TxSockV(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : (1) Only the first SMTPc_TRANSPORT_POSIX_VEC_NBR_MAX buffers are sent : the caller sends the
+*                   rest on the next call, like after any partial send.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportPosix_TxV (SMTPc_SOCK_ID                sock_id,
+                                              const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                              CPU_INT08U                   vec_nbr,
+                                              SMTPc_ERR                   *p_err)
+{
+    struct  iovec   iov[SMTPc_TRANSPORT_POSIX_VEC_NBR_MAX];
+    struct  msghdr  msg;
+    CPU_INT08U      i;
+    ssize_t         rtn;
+
+
+                                                                /* See Note #1.                                         */
+    vec_nbr = DEF_MIN(vec_nbr, SMTPc_TRANSPORT_POSIX_VEC_NBR_MAX);
+    for (i = 0u; i < vec_nbr; i++) {
+        iov[i].iov_base = (void *)p_vec[i].DataPtr;
+        iov[i].iov_len  = p_vec[i].Len;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = vec_nbr;
+
+    do {
+        rtn = sendmsg((int)sock_id, &msg, MSG_NOSIGNAL);
+    } while ((rtn < 0) && (errno == EINTR));
+
+    if (rtn < 0) {
+       *p_err = SMTPc_TransportPosix_ErrGet(SMTPc_ERR_TX_FAILED);
+        return (0u);
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return ((CPU_INT32U)rtn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportPosix_Rx()
+*
+* Description : Receive data from a socket.
+*
+* Argument(s) : sock_id         Socket to receive from.
+*
+*               p_buf           Pointer to the buffer that will receive the data.
+*
+*               len             Size of the buffer.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data received.
+*                               SMTPc_ERR_WOULD_BLOCK               No data available yet.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving, or connection closed.
+*
+* Return(s)   : Number of octets received, if NO error.
+*
+*               0,                         otherwise.
+*
+* Caller(s)   : SMTPc_RxReply(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : (1) recv() returns 0 once the server closed the connection.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportPosix_Rx (SMTPc_SOCK_ID  sock_id,
+                                             void          *p_buf,
+                                             CPU_INT32U     len,
+                                             SMTPc_ERR     *p_err)
+{
+    ssize_t  rtn;
+
+
+    do {
+        rtn = recv((int)sock_id, p_buf, len, 0);
+    } while ((rtn < 0) && (errno == EINTR));
+
+    if (rtn == 0) {                                             /* See Note #1.                                         */
+       *p_err = SMTPc_ERR_RX_FAILED;
+        return (0u);
+    }
+    if (rtn < 0) {
+       *p_err = SMTPc_TransportPosix_ErrGet(SMTPc_ERR_RX_FAILED);
+        return (0u);
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return ((CPU_INT32U)rtn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportPosix_Close()
+*
+* Description : Close a socket.
+*
+* Argument(s) : sock_id         Socket to close.
+*
+*               timeout_ms      Time to wait for the connection to be closed (unused, see Note #1).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various, through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : (1) The system completes the close of the connection in the background : close() does not
+*                   wait.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportPosix_Close (SMTPc_SOCK_ID  sock_id,
+                                          CPU_INT32U     timeout_ms)
+{
+   (void)&timeout_ms;                                           /* See Note #1.                                         */
+
+    (void)close((int)sock_id);
+}
+
+
+/*
+*********************************************************************************************************
+*                                  SMTPc_TransportPosix_DeadlineSet()
+*
+* Description : Configure the blocking mode & the timeouts of a socket.
+*
+* Argument(s) : sock_id         Socket to configure.
+*
+*               timeout_ms      SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, SMTPc_TRANSPORT_TIMEOUT_INFINITE, or time
+*                               to wait on each receive & transmit, in milliseconds.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, socket configured.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Error configuring the socket.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : (1) A null timeout disables the timeouts of a blocking socket.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportPosix_DeadlineSet (SMTPc_SOCK_ID  sock_id,
+                                                CPU_INT32U     timeout_ms,
+                                                SMTPc_ERR     *p_err)
+{
+    struct  timeval  tv;
+    int              flags;
+    int              rtn;
+
+
+    flags = fcntl((int)sock_id, F_GETFL);
+    if (flags < 0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+
+    if (timeout_ms == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+        rtn = fcntl((int)sock_id, F_SETFL, flags |  O_NONBLOCK);
+    } else {
+        rtn = fcntl((int)sock_id, F_SETFL, flags & ~O_NONBLOCK);
+        if (rtn == 0) {
+            if (timeout_ms == SMTPc_TRANSPORT_TIMEOUT_INFINITE) {
+                tv.tv_sec  = 0;                                 /* See Note #1.                                         */
+                tv.tv_usec = 0;
+            } else {
+                tv.tv_sec  = (time_t)(timeout_ms / 1000u);
+                tv.tv_usec = (suseconds_t)((timeout_ms % 1000u) * 1000u);
+            }
+            rtn = setsockopt((int)sock_id, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            if (rtn == 0) {
+                rtn = setsockopt((int)sock_id, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+            }
+        }
+    }
+
+    if (rtn != 0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                 SMTPc_TransportPosix_LocalAddrGet()
+*
+* Description : Get the local IP address of a connected socket, as a string.
+*
+* Argument(s) : sock_id         Socket to get the address of.
+*
+*               p_addr          Pointer to the buffer that will receive the address, of at least
+*                               SMTPc_TRANSPORT_ADDR_LEN characters.
+*
+*               p_family        Pointer to the variable that will receive the address family.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, address returned.
+*                               SMTPc_ERR_TX_FAILED                 Error getting or formatting the address.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_BuildHELO(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportPosix_LocalAddrGet (SMTPc_SOCK_ID  sock_id,
+                                                 CPU_CHAR      *p_addr,
+                                                 CPU_INT08U    *p_family,
+                                                 SMTPc_ERR     *p_err)
+{
+    struct  sockaddr_storage  addr;
+    socklen_t                 addr_len;
+    const  char              *p_str;
+
+
+    addr_len = sizeof(addr);
+    if (getsockname((int)sock_id, (struct sockaddr *)&addr, &addr_len) != 0) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+    switch (addr.ss_family) {
+        case AF_INET:
+             p_str = inet_ntop(AF_INET,
+                              &((struct sockaddr_in *)&addr)->sin_addr,
+                               (char *)p_addr,
+                               SMTPc_TRANSPORT_ADDR_LEN);
+            *p_family = SMTPc_TRANSPORT_FAMILY_IPv4;
+             break;
+
+        case AF_INET6:
+             p_str = inet_ntop(AF_INET6,
+                              &((struct sockaddr_in6 *)&addr)->sin6_addr,
+                               (char *)p_addr,
+                               SMTPc_TRANSPORT_ADDR_LEN);
+            *p_family = SMTPc_TRANSPORT_FAMILY_IPv6;
+             break;
+
+        default:
+             p_str = DEF_NULL;
+             break;
+    }
+
+    if (p_str == DEF_NULL) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportPosix_TS_Get_ms()
+*
+* Description : Get the time of the monotonic clock (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #1h').
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in milliseconds.
+*
+* Caller(s)   : SMTPc_TS_Get_ms(), through SMTPc_TransportAPI_Posix.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  SMTPc_TS_MS  SMTPc_TransportPosix_TS_Get_ms (void)
+{
+    struct  timespec  ts;
+
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((SMTPc_TS_MS)(((CPU_INT64U)ts.tv_sec * 1000u) + ((CPU_INT64U)ts.tv_nsec / 1000000u)));
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportPosix_Conn()
+*
+* Description : Connect a new socket to an address, within a timeout.
+*
+* Argument(s) : p_ai            Pointer to the address.
+*
+*               timeout_ms      Time to wait for the server to accept the connection, in milliseconds, or
+*                               SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK.
+*
+* Return(s)   : Descriptor of the connected socket, if NO error.
+*
+*               -1,                             otherwise.
+*
+* Caller(s)   : SMTPc_TransportPosix_Open().
+*
+* Note(s)     : (1) The socket is made non-blocking so that the connection can be waited for with a
+*                   timeout, then blocking again (see 'smtp-c_transport_posix.c  Note #1').
+*
+*               (2) Without timeout, the socket is left non-blocking & the connection in progress (see
+*                   'SMTPc_TransportPosix_Open()  Note #3').
+*********************************************************************************************************
+*/
+
+static  int  SMTPc_TransportPosix_Conn (const  struct  addrinfo  *p_ai,
+                                        CPU_INT32U                timeout_ms)
+{
+    struct  pollfd  pfd;
+    socklen_t       opt_len;
+    int             fd;
+    int             flags;
+    int             timeout;
+    int             rtn;
+    int             err;
+
+
+    fd = socket(p_ai->ai_family, p_ai->ai_socktype, p_ai->ai_protocol);
+    if (fd < 0) {
+        return (-1);
+    }
+
+    flags = fcntl(fd, F_GETFL);                                 /* See Note #1.                                         */
+    if ((flags < 0) ||
+        (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0)) {
+        (void)close(fd);
+        return (-1);
+    }
+
+    rtn = connect(fd, p_ai->ai_addr, p_ai->ai_addrlen);
+    if (timeout_ms == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {       /* See Note #2.                                         */
+        if ((rtn != 0) && (errno != EINPROGRESS)) {
+            (void)close(fd);
+            return (-1);
+        }
+        return (fd);
+    }
+
+    if ((rtn != 0) && (errno == EINPROGRESS)) {
+        if (timeout_ms >= (CPU_INT32U)INT_MAX) {
+            timeout = -1;
+        } else {
+            timeout = (int)timeout_ms;
+        }
+
+        pfd.fd      = fd;
+        pfd.events  = POLLOUT;
+        pfd.revents = 0;
+        do {
+            rtn = poll(&pfd, 1u, timeout);
+        } while ((rtn < 0) && (errno == EINTR));
+
+        if (rtn == 1) {                                         /* Conn completed : get its result.                     */
+            err     = 0;
+            opt_len = sizeof(err);
+            rtn     = getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &opt_len);
+            if (err != 0) {
+                rtn = -1;
+            }
+        } else {
+            rtn = -1;
+        }
+    }
+
+    if ((rtn != 0) ||
+        (fcntl(fd, F_SETFL, flags) != 0)) {
+        (void)close(fd);
+        return (-1);
+    }
+
+    return (fd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportPosix_ErrGet()
+*
+* Description : Get the error code of a failed send or receive.
+*
+* Argument(s) : err_fail        Error code returned if the failure is not transitory.
+*
+* Return(s)   : SMTPc_ERR_WOULD_BLOCK, if the socket could not proceed without blocking, or timed out.
+*
+*               err_fail,              otherwise.
+*
+* Caller(s)   : SMTPc_TransportPosix_Rx(),
+*               SMTPc_TransportPosix_Tx(),
+*               SMTPc_TransportPosix_TxV().
+*
+* Note(s)     : (1) Called with errno set by the failed call.
+*********************************************************************************************************
+*/
+
+static  SMTPc_ERR  SMTPc_TransportPosix_ErrGet (SMTPc_ERR  err_fail)
+{
+    if ((errno == EAGAIN) ||
+        (errno == EWOULDBLOCK)) {
+        return (SMTPc_ERR_WOULD_BLOCK);
+    }
+
+    return (err_fail);
+}
@@ -0,0 +1,74 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                   uC/SMTPc TRANSPORT : POSIX SOCKETS
+*
+* Filename : smtp-c_transport_posix.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Transport of the sessions (see 'smtp-c.h  SMTPc_TRANSPORT_API') over the sockets of a
+*                POSIX system, for hosts running the client without uC/TCP-IP :
+*
+*                    SMTPc_TransportSet(&SMTPc_TransportAPI_Posix, &err);
+*
+*            (2) The socket identifiers are the descriptors of the sockets; connecting fails if a descriptor
+*                does not fit in a SMTPc_SOCK_ID.
+*
+*            (3) TLS is not supported : connecting with a secure configuration fails.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  SMTPc_TRANSPORT_POSIX_MODULE_PRESENT
+#define  SMTPc_TRANSPORT_POSIX_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+
+#include  <Source/smtp-c.h>
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+extern  const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Posix;   /* Transport fncts (see Note #1).                       */
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of smtp-c transport posix module include.        */
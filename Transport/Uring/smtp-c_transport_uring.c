@@ -0,0 +1,1826 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                   uC/SMTPc TRANSPORT : LINUX IO_URING
+*
+* Filename : smtp-c_transport_uring.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) The sockets stay blocking : io_uring waits for them itself, & fails the operations of a
+*                non-blocking socket that could not proceed.  The deadline of a connection is only used by
+*                the transport functions, to wait for the completion of its operations.  A blocking
+*                operation that times out returns SMTPc_ERR_WOULD_BLOCK, like a non-blocking one that could
+*                not proceed.
+*
+*            (2) Each connection has at most one operation of each kind in progress : connection,
+*                transmission & reception.  A zero-copy transmission also completes with a notification, once
+*                the kernel released its buffer (see 'SMTPc_TransportUring_TxPost()  Note #1').  The
+*                completion queue is sized accordingly; completions overflowing it are kept by the kernel.
+*
+*            (3) The user data of a request is the index of its connection, shifted, ORed with the kind of
+*                its operation (SMTPc_TRANSPORT_URING_OP_xxx); cancel requests have no kind.  The buffer held
+*                by a zero-copy transmission is tracked as an operation of its own, without request.
+*
+*            (4) A connection is ready once one of its operations completed, until a non-blocking transport
+*                function returns SMTPc_ERR_WOULD_BLOCK for it : its job may progress without waiting, even
+*                if the completion was processed by another transport function.  SMTPc_TransportUring_Wait()
+*                does not wait while a connection is ready.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#ifndef  _DEFAULT_SOURCE
+#define  _DEFAULT_SOURCE                                        /* POSIX.1-2008 & MAP_ANONYMOUS/MAP_POPULATE.           */
+#endif
+
+#define  MICRIUM_SOURCE
+#define  SMTPc_TRANSPORT_URING_MODULE
+
+#include  "smtp-c_transport_uring.h"
+
+#include  <lib_mem.h>
+
+#include  <arpa/inet.h>
+#include  <errno.h>
+#include  <linux/io_uring.h>
+#include  <netdb.h>
+#include  <netinet/in.h>
+#include  <netinet/tcp.h>
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <string.h>
+#include  <sys/mman.h>
+#include  <sys/socket.h>
+#include  <sys/syscall.h>
+#include  <sys/uio.h>
+#include  <time.h>
+#include  <unistd.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  SMTPc_TRANSPORT_URING_PORT_LEN                    6u   /* "65535".                                             */
+#define  SMTPc_TRANSPORT_URING_RX_BUF_LEN               1024u   /* Size of the rx buf of each conn.                     */
+#define  SMTPc_TRANSPORT_URING_TX_BUF_LEN               8192u   /* Size of the tx buf of each conn.                     */
+#define  SMTPc_TRANSPORT_URING_SQ_SIZE_MAX              4096u   /* Max nbr of entries of the submission Q.              */
+#define  SMTPc_TRANSPORT_URING_TX_ZC_LEN_MIN            2048u   /* Min len of zero-copy tx (see TxPost() Note #1b).     */
+
+                                                                /* ---------------- OPS (see Note #3) ----------------- */
+#define  SMTPc_TRANSPORT_URING_OP_CANCEL                   0u
+#define  SMTPc_TRANSPORT_URING_OP_CONN                     1u
+#define  SMTPc_TRANSPORT_URING_OP_TX                       2u
+#define  SMTPc_TRANSPORT_URING_OP_RX                       4u
+#define  SMTPc_TRANSPORT_URING_OP_ALL                     (SMTPc_TRANSPORT_URING_OP_CONN | \
+                                                           SMTPc_TRANSPORT_URING_OP_TX   | \
+                                                           SMTPc_TRANSPORT_URING_OP_RX)
+#define  SMTPc_TRANSPORT_URING_OP_TX_BUF                   8u   /* Tx buf held by a zero-copy tx, no request.           */
+#define  SMTPc_TRANSPORT_URING_OP_SHIFT                    3u
+
+#define  SMTPc_TRANSPORT_URING_PROBE_OP_NBR              256u   /* Nbr of ops probed.                                   */
+
+#define  SMTPc_TRANSPORT_URING_FEAT_REQ                   (IORING_FEAT_SINGLE_MMAP | \
+                                                           IORING_FEAT_NODROP      | \
+                                                           IORING_FEAT_EXT_ARG)
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  smtpc_transport_uring_conn  SMTPc_TRANSPORT_URING_CONN;
+
+struct  smtpc_transport_uring_conn {
+    int                          Fd;                            /* Socket, -1 if conn free.                             */
+    CPU_INT08U                   OpPend;                        /* Ops in progress (see Note #2).                       */
+    CPU_BOOLEAN                  Fail;                          /* Conn failed or closed by the server.                 */
+    CPU_BOOLEAN                  Rdy;                           /* Op cmpl'd since the conn last blocked (see Note #4). */
+    CPU_INT32U                   TimeoutMs;                     /* Deadline of the ops (see Note #1).                   */
+
+    CPU_INT08U                  *TxBufPtr;                      /* Data being tx'd ...                                  */
+    CPU_INT32U                   TxLen;                         /* ... its len ...                                      */
+    CPU_INT32U                   TxOff;                         /* ... & len already tx'd.                              */
+    CPU_INT08U                   TxNotifNbr;                    /* Nbr of zero-copy notifications pending.              */
+
+    CPU_INT08U                  *RxBufPtr;                      /* Data rx'd ...                                        */
+    CPU_INT32U                   RxLen;                         /* ... its len ...                                      */
+    CPU_INT32U                   RxOff;                         /* ... & len already returned.                          */
+
+    struct  sockaddr_storage     Addr;                          /* Server addr, while connecting.                       */
+    socklen_t                    AddrLen;
+
+    SMTPc_TRANSPORT_URING_CONN  *NextPtr;                       /* Next free conn.                                      */
+};
+
+
+typedef  struct  smtpc_transport_uring_ring {
+    int                          Fd;                            /* io_uring instance.                                   */
+
+    CPU_INT32U                  *SQ_HeadPtr;                    /* Submission Q, shared with the kernel.                */
+    CPU_INT32U                  *SQ_TailPtr;
+    CPU_INT32U                  *SQ_ArrayPtr;
+    struct  io_uring_sqe        *SQE_Tbl;
+    CPU_INT32U                   SQ_Mask;
+    CPU_INT32U                   SQ_Entries;
+    CPU_INT32U                   SQ_Tail;                       /* Tail of the submission Q, not published yet.         */
+
+    CPU_INT32U                  *CQ_HeadPtr;                    /* Completion Q, shared with the kernel.                */
+    CPU_INT32U                  *CQ_TailPtr;
+    struct  io_uring_cqe        *CQE_Tbl;
+    CPU_INT32U                   CQ_Mask;
+} SMTPc_TRANSPORT_URING_RING;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN                  SMTPc_TransportUring_InitDone = DEF_NO;
+static  SMTPc_TRANSPORT_URING_RING   SMTPc_TransportUring_Ring;
+static  SMTPc_TRANSPORT_URING_CONN  *SMTPc_TransportUring_ConnTbl;
+static  CPU_INT32U                   SMTPc_TransportUring_ConnNbrMax;
+static  SMTPc_TRANSPORT_URING_CONN  *SMTPc_TransportUring_ConnFreePtr;
+static  CPU_BOOLEAN                  SMTPc_TransportUring_TxZC_En;
+static  CPU_INT32U                   SMTPc_TransportUring_RdyNbr;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID                SMTPc_TransportUring_Open        (CPU_CHAR                    *p_host_name,
+                                                                       CPU_INT16U                   port,
+                                                                       SMTPc_SECURE_CFG            *p_secure_cfg,
+                                                                       CPU_INT32U                   timeout_ms,
+                                                                       SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U                   SMTPc_TransportUring_Tx          (SMTPc_SOCK_ID                sock_id,
+                                                                       const  void                 *p_data,
+                                                                       CPU_INT32U                   len,
+                                                                       SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U                   SMTPc_TransportUring_TxV         (SMTPc_SOCK_ID                sock_id,
+                                                                       const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                                                       CPU_INT08U                   vec_nbr,
+                                                                       SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U                   SMTPc_TransportUring_Rx          (SMTPc_SOCK_ID                sock_id,
+                                                                       void                        *p_buf,
+                                                                       CPU_INT32U                   len,
+                                                                       SMTPc_ERR                   *p_err);
+
+static  void                         SMTPc_TransportUring_Close       (SMTPc_SOCK_ID                sock_id,
+                                                                       CPU_INT32U                   timeout_ms);
+
+static  void                         SMTPc_TransportUring_DeadlineSet (SMTPc_SOCK_ID                sock_id,
+                                                                       CPU_INT32U                   timeout_ms,
+                                                                       SMTPc_ERR                   *p_err);
+
+static  void                         SMTPc_TransportUring_LocalAddrGet(SMTPc_SOCK_ID                sock_id,
+                                                                       CPU_CHAR                    *p_addr,
+                                                                       CPU_INT08U                  *p_family,
+                                                                       SMTPc_ERR                   *p_err);
+
+static  SMTPc_TS_MS                  SMTPc_TransportUring_TS_Get_ms   (void);
+
+static  SMTPc_SOCK_ID                SMTPc_TransportUring_Conn        (const  struct  addrinfo     *p_ai,
+                                                                       CPU_INT32U                   timeout_ms);
+
+static  void                         SMTPc_TransportUring_ConnRelease (SMTPc_TRANSPORT_URING_CONN  *p_conn);
+
+static  SMTPc_TRANSPORT_URING_CONN  *SMTPc_TransportUring_ConnGet     (SMTPc_SOCK_ID                sock_id);
+
+static  CPU_BOOLEAN                  SMTPc_TransportUring_ConnPost    (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                                       CPU_BOOLEAN                  rx_link);
+
+static  CPU_BOOLEAN                  SMTPc_TransportUring_TxPost      (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                                       CPU_BOOLEAN                  rx_link);
+
+static  CPU_BOOLEAN                  SMTPc_TransportUring_RxPost      (SMTPc_TRANSPORT_URING_CONN  *p_conn);
+
+static  void                         SMTPc_TransportUring_RxPrep      (SMTPc_TRANSPORT_URING_CONN  *p_conn);
+
+static  void                         SMTPc_TransportUring_RdySet      (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                                       CPU_BOOLEAN                  rdy);
+
+static  CPU_BOOLEAN                  SMTPc_TransportUring_OpWait      (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                                       CPU_INT08U                   op,
+                                                                       CPU_INT32U                   timeout_ms);
+
+static  void                         SMTPc_TransportUring_OpCmpl      (CPU_INT64U                   user_data,
+                                                                       CPU_INT32S                   res,
+                                                                       CPU_INT32U                   flags);
+
+static  CPU_INT32U                   SMTPc_TransportUring_Reap        (void);
+
+static  int                          SMTPc_TransportUring_Enter       (CPU_INT32U                   min_cmpl,
+                                                                       CPU_INT32U                   timeout_ms);
+
+static  CPU_BOOLEAN                  SMTPc_TransportUring_SQ_Reserve  (CPU_INT32U                   nbr);
+
+static  struct  io_uring_sqe        *SMTPc_TransportUring_SQE_Get     (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                                       CPU_INT08U                   op);
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Uring = {
+    SMTPc_TransportUring_Open,
+    SMTPc_TransportUring_Tx,
+    SMTPc_TransportUring_TxV,
+    SMTPc_TransportUring_Rx,
+    SMTPc_TransportUring_Close,
+    SMTPc_TransportUring_DeadlineSet,
+    SMTPc_TransportUring_LocalAddrGet,
+    SMTPc_TransportUring_TS_Get_ms
+};
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Init()
+*
+* Description : (1) Initialize the transport.
+*
+*                   (a) Allocate the connections & their buffers
+*                   (b) Create the io_uring instance & map its queues
+*                   (c) Register the buffers
+*                   (d) Probe the zero-copy transmission
+*
+*
+* Argument(s) : conn_nbr_max    Maximum number of connections open at once.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, transport ready.
+*                               SMTPc_ERR_INVALID_CFG               Invalid number of connections.
+*                               SMTPc_ERR_INIT_FAILED               Transport already initialized, io_uring not
+*                                                                       supported, or allocation failed.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (2) The function MUST be called once, before the transport is set (see
+*                   'smtp-c_transport_uring.h  Note #1').  The memory is never freed.
+*
+*               (3) Each connection needs SMTPc_TRANSPORT_URING_RX_BUF_LEN + SMTPc_TRANSPORT_URING_TX_BUF_LEN
+*                   octets, mapped as a single region so that the buffers are registered at once.
+*
+*               (4) The submission queue may be shorter than the number of connections : it is submitted
+*                   whenever full.  The completion queue holds the completions of all the operations that
+*                   may be in progress, with a notification (see 'smtp-c_transport_uring.c  Note #2'); both
+*                   are clamped to the limits of the kernel.
+*
+*               (5) IORING_OP_SEND_ZC reads registered buffers since Linux 6.0; older kernels copy all the
+*                   data sent (see 'SMTPc_TransportUring_TxPost()  Note #1').
+*********************************************************************************************************
+*/
+
+void  SMTPc_TransportUring_Init (CPU_INT32U   conn_nbr_max,
+                                 SMTPc_ERR   *p_err)
+{
+    SMTPc_TRANSPORT_URING_RING  *p_ring;
+    SMTPc_TRANSPORT_URING_CONN  *p_tbl;
+    struct  io_uring_params      params;
+    struct  io_uring_probe      *p_probe;
+    CPU_INT64U                   probe_buf[(sizeof(struct io_uring_probe) +
+                                            SMTPc_TRANSPORT_URING_PROBE_OP_NBR * sizeof(struct io_uring_probe_op)) / 8u];
+    struct  iovec                iov;
+    CPU_INT08U                  *p_buf;
+    CPU_INT08U                  *p_sq;
+    void                        *p_sqe;
+    CPU_SIZE_T                   buf_size;
+    CPU_SIZE_T                   ring_size;
+    CPU_INT32U                   i;
+    int                          fd;
+    LIB_MEM_ERR                  err_lib;
+
+
+    if ((conn_nbr_max == 0u) ||                                 /* Conn ix MUST fit in a sock ID.                       */
+        ((CPU_INT32U)(SMTPc_SOCK_ID)(conn_nbr_max - 1u) != (conn_nbr_max - 1u))) {
+       *p_err = SMTPc_ERR_INVALID_CFG;
+        return;
+    }
+    if (SMTPc_TransportUring_InitDone == DEF_YES) {             /* See Note #2.                                         */
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* -------------------- ALLOC CONNS ------------------- */
+    p_tbl = (SMTPc_TRANSPORT_URING_CONN *)Mem_SegAlloc("SMTPc Uring Conns",
+                                                        DEF_NULL,
+                                                        conn_nbr_max * sizeof(SMTPc_TRANSPORT_URING_CONN),
+                                                       &err_lib);
+    if (err_lib != LIB_MEM_ERR_NONE) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* See Note #3.                                         */
+    buf_size = (CPU_SIZE_T)conn_nbr_max * (SMTPc_TRANSPORT_URING_RX_BUF_LEN + SMTPc_TRANSPORT_URING_TX_BUF_LEN);
+    p_buf    = (CPU_INT08U *)mmap(DEF_NULL, buf_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p_buf == (CPU_INT08U *)MAP_FAILED) {
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* ------------------- CREATE RING -------------------- */
+    Mem_Clr(&params, sizeof(params));
+    params.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = conn_nbr_max * 4u;                      /* See Note #4.                                         */
+    fd = (int)syscall(__NR_io_uring_setup,
+                      DEF_MIN(conn_nbr_max, SMTPc_TRANSPORT_URING_SQ_SIZE_MAX),
+                     &params);
+    if (fd < 0) {
+        (void)munmap(p_buf, buf_size);
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+
+    ring_size = DEF_MAX(params.sq_off.array + params.sq_entries * sizeof(CPU_INT32U),
+                        params.cq_off.cqes  + params.cq_entries * sizeof(struct io_uring_cqe));
+    p_sq      = DEF_NULL;
+    p_sqe     = DEF_NULL;
+    if ((params.features & SMTPc_TRANSPORT_URING_FEAT_REQ) == SMTPc_TRANSPORT_URING_FEAT_REQ) {
+        p_sq  = (CPU_INT08U *)mmap(DEF_NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   fd, IORING_OFF_SQ_RING);
+        p_sqe =               mmap(DEF_NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+                                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   fd, IORING_OFF_SQES);
+    }
+    if ((p_sq  == DEF_NULL) || (p_sq  == (CPU_INT08U *)MAP_FAILED) ||
+        (p_sqe == DEF_NULL) || (p_sqe == MAP_FAILED)) {
+        (void)close(fd);                                        /* Closing the ring unmaps its queues.                  */
+        (void)munmap(p_buf, buf_size);
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* -------------------- REG BUFS ---------------------- */
+    iov.iov_base = p_buf;
+    iov.iov_len  = buf_size;
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, &iov, 1u) != 0) {
+        (void)close(fd);
+        (void)munmap(p_buf, buf_size);
+       *p_err = SMTPc_ERR_INIT_FAILED;
+        return;
+    }
+                                                                /* ------------------- PROBE TX ZC -------------------- */
+    SMTPc_TransportUring_TxZC_En = DEF_NO;                      /* See Note #5.                                         */
+    Mem_Clr(probe_buf, sizeof(probe_buf));
+    p_probe = (struct io_uring_probe *)probe_buf;
+    if ((syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, p_probe, SMTPc_TRANSPORT_URING_PROBE_OP_NBR) == 0) &&
+        (p_probe->last_op >= IORING_OP_SEND_ZC) &&
+        (DEF_BIT_IS_SET(p_probe->ops[IORING_OP_SEND_ZC].flags, IO_URING_OP_SUPPORTED) == DEF_YES)) {
+        SMTPc_TransportUring_TxZC_En = DEF_YES;
+    }
+                                                                /* --------------------- INIT RING -------------------- */
+    p_ring              = &SMTPc_TransportUring_Ring;
+    p_ring->Fd          =  fd;
+    p_ring->SQ_HeadPtr  = (CPU_INT32U *)(p_sq + params.sq_off.head);
+    p_ring->SQ_TailPtr  = (CPU_INT32U *)(p_sq + params.sq_off.tail);
+    p_ring->SQ_ArrayPtr = (CPU_INT32U *)(p_sq + params.sq_off.array);
+    p_ring->SQE_Tbl     = (struct io_uring_sqe *)p_sqe;
+    p_ring->SQ_Mask     = *(CPU_INT32U *)(p_sq + params.sq_off.ring_mask);
+    p_ring->SQ_Entries  =  params.sq_entries;
+    p_ring->SQ_Tail     = *p_ring->SQ_TailPtr;
+    p_ring->CQ_HeadPtr  = (CPU_INT32U *)(p_sq + params.cq_off.head);
+    p_ring->CQ_TailPtr  = (CPU_INT32U *)(p_sq + params.cq_off.tail);
+    p_ring->CQE_Tbl     = (struct io_uring_cqe *)(p_sq + params.cq_off.cqes);
+    p_ring->CQ_Mask     = *(CPU_INT32U *)(p_sq + params.cq_off.ring_mask);
+                                                                /* -------------------- INIT CONNS -------------------- */
+    for (i = 0u; i < conn_nbr_max; i++) {
+        p_tbl[i].Fd       = -1;
+        p_tbl[i].OpPend   =  0u;
+        p_tbl[i].Fail     =  DEF_NO;
+        p_tbl[i].Rdy      =  DEF_NO;
+        p_tbl[i].RxBufPtr =  p_buf + ((CPU_SIZE_T)i * SMTPc_TRANSPORT_URING_RX_BUF_LEN);
+        p_tbl[i].TxBufPtr =  p_buf + ((CPU_SIZE_T)conn_nbr_max * SMTPc_TRANSPORT_URING_RX_BUF_LEN)
+                                   + ((CPU_SIZE_T)i            * SMTPc_TRANSPORT_URING_TX_BUF_LEN);
+        p_tbl[i].NextPtr  = (i + 1u < conn_nbr_max) ? &p_tbl[i + 1u] : (SMTPc_TRANSPORT_URING_CONN *)0;
+    }
+    SMTPc_TransportUring_ConnTbl     = p_tbl;
+    SMTPc_TransportUring_ConnNbrMax  = conn_nbr_max;
+    SMTPc_TransportUring_ConnFreePtr = p_tbl;
+    SMTPc_TransportUring_RdyNbr      = 0u;
+    SMTPc_TransportUring_InitDone    = DEF_YES;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Wait()
+*
+* Description : Submit the queued operations & wait for at least one to complete.
+*
+* Argument(s) : timeout_ms      Time to wait for a completion, in milliseconds, SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK
+*                               or SMTPc_TRANSPORT_TIMEOUT_INFINITE.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, operations submitted.
+*                               SMTPc_ERR_NOT_INIT                  Transport not initialized.
+*                               SMTPc_ERR_RX_FAILED                 Error submitting or waiting.
+*
+* Return(s)   : Number of operations completed.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) See 'smtp-c_transport_uring.h  Note #2'.
+*
+*               (2) Completions already queued are taken without waiting, nor is a completion waited for
+*                   while a connection is ready (see 'smtp-c_transport_uring.c  Note #4') : SMTPc_Poll() steps
+*                   each job once per call, & a job may have data left to process after its step.  The
+*                   queued operations are submitted all the same.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  SMTPc_TransportUring_Wait (CPU_INT32U   timeout_ms,
+                                       SMTPc_ERR   *p_err)
+{
+    CPU_INT32U  nbr;
+    int         rtn;
+
+
+    if (SMTPc_TransportUring_InitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_NOT_INIT;
+        return (0u);
+    }
+
+    nbr = SMTPc_TransportUring_Reap();                          /* See Note #2.                                         */
+    if ((nbr                         > 0u) ||
+        (SMTPc_TransportUring_RdyNbr > 0u)) {
+        rtn = SMTPc_TransportUring_Enter(0u, SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK);
+    } else {
+        rtn = SMTPc_TransportUring_Enter(1u, timeout_ms);
+        nbr = SMTPc_TransportUring_Reap();
+    }
+
+    if ((rtn   <  0)     &&
+        (errno != ETIME) &&
+        (errno != EINTR) &&
+        (errno != EBUSY)) {
+       *p_err = SMTPc_ERR_RX_FAILED;
+        return (nbr);
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (nbr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Open()
+*
+* Description : Open a TCP connection to a server.
+*
+* Argument(s) : p_host_name     Pointer to host name or IP address of the server.
+*
+*               port            TCP port of the server.
+*
+*               p_secure_cfg    Pointer to the secure configuration, MUST be DEF_NULL (see
+*                               'smtp-c_transport_uring.h  Note #6').
+*
+*               timeout_ms      Time to wait for the server to accept the connection, in milliseconds, or
+*                               SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK (see Note #2).
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, connection established.
+*                               SMTPc_ERR_SECURE_NOT_AVAIL          Secure configuration passed.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Transport not initialized, no connection
+*                                                                       free, or error resolving or connecting
+*                                                                       to server.
+*
+* Return(s)   : Index of the connection, if NO error.
+*
+*               SMTPc_SOCK_ID_NONE,        otherwise.
+*
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : (1) Each address the host name resolves to is tried in turn, each with the full timeout.
+*
+*               (2) With SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, the connection is returned as soon as it is
+*                   queued, linked to the reception of the greeting (see 'smtp-c.h  SMTPc_TRANSPORT_API
+*                   Note #1a').  Only the first address a socket could be created for is tried.
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID  SMTPc_TransportUring_Open (CPU_CHAR                 *p_host_name,
+                                                  CPU_INT16U                port,
+                                                  SMTPc_SECURE_CFG         *p_secure_cfg,
+                                                  CPU_INT32U                timeout_ms,
+                                                  SMTPc_ERR                *p_err)
+{
+    struct  addrinfo   hints;
+    struct  addrinfo  *p_ai_list;
+    struct  addrinfo  *p_ai;
+    char               port_str[SMTPc_TRANSPORT_URING_PORT_LEN];
+    SMTPc_SOCK_ID      sock_id;
+
+
+    if (p_secure_cfg != DEF_NULL) {
+       *p_err = SMTPc_ERR_SECURE_NOT_AVAIL;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+    if (SMTPc_TransportUring_InitDone != DEF_YES) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+                                                                /* ------------------ RESOLVE HOST -------------------- */
+    (void)snprintf(port_str, sizeof(port_str), "%u", (unsigned)port);
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = AI_NUMERICSERV;
+
+    if (getaddrinfo((const char *)p_host_name, port_str, &hints, &p_ai_list) != 0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+                                                                /* ------------------- CONN TO HOST ------------------- */
+    sock_id = SMTPc_SOCK_ID_NONE;
+    for (p_ai = p_ai_list; p_ai != DEF_NULL; p_ai = p_ai->ai_next) {
+        sock_id = SMTPc_TransportUring_Conn(p_ai, timeout_ms);  /* See Note #1.                                         */
+        if (sock_id != SMTPc_SOCK_ID_NONE) {
+            break;
+        }
+    }
+    freeaddrinfo(p_ai_list);
+
+    if (sock_id == SMTPc_SOCK_ID_NONE) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (sock_id);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportUring_Tx()
+*
+* Description : Send data on a connection.
+*
+* Argument(s) : sock_id         Connection to send on.
+*
+*               p_data          Pointer to the data to send.
+*
+*               len             Length of the data.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                                                                   --- RETURNED BY SMTPc_TransportUring_TxV() : ---
+*                               SMTPc_ERR_NONE                      No error, data (partially) sent.
+*                               SMTPc_ERR_WOULD_BLOCK               Nothing could be sent.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : Number of octets sent, if NO error.
+*
+*               0,                     otherwise.
+*
+* Caller(s)   : SMTPc_AsyncTx(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportUring_Tx (SMTPc_SOCK_ID  sock_id,
+                                             const  void   *p_data,
+                                             CPU_INT32U     len,
+                                             SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_VEC  vec;
+    CPU_INT32U           tx_len;
+
+
+    vec.DataPtr = p_data;
+    vec.Len     = len;
+    tx_len      = SMTPc_TransportUring_TxV(sock_id, &vec, 1u, p_err);
+
+    return (tx_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportUring_TxV()
+*
+* Description : Send several buffers on a connection, in order, in a single operation.
+*
+* Argument(s) : sock_id         Connection to send on.
+*
+*               p_vec           Pointer to the table of buffers.
+*
+*               vec_nbr         Number of buffers.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data (partially) sent.
+*                               SMTPc_ERR_WOULD_BLOCK               Nothing could be sent.
+*                               SMTPc_ERR_TX_FAILED                 Error transmitting the data.
+*
+* Return(s)   : Number of octets sent, if NO error.
+*
+*               0,                     otherwise.
+*
+* Caller(s)   : SMTPc_TransportUring_Tx(),
+*               SMTPc_TxSockV(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : (1) The data is copied to the transmission buffer of the connection : only its first
+*                   SMTPc_TRANSPORT_URING_TX_BUF_LEN octets are sent, the caller sending the rest on the next
+*                   call, like after any partial send.  The data of the previous call MUST have been sent.
+*
+*               (2) Without deadline, the data is counted as sent once queued; a failure to send it is
+*                   returned by the next call.  Otherwise, the function waits for the data to be sent.
+*
+*               (3) See 'smtp-c_transport_uring.h  Note #3'.  A reply already (partially) received is not
+*                   overwritten.
+*
+*               (4) The buffer of a zero-copy transmission is only written again once the kernel released it
+*                   (see 'SMTPc_TransportUring_TxPost()  Note #1a').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportUring_TxV (SMTPc_SOCK_ID                sock_id,
+                                              const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                              CPU_INT08U                   vec_nbr,
+                                              SMTPc_ERR                   *p_err)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+    CPU_INT32U                   len;
+    CPU_INT32U                   copy_len;
+    CPU_INT08U                   i;
+    CPU_BOOLEAN                  rx_link;
+    CPU_BOOLEAN                  ok;
+
+
+    p_conn = SMTPc_TransportUring_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_URING_CONN *)0) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return (0u);
+    }
+                                                                /* ------------- WAIT FOR PREVIOUS DATA --------------- */
+    (void)SMTPc_TransportUring_Reap();                          /* See Note #4.                                         */
+    if (DEF_BIT_IS_SET_ANY(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_TX | SMTPc_TRANSPORT_URING_OP_TX_BUF) == DEF_YES) {
+        if (p_conn->TimeoutMs == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+            SMTPc_TransportUring_RdySet(p_conn, DEF_NO);
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+            return (0u);
+        }
+        ok = SMTPc_TransportUring_OpWait(p_conn,
+                                         SMTPc_TRANSPORT_URING_OP_TX | SMTPc_TRANSPORT_URING_OP_TX_BUF,
+                                         p_conn->TimeoutMs);
+        if (ok != DEF_YES) {
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+            return (0u);
+        }
+    }
+    if (p_conn->Fail == DEF_YES) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return (0u);
+    }
+                                                                /* ------------------- COPY DATA ---------------------- */
+    len = 0u;                                                   /* See Note #1.                                         */
+    for (i = 0u; (i < vec_nbr) && (len < SMTPc_TRANSPORT_URING_TX_BUF_LEN); i++) {
+        copy_len = DEF_MIN(p_vec[i].Len, SMTPc_TRANSPORT_URING_TX_BUF_LEN - len);
+        Mem_Copy(&p_conn->TxBufPtr[len], p_vec[i].DataPtr, copy_len);
+        len     += copy_len;
+    }
+    if (len == 0u) {
+       *p_err = SMTPc_ERR_NONE;
+        return (0u);
+    }
+                                                                /* -------------------- SEND DATA --------------------- */
+    p_conn->TxLen = len;
+    p_conn->TxOff = 0u;
+    rx_link       = DEF_NO;                                     /* See Note #3.                                         */
+    if ((DEF_BIT_IS_CLR(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_RX) == DEF_YES) &&
+        (p_conn->RxOff >= p_conn->RxLen)) {
+        rx_link = DEF_YES;
+    }
+    ok = SMTPc_TransportUring_TxPost(p_conn, rx_link);
+    if (ok != DEF_YES) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return (0u);
+    }
+                                                                /* See Note #2.                                         */
+    if (p_conn->TimeoutMs != SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+        ok = SMTPc_TransportUring_OpWait(p_conn, SMTPc_TRANSPORT_URING_OP_TX, p_conn->TimeoutMs);
+        if (ok != DEF_YES) {
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+            return (0u);
+        }
+        if (p_conn->Fail == DEF_YES) {
+           *p_err = SMTPc_ERR_TX_FAILED;
+            return (0u);
+        }
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      SMTPc_TransportUring_Rx()
+*
+* Description : Receive data from a connection.
+*
+* Argument(s) : sock_id         Connection to receive from.
+*
+*               p_buf           Pointer to the buffer that will receive the data.
+*
+*               len             Size of the buffer.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, data received.
+*                               SMTPc_ERR_WOULD_BLOCK               No data available yet.
+*                               SMTPc_ERR_RX_FAILED                 Error receiving, or connection closed.
+*
+* Return(s)   : Number of octets received, if NO error.
+*
+*               0,                         otherwise.
+*
+* Caller(s)   : SMTPc_RxReply(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : (1) The data left in the reception buffer is returned first, even if the connection failed
+*                   since.
+*
+*               (2) A reception is only queued once the buffer is empty, so that it may be linked to the
+*                   next transmission instead (see 'smtp-c_transport_uring.h  Note #3').  It is queued again
+*                   if it was cancelled (see 'SMTPc_TransportUring_OpCmpl()  Note #2').
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportUring_Rx (SMTPc_SOCK_ID  sock_id,
+                                             void          *p_buf,
+                                             CPU_INT32U     len,
+                                             SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+    CPU_INT32U                   rx_len;
+    CPU_BOOLEAN                  ok;
+
+
+    p_conn = SMTPc_TransportUring_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_URING_CONN *)0) {
+       *p_err = SMTPc_ERR_RX_FAILED;
+        return (0u);
+    }
+                                                                /* ------------------ WAIT FOR DATA ------------------- */
+    while (p_conn->RxOff >= p_conn->RxLen) {                    /* See Note #1.                                         */
+        (void)SMTPc_TransportUring_Reap();
+        if (p_conn->RxOff < p_conn->RxLen) {
+            break;
+        }
+        if (p_conn->Fail == DEF_YES) {
+           *p_err = SMTPc_ERR_RX_FAILED;
+            return (0u);
+        }
+                                                                /* See Note #2.                                         */
+        if (DEF_BIT_IS_CLR(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_RX) == DEF_YES) {
+            ok = SMTPc_TransportUring_RxPost(p_conn);
+            if (ok != DEF_YES) {
+               *p_err = SMTPc_ERR_RX_FAILED;
+                return (0u);
+            }
+        }
+        if (p_conn->TimeoutMs == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) {
+            SMTPc_TransportUring_RdySet(p_conn, DEF_NO);
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+            return (0u);
+        }
+        ok = SMTPc_TransportUring_OpWait(p_conn, SMTPc_TRANSPORT_URING_OP_RX, p_conn->TimeoutMs);
+        if (ok != DEF_YES) {
+           *p_err = SMTPc_ERR_WOULD_BLOCK;
+            return (0u);
+        }
+    }
+                                                                /* -------------------- COPY DATA --------------------- */
+    rx_len = DEF_MIN(len, p_conn->RxLen - p_conn->RxOff);
+    Mem_Copy(p_buf, &p_conn->RxBufPtr[p_conn->RxOff], rx_len);
+    p_conn->RxOff += rx_len;
+
+   *p_err = SMTPc_ERR_NONE;
+
+    return (rx_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Close()
+*
+* Description : Close a connection.
+*
+* Argument(s) : sock_id         Connection to close.
+*
+*               timeout_ms      Time to wait for the data being sent, in milliseconds.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various, through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : (1) The data queued by a non-blocking connection may not be sent yet (see
+*                   'SMTPc_TransportUring_TxV()  Note #2') : the QUIT command, typically.  The data sent
+*                   without copy is waited for until acknowledged (see 'SMTPc_TransportUring_TxPost()
+*                   Note #1a').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_Close (SMTPc_SOCK_ID  sock_id,
+                                          CPU_INT32U     timeout_ms)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+
+
+    p_conn = SMTPc_TransportUring_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_URING_CONN *)0) {
+        return;
+    }
+                                                                /* See Note #1.                                         */
+    if (DEF_BIT_IS_SET_ANY(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_TX | SMTPc_TRANSPORT_URING_OP_TX_BUF) == DEF_YES) {
+        (void)SMTPc_TransportUring_OpWait(p_conn,
+                                          SMTPc_TRANSPORT_URING_OP_TX | SMTPc_TRANSPORT_URING_OP_TX_BUF,
+                                          timeout_ms);
+    }
+
+    SMTPc_TransportUring_ConnRelease(p_conn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                  SMTPc_TransportUring_DeadlineSet()
+*
+* Description : Set how long the operations of a connection are waited for.
+*
+* Argument(s) : sock_id         Connection to configure.
+*
+*               timeout_ms      SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK, SMTPc_TRANSPORT_TIMEOUT_INFINITE, or time
+*                               to wait on each receive & transmit, in milliseconds.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, connection configured.
+*                               SMTPc_ERR_SOCK_CONN_FAILED          Invalid connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_SessionConnect() & SMTPc_AsyncConn(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : (1) See 'smtp-c_transport_uring.c  Note #1'.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_DeadlineSet (SMTPc_SOCK_ID  sock_id,
+                                                CPU_INT32U     timeout_ms,
+                                                SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+
+
+    p_conn = SMTPc_TransportUring_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_URING_CONN *)0) {
+       *p_err = SMTPc_ERR_SOCK_CONN_FAILED;
+        return;
+    }
+
+    p_conn->TimeoutMs = timeout_ms;
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                 SMTPc_TransportUring_LocalAddrGet()
+*
+* Description : Get the local IP address of a connection, as a string.
+*
+* Argument(s) : sock_id         Connection to get the address of.
+*
+*               p_addr          Pointer to the buffer that will receive the address, of at least
+*                               SMTPc_TRANSPORT_ADDR_LEN characters.
+*
+*               p_family        Pointer to the variable that will receive the address family.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function :
+*
+*                               SMTPc_ERR_NONE                      No error, address returned.
+*                               SMTPc_ERR_TX_FAILED                 Error getting or formatting the address.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_BuildHELO(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_LocalAddrGet (SMTPc_SOCK_ID  sock_id,
+                                                 CPU_CHAR      *p_addr,
+                                                 CPU_INT08U    *p_family,
+                                                 SMTPc_ERR     *p_err)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+    struct  sockaddr_storage     addr;
+    socklen_t                    addr_len;
+    const  char                 *p_str;
+
+
+    p_conn = SMTPc_TransportUring_ConnGet(sock_id);
+    if (p_conn == (SMTPc_TRANSPORT_URING_CONN *)0) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+    addr_len = sizeof(addr);
+    if (getsockname(p_conn->Fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+    switch (addr.ss_family) {
+        case AF_INET:
+             p_str = inet_ntop(AF_INET,
+                              &((struct sockaddr_in *)&addr)->sin_addr,
+                               (char *)p_addr,
+                               SMTPc_TRANSPORT_ADDR_LEN);
+            *p_family = SMTPc_TRANSPORT_FAMILY_IPv4;
+             break;
+
+        case AF_INET6:
+             p_str = inet_ntop(AF_INET6,
+                              &((struct sockaddr_in6 *)&addr)->sin6_addr,
+                               (char *)p_addr,
+                               SMTPc_TRANSPORT_ADDR_LEN);
+            *p_family = SMTPc_TRANSPORT_FAMILY_IPv6;
+             break;
+
+        default:
+             p_str = DEF_NULL;
+             break;
+    }
+
+    if (p_str == DEF_NULL) {
+       *p_err = SMTPc_ERR_TX_FAILED;
+        return;
+    }
+
+   *p_err = SMTPc_ERR_NONE;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Conn()
+*
+* Description : Connect a new socket to an address, within a timeout.
+*
+* Argument(s) : p_ai            Pointer to the address.
+*
+*               timeout_ms      Time to wait for the server to accept the connection, in milliseconds, or
+*                               SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK.
+*
+* Return(s)   : Index of the connection, if NO error.
+*
+*               SMTPc_SOCK_ID_NONE,        otherwise.
+*
+* Caller(s)   : SMTPc_TransportUring_Open().
+*
+* Note(s)     : (1) Commands are already gathered into segments by the client : Nagle's algorithm would
+*                   only delay them.
+*
+*               (2) See 'SMTPc_TransportUring_Open()  Note #2'.  The connection is opened without limit
+*                   (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #1f').
+*********************************************************************************************************
+*/
+
+static  SMTPc_SOCK_ID  SMTPc_TransportUring_Conn (const  struct  addrinfo  *p_ai,
+                                                  CPU_INT32U                timeout_ms)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+    CPU_BOOLEAN                  no_block;
+    CPU_BOOLEAN                  ok;
+    int                          fd;
+    int                          opt;
+
+
+    p_conn = SMTPc_TransportUring_ConnFreePtr;
+    if ((p_conn          == (SMTPc_TRANSPORT_URING_CONN *)0) || /* All conns in use.                                    */
+        (p_ai->ai_addrlen > sizeof(p_conn->Addr))) {
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    fd = socket(p_ai->ai_family, p_ai->ai_socktype | SOCK_CLOEXEC, p_ai->ai_protocol);
+    if (fd < 0) {
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    opt = 1;                                                    /* See Note #1.                                         */
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+                                                                /* --------------------- GET CONN --------------------- */
+    SMTPc_TransportUring_ConnFreePtr = p_conn->NextPtr;
+    p_conn->NextPtr    = (SMTPc_TRANSPORT_URING_CONN *)0;
+    p_conn->Fd         =  fd;
+    p_conn->OpPend     =  0u;
+    p_conn->Fail       =  DEF_NO;
+    p_conn->Rdy        =  DEF_NO;
+    p_conn->TimeoutMs  =  SMTPc_TRANSPORT_TIMEOUT_INFINITE;
+    p_conn->TxLen      =  0u;
+    p_conn->TxOff      =  0u;
+    p_conn->TxNotifNbr =  0u;
+    p_conn->RxLen      =  0u;
+    p_conn->RxOff      =  0u;
+    p_conn->AddrLen    =  p_ai->ai_addrlen;
+    Mem_Copy(&p_conn->Addr, p_ai->ai_addr, p_ai->ai_addrlen);
+                                                                /* ---------------------- CONN ------------------------ */
+    no_block = (timeout_ms == SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK) ? DEF_YES : DEF_NO;
+    ok       =  SMTPc_TransportUring_ConnPost(p_conn, no_block);
+    if (ok != DEF_YES) {
+        SMTPc_TransportUring_ConnRelease(p_conn);
+        return (SMTPc_SOCK_ID_NONE);
+    }
+
+    if (no_block == DEF_NO) {                                   /* See Note #2.                                         */
+        ok = SMTPc_TransportUring_OpWait(p_conn, SMTPc_TRANSPORT_URING_OP_CONN, timeout_ms);
+        if ((ok           != DEF_YES) ||
+            (p_conn->Fail == DEF_YES)) {
+            SMTPc_TransportUring_ConnRelease(p_conn);
+            return (SMTPc_SOCK_ID_NONE);
+        }
+    }
+
+    return ((SMTPc_SOCK_ID)(p_conn - SMTPc_TransportUring_ConnTbl));
+}
+
+
+/*
+*********************************************************************************************************
+*                                  SMTPc_TransportUring_ConnRelease()
+*
+* Description : Abort the operations of a connection, close its socket & free it.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportUring_Close(),
+*               SMTPc_TransportUring_Conn().
+*
+* Note(s)     : (1) The operations in progress refer to the buffers of the connection : they MUST complete
+*                   before the connection is reused.  Shutting the socket down completes its transmission &
+*                   reception at once; a connection in progress is cancelled.
+*
+*               (2) If no cancel request can be queued, the connection still completes on its own, within
+*                   the timeout of the system.
+*
+*               (3) The buffer of a zero-copy transmission is held until its data is acknowledged (see
+*                   'SMTPc_TransportUring_TxPost()  Note #1a') : the connection is then reset, which discards
+*                   the data & releases the buffer at once.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_ConnRelease (SMTPc_TRANSPORT_URING_CONN  *p_conn)
+{
+    struct  io_uring_sqe  *p_sqe;
+    struct  linger         linger;
+    CPU_BOOLEAN            ok;
+
+
+                                                                /* See Note #1.                                         */
+    if ((p_conn->OpPend & SMTPc_TRANSPORT_URING_OP_ALL) != 0u) {
+        (void)shutdown(p_conn->Fd, SHUT_RDWR);
+        if (DEF_BIT_IS_SET(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_CONN) == DEF_YES) {
+            ok = SMTPc_TransportUring_SQ_Reserve(1u);
+            if (ok == DEF_YES) {                                /* See Note #2.                                         */
+                p_sqe       = SMTPc_TransportUring_SQE_Get(p_conn, SMTPc_TRANSPORT_URING_OP_CANCEL);
+                p_sqe->addr = ((CPU_INT64U)(p_conn - SMTPc_TransportUring_ConnTbl) << SMTPc_TRANSPORT_URING_OP_SHIFT)
+                            |   SMTPc_TRANSPORT_URING_OP_CONN;
+            }
+        }
+        (void)SMTPc_TransportUring_OpWait(p_conn, SMTPc_TRANSPORT_URING_OP_ALL, SMTPc_TRANSPORT_TIMEOUT_INFINITE);
+    }
+
+    if (DEF_BIT_IS_SET(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_TX_BUF) == DEF_YES) {
+        linger.l_onoff  = 1;                                    /* See Note #3.                                         */
+        linger.l_linger = 0;
+        (void)setsockopt(p_conn->Fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+        (void)close(p_conn->Fd);
+        (void)SMTPc_TransportUring_OpWait(p_conn, SMTPc_TRANSPORT_URING_OP_TX_BUF, SMTPc_TRANSPORT_TIMEOUT_INFINITE);
+    } else {
+        (void)close(p_conn->Fd);
+    }
+    SMTPc_TransportUring_RdySet(p_conn, DEF_NO);
+    p_conn->Fd                       = -1;
+    p_conn->NextPtr                  =  SMTPc_TransportUring_ConnFreePtr;
+    SMTPc_TransportUring_ConnFreePtr =  p_conn;
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_ConnGet()
+*
+* Description : Get the open connection of a socket identifier.
+*
+* Argument(s) : sock_id         Socket identifier.
+*
+* Return(s)   : Pointer to the connection, if open.
+*
+*               Pointer to NULL,           otherwise.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  SMTPc_TRANSPORT_URING_CONN  *SMTPc_TransportUring_ConnGet (SMTPc_SOCK_ID  sock_id)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+
+
+    if ((SMTPc_TransportUring_InitDone != DEF_YES) ||
+        (sock_id                       <  0)       ||
+        ((CPU_INT32U)sock_id           >= SMTPc_TransportUring_ConnNbrMax)) {
+        return ((SMTPc_TRANSPORT_URING_CONN *)0);
+    }
+
+    p_conn = &SMTPc_TransportUring_ConnTbl[sock_id];
+    if (p_conn->Fd < 0) {
+        return ((SMTPc_TRANSPORT_URING_CONN *)0);
+    }
+
+    return (p_conn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportUring_ConnPost()
+*
+* Description : Queue the connection of a socket to its server.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               rx_link         DEF_YES, to link the reception of the greeting to the connection.
+*
+* Return(s)   : DEF_YES, if the operations were queued.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_TransportUring_Conn().
+*
+* Note(s)     : (1) A linked operation is cancelled if the previous one fails : both are hence queued in the
+*                   same submission.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_TransportUring_ConnPost (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                    CPU_BOOLEAN                  rx_link)
+{
+    struct  io_uring_sqe  *p_sqe;
+    CPU_BOOLEAN            ok;
+
+
+    ok = SMTPc_TransportUring_SQ_Reserve((rx_link == DEF_YES) ? 2u : 1u);
+    if (ok != DEF_YES) {                                        /* See Note #1.                                         */
+        return (DEF_NO);
+    }
+
+    p_sqe       = SMTPc_TransportUring_SQE_Get(p_conn, SMTPc_TRANSPORT_URING_OP_CONN);
+    p_sqe->addr = (CPU_INT64U)(uintptr_t)&p_conn->Addr;
+    p_sqe->off  = p_conn->AddrLen;                              /* Len of the addr.                                     */
+    if (rx_link == DEF_YES) {
+        p_sqe->flags = IOSQE_IO_LINK;
+        SMTPc_TransportUring_RxPrep(p_conn);
+    }
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_TxPost()
+*
+* Description : Queue the transmission of the data left in the transmission buffer of a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               rx_link         DEF_YES, to link the reception of the reply to the transmission.
+*
+* Return(s)   : DEF_YES, if the operations were queued.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_TransportUring_OpCmpl(),
+*               SMTPc_TransportUring_TxV().
+*
+* Note(s)     : (1) The data is sent rather than written, so that a connection reset by the server does not
+*                   raise SIGPIPE.  Where the kernel supports it (see 'SMTPc_TransportUring_Init()  Note #5'),
+*                   it is sent without copy from the registered transmission buffer :
+*
+*                   (a) The kernel holds the buffer until the data is acknowledged, past the completion of the
+*                       transmission : a second completion, flagged IORING_CQE_F_NOTIF, releases it.  The
+*                       buffer is meanwhile held by SMTPc_TRANSPORT_URING_OP_TX_BUF.
+*
+*                   (b) Pinning the pages & the notification cost more than copying short data : commands &
+*                       short segments, under SMTPc_TRANSPORT_URING_TX_ZC_LEN_MIN octets, are copied.
+*
+*               (2) See 'SMTPc_TransportUring_ConnPost()  Note #1'.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_TransportUring_TxPost (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                  CPU_BOOLEAN                  rx_link)
+{
+    struct  io_uring_sqe  *p_sqe;
+    CPU_BOOLEAN            ok;
+
+
+    ok = SMTPc_TransportUring_SQ_Reserve((rx_link == DEF_YES) ? 2u : 1u);
+    if (ok != DEF_YES) {                                        /* See Note #2.                                         */
+        return (DEF_NO);
+    }
+
+    p_sqe            = SMTPc_TransportUring_SQE_Get(p_conn, SMTPc_TRANSPORT_URING_OP_TX);
+    p_sqe->addr      = (CPU_INT64U)(uintptr_t)&p_conn->TxBufPtr[p_conn->TxOff];
+    p_sqe->len       =  p_conn->TxLen - p_conn->TxOff;
+    p_sqe->msg_flags =  MSG_NOSIGNAL;                           /* See Note #1.                                         */
+    if ((SMTPc_TransportUring_TxZC_En == DEF_YES) &&
+        (p_sqe->len                   >= SMTPc_TRANSPORT_URING_TX_ZC_LEN_MIN)) {
+        p_sqe->opcode    = IORING_OP_SEND_ZC;                   /* See Note #1b.                                        */
+        p_sqe->ioprio    = IORING_RECVSEND_FIXED_BUF;
+        p_sqe->buf_index = 0u;
+    }
+    if (rx_link == DEF_YES) {
+        p_sqe->flags = IOSQE_IO_LINK;
+        SMTPc_TransportUring_RxPrep(p_conn);
+    }
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_RxPost()
+*
+* Description : Queue a reception on a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : DEF_YES, if the operation was queued.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : SMTPc_TransportUring_Rx().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_TransportUring_RxPost (SMTPc_TRANSPORT_URING_CONN  *p_conn)
+{
+    CPU_BOOLEAN  ok;
+
+
+    ok = SMTPc_TransportUring_SQ_Reserve(1u);
+    if (ok != DEF_YES) {
+        return (DEF_NO);
+    }
+
+    SMTPc_TransportUring_RxPrep(p_conn);
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_RxPrep()
+*
+* Description : Queue a reception on a connection, in an entry already reserved.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportUring_ConnPost(),
+*               SMTPc_TransportUring_RxPost(),
+*               SMTPc_TransportUring_TxPost().
+*
+* Note(s)     : (1) The data is read into the registered reception buffer of the connection (see
+*                   'SMTPc_TransportUring_Init()  Note #3'); the offset is ignored by sockets.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_RxPrep (SMTPc_TRANSPORT_URING_CONN  *p_conn)
+{
+    struct  io_uring_sqe  *p_sqe;
+
+
+    p_conn->RxLen    = 0u;
+    p_conn->RxOff    = 0u;
+                                                                /* See Note #1.                                         */
+    p_sqe            = SMTPc_TransportUring_SQE_Get(p_conn, SMTPc_TRANSPORT_URING_OP_RX);
+    p_sqe->addr      = (CPU_INT64U)(uintptr_t)p_conn->RxBufPtr;
+    p_sqe->len       = SMTPc_TRANSPORT_URING_RX_BUF_LEN;
+    p_sqe->buf_index = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_RdySet()
+*
+* Description : Set whether a connection is ready.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               rdy             DEF_YES, if the job of the connection may progress without waiting;
+*                               DEF_NO,  otherwise.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) See 'smtp-c_transport_uring.c  Note #4'.
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_RdySet (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                           CPU_BOOLEAN                  rdy)
+{
+    if (p_conn->Rdy == rdy) {
+        return;
+    }
+
+    p_conn->Rdy = rdy;
+    if (rdy == DEF_YES) {
+        SMTPc_TransportUring_RdyNbr++;
+    } else {
+        SMTPc_TransportUring_RdyNbr--;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_OpWait()
+*
+* Description : Wait for the operations of a connection to complete.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               op              Operations to wait for (SMTPc_TRANSPORT_URING_OP_xxx).
+*
+*               timeout_ms      Time to wait, in milliseconds, or SMTPc_TRANSPORT_TIMEOUT_INFINITE.
+*
+* Return(s)   : DEF_YES, if the operations completed.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) The completions of the other connections are processed as well.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_TransportUring_OpWait (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                  CPU_INT08U                   op,
+                                                  CPU_INT32U                   timeout_ms)
+{
+    SMTPc_TS_MS  ts_start;
+    SMTPc_TS_MS  elapsed;
+    CPU_INT32U   remain_ms;
+    int          rtn;
+
+
+    ts_start  = SMTPc_TransportUring_TS_Get_ms();
+    remain_ms = timeout_ms;
+
+    (void)SMTPc_TransportUring_Reap();
+    while ((p_conn->OpPend & op) != 0u) {
+        if (timeout_ms != SMTPc_TRANSPORT_TIMEOUT_INFINITE) {
+            elapsed = (SMTPc_TS_MS)(SMTPc_TransportUring_TS_Get_ms() - ts_start);
+            if (elapsed >= timeout_ms) {
+                return (DEF_NO);
+            }
+            remain_ms = timeout_ms - elapsed;
+        }
+
+        rtn = SMTPc_TransportUring_Enter(1u, remain_ms);
+        if ((rtn   <  0)     &&
+            (errno != ETIME) &&
+            (errno != EINTR) &&
+            (errno != EBUSY)) {
+            return (DEF_NO);
+        }
+        (void)SMTPc_TransportUring_Reap();                      /* See Note #1.                                         */
+    }
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                    SMTPc_TransportUring_OpCmpl()
+*
+* Description : Process the completion of an operation.
+*
+* Argument(s) : user_data       User data of the operation (see 'smtp-c_transport_uring.c  Note #3').
+*
+*               res             Result of the operation.
+*
+*               flags           Flags of the completion (IORING_CQE_F_xxx).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_TransportUring_Reap().
+*
+* Note(s)     : (1) A partial transmission is completed by a new one : the data was already counted as sent
+*                   (see 'SMTPc_TransportUring_TxV()  Note #2').
+*
+*               (2) A reception linked to a partial transmission is cancelled, but the connection did not
+*                   fail : it is queued again by the next reception.  The failure of the connection or
+*                   transmission it was linked to is set by their own completion.
+*
+*               (3) The server closed the connection.
+*
+*               (4) A zero-copy transmission holds its buffer until its notification (see
+*                   'SMTPc_TransportUring_TxPost()  Note #1a').  A partial transmission is completed before the
+*                   notification of its first part : several notifications may be pending.
+*
+*               (5) The job of the connection may progress again (see 'smtp-c_transport_uring.c  Note #4').
+*********************************************************************************************************
+*/
+
+static  void  SMTPc_TransportUring_OpCmpl (CPU_INT64U  user_data,
+                                           CPU_INT32S  res,
+                                           CPU_INT32U  flags)
+{
+    SMTPc_TRANSPORT_URING_CONN  *p_conn;
+    CPU_INT08U                   op;
+    CPU_BOOLEAN                  ok;
+
+
+    op     = (CPU_INT08U)(user_data & ((1u << SMTPc_TRANSPORT_URING_OP_SHIFT) - 1u));
+    p_conn = &SMTPc_TransportUring_ConnTbl[user_data >> SMTPc_TRANSPORT_URING_OP_SHIFT];
+
+    switch (op) {
+        case SMTPc_TRANSPORT_URING_OP_CONN:
+             if (res < 0) {
+                 p_conn->Fail = DEF_YES;
+             }
+             break;
+
+
+        case SMTPc_TRANSPORT_URING_OP_TX:
+             if (DEF_BIT_IS_SET(flags, IORING_CQE_F_NOTIF) == DEF_YES) {
+                 p_conn->TxNotifNbr--;                          /* See Note #4.                                         */
+                 if (p_conn->TxNotifNbr == 0u) {
+                     DEF_BIT_CLR(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_TX_BUF);
+                     SMTPc_TransportUring_RdySet(p_conn, DEF_YES);
+                 }
+                 return;
+             }
+             if (DEF_BIT_IS_SET(flags, IORING_CQE_F_MORE) == DEF_YES) {
+                 p_conn->TxNotifNbr++;
+                 DEF_BIT_SET(p_conn->OpPend, SMTPc_TRANSPORT_URING_OP_TX_BUF);
+             }
+             if (res <= 0) {
+                 p_conn->Fail = DEF_YES;
+                 break;
+             }
+             p_conn->TxOff += (CPU_INT32U)res;
+             if ((p_conn->TxOff <  p_conn->TxLen) &&            /* See Note #1.                                         */
+                 (p_conn->Fail  == DEF_NO)) {
+                 ok = SMTPc_TransportUring_TxPost(p_conn, DEF_NO);
+                 if (ok == DEF_YES) {
+                     return;
+                 }
+                 p_conn->Fail = DEF_YES;
+             }
+             break;
+
+
+        case SMTPc_TRANSPORT_URING_OP_RX:
+             if (res > 0) {
+                 p_conn->RxLen = (CPU_INT32U)res;
+             } else if (res != -ECANCELED) {                    /* See Note #2.                                         */
+                 p_conn->Fail  =  DEF_YES;                      /* See Note #3.                                         */
+             }
+             break;
+
+
+        case SMTPc_TRANSPORT_URING_OP_CANCEL:
+        default:
+             return;
+    }
+
+    DEF_BIT_CLR(p_conn->OpPend, op);
+    SMTPc_TransportUring_RdySet(p_conn, DEF_YES);               /* See Note #5.                                         */
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Reap()
+*
+* Description : Process the completions available, without waiting.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Number of completions processed.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) The head is only read by the kernel once published : the entries are copied before.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  SMTPc_TransportUring_Reap (void)
+{
+    SMTPc_TRANSPORT_URING_RING  *p_ring;
+    struct  io_uring_cqe        *p_cqe;
+    CPU_INT64U                   user_data;
+    CPU_INT32S                   res;
+    CPU_INT32U                   flags;
+    CPU_INT32U                   head;
+    CPU_INT32U                   tail;
+    CPU_INT32U                   nbr;
+
+
+    p_ring = &SMTPc_TransportUring_Ring;
+    head   = *p_ring->CQ_HeadPtr;
+    tail   =  __atomic_load_n(p_ring->CQ_TailPtr, __ATOMIC_ACQUIRE);
+    nbr    =  0u;
+
+    while (head != tail) {
+        p_cqe     = &p_ring->CQE_Tbl[head & p_ring->CQ_Mask];
+        user_data =  p_cqe->user_data;
+        res       =  p_cqe->res;
+        flags     =  p_cqe->flags;
+        head++;
+                                                                /* See Note #1.                                         */
+        __atomic_store_n(p_ring->CQ_HeadPtr, head, __ATOMIC_RELEASE);
+
+        SMTPc_TransportUring_OpCmpl(user_data, res, flags);
+        nbr++;
+    }
+
+    return (nbr);
+}
+
+
+/*
+*********************************************************************************************************
+*                                     SMTPc_TransportUring_Enter()
+*
+* Description : Submit the queued operations, & optionally wait for completions.
+*
+* Argument(s) : min_cmpl        Number of completions to wait for, 0 to only submit.
+*
+*               timeout_ms      Time to wait, in milliseconds, SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK or
+*                               SMTPc_TRANSPORT_TIMEOUT_INFINITE.
+*
+* Return(s)   : Number of operations submitted, if NO error.
+*
+*               -1,                             otherwise, with errno set (ETIME if the wait timed out).
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) The entries are only read by the kernel within the call : the tail is published here,
+*                   once they were all prepared.
+*********************************************************************************************************
+*/
+
+static  int  SMTPc_TransportUring_Enter (CPU_INT32U  min_cmpl,
+                                         CPU_INT32U  timeout_ms)
+{
+    SMTPc_TRANSPORT_URING_RING       *p_ring;
+    struct  io_uring_getevents_arg    arg;
+    struct  __kernel_timespec         ts;
+    CPU_INT32U                        to_submit;
+    unsigned                          flags;
+    void                             *p_arg;
+    size_t                            arg_size;
+    int                               rtn;
+
+
+    p_ring = &SMTPc_TransportUring_Ring;
+                                                                /* See Note #1.                                         */
+    __atomic_store_n(p_ring->SQ_TailPtr, p_ring->SQ_Tail, __ATOMIC_RELEASE);
+    to_submit = p_ring->SQ_Tail - __atomic_load_n(p_ring->SQ_HeadPtr, __ATOMIC_ACQUIRE);
+
+    flags    = 0u;
+    p_arg    = DEF_NULL;
+    arg_size = 0u;
+    if (min_cmpl > 0u) {
+        flags |= IORING_ENTER_GETEVENTS;
+        if (timeout_ms != SMTPc_TRANSPORT_TIMEOUT_INFINITE) {
+            ts.tv_sec  = (long long)(timeout_ms / 1000u);
+            ts.tv_nsec = (long long)(timeout_ms % 1000u) * 1000000;
+            memset(&arg, 0, sizeof(arg));
+            arg.ts     = (CPU_INT64U)(uintptr_t)&ts;
+            flags     |= IORING_ENTER_EXT_ARG;
+            p_arg      = &arg;
+            arg_size   = sizeof(arg);
+        }
+    } else if (to_submit == 0u) {
+        return (0);
+    }
+
+    rtn = (int)syscall(__NR_io_uring_enter, p_ring->Fd, to_submit, min_cmpl, flags, p_arg, arg_size);
+
+    return (rtn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                  SMTPc_TransportUring_SQ_Reserve()
+*
+* Description : Make room for entries in the submission queue.
+*
+* Argument(s) : nbr             Number of entries needed.
+*
+* Return(s)   : DEF_YES, if the entries are available.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) A full queue is submitted, without waiting.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  SMTPc_TransportUring_SQ_Reserve (CPU_INT32U  nbr)
+{
+    SMTPc_TRANSPORT_URING_RING  *p_ring;
+    CPU_INT32U                   used;
+
+
+    p_ring = &SMTPc_TransportUring_Ring;
+    used   =  p_ring->SQ_Tail - __atomic_load_n(p_ring->SQ_HeadPtr, __ATOMIC_ACQUIRE);
+    if (p_ring->SQ_Entries - used >= nbr) {
+        return (DEF_YES);
+    }
+                                                                /* See Note #1.                                         */
+    (void)SMTPc_TransportUring_Enter(0u, SMTPc_TRANSPORT_TIMEOUT_NO_BLOCK);
+
+    used   =  p_ring->SQ_Tail - __atomic_load_n(p_ring->SQ_HeadPtr, __ATOMIC_ACQUIRE);
+    if (p_ring->SQ_Entries - used >= nbr) {
+        return (DEF_YES);
+    }
+
+    return (DEF_NO);
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportUring_SQE_Get()
+*
+* Description : Get the next entry of the submission queue, reserved by SMTPc_TransportUring_SQ_Reserve(),
+*               & initialize it for an operation of a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               op              Operation (SMTPc_TRANSPORT_URING_OP_xxx), set in progress.
+*
+* Return(s)   : Pointer to the entry.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : (1) Receptions read into the registered buffers (see 'SMTPc_TransportUring_RxPrep()').
+*********************************************************************************************************
+*/
+
+static  struct  io_uring_sqe  *SMTPc_TransportUring_SQE_Get (SMTPc_TRANSPORT_URING_CONN  *p_conn,
+                                                             CPU_INT08U                   op)
+{
+    SMTPc_TRANSPORT_URING_RING  *p_ring;
+    struct  io_uring_sqe        *p_sqe;
+    CPU_INT32U                   ix;
+
+
+    p_ring = &SMTPc_TransportUring_Ring;
+    ix     =  p_ring->SQ_Tail & p_ring->SQ_Mask;
+    p_sqe  = &p_ring->SQE_Tbl[ix];
+    memset(p_sqe, 0, sizeof(*p_sqe));
+    p_ring->SQ_ArrayPtr[ix] = ix;
+    p_ring->SQ_Tail++;
+    switch (op) {
+        case SMTPc_TRANSPORT_URING_OP_CONN:
+             p_sqe->opcode = IORING_OP_CONNECT;
+             break;
+
+        case SMTPc_TRANSPORT_URING_OP_TX:
+             p_sqe->opcode = IORING_OP_SEND;
+             break;
+
+        case SMTPc_TRANSPORT_URING_OP_RX:
+             p_sqe->opcode = IORING_OP_READ_FIXED;              /* See Note #1.                                         */
+             break;
+
+        case SMTPc_TRANSPORT_URING_OP_CANCEL:
+        default:
+             p_sqe->opcode = IORING_OP_ASYNC_CANCEL;
+             break;
+    }
+    if (op != SMTPc_TRANSPORT_URING_OP_CANCEL) {
+        p_sqe->fd = p_conn->Fd;
+        DEF_BIT_SET(p_conn->OpPend, op);
+    } else {
+        p_sqe->fd = -1;
+    }
+    p_sqe->user_data = ((CPU_INT64U)(p_conn - SMTPc_TransportUring_ConnTbl) << SMTPc_TRANSPORT_URING_OP_SHIFT) | op;
+
+    return (p_sqe);
+}
+
+
+/*
+*********************************************************************************************************
+*                                   SMTPc_TransportUring_TS_Get_ms()
+*
+* Description : Get the time of the monotonic clock (see 'smtp-c.h  SMTPc_TRANSPORT_API  Note #1h').
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in milliseconds.
+*
+* Caller(s)   : SMTPc_TransportUring_OpWait(),
+*               SMTPc_TS_Get_ms(), through SMTPc_TransportAPI_Uring.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  SMTPc_TS_MS  SMTPc_TransportUring_TS_Get_ms (void)
+{
+    struct  timespec  ts;
+
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((SMTPc_TS_MS)(((CPU_INT64U)ts.tv_sec * 1000u) + ((CPU_INT64U)ts.tv_nsec / 1000000u)));
+}
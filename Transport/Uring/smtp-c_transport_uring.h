@@ -0,0 +1,111 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                   uC/SMTPc TRANSPORT : LINUX IO_URING
+*
+* Filename : smtp-c_transport_uring.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Transport of the sessions (see 'smtp-c.h  SMTPc_TRANSPORT_API') over a Linux io_uring
+*                instance (Linux 5.11 or later, built with the headers of Linux 6.0 or later), for hosts
+*                running many sessions from a single task :
+*
+*                    SMTPc_TransportUring_Init(1000u, &err);
+*                    SMTPc_TransportSet(&SMTPc_TransportAPI_Uring, &err);
+*
+*            (2) The operations are queued, & only submitted to the kernel when the transport waits : on a
+*                blocking operation, or in SMTPc_TransportUring_Wait().  The jobs of the asynchronous engine
+*                hence submit the operations of a whole round in a single system call :
+*
+*                    while (SMTPc_Poll(DEF_INT_16U_MAX_VAL) > 0u) {
+*                        (void)SMTPc_TransportUring_Wait(100u, &err);
+*                    }
+*
+*                All the jobs SHOULD be polled between two waits, & the wait SHOULD be shorter than
+*                SMTPc_CFG_ASYNC_TIMEOUT_MS, so that the jobs are expired on time.  The wait returns at once
+*                while a job may progress without I/O : when an operation of its connection completed since
+*                it last blocked.
+*
+*            (3) Each connection has a reception & a transmission buffer, all registered with the kernel.
+*                Data of SMTPc_TRANSPORT_URING_TX_ZC_LEN_MIN octets or more is sent from the transmission
+*                buffer without copy (IORING_OP_SEND_ZC, on Linux 6.0 or later); shorter data, such as the
+*                commands, is copied by the kernel.  A command transmitted while no reply is pending is
+*                linked to the reception of its reply, & a connection opened without blocking to the
+*                reception of the greeting, so that both are submitted at once.
+*
+*            (4) The transport functions & SMTPc_TransportUring_Wait() MUST be called from a single task.
+*
+*            (5) The socket identifiers are indexes of connections, not descriptors : the transport cannot
+*                be used by the epoll reactor (see 'Reactor/Epoll/smtp-c_reactor_epoll.h  Note #2').
+*
+*            (6) TLS is not supported : connecting with a secure configuration fails.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  SMTPc_TRANSPORT_URING_MODULE_PRESENT
+#define  SMTPc_TRANSPORT_URING_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+
+#include  <Source/smtp-c.h>
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+extern  const  SMTPc_TRANSPORT_API  SMTPc_TransportAPI_Uring;   /* Transport fncts (see Note #1).                       */
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void        SMTPc_TransportUring_Init(CPU_INT32U   conn_nbr_max,
+                                      SMTPc_ERR   *p_err);
+
+CPU_INT32U  SMTPc_TransportUring_Wait(CPU_INT32U   timeout_ms,
+                                      SMTPc_ERR   *p_err);
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of smtp-c transport uring module include.        */
@@ -0,0 +1,103 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                    CPU CONFIGURATION FILE
+*
+*                                          LINUX HOST
+*
+* Filename : cpu_cfg.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Configuration of uC/CPU for its POSIX port ('uC-CPU/Posix/GNU'), used by the host builds of
+*                'bench/Makefile'.
+*********************************************************************************************************
+*/
+
+#ifndef  CPU_CFG_MODULE_PRESENT
+#define  CPU_CFG_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                       CPU NAME CONFIGURATION
+*********************************************************************************************************
+*/
+
+#define  CPU_CFG_NAME_EN                        DEF_DISABLED
+#define  CPU_CFG_NAME_SIZE                                16
+
+
+/*
+*********************************************************************************************************
+*                                     CPU TIMESTAMP CONFIGURATION
+*
+* Note(s) : (1) The 64-bit timestamp measures the latencies & the recovery times of the mock server (see
+*               'smtp-c_transport_mock.c  SMTPc_TransportMock_LatRec()') : it does not wrap during a run.
+*
+*           (2) The POSIX port reads CLOCK_MONOTONIC, in nanoseconds : the timestamp timer MUST be 64-bit
+*               wide, so that CPU_TS_Get64() needs no periodic CPU_TS_Update().
+*********************************************************************************************************
+*/
+
+#define  CPU_CFG_TS_32_EN                       DEF_ENABLED
+#define  CPU_CFG_TS_64_EN                       DEF_ENABLED     /* See Note #1.                                         */
+                                                                /* See Note #2.                                         */
+#define  CPU_CFG_TS_TMR_SIZE                    CPU_WORD_SIZE_64
+
+
+/*
+*********************************************************************************************************
+*                        CPU INTERRUPTS DISABLED TIME MEASUREMENT CONFIGURATION
+*********************************************************************************************************
+*/
+
+#if 0
+#define  CPU_CFG_INT_DIS_MEAS_EN
+#endif
+#define  CPU_CFG_INT_DIS_MEAS_OVRHD_NBR                    1u
+
+
+/*
+*********************************************************************************************************
+*                                 CPU COUNT ZEROS CONFIGURATION
+*********************************************************************************************************
+*/
+
+#if 0
+#define  CPU_CFG_LEAD_ZEROS_ASM_PRESENT
+#define  CPU_CFG_TRAIL_ZEROS_ASM_PRESENT
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                   CACHE MANAGEMENT CONFIGURATION
+*********************************************************************************************************
+*/
+
+#define  CPU_CFG_CACHE_MGMT_EN                  DEF_DISABLED
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of CPU cfg module include.                       */
@@ -0,0 +1,62 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                  CUSTOM LIBRARY CONFIGURATION FILE
+*
+*                                             LINUX HOST
+*
+* Filename : lib_cfg.h
+* Version  : V2.01.01
+*********************************************************************************************************
+*/
+
+#ifndef  LIB_CFG_MODULE_PRESENT
+#define  LIB_CFG_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                 MEMORY LIBRARY CONFIGURATION
+*********************************************************************************************************
+*/
+
+#define  LIB_MEM_CFG_ARG_CHK_EXT_EN             DEF_ENABLED
+#define  LIB_MEM_CFG_OPTIMIZE_ASM_EN            DEF_DISABLED
+#define  LIB_MEM_CFG_DBG_INFO_EN                DEF_DISABLED
+#define  LIB_MEM_CFG_HEAP_SIZE                       8388608u   /* Heap of Mem_SegAlloc(), holding the mock conns.      */
+#define  LIB_MEM_CFG_HEAP_PADDING_ALIGN            LIB_MEM_PADDING_ALIGN_NONE
+
+
+/*
+*********************************************************************************************************
+*                                 STRING LIBRARY CONFIGURATION
+*********************************************************************************************************
+*/
+
+#define  LIB_STR_CFG_FP_EN                      DEF_DISABLED
+#define  LIB_STR_CFG_FP_MAX_NBR_DIG_SIG         LIB_STR_FP_MAX_NBR_DIG_SIG_DFLT
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of lib cfg module include.                       */
@@ -0,0 +1,650 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                 uC/SMTPc BASE64 ENCODER BENCHMARK
+*
+* Filename : bench_b64.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Linux host program measuring the throughput of the base64 encoder of the client (see
+*                'smtp-c.c  SMTPc_B64Enc()'), in MB/s of input octets, against the encoder it replaced :
+*
+*                (a) "client_<kernel>" renders a message holding an attachment of random octets with
+*                    SMTPc_RenderMsg(), i.e. encodes it into lines of 76 characters through the path used
+*                    to send it, with each kernel compiled & supported by the CPU in turn (see 'smtp-c.c
+*                    SMTPc_B64EncSet()').  The program is built twice (see 'Makefile') : 'bench_b64' with
+*                    the table of character pairs (SMTPc_CFG_B64_PAIR_TBL_EN), 'bench_b64_tbl64' with the
+*                    table of 64 characters, which is the encoder the attachments used before; the table
+*                    is used by the scalar kernel & for the groups the SIMD kernels leave to it.
+*
+*                (b) "netbase64" encodes the same octets with NetBase64_Encode(), the encoder of uC/TCP-IP
+*                    AUTH used before, by pieces of at most BENCH_NET_B64_IN_LEN octets since its lengths
+*                    are 16-bit.  Without uC/TCP-IP (SMTPc_CFG_TRANSPORT_NET_EN disabled), the same
+*                    algorithm is run by BenchNetB64Enc() : 4 lookups per group, no line wrapping.
+*
+*            (2) The encoders are run in turn, for at least BENCH_DURATION_MIN_NS; the best & median runs of
+*                each are reported, with the median of the ratios of the time of "netbase64" to the time of
+*                the encoder of each turn, which the drift of the clock of the CPU affects less.  The
+*                results are written to '<dir>/<name>.csv' & '<dir>/<name>.json', <name> being the name of
+*                the program, "results" by default :
+*
+*                    bench_b64 [-o <dir>]
+*
+*            (3) The message rendered with each SIMD kernel is checked against the one rendered with the
+*                scalar kernel, apart from the MIME boundary, which varies from one message to the next.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  _GNU_SOURCE
+
+#include  <errno.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <unistd.h>
+#include  <sys/stat.h>
+
+#include  <cpu.h>
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+
+#include  <Source/smtp-c.h>
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+#include  <Source/net_base64.h>
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  BENCH_DATA_LEN_MAX                      (8u << 20)     /* Max len of the data encoded.                         */
+#define  BENCH_BUF_LEN        (((BENCH_DATA_LEN_MAX / 57u) + 1u) * 78u + 4096u)
+#define  BENCH_RUN_NBR_MAX                              256u    /* Max nbr of runs of a measure ...                     */
+#define  BENCH_DURATION_MIN_NS                    500000000u    /* ... lasting at least this time (see Note #2).        */
+
+#define  BENCH_NET_B64_IN_LEN                         49146u    /* Max len encoded at once by NetBase64_Encode().       */
+
+#define  BENCH_ENC_SCALAR                                 0u    /* Encoders, the client ones first.                     */
+#define  BENCH_ENC_SSE2                                   1u
+#define  BENCH_ENC_AVX2                                   2u
+#define  BENCH_ENC_NEON                                   3u
+#define  BENCH_ENC_NET                                    4u
+#define  BENCH_ENC_NBR                                    5u
+
+#define  BENCH_BOUNDARY_PREFIX                  "=_SMTPc_"      /* See Note #3.                                         */
+#define  BENCH_BOUNDARY_LEN                               16u
+
+#if (SMTPc_CFG_B64_PAIR_TBL_EN == DEF_ENABLED)
+#define  BENCH_CLIENT_TBL_NAME                  "pair"
+#else
+#define  BENCH_CLIENT_TBL_NAME                  "tbl64"
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  CPU_INT32U   BenchDataLenTbl[] = { 65536u, 1048576u, BENCH_DATA_LEN_MAX };
+
+static  const  char        *BenchEncNameTbl[]   = { "client_scalar", "client_sse2", "client_avx2", "client_neon",
+                                                  "netbase64" };
+
+static  const  CPU_INT08U   BenchEncKernelTbl[] = { SMTPc_B64_ENC_SCALAR, SMTPc_B64_ENC_SSE2, SMTPc_B64_ENC_AVX2,
+                                                  SMTPc_B64_ENC_NEON };
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN != DEF_ENABLED)
+static  const  CPU_CHAR     BenchNetB64Tbl[]  = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  SMTPc_SESSION  BenchSess;
+static  SMTPc_MSG      BenchMsg;
+static  SMTPc_ATTACH   BenchAttach;
+static  SMTPc_MBOX     BenchFrom;
+static  SMTPc_MBOX     BenchTo;
+
+static  CPU_BOOLEAN    BenchEncAvailTbl[BENCH_ENC_NBR];         /* Encoders compiled & supported by the CPU.            */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U   BenchTS_Get_ns   (void);
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN != DEF_ENABLED)
+static  CPU_INT32U   BenchNetB64Enc   (const  CPU_INT08U  *p_src,
+                                       CPU_INT32U          len,
+                                       CPU_CHAR           *p_dest);
+#endif
+
+static  CPU_INT64U   BenchEncRun      (CPU_INT08U          enc,
+                                       CPU_INT08U         *p_data,
+                                       CPU_INT32U          len,
+                                       CPU_CHAR           *p_buf,
+                                       CPU_INT32U         *p_out_len);
+
+static  void         BenchBoundaryClr (CPU_CHAR           *p_buf,
+                                       CPU_INT32U          len);
+
+static  int          BenchTimeCmp     (const  void        *p_a,
+                                       const  void        *p_b);
+
+static  int          BenchRatioCmp    (const  void        *p_a,
+                                       const  void        *p_b);
+
+
+/*
+*********************************************************************************************************
+*                                               main()
+*
+* Description : Measure the encoders on every data length & write the results (see Note #2).
+*
+* Argument(s) : argc            Number of arguments.
+*
+*               argv            Arguments.
+*
+* Return(s)   : 0, if NO error(s).
+*
+*               1, otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+int  main (int    argc,
+           char  *argv[])
+{
+    const  char  *p_dir;
+    const  char  *p_name;
+    CPU_INT08U   *p_data;
+    CPU_CHAR     *p_buf;
+    CPU_CHAR     *p_ref;
+    CPU_INT64U    time_tbl[BENCH_ENC_NBR][BENCH_RUN_NBR_MAX];
+    double        ratio_tbl[BENCH_ENC_NET][BENCH_RUN_NBR_MAX];
+    CPU_INT64U    total;
+    CPU_INT32U    run_nbr;
+    CPU_INT32U    out_len[BENCH_ENC_NBR];
+    CPU_INT32U    len;
+    CPU_INT32U    i;
+    CPU_INT08U    enc;
+    double        best;
+    double        median;
+    double        ratio;
+    FILE         *p_csv;
+    FILE         *p_json;
+    char          path[512];
+    int           opt;
+    SMTPc_ERR     err;
+
+
+    p_dir = "results";
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        switch (opt) {
+            case 'o':
+                 p_dir = optarg;
+                 break;
+
+            default:
+                 fprintf(stderr, "usage: %s [-o <dir>]\n", argv[0]);
+                 return (1);
+        }
+    }
+    p_name = strrchr(argv[0], '/');
+    p_name = (p_name != NULL) ? (p_name + 1) : argv[0];
+
+    CPU_Init();
+    Mem_Init();
+
+    p_data = malloc(BENCH_DATA_LEN_MAX);
+    p_buf  = malloc(BENCH_BUF_LEN);
+    p_ref  = malloc(BENCH_BUF_LEN);
+    if ((p_data == NULL) || (p_buf == NULL) || (p_ref == NULL)) {
+        return (1);
+    }
+    srand(1u);
+    for (i = 0u; i < BENCH_DATA_LEN_MAX; i++) {
+        p_data[i] = (CPU_INT08U)rand();
+    }
+    SMTPc_SetMbox(&BenchFrom, "Bench", "bench@example.com", &err);
+    SMTPc_SetMbox(&BenchTo,   "",      "rcpt@example.com",  &err);
+
+                                                                /* Find the encoders available on this host.            */
+    for (enc = BENCH_ENC_SCALAR; enc <= BENCH_ENC_NET; enc++) {
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)
+        if (enc != BENCH_ENC_NET) {
+            SMTPc_B64EncSet(BenchEncKernelTbl[enc], &err);
+            BenchEncAvailTbl[enc] = (err == SMTPc_ERR_NONE) ? DEF_YES : DEF_NO;
+        } else {
+            BenchEncAvailTbl[enc] = DEF_YES;
+        }
+#else
+        BenchEncAvailTbl[enc] = ((enc == BENCH_ENC_SCALAR) || (enc == BENCH_ENC_NET)) ? DEF_YES : DEF_NO;
+#endif
+    }
+
+    if ((mkdir(p_dir, 0755) != 0) && (errno != EEXIST)) {
+        perror(p_dir);
+        return (1);
+    }
+    snprintf(path, sizeof(path), "%s/%s.csv", p_dir, p_name);
+    p_csv = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s/%s.json", p_dir, p_name);
+    p_json = fopen(path, "w");
+    if ((p_csv == NULL) || (p_json == NULL)) {
+        perror(path);
+        return (1);
+    }
+    fprintf(p_csv, "encoder,client_tbl,in_octets,out_octets,runs,best_mb_per_s,median_mb_per_s,speedup\n");
+    fprintf(p_json, "{\n  \"client_tbl\": \"%s\",\n  \"netbase64\": \"%s\",\n  \"results\": [\n",
+            BENCH_CLIENT_TBL_NAME,
+            (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED) ? "uC/TCP-IP" : "BenchNetB64Enc");
+
+    printf("%-13s %-6s %9s %9s %6s %10s %10s %8s\n",
+           "encoder", "tbl", "in", "out", "runs", "best MB/s", "med MB/s", "speedup");
+    for (i = 0u; i < (sizeof(BenchDataLenTbl) / sizeof(BenchDataLenTbl[0])); i++) {
+        len = BenchDataLenTbl[i];
+                                                                /* Check the SIMD kernels against the scalar one ...    */
+                                                                /* ... (see Note #3).                                   */
+        if (BenchEncRun(BENCH_ENC_SCALAR, p_data, len, p_ref, &out_len[BENCH_ENC_SCALAR]) == 0u) {
+            fprintf(stderr, "%s: encoding failed\n", BenchEncNameTbl[BENCH_ENC_SCALAR]);
+            return (1);
+        }
+        BenchBoundaryClr(p_ref, out_len[BENCH_ENC_SCALAR]);
+        for (enc = BENCH_ENC_SSE2; enc < BENCH_ENC_NET; enc++) {
+            if (BenchEncAvailTbl[enc] != DEF_YES) {
+                continue;
+            }
+            if (BenchEncRun(enc, p_data, len, p_buf, &out_len[enc]) == 0u) {
+                fprintf(stderr, "%s: encoding failed\n", BenchEncNameTbl[enc]);
+                return (1);
+            }
+            BenchBoundaryClr(p_buf, out_len[enc]);
+            if ((out_len[enc] != out_len[BENCH_ENC_SCALAR]) ||
+                (memcmp(p_buf, p_ref, out_len[enc]) != 0)) {
+                fprintf(stderr, "%s: output differs from %s, %u octets\n",
+                        BenchEncNameTbl[enc], BenchEncNameTbl[BENCH_ENC_SCALAR], (unsigned)len);
+                return (1);
+            }
+        }
+
+        run_nbr = 0u;
+        total   = 0u;
+        while ((run_nbr < BENCH_RUN_NBR_MAX) &&                 /* See Note #2.                                         */
+               (total   < BENCH_DURATION_MIN_NS)) {
+            for (enc = BENCH_ENC_SCALAR; enc <= BENCH_ENC_NET; enc++) {
+                if (BenchEncAvailTbl[enc] != DEF_YES) {
+                    continue;
+                }
+                time_tbl[enc][run_nbr] = BenchEncRun(enc, p_data, len, p_buf, &out_len[enc]);
+                if (time_tbl[enc][run_nbr] == 0u) {
+                    fprintf(stderr, "%s: encoding failed\n", BenchEncNameTbl[enc]);
+                    return (1);
+                }
+                total += time_tbl[enc][run_nbr];
+            }
+            for (enc = BENCH_ENC_SCALAR; enc < BENCH_ENC_NET; enc++) {
+                if (BenchEncAvailTbl[enc] == DEF_YES) {
+                    ratio_tbl[enc][run_nbr] = (double)time_tbl[BENCH_ENC_NET][run_nbr] / (double)time_tbl[enc][run_nbr];
+                }
+            }
+            run_nbr++;
+        }
+
+        for (enc = BENCH_ENC_SCALAR; enc <= BENCH_ENC_NET; enc++) {
+            if (BenchEncAvailTbl[enc] != DEF_YES) {
+                continue;
+            }
+            qsort(time_tbl[enc], run_nbr, sizeof(CPU_INT64U), BenchTimeCmp);
+            best   = ((double)len * 1000.0) / (double)time_tbl[enc][0];
+            median = ((double)len * 1000.0) / (double)time_tbl[enc][run_nbr / 2u];
+            ratio  = 1.0;
+            if (enc != BENCH_ENC_NET) {
+                qsort(ratio_tbl[enc], run_nbr, sizeof(double), BenchRatioCmp);
+                ratio = ratio_tbl[enc][run_nbr / 2u];
+            }
+
+            printf("%-13s %-6s %9u %9u %6u %10.1f %10.1f %8.3f\n",
+                   BenchEncNameTbl[enc], BENCH_CLIENT_TBL_NAME, (unsigned)len, (unsigned)out_len[enc],
+                   (unsigned)run_nbr, best, median, ratio);
+            fprintf(p_csv, "%s,%s,%u,%u,%u,%.1f,%.1f,%.3f\n",
+                    BenchEncNameTbl[enc], BENCH_CLIENT_TBL_NAME, (unsigned)len, (unsigned)out_len[enc],
+                    (unsigned)run_nbr, best, median, ratio);
+            fprintf(p_json, "    { \"encoder\": \"%s\", \"in_octets\": %u, \"out_octets\": %u, \"runs\": %u,"
+                            " \"best_mb_per_s\": %.1f, \"median_mb_per_s\": %.1f, \"speedup\": %.3f }%s\n",
+                    BenchEncNameTbl[enc], (unsigned)len, (unsigned)out_len[enc], (unsigned)run_nbr, best, median, ratio,
+                    ((i + 1u < (sizeof(BenchDataLenTbl) / sizeof(BenchDataLenTbl[0]))) ||
+                     (enc != BENCH_ENC_NET)) ? "," : "");
+        }
+    }
+    fprintf(p_json, "  ]\n}\n");
+
+    fclose(p_csv);
+    fclose(p_json);
+
+    return (0);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          BenchTS_Get_ns()
+*
+* Description : Get the time of the monotonic clock.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in nanoseconds.
+*
+* Caller(s)   : BenchEncRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchTS_Get_ns (void)
+{
+    struct  timespec  ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((CPU_INT64U)ts.tv_sec * 1000000000u) + (CPU_INT64U)ts.tv_nsec);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchNetB64Enc()
+*
+* Description : Encode data in base64 as NetBase64_Encode() does (see Note #1b).
+*
+* Argument(s) : p_src           Pointer to the data.
+*
+*               len             Length of the data.
+*
+*               p_dest          Pointer to the buffer receiving the encoded data.
+*
+* Return(s)   : Number of characters written, NOT including the NULL terminator.
+*
+* Caller(s)   : BenchEncRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+#if (SMTPc_CFG_TRANSPORT_NET_EN != DEF_ENABLED)
+static  CPU_INT32U  BenchNetB64Enc (const  CPU_INT08U  *p_src,
+                                    CPU_INT32U          len,
+                                    CPU_CHAR           *p_dest)
+{
+    CPU_CHAR    *p_out;
+    CPU_INT32U   i;
+
+
+    p_out = p_dest;
+    for (i = 0u; (i + 3u) <= len; i += 3u) {
+       *p_out++ = BenchNetB64Tbl[  p_src[i]                >> 2];
+       *p_out++ = BenchNetB64Tbl[((p_src[i]      & 0x03u) << 4) | (p_src[i + 1u] >> 4)];
+       *p_out++ = BenchNetB64Tbl[((p_src[i + 1u] & 0x0Fu) << 2) | (p_src[i + 2u] >> 6)];
+       *p_out++ = BenchNetB64Tbl[  p_src[i + 2u] & 0x3Fu];
+    }
+    if (i < len) {                                              /* Pad the last, partial group.                         */
+       *p_out++ = BenchNetB64Tbl[p_src[i] >> 2];
+        if ((i + 1u) < len) {
+           *p_out++ = BenchNetB64Tbl[((p_src[i]      & 0x03u) << 4) | (p_src[i + 1u] >> 4)];
+           *p_out++ = BenchNetB64Tbl[ (p_src[i + 1u] & 0x0Fu) << 2];
+        } else {
+           *p_out++ = BenchNetB64Tbl[ (p_src[i]      & 0x03u) << 4];
+           *p_out++ = '=';
+        }
+       *p_out++ = '=';
+    }
+   *p_out = '\0';
+
+    return ((CPU_INT32U)(p_out - p_dest));
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            BenchEncRun()
+*
+* Description : Encode data once.
+*
+* Argument(s) : enc             Encoder : BENCH_ENC_<kernel> or BENCH_ENC_NET.
+*
+*               p_data          Pointer to the data.
+*
+*               len             Length of the data.
+*
+*               p_buf           Pointer to the buffer receiving the encoded data, of BENCH_BUF_LEN octets.
+*
+*               p_out_len       Pointer to the variable that will receive the length of the output.
+*
+* Return(s)   : Time taken, in nanoseconds,
+*
+*               0, if the data could not be encoded.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : (1) The output of the client includes the headers of the message & of its MIME parts, a few
+*                   hundred octets.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchEncRun (CPU_INT08U   enc,
+                                 CPU_INT08U  *p_data,
+                                 CPU_INT32U   len,
+                                 CPU_CHAR    *p_buf,
+                                 CPU_INT32U  *p_out_len)
+{
+    CPU_INT64U  ts;
+    CPU_INT32U  ix;
+    CPU_INT32U  in_len;
+    CPU_INT32U  out_len;
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+    NET_ERR     net_err;
+#endif
+    SMTPc_ERR   err;
+
+
+    if (enc == BENCH_ENC_NET) {                                 /* See Note #1b.                                        */
+        out_len = 0u;
+        ts      = BenchTS_Get_ns();
+        for (ix = 0u; ix < len; ix += in_len) {
+            in_len = DEF_MIN(len - ix, BENCH_NET_B64_IN_LEN);
+#if (SMTPc_CFG_TRANSPORT_NET_EN == DEF_ENABLED)
+            NetBase64_Encode((CPU_CHAR *)&p_data[ix],
+                             (CPU_INT16U)in_len,
+                             &p_buf[out_len],
+                             (CPU_INT16U)(((in_len + 2u) / 3u) * 4u + 1u),
+                             &net_err);
+            if (net_err != NET_ERR_NONE) {
+                return (0u);
+            }
+            out_len += ((in_len + 2u) / 3u) * 4u;
+#else
+            out_len += BenchNetB64Enc(&p_data[ix], in_len, &p_buf[out_len]);
+#endif
+        }
+        ts         = BenchTS_Get_ns() - ts;
+       *p_out_len  = out_len;
+        return (DEF_MAX(ts, 1u));
+    }
+
+#if (SMTPc_CFG_B64_SIMD_EN == DEF_ENABLED)
+    SMTPc_B64EncSet(BenchEncKernelTbl[enc], &err);
+    if (err != SMTPc_ERR_NONE) {
+        return (0u);
+    }
+#endif
+    SMTPc_SetMsg(&BenchMsg, &err);
+    SMTPc_SetAttach(&BenchAttach, "data.bin", "", p_data, len, &err);
+    if (err != SMTPc_ERR_NONE) {
+        return (0u);
+    }
+    BenchMsg.From           = &BenchFrom;
+    BenchMsg.ToArray[0]     = &BenchTo;
+    BenchMsg.Subject        = "Benchmark";
+    BenchMsg.ContentBodyMsg = "";
+    BenchMsg.AttachArray[0] = &BenchAttach;
+
+    ts = BenchTS_Get_ns();
+    SMTPc_RenderMsg(&BenchSess, &BenchMsg, p_buf, BENCH_BUF_LEN, &err);
+    ts = BenchTS_Get_ns() - ts;
+    if (err != SMTPc_ERR_NONE) {
+        return (0u);
+    }
+   *p_out_len = BenchMsg.RenderLen;                             /* See Note #1.                                         */
+
+    return (DEF_MAX(ts, 1u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         BenchBoundaryClr()
+*
+* Description : Blank the MIME boundaries out of a rendered message (see Note #3).
+*
+* Argument(s) : p_buf           Pointer to the message.
+*
+*               len             Length of the message.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchBoundaryClr (CPU_CHAR    *p_buf,
+                                CPU_INT32U   len)
+{
+    CPU_INT32U  prefix_len;
+    CPU_INT32U  ix;
+
+
+    prefix_len = sizeof(BENCH_BOUNDARY_PREFIX) - 1u;
+    for (ix = 0u; (ix + BENCH_BOUNDARY_LEN) <= len; ix++) {
+        if (memcmp(&p_buf[ix], BENCH_BOUNDARY_PREFIX, prefix_len) == 0) {
+            Mem_Set(&p_buf[ix], '#', BENCH_BOUNDARY_LEN);
+            ix += BENCH_BOUNDARY_LEN - 1u;
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchTimeCmp()
+*
+* Description : Compare two times, for qsort().
+*
+* Argument(s) : p_a             Pointer to the first  time.
+*
+*               p_b             Pointer to the second time.
+*
+* Return(s)   : < 0, = 0 or > 0, as the first time is shorter, equal or longer.
+*
+* Caller(s)   : main(), through qsort().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  int  BenchTimeCmp (const  void  *p_a,
+                           const  void  *p_b)
+{
+    CPU_INT64U  a;
+    CPU_INT64U  b;
+
+
+    a = *(const CPU_INT64U *)p_a;
+    b = *(const CPU_INT64U *)p_b;
+
+    return ((a > b) - (a < b));
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchRatioCmp()
+*
+* Description : Compare two ratios, for qsort().
+*
+* Argument(s) : p_a             Pointer to the first  ratio.
+*
+*               p_b             Pointer to the second ratio.
+*
+* Return(s)   : < 0, = 0 or > 0, as the first ratio is lower, equal or higher.
+*
+* Caller(s)   : main(), through qsort().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  int  BenchRatioCmp (const  void  *p_a,
+                            const  void  *p_b)
+{
+    double  a;
+    double  b;
+
+
+    a = *(const double *)p_a;
+    b = *(const double *)p_b;
+
+    return ((a > b) - (a < b));
+}
@@ -0,0 +1,488 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                              uC/SMTPc TRANSPARENCY ENCODER THROUGHPUT BENCHMARK
+*
+* Filename : bench_enc.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Linux host program measuring the throughput of the transparency encoder of the message
+*                body (dot-stuffing & line ending normalization, see 'smtp-c.c  SMTPc_TxContent()'), in
+*                GB/s of body octets.  The bodies are rendered by SMTPc_RenderMsg(), which runs the path
+*                used to send a message without transmitting it.
+*
+*            (2) Each body is also encoded by a reference encoder examining one octet at a time, as the
+*                baseline of the word-at-a-time scan of the client (see 'smtp-c.c  SMTPc_EncScanLF()').
+*
+*            (3) Each measure is repeated for at least BENCH_DURATION_MIN_NS; the best & median runs are
+*                reported.  The results are written to '<dir>/bench_enc.csv' & '<dir>/bench_enc.json',
+*                "results" by default :
+*
+*                    bench_enc [-o <dir>]
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  _GNU_SOURCE
+
+#include  <errno.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <unistd.h>
+#include  <sys/stat.h>
+
+#include  <cpu.h>
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+
+#include  <Source/smtp-c.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  BENCH_BODY_LEN                          (8u << 20)     /* Len of the bodies encoded.                           */
+#define  BENCH_BUF_LEN              ((BENCH_BODY_LEN * 2u) + 4096u)
+#define  BENCH_RUN_NBR_MAX                              256u    /* Max nbr of runs of a measure ...                     */
+#define  BENCH_DURATION_MIN_NS                    500000000u    /* ... lasting at least this time (see Note #3).        */
+
+#define  BENCH_ENC_CLIENT                                 0u
+#define  BENCH_ENC_REF                                    1u
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  bench_body {
+    const  char  *NamePtr;                                      /* Name of the body ...                                 */
+    CPU_INT32U    LineLen;                                      /* ... of lines of this len, line ending included ...   */
+    CPU_BOOLEAN   LF_Only;                                      /* ... ending with a bare LF instead of CRLF ...        */
+    CPU_INT32U    DotPeriod;                                    /* ... & starting with a dot once every this nbr of ... */
+} BENCH_BODY;                                                   /* ... lines, 0 for none.                               */
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  BENCH_BODY  BenchBodyTbl[] = {
+    { "crlf_78",   78u, DEF_NO,  0u },                          /* Already encoded, sent as is.                         */
+    { "lf_78",     78u, DEF_YES, 0u },                          /* Every line ending converted.                         */
+    { "dots_78",   78u, DEF_NO,  4u },                          /* One line in 4 dot-stuffed.                           */
+    { "crlf_998", 998u, DEF_NO,  0u },                          /* Longest lines allowed (see RFC #5322).               */
+    { "lf_998",   998u, DEF_YES, 0u },
+};
+
+static  const  char  *BenchEncNameTbl[] = { "client", "reference" };
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  SMTPc_SESSION  BenchSess;
+static  SMTPc_MSG      BenchMsg;
+static  SMTPc_MBOX     BenchFrom;
+static  SMTPc_MBOX     BenchTo;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U   BenchTS_Get_ns   (void);
+
+static  void         BenchBodyBuild   (const  BENCH_BODY  *p_body,
+                                       CPU_CHAR           *p_buf);
+
+static  CPU_INT32U   BenchEncRef      (const  CPU_CHAR    *p_src,
+                                       CPU_INT32U          len,
+                                       CPU_CHAR           *p_dest);
+
+static  CPU_INT64U   BenchEncRun      (CPU_INT08U          enc,
+                                       CPU_CHAR           *p_body,
+                                       CPU_CHAR           *p_buf,
+                                       CPU_INT32U         *p_len);
+
+static  int          BenchTimeCmp     (const  void        *p_a,
+                                       const  void        *p_b);
+
+
+/*
+*********************************************************************************************************
+*                                               main()
+*
+* Description : Measure the encoders on every body & write the results (see Note #3).
+*
+* Argument(s) : argc            Number of arguments.
+*
+*               argv            Arguments.
+*
+* Return(s)   : 0, if NO error(s).
+*
+*               1, otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+int  main (int    argc,
+           char  *argv[])
+{
+    const  char  *p_dir;
+    CPU_CHAR     *p_body;
+    CPU_CHAR     *p_buf;
+    CPU_INT64U    time_tbl[BENCH_RUN_NBR_MAX];
+    CPU_INT64U    total;
+    CPU_INT32U    run_nbr;
+    CPU_INT32U    out_len;
+    CPU_INT32U    i;
+    CPU_INT08U    enc;
+    double        best;
+    double        median;
+    FILE         *p_csv;
+    FILE         *p_json;
+    char          path[512];
+    int           opt;
+    SMTPc_ERR     err;
+
+
+    p_dir = "results";
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        switch (opt) {
+            case 'o':
+                 p_dir = optarg;
+                 break;
+
+            default:
+                 fprintf(stderr, "usage: %s [-o <dir>]\n", argv[0]);
+                 return (1);
+        }
+    }
+
+    CPU_Init();
+    Mem_Init();
+
+    p_body = malloc(BENCH_BODY_LEN);
+    p_buf  = malloc(BENCH_BUF_LEN);
+    if ((p_body == NULL) || (p_buf == NULL)) {
+        return (1);
+    }
+    SMTPc_SetMbox(&BenchFrom, "Bench", "bench@example.com", &err);
+    SMTPc_SetMbox(&BenchTo,   "",      "rcpt@example.com",  &err);
+
+    if ((mkdir(p_dir, 0755) != 0) && (errno != EEXIST)) {
+        perror(p_dir);
+        return (1);
+    }
+    snprintf(path, sizeof(path), "%s/bench_enc.csv", p_dir);
+    p_csv = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s/bench_enc.json", p_dir);
+    p_json = fopen(path, "w");
+    if ((p_csv == NULL) || (p_json == NULL)) {
+        perror(path);
+        return (1);
+    }
+    fprintf(p_csv, "body,encoder,body_octets,out_octets,runs,best_gb_per_s,median_gb_per_s\n");
+    fprintf(p_json, "{\n  \"word_octets\": %u,\n  \"results\": [\n", (unsigned)sizeof(CPU_DATA));
+
+    printf("%-10s %-10s %10s %6s %10s %10s\n", "body", "encoder", "out", "runs", "best GB/s", "med GB/s");
+    for (i = 0u; i < (sizeof(BenchBodyTbl) / sizeof(BenchBodyTbl[0])); i++) {
+        BenchBodyBuild(&BenchBodyTbl[i], p_body);
+
+        for (enc = BENCH_ENC_CLIENT; enc <= BENCH_ENC_REF; enc++) {
+            run_nbr = 0u;
+            total   = 0u;
+            while ((run_nbr < BENCH_RUN_NBR_MAX) &&
+                   (total   < BENCH_DURATION_MIN_NS)) {
+                time_tbl[run_nbr] = BenchEncRun(enc, p_body, p_buf, &out_len);
+                if (time_tbl[run_nbr] == 0u) {
+                    fprintf(stderr, "%s: render failed\n", BenchBodyTbl[i].NamePtr);
+                    return (1);
+                }
+                total += time_tbl[run_nbr];
+                run_nbr++;
+            }
+            qsort(time_tbl, run_nbr, sizeof(CPU_INT64U), BenchTimeCmp);
+            best   = (double)BENCH_BODY_LEN / (double)time_tbl[0];
+            median = (double)BENCH_BODY_LEN / (double)time_tbl[run_nbr / 2u];
+
+            printf("%-10s %-10s %10u %6u %10.3f %10.3f\n",
+                   BenchBodyTbl[i].NamePtr, BenchEncNameTbl[enc], (unsigned)out_len, (unsigned)run_nbr, best, median);
+            fprintf(p_csv, "%s,%s,%u,%u,%u,%.3f,%.3f\n",
+                    BenchBodyTbl[i].NamePtr, BenchEncNameTbl[enc], (unsigned)BENCH_BODY_LEN, (unsigned)out_len,
+                    (unsigned)run_nbr, best, median);
+            fprintf(p_json, "    { \"body\": \"%s\", \"encoder\": \"%s\", \"body_octets\": %u, \"out_octets\": %u,"
+                            " \"runs\": %u, \"best_gb_per_s\": %.3f, \"median_gb_per_s\": %.3f }%s\n",
+                    BenchBodyTbl[i].NamePtr, BenchEncNameTbl[enc], (unsigned)BENCH_BODY_LEN, (unsigned)out_len,
+                    (unsigned)run_nbr, best, median,
+                    ((i + 1u < (sizeof(BenchBodyTbl) / sizeof(BenchBodyTbl[0]))) || (enc != BENCH_ENC_REF)) ? "," : "");
+        }
+    }
+    fprintf(p_json, "  ]\n}\n");
+
+    fclose(p_csv);
+    fclose(p_json);
+
+    return (0);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          BenchTS_Get_ns()
+*
+* Description : Get the time of the monotonic clock.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in nanoseconds.
+*
+* Caller(s)   : BenchEncRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchTS_Get_ns (void)
+{
+    struct  timespec  ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((CPU_INT64U)ts.tv_sec * 1000000000u) + (CPU_INT64U)ts.tv_nsec);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchBodyBuild()
+*
+* Description : Build a body of text.
+*
+* Argument(s) : p_body          Pointer to the description of the body.
+*
+*               p_buf           Pointer to the buffer receiving the body, of BENCH_BODY_LEN octets.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchBodyBuild (const  BENCH_BODY  *p_body,
+                              CPU_CHAR           *p_buf)
+{
+    CPU_INT32U  line_ix;
+    CPU_INT32U  col;
+    CPU_INT32U  eol_len;
+    CPU_INT32U  i;
+
+
+    eol_len = (p_body->LF_Only == DEF_YES) ? 1u : 2u;
+    for (i = 0u; i < BENCH_BODY_LEN; i++) {
+        line_ix = i / p_body->LineLen;
+        col     = i % p_body->LineLen;
+        if (col == (p_body->LineLen - 1u)) {
+            p_buf[i] = ASCII_CHAR_LINE_FEED;
+        } else if ((col == (p_body->LineLen - 2u)) && (eol_len == 2u)) {
+            p_buf[i] = ASCII_CHAR_CARRIAGE_RETURN;
+        } else if ((col == 0u) && (p_body->DotPeriod != 0u) && ((line_ix % p_body->DotPeriod) == 0u)) {
+            p_buf[i] = ASCII_CHAR_FULL_STOP;
+        } else {
+            p_buf[i] = (CPU_CHAR)('a' + ((i * 7u) % 26u));
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            BenchEncRef()
+*
+* Description : Encode a body one octet at a time (see Note #2).
+*
+* Argument(s) : p_src           Pointer to the body.
+*
+*               len             Length of the body.
+*
+*               p_dest          Pointer to the buffer receiving the encoded body, of at least twice 'len'
+*                               octets.
+*
+* Return(s)   : Length of the encoded body.
+*
+* Caller(s)   : BenchEncRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  BenchEncRef (const  CPU_CHAR  *p_src,
+                                 CPU_INT32U        len,
+                                 CPU_CHAR         *p_dest)
+{
+    CPU_CHAR     *p_out;
+    CPU_CHAR      c;
+    CPU_BOOLEAN   bol;
+    CPU_BOOLEAN   cr;
+    CPU_INT32U    i;
+
+
+    p_out = p_dest;
+    bol   = DEF_YES;
+    cr    = DEF_NO;
+    for (i = 0u; i < len; i++) {
+        c = p_src[i];
+        if ((c == ASCII_CHAR_LINE_FEED) && (cr == DEF_NO)) {
+           *p_out++ = ASCII_CHAR_CARRIAGE_RETURN;
+        }
+        if ((c == ASCII_CHAR_FULL_STOP) && (bol == DEF_YES)) {
+           *p_out++ = ASCII_CHAR_FULL_STOP;
+        }
+       *p_out++ = c;
+        bol     = (c == ASCII_CHAR_LINE_FEED)       ? DEF_YES : DEF_NO;
+        cr      = (c == ASCII_CHAR_CARRIAGE_RETURN) ? DEF_YES : DEF_NO;
+    }
+
+    return ((CPU_INT32U)(p_out - p_dest));
+}
+
+
+/*
+*********************************************************************************************************
+*                                            BenchEncRun()
+*
+* Description : Encode a body once.
+*
+* Argument(s) : enc             Encoder : BENCH_ENC_CLIENT or BENCH_ENC_REF.
+*
+*               p_body          Pointer to the body, of BENCH_BODY_LEN octets.
+*
+*               p_buf           Pointer to the buffer receiving the encoded body, of BENCH_BUF_LEN octets.
+*
+*               p_len           Pointer to the variable that will receive the length of the output.
+*
+* Return(s)   : Time taken, in nanoseconds,
+*
+*               0, if the message could not be rendered.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : (1) The output of the client includes the headers of the message, a few hundred octets.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchEncRun (CPU_INT08U   enc,
+                                 CPU_CHAR    *p_body,
+                                 CPU_CHAR    *p_buf,
+                                 CPU_INT32U  *p_len)
+{
+    CPU_INT64U  ts;
+    SMTPc_ERR   err;
+
+
+    if (enc == BENCH_ENC_REF) {
+        ts     = BenchTS_Get_ns();
+       *p_len  = BenchEncRef(p_body, BENCH_BODY_LEN, p_buf);
+        ts     = BenchTS_Get_ns() - ts;
+        return (DEF_MAX(ts, 1u));
+    }
+
+    SMTPc_SetMsg(&BenchMsg, &err);
+    BenchMsg.From              = &BenchFrom;
+    BenchMsg.ToArray[0]        = &BenchTo;
+    BenchMsg.Subject           = "Benchmark";
+    BenchMsg.ContentBodyMsg    = p_body;
+    BenchMsg.ContentBodyMsgLen = BENCH_BODY_LEN;
+
+    ts = BenchTS_Get_ns();
+    SMTPc_RenderMsg(&BenchSess, &BenchMsg, p_buf, BENCH_BUF_LEN, &err);
+    ts = BenchTS_Get_ns() - ts;
+    if (err != SMTPc_ERR_NONE) {
+        return (0u);
+    }
+   *p_len = BenchMsg.RenderLen;                                 /* See Note #1.                                         */
+
+    return (DEF_MAX(ts, 1u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchTimeCmp()
+*
+* Description : Compare two times, for qsort().
+*
+* Argument(s) : p_a             Pointer to the first  time.
+*
+*               p_b             Pointer to the second time.
+*
+* Return(s)   : < 0, = 0 or > 0, as the first time is shorter, equal or longer.
+*
+* Caller(s)   : main(), through qsort().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  int  BenchTimeCmp (const  void  *p_a,
+                           const  void  *p_b)
+{
+    CPU_INT64U  a;
+    CPU_INT64U  b;
+
+
+    a = *(const CPU_INT64U *)p_a;
+    b = *(const CPU_INT64U *)p_b;
+
+    return ((a > b) - (a < b));
+}
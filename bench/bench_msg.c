@@ -0,0 +1,812 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                   uC/SMTPc MESSAGE THROUGHPUT BENCHMARK
+*
+* Filename : bench_msg.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Linux host program measuring the cost of sending messages, without network, against the
+*                mock transport (see 'Transport/Mock/smtp-c_transport_mock.h  Note #1').  Every point of
+*                the sweep sends messages of one body size, to one number of recipients, from one number
+*                of threads; each thread holds its own session (see 'smtp-c.h  SMTP SESSION DATA TYPES
+*                Note #1') & sends its share of the messages on a single connection.
+*
+*            (2) For each point are reported :
+*
+*                (a) The messages & content octets accepted by the server per second of wall time.
+*
+*                (b) The exact 50th, 99th & 99.9th percentiles of the time SMTPc_SessionSendMsg() took,
+*                    from every sample, & those of the mock server (see 'smtp-c_transport_mock.h
+*                    DATA TYPES  Note #3') as a cross-check.
+*
+*                (c) The CPU cycles per message of the sending threads, from the cycle counter of the
+*                    kernel (perf_event_open()).  Where it is unavailable, the CPU time of the threads is
+*                    converted to cycles at the rate of the time stamp counter of the CPU, measured at start;
+*                    the source is reported in the 'cycle_src' column.
+*
+*            (3) The results are written to '<dir>/bench_msg.csv' & '<dir>/bench_msg.json', "results" by
+*                default :
+*
+*                    bench_msg [-o <dir>] [-q]
+*
+*                '-q' runs a shorter sweep.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  _GNU_SOURCE
+
+#include  <errno.h>
+#include  <pthread.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <unistd.h>
+#include  <sys/ioctl.h>
+#include  <sys/stat.h>
+#include  <sys/syscall.h>
+#include  <linux/perf_event.h>
+#if (defined(__x86_64__) || defined(__i386__))
+#include  <x86intrin.h>
+#endif
+
+#include  <cpu.h>
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+
+#include  <Source/smtp-c.h>
+#include  <Transport/Mock/smtp-c_transport_mock.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  BENCH_THREAD_NBR_MAX                            16u    /* Max nbr of sending threads.                          */
+#define  BENCH_OCTET_BUDGET                       (64u << 20)   /* Content octets sent per point ...                    */
+#define  BENCH_OCTET_BUDGET_QUICK                  (4u << 20)
+#define  BENCH_MSG_NBR_MIN                              256u    /* ... within these nbrs of msgs.                       */
+#define  BENCH_MSG_NBR_MAX                            20000u
+#define  BENCH_LINE_LEN                                  78u    /* Len of the body lines, CRLF included.                */
+
+#define  BENCH_CYCLE_SRC_NONE                             0u
+#define  BENCH_CYCLE_SRC_PERF                             1u
+#define  BENCH_CYCLE_SRC_TSC                              2u
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  bench_thread {
+    pthread_t       Thread;
+    CPU_INT32U      MsgNbr;                                     /* Nbr of msgs to send ...                              */
+    CPU_INT32U      RcptNbr;                                    /* ... to this nbr of rcpts.                            */
+    CPU_INT64U     *LatTbl;                                     /* Latency of each msg (ns).                            */
+    CPU_INT64U      Cycles;                                     /* Cycles spent sending the msgs.                       */
+    CPU_INT32U      FailCtr;                                    /* Nbr of msgs not sent.                                */
+    SMTPc_SESSION   Sess;
+    SMTPc_MSG       Msg;
+} BENCH_THREAD;
+
+
+typedef  struct  bench_result {
+    CPU_INT32U      BodyLen;
+    CPU_INT32U      RcptNbr;
+    CPU_INT32U      ThreadNbr;
+    CPU_INT32U      MsgNbr;
+    CPU_INT32U      FailCtr;
+    double          Elapsed_s;
+    double          MsgPerSec;
+    double          OctetPerSec;
+    double          P50_us;
+    double          P99_us;
+    double          P999_us;
+    double          Max_us;
+    CPU_INT32U      SrvP50_us;
+    CPU_INT32U      SrvP99_us;
+    CPU_INT32U      SrvP999_us;
+    double          CyclesPerMsg;
+} BENCH_RESULT;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  CPU_INT32U  BenchBodyLenTbl[]   = { 1024u, 16384u, 262144u, 1048576u };
+static  const  CPU_INT32U  BenchRcptNbrTbl[]   = { 1u, 10u, 50u };
+static  const  CPU_INT32U  BenchThreadNbrTbl[] = { 1u, 4u, 16u };
+
+static  const  char       *BenchCycleSrcTbl[]  = { "none", "perf", "tsc" };
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  CPU_CHAR      *BenchBodyPtr;
+static  SMTPc_MBOX     BenchFrom;
+static  SMTPc_MBOX     BenchRcptTbl[SMTPc_CFG_MSG_MAX_TO];
+static  CPU_INT08U     BenchCycleSrc;
+static  double         BenchTSC_PerNs;                          /* Rate of the time stamp counter (see Note #2c).       */
+static  BENCH_THREAD   BenchThreadTbl[BENCH_THREAD_NBR_MAX];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U   BenchTS_Get_ns   (void);
+
+static  int          BenchCycleOpen   (void);
+
+static  CPU_INT64U   BenchCycleGet    (int            fd);
+
+static  void        *BenchThread      (void          *p_arg);
+
+static  int          BenchLatCmp      (const  void   *p_a,
+                                       const  void   *p_b);
+
+static  double       BenchLatPctGet   (CPU_INT64U    *p_tbl,
+                                       CPU_INT32U     nbr,
+                                       CPU_INT32U     per_mille);
+
+static  void         BenchRun         (CPU_INT32U     body_len,
+                                       CPU_INT32U     rcpt_nbr,
+                                       CPU_INT32U     thread_nbr,
+                                       CPU_INT32U     octet_budget,
+                                       BENCH_RESULT  *p_result);
+
+static  void         BenchWr          (const  char   *p_dir,
+                                       BENCH_RESULT  *p_tbl,
+                                       CPU_INT32U     nbr);
+
+
+/*
+*********************************************************************************************************
+*                                               main()
+*
+* Description : Run the sweep & write its results (see Note #3).
+*
+* Argument(s) : argc            Number of arguments.
+*
+*               argv            Arguments.
+*
+* Return(s)   : 0, if NO error(s).
+*
+*               1, otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+int  main (int    argc,
+           char  *argv[])
+{
+    BENCH_RESULT              *p_tbl;
+    SMTPc_TRANSPORT_MOCK_CFG   cfg;
+    const  char               *p_dir;
+    CPU_INT32U                 octet_budget;
+    CPU_INT32U                 body_len_max;
+    CPU_INT32U                 nbr;
+    CPU_INT32U                 i;
+    CPU_INT32U                 j;
+    CPU_INT32U                 k;
+    CPU_INT64U                 ts;
+    CPU_INT64U                 cycles;
+    int                        fd;
+    int                        opt;
+    char                       addr[32];
+    SMTPc_ERR                  err;
+
+
+    p_dir        = "results";
+    octet_budget = BENCH_OCTET_BUDGET;
+    while ((opt = getopt(argc, argv, "o:q")) != -1) {
+        switch (opt) {
+            case 'o':
+                 p_dir = optarg;
+                 break;
+
+            case 'q':
+                 octet_budget = BENCH_OCTET_BUDGET_QUICK;
+                 break;
+
+            default:
+                 fprintf(stderr, "usage: %s [-o <dir>] [-q]\n", argv[0]);
+                 return (1);
+        }
+    }
+
+    CPU_Init();
+    Mem_Init();
+
+    SMTPc_TransportMock_Init(BENCH_THREAD_NBR_MAX, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_TransportMock_Init(): %u\n", err);
+        return (1);
+    }
+    Mem_Clr(&cfg, sizeof(cfg));
+    cfg.CapFlags = SMTPc_CAP_PIPELINING | SMTPc_CAP_8BITMIME | SMTPc_CAP_ENHSTATUS;
+    SMTPc_TransportMock_CfgSet(&cfg, &err);
+    SMTPc_TransportSet(&SMTPc_TransportAPI_Mock, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_TransportSet(): %u\n", err);
+        return (1);
+    }
+                                                                /* Body of CRLF terminated lines of text.               */
+    body_len_max = BenchBodyLenTbl[(sizeof(BenchBodyLenTbl) / sizeof(BenchBodyLenTbl[0])) - 1u];
+    BenchBodyPtr = malloc(body_len_max);
+    if (BenchBodyPtr == NULL) {
+        return (1);
+    }
+    for (i = 0u; i < body_len_max; i++) {
+        switch (i % BENCH_LINE_LEN) {
+            case BENCH_LINE_LEN - 2u:
+                 BenchBodyPtr[i] = ASCII_CHAR_CARRIAGE_RETURN;
+                 break;
+
+            case BENCH_LINE_LEN - 1u:
+                 BenchBodyPtr[i] = ASCII_CHAR_LINE_FEED;
+                 break;
+
+            default:
+                 BenchBodyPtr[i] = (CPU_CHAR)('a' + ((i * 7u) % 26u));
+                 break;
+        }
+    }
+
+    SMTPc_SetMbox(&BenchFrom, "Bench", "bench@example.com", &err);
+    for (i = 0u; i < SMTPc_CFG_MSG_MAX_TO; i++) {
+        snprintf(addr, sizeof(addr), "rcpt%u@example.com", (unsigned)i);
+        SMTPc_SetMbox(&BenchRcptTbl[i], "", addr, &err);
+    }
+
+    BenchCycleSrc = BENCH_CYCLE_SRC_NONE;                       /* See Note #2c.                                        */
+    fd            = BenchCycleOpen();
+    if (fd >= 0) {
+        BenchCycleSrc = BENCH_CYCLE_SRC_PERF;
+        close(fd);
+    } else {
+#if (defined(__x86_64__) || defined(__i386__))
+        BenchCycleSrc  = BENCH_CYCLE_SRC_TSC;
+        ts             = BenchTS_Get_ns();
+        cycles         = __rdtsc();
+        usleep(100000u);
+        BenchTSC_PerNs = (double)(__rdtsc() - cycles) / (double)(BenchTS_Get_ns() - ts);
+#endif
+    }
+
+    nbr   = (sizeof(BenchBodyLenTbl)   / sizeof(BenchBodyLenTbl[0]))
+          * (sizeof(BenchRcptNbrTbl)   / sizeof(BenchRcptNbrTbl[0]))
+          * (sizeof(BenchThreadNbrTbl) / sizeof(BenchThreadNbrTbl[0]));
+    p_tbl = calloc(nbr, sizeof(BENCH_RESULT));
+    if (p_tbl == NULL) {
+        return (1);
+    }
+
+    printf("%8s %5s %4s %6s %10s %10s %9s %9s %9s %9s %12s\n",
+           "body", "rcpts", "thr", "msgs", "msg/s", "MB/s", "p50(us)", "p99(us)", "p999(us)", "max(us)", "cycles/msg");
+    nbr = 0u;
+    for (i = 0u; i < (sizeof(BenchBodyLenTbl) / sizeof(BenchBodyLenTbl[0])); i++) {
+        for (j = 0u; j < (sizeof(BenchRcptNbrTbl) / sizeof(BenchRcptNbrTbl[0])); j++) {
+            for (k = 0u; k < (sizeof(BenchThreadNbrTbl) / sizeof(BenchThreadNbrTbl[0])); k++) {
+                BenchRun(BenchBodyLenTbl[i], BenchRcptNbrTbl[j], BenchThreadNbrTbl[k], octet_budget, &p_tbl[nbr]);
+                printf("%8u %5u %4u %6u %10.0f %10.1f %9.1f %9.1f %9.1f %9.1f %12.0f\n",
+                       (unsigned)p_tbl[nbr].BodyLen,
+                       (unsigned)p_tbl[nbr].RcptNbr,
+                       (unsigned)p_tbl[nbr].ThreadNbr,
+                       (unsigned)p_tbl[nbr].MsgNbr,
+                       p_tbl[nbr].MsgPerSec,
+                       p_tbl[nbr].OctetPerSec / 1e6,
+                       p_tbl[nbr].P50_us,
+                       p_tbl[nbr].P99_us,
+                       p_tbl[nbr].P999_us,
+                       p_tbl[nbr].Max_us,
+                       p_tbl[nbr].CyclesPerMsg);
+                if (p_tbl[nbr].FailCtr != 0u) {
+                    fprintf(stderr, "  %u msgs failed\n", (unsigned)p_tbl[nbr].FailCtr);
+                }
+                nbr++;
+            }
+        }
+    }
+    printf("cycle source: %s\n", BenchCycleSrcTbl[BenchCycleSrc]);
+
+    BenchWr(p_dir, p_tbl, nbr);
+
+    return (0);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          BenchTS_Get_ns()
+*
+* Description : Get the time of the monotonic clock.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in nanoseconds.
+*
+* Caller(s)   : BenchThread(),
+*               BenchRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchTS_Get_ns (void)
+{
+    struct  timespec  ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((CPU_INT64U)ts.tv_sec * 1000000000u) + (CPU_INT64U)ts.tv_nsec);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchCycleOpen()
+*
+* Description : Open the cycle counter of the calling thread.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Descriptor of the counter, counting,
+*
+*               -1, if the counter is unavailable.
+*
+* Caller(s)   : main(),
+*               BenchThread().
+*
+* Note(s)     : (1) Only the cycles spent in user mode are counted, which 'perf_event_paranoid' levels up to
+*                   2 allow to unprivileged processes.
+*********************************************************************************************************
+*/
+
+static  int  BenchCycleOpen (void)
+{
+    struct  perf_event_attr  attr;
+    int                      fd;
+
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;                                    /* See Note #1.                                         */
+    attr.exclude_hv     = 1;
+
+    fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+        return (-1);
+    }
+    ioctl(fd, PERF_EVENT_IOC_RESET,  0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+
+    return (fd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchCycleGet()
+*
+* Description : Read the cycle counter of the calling thread (see 'bench_msg.c  Note #2c').
+*
+* Argument(s) : fd              Descriptor of the counter, if the source is the kernel counter.
+*
+* Return(s)   : Number of cycles counted.
+*
+* Caller(s)   : BenchThread().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchCycleGet (int  fd)
+{
+    struct  timespec  ts;
+    CPU_INT64U        cycles;
+
+
+    cycles = 0u;
+    switch (BenchCycleSrc) {
+        case BENCH_CYCLE_SRC_PERF:
+             if (read(fd, &cycles, sizeof(cycles)) != (ssize_t)sizeof(cycles)) {
+                 cycles = 0u;
+             }
+             break;
+
+        case BENCH_CYCLE_SRC_TSC:
+             clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+             cycles = (CPU_INT64U)((((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec) * BenchTSC_PerNs);
+             break;
+
+        default:
+             break;
+    }
+
+    return (cycles);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            BenchThread()
+*
+* Description : Send the messages of a thread on its own session.
+*
+* Argument(s) : p_arg           Pointer to the thread (see 'BENCH_THREAD').
+*
+* Return(s)   : NULL.
+*
+* Caller(s)   : BenchRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  *BenchThread (void  *p_arg)
+{
+    BENCH_THREAD  *p_thread;
+    CPU_INT64U     ts;
+    CPU_INT64U     cycles;
+    CPU_INT32U     i;
+    int            fd;
+    SMTPc_ERR      err;
+
+
+    p_thread         = (BENCH_THREAD *)p_arg;
+    p_thread->Cycles = 0u;
+
+    SMTPc_SessionConnect(&p_thread->Sess, "localhost", 25u, DEF_NULL, DEF_NULL, DEF_NULL, &err);
+    if (err != SMTPc_ERR_NONE) {
+        p_thread->FailCtr = p_thread->MsgNbr;
+        return (NULL);
+    }
+
+    fd     = (BenchCycleSrc == BENCH_CYCLE_SRC_PERF) ? BenchCycleOpen() : -1;
+    cycles = BenchCycleGet(fd);
+    for (i = 0u; i < p_thread->MsgNbr; i++) {
+        ts = BenchTS_Get_ns();
+        SMTPc_SessionSendMsg(&p_thread->Sess, &p_thread->Msg, &err);
+        p_thread->LatTbl[i] = BenchTS_Get_ns() - ts;
+        if (err != SMTPc_ERR_NONE) {
+            p_thread->FailCtr++;
+        }
+    }
+    p_thread->Cycles = BenchCycleGet(fd) - cycles;
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    SMTPc_SessionDisconnect(&p_thread->Sess, &err);
+
+    return (NULL);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            BenchLatCmp()
+*
+* Description : Compare two latencies, for qsort().
+*
+* Argument(s) : p_a             Pointer to the first  latency.
+*
+*               p_b             Pointer to the second latency.
+*
+* Return(s)   : < 0, = 0 or > 0, as the first latency is shorter, equal or longer.
+*
+* Caller(s)   : BenchRun(), through qsort().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  int  BenchLatCmp (const  void  *p_a,
+                          const  void  *p_b)
+{
+    CPU_INT64U  a;
+    CPU_INT64U  b;
+
+
+    a = *(const CPU_INT64U *)p_a;
+    b = *(const CPU_INT64U *)p_b;
+
+    return ((a > b) - (a < b));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchLatPctGet()
+*
+* Description : Get a percentile of sorted latencies.
+*
+* Argument(s) : p_tbl           Pointer to the latencies, sorted, in nanoseconds.
+*
+*               nbr             Number of latencies, MUST be non-null.
+*
+*               per_mille       Percentile, in thousandths.
+*
+* Return(s)   : Latency of rank ceil(per_mille * nbr / 1000), in microseconds.
+*
+* Caller(s)   : BenchRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  double  BenchLatPctGet (CPU_INT64U  *p_tbl,
+                                CPU_INT32U   nbr,
+                                CPU_INT32U   per_mille)
+{
+    CPU_INT64U  rank;
+
+
+    rank = (((CPU_INT64U)nbr * per_mille) + 999u) / 1000u;
+    if (rank == 0u) {
+        rank = 1u;
+    }
+
+    return ((double)p_tbl[rank - 1u] / 1000.0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             BenchRun()
+*
+* Description : Run a point of the sweep.
+*
+* Argument(s) : body_len        Length of the message body, in octets.
+*
+*               rcpt_nbr        Number of recipients of each message.
+*
+*               thread_nbr      Number of sending threads.
+*
+*               octet_budget    Number of body octets to send, in total.
+*
+*               p_result        Pointer to the variable that will receive the results.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : (1) The latencies of all the threads are merged, so that the percentiles are those of every
+*                   message of the point.
+*********************************************************************************************************
+*/
+
+static  void  BenchRun (CPU_INT32U     body_len,
+                        CPU_INT32U     rcpt_nbr,
+                        CPU_INT32U     thread_nbr,
+                        CPU_INT32U     octet_budget,
+                        BENCH_RESULT  *p_result)
+{
+    SMTPc_TRANSPORT_MOCK_STATS   stats;
+    BENCH_THREAD                *p_thread;
+    CPU_INT64U                  *p_lat_tbl;
+    CPU_INT64U                   ts;
+    CPU_INT64U                   cycles;
+    CPU_INT32U                   msg_nbr;
+    CPU_INT32U                   nbr;
+    CPU_INT32U                   i;
+    CPU_INT32U                   j;
+    SMTPc_ERR                    err;
+
+
+    msg_nbr = octet_budget / body_len;
+    msg_nbr = DEF_MAX(msg_nbr, BENCH_MSG_NBR_MIN);
+    msg_nbr = DEF_MIN(msg_nbr, BENCH_MSG_NBR_MAX);
+    msg_nbr = ((msg_nbr + thread_nbr - 1u) / thread_nbr) * thread_nbr;
+
+    p_lat_tbl = malloc(msg_nbr * sizeof(CPU_INT64U));
+    if (p_lat_tbl == NULL) {
+        exit(1);
+    }
+
+    for (i = 0u; i < thread_nbr; i++) {
+        p_thread          = &BenchThreadTbl[i];
+        p_thread->MsgNbr  = msg_nbr / thread_nbr;
+        p_thread->RcptNbr = rcpt_nbr;
+        p_thread->LatTbl  = &p_lat_tbl[i * p_thread->MsgNbr];
+        p_thread->FailCtr = 0u;
+
+        SMTPc_SetMsg(&p_thread->Msg, &err);
+        p_thread->Msg.From              = &BenchFrom;
+        p_thread->Msg.Subject           = "Benchmark";
+        p_thread->Msg.ContentBodyMsg    = BenchBodyPtr;
+        p_thread->Msg.ContentBodyMsgLen = body_len;
+        for (j = 0u; j < rcpt_nbr; j++) {
+            p_thread->Msg.ToArray[j] = &BenchRcptTbl[j];
+        }
+    }
+
+    SMTPc_TransportMock_StatsClr();
+    ts = BenchTS_Get_ns();
+    for (i = 0u; i < thread_nbr; i++) {
+        pthread_create(&BenchThreadTbl[i].Thread, NULL, BenchThread, &BenchThreadTbl[i]);
+    }
+    cycles = 0u;
+    nbr    = 0u;
+    for (i = 0u; i < thread_nbr; i++) {
+        pthread_join(BenchThreadTbl[i].Thread, NULL);
+        cycles += BenchThreadTbl[i].Cycles;
+        nbr    += BenchThreadTbl[i].FailCtr;
+    }
+    ts = BenchTS_Get_ns() - ts;
+    SMTPc_TransportMock_StatsGet(&stats);
+
+                                                                /* See Note #1.                                         */
+    qsort(p_lat_tbl, msg_nbr, sizeof(CPU_INT64U), BenchLatCmp);
+
+    p_result->BodyLen      = body_len;
+    p_result->RcptNbr      = rcpt_nbr;
+    p_result->ThreadNbr    = thread_nbr;
+    p_result->MsgNbr       = msg_nbr;
+    p_result->FailCtr      = nbr;
+    p_result->Elapsed_s    = (double)ts / 1e9;
+    p_result->MsgPerSec    = (double)stats.MsgCtr   / p_result->Elapsed_s;
+    p_result->OctetPerSec  = (double)stats.OctetCtr / p_result->Elapsed_s;
+    p_result->P50_us       = BenchLatPctGet(p_lat_tbl, msg_nbr, 500u);
+    p_result->P99_us       = BenchLatPctGet(p_lat_tbl, msg_nbr, 990u);
+    p_result->P999_us      = BenchLatPctGet(p_lat_tbl, msg_nbr, 999u);
+    p_result->Max_us       = (double)p_lat_tbl[msg_nbr - 1u] / 1000.0;
+    p_result->SrvP50_us    = stats.LatP50_us;
+    p_result->SrvP99_us    = stats.LatP99_us;
+    p_result->SrvP999_us   = stats.LatP999_us;
+    p_result->CyclesPerMsg = (double)cycles / msg_nbr;
+
+    free(p_lat_tbl);
+}
+
+
+/*
+*********************************************************************************************************
+*                                              BenchWr()
+*
+* Description : Write the results of the sweep, as CSV & JSON (see 'bench_msg.c  Note #3').
+*
+* Argument(s) : p_dir           Directory the files are written to, created if needed.
+*
+*               p_tbl           Pointer to the results.
+*
+*               nbr             Number of results.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchWr (const  char   *p_dir,
+                       BENCH_RESULT  *p_tbl,
+                       CPU_INT32U     nbr)
+{
+    BENCH_RESULT  *p_result;
+    FILE          *p_csv;
+    FILE          *p_json;
+    char           path[512];
+    CPU_INT32U     i;
+
+
+    if ((mkdir(p_dir, 0755) != 0) && (errno != EEXIST)) {
+        perror(p_dir);
+        return;
+    }
+
+    snprintf(path, sizeof(path), "%s/bench_msg.csv", p_dir);
+    p_csv = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s/bench_msg.json", p_dir);
+    p_json = fopen(path, "w");
+    if ((p_csv == NULL) || (p_json == NULL)) {
+        perror(path);
+        return;
+    }
+
+    fprintf(p_csv, "body_octets,rcpts,threads,msgs,failed,elapsed_s,msgs_per_s,bytes_per_s,"
+                   "p50_us,p99_us,p999_us,max_us,srv_p50_us,srv_p99_us,srv_p999_us,cycles_per_msg,cycle_src\n");
+    fprintf(p_json, "{\n  \"cycle_src\": \"%s\",\n  \"cpus\": %ld,\n  \"results\": [\n",
+            BenchCycleSrcTbl[BenchCycleSrc], sysconf(_SC_NPROCESSORS_ONLN));
+
+    for (i = 0u; i < nbr; i++) {
+        p_result = &p_tbl[i];
+        fprintf(p_csv, "%u,%u,%u,%u,%u,%.6f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%.0f,%s\n",
+                (unsigned)p_result->BodyLen,
+                (unsigned)p_result->RcptNbr,
+                (unsigned)p_result->ThreadNbr,
+                (unsigned)p_result->MsgNbr,
+                (unsigned)p_result->FailCtr,
+                p_result->Elapsed_s,
+                p_result->MsgPerSec,
+                p_result->OctetPerSec,
+                p_result->P50_us,
+                p_result->P99_us,
+                p_result->P999_us,
+                p_result->Max_us,
+                (unsigned)p_result->SrvP50_us,
+                (unsigned)p_result->SrvP99_us,
+                (unsigned)p_result->SrvP999_us,
+                p_result->CyclesPerMsg,
+                BenchCycleSrcTbl[BenchCycleSrc]);
+        fprintf(p_json, "    { \"body_octets\": %u, \"rcpts\": %u, \"threads\": %u, \"msgs\": %u, \"failed\": %u,"
+                        " \"elapsed_s\": %.6f, \"msgs_per_s\": %.1f, \"bytes_per_s\": %.1f,"
+                        " \"p50_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f,"
+                        " \"srv_p50_us\": %u, \"srv_p99_us\": %u, \"srv_p999_us\": %u,"
+                        " \"cycles_per_msg\": %.0f }%s\n",
+                (unsigned)p_result->BodyLen,
+                (unsigned)p_result->RcptNbr,
+                (unsigned)p_result->ThreadNbr,
+                (unsigned)p_result->MsgNbr,
+                (unsigned)p_result->FailCtr,
+                p_result->Elapsed_s,
+                p_result->MsgPerSec,
+                p_result->OctetPerSec,
+                p_result->P50_us,
+                p_result->P99_us,
+                p_result->P999_us,
+                p_result->Max_us,
+                (unsigned)p_result->SrvP50_us,
+                (unsigned)p_result->SrvP99_us,
+                (unsigned)p_result->SrvP999_us,
+                p_result->CyclesPerMsg,
+                (i + 1u < nbr) ? "," : "");
+    }
+    fprintf(p_json, "  ]\n}\n");
+
+    fclose(p_csv);
+    fclose(p_json);
+}
@@ -0,0 +1,652 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                    uC/SMTPc LOOPBACK MOCK SERVER
+*
+* Filename : bench_srv.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) The server is a single epoll loop over non-blocking sockets.  The replies to the commands
+*                read at once are gathered & sent together, as a pipelining server does (RFC 2920).
+*
+*            (2) The end of the message content is found by a scanner of the "<CRLF>.<CRLF>" sequence, run
+*                octet by octet across the receptions : the content itself is discarded.
+*
+*            (3) The server closes each connection after its reply to QUIT, so that the ports of the
+*                client are not left in TIME-WAIT from one run to the next.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  _GNU_SOURCE
+
+#include  <errno.h>
+#include  <signal.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <strings.h>
+#include  <unistd.h>
+#include  <arpa/inet.h>
+#include  <netinet/in.h>
+#include  <netinet/tcp.h>
+#include  <sys/epoll.h>
+#include  <sys/prctl.h>
+#include  <sys/resource.h>
+#include  <sys/socket.h>
+#include  <sys/wait.h>
+
+#include  <lib_def.h>
+
+#include  "bench_srv.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  BENCH_SRV_BACKLOG                            65535     /* Clamped to 'somaxconn' by the kernel.                */
+#define  BENCH_SRV_EVT_NBR                              256u    /* Nbr of evts taken per wait.                          */
+#define  BENCH_SRV_LINE_LEN                             512u    /* Max len of a cmd line.                               */
+#define  BENCH_SRV_OUT_LEN                             4096u    /* Size of the reply buf.                               */
+#define  BENCH_SRV_RX_BUF_LEN                         65536u    /* Size of the rx buf, shared by the conns.             */
+
+                                                                /* -------- STATES OF THE END SCANNER (Note #2) ------- */
+#define  BENCH_SRV_DATA_MID                               0u    /* Within a line.                                       */
+#define  BENCH_SRV_DATA_CR                                1u    /* After CR.                                            */
+#define  BENCH_SRV_DATA_BOL                               2u    /* At the start of a line.                              */
+#define  BENCH_SRV_DATA_DOT                               3u    /* After "<CRLF>.".                                     */
+#define  BENCH_SRV_DATA_DOT_CR                            4u    /* After "<CRLF>.<CR>".                                 */
+
+#define  BENCH_SRV_REP_GREETING     "220 bench.local ESMTP\r\n"
+#define  BENCH_SRV_REP_EHLO         "250-bench.local\r\n250-PIPELINING\r\n250-8BITMIME\r\n250 ENHANCEDSTATUSCODES\r\n"
+#define  BENCH_SRV_REP_OK           "250 2.0.0 OK\r\n"
+#define  BENCH_SRV_REP_DATA         "354 End data with <CR><LF>.<CR><LF>\r\n"
+#define  BENCH_SRV_REP_QUEUED       "250 2.0.0 Queued\r\n"
+#define  BENCH_SRV_REP_QUIT         "221 2.0.0 Bye\r\n"
+#define  BENCH_SRV_REP_UNKNOWN      "502 5.5.2 Command not implemented\r\n"
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  bench_srv_conn {
+    int          Fd;
+    CPU_BOOLEAN  Data;                                          /* Rx'ing msg content ...                               */
+    CPU_INT08U   DataState;                                     /* ... & state of its end scanner (see Note #2).        */
+    CPU_BOOLEAN  Quit;                                          /* QUIT rx'd : close once the replies are sent.         */
+    CPU_BOOLEAN  OutWait;                                       /* Waiting for the socket to accept the replies.        */
+    CPU_INT32U   LineLen;
+    CPU_INT32U   OutLen;
+    char         Line[BENCH_SRV_LINE_LEN];
+    char         Out[BENCH_SRV_OUT_LEN];
+} BENCH_SRV_CONN;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  int              BenchSrv_EpollFd;
+static  BENCH_SRV_CONN **BenchSrv_ConnTbl;                      /* Conns, indexed by descriptor.                        */
+static  CPU_INT32U       BenchSrv_ConnTblSize;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         BenchSrv_Run     (int              listen_fd);
+
+static  void         BenchSrv_Accept  (int              listen_fd);
+
+static  void         BenchSrv_Rx      (BENCH_SRV_CONN  *p_conn);
+
+static  void         BenchSrv_CmdProc (BENCH_SRV_CONN  *p_conn);
+
+static  void         BenchSrv_Rep     (BENCH_SRV_CONN  *p_conn,
+                                       const  char     *p_rep);
+
+static  CPU_BOOLEAN  BenchSrv_Flush   (BENCH_SRV_CONN  *p_conn);
+
+static  void         BenchSrv_Close   (BENCH_SRV_CONN  *p_conn);
+
+
+/*
+*********************************************************************************************************
+*                                          BenchSrv_Start()
+*
+* Description : Start the server, in a child process, on an ephemeral port of the loopback interface.
+*
+* Argument(s) : p_port          Pointer to the variable that will receive the port of the server.
+*
+* Return(s)   : Process of the server, if NO error.
+*
+*               -1,                    otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) The socket listens before the process is created : the client may connect as soon as the
+*                   function returns.
+*
+*               (2) The server stops with its parent.
+*********************************************************************************************************
+*/
+
+pid_t  BenchSrv_Start (CPU_INT16U  *p_port)
+{
+    struct  sockaddr_in  addr;
+    socklen_t            addr_len;
+    pid_t                pid;
+    int                  fd;
+    int                  opt;
+
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return (-1);
+    }
+    opt = 1;
+    (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = 0u;
+    addr_len             = sizeof(addr);
+                                                                /* See Note #1.                                         */
+    if ((bind(fd, (struct sockaddr *)&addr, sizeof(addr))     != 0) ||
+        (listen(fd, BENCH_SRV_BACKLOG)                        != 0) ||
+        (getsockname(fd, (struct sockaddr *)&addr, &addr_len) != 0)) {
+        close(fd);
+        return (-1);
+    }
+
+    pid = fork();
+    if (pid == 0) {
+        (void)prctl(PR_SET_PDEATHSIG, SIGTERM);                 /* See Note #2.                                         */
+        BenchSrv_Run(fd);
+        _exit(0);
+    }
+    close(fd);
+    if (pid < 0) {
+        return (-1);
+    }
+
+   *p_port = ntohs(addr.sin_port);
+
+    return (pid);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchSrv_Stop()
+*
+* Description : Stop the server.
+*
+* Argument(s) : pid             Process of the server.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+void  BenchSrv_Stop (pid_t  pid)
+{
+    if (pid <= 0) {
+        return;
+    }
+
+    (void)kill(pid, SIGTERM);
+    (void)waitpid(pid, NULL, 0);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                           BenchSrv_Run()
+*
+* Description : Serve the connections, until the process is stopped.
+*
+* Argument(s) : listen_fd       Listening socket.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : BenchSrv_Start().
+*
+* Note(s)     : (1) The limit of descriptors is raised to its maximum : the server holds as many connections
+*                   as the client.
+*********************************************************************************************************
+*/
+
+static  void  BenchSrv_Run (int  listen_fd)
+{
+    struct  epoll_event   evt;
+    struct  epoll_event   evt_tbl[BENCH_SRV_EVT_NBR];
+    struct  rlimit        lim;
+    BENCH_SRV_CONN       *p_conn;
+    int                   evt_nbr;
+    int                   i;
+
+
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {                  /* See Note #1.                                         */
+        lim.rlim_cur = lim.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &lim);
+    }
+    BenchSrv_ConnTblSize = (CPU_INT32U)DEF_MIN(lim.rlim_cur, DEF_INT_32U_MAX_VAL);
+    BenchSrv_ConnTbl     = calloc(BenchSrv_ConnTblSize, sizeof(BENCH_SRV_CONN *));
+    BenchSrv_EpollFd     = epoll_create1(EPOLL_CLOEXEC);
+    if ((BenchSrv_ConnTbl == NULL) ||
+        (BenchSrv_EpollFd <  0)) {
+        return;
+    }
+
+    memset(&evt, 0, sizeof(evt));
+    evt.events   = EPOLLIN;
+    evt.data.ptr = NULL;                                        /* Listening socket.                                    */
+    if (epoll_ctl(BenchSrv_EpollFd, EPOLL_CTL_ADD, listen_fd, &evt) != 0) {
+        return;
+    }
+
+    for (;;) {
+        evt_nbr = epoll_wait(BenchSrv_EpollFd, evt_tbl, BENCH_SRV_EVT_NBR, -1);
+        if (evt_nbr < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        for (i = 0; i < evt_nbr; i++) {
+            p_conn = (BENCH_SRV_CONN *)evt_tbl[i].data.ptr;
+            if (p_conn == NULL) {
+                BenchSrv_Accept(listen_fd);
+            } else if ((evt_tbl[i].events & EPOLLOUT) != 0u) {
+                if (BenchSrv_Flush(p_conn) == DEF_YES) {
+                    BenchSrv_Rx(p_conn);
+                }
+            } else {
+                BenchSrv_Rx(p_conn);
+            }
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchSrv_Accept()
+*
+* Description : Accept the pending connections & greet them.
+*
+* Argument(s) : listen_fd       Listening socket.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : BenchSrv_Run().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchSrv_Accept (int  listen_fd)
+{
+    struct  epoll_event   evt;
+    BENCH_SRV_CONN       *p_conn;
+    int                   fd;
+    int                   opt;
+
+
+    for (;;) {
+        fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if ((CPU_INT32U)fd >= BenchSrv_ConnTblSize) {
+            close(fd);
+            continue;
+        }
+
+        p_conn = BenchSrv_ConnTbl[fd];
+        if (p_conn == NULL) {
+            p_conn = malloc(sizeof(BENCH_SRV_CONN));
+            if (p_conn == NULL) {
+                close(fd);
+                continue;
+            }
+            BenchSrv_ConnTbl[fd] = p_conn;
+        }
+        p_conn->Fd        = fd;
+        p_conn->Data      = DEF_NO;
+        p_conn->DataState = BENCH_SRV_DATA_BOL;
+        p_conn->Quit      = DEF_NO;
+        p_conn->OutWait   = DEF_NO;
+        p_conn->LineLen   = 0u;
+        p_conn->OutLen    = 0u;
+
+        opt = 1;
+        (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+        memset(&evt, 0, sizeof(evt));
+        evt.events   = EPOLLIN;
+        evt.data.ptr = p_conn;
+        if (epoll_ctl(BenchSrv_EpollFd, EPOLL_CTL_ADD, fd, &evt) != 0) {
+            close(fd);
+            continue;
+        }
+
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_GREETING);
+        (void)BenchSrv_Flush(p_conn);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            BenchSrv_Rx()
+*
+* Description : Receive the data of a connection, & reply to its commands.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : BenchSrv_Run().
+*
+* Note(s)     : (1) A connection waiting for its replies to be sent is not read : the client MUST read them
+*                   before sending more.
+*********************************************************************************************************
+*/
+
+static  void  BenchSrv_Rx (BENCH_SRV_CONN  *p_conn)
+{
+    static  char     rx_buf[BENCH_SRV_RX_BUF_LEN];
+    CPU_INT08U       state;
+    ssize_t          rx_len;
+    ssize_t          i;
+    char             c;
+
+
+    if (p_conn->OutWait == DEF_YES) {                           /* See Note #1.                                         */
+        return;
+    }
+
+    rx_len = read(p_conn->Fd, rx_buf, sizeof(rx_buf));
+    if (rx_len <= 0) {
+        if ((rx_len == 0) || (errno != EAGAIN)) {
+            BenchSrv_Close(p_conn);
+        }
+        return;
+    }
+
+    for (i = 0; i < rx_len; i++) {
+        c = rx_buf[i];
+        if (p_conn->Data == DEF_YES) {                          /* See Note #2.                                         */
+            state = p_conn->DataState;
+            switch (c) {
+                case '\r':
+                     state = (state == BENCH_SRV_DATA_DOT) ? BENCH_SRV_DATA_DOT_CR : BENCH_SRV_DATA_CR;
+                     break;
+
+                case '\n':
+                     if (state == BENCH_SRV_DATA_DOT_CR) {
+                         p_conn->Data = DEF_NO;
+                         BenchSrv_Rep(p_conn, BENCH_SRV_REP_QUEUED);
+                     }
+                     state = (state == BENCH_SRV_DATA_CR) ? BENCH_SRV_DATA_BOL : BENCH_SRV_DATA_MID;
+                     break;
+
+                case '.':
+                     state = (state == BENCH_SRV_DATA_BOL) ? BENCH_SRV_DATA_DOT : BENCH_SRV_DATA_MID;
+                     break;
+
+                default:
+                     state = BENCH_SRV_DATA_MID;
+                     break;
+            }
+            p_conn->DataState = state;
+
+        } else if (c == '\n') {
+            BenchSrv_CmdProc(p_conn);
+            p_conn->LineLen = 0u;
+
+        } else if (p_conn->LineLen < BENCH_SRV_LINE_LEN) {
+            p_conn->Line[p_conn->LineLen] = c;
+            p_conn->LineLen++;
+        }
+    }
+
+    (void)BenchSrv_Flush(p_conn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         BenchSrv_CmdProc()
+*
+* Description : Reply to the command line of a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : BenchSrv_Rx().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchSrv_CmdProc (BENCH_SRV_CONN  *p_conn)
+{
+    const  char  *p_cmd;
+
+
+    if (p_conn->LineLen < 4u) {
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_UNKNOWN);
+        return;
+    }
+
+    p_cmd = p_conn->Line;
+    if (strncasecmp(p_cmd, "EHLO", 4u) == 0) {
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_EHLO);
+
+    } else if ((strncasecmp(p_cmd, "HELO", 4u) == 0) ||
+               (strncasecmp(p_cmd, "MAIL", 4u) == 0) ||
+               (strncasecmp(p_cmd, "RCPT", 4u) == 0) ||
+               (strncasecmp(p_cmd, "RSET", 4u) == 0) ||
+               (strncasecmp(p_cmd, "NOOP", 4u) == 0)) {
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_OK);
+
+    } else if (strncasecmp(p_cmd, "DATA", 4u) == 0) {
+        p_conn->Data      = DEF_YES;
+        p_conn->DataState = BENCH_SRV_DATA_BOL;
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_DATA);
+
+    } else if (strncasecmp(p_cmd, "QUIT", 4u) == 0) {
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_QUIT);
+        p_conn->Quit = DEF_YES;                                 /* Set once the reply is queued.                        */
+
+    } else {
+        BenchSrv_Rep(p_conn, BENCH_SRV_REP_UNKNOWN);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchSrv_Rep()
+*
+* Description : Append a reply to the replies of a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+*               p_rep           Pointer to the reply, CRLF terminated.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : BenchSrv_Accept(),
+*               BenchSrv_CmdProc(),
+*               BenchSrv_Rx().
+*
+* Note(s)     : (1) A full reply buffer is sent first, as far as the socket accepts it; a reply that still
+*                   does not fit is dropped, which only a client ignoring the replies may cause.
+*********************************************************************************************************
+*/
+
+static  void  BenchSrv_Rep (BENCH_SRV_CONN  *p_conn,
+                            const  char     *p_rep)
+{
+    CPU_INT32U  len;
+
+
+    len = (CPU_INT32U)strlen(p_rep);
+    if (p_conn->OutLen + len > BENCH_SRV_OUT_LEN) {             /* See Note #1.                                         */
+        (void)BenchSrv_Flush(p_conn);
+        if (p_conn->OutLen + len > BENCH_SRV_OUT_LEN) {
+            return;
+        }
+    }
+
+    memcpy(&p_conn->Out[p_conn->OutLen], p_rep, len);
+    p_conn->OutLen += len;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchSrv_Flush()
+*
+* Description : Send the replies of a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection.
+*
+* Return(s)   : DEF_YES, if all the replies were sent & the connection is open.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : BenchSrv_Accept(),
+*               BenchSrv_Rep(),
+*               BenchSrv_Run(),
+*               BenchSrv_Rx().
+*
+* Note(s)     : (1) The replies the socket does not accept are kept, & the connection waits until the socket
+*                   is writable.
+*
+*               (2) See 'bench_srv.c  Note #3'.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  BenchSrv_Flush (BENCH_SRV_CONN  *p_conn)
+{
+    struct  epoll_event  evt;
+    ssize_t              tx_len;
+    CPU_BOOLEAN          out_wait;
+
+
+    tx_len = 0;
+    if (p_conn->OutLen > 0u) {
+        tx_len = send(p_conn->Fd, p_conn->Out, p_conn->OutLen, MSG_NOSIGNAL);
+        if (tx_len < 0) {
+            if (errno != EAGAIN) {
+                BenchSrv_Close(p_conn);
+                return (DEF_NO);
+            }
+            tx_len = 0;
+        }
+        memmove(p_conn->Out, &p_conn->Out[tx_len], p_conn->OutLen - (CPU_INT32U)tx_len);
+        p_conn->OutLen -= (CPU_INT32U)tx_len;
+    }
+
+    out_wait = (p_conn->OutLen > 0u) ? DEF_YES : DEF_NO;        /* See Note #1.                                         */
+    if (out_wait != p_conn->OutWait) {
+        memset(&evt, 0, sizeof(evt));
+        evt.events   = (out_wait == DEF_YES) ? EPOLLOUT : EPOLLIN;
+        evt.data.ptr = p_conn;
+        (void)epoll_ctl(BenchSrv_EpollFd, EPOLL_CTL_MOD, p_conn->Fd, &evt);
+        p_conn->OutWait = out_wait;
+    }
+    if (out_wait == DEF_YES) {
+        return (DEF_NO);
+    }
+
+    if (p_conn->Quit == DEF_YES) {                              /* See Note #2.                                         */
+        BenchSrv_Close(p_conn);
+        return (DEF_NO);
+    }
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchSrv_Close()
+*
+* Description : Close a connection.
+*
+* Argument(s) : p_conn          Pointer to the connection, kept for the next connection of its descriptor.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchSrv_Close (BENCH_SRV_CONN  *p_conn)
+{
+    if (p_conn->Fd < 0) {
+        return;
+    }
+
+    close(p_conn->Fd);                                          /* Also removes it from the epoll instance.             */
+    p_conn->Fd      = -1;
+    p_conn->OutLen  =  0u;
+    p_conn->Data    =  DEF_NO;
+    p_conn->Quit    =  DEF_NO;
+    p_conn->OutWait =  DEF_NO;
+}
@@ -0,0 +1,78 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                    uC/SMTPc LOOPBACK MOCK SERVER
+*
+* Filename : bench_srv.h
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Minimal SMTP server, reachable over real sockets on the loopback interface, for the
+*                benchmarks of the socket transports : unlike the mock transport (see
+*                'Transport/Mock/smtp-c_transport_mock.h  Note #4'), its connections are descriptors, which
+*                the epoll reactor & the io_uring transport both wait on.
+*
+*            (2) The server runs in a child process, so that its descriptors do not count against the limit
+*                of the client, & accepts every command & message :
+*
+*                    pid = BenchSrv_Start(&port);
+*                    ...                                        Send to 127.0.0.1, port 'port'.
+*                    BenchSrv_Stop(pid);
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                               MODULE
+*********************************************************************************************************
+*/
+
+#ifndef  BENCH_SRV_MODULE_PRESENT
+#define  BENCH_SRV_MODULE_PRESENT
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <sys/types.h>
+
+#include  <cpu.h>
+
+
+/*
+*********************************************************************************************************
+*                                         FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+pid_t  BenchSrv_Start(CPU_INT16U  *p_port);
+
+void   BenchSrv_Stop (pid_t        pid);
+
+
+/*
+*********************************************************************************************************
+*                                             MODULE END
+*********************************************************************************************************
+*/
+
+#endif                                                          /* End of bench srv module include.                     */
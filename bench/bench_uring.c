@@ -0,0 +1,824 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                              uC/SMTPc CONCURRENT SESSIONS BENCHMARK : EPOLL VS IO_URING
+*
+* Filename : bench_uring.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Linux host program comparing the two backends of the asynchronous engine, for thousands of
+*                concurrent sessions, against the loopback mock server (see 'bench_srv.h  Note #1') :
+*
+*                (a) "epoll" : the jobs are run by SMTPc_ReactorEpoll_Run(), over the POSIX sockets
+*                    transport (see 'Reactor/Epoll/smtp-c_reactor_epoll.h').
+*
+*                (b) "uring" : the jobs are run by SMTPc_Poll(), over the io_uring transport, which
+*                    submits their operations in SMTPc_TransportUring_Wait() (see
+*                    'Transport/Uring/smtp-c_transport_uring.h  Note #2').
+*
+*                The io_uring transport cannot be driven by the reactor (see 'smtp-c_transport_uring.h
+*                Note #5') : each backend runs its own loop, on the same job set.
+*
+*            (2) A run submits N jobs at once, each sending one message to one recipient over its own
+*                connection, & ends when all completed : N is the number of concurrent sessions, 1000 &
+*                10000.  The body of the messages is of 1 KiB, copied by the io_uring transport, or of
+*                16 KiB, sent from its registered buffers without copy (see 'smtp-c_transport_uring.h
+*                Note #3').  The runs alternate between the backends; for each backend, N & body are
+*                reported, from the run of median duration :
+*
+*                (a) The messages accepted by the server per second of wall time.
+*
+*                (b) The exact 50th, 99th & 99.9th percentiles of the time from the submission of a job to
+*                    its completion.
+*
+*                (c) The CPU cycles per message of the client task, as in 'bench_msg.c  Note #2c'.  The
+*                    server runs in a process of its own, not counted.
+*
+*            (3) The results are written to '<dir>/bench_uring.csv' & '<dir>/bench_uring.json', "results"
+*                by default :
+*
+*                    bench_uring [-o <dir>] [-q]
+*
+*                '-q' only runs 1000 sessions, once per body.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  _GNU_SOURCE
+
+#include  <errno.h>
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <unistd.h>
+#include  <sys/ioctl.h>
+#include  <sys/resource.h>
+#include  <sys/stat.h>
+#include  <sys/syscall.h>
+#include  <linux/perf_event.h>
+#if (defined(__x86_64__) || defined(__i386__))
+#include  <x86intrin.h>
+#endif
+
+#include  <cpu.h>
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+
+#include  <Source/smtp-c.h>
+#include  <Transport/Posix/smtp-c_transport_posix.h>
+#include  <Transport/Uring/smtp-c_transport_uring.h>
+#include  <Reactor/Epoll/smtp-c_reactor_epoll.h>
+
+#include  "bench_srv.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  BENCH_SESS_NBR_MAX                           10000u    /* Max nbr of concurrent sessions.                      */
+#define  BENCH_RUN_NBR                                    3u    /* Nbr of runs of each backend & nbr of sessions.       */
+#define  BENCH_BODY_LEN_MAX                           16384u    /* Max len of the msg body.                             */
+#define  BENCH_LINE_LEN                                  78u    /* Len of the body lines, CRLF included.                */
+#define  BENCH_RENDER_BUF_LEN       (BENCH_BODY_LEN_MAX + 1024u)/* Size of the rendered msg.                            */
+#define  BENCH_WAIT_MS                                  100u    /* Max wait of the io_uring loop (see Note #1b).        */
+
+#define  BENCH_BACKEND_EPOLL                              0u
+#define  BENCH_BACKEND_URING                              1u
+#define  BENCH_BACKEND_NBR                                2u
+
+#define  BENCH_CYCLE_SRC_NONE                             0u
+#define  BENCH_CYCLE_SRC_PERF                             1u
+#define  BENCH_CYCLE_SRC_TSC                              2u
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  bench_result {
+    CPU_INT08U      Backend;
+    CPU_INT32U      SessNbr;
+    CPU_INT32U      BodyLen;
+    CPU_INT32U      FailCtr;
+    double          Elapsed_s;
+    double          MsgPerSec;
+    double          P50_us;
+    double          P99_us;
+    double          P999_us;
+    double          Max_us;
+    double          CyclesPerMsg;
+} BENCH_RESULT;
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL TABLES
+*********************************************************************************************************
+*/
+
+static  const  CPU_INT32U  BenchSessNbrTbl[] = { 1000u, 10000u };
+
+static  const  CPU_INT32U  BenchBodyLenTbl[] = { 1024u, 16384u };
+
+static  const  char       *BenchBackendTbl[] = { "epoll", "uring" };
+
+static  const  char       *BenchCycleSrcTbl[] = { "none", "perf", "tsc" };
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  SMTPc_ASYNC          *BenchJobTbl;
+static  CPU_INT64U           *BenchSubmitTS_Tbl;                /* Time each job was submitted (ns) ...                 */
+static  CPU_INT64U           *BenchLatTbl;                      /* ... & took to complete (ns).                         */
+static  CPU_INT32U            BenchJobNbr;
+static  CPU_INT32U            BenchCmplCtr;
+static  CPU_INT32U            BenchFailCtr;
+static  CPU_INT08U            BenchBackend;
+
+static  SMTPc_REACTOR_EPOLL   BenchReactor;
+static  CPU_INT16U            BenchSrvPort;
+static  SMTPc_SESSION         BenchSess;                        /* Session rendering the msg.                           */
+static  SMTPc_MSG             BenchMsg;
+static  SMTPc_MBOX            BenchFrom;
+static  SMTPc_MBOX            BenchTo;
+static  CPU_CHAR              BenchBody[BENCH_BODY_LEN_MAX];
+static  CPU_CHAR              BenchRenderBuf[BENCH_RENDER_BUF_LEN];
+
+static  CPU_INT08U            BenchCycleSrc;
+static  double                BenchTSC_PerNs;                   /* Rate of the time stamp counter (see Note #2c).       */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U   BenchTS_Get_ns   (void);
+
+static  int          BenchCycleOpen   (void);
+
+static  CPU_INT64U   BenchCycleGet    (int            fd);
+
+static  void         BenchCmpl        (SMTPc_ASYNC   *p_async,
+                                       SMTPc_ERR      err,
+                                       void          *p_arg);
+
+static  int          BenchLatCmp      (const  void   *p_a,
+                                       const  void   *p_b);
+
+static  double       BenchLatPctGet   (CPU_INT64U    *p_tbl,
+                                       CPU_INT32U     nbr,
+                                       CPU_INT32U     per_mille);
+
+static  void         BenchRun         (CPU_INT08U     backend,
+                                       CPU_INT32U     sess_nbr,
+                                       BENCH_RESULT  *p_result);
+
+static  void         BenchWr          (const  char   *p_dir,
+                                       BENCH_RESULT  *p_tbl,
+                                       CPU_INT32U     nbr);
+
+
+/*
+*********************************************************************************************************
+*                                               main()
+*
+* Description : Run the comparison & write its results (see Note #3).
+*
+* Argument(s) : argc            Number of arguments.
+*
+*               argv            Arguments.
+*
+* Return(s)   : 0, if NO error(s).
+*
+*               1, otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : (1) Each session holds a descriptor in the client, & one in the server : the limit of
+*                   descriptors is raised to its maximum.
+*********************************************************************************************************
+*/
+
+int  main (int    argc,
+           char  *argv[])
+{
+    BENCH_RESULT   run_tbl[BENCH_BACKEND_NBR][BENCH_RUN_NBR];
+    BENCH_RESULT   result_tbl[(sizeof(BenchSessNbrTbl) / sizeof(BenchSessNbrTbl[0])) *
+                              (sizeof(BenchBodyLenTbl) / sizeof(BenchBodyLenTbl[0])) * BENCH_BACKEND_NBR];
+    BENCH_RESULT   result;
+    struct rlimit  lim;
+    const  char   *p_dir;
+    CPU_INT32U     sess_tbl_nbr;
+    CPU_INT32U     run_nbr;
+    CPU_INT32U     nbr;
+    CPU_INT32U     i;
+    CPU_INT32U     j;
+    CPU_INT32U     l;
+    CPU_INT32U     k;
+    CPU_INT32U     m;
+    CPU_INT08U     b;
+    CPU_INT64U     ts;
+    CPU_INT64U     cycles;
+    pid_t          srv_pid;
+    int            fd;
+    int            opt;
+    SMTPc_ERR      err;
+
+
+    p_dir        = "results";
+    sess_tbl_nbr = sizeof(BenchSessNbrTbl) / sizeof(BenchSessNbrTbl[0]);
+    run_nbr      = BENCH_RUN_NBR;
+    while ((opt = getopt(argc, argv, "o:q")) != -1) {
+        switch (opt) {
+            case 'o':
+                 p_dir = optarg;
+                 break;
+
+            case 'q':
+                 sess_tbl_nbr = 1u;
+                 run_nbr      = 1u;
+                 break;
+
+            default:
+                 fprintf(stderr, "usage: %s [-o <dir>] [-q]\n", argv[0]);
+                 return (1);
+        }
+    }
+
+    CPU_Init();
+    Mem_Init();
+
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {                  /* See Note #1.                                         */
+        lim.rlim_cur = lim.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &lim);
+    }
+    if (lim.rlim_cur < BENCH_SESS_NBR_MAX + 64u) {
+        fprintf(stderr, "descriptor limit %lu too low for %u sessions\n",
+                (unsigned long)lim.rlim_cur, (unsigned)BENCH_SESS_NBR_MAX);
+        return (1);
+    }
+
+    srv_pid = BenchSrv_Start(&BenchSrvPort);
+    if (srv_pid < 0) {
+        fprintf(stderr, "BenchSrv_Start() failed\n");
+        return (1);
+    }
+                                                                /* ------------------- INIT BACKENDS ------------------ */
+    SMTPc_ReactorEpoll_Init(&BenchReactor, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_ReactorEpoll_Init(): %u\n", err);
+        return (1);
+    }
+    SMTPc_TransportUring_Init(BENCH_SESS_NBR_MAX, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_TransportUring_Init(): %u\n", err);
+        return (1);
+    }
+                                                                /* --------------------- BUILD MSG -------------------- */
+    for (i = 0u; i < BENCH_BODY_LEN_MAX; i++) {
+        switch (i % BENCH_LINE_LEN) {
+            case BENCH_LINE_LEN - 2u:
+                 BenchBody[i] = ASCII_CHAR_CARRIAGE_RETURN;
+                 break;
+
+            case BENCH_LINE_LEN - 1u:
+                 BenchBody[i] = ASCII_CHAR_LINE_FEED;
+                 break;
+
+            default:
+                 BenchBody[i] = (CPU_CHAR)('a' + ((i * 7u) % 26u));
+                 break;
+        }
+    }
+    SMTPc_SetMbox(&BenchFrom, "Bench", "bench@example.com", &err);
+    SMTPc_SetMbox(&BenchTo,   "",      "rcpt@example.com",  &err);
+    SMTPc_SetMsg(&BenchMsg, &err);
+    BenchMsg.From              = &BenchFrom;
+    BenchMsg.ToArray[0]        = &BenchTo;
+    BenchMsg.Subject           = "Benchmark";
+    BenchMsg.ContentBodyMsg    = BenchBody;
+
+    BenchJobTbl       = calloc(BENCH_SESS_NBR_MAX, sizeof(SMTPc_ASYNC));
+    BenchSubmitTS_Tbl = calloc(BENCH_SESS_NBR_MAX, sizeof(CPU_INT64U));
+    BenchLatTbl       = calloc(BENCH_SESS_NBR_MAX, sizeof(CPU_INT64U));
+    if ((BenchJobTbl       == NULL) ||
+        (BenchSubmitTS_Tbl == NULL) ||
+        (BenchLatTbl       == NULL)) {
+        return (1);
+    }
+
+    BenchCycleSrc = BENCH_CYCLE_SRC_NONE;                       /* See Note #2c.                                        */
+    fd            = BenchCycleOpen();
+    if (fd >= 0) {
+        BenchCycleSrc = BENCH_CYCLE_SRC_PERF;
+        close(fd);
+    } else {
+#if (defined(__x86_64__) || defined(__i386__))
+        BenchCycleSrc  = BENCH_CYCLE_SRC_TSC;
+        ts             = BenchTS_Get_ns();
+        cycles         = __rdtsc();
+        usleep(100000u);
+        BenchTSC_PerNs = (double)(__rdtsc() - cycles) / (double)(BenchTS_Get_ns() - ts);
+#endif
+    }
+                                                                /* ---------------------- RUN ------------------------- */
+    printf("%6s %7s %6s %6s %9s %10s %10s %10s %10s %12s\n",
+           "", "sessions", "body", "failed", "msg/s", "p50(us)", "p99(us)", "p999(us)", "max(us)", "cycles/msg");
+    nbr = 0u;
+    for (i = 0u; i < sess_tbl_nbr; i++) {
+        for (l = 0u; l < sizeof(BenchBodyLenTbl) / sizeof(BenchBodyLenTbl[0]); l++) {
+            BenchMsg.ContentBodyMsgLen = BenchBodyLenTbl[l];
+            SMTPc_RenderMsg(&BenchSess, &BenchMsg, BenchRenderBuf, BENCH_RENDER_BUF_LEN, &err);
+            if (err != SMTPc_ERR_NONE) {
+                fprintf(stderr, "SMTPc_RenderMsg(): %u\n", err);
+                return (1);
+            }
+            for (j = 0u; j < run_nbr; j++) {                    /* See Note #2.                                         */
+                for (b = 0u; b < BENCH_BACKEND_NBR; b++) {
+                    BenchRun(b, BenchSessNbrTbl[i], &run_tbl[b][j]);
+                }
+            }
+            for (b = 0u; b < BENCH_BACKEND_NBR; b++) {          /* Sort the runs by duration, take the median.          */
+                for (k = 1u; k < run_nbr; k++) {
+                    for (m = k; (m > 0u) && (run_tbl[b][m - 1u].Elapsed_s > run_tbl[b][m].Elapsed_s); m--) {
+                        result             = run_tbl[b][m];
+                        run_tbl[b][m]      = run_tbl[b][m - 1u];
+                        run_tbl[b][m - 1u] = result;
+                    }
+                }
+                result_tbl[nbr]         = run_tbl[b][run_nbr / 2u];
+                result_tbl[nbr].BodyLen = BenchBodyLenTbl[l];
+                printf("%6s %7u %6u %6u %9.0f %10.1f %10.1f %10.1f %10.1f %12.0f\n",
+                       BenchBackendTbl[b],
+                       (unsigned)result_tbl[nbr].SessNbr,
+                       (unsigned)result_tbl[nbr].BodyLen,
+                       (unsigned)result_tbl[nbr].FailCtr,
+                       result_tbl[nbr].MsgPerSec,
+                       result_tbl[nbr].P50_us,
+                       result_tbl[nbr].P99_us,
+                       result_tbl[nbr].P999_us,
+                       result_tbl[nbr].Max_us,
+                       result_tbl[nbr].CyclesPerMsg);
+                nbr++;
+            }
+        }
+    }
+    printf("cycle source: %s\n", BenchCycleSrcTbl[BenchCycleSrc]);
+
+    BenchSrv_Stop(srv_pid);
+
+    BenchWr(p_dir, result_tbl, nbr);
+
+    return (0);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          BenchTS_Get_ns()
+*
+* Description : Get the time of the monotonic clock.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in nanoseconds.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchTS_Get_ns (void)
+{
+    struct  timespec  ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((CPU_INT64U)ts.tv_sec * 1000000000u) + (CPU_INT64U)ts.tv_nsec);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchCycleOpen()
+*
+* Description : Open the cycle counter of the calling thread.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Descriptor of the counter, counting,
+*
+*               -1, if the counter is unavailable.
+*
+* Caller(s)   : main(),
+*               BenchRun().
+*
+* Note(s)     : (1) See 'bench_msg.c  BenchCycleOpen()  Note #1'.
+*********************************************************************************************************
+*/
+
+static  int  BenchCycleOpen (void)
+{
+    struct  perf_event_attr  attr;
+    int                      fd;
+
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;                                    /* See Note #1.                                         */
+    attr.exclude_hv     = 1;
+
+    fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+        return (-1);
+    }
+    ioctl(fd, PERF_EVENT_IOC_RESET,  0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+
+    return (fd);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BenchCycleGet()
+*
+* Description : Read the cycle counter of the calling thread (see 'bench_uring.c  Note #2c').
+*
+* Argument(s) : fd              Descriptor of the counter, if the source is the kernel counter.
+*
+* Return(s)   : Number of cycles counted.
+*
+* Caller(s)   : BenchRun().
+*
+* Note(s)     : (1) The CPU time of the thread includes the time spent in the kernel : the system calls of
+*                   the backends are counted, unlike with the kernel counter.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  BenchCycleGet (int  fd)
+{
+    struct  timespec  ts;
+    CPU_INT64U        cycles;
+
+
+    cycles = 0u;
+    switch (BenchCycleSrc) {
+        case BENCH_CYCLE_SRC_PERF:
+             if (read(fd, &cycles, sizeof(cycles)) != (ssize_t)sizeof(cycles)) {
+                 cycles = 0u;
+             }
+             break;
+
+        case BENCH_CYCLE_SRC_TSC:                               /* See Note #1.                                         */
+             clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+             cycles = (CPU_INT64U)((((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec) * BenchTSC_PerNs);
+             break;
+
+        default:
+             break;
+    }
+
+    return (cycles);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             BenchCmpl()
+*
+* Description : Record the completion of a job.
+*
+* Argument(s) : p_async         Pointer to the job.
+*
+*               err             Result of the job.
+*
+*               p_arg           Index of the job.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_Poll() & SMTPc_ReactorEpoll_Run(), through the jobs.
+*
+* Note(s)     : (1) The reactor is stopped once the last job of the run completed.
+*********************************************************************************************************
+*/
+
+static  void  BenchCmpl (SMTPc_ASYNC  *p_async,
+                         SMTPc_ERR     err,
+                         void         *p_arg)
+{
+    CPU_INT32U  ix;
+
+
+    (void)p_async;
+
+    ix              = (CPU_INT32U)(uintptr_t)p_arg;
+    BenchLatTbl[ix] = BenchTS_Get_ns() - BenchSubmitTS_Tbl[ix];
+    if (err != SMTPc_ERR_NONE) {
+        BenchFailCtr++;
+    }
+
+    BenchCmplCtr++;
+    if ((BenchCmplCtr == BenchJobNbr) &&                        /* See Note #1.                                         */
+        (BenchBackend == BENCH_BACKEND_EPOLL)) {
+        SMTPc_ReactorEpoll_Stop(&BenchReactor);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            BenchLatCmp()
+*
+* Description : Compare two latencies, for qsort().
+*
+* Argument(s) : p_a             Pointer to the first  latency.
+*
+*               p_b             Pointer to the second latency.
+*
+* Return(s)   : < 0, = 0 or > 0, as the first latency is shorter, equal or longer.
+*
+* Caller(s)   : BenchRun(), through qsort().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  int  BenchLatCmp (const  void  *p_a,
+                          const  void  *p_b)
+{
+    CPU_INT64U  a;
+    CPU_INT64U  b;
+
+
+    a = *(const CPU_INT64U *)p_a;
+    b = *(const CPU_INT64U *)p_b;
+
+    return ((a > b) - (a < b));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          BenchLatPctGet()
+*
+* Description : Get a percentile of sorted latencies.
+*
+* Argument(s) : p_tbl           Pointer to the latencies, sorted, in nanoseconds.
+*
+*               nbr             Number of latencies, MUST be non-null.
+*
+*               per_mille       Percentile, in thousandths.
+*
+* Return(s)   : Latency of rank ceil(per_mille * nbr / 1000), in microseconds.
+*
+* Caller(s)   : BenchRun().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  double  BenchLatPctGet (CPU_INT64U  *p_tbl,
+                                CPU_INT32U   nbr,
+                                CPU_INT32U   per_mille)
+{
+    CPU_INT64U  rank;
+
+
+    rank = (((CPU_INT64U)nbr * per_mille) + 999u) / 1000u;
+    if (rank == 0u) {
+        rank = 1u;
+    }
+
+    return ((double)p_tbl[rank - 1u] / 1000.0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             BenchRun()
+*
+* Description : Run the job set once on a backend (see 'bench_uring.c  Note #2').
+*
+* Argument(s) : backend         Backend (BENCH_BACKEND_xxx).
+*
+*               sess_nbr        Number of jobs, all submitted at once.
+*
+*               p_result        Pointer to the variable that will receive the results.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : (1) The reactor resolves the host name of the jobs on submission : the IP address of the
+*                   server is passed, which is resolved without lookup.
+*
+*               (2) See 'smtp-c_transport_uring.h  Note #2'.
+*********************************************************************************************************
+*/
+
+static  void  BenchRun (CPU_INT08U     backend,
+                        CPU_INT32U     sess_nbr,
+                        BENCH_RESULT  *p_result)
+{
+    CPU_INT64U  ts;
+    CPU_INT64U  cycles;
+    CPU_INT32U  i;
+    int         fd;
+    SMTPc_ERR   err;
+
+
+    BenchBackend = backend;
+    BenchJobNbr  = sess_nbr;
+    BenchCmplCtr = 0u;
+    BenchFailCtr = 0u;
+    SMTPc_TransportSet((backend == BENCH_BACKEND_EPOLL) ? &SMTPc_TransportAPI_Posix : &SMTPc_TransportAPI_Uring, &err);
+
+    fd     = (BenchCycleSrc == BENCH_CYCLE_SRC_PERF) ? BenchCycleOpen() : -1;
+    cycles = BenchCycleGet(fd);
+    ts     = BenchTS_Get_ns();
+                                                                /* -------------------- SUBMIT JOBS ------------------- */
+    for (i = 0u; i < sess_nbr; i++) {
+        BenchSubmitTS_Tbl[i] = BenchTS_Get_ns();
+        if (backend == BENCH_BACKEND_EPOLL) {                   /* See Note #1.                                         */
+            SMTPc_ReactorEpoll_Submit(&BenchReactor, &BenchJobTbl[i], "127.0.0.1", BenchSrvPort,
+                                      DEF_NULL, DEF_NULL, DEF_NULL, &BenchMsg,
+                                      BenchCmpl, (void *)(uintptr_t)i, &err);
+        } else {
+            SMTPc_AsyncSubmit(&BenchJobTbl[i], "127.0.0.1", BenchSrvPort,
+                              DEF_NULL, DEF_NULL, DEF_NULL, &BenchMsg,
+                              BenchCmpl, (void *)(uintptr_t)i, &err);
+        }
+        if (err != SMTPc_ERR_NONE) {
+            BenchCmpl(&BenchJobTbl[i], err, (void *)(uintptr_t)i);
+        }
+    }
+                                                                /* ---------------------- RUN JOBS -------------------- */
+    if (backend == BENCH_BACKEND_EPOLL) {
+        if (BenchCmplCtr < sess_nbr) {
+            SMTPc_ReactorEpoll_Run(&BenchReactor, &err);
+        }
+    } else {
+        while (BenchCmplCtr < sess_nbr) {                       /* See Note #2.                                         */
+            (void)SMTPc_Poll(DEF_INT_16U_MAX_VAL);
+            if (BenchCmplCtr < sess_nbr) {
+                (void)SMTPc_TransportUring_Wait(BENCH_WAIT_MS, &err);
+            }
+        }
+    }
+
+    ts     = BenchTS_Get_ns() - ts;
+    cycles = BenchCycleGet(fd) - cycles;
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    qsort(BenchLatTbl, sess_nbr, sizeof(CPU_INT64U), BenchLatCmp);
+
+    p_result->Backend      = backend;
+    p_result->SessNbr      = sess_nbr;
+    p_result->FailCtr      = BenchFailCtr;
+    p_result->Elapsed_s    = (double)ts / 1e9;
+    p_result->MsgPerSec    = (double)(sess_nbr - BenchFailCtr) / p_result->Elapsed_s;
+    p_result->P50_us       = BenchLatPctGet(BenchLatTbl, sess_nbr, 500u);
+    p_result->P99_us       = BenchLatPctGet(BenchLatTbl, sess_nbr, 990u);
+    p_result->P999_us      = BenchLatPctGet(BenchLatTbl, sess_nbr, 999u);
+    p_result->Max_us       = (double)BenchLatTbl[sess_nbr - 1u] / 1000.0;
+    p_result->CyclesPerMsg = (double)cycles / sess_nbr;
+}
+
+
+/*
+*********************************************************************************************************
+*                                              BenchWr()
+*
+* Description : Write the results, as CSV & JSON (see 'bench_uring.c  Note #3').
+*
+* Argument(s) : p_dir           Directory the files are written to, created if needed.
+*
+*               p_tbl           Pointer to the results.
+*
+*               nbr             Number of results.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  BenchWr (const  char   *p_dir,
+                       BENCH_RESULT  *p_tbl,
+                       CPU_INT32U     nbr)
+{
+    BENCH_RESULT  *p_result;
+    FILE          *p_csv;
+    FILE          *p_json;
+    char           path[512];
+    CPU_INT32U     i;
+
+
+    if ((mkdir(p_dir, 0755) != 0) && (errno != EEXIST)) {
+        perror(p_dir);
+        return;
+    }
+
+    snprintf(path, sizeof(path), "%s/bench_uring.csv", p_dir);
+    p_csv = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s/bench_uring.json", p_dir);
+    p_json = fopen(path, "w");
+    if ((p_csv == NULL) || (p_json == NULL)) {
+        perror(path);
+        return;
+    }
+
+    fprintf(p_csv, "backend,sessions,body_octets,failed,elapsed_s,msgs_per_s,"
+                   "p50_us,p99_us,p999_us,max_us,cycles_per_msg,cycle_src\n");
+    fprintf(p_json, "{\n  \"cycle_src\": \"%s\",\n  \"cpus\": %ld,\n  \"results\": [\n",
+            BenchCycleSrcTbl[BenchCycleSrc], sysconf(_SC_NPROCESSORS_ONLN));
+
+    for (i = 0u; i < nbr; i++) {
+        p_result = &p_tbl[i];
+        fprintf(p_csv, "%s,%u,%u,%u,%.6f,%.1f,%.3f,%.3f,%.3f,%.3f,%.0f,%s\n",
+                BenchBackendTbl[p_result->Backend],
+                (unsigned)p_result->SessNbr,
+                (unsigned)p_result->BodyLen,
+                (unsigned)p_result->FailCtr,
+                p_result->Elapsed_s,
+                p_result->MsgPerSec,
+                p_result->P50_us,
+                p_result->P99_us,
+                p_result->P999_us,
+                p_result->Max_us,
+                p_result->CyclesPerMsg,
+                BenchCycleSrcTbl[BenchCycleSrc]);
+        fprintf(p_json, "    { \"backend\": \"%s\", \"sessions\": %u, \"body_octets\": %u, \"failed\": %u,"
+                        " \"elapsed_s\": %.6f,"
+                        " \"msgs_per_s\": %.1f, \"p50_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f,"
+                        " \"max_us\": %.3f, \"cycles_per_msg\": %.0f }%s\n",
+                BenchBackendTbl[p_result->Backend],
+                (unsigned)p_result->SessNbr,
+                (unsigned)p_result->BodyLen,
+                (unsigned)p_result->FailCtr,
+                p_result->Elapsed_s,
+                p_result->MsgPerSec,
+                p_result->P50_us,
+                p_result->P99_us,
+                p_result->P999_us,
+                p_result->Max_us,
+                p_result->CyclesPerMsg,
+                (i + 1u < nbr) ? "," : "");
+    }
+    fprintf(p_json, "  ]\n}\n");
+
+    fclose(p_csv);
+    fclose(p_json);
+}
@@ -0,0 +1,824 @@
+/*
+*********************************************************************************************************
+*                                              uC/SMTPc
+*                               Simple Mail Transfer Protocol (client)
+*
+*                    Copyright 2004-2021 Silicon Laboratories Inc. www.silabs.com
+*
+*                                 SPDX-License-Identifier: APACHE-2.0
+*
+*               This software is subject to an open source license and is distributed by
+*                Silicon Laboratories Inc. pursuant to the terms of the Apache License,
+*                    Version 2.0 available at www.apache.org/licenses/LICENSE-2.0.
+*
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*
+*                                    uC/SMTPc SERVER FAULT TESTS
+*
+* Filename : test_fault.c
+* Version  : V2.01.01
+*********************************************************************************************************
+* Note(s)  : (1) Linux host program checking the behaviour of the client against the faults injected by the
+*                mock transport (see 'Transport/Mock/smtp-c_transport_mock.h  DATA TYPES  Note #2').  Each
+*                scenario sends one message with SMTPc_Connect(), SMTPc_SendMsg() & SMTPc_Disconnect(),
+*                then one more without fault, from which the mock server measures the recovery time :
+*
+*                (a) "greet_slow" : the greeting comes after SMTPc_CFG_MAX_REP_TIMEOUT_MS.  SMTPc_Connect()
+*                    MUST time out once it expired, & not wait on the connection again to send QUIT.
+*
+*                (b) "seg_1"      : every reply is received one octet at a time.  The message MUST be sent.
+*
+*                (c) "rcpt_421"   : the server replies 421 to RCPT & closes the connection.  Neither RSET
+*                    nor QUIT may be sent.
+*
+*                (d) "eom_drop"   : the server drops the connection after the "." ending the message
+*                    content.  Neither RSET nor QUIT may be sent.
+*
+*                (e) "mail_stall" : the reply to MAIL comes after SMTPc_CFG_MAX_REP_TIMEOUT_MS.
+*                    SMTPc_SendMsg() MUST time out once it expired; neither RSET nor QUIT may be sent.  "mail_np"
+*                    is the same, without PIPELINING advertised : MAIL is then sent & awaited alone.
+*
+*                (f) "rcpt_550"   : the server rejects the recipient, without closing the connection.
+*                    RSET & QUIT MUST still be sent.
+*
+*                The commands sent by the client are recorded by a transport wrapping the mock transport.
+*
+*            (2) "async" submits 1000 jobs at once to the asynchronous engine, run by SMTPc_Poll(), against
+*                a mix of the faults above.  Every job MUST complete, & every message reported as sent MUST
+*                have been accepted by the server.
+*
+*            (3) The latencies (see 'smtp-c_transport_mock.h  DATA TYPES  Note #3') & recovery times (see
+*                'smtp-c_transport_mock.h  DATA TYPES  Note #4') of each scenario are printed :
+*
+*                    test_fault
+*
+*                The program returns 0 if all the checks passed, 1 otherwise.
+*
+*            (4) The tests are built with a SMTPc_CFG_MAX_REP_TIMEOUT_MS of a few seconds (see 'Makefile
+*                Note #7').
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+*                                            INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#define  _GNU_SOURCE
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+
+#include  <cpu.h>
+#include  <cpu_core.h>
+#include  <lib_mem.h>
+
+#include  <Source/smtp-c.h>
+#include  <Transport/Mock/smtp-c_transport_mock.h>
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  TEST_JOB_NBR                                  1000u    /* Nbr of jobs of the async run (see Note #2).          */
+#define  TEST_BODY_LEN                                 1024u    /* Len of the msg body.                                 */
+#define  TEST_LINE_LEN                                   78u    /* Len of the body lines, CRLF included.                */
+#define  TEST_RENDER_BUF_LEN                           4096u    /* Size of the rendered msg.                            */
+#define  TEST_TX_LOG_LEN                              16384u    /* Size of the log of the data tx'd.                    */
+
+                                                                /* Dly of a stalled reply.                              */
+#define  TEST_STALL_MS                (SMTPc_CFG_MAX_REP_TIMEOUT_MS + 1000u)
+#define  TEST_SLACK_MS                                  500u    /* Max time past the timeout.                           */
+#define  TEST_FAST_MS                                   100u    /* Max time of a call that MUST NOT wait.               */
+
+
+/*
+*********************************************************************************************************
+*                                           LOCAL DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  test_result {                                  /* Result of the faulted msg of a scenario.             */
+    SMTPc_ERR    ConnErr;
+    SMTPc_ERR    SendErr;
+    CPU_INT64U   Conn_ms;                                       /* Time SMTPc_Connect()    took.                        */
+    CPU_INT64U   Send_ms;                                       /* Time SMTPc_SendMsg()    took.                        */
+    CPU_INT64U   Disc_ms;                                       /* Time SMTPc_Disconnect() took.                        */
+    CPU_BOOLEAN  RsetTx;                                        /* RSET tx'd after the msg.                             */
+    CPU_BOOLEAN  QuitTx;                                        /* QUIT tx'd after the msg.                             */
+    CPU_INT32U   FaultCtr;                                      /* Nbr of faults injected.                              */
+} TEST_RESULT;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  SMTPc_TRANSPORT_API   TestTransportAPI;                 /* Mock transport, recording the data tx'd.             */
+static  CPU_CHAR              TestTxLog[TEST_TX_LOG_LEN];
+static  CPU_INT32U            TestTxLogLen;
+
+static  SMTPc_MSG             TestMsg;
+static  SMTPc_MSG             TestMsgRender;                    /* Msg rendered for the async jobs.                     */
+static  SMTPc_MBOX            TestFrom;
+static  SMTPc_MBOX            TestTo;
+static  CPU_CHAR              TestBody[TEST_BODY_LEN];
+static  CPU_CHAR              TestRenderBuf[TEST_RENDER_BUF_LEN];
+static  SMTPc_SESSION         TestRenderSess;                   /* Session rendering the msg.                           */
+
+static  SMTPc_ASYNC          *TestJobTbl;
+static  CPU_INT32U            TestCmplCtr;
+static  CPU_INT32U            TestOkCtr;
+
+static  SMTPc_CAP_FLAGS       TestCapFlags;                     /* Extensions advertised by the server.                 */
+static  CPU_INT32U            TestFailCtr;                      /* Nbr of checks failed.                                */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U   TestTS_Get_ms (void);
+
+static  CPU_INT32U   TestTx        (SMTPc_SOCK_ID                sock_id,
+                                    const  void                 *p_data,
+                                    CPU_INT32U                   len,
+                                    SMTPc_ERR                   *p_err);
+
+static  CPU_INT32U   TestTxV       (SMTPc_SOCK_ID                sock_id,
+                                    const  SMTPc_TRANSPORT_VEC  *p_vec,
+                                    CPU_INT08U                   vec_nbr,
+                                    SMTPc_ERR                   *p_err);
+
+static  void         TestTxLogAdd  (const  void                 *p_data,
+                                    CPU_INT32U                   len);
+
+static  CPU_BOOLEAN  TestTxLogHas  (const  CPU_CHAR             *p_cmd);
+
+static  void         TestChk       (CPU_BOOLEAN                  ok,
+                                    const  char                 *p_scenario,
+                                    const  char                 *p_desc);
+
+static  void         TestCfgSet    (const  SMTPc_TRANSPORT_MOCK_FAULT  *p_fault_tbl,
+                                    CPU_INT08U                   fault_nbr);
+
+static  void         TestRun       (const  char                 *p_scenario,
+                                    const  SMTPc_TRANSPORT_MOCK_FAULT  *p_fault_tbl,
+                                    CPU_INT08U                   fault_nbr,
+                                    TEST_RESULT                 *p_result);
+
+static  void         TestCmpl      (SMTPc_ASYNC                 *p_async,
+                                    SMTPc_ERR                    err,
+                                    void                        *p_arg);
+
+static  void         TestAsync     (void);
+
+
+/*
+*********************************************************************************************************
+*                                               main()
+*
+* Description : Run the scenarios (see Note #1) & report the checks failed.
+*
+* Argument(s) : argc            Number of arguments (unused).
+*
+*               argv            Arguments (unused).
+*
+* Return(s)   : 0, if all the checks passed.
+*
+*               1, otherwise.
+*
+* Caller(s)   : Application.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+int  main (int    argc,
+           char  *argv[])
+{
+    SMTPc_TRANSPORT_MOCK_FAULT  fault;
+    TEST_RESULT                 result;
+    CPU_INT32U                  i;
+    SMTPc_ERR                   err;
+
+
+    (void)argc;
+    (void)argv;
+
+    CPU_Init();
+    Mem_Init();
+
+    SMTPc_TransportMock_Init(TEST_JOB_NBR + 1u, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_TransportMock_Init(): %u\n", err);
+        return (1);
+    }
+    TestTransportAPI     = SMTPc_TransportAPI_Mock;
+    TestTransportAPI.Tx  = TestTx;
+    TestTransportAPI.TxV = TestTxV;
+    SMTPc_TransportSet(&TestTransportAPI, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_TransportSet(): %u\n", err);
+        return (1);
+    }
+                                                                /* --------------------- BUILD MSG -------------------- */
+    for (i = 0u; i < TEST_BODY_LEN; i++) {
+        switch (i % TEST_LINE_LEN) {
+            case TEST_LINE_LEN - 2u:
+                 TestBody[i] = ASCII_CHAR_CARRIAGE_RETURN;
+                 break;
+
+            case TEST_LINE_LEN - 1u:
+                 TestBody[i] = ASCII_CHAR_LINE_FEED;
+                 break;
+
+            default:
+                 TestBody[i] = (CPU_CHAR)('a' + ((i * 7u) % 26u));
+                 break;
+        }
+    }
+    SMTPc_SetMbox(&TestFrom, "Test", "test@example.com", &err);
+    SMTPc_SetMbox(&TestTo,   "",     "rcpt@example.com", &err);
+    SMTPc_SetMsg(&TestMsg, &err);
+    TestMsg.From              = &TestFrom;
+    TestMsg.ToArray[0]        = &TestTo;
+    TestMsg.Subject           = "Test";
+    TestMsg.ContentBodyMsg    = TestBody;
+    TestMsg.ContentBodyMsgLen = TEST_BODY_LEN;
+    TestMsgRender             = TestMsg;
+    SMTPc_RenderMsg(&TestRenderSess, &TestMsgRender, TestRenderBuf, TEST_RENDER_BUF_LEN, &err);
+    if (err != SMTPc_ERR_NONE) {
+        fprintf(stderr, "SMTPc_RenderMsg(): %u\n", err);
+        return (1);
+    }
+
+    TestCapFlags = SMTPc_CAP_PIPELINING | SMTPc_CAP_8BITMIME | SMTPc_CAP_ENHSTATUS;
+    printf("%-10s %5s %5s %8s %8s %8s %4s %4s %8s %8s %8s %8s %9s %9s\n",
+           "", "conn", "send", "conn(ms)", "send(ms)", "disc(ms)", "rset", "quit",
+           "p50(us)", "p99(us)", "p999(us)", "max(us)", "recov(ms)", "recovmax");
+                                                                /* -------------------- SCENARIOS --------------------- */
+    TestRun("clean", DEF_NULL, 0u, &result);
+    TestChk(((result.ConnErr == SMTPc_ERR_NONE) &&
+             (result.SendErr == SMTPc_ERR_NONE)), "clean", "msg sent");
+    TestChk( result.QuitTx  == DEF_YES,          "clean", "QUIT sent");
+
+    Mem_Clr(&fault, sizeof(fault));                             /* See Note #1a.                                        */
+    fault.Cmd    = SMTPc_TRANSPORT_MOCK_CMD_CONN;
+    fault.Period = 1u;
+    fault.DlyMs  = TEST_STALL_MS;
+    TestRun("greet_slow", &fault, 1u, &result);
+    TestChk( result.ConnErr != SMTPc_ERR_NONE,                  "greet_slow", "SMTPc_Connect() failed");
+    TestChk( result.Conn_ms >= SMTPc_CFG_MAX_REP_TIMEOUT_MS,    "greet_slow", "timeout not early");
+    TestChk( result.Conn_ms <  SMTPc_CFG_MAX_REP_TIMEOUT_MS + TEST_SLACK_MS, "greet_slow", "timeout on time");
+    TestChk( result.QuitTx  == DEF_NO,                          "greet_slow", "QUIT skipped");
+
+    Mem_Clr(&fault, sizeof(fault));                             /* See Note #1b.                                        */
+    fault.Cmd    = SMTPc_TRANSPORT_MOCK_CMD_ANY;
+    fault.Period = 1u;
+    fault.SegLen = 1u;
+    TestRun("seg_1", &fault, 1u, &result);
+    TestChk(((result.ConnErr == SMTPc_ERR_NONE) &&
+             (result.SendErr == SMTPc_ERR_NONE)), "seg_1", "msg sent");
+    TestChk( result.FaultCtr > 0u,               "seg_1", "replies split");
+    TestChk( result.QuitTx  == DEF_YES,          "seg_1", "QUIT sent");
+
+    Mem_Clr(&fault, sizeof(fault));                             /* See Note #1c.                                        */
+    fault.Cmd     = SMTPc_TRANSPORT_MOCK_CMD_RCPT;
+    fault.Period  = 1u;
+    fault.RepCode = 421u;
+    TestRun("rcpt_421", &fault, 1u, &result);
+    TestChk( result.SendErr != SMTPc_ERR_NONE,   "rcpt_421", "SMTPc_SendMsg() failed");
+    TestChk( result.Disc_ms <  TEST_FAST_MS,     "rcpt_421", "SMTPc_Disconnect() did not wait");
+    TestChk((result.RsetTx  == DEF_NO) &&
+            (result.QuitTx  == DEF_NO),          "rcpt_421", "RSET & QUIT skipped");
+
+    Mem_Clr(&fault, sizeof(fault));                             /* See Note #1d.                                        */
+    fault.Cmd    = SMTPc_TRANSPORT_MOCK_CMD_EOM;
+    fault.Period = 1u;
+    fault.Drop   = DEF_YES;
+    TestRun("eom_drop", &fault, 1u, &result);
+    TestChk( result.SendErr != SMTPc_ERR_NONE,   "eom_drop", "SMTPc_SendMsg() failed");
+    TestChk( result.Disc_ms <  TEST_FAST_MS,     "eom_drop", "SMTPc_Disconnect() did not wait");
+    TestChk((result.RsetTx  == DEF_NO) &&
+            (result.QuitTx  == DEF_NO),          "eom_drop", "RSET & QUIT skipped");
+
+    Mem_Clr(&fault, sizeof(fault));                             /* See Note #1e.                                        */
+    fault.Cmd    = SMTPc_TRANSPORT_MOCK_CMD_MAIL;
+    fault.Period = 1u;
+    fault.DlyMs  = TEST_STALL_MS;
+    TestRun("mail_stall", &fault, 1u, &result);
+    TestChk( result.SendErr != SMTPc_ERR_NONE,                  "mail_stall", "SMTPc_SendMsg() failed");
+    TestChk( result.Send_ms >= SMTPc_CFG_MAX_REP_TIMEOUT_MS,    "mail_stall", "timeout not early");
+    TestChk( result.Send_ms <  SMTPc_CFG_MAX_REP_TIMEOUT_MS + TEST_SLACK_MS, "mail_stall", "timeout on time");
+    TestChk( result.Disc_ms <  TEST_FAST_MS,                    "mail_stall", "SMTPc_Disconnect() did not wait");
+    TestChk((result.RsetTx  == DEF_NO) &&
+            (result.QuitTx  == DEF_NO),                         "mail_stall", "RSET & QUIT skipped");
+
+    TestCapFlags = SMTPc_CAP_8BITMIME | SMTPc_CAP_ENHSTATUS;
+    TestRun("mail_np", &fault, 1u, &result);
+    TestCapFlags = SMTPc_CAP_PIPELINING | SMTPc_CAP_8BITMIME | SMTPc_CAP_ENHSTATUS;
+    TestChk( result.SendErr != SMTPc_ERR_NONE,                  "mail_np", "SMTPc_SendMsg() failed");
+    TestChk( result.Send_ms <  SMTPc_CFG_MAX_REP_TIMEOUT_MS + TEST_SLACK_MS, "mail_np", "timeout on time");
+    TestChk((result.RsetTx  == DEF_NO) &&
+            (result.QuitTx  == DEF_NO),                         "mail_np", "RSET & QUIT skipped");
+
+    Mem_Clr(&fault, sizeof(fault));                             /* See Note #1f.                                        */
+    fault.Cmd     = SMTPc_TRANSPORT_MOCK_CMD_RCPT;
+    fault.Period  = 1u;
+    fault.RepCode = 550u;
+    TestRun("rcpt_550", &fault, 1u, &result);
+    TestChk( result.SendErr == SMTPc_ERR_REP,    "rcpt_550", "SMTPc_SendMsg() rejected");
+    TestChk((result.RsetTx  == DEF_YES) &&
+            (result.QuitTx  == DEF_YES),         "rcpt_550", "RSET & QUIT sent");
+
+    TestAsync();                                                /* See Note #2.                                         */
+
+    if (TestFailCtr > 0u) {
+        printf("%u check(s) failed\n", (unsigned)TestFailCtr);
+        return (1);
+    }
+    printf("all checks passed\n");
+
+    return (0);
+}
+
+
+/*
+*********************************************************************************************************
+*********************************************************************************************************
+*                                           LOCAL FUNCTIONS
+*********************************************************************************************************
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          TestTS_Get_ms()
+*
+* Description : Get the time of the monotonic clock.
+*
+* Argument(s) : none.
+*
+* Return(s)   : Time, in milliseconds.
+*
+* Caller(s)   : Various.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  TestTS_Get_ms (void)
+{
+    struct  timespec  ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((CPU_INT64U)ts.tv_sec * 1000u) + ((CPU_INT64U)ts.tv_nsec / 1000000u));
+}
+
+
+/*
+*********************************************************************************************************
+*                                              TestTx()
+*
+* Description : Send data over the mock transport & record the data sent.
+*
+* Argument(s) : sock_id         Connection to send on.
+*
+*               p_data          Pointer to the data.
+*
+*               len             Length of the data.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function (see 'smtp-c.h  SMTPc_TRANSPORT_API').
+*
+* Return(s)   : Number of octets sent.
+*
+* Caller(s)   : Various, through TestTransportAPI.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  TestTx (SMTPc_SOCK_ID   sock_id,
+                            const  void    *p_data,
+                            CPU_INT32U      len,
+                            SMTPc_ERR      *p_err)
+{
+    CPU_INT32U  tx_len;
+
+
+    tx_len = SMTPc_TransportAPI_Mock.Tx(sock_id, p_data, len, p_err);
+    TestTxLogAdd(p_data, tx_len);
+
+    return (tx_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                              TestTxV()
+*
+* Description : Send several buffers over the mock transport & record the data sent.
+*
+* Argument(s) : sock_id         Connection to send on.
+*
+*               p_vec           Pointer to the buffers.
+*
+*               vec_nbr         Number of buffers.
+*
+*               p_err           Pointer to variable that will hold the return error code from this
+*                               function (see 'smtp-c.h  SMTPc_TRANSPORT_API').
+*
+* Return(s)   : Number of octets sent.
+*
+* Caller(s)   : Various, through TestTransportAPI.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  TestTxV (SMTPc_SOCK_ID                sock_id,
+                             const  SMTPc_TRANSPORT_VEC  *p_vec,
+                             CPU_INT08U                   vec_nbr,
+                             SMTPc_ERR                   *p_err)
+{
+    CPU_INT32U  tx_len;
+    CPU_INT32U  len;
+    CPU_INT32U  rem;
+    CPU_INT08U  i;
+
+
+    tx_len = SMTPc_TransportAPI_Mock.TxV(sock_id, p_vec, vec_nbr, p_err);
+    rem    = tx_len;
+    for (i = 0u; (i < vec_nbr) && (rem > 0u); i++) {
+        len  = DEF_MIN(p_vec[i].Len, rem);
+        TestTxLogAdd(p_vec[i].DataPtr, len);
+        rem -= len;
+    }
+
+    return (tx_len);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           TestTxLogAdd()
+*
+* Description : Append data sent to the log.
+*
+* Argument(s) : p_data          Pointer to the data.
+*
+*               len             Length of the data.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : TestTx(),
+*               TestTxV().
+*
+* Note(s)     : (1) The data past the size of the log is dropped : the log only holds the commands of a
+*                   few messages.
+*********************************************************************************************************
+*/
+
+static  void  TestTxLogAdd (const  void        *p_data,
+                            CPU_INT32U          len)
+{
+    len = DEF_MIN(len, TEST_TX_LOG_LEN - TestTxLogLen);         /* See Note #1.                                         */
+    Mem_Copy(&TestTxLog[TestTxLogLen], p_data, len);
+    TestTxLogLen += len;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           TestTxLogHas()
+*
+* Description : Find a command in the log.
+*
+* Argument(s) : p_cmd           Pointer to the command, without its CRLF.
+*
+* Return(s)   : DEF_YES, if the command was sent since the log was cleared.
+*
+*               DEF_NO,  otherwise.
+*
+* Caller(s)   : TestRun().
+*
+* Note(s)     : (1) A command begins a line; the body of the message has no upper case letter.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  TestTxLogHas (const  CPU_CHAR  *p_cmd)
+{
+    CPU_CHAR    line[16];
+    CPU_INT32U  len;
+
+
+    len = (CPU_INT32U)snprintf(line, sizeof(line), "%s\r\n", p_cmd);
+    if (TestTxLogLen < len) {
+        return (DEF_NO);
+    }
+    if (memcmp(TestTxLog, line, len) == 0) {
+        return (DEF_YES);
+    }
+
+                                                                /* See Note #1.                                         */
+    len = (CPU_INT32U)snprintf(line, sizeof(line), "\n%s\r\n", p_cmd);
+    if (memmem(TestTxLog, TestTxLogLen, line, len) != NULL) {
+        return (DEF_YES);
+    }
+
+    return (DEF_NO);
+}
+
+
+/*
+*********************************************************************************************************
+*                                              TestChk()
+*
+* Description : Report a check.
+*
+* Argument(s) : ok              DEF_YES, if the check passed.
+*
+*               p_scenario      Name of the scenario.
+*
+*               p_desc          Description of the check.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main(),
+*               TestAsync().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  TestChk (CPU_BOOLEAN   ok,
+                       const  char  *p_scenario,
+                       const  char  *p_desc)
+{
+    if (ok != DEF_YES) {
+        printf("FAIL %s: %s\n", p_scenario, p_desc);
+        TestFailCtr++;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            TestCfgSet()
+*
+* Description : Configure the mock server.
+*
+* Argument(s) : p_fault_tbl     Pointer to the faults to inject.
+*
+*               fault_nbr       Number of faults.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : TestRun(),
+*               TestAsync().
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  TestCfgSet (const  SMTPc_TRANSPORT_MOCK_FAULT  *p_fault_tbl,
+                          CPU_INT08U                         fault_nbr)
+{
+    SMTPc_TRANSPORT_MOCK_CFG  cfg;
+    SMTPc_ERR                 err;
+
+
+    Mem_Clr(&cfg, sizeof(cfg));
+    cfg.CapFlags = TestCapFlags;
+    cfg.FaultTbl = p_fault_tbl;
+    cfg.FaultNbr = fault_nbr;
+    SMTPc_TransportMock_CfgSet(&cfg, &err);
+    TestChk((err == SMTPc_ERR_NONE) ? DEF_YES : DEF_NO, "cfg", "SMTPc_TransportMock_CfgSet()");
+}
+
+
+/*
+*********************************************************************************************************
+*                                              TestRun()
+*
+* Description : Run a scenario & print its results (see 'test_fault.c  Note #1').
+*
+* Argument(s) : p_scenario      Name of the scenario.
+*
+*               p_fault_tbl     Pointer to the faults injected in the first message.
+*
+*               fault_nbr       Number of faults.
+*
+*               p_result        Pointer to the variable that will receive the results of the first message.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : (1) The message sent without fault MUST be accepted : the recovery time runs from the first
+*                   fault to its acceptance.
+*********************************************************************************************************
+*/
+
+static  void  TestRun (const  char                        *p_scenario,
+                       const  SMTPc_TRANSPORT_MOCK_FAULT  *p_fault_tbl,
+                       CPU_INT08U                          fault_nbr,
+                       TEST_RESULT                        *p_result)
+{
+    SMTPc_TRANSPORT_MOCK_STATS  stats;
+    SMTPc_SOCK_ID               sock_id;
+    CPU_INT64U                  ts;
+    SMTPc_ERR                   err;
+
+
+    Mem_Clr(p_result, sizeof(*p_result));
+    p_result->SendErr = SMTPc_ERR_NOT_CONNECTED;
+    SMTPc_TransportMock_StatsClr();
+                                                                /* ------------------ FAULTED MSG --------------------- */
+    TestCfgSet(p_fault_tbl, fault_nbr);
+    TestTxLogLen      = 0u;
+    ts                = TestTS_Get_ms();
+    sock_id           = SMTPc_Connect("mock", 0u, DEF_NULL, DEF_NULL, DEF_NULL, &p_result->ConnErr);
+    p_result->Conn_ms = TestTS_Get_ms() - ts;
+    if (p_result->ConnErr == SMTPc_ERR_NONE) {
+        ts                = TestTS_Get_ms();
+        SMTPc_SendMsg(sock_id, &TestMsg, &p_result->SendErr);
+        p_result->Send_ms = TestTS_Get_ms() - ts;
+        ts                = TestTS_Get_ms();
+        SMTPc_Disconnect(sock_id, &err);
+        p_result->Disc_ms = TestTS_Get_ms() - ts;
+    }
+    p_result->RsetTx = TestTxLogHas("RSET");
+    p_result->QuitTx = TestTxLogHas("QUIT");
+                                                                /* -------------------- CLEAN MSG --------------------- */
+    TestCfgSet(DEF_NULL, 0u);                                   /* See Note #1.                                         */
+    sock_id = SMTPc_Connect("mock", 0u, DEF_NULL, DEF_NULL, DEF_NULL, &err);
+    if (err == SMTPc_ERR_NONE) {
+        SMTPc_SendMsg(sock_id, &TestMsg, &err);
+        TestChk((err == SMTPc_ERR_NONE) ? DEF_YES : DEF_NO, p_scenario, "msg sent after the fault");
+        SMTPc_Disconnect(sock_id, &err);
+    } else {
+        TestChk(DEF_NO, p_scenario, "connected after the fault");
+    }
+
+    SMTPc_TransportMock_StatsGet(&stats);
+    p_result->FaultCtr = stats.FaultCtr;
+    printf("%-10s %5u %5u %8llu %8llu %8llu %4s %4s %8u %8u %8u %8u %9u %9u\n",
+           p_scenario,
+           (unsigned)p_result->ConnErr,
+           (unsigned)p_result->SendErr,
+           (unsigned long long)p_result->Conn_ms,
+           (unsigned long long)p_result->Send_ms,
+           (unsigned long long)p_result->Disc_ms,
+           (p_result->RsetTx == DEF_YES) ? "yes" : "no",
+           (p_result->QuitTx == DEF_YES) ? "yes" : "no",
+           (unsigned)stats.LatP50_us,
+           (unsigned)stats.LatP99_us,
+           (unsigned)stats.LatP999_us,
+           (unsigned)stats.LatMax_us,
+           (unsigned)stats.RecovAvg_ms,
+           (unsigned)stats.RecovMax_ms);
+}
+
+
+/*
+*********************************************************************************************************
+*                                              TestCmpl()
+*
+* Description : Record the completion of a job of the async run.
+*
+* Argument(s) : p_async         Pointer to the job (unused).
+*
+*               err             Result of the job.
+*
+*               p_arg           Argument of the job (unused).
+*
+* Return(s)   : none.
+*
+* Caller(s)   : SMTPc_Poll(), through the jobs.
+*
+* Note(s)     : none.
+*********************************************************************************************************
+*/
+
+static  void  TestCmpl (SMTPc_ASYNC  *p_async,
+                        SMTPc_ERR     err,
+                        void         *p_arg)
+{
+    (void)p_async;
+    (void)p_arg;
+
+    if (err == SMTPc_ERR_NONE) {
+        TestOkCtr++;
+    }
+    TestCmplCtr++;
+}
+
+
+/*
+*********************************************************************************************************
+*                                             TestAsync()
+*
+* Description : Run the jobs of the async run against a mix of faults (see 'test_fault.c  Note #2').
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Caller(s)   : main().
+*
+* Note(s)     : (1) The jobs never wait : SMTPc_Poll() is called until they all completed, or until they
+*                   had the time to expire (see 'smtp-c_cfg.h  Note #14').
+*********************************************************************************************************
+*/
+
+static  void  TestAsync (void)
+{
+    SMTPc_TRANSPORT_MOCK_FAULT  fault_tbl[3];
+    SMTPc_TRANSPORT_MOCK_STATS  stats;
+    CPU_INT64U                  ts;
+    CPU_INT64U                  elapsed_ms;
+    CPU_INT32U                  i;
+    SMTPc_ERR                   err;
+
+
+    TestJobTbl = calloc(TEST_JOB_NBR, sizeof(SMTPc_ASYNC));
+    if (TestJobTbl == NULL) {
+        TestChk(DEF_NO, "async", "job tbl alloc");
+        return;
+    }
+
+    Mem_Clr(fault_tbl, sizeof(fault_tbl));
+    fault_tbl[0].Cmd     = SMTPc_TRANSPORT_MOCK_CMD_RCPT;
+    fault_tbl[0].Period  = 7u;
+    fault_tbl[0].RepCode = 421u;
+    fault_tbl[1].Cmd     = SMTPc_TRANSPORT_MOCK_CMD_ANY;
+    fault_tbl[1].Period  = 13u;
+    fault_tbl[1].SegLen  = 1u;
+    fault_tbl[1].DlyMs   = 30u;
+    fault_tbl[2].Cmd     = SMTPc_TRANSPORT_MOCK_CMD_EOM;
+    fault_tbl[2].Period  = 11u;
+    fault_tbl[2].Drop    = DEF_YES;
+    TestCfgSet(fault_tbl, 3u);
+    SMTPc_TransportMock_StatsClr();
+
+    TestCmplCtr = 0u;
+    TestOkCtr   = 0u;
+    ts          = TestTS_Get_ms();
+    for (i = 0u; i < TEST_JOB_NBR; i++) {
+        SMTPc_AsyncSubmit(&TestJobTbl[i], "mock", 0u, DEF_NULL, DEF_NULL, DEF_NULL, &TestMsgRender,
+                          TestCmpl, DEF_NULL, &err);
+        if (err != SMTPc_ERR_NONE) {
+            TestCmpl(&TestJobTbl[i], err, DEF_NULL);
+        }
+    }
+                                                                /* See Note #1.                                         */
+    while ((TestCmplCtr < TEST_JOB_NBR) &&
+           (TestTS_Get_ms() - ts < SMTPc_CFG_ASYNC_TIMEOUT_MS + SMTPc_CFG_MAX_REP_TIMEOUT_MS)) {
+        (void)SMTPc_Poll(DEF_INT_16U_MAX_VAL);
+    }
+    elapsed_ms = TestTS_Get_ms() - ts;
+
+    SMTPc_TransportMock_StatsGet(&stats);
+    printf("async: %u jobs, %u sent, %u failed in %llu ms; %u faults; "
+           "lat p50 %u p99 %u p999 %u max %u us; recov %u avg %u max %u ms\n",
+           (unsigned)TestCmplCtr,
+           (unsigned)TestOkCtr,
+           (unsigned)(TestCmplCtr - TestOkCtr),
+           (unsigned long long)elapsed_ms,
+           (unsigned)stats.FaultCtr,
+           (unsigned)stats.LatP50_us,
+           (unsigned)stats.LatP99_us,
+           (unsigned)stats.LatP999_us,
+           (unsigned)stats.LatMax_us,
+           (unsigned)stats.RecovCtr,
+           (unsigned)stats.RecovAvg_ms,
+           (unsigned)stats.RecovMax_ms);
+
+    TestChk( TestCmplCtr == TEST_JOB_NBR,                       "async", "all jobs completed");
+    TestChk( stats.MsgCtr == TestOkCtr,                         "async", "msgs sent accepted by the server");
+    TestChk((TestOkCtr    >  0u) &&
+            (TestOkCtr    <  TEST_JOB_NBR),                     "async", "faults failed some jobs only");
+
+    free(TestJobTbl);
+}